@@ -0,0 +1,219 @@
+#include "benchmark_utils.h"
+
+#include "aerial_autonomy/common/conversions.h"
+#include "aerial_autonomy/controller_connectors/arm_sine_controller_connector.h"
+#include "aerial_autonomy/controller_connectors/builtin_pose_controller_arm_connector.h"
+#include "aerial_autonomy/controller_connectors/visual_servoing_controller_arm_connector.h"
+#include "aerial_autonomy/controllers/relative_pose_controller.h"
+#include "aerial_autonomy/kinematics/damped_least_squares_ik.h"
+#include "aerial_autonomy/kinematics/reachability_map.h"
+#include "aerial_autonomy/simulators/arm_dynamics_simulator.h"
+#include "aerial_autonomy/state_machines/pick_place_state_machine.h"
+#include "aerial_autonomy/state_machines/uav_arm_sysid_state_machine.h"
+#include "aerial_autonomy/trackers/simple_tracker.h"
+
+#include <arm_parsers/arm_simulator.h>
+#include <benchmark/benchmark.h>
+
+#include "grip_config.pb.h"
+
+/**
+ * @brief Fixture with simulated quadrotor and arm hardware shared by the arm
+ * connectors
+ */
+class ArmConnectorFixture : public benchmark::Fixture {
+public:
+  ArmConnectorFixture()
+      : drone_hardware_(createDroneHardware()),
+        camera_transform_(tf::Matrix3x3(0, 0, 1, -1, 0, 0, 0, -1, 0),
+                          tf::Vector3(0, 0, 0)),
+        arm_transform_(tf::Matrix3x3(1, 0, 0, 0, -1, 0, 0, 0, -1),
+                       tf::Vector3(0, 0, 0)),
+        tracker_(*drone_hardware_, camera_transform_) {
+    tracker_.setTargetPoseGlobalFrame(tf::Transform(
+        tf::createQuaternionFromRPY(0, 0, 0.3), tf::Vector3(0.5, 0, -0.2)));
+  }
+
+protected:
+  ArmSimulator arm_hardware_; ///< Simulated arm
+  /**
+   * @brief Simulated quadrotor
+   */
+  std::shared_ptr<quad_simulator::QuadSimulator> drone_hardware_;
+  tf::Transform camera_transform_; ///< Front facing camera
+  tf::Transform arm_transform_;    ///< Upside-down arm
+  SimpleTracker tracker_;          ///< Tracker with a fixed target
+};
+
+BENCHMARK_F(ArmConnectorFixture, ArmSineControllerConnector)
+(benchmark::State &state) {
+  ArmSineControllerConfig config;
+  for (int i = 0; i < 6; ++i) {
+    auto joint_config = config.mutable_joint_config()->Add();
+    joint_config->set_amplitude(0.5);
+    joint_config->set_frequency(0.2 * (i + 1));
+  }
+  ArmSineController controller(config);
+  ArmSineControllerConnector connector(arm_hardware_, controller);
+  runConnector(state, connector, EmptyGoal());
+}
+
+BENCHMARK_F(ArmConnectorFixture, BuiltInPoseControllerArmConnector)
+(benchmark::State &state) {
+  BuiltInPoseController controller;
+  BuiltInPoseControllerArmConnector connector(arm_hardware_, controller);
+  runConnector(state, connector,
+               tf::Transform(tf::Quaternion::getIdentity(),
+                             tf::Vector3(0.2, 0, -0.1)));
+}
+
+BENCHMARK_F(ArmConnectorFixture, VisualServoingControllerArmConnector)
+(benchmark::State &state) {
+  RelativePoseController controller((PoseControllerConfig()));
+  VisualServoingControllerArmConnector connector(
+      tracker_, *drone_hardware_, arm_hardware_, controller, camera_transform_,
+      arm_transform_);
+  runConnector(state, connector, Pose());
+}
+
+/**
+ * @brief Benchmark the internal transitions of a state machine that needs a
+ * UAV arm system. The state machine is benchmarked in the landed state
+ */
+template <class LogicStateMachineT>
+static void BM_UAVArmSystemStateMachine(benchmark::State &state) {
+  auto drone_hardware = createDroneHardware();
+  std::shared_ptr<ArmSimulator> arm_hardware(new ArmSimulator);
+  UAVSystemConfig config;
+  BaseStateMachineConfig state_machine_config;
+  tf::Transform camera_transform = conversions::protoTransformToTf(
+      config.uav_vision_system_config().camera_transform());
+  std::shared_ptr<SimpleTracker> tracker(
+      new SimpleTracker(*drone_hardware, camera_transform));
+  UAVArmSystem uav_arm_system(
+      config, std::dynamic_pointer_cast<BaseTracker>(tracker),
+      std::dynamic_pointer_cast<parsernode::Parser>(drone_hardware),
+      std::dynamic_pointer_cast<ArmParser>(arm_hardware));
+  LogicStateMachineT logic_state_machine(boost::ref(uav_arm_system),
+                                         boost::cref(state_machine_config));
+  logic_state_machine.start();
+  // Move to landed state
+  logic_state_machine.process_event(InternalTransitionEvent());
+  processInternalTransitions(state, logic_state_machine);
+}
+BENCHMARK_TEMPLATE(BM_UAVArmSystemStateMachine, PickPlaceStateMachine);
+BENCHMARK_TEMPLATE(BM_UAVArmSystemStateMachine, UAVArmSysIDStateMachine);
+
+/**
+ * @brief Simulate pick-place cycles with the arm dynamics simulator, ticking
+ * the arm commands at 50 Hz. Each iteration moves to the object, grips until
+ * the grip has held for the grip duration, retrying failed grips, moves to
+ * the drop pose and releases. The object is placed off the commanded grasp
+ * pose by the argument in mm, as with perception errors. Reports the mean
+ * simulated cycle time and grip attempts per cycle
+ */
+static void BM_ArmDynamicsSimulatorPickPlace(benchmark::State &state) {
+  ArmDynamicsSimulatorConfig config;
+  config.set_seed(1);
+  ArmDynamicsSimulator arm(config);
+  const std::chrono::milliseconds period(20);
+  const std::chrono::milliseconds grip_duration(GripConfig().grip_duration());
+  arm.sendCmd(ArmParser::POWER_ON);
+  arm.sendCmd(ArmParser::RIGHT_ARM);
+  Eigen::Matrix4d pick_pose = Eigen::Matrix4d::Identity();
+  pick_pose.topRightCorner<3, 1>() = Eigen::Vector3d(0.3, 0.0, -0.15);
+  Eigen::Matrix4d place_pose = pick_pose;
+  place_pose(1, 3) = 0.15;
+  Eigen::Matrix4d object_pose = pick_pose;
+  object_pose(1, 3) += 1e-3 * state.range(0);
+  auto move = [&](const Eigen::Matrix4d &pose) {
+    arm.setEndEffectorPose(pose);
+    do {
+      arm.advance(period);
+    } while (!arm.getCommandStatus());
+  };
+  double simulated_time = 0;
+  double grip_attempts = 0;
+  while (state.KeepRunning()) {
+    const auto start = arm.getTime();
+    arm.setObjectPose(object_pose);
+    move(pick_pose);
+    std::chrono::duration<double> grip_time(0);
+    while (grip_time < grip_duration) {
+      if (arm.gripStatus()) {
+        grip_time += period;
+      } else if (arm.getCommandStatus()) {
+        // Closed without gripping the object
+        arm.resetGripper();
+        arm.grip(true);
+        grip_time = std::chrono::duration<double>(0);
+        ++grip_attempts;
+      }
+      arm.advance(period);
+    }
+    move(place_pose);
+    arm.grip(false);
+    do {
+      arm.advance(period);
+    } while (!arm.getCommandStatus());
+    simulated_time += (arm.getTime() - start).count();
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["simulated_cycle_time"] =
+      benchmark::Counter(simulated_time, benchmark::Counter::kAvgIterations);
+  state.counters["grip_attempts"] =
+      benchmark::Counter(grip_attempts, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_ArmDynamicsSimulatorPickPlace)->Arg(0)->Arg(20);
+
+/**
+ * @brief Solve the inverse kinematics of the simulated arm for an end
+ * effector goal moving by the argument in mm per 50 Hz tick, starting each
+ * solve from the previous solution. Reports the mean solver iterations
+ */
+static void BM_DampedLeastSquaresIKTrackGoal(benchmark::State &state) {
+  ArmInverseKinematicsConfig config;
+  *config.mutable_kinematics_config() =
+      ArmDynamicsSimulator::kinematicsConfig(ArmDynamicsSimulatorConfig());
+  DampedLeastSquaresIK ik(config);
+  Eigen::VectorXd q(6);
+  q << 0, 0.5, -1.0, 0.5, 0.5, 0;
+  ik.reset(q);
+  const Eigen::Matrix4d start = ik.getKinematics().forwardKinematics(q);
+  Eigen::Matrix4d target = start;
+  const double step = 1e-3 * state.range(0);
+  double iterations = 0;
+  int tick = 0;
+  while (state.KeepRunning()) {
+    // Move back and forth along y over 0.1 m
+    const int phase = tick++ % 40;
+    target(1, 3) = start(1, 3) + step * (phase < 20 ? phase : 40 - phase);
+    benchmark::DoNotOptimize(ik.solve(target));
+    iterations += ik.getIterations();
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["iterations"] =
+      benchmark::Counter(iterations, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_DampedLeastSquaresIKTrackGoal)->Arg(1)->Arg(5);
+
+/**
+ * @brief Look up the closest reachable position of goals inside and outside
+ * the workspace of the simulated arm
+ */
+static void BM_ReachabilityMapClosestReachable(benchmark::State &state) {
+  ArmInverseKinematicsConfig config;
+  ArmKinematics kinematics(
+      ArmDynamicsSimulator::kinematicsConfig(ArmDynamicsSimulatorConfig()));
+  ReachabilityMap map(kinematics, config.voxel_size(),
+                      config.reachability_samples());
+  const Eigen::Vector3d goals[] = {Eigen::Vector3d(0.3, 0, -0.1),
+                                   Eigen::Vector3d(0.8, 0, -0.1),
+                                   Eigen::Vector3d(0, 0.2, 0.6)};
+  int goal = 0;
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(map.closestReachable(goals[goal++ % 3]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReachabilityMapClosestReachable);
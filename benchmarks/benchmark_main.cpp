@@ -0,0 +1,29 @@
+#include "aerial_autonomy/common/proto_utils.h"
+#include "aerial_autonomy/log/log.h"
+
+#include <benchmark/benchmark.h>
+#include <glog/logging.h>
+
+/**
+ * @brief Runs all the registered benchmarks.
+ *
+ * The data streams are configured from the package log config so that
+ * controllers and connectors pay the same logging cost as in flight. Results
+ * can be written in machine readable form using the google benchmark flags
+ * --benchmark_out=<file> --benchmark_out_format=json
+ */
+int main(int argc, char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  LogConfig log_config;
+  if (!proto_utils::loadProtoText(LOG_CONFIG_FILE, log_config)) {
+    LOG(WARNING) << "Could not load log config: " << LOG_CONFIG_FILE;
+  }
+  log_config.set_directory("/tmp/aerial_autonomy_benchmarks_");
+  Log::instance().configure(log_config);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "aerial_autonomy/controller_connectors/base_controller_connector.h"
+#include "aerial_autonomy/types/internal_transition_event.h"
+
+#include <benchmark/benchmark.h>
+
+#include <quad_simulator_parser/quad_simulator.h>
+
+#include <memory>
+
+/**
+ * @brief Set the goal of a connector and run one step of the connector per
+ * iteration
+ *
+ * @param state Benchmark state
+ * @param connector Connector to run
+ * @param goal Goal of the connector
+ */
+template <class SensorDataType, class GoalType, class ControlType>
+void runConnector(
+    benchmark::State &state,
+    ControllerConnector<SensorDataType, GoalType, ControlType> &connector,
+    GoalType goal) {
+  connector.setGoal(goal);
+  while (state.KeepRunning()) {
+    connector.run();
+  }
+}
+
+/**
+ * @brief Process one internal transition event per iteration. The state
+ * machine is expected to be started and in the state being benchmarked
+ *
+ * @param state Benchmark state
+ * @param logic_state_machine State machine to process events
+ */
+template <class LogicStateMachineT>
+void processInternalTransitions(benchmark::State &state,
+                                LogicStateMachineT &logic_state_machine) {
+  while (state.KeepRunning()) {
+    logic_state_machine.process_event(InternalTransitionEvent());
+  }
+  logic_state_machine.stop();
+}
+
+/**
+ * @brief Create a simulated quadrotor with a full battery that takes off
+ * without waiting on simulated time
+ */
+inline std::shared_ptr<quad_simulator::QuadSimulator> createDroneHardware() {
+  std::shared_ptr<quad_simulator::QuadSimulator> drone_hardware(
+      new quad_simulator::QuadSimulator);
+  drone_hardware->usePerfectTime();
+  drone_hardware->setTakeoffAltitude(2.0);
+  drone_hardware->setBatteryPercent(100);
+  return drone_hardware;
+}
@@ -0,0 +1,146 @@
+#include "benchmark_utils.h"
+
+#include "aerial_autonomy/controller_connectors/basic_controller_connectors.h"
+#include "aerial_autonomy/controller_connectors/joystick_velocity_controller_drone_connector.h"
+#include "aerial_autonomy/controller_connectors/relative_pose_visual_servoing_controller_drone_connector.h"
+#include "aerial_autonomy/controller_connectors/rpyt_based_position_controller_drone_connector.h"
+#include "aerial_autonomy/controller_connectors/rpyt_relative_pose_visual_servoing_connector.h"
+#include "aerial_autonomy/controller_connectors/visual_servoing_controller_drone_connector.h"
+#include "aerial_autonomy/controllers/builtin_controller.h"
+#include "aerial_autonomy/controllers/manual_rpyt_controller.h"
+#include "aerial_autonomy/tests/sample_parser.h"
+#include "aerial_autonomy/trackers/simple_tracker.h"
+
+#include <benchmark/benchmark.h>
+#include <tf/transform_datatypes.h>
+
+#include <chrono>
+
+/**
+ * @brief Fixture with a stub quadrotor parser, a tracker following a fixed
+ * target and a thrust gain estimator shared by the drone connectors
+ */
+class DroneConnectorFixture : public benchmark::Fixture {
+public:
+  DroneConnectorFixture()
+      : camera_transform_(tf::Matrix3x3(0, 0, 1, -1, 0, 0, 0, -1, 0),
+                          tf::Vector3(0.1, 0, 0)),
+        tracker_(drone_hardware_, camera_transform_),
+        thrust_gain_estimator_(0.16) {
+    drone_hardware_.setaltitude(1.0);
+    drone_hardware_.setBatteryPercent(100);
+    tracker_.setTargetPoseGlobalFrame(tf::Transform(
+        tf::createQuaternionFromRPY(0, 0, 0.3), tf::Vector3(2, 0.5, 0.5)));
+  }
+
+protected:
+  SampleParser drone_hardware_;    ///< Stub quadrotor hardware
+  tf::Transform camera_transform_; ///< Front facing camera
+  SimpleTracker tracker_;          ///< Tracker with a fixed target
+  /**
+   * @brief Thrust gain estimator for RPYT connectors
+   */
+  ThrustGainEstimator thrust_gain_estimator_;
+};
+
+BENCHMARK_F(DroneConnectorFixture, PositionControllerDroneConnector)
+(benchmark::State &state) {
+  BuiltInPositionController controller;
+  PositionControllerDroneConnector connector(drone_hardware_, controller);
+  runConnector(state, connector, PositionYaw(1, 2, 3, 0.5));
+}
+
+BENCHMARK_F(DroneConnectorFixture, BuiltInVelocityControllerDroneConnector)
+(benchmark::State &state) {
+  BuiltInVelocityController controller;
+  BuiltInVelocityControllerDroneConnector connector(drone_hardware_,
+                                                    controller);
+  runConnector(state, connector, VelocityYaw(0.5, 0.2, 0, 0.5));
+}
+
+BENCHMARK_F(DroneConnectorFixture, ManualRPYTControllerDroneConnector)
+(benchmark::State &state) {
+  ManualRPYTController controller;
+  ManualRPYTControllerDroneConnector connector(drone_hardware_, controller);
+  runConnector(state, connector, EmptyGoal());
+}
+
+BENCHMARK_F(DroneConnectorFixture, JoystickVelocityControllerDroneConnector)
+(benchmark::State &state) {
+  JoystickVelocityController controller(JoystickVelocityControllerConfig(),
+                                        std::chrono::milliseconds(20));
+  JoystickVelocityControllerDroneConnector connector(
+      drone_hardware_, controller, thrust_gain_estimator_);
+  runConnector(state, connector, EmptyGoal());
+}
+
+BENCHMARK_F(DroneConnectorFixture,
+            VelocityBasedPositionControllerDroneConnector)
+(benchmark::State &state) {
+  VelocityBasedPositionController controller;
+  VelocityBasedPositionControllerDroneConnector connector(drone_hardware_,
+                                                          controller);
+  runConnector(state, connector, PositionYaw(1, 2, 3, 0.5));
+}
+
+BENCHMARK_F(DroneConnectorFixture, RPYTBasedPositionControllerDroneConnector)
+(benchmark::State &state) {
+  RPYTBasedPositionController controller(RPYTBasedPositionControllerConfig(),
+                                         std::chrono::milliseconds(20));
+  RPYTBasedPositionControllerDroneConnector connector(
+      drone_hardware_, controller, thrust_gain_estimator_);
+  runConnector(state, connector, PositionYaw(1, 2, 3, 0.5));
+}
+
+BENCHMARK_F(DroneConnectorFixture, VisualServoingControllerDroneConnector)
+(benchmark::State &state) {
+  ConstantHeadingDepthController controller;
+  VisualServoingControllerDroneConnector connector(
+      tracker_, drone_hardware_, controller, camera_transform_);
+  runConnector(state, connector, Position(1, 0, 0));
+}
+
+BENCHMARK_F(DroneConnectorFixture,
+            RelativePoseVisualServoingControllerDroneConnector)
+(benchmark::State &state) {
+  VelocityBasedRelativePoseController controller(
+      (VelocityBasedRelativePoseControllerConfig()));
+  RelativePoseVisualServoingControllerDroneConnector connector(
+      tracker_, drone_hardware_, controller, camera_transform_);
+  runConnector(state, connector, PositionYaw(-1, 0, 0, 0));
+}
+
+BENCHMARK_F(DroneConnectorFixture, RPYTRelativePoseVisualServoingConnector)
+(benchmark::State &state) {
+  RPYTBasedRelativePoseController controller(
+      RPYTBasedRelativePoseControllerConfig(), std::chrono::milliseconds(20));
+  RPYTRelativePoseVisualServoingConnector connector(
+      tracker_, drone_hardware_, controller, thrust_gain_estimator_,
+      camera_transform_);
+  runConnector(state, connector, PositionYaw(-1, 0, 0, 0));
+}
+
+/**
+ * @brief One visual servoing tick with a number of targets in view. The
+ * tracker moves every target into the camera frame and the connector moves
+ * the selected target into the rotation-compensated quadrotor frame
+ */
+BENCHMARK_DEFINE_F(DroneConnectorFixture, VisualServoingTick)
+(benchmark::State &state) {
+  std::unordered_map<uint32_t, tf::Transform> targets;
+  for (int i = 0; i < state.range(0); ++i) {
+    targets[i] = tf::Transform(tf::createQuaternionFromRPY(0, 0, 0.3),
+                               tf::Vector3(2, 0.5 + 0.1 * i, 0.5));
+  }
+  tracker_.setTargetPosesGlobalFrame(targets);
+  RPYTBasedRelativePoseController controller(
+      RPYTBasedRelativePoseControllerConfig(), std::chrono::milliseconds(20));
+  RPYTRelativePoseVisualServoingConnector connector(
+      tracker_, drone_hardware_, controller, thrust_gain_estimator_,
+      camera_transform_);
+  runConnector(state, connector, PositionYaw(-1, 0, 0, 0));
+}
+BENCHMARK_REGISTER_F(DroneConnectorFixture, VisualServoingTick)
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(64);
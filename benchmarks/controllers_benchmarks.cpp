@@ -0,0 +1,246 @@
+#include "aerial_autonomy/controllers/arm_sine_controller.h"
+#include "aerial_autonomy/controllers/constant_heading_depth_controller.h"
+#include "aerial_autonomy/controllers/joystick_velocity_controller.h"
+#include "aerial_autonomy/controllers/manual_rpyt_controller.h"
+#include "aerial_autonomy/controllers/qrotor_backstepping_controller.h"
+#include "aerial_autonomy/controllers/qrotor_backstepping_kernel.h"
+#include "aerial_autonomy/controllers/relative_pose_controller.h"
+#include "aerial_autonomy/controllers/rpyt_based_position_controller.h"
+#include "aerial_autonomy/controllers/rpyt_based_relative_pose_controller.h"
+#include "aerial_autonomy/controllers/rpyt_based_velocity_controller.h"
+#include "aerial_autonomy/controllers/velocity_based_position_controller.h"
+#include "aerial_autonomy/controllers/velocity_based_relative_pose_controller.h"
+#include "aerial_autonomy/tests/reference_backstepping_law.h"
+#include "aerial_autonomy/types/discrete_reference_trajectory_interpolate.h"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <random>
+
+/**
+ * @brief Run one step of a controller per iteration with fixed sensor data
+ *
+ * @param state Benchmark state
+ * @param controller Controller with goal already set
+ * @param sensor_data Sensor data passed to the controller
+ */
+template <class SensorDataType, class GoalType, class ControlType>
+void runController(
+    benchmark::State &state,
+    Controller<SensorDataType, GoalType, ControlType> &controller,
+    const SensorDataType &sensor_data) {
+  ControlType control;
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(controller.run(sensor_data, control));
+    benchmark::ClobberMemory();
+  }
+}
+
+/**
+ * @brief Pose of the quadrotor and the tracked object used for relative pose
+ * controllers
+ */
+std::tuple<Pose, Pose> relativePoseSensorData() {
+  return std::make_tuple(
+      Pose::fromRPY(0.1, -0.1, 0.5, Eigen::Vector3d(0.5, -0.3, 1.0)),
+      Pose::fromRPY(0, 0, 0.2, Eigen::Vector3d(1.5, 0.2, 0.4)));
+}
+
+static void BM_VelocityBasedPositionController(benchmark::State &state) {
+  VelocityBasedPositionController controller;
+  controller.setGoal(PositionYaw(1, 2, 3, 0.5), true);
+  runController(state, controller, PositionYaw(0.1, -0.2, 1.0, 0.1));
+}
+BENCHMARK(BM_VelocityBasedPositionController);
+
+static void BM_ConstantHeadingDepthController(benchmark::State &state) {
+  ConstantHeadingDepthController controller;
+  controller.setGoal(Position(1, 0, 0.5));
+  runController(state, controller, PositionYaw(2, 1, 0.3, 0.1));
+}
+BENCHMARK(BM_ConstantHeadingDepthController);
+
+static void BM_RelativePoseController(benchmark::State &state) {
+  RelativePoseController controller((PoseControllerConfig()));
+  controller.setGoal(Pose::fromRPY(0, 0, 0.3, Eigen::Vector3d(-1, 0, 0.2)));
+  runController(state, controller, relativePoseSensorData());
+}
+BENCHMARK(BM_RelativePoseController);
+
+static void BM_RPYTBasedVelocityController(benchmark::State &state) {
+  RPYTBasedVelocityController controller(RPYTBasedVelocityControllerConfig(),
+                                         std::chrono::milliseconds(20));
+  controller.setGoal(VelocityYawRate(0.5, -0.2, 0.1, 0.1));
+  runController(state, controller,
+                std::make_tuple(VelocityYawRate(0.1, 0.1, 0, 0), 0.2));
+}
+BENCHMARK(BM_RPYTBasedVelocityController);
+
+static void BM_RPYTBasedPositionController(benchmark::State &state) {
+  RPYTBasedPositionController controller(RPYTBasedPositionControllerConfig(),
+                                         std::chrono::milliseconds(20));
+  controller.setGoal(PositionYaw(1, 2, 3, 0.5));
+  runController(state, controller,
+                std::make_tuple(VelocityYawRate(0.1, 0.1, 0, 0),
+                                PositionYaw(0.1, -0.2, 1.0, 0.1)));
+}
+BENCHMARK(BM_RPYTBasedPositionController);
+
+static void BM_VelocityBasedRelativePoseController(benchmark::State &state) {
+  VelocityBasedRelativePoseController controller(
+      (VelocityBasedRelativePoseControllerConfig()));
+  controller.setGoal(PositionYaw(-1, 0, 0.2, 0));
+  runController(state, controller, relativePoseSensorData());
+}
+BENCHMARK(BM_VelocityBasedRelativePoseController);
+
+static void BM_RPYTBasedRelativePoseController(benchmark::State &state) {
+  RPYTBasedRelativePoseController controller(
+      RPYTBasedRelativePoseControllerConfig(), std::chrono::milliseconds(20));
+  controller.setGoal(PositionYaw(-1, 0, 0.2, 0));
+  auto poses = relativePoseSensorData();
+  runController(state, controller,
+                std::make_tuple(std::get<0>(poses), std::get<1>(poses),
+                                Twist(Eigen::Vector3d(0.1, 0.1, 0),
+                                      Eigen::Vector3d::Zero())));
+}
+BENCHMARK(BM_RPYTBasedRelativePoseController);
+
+static void BM_JoystickVelocityController(benchmark::State &state) {
+  JoystickVelocityController controller(JoystickVelocityControllerConfig(),
+                                        std::chrono::milliseconds(20));
+  controller.setGoal(EmptyGoal());
+  runController(state, controller,
+                std::make_tuple(Joystick(1000, -2000, 500, 0),
+                                VelocityYawRate(0.1, 0.1, 0, 0), 0.2));
+}
+BENCHMARK(BM_JoystickVelocityController);
+
+static void BM_ManualRPYTController(benchmark::State &state) {
+  ManualRPYTController controller;
+  controller.setGoal(EmptyGoal());
+  runController(state, controller, Joystick(1000, -2000, 500, 0));
+}
+BENCHMARK(BM_ManualRPYTController);
+
+static void BM_ArmSineController(benchmark::State &state) {
+  ArmSineControllerConfig config;
+  for (int i = 0; i < state.range(0); ++i) {
+    auto joint_config = config.mutable_joint_config()->Add();
+    joint_config->set_amplitude(0.5);
+    joint_config->set_frequency(0.2 * (i + 1));
+    joint_config->set_phase(0.1 * i);
+  }
+  ArmSineController controller(config);
+  controller.setGoal(EmptyGoal());
+  runController(state, controller, EmptySensor());
+}
+BENCHMARK(BM_ArmSineController)->Arg(2)->Arg(6);
+
+/**
+ * @brief Fixture with random qrotor states and references for the backstepping
+ * controller and its kernel
+ */
+class QrotorBacksteppingFixture : public benchmark::Fixture {
+public:
+  QrotorBacksteppingFixture() : generator_(0), distribution_(-1, 1) {
+    config_.set_mass(1.3);
+    config_.set_jxx(0.02);
+    config_.set_jyy(0.03);
+    config_.set_jzz(0.04);
+    for (int i = 0; i < samples; ++i) {
+      QrotorBacksteppingState state;
+      state.R = Eigen::AngleAxisd(M_PI * random(), randomVector().normalized())
+                    .toRotationMatrix();
+      state.p = randomVector();
+      state.v = randomVector();
+      state.w = randomVector();
+      state.thrust = 10 + random();
+      state.thrust_dot = random();
+      states_.push_back(state);
+      ParticleState desired_state;
+      desired_state.p = randomVector();
+      desired_state.v = randomVector();
+      desired_state.a = randomVector();
+      desired_state.j = randomVector();
+      desired_states_.push_back(desired_state);
+      snaps_.push_back(Snap(random(), random(), random()));
+    }
+  }
+
+protected:
+  static constexpr int samples = 64; ///< Number of random samples
+
+  double random() { return distribution_(generator_); }
+
+  Eigen::Vector3d randomVector() {
+    return Eigen::Vector3d(random(), random(), random());
+  }
+
+  QrotorBacksteppingControllerConfig config_;
+  std::vector<QrotorBacksteppingState> states_;
+  std::vector<ParticleState> desired_states_;
+  std::vector<Snap> snaps_;
+  std::mt19937 generator_;
+  std::uniform_real_distribution<double> distribution_;
+};
+
+constexpr int QrotorBacksteppingFixture::samples;
+
+BENCHMARK_F(QrotorBacksteppingFixture, Controller)(benchmark::State &state) {
+  QrotorBacksteppingController controller(config_);
+  std::shared_ptr<DiscreteReferenceTrajectoryInterpolate<ParticleState, Snap>>
+      reference(
+          new DiscreteReferenceTrajectoryInterpolate<ParticleState, Snap>());
+  for (int i = 0; i < samples; ++i) {
+    reference->ts.push_back(0.05 * i);
+    reference->states.push_back(desired_states_[i]);
+    reference->controls.push_back(snaps_[i]);
+  }
+  controller.setGoal(reference);
+  auto sensor_data = std::make_pair(1.01, states_[0]);
+  runController(state, controller, sensor_data);
+}
+
+BENCHMARK_F(QrotorBacksteppingFixture, Kernel)(benchmark::State &state) {
+  QrotorBacksteppingKernel kernel(config_);
+  QrotorBacksteppingControl control;
+  int i = 0;
+  while (state.KeepRunning()) {
+    kernel.run(states_[i], desired_states_[i], snaps_[i], control);
+    benchmark::DoNotOptimize(control);
+    i = (i + 1) % samples;
+  }
+}
+
+BENCHMARK_F(QrotorBacksteppingFixture, DenseReference)
+(benchmark::State &state) {
+  ReferenceBacksteppingLaw reference(
+      config_, QrotorBacksteppingKernel::lyapunovWeights(config_));
+  QrotorBacksteppingControl control;
+  int i = 0;
+  while (state.KeepRunning()) {
+    reference.run(states_[i], desired_states_[i], snaps_[i], control);
+    benchmark::DoNotOptimize(control);
+    i = (i + 1) % samples;
+  }
+}
+
+BENCHMARK_F(QrotorBacksteppingFixture, KernelBatch)(benchmark::State &state) {
+  QrotorBacksteppingKernel kernel(config_);
+  std::vector<QrotorBacksteppingControl> controls;
+  while (state.KeepRunning()) {
+    kernel.run(states_, desired_states_, snaps_, controls);
+    benchmark::DoNotOptimize(controls.data());
+  }
+  state.SetItemsProcessed(state.iterations() * samples);
+}
+
+BENCHMARK_F(QrotorBacksteppingFixture, LyapunovWeights)
+(benchmark::State &state) {
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(
+        QrotorBacksteppingKernel::lyapunovWeights(config_));
+  }
+}
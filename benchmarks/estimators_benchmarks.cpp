@@ -0,0 +1,80 @@
+#include "aerial_autonomy/estimators/recursive_least_squares.h"
+#include "aerial_autonomy/estimators/system_identification_estimator.h"
+#include "aerial_autonomy/estimators/thrust_gain_estimator.h"
+#include "aerial_autonomy/estimators/tracking_vector_estimator.h"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cmath>
+
+/**
+ * @brief Sensor data of a quadrotor tilting and accelerating at time t
+ */
+parsernode::common::quaddata quadData(double t) {
+  parsernode::common::quaddata data;
+  data.rpydata.x = 0.3 * std::cos(t);
+  data.rpydata.y = 0.3 * std::sin(1.3 * t);
+  data.rpydata.z = 0.5 * t;
+  data.linvel.x = 2 * std::sin(0.7 * t);
+  data.linvel.y = 2 * std::cos(0.9 * t);
+  data.linvel.z = std::sin(1.1 * t);
+  data.linacc.x = 0.1 * std::cos(t);
+  data.linacc.y = -0.1 * std::sin(t);
+  data.linacc.z = 9.81 + std::sin(2 * t);
+  return data;
+}
+
+static void BM_ThrustGainEstimator(benchmark::State &state) {
+  ThrustGainEstimator estimator(0.16, 0.1, state.range(0));
+  double t = 0;
+  while (state.KeepRunning()) {
+    estimator.addSensorData(quadData(t));
+    estimator.addThrustCommand(60 + std::sin(t));
+    benchmark::DoNotOptimize(estimator.getThrustGain());
+    t += 0.02;
+  }
+}
+BENCHMARK(BM_ThrustGainEstimator)->Arg(1)->Arg(5);
+
+static void BM_SystemIdentificationEstimator(benchmark::State &state) {
+  SystemIdentificationEstimatorConfig config;
+  SystemIdentificationEstimator estimator(config);
+  double t = 0;
+  while (state.KeepRunning()) {
+    estimator.addSensorData(quadData(t));
+    estimator.addThrustCommand(60 + std::sin(t));
+    benchmark::DoNotOptimize(estimator.getThrustGain());
+    t += 0.02;
+  }
+}
+BENCHMARK(BM_SystemIdentificationEstimator);
+
+template <int N> static void BM_RecursiveLeastSquares(benchmark::State &state) {
+  using VectorNd = typename RecursiveLeastSquares<N>::VectorNd;
+  RecursiveLeastSquares<N> estimator(VectorNd::Zero(), VectorNd::Ones(), 0.99);
+  VectorNd phi = VectorNd::LinSpaced(0.1, 1.0);
+  double t = 0;
+  while (state.KeepRunning()) {
+    phi(0) = std::sin(t);
+    benchmark::DoNotOptimize(estimator.update(phi, std::cos(t)));
+    t += 0.02;
+  }
+}
+BENCHMARK_TEMPLATE(BM_RecursiveLeastSquares, 2);
+BENCHMARK_TEMPLATE(BM_RecursiveLeastSquares, 3);
+
+static void BM_TrackingVectorEstimator(benchmark::State &state) {
+  TrackingVectorEstimator estimator(TrackingVectorEstimatorConfig(),
+                                    std::chrono::milliseconds(20));
+  estimator.initializeState(tf::Vector3(1, 0, 0));
+  double t = 0;
+  while (state.KeepRunning()) {
+    estimator.predict(tf::Vector3(0.1 * std::sin(t), 0.1, 0));
+    estimator.correct(tf::Vector3(1, 0.1 * std::cos(t), 0),
+                      std::chrono::high_resolution_clock::now());
+    benchmark::DoNotOptimize(estimator.getMarkerDirection());
+    t += 0.02;
+  }
+}
+BENCHMARK(BM_TrackingVectorEstimator);
@@ -0,0 +1,138 @@
+#include "aerial_autonomy/common/html_utils.h"
+#include "aerial_autonomy/log/log.h"
+#include "aerial_autonomy/log/stream_compression.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Add a data stream used only by the benchmarks to the log. The stream
+ * is added once and reused by all benchmarks
+ *
+ * @param stream_id ID of the stream
+ * @param log_rate Rate at which data is logged (Hz)
+ *
+ * @return ID of the stream
+ */
+std::string benchmarkStream(std::string stream_id, double log_rate) {
+  static std::set<std::string> added_streams;
+  if (added_streams.insert(stream_id).second) {
+    DataStreamConfig config;
+    config.set_stream_id(stream_id);
+    config.set_log_rate(log_rate);
+    Log::instance().addDataStream(config);
+  }
+  return stream_id;
+}
+
+/**
+ * @brief Log a line of state.range(0) numbers per iteration on a stream
+ *
+ * @param state Benchmark state
+ * @param stream_id Stream to log to
+ */
+void logLines(benchmark::State &state, std::string stream_id) {
+  const int columns = state.range(0);
+  double value = 0;
+  while (state.KeepRunning()) {
+    DataStream &stream = DATA_LOG(stream_id);
+    for (int i = 0; i < columns; ++i) {
+      stream << value;
+    }
+    stream << DataStream::endl;
+    value += 1e-3;
+  }
+}
+
+static void BM_DataStreamEveryLine(benchmark::State &state) {
+  logLines(state, benchmarkStream("benchmark_every_line", 1e9));
+}
+BENCHMARK(BM_DataStreamEveryLine)->Arg(4)->Arg(16);
+
+static void BM_DataStreamRateLimited(benchmark::State &state) {
+  logLines(state, benchmarkStream("benchmark_rate_limited", 25));
+}
+BENCHMARK(BM_DataStreamRateLimited)->Arg(16);
+
+/**
+ * @brief Compress a line of state.range(0) numbers per iteration, flushing a
+ * block every 100 lines as the log writer does for a 100 Hz stream. The
+ * numbers follow the same slow ramp as logLines so the results compare with
+ * the text benchmarks above
+ *
+ * @param state Benchmark state
+ * @param compression Compression of the values
+ */
+void compressLines(benchmark::State &state,
+                   DataStreamConfig::Compression compression) {
+  const int columns = state.range(0);
+  DataStreamConfig config;
+  config.set_compression(compression);
+  StreamCompressor compressor(config);
+  std::string output;
+  compressor.start(output);
+  std::vector<double> values(columns);
+  int64_t timestamp = 0;
+  int64_t lines = 0;
+  std::size_t bytes = 0;
+  double value = 0;
+  while (state.KeepRunning()) {
+    std::fill(values.begin(), values.end(), value);
+    compressor.addDataPoint(timestamp, values.data(), values.size());
+    timestamp += 10000000;
+    value += 1e-3;
+    if (++lines % 100 == 0) {
+      compressor.flush(output);
+      bytes += output.size();
+      output.clear();
+    }
+  }
+  compressor.flush(output);
+  bytes += output.size();
+  state.SetItemsProcessed(state.iterations());
+  state.counters["bytes_per_line"] = double(bytes) / lines;
+}
+
+static void BM_StreamCompressorXor(benchmark::State &state) {
+  compressLines(state, DataStreamConfig::XOR);
+}
+BENCHMARK(BM_StreamCompressorXor)->Arg(4)->Arg(16);
+
+static void BM_StreamCompressorQuantized(benchmark::State &state) {
+  compressLines(state, DataStreamConfig::QUANTIZED);
+}
+BENCHMARK(BM_StreamCompressorQuantized)->Arg(4)->Arg(16);
+
+static void BM_LogStreamLookup(benchmark::State &state) {
+  const std::string stream_id = benchmarkStream("benchmark_lookup", 25);
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(&Log::instance()[stream_id]);
+  }
+}
+BENCHMARK(BM_LogStreamLookup);
+
+/**
+ * @brief Build a status table with state.range(0) rows similar to the robot
+ * system status tables
+ */
+static void BM_HtmlTableWriter(benchmark::State &state) {
+  const int rows = state.range(0);
+  while (state.KeepRunning()) {
+    HtmlTableWriter table_writer;
+    table_writer.beginRow();
+    table_writer.addHeader("Status", Colors::blue, 4);
+    for (int i = 0; i < rows; ++i) {
+      table_writer.beginRow();
+      table_writer.addCell("Data", "Name");
+      table_writer.addCell(0.1 * i, "X");
+      table_writer.addCell(0.2 * i, "Y", Colors::green);
+      table_writer.addCell(0.3 * i, "Z", Colors::red);
+    }
+    benchmark::DoNotOptimize(table_writer.getTableString());
+  }
+}
+BENCHMARK(BM_HtmlTableWriter)->Arg(4)->Arg(16);
@@ -0,0 +1,39 @@
+#include "aerial_autonomy/simulators/quad_dynamics_simulator.h"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+
+/**
+ * @brief Simulate one second of hovering with roll, pitch, yaw rate, thrust
+ * commands at 50 Hz per iteration. Enables noise and wind gusts if the
+ * argument is non-zero
+ */
+static void BM_QuadDynamicsSimulator(benchmark::State &state) {
+  QuadDynamicsSimulatorConfig config;
+  if (state.range(0)) {
+    config.set_position_noise(0.01);
+    config.set_velocity_noise(0.01);
+    config.set_wind_gust_stddev(0.5);
+  }
+  QuadDynamicsSimulator simulator(config);
+  QrotorBacksteppingState initial_state;
+  initial_state.p.z() = 10;
+  initial_state.thrust = config.mass() * config.acc_gravity();
+  simulator.setState(initial_state);
+  geometry_msgs::Quaternion rpyt;
+  rpyt.w = config.acc_gravity() / config.thrust_gain();
+  parsernode::common::quaddata data;
+  const std::chrono::milliseconds period(20);
+  while (state.KeepRunning()) {
+    for (int i = 0; i < 50; ++i) {
+      simulator.getquaddata(data);
+      simulator.cmdrpyawratethrust(rpyt);
+      simulator.advance(period);
+    }
+    benchmark::DoNotOptimize(data);
+  }
+  // Items are simulated seconds
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QuadDynamicsSimulator)->Arg(0)->Arg(1);
@@ -0,0 +1,65 @@
+#include "benchmark_utils.h"
+
+#include "aerial_autonomy/common/conversions.h"
+#include "aerial_autonomy/state_machines/joystick_state_machine.h"
+#include "aerial_autonomy/state_machines/uav_state_machine.h"
+#include "aerial_autonomy/state_machines/visual_servoing_state_machine.h"
+#include "aerial_autonomy/trackers/simple_tracker.h"
+
+#include <benchmark/benchmark.h>
+
+/**
+* @brief Namespace for basic events such as takeoff, land.
+*/
+namespace be = uav_basic_events;
+
+/**
+ * @brief Start a state machine and take off so that the internal transitions
+ * are processed in the hovering state
+ *
+ * @param logic_state_machine State machine to start
+ */
+template <class LogicStateMachineT>
+void startAndTakeoff(LogicStateMachineT &logic_state_machine) {
+  logic_state_machine.start();
+  // Switch to landed state from manual control state
+  logic_state_machine.process_event(InternalTransitionEvent());
+  logic_state_machine.process_event(be::Takeoff());
+  logic_state_machine.process_event(InternalTransitionEvent());
+}
+
+/**
+ * @brief Benchmark a state machine that only needs a UAV system
+ */
+template <class LogicStateMachineT>
+static void BM_UAVSystemStateMachine(benchmark::State &state) {
+  auto drone_hardware = createDroneHardware();
+  UAVSystemConfig config;
+  BaseStateMachineConfig state_machine_config;
+  UAVSystem uav_system(
+      config, std::dynamic_pointer_cast<parsernode::Parser>(drone_hardware));
+  LogicStateMachineT logic_state_machine(boost::ref(uav_system),
+                                         boost::cref(state_machine_config));
+  startAndTakeoff(logic_state_machine);
+  processInternalTransitions(state, logic_state_machine);
+}
+BENCHMARK_TEMPLATE(BM_UAVSystemStateMachine, UAVStateMachine);
+BENCHMARK_TEMPLATE(BM_UAVSystemStateMachine, UAVRPYTStateMachine);
+
+static void BM_VisualServoingStateMachine(benchmark::State &state) {
+  auto drone_hardware = createDroneHardware();
+  UAVSystemConfig config;
+  BaseStateMachineConfig state_machine_config;
+  tf::Transform camera_transform = conversions::protoTransformToTf(
+      config.uav_vision_system_config().camera_transform());
+  std::shared_ptr<SimpleTracker> tracker(
+      new SimpleTracker(*drone_hardware, camera_transform));
+  UAVVisionSystem uav_system(
+      config, std::dynamic_pointer_cast<BaseTracker>(tracker),
+      std::dynamic_pointer_cast<parsernode::Parser>(drone_hardware));
+  VisualServoingStateMachine logic_state_machine(
+      boost::ref(uav_system), boost::cref(state_machine_config));
+  startAndTakeoff(logic_state_machine);
+  processInternalTransitions(state, logic_state_machine);
+}
+BENCHMARK(BM_VisualServoingStateMachine);
@@ -0,0 +1,71 @@
+#include "aerial_autonomy/trackers/color_blob_roi_detector.h"
+#include "aerial_autonomy/trackers/roi_to_position_converter.h"
+#include "aerial_autonomy/trackers/template_roi_detector.h"
+
+#include <benchmark/benchmark.h>
+
+/**
+ * @brief Compute the tracking vector of a square region of interest with the
+ * given side length (pixels) in a VGA depth image
+ */
+static void BM_RoiToPositionConverter(benchmark::State &state) {
+  const int side = state.range(0);
+  cv::Mat depth(480, 640, CV_32F);
+  cv::randu(depth, cv::Scalar(0.5), cv::Scalar(4.0));
+  sensor_msgs::CameraInfo camera_info;
+  camera_info.K[0] = 525;
+  camera_info.K[2] = 320;
+  camera_info.K[4] = 525;
+  camera_info.K[5] = 240;
+  sensor_msgs::RegionOfInterest roi;
+  roi.x_offset = 320 - side / 2;
+  roi.y_offset = 240 - side / 2;
+  roi.width = side;
+  roi.height = side;
+  tf::Transform pose;
+  while (state.KeepRunning()) {
+    RoiToPositionConverter::computeTrackingVector(roi, depth, camera_info, 3.0,
+                                                  0.25, pose);
+    benchmark::DoNotOptimize(pose);
+  }
+  state.SetItemsProcessed(state.iterations() * side * side);
+}
+BENCHMARK(BM_RoiToPositionConverter)->Arg(16)->Arg(64)->Arg(256);
+
+/**
+ * @brief Detect a green blob in a noisy VGA image. This is the time the in
+ * process detector adds to the tracking latency of each depth image
+ */
+static void BM_ColorBlobRoiDetector(benchmark::State &state) {
+  cv::Mat image(480, 640, CV_8UC3);
+  cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(100));
+  image(cv::Rect(300, 200, 64, 48)).setTo(cv::Scalar(0, 255, 0));
+  ColorBlobDetectorConfig config;
+  config.set_hue_min(50);
+  config.set_hue_max(70);
+  ColorBlobRoiDetector detector(config);
+  sensor_msgs::RegionOfInterest roi;
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(detector.detect(image, roi));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ColorBlobRoiDetector);
+
+/**
+ * @brief Match a template with the given side length (pixels) in a noisy VGA
+ * image
+ */
+static void BM_TemplateRoiDetector(benchmark::State &state) {
+  const int side = state.range(0);
+  cv::Mat image(480, 640, CV_8UC3);
+  cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(255));
+  TemplateRoiDetector detector(TemplateDetectorConfig(),
+                               image(cv::Rect(300, 200, side, side)).clone());
+  sensor_msgs::RegionOfInterest roi;
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(detector.detect(image, roi));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TemplateRoiDetector)->Arg(16)->Arg(64);
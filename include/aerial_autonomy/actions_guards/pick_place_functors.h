@@ -6,16 +6,19 @@
 #include <aerial_autonomy/actions_guards/shorting_action_sequence.h>
 #include <aerial_autonomy/actions_guards/visual_servoing_functors.h>
 #include <aerial_autonomy/common/conversions.h>
+#include <aerial_autonomy/common/eigen_views.h>
 #include <aerial_autonomy/common/proto_utils.h>
 #include <aerial_autonomy/logic_states/base_state.h>
 #include <aerial_autonomy/logic_states/timed_state.h>
 #include <aerial_autonomy/pick_place_events.h>
 #include <aerial_autonomy/robot_systems/uav_arm_system.h>
+#include <aerial_autonomy/types/blended_waypoint_trajectory.h>
 #include <aerial_autonomy/types/completed_event.h>
 #include <aerial_autonomy/types/object_id.h>
 #include <aerial_autonomy/types/reset_event.h>
 #include <chrono>
 #include <glog/logging.h>
+#include <memory>
 #include <thread>
 
 // Forward declaration for GrippingInternalActionFunctor_
@@ -109,8 +112,8 @@ struct VisualServoingArmTransitionActionFunctor_
             .pick_place_state_machine_config()
             .arm_goal_transform()
             .Get(TransformIndex);
-    robot_system.setGoal<VisualServoingControllerArmConnector, tf::Transform>(
-        conversions::protoTransformToTf(goal));
+    robot_system.setGoal<VisualServoingControllerArmConnector, Pose>(
+        conversions::toPose(conversions::protoTransformToTf(goal)));
     // Also ensure the gripper is in the right state to grip objects
     robot_system.resetGripper();
   }
@@ -181,6 +184,9 @@ struct GoToWaypointInternalActionFunctor_
    */
   bool run(UAVArmSystem &robot_system, LogicStateMachineT &logic_state_machine,
            StateT &state) {
+    if (state.blendWaypoints()) {
+      return followBlendedPath(robot_system, logic_state_machine, state);
+    }
     // Initialize controller
     if (!state.controlInitialized()) {
       PositionYaw waypoint;
@@ -212,18 +218,80 @@ struct GoToWaypointInternalActionFunctor_
           sendLocalWaypoint(robot_system, waypoint);
         }
       }
-    } else if (status == ControllerStatus::Critical) {
+    } else if (abortIfFailed(status, logic_state_machine)) {
+      return false;
+    }
+    return true;
+  }
+
+  /**
+  * @brief Follow a continuous path through the waypoints. The position goal
+  * is advanced along the path every time the action is run and the completed
+  * event is produced once the path has ended and the controller has
+  * converged to the last waypoint. Aborts if the controller does not
+  * converge within the settle timeout after the end of the path.
+  *
+  * @param robot_system Robot system to send goals to
+  * @param logic_state_machine State machine to process events
+  * @param state State storing the blended path
+  *
+  * @return false if it processed any events. True otherwise.
+  */
+  bool followBlendedPath(UAVArmSystem &robot_system,
+                         LogicStateMachineT &logic_state_machine,
+                         StateT &state) {
+    if (!state.controlInitialized()) {
+      parsernode::common::quaddata data = robot_system.getUAVData();
+      PositionYaw start(data.localpos.x, data.localpos.y, data.localpos.z,
+                        data.rpydata.z);
+      if (!state.startBlendedPath(start)) {
+        LOG(WARNING) << "Waypoint index not available: " << EndIndex;
+        logic_state_machine.process_event(be::Abort());
+        return false;
+      }
+      robot_system.setGoal<RPYTBasedPositionControllerDroneConnector,
+                           PositionYaw>(state.blendedPathGoal());
+      return true;
+    }
+    ControllerStatus status =
+        robot_system.getStatus<RPYTBasedPositionControllerDroneConnector>();
+    if (abortIfFailed(status, logic_state_machine)) {
+      return false;
+    }
+    if (state.blendedPathEnded() && status == ControllerStatus::Completed) {
+      VLOG(1) << "Reached end of blended path";
+      logic_state_machine.process_event(state.completedEvent());
+      return false;
+    } else if (state.blendedPathTimedOut()) {
+      LOG(WARNING) << "Timeout: Failed to reach end of blended path";
+      logic_state_machine.process_event(be::Abort());
+      return false;
+    }
+    robot_system.updateGoal<RPYTBasedPositionControllerDroneConnector,
+                            PositionYaw>(state.blendedPathGoal());
+    return true;
+  }
+
+  /**
+  * @brief Abort if the position controller is critical or not engaged
+  * @param status Position controller status
+  * @param logic_state_machine State machine to process events
+  * @return True if aborted
+  */
+  bool abortIfFailed(const ControllerStatus &status,
+                     LogicStateMachineT &logic_state_machine) {
+    if (status == ControllerStatus::Critical) {
       LOG(WARNING) << "Controller critical for "
                    << typeid(RPYTBasedPositionControllerDroneConnector).name();
       logic_state_machine.process_event(be::Abort());
-      return false;
+      return true;
     } else if (status == ControllerStatus::NotEngaged) {
       LOG(WARNING) << "Controller not engaged for "
                    << typeid(RPYTBasedPositionControllerDroneConnector).name();
       logic_state_machine.process_event(be::Abort());
-      return false;
+      return true;
     }
-    return true;
+    return false;
   }
 
   /**
@@ -311,6 +379,73 @@ struct FollowingWaypointSequence_
     return true;
   }
 
+  /**
+  * @brief Whether to follow a continuous path through the waypoints
+  * @return True if waypoints should be blended
+  */
+  bool blendWaypoints() { return config_.blend_waypoints(); }
+
+  /**
+  * @brief Build a blended path through the relative waypoints from
+  * StartIndex to EndIndex. The relative waypoints are accumulated starting
+  * from the given position, as they would be when stopping at each waypoint
+  *
+  * @param start Current position and yaw of the robot
+  * @return False if the waypoint indices are not in the waypoint list
+  */
+  bool startBlendedPath(const PositionYaw &start) {
+    if (EndIndex < StartIndex || EndIndex >= config_.way_points().size()) {
+      return false;
+    }
+    std::vector<PositionYaw> waypoints{start};
+    for (int i = StartIndex; i <= EndIndex; ++i) {
+      PositionYaw relative_waypoint =
+          conversions::protoPositionYawToPositionYaw(
+              config_.way_points().Get(i));
+      PositionYaw waypoint = waypoints.back();
+      waypoint.x += relative_waypoint.x;
+      waypoint.y += relative_waypoint.y;
+      waypoint.z += relative_waypoint.z;
+      waypoint.yaw = relative_waypoint.yaw;
+      waypoints.push_back(waypoint);
+    }
+    blended_path_.reset(new BlendedWaypointTrajectory(
+        waypoints, config_.cruise_velocity(), config_.corner_tolerance(),
+        config_.max_yaw_rate()));
+    blended_path_start_time_ = std::chrono::high_resolution_clock::now();
+    control_initialized_ = true;
+    return true;
+  }
+
+  /**
+  * @brief Position goal on the blended path at the current time plus the look
+  * ahead time. Also updates the tracked waypoint index.
+  * @return Goal for the position controller
+  */
+  PositionYaw blendedPathGoal() {
+    double t = blendedPathTime();
+    tracked_index_ = StartIndex + blended_path_->waypointIndex(t) - 1;
+    return blended_path_->atTime(t + config_.look_ahead_time()).first;
+  }
+
+  /**
+  * @brief Whether the blended path has reached the last waypoint
+  * @return True if path has ended
+  */
+  bool blendedPathEnded() {
+    return blendedPathTime() >= blended_path_->duration();
+  }
+
+  /**
+  * @brief Whether the settle timeout has passed since the end of the blended
+  * path
+  * @return True if timed out
+  */
+  bool blendedPathTimedOut() {
+    return blendedPathTime() >
+           blended_path_->duration() + config_.settle_timeout();
+  }
+
   /**
    * @brief Get state configuration from the state machine
    * @return state config
@@ -358,10 +493,25 @@ struct FollowingWaypointSequence_
   bool controlInitialized() { return control_initialized_; }
 
 private:
+  /**
+  * @brief Time since the start of the blended path
+  * @return time in seconds
+  */
+  double blendedPathTime() {
+    return std::chrono::duration<double>(
+               std::chrono::high_resolution_clock::now() -
+               blended_path_start_time_)
+        .count();
+  }
+
   FollowingWaypointSequenceConfig config_; ///< State config
   int tracked_index_ = StartIndex;         ///< Current tracked index
   bool control_initialized_ =
       false; ///< Flag to indicate if control is initialized
+  std::shared_ptr<BlendedWaypointTrajectory>
+      blended_path_; ///< Path through waypoints when blending
+  std::chrono::time_point<std::chrono::high_resolution_clock>
+      blended_path_start_time_; ///< Time at which blended path started
 };
 
 /**
@@ -1,12 +1,15 @@
 #pragma once
 
+#include "aerial_autonomy/common/timer_executor.h"
+
 #include <atomic>
 #include <chrono>
 #include <functional>
 #include <thread>
 
 /**
- * @brief Calls given function on a timer in its own thread
+ * @brief Calls given function on a timer in its own thread, or on the threads
+ * of an executor when one is provided
  */
 class AsyncTimer {
 public:
@@ -14,9 +17,12 @@ public:
    * @brief Constructor
    * @param function Function to call
    * @param timer_duration The amount of time in between each function call
+   * @param executor Executor running the function instead of a timer thread.
+   * Should outlive the timer
    */
   AsyncTimer(std::function<void()> function,
-             std::chrono::duration<double> timer_duration);
+             std::chrono::duration<double> timer_duration,
+             TimerExecutor *executor = nullptr);
   /**
    * @brief Destructor cleans up running thread
    */
@@ -49,4 +55,6 @@ private:
   std::chrono::duration<double>
       timer_duration_; ///< The amount of time in between each function call
   std::atomic_bool running_; ///< True when the timer is running
+  TimerExecutor *executor_;  ///< Executor running the function if not null
+  int task_id_;              ///< Id of the task scheduled on the executor
 };
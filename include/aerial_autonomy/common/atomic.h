@@ -44,6 +44,16 @@ public:
     return data_copy;
   }
 
+  /**
+   * @brief Compare the data without copying it
+   * @param data Value to compare against
+   * @return True if the data compares equal to the value
+   */
+  template <class U> bool equals(const U &data) const {
+    boost::mutex::scoped_lock lock(mutex_);
+    return data_ == data;
+  }
+
   /**
    * @brief Assignment operator
    * @param a Atomic class whose data we are copying
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+/**
+ * @brief Optional instrumentation of the functions run by the controller
+ * timers of a system handler.
+ *
+ * A library linked into the executable installs a wrapper and a reporter,
+ * e.g. the allocation tracker installs a wrapper recording the allocating call
+ * sites on the controller thread. Handlers whose configuration enables the
+ * hook wrap their controller timer functions and log the report when they are
+ * destroyed. Without an installed wrapper the functions run unchanged.
+ */
+class ControllerTimerHook {
+public:
+  /**
+   * @brief Wraps a timer function
+   */
+  using Wrapper = std::function<std::function<void()>(std::function<void()>)>;
+  /**
+   * @brief Produces a human readable report of the wrapped runs
+   */
+  using Reporter = std::function<std::string()>;
+
+  /**
+   * @brief Install the wrapper and reporter used by enabled hooks. Called
+   * once, before the handlers are created
+   *
+   * @param wrapper Wrapper of the timer functions
+   * @param reporter Report logged when an enabled hook is destroyed
+   */
+  static void install(Wrapper wrapper, Reporter reporter);
+
+  /**
+   * @brief Check whether a wrapper is installed
+   */
+  static bool installed();
+
+  /**
+   * @brief Constructor
+   * @param enabled Whether timer functions are wrapped
+   */
+  explicit ControllerTimerHook(bool enabled);
+
+  /**
+   * @brief Destructor logs the report if the hook is enabled. Destroy the
+   * hook after the timers it wrapped are stopped
+   */
+  ~ControllerTimerHook();
+
+  /**
+   * @brief Wrap a timer function if the hook is enabled and installed
+   *
+   * @param function Function run by a controller timer
+   *
+   * @return Wrapped function, or the function itself
+   */
+  std::function<void()> wrap(std::function<void()> function) const;
+
+  /**
+   * @brief Delete copy constructor
+   */
+  ControllerTimerHook(const ControllerTimerHook &) = delete;
+  /**
+   * @brief Delete assignment operator
+   */
+  ControllerTimerHook &operator=(const ControllerTimerHook &) = delete;
+
+private:
+  const bool enabled_; ///< Whether the hook wraps functions
+};
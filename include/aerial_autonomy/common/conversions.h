@@ -2,6 +2,7 @@
 
 #include "aerial_autonomy/types/acceleration.h"
 #include "aerial_autonomy/types/jerk.h"
+#include "aerial_autonomy/types/pose.h"
 #include "aerial_autonomy/types/position.h"
 #include "aerial_autonomy/types/position_yaw.h"
 #include "aerial_autonomy/types/velocity.h"
@@ -35,6 +36,13 @@ void transformRPYToTf(double r, double p, double y, tf::Transform &tf);
  */
 void positionYawToTf(const PositionYaw &p, tf::Transform &tf);
 
+/**
+ * @brief Convert PositionYaw to Pose
+ * @param p PositionYaw to convert
+ * @return The equivalent Pose
+ */
+Pose positionYawToPose(const PositionYaw &p);
+
 /**
  * @brief Convert T to Eigen::Vector3d
  * @param p Position to convert
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "aerial_autonomy/types/pose.h"
+
+#include <Eigen/Dense>
+#include <cmath>
+#include <tf/tf.h>
+#include <type_traits>
+
+/**
+ * @brief Zero-copy Eigen views of tf and plain x, y, z types.
+ *
+ * The views alias the memory of the viewed object, so they are only valid as
+ * long as the viewed object is alive. They let controllers use Eigen
+ * arithmetic on tf types and the Position/Velocity family of types without
+ * copying element by element.
+ */
+namespace conversions {
+
+static_assert(std::is_same<tfScalar, double>::value,
+              "Eigen views require tf to use double precision");
+
+/**
+ * @brief Read-only view of a tf::Matrix3x3. tf stores each row as a padded
+ * four element vector, which is mapped with an outer stride of 4.
+ */
+using TfMatrixView =
+    Eigen::Map<const Eigen::Matrix<double, 3, 3, Eigen::RowMajor>,
+               Eigen::Unaligned, Eigen::OuterStride<4>>;
+
+/**
+ * @brief View a tf::Vector3 as an Eigen vector
+ * @param v Vector to view
+ * @return Mutable view of v
+ */
+inline Eigen::Map<Eigen::Vector3d> eigenView(tf::Vector3 &v) {
+  return Eigen::Map<Eigen::Vector3d>(static_cast<tfScalar *>(v));
+}
+
+/**
+ * @brief View a tf::Vector3 as a read-only Eigen vector
+ * @param v Vector to view
+ * @return Read-only view of v
+ */
+inline Eigen::Map<const Eigen::Vector3d> eigenView(const tf::Vector3 &v) {
+  return Eigen::Map<const Eigen::Vector3d>(static_cast<const tfScalar *>(v));
+}
+
+/**
+ * @brief View a tf::Matrix3x3 as a read-only Eigen matrix
+ * @param m Matrix to view
+ * @return Read-only view of m
+ */
+inline TfMatrixView eigenView(const tf::Matrix3x3 &m) {
+  return TfMatrixView(static_cast<const tfScalar *>(m[0]));
+}
+
+/**
+ * @brief View the x, y, z members of a type such as Position, Velocity or
+ * Acceleration as an Eigen vector
+ * @param p Object to view. Its x, y, z members should be consecutive doubles
+ * @return Mutable view of p
+ */
+template <class T> Eigen::Map<Eigen::Vector3d> xyzView(T &p) {
+  static_assert(std::is_same<decltype(p.x), double>::value,
+                "xyzView requires double x, y, z members");
+  return Eigen::Map<Eigen::Vector3d>(&p.x);
+}
+
+/**
+ * @brief View the x, y, z members of a type as a read-only Eigen vector
+ * @param p Object to view. Its x, y, z members should be consecutive doubles
+ * @return Read-only view of p
+ */
+template <class T> Eigen::Map<const Eigen::Vector3d> xyzView(const T &p) {
+  static_assert(std::is_same<decltype(p.x), double>::value,
+                "xyzView requires double x, y, z members");
+  return Eigen::Map<const Eigen::Vector3d>(&p.x);
+}
+
+/**
+ * @brief Copy an Eigen vector into a tf::Vector3 at the ROS boundary
+ * @param v Eigen vector
+ * @return Equivalent tf vector
+ */
+template <class Derived>
+tf::Vector3 toTf(const Eigen::MatrixBase<Derived> &v) {
+  return tf::Vector3(v(0), v(1), v(2));
+}
+
+/**
+ * @brief Copy a tf::Transform into a Pose at the ROS boundary
+ * @param tf Transform to convert
+ * @return Equivalent pose
+ */
+inline Pose toPose(const tf::Transform &tf) {
+  return Pose(eigenView(tf.getBasis()), eigenView(tf.getOrigin()));
+}
+
+/**
+ * @brief Copy a Pose into a tf::Transform at the ROS boundary
+ * @param pose Pose to convert
+ * @return Equivalent tf transform
+ */
+inline tf::Transform toTf(const Pose &pose) {
+  const Eigen::Matrix3d &R = pose.R;
+  return tf::Transform(tf::Matrix3x3(R(0, 0), R(0, 1), R(0, 2), R(1, 0),
+                                     R(1, 1), R(1, 2), R(2, 0), R(2, 1),
+                                     R(2, 2)),
+                       toTf(pose.p));
+}
+
+/**
+ * @brief Yaw of a rotation matrix under Euler ZYX convention.
+ * Equivalent to the yaw returned by tf::Matrix3x3::getRPY (including the
+ * gimbal lock case) without computing roll and pitch
+ * @param m Rotation matrix
+ * @return yaw in radians
+ */
+inline double yaw(const tf::Matrix3x3 &m) {
+  if (std::abs(m[2].x()) >= 1) {
+    return 0;
+  }
+  return std::atan2(m[1].x(), m[0].x());
+}
+}
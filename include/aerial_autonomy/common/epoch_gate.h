@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * @brief Lets readers use a shared object without locks while writers wait
+ * until the readers are done with a replaced object.
+ *
+ * Readers enter the gate before loading the object and leave it when done;
+ * entering and leaving never block. A writer publishes the new object, e.g.
+ * with an atomic store, and then calls synchronize, which returns once every
+ * reader that could have loaded the old object has left. Readers are counted
+ * in one of two slots picked by the epoch they enter in. synchronize advances
+ * the epoch twice and waits for each slot to drain, so readers entering
+ * during the wait only delay it by the length of their own read.
+ */
+class EpochGate {
+public:
+  /**
+   * @brief Keeps a reader inside the gate until destroyed
+   */
+  class Guard {
+  public:
+    /**
+     * @brief Enter the gate
+     * @param gate Gate to enter
+     */
+    explicit Guard(EpochGate &gate)
+        : gate_(&gate), slot_(gate.epoch_.load() & 1) {
+      ++gate_->readers_[slot_];
+    }
+    /**
+     * @brief Move constructor
+     */
+    Guard(Guard &&other) : gate_(other.gate_), slot_(other.slot_) {
+      other.gate_ = nullptr;
+    }
+    /**
+     * @brief Leave the gate
+     */
+    ~Guard() {
+      if (gate_) {
+        --gate_->readers_[slot_];
+      }
+    }
+    /**
+     * @brief Delete the copy constructor
+     */
+    Guard(const Guard &) = delete;
+    /**
+     * @brief Delete the assign operator
+     */
+    Guard &operator=(const Guard &) = delete;
+
+  private:
+    EpochGate *gate_; ///< Gate entered, null once moved from
+    int slot_;        ///< Reader count incremented on entry
+  };
+
+  /**
+   * @brief Constructor
+   */
+  EpochGate();
+  /**
+   * @brief Enter the gate as a reader. Never blocks
+   * @return Guard leaving the gate when destroyed
+   */
+  Guard enter() { return Guard(*this); }
+  /**
+   * @brief Wait until every reader inside the gate when called has left.
+   * Must not be called by a reader inside the gate
+   */
+  void synchronize();
+  /**
+   * @brief Number of readers inside the gate
+   */
+  int readers() const;
+
+  /**
+   * @brief Delete the copy constructor
+   */
+  EpochGate(const EpochGate &) = delete;
+  /**
+   * @brief Delete the assign operator
+   */
+  EpochGate &operator=(const EpochGate &) = delete;
+
+private:
+  std::atomic<uint64_t> epoch_;             ///< Slot of new readers
+  std::array<std::atomic<int>, 2> readers_; ///< Readers per slot
+  std::mutex synchronize_mutex_;            ///< Serializes writers
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "aerial_autonomy/types/pose.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Tree of coordinate frames with cached transforms between them.
+ *
+ * Every frame except the root has a parent and a pose in that parent. Static
+ * frames are fixed when added, e.g. a camera mounted on the body, while the
+ * pose of a dynamic frame is set every tick, e.g. the body attitude. Each
+ * transform looked up is cached: transforms between frames with only static
+ * links to the root are composed once, and the rest are composed again only
+ * after a dynamic pose changes. Frames are added during setup; lookups do not
+ * allocate once every frame is added.
+ *
+ * Lookups fill the cache, so a graph is not thread safe and should only be
+ * used by the thread that sets its dynamic poses, e.g. the controller thread.
+ */
+class FrameGraph {
+public:
+  /**
+   * @brief Index of a frame in the graph
+   */
+  using FrameId = std::size_t;
+  /**
+   * @brief Root frame of the graph
+   */
+  static constexpr FrameId root = 0;
+
+  /**
+   * @brief Constructor. Creates the root frame
+   */
+  FrameGraph();
+  /**
+   * @brief Add a frame with a fixed pose
+   * @param parent Parent of the new frame
+   * @param pose_in_parent Pose of the new frame in the parent frame
+   * @return Id of the new frame
+   */
+  FrameId addStaticFrame(FrameId parent, const Pose &pose_in_parent);
+  /**
+   * @brief Add a frame whose pose is set every tick. The pose is identity
+   * until set
+   * @param parent Parent of the new frame
+   * @return Id of the new frame
+   */
+  FrameId addDynamicFrame(FrameId parent);
+  /**
+   * @brief Set the pose of a dynamic frame. Invalidates the cached transforms
+   * that depend on dynamic frames
+   * @param frame Dynamic frame
+   * @param pose_in_parent Pose of the frame in its parent frame
+   */
+  void setDynamicPose(FrameId frame, const Pose &pose_in_parent);
+  /**
+   * @brief Get the transform taking poses in the source frame to the target
+   * frame, i.e. the pose of the source frame in the target frame
+   * @param target Frame the returned transform maps into
+   * @param source Frame the returned transform maps from
+   * @return Reference to the cached transform, valid until a frame is added
+   */
+  const Pose &getTransform(FrameId target, FrameId source);
+  /**
+   * @brief Number of frames including the root
+   */
+  std::size_t size() const { return frames_.size(); }
+
+private:
+  /**
+   * @brief Link of a frame to its parent
+   */
+  struct Frame {
+    FrameId parent;      ///< Parent frame, the root is its own parent
+    std::size_t depth;   ///< Number of links to the root
+    bool dynamic;        ///< Whether the link is set every tick
+    Pose pose_in_parent; ///< Pose in the parent frame
+  };
+  /**
+   * @brief Cached transform between two frames
+   */
+  struct CacheEntry {
+    Pose transform;        ///< Transform from source to target
+    std::uint64_t version; ///< Version the transform was composed at
+  };
+  /**
+   * @brief Add a frame and reset the cache to fit the frames
+   */
+  FrameId addFrame(FrameId parent, bool dynamic, const Pose &pose_in_parent);
+  /**
+   * @brief Compose the links from a frame up to one of its ancestors
+   * @param frame Frame to start from
+   * @param ancestor Ancestor to stop at
+   * @param dynamic Set to true if any composed link is dynamic
+   * @return Pose of the frame in the ancestor frame
+   */
+  Pose composeToAncestor(FrameId frame, FrameId ancestor, bool &dynamic) const;
+  /**
+   * @brief Entry of the cache for a pair of frames
+   */
+  CacheEntry &cacheEntry(FrameId target, FrameId source) {
+    return cache_[target * frames_.size() + source];
+  }
+
+  std::vector<Frame> frames_;     ///< Frames indexed by id
+  std::vector<CacheEntry> cache_; ///< Transforms indexed by target and source
+  /**
+   * @brief Incremented when a dynamic pose changes so that the transforms
+   * composed through dynamic links are composed again
+   */
+  std::uint64_t version_;
+};
@@ -61,4 +61,39 @@ Eigen::Matrix3d hat(const Eigen::Vector3d &v);
   */
 Eigen::MatrixXd sylvester(const Eigen::MatrixXd &A, const Eigen::MatrixXd &B,
                           const Eigen::MatrixXd &C);
+
+/**
+  * @brief Solve the continuous Lyapunov equation A^T P + P A + Q = 0 for
+  * small fixed-size matrices.
+  *
+  * The equation is solved through its Kronecker form
+  * (I x A^T + A^T x I) vec(P) = -vec(Q) using fixed-size matrices, so that it
+  * does not allocate memory and can be used inside a control loop.
+  * @tparam N Size of the matrices
+  * @param A A
+  * @param Q Symmetric Q
+  * @return Symmetric P
+  */
+template <int N>
+Eigen::Matrix<double, N, N> lyapunov(const Eigen::Matrix<double, N, N> &A,
+                                     const Eigen::Matrix<double, N, N> &Q) {
+  static_assert(N > 0 && N <= 6,
+                "Kronecker form is only suitable for small matrices");
+  Eigen::Matrix<double, N * N, N * N> M;
+  // Column j of A^T P + P A is A^T p_j + sum_k A(k, j) p_k
+  for (int j = 0; j < N; ++j) {
+    for (int k = 0; k < N; ++k) {
+      M.template block<N, N>(j * N, k * N) =
+          A(k, j) * Eigen::Matrix<double, N, N>::Identity();
+    }
+    M.template block<N, N>(j * N, j * N) += A.transpose();
+  }
+  Eigen::Matrix<double, N * N, 1> q =
+      Eigen::Map<const Eigen::Matrix<double, N * N, 1>>(Q.data());
+  Eigen::Matrix<double, N * N, 1> p = M.partialPivLu().solve(-q);
+  Eigen::Matrix<double, N, N> P =
+      Eigen::Map<const Eigen::Matrix<double, N, N>>(p.data());
+  // Remove asymmetry due to round off errors
+  return 0.5 * (P + P.transpose());
+}
 }
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief Fixed capacity first-in first-out buffer backed by a std::array.
+ *
+ * The storage is allocated along with the buffer, so pushing and popping
+ * elements never touches the heap. The active size of the buffer can be
+ * limited at runtime to any value up to the compile time capacity.
+ * Pushing into a full buffer overwrites the oldest element.
+ *
+ * @tparam T Type of element stored
+ * @tparam Capacity Maximum number of elements the buffer can hold
+ */
+template <class T, std::size_t Capacity> class RingBuffer {
+  static_assert(Capacity > 0, "Ring buffer capacity should be positive");
+
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param max_size Number of elements after which the buffer is full.
+   * Should be between 1 and Capacity
+   */
+  RingBuffer(std::size_t max_size = Capacity)
+      : max_size_(max_size), head_(0), size_(0) {
+    if (max_size_ == 0 || max_size_ > Capacity) {
+      throw std::out_of_range("Ring buffer size should be between 1 and " +
+                              std::to_string(Capacity));
+    }
+  }
+
+  /**
+   * @brief Add an element at the back of the buffer. If the buffer is full,
+   * the oldest element is discarded
+   *
+   * @param element Element to add
+   */
+  void push(const T &element) {
+    data_[(head_ + size_) % max_size_] = element;
+    if (size_ == max_size_) {
+      head_ = (head_ + 1) % max_size_;
+    } else {
+      ++size_;
+    }
+  }
+
+  /**
+   * @brief Remove the oldest element from the buffer. Does nothing if the
+   * buffer is empty
+   */
+  void pop() {
+    if (size_ > 0) {
+      head_ = (head_ + 1) % max_size_;
+      --size_;
+    }
+  }
+
+  /**
+   * @brief Oldest element in the buffer. The buffer should not be empty
+   */
+  const T &front() const { return data_[head_]; }
+
+  /**
+   * @brief Newest element in the buffer. The buffer should not be empty
+   */
+  const T &back() const { return (*this)[size_ - 1]; }
+
+  /**
+   * @brief Access elements from oldest (index 0) to newest (size() - 1)
+   *
+   * @param index Position relative to the oldest element
+   *
+   * @return element at index
+   */
+  const T &operator[](std::size_t index) const {
+    return data_[(head_ + index) % max_size_];
+  }
+
+  /**
+   * @brief Number of elements in the buffer
+   */
+  std::size_t size() const { return size_; }
+
+  /**
+   * @brief Maximum number of elements before the buffer is full
+   */
+  std::size_t maxSize() const { return max_size_; }
+
+  /**
+   * @brief Check if the buffer is empty
+   */
+  bool empty() const { return size_ == 0; }
+
+  /**
+   * @brief Check if the buffer is full
+   */
+  bool full() const { return size_ == max_size_; }
+
+  /**
+   * @brief Remove all elements without releasing storage
+   */
+  void clear() {
+    head_ = 0;
+    size_ = 0;
+  }
+
+private:
+  std::array<T, Capacity> data_; ///< Element storage
+  std::size_t max_size_;         ///< Active size of the buffer
+  std::size_t head_;             ///< Index of the oldest element
+  std::size_t size_;             ///< Number of stored elements
+};
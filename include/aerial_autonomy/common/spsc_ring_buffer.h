@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief Lock-free first-in first-out buffer for one producer thread and one
+ * consumer thread.
+ *
+ * The storage is allocated by the constructor, so pushing and popping
+ * elements never touches the heap or blocks. Unlike RingBuffer, pushing into
+ * a full buffer fails and leaves the buffered elements untouched, so that the
+ * producer can count the dropped elements.
+ *
+ * @tparam T Type of element stored
+ */
+template <class T> class SpscRingBuffer {
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param capacity Maximum number of buffered elements. Should be positive
+   */
+  explicit SpscRingBuffer(std::size_t capacity) : data_(capacity) {
+    head_.value = 0;
+    tail_.value = 0;
+    if (capacity == 0) {
+      throw std::out_of_range("Ring buffer capacity should be positive");
+    }
+  }
+
+  /**
+   * @brief Add an element at the back of the buffer. Should only be called
+   * by the producer thread
+   *
+   * @param element Element to add
+   *
+   * @return False if the buffer is full and the element was not added
+   */
+  bool push(const T &element) {
+    std::size_t tail = tail_.value.load(std::memory_order_relaxed);
+    if (tail - head_.value.load(std::memory_order_acquire) == data_.size()) {
+      return false;
+    }
+    data_[tail % data_.size()] = element;
+    tail_.value.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Remove the oldest element from the buffer. Should only be called
+   * by the consumer thread
+   *
+   * @param element Returns the removed element
+   *
+   * @return False if the buffer is empty
+   */
+  bool pop(T &element) {
+    std::size_t head = head_.value.load(std::memory_order_relaxed);
+    if (head == tail_.value.load(std::memory_order_acquire)) {
+      return false;
+    }
+    element = data_[head % data_.size()];
+    head_.value.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Number of buffered elements. Exact only when called by the
+   * producer or the consumer while the other thread is idle
+   */
+  std::size_t size() const {
+    return tail_.value.load(std::memory_order_acquire) -
+           head_.value.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Maximum number of buffered elements
+   */
+  std::size_t capacity() const { return data_.size(); }
+
+private:
+  /**
+   * @brief Index padded to a cache line so that the producer and consumer
+   * indices do not share one
+   */
+  struct PaddedIndex {
+    std::atomic<std::size_t> value;                  ///< Index
+    char pad[64 - sizeof(std::atomic<std::size_t>)]; ///< Padding
+  };
+
+  std::vector<T> data_; ///< Element storage
+  PaddedIndex head_;    ///< Number of elements popped
+  PaddedIndex tail_;    ///< Number of elements pushed
+};
@@ -8,6 +8,10 @@
 #include <aerial_autonomy/types/controller_groups.h>
 // Base Robot system
 #include <aerial_autonomy/robot_systems/base_robot_system.h>
+// Log
+#include <aerial_autonomy/log/log.h>
+// Tick pipeline timings
+#include <aerial_autonomy/common/tick_pipeline.h>
 
 /**
  * @brief Responsible for publishing system status message
@@ -26,7 +30,16 @@ public:
                         LogicStateMachineT &logic_state_machine)
       : nh_(nh),
         system_status_pub_(nh.advertise<std_msgs::String>("system_status", 1)),
-        robot_system_(robot_system), logic_state_machine_(logic_state_machine) {
+        robot_system_(robot_system), logic_state_machine_(logic_state_machine),
+        tick_pipeline_(nullptr) {}
+
+  /**
+  * @brief Add the stage timings of a tick pipeline to the status
+  * @param tick_pipeline Pipeline running the system. Should outlive the
+  * publisher
+  */
+  void setTickPipeline(TickPipeline *tick_pipeline) {
+    tick_pipeline_ = tick_pipeline;
   }
 
   /**
@@ -79,6 +92,11 @@ public:
     }
     // Add table to division
     division_writer.addText(logic_state_machine_table.getTableString());
+    // Add table for dropped data points in the log
+    division_writer.addText(Log::instance().getStatus());
+    if (tick_pipeline_) {
+      division_writer.addText(tick_pipeline_->getStatus());
+    }
     std_msgs::String status;
     status.data = division_writer.getDivisionText();
     system_status_pub_.publish(status);
@@ -91,4 +109,5 @@ private:
       &robot_system_; ///< system whose status we are publishing
   const LogicStateMachineT
       &logic_state_machine_; ///< state machine whose status we are publishing
+  TickPipeline *tick_pipeline_; ///< Pipeline whose timings are published
 };
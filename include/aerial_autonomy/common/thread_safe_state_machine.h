@@ -2,6 +2,7 @@
 
 #include <boost/msm/back/state_machine.hpp>
 #include <boost/thread/recursive_mutex.hpp>
+#include <functional>
 // Type index
 #include <typeindex>
 // Internal transition event
@@ -35,6 +36,11 @@ class thread_safe_state_machine : public state_machine<A0, A1, A2, A3, A4> {
    * @brief  Last event processed by the state machine
    */
   std::type_index last_processed_event_index;
+  /**
+   * @brief Function called with the type index of every event other than the
+   * internal transition event before it is processed
+   */
+  std::function<void(std::type_index)> event_observer_;
 
 public:
   thread_safe_state_machine<A0, A1, A2, A3, A4>()
@@ -117,11 +123,27 @@ public:
     recursive_mutex::scoped_lock lock(process_event_mutex_);
     // Store the event if it is not internal transition event
     std::type_index event_index = typeid(Event);
-    if (event_index != typeid(InternalTransitionEvent))
+    if (event_index != typeid(InternalTransitionEvent)) {
       last_processed_event_index = event_index;
+      if (event_observer_) {
+        event_observer_(event_index);
+      }
+    }
     return this->process_event_internal(evt, true);
   }
 
+  /**
+   * @brief Set the function observing the events processed by the state
+   * machine. It is called while processing the event and should return
+   * quickly
+   *
+   * @param observer Function taking the type index of the event
+   */
+  void setEventObserver(std::function<void(std::type_index)> observer) {
+    recursive_mutex::scoped_lock lock(process_event_mutex_);
+    event_observer_ = observer;
+  }
+
   /**
    * @brief Returns the type index of last processed event after locking
    *
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Timing of a tick pipeline stage. Durations are in seconds
+ */
+struct TickStageTiming {
+  std::string name; ///< Name of the stage
+  uint64_t calls;   ///< Number of times the stage ran
+  double last;      ///< Duration of the latest run
+  double mean;      ///< Mean duration over all the runs
+  double max;       ///< Longest run
+};
+
+/**
+ * @brief Runs a sequence of stages in order on every tick and measures the
+ * time spent in each stage.
+ *
+ * Used to run the controllers, the state machine and the status update of a
+ * system handler on a single timer so that each stage sees the outputs of the
+ * previous stages of the same tick. Stages are added before the first tick.
+ * The stage durations of every tick are logged to a data stream.
+ */
+class TickPipeline {
+public:
+  /**
+   * @brief Constructor
+   * @param stream_id Data stream receiving the stage durations
+   */
+  explicit TickPipeline(std::string stream_id = "tick_pipeline");
+
+  /**
+   * @brief Add a stage after the existing stages
+   *
+   * @param name Name of the stage
+   * @param stage Function run by the stage
+   * @param decimation The stage runs once every decimation ticks, starting
+   * with the first tick
+   */
+  void addStage(std::string name, std::function<void()> stage,
+                unsigned int decimation = 1);
+
+  /**
+   * @brief Run the stages in order
+   */
+  void tick();
+
+  /**
+   * @brief Get the timing of each stage followed by the timing of the whole
+   * tick
+   */
+  std::vector<TickStageTiming> timings();
+
+  /**
+   * @brief Get the stage timings as an html table for the system status
+   * @return Html table string
+   */
+  std::string getStatus();
+
+private:
+  /**
+   * @brief Clock used to time the stages
+   */
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Stage of the pipeline
+   */
+  struct Stage {
+    std::function<void()> function; ///< Function run by the stage
+    unsigned int decimation;        ///< Ticks between runs
+    Clock::duration duration;       ///< Duration of the latest run
+    TickStageTiming timing;         ///< Accumulated timing
+    double total;                   ///< Sum of the run durations
+  };
+
+  /**
+   * @brief Add a run of a stage to its timing
+   */
+  static void recordRun(Stage &stage);
+
+  std::string stream_id_;     ///< Data stream of the stage durations
+  std::vector<Stage> stages_; ///< Stages in order, followed by the tick
+  uint64_t tick_count_;       ///< Ticks run
+  bool header_written_;       ///< True once the stream header is written
+  std::mutex timing_mutex_;   ///< Protects the timings of the stages
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <ros/time.h>
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief Namespace for the process wide monotonic timebase
+ *
+ * All logs and sensor time stamps use the steady clock so that times from
+ * different threads and streams can be compared and never jump with wall or
+ * ROS time adjustments. Times are stored as nanoseconds of the steady clock.
+ * The log records the mapping to wall and ROS time in the "timebase" stream.
+ */
+namespace timebase {
+/**
+ * @brief Monotonic clock of the timebase
+ */
+using Clock = std::chrono::steady_clock;
+/**
+ * @brief Time point of the timebase
+ */
+using TimePoint = Clock::time_point;
+
+/**
+* @brief Current time of the timebase
+* @return Nanoseconds of the monotonic clock
+*/
+int64_t now();
+
+/**
+* @brief Convert a time point of the timebase to nanoseconds
+* @param time Time point to convert
+* @return Nanoseconds of the monotonic clock
+*/
+int64_t toNanoseconds(TimePoint time);
+
+/**
+* @brief Current wall time
+* @return Nanoseconds since the Unix epoch
+*/
+int64_t wallTime();
+
+/**
+* @brief Current ROS time, which is the simulation time when ROS uses a
+* simulated clock
+* @return Nanoseconds of ROS time or zero if ROS time is not initialized
+*/
+int64_t rosTime();
+
+/**
+* @brief Recorded offset from the timebase to the reference time of stamps,
+* which is ROS time or wall time if ROS time is not initialized.
+*
+* The offset is recorded by the first call and kept while samples of the
+* offset stay within a millisecond of it. When the reference time runs slower
+* than the timebase the offset follows it immediately; when it runs faster the
+* offset is slewed at half the rate of the timebase so that converted stamps
+* keep their order. A difference of more than a second, e.g. a restarted
+* simulation, records the offset again.
+*
+* @return Reference time minus timebase time (ns)
+*/
+int64_t referenceOffset();
+
+/**
+* @brief Convert a ROS time stamp, e.g. from a message header, to the timebase
+* using the recorded reference offset, so that both wall and simulated ROS time
+* are supported and converting a stamp twice gives the same time point.
+*
+* @param stamp Time stamp to convert
+* @return Time point of the stamp in the timebase
+*/
+TimePoint fromRosTime(const ros::Time &stamp);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+
+/**
+ * @brief Runs periodic tasks on threads it owns. Used to share a bounded
+ * number of threads between many timers, e.g. between the vehicles of a
+ * multi-vehicle runtime
+ */
+class TimerExecutor {
+public:
+  /**
+   * @brief Destructor
+   */
+  virtual ~TimerExecutor() {}
+
+  /**
+   * @brief Run a task periodically. The first call is made as soon as a thread
+   * is available and a task is never called concurrently with itself
+   *
+   * @param task Function to call
+   * @param period The amount of time in between the start of each call
+   *
+   * @return Id of the scheduled task
+   */
+  virtual int schedule(std::function<void()> task,
+                       std::chrono::duration<double> period) = 0;
+
+  /**
+   * @brief Stop calling a task. Waits for a running call of the task to
+   * finish unless called from the task itself
+   *
+   * @param id Id returned by schedule
+   */
+  virtual void cancel(int id) = 0;
+};
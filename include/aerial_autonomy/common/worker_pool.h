@@ -0,0 +1,114 @@
+#pragma once
+
+#include "aerial_autonomy/common/timer_executor.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Fixed number of threads running periodic tasks by due time.
+ *
+ * Tasks are kept in a heap ordered by their next call time and taken by the
+ * first idle thread. A task that overruns its period is called again as soon
+ * as it finishes, skipping the missed periods instead of calling the task
+ * repeatedly to catch up.
+ */
+class WorkerPool : public TimerExecutor {
+public:
+  /**
+   * @brief Constructor starts the threads
+   * @param thread_count Number of threads, at least one
+   */
+  explicit WorkerPool(unsigned int thread_count);
+  /**
+   * @brief Destructor cancels the remaining tasks and joins the threads
+   */
+  ~WorkerPool();
+
+  /**
+   * @brief Run a task periodically on the pool threads
+   * @param task Function to call
+   * @param period The amount of time in between the start of each call
+   * @return Id of the scheduled task
+   */
+  int schedule(std::function<void()> task,
+               std::chrono::duration<double> period);
+
+  /**
+   * @brief Stop calling a task
+   * @param id Id returned by schedule
+   */
+  void cancel(int id);
+
+  /**
+   * @brief Number of threads of the pool
+   */
+  unsigned int threadCount() const;
+
+  /**
+   * @brief Number of scheduled tasks
+   */
+  std::size_t taskCount();
+
+  /**
+   * @brief Delete the copy constructor
+   */
+  WorkerPool(const WorkerPool &) = delete;
+  /**
+   * @brief Delete the assign operator
+   */
+  WorkerPool &operator=(const WorkerPool &) = delete;
+
+private:
+  /**
+   * @brief Clock used to schedule the tasks
+   */
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @brief Scheduled task
+   */
+  struct Task {
+    std::function<void()> function; ///< Function to call
+    Clock::duration period;         ///< Time in between calls
+    Clock::time_point due_time;     ///< Time of the next call
+    bool running;                   ///< True while the function is called
+    bool cancelled;                 ///< True once the task is cancelled
+    std::thread::id thread;         ///< Thread calling the function
+  };
+
+  /**
+   * @brief Entry of the due time heap
+   */
+  struct DueTask {
+    Clock::time_point due_time; ///< Time of the next call
+    int id;                     ///< Id of the task
+    /**
+     * @brief Order by latest due time so the heap top is the earliest task
+     */
+    bool operator<(const DueTask &other) const {
+      return due_time > other.due_time;
+    }
+  };
+
+  /**
+   * @brief Loop of the worker threads
+   */
+  void work();
+
+  std::vector<std::thread> threads_; ///< Worker threads
+  std::unordered_map<int, std::shared_ptr<Task>> tasks_; ///< Tasks by id
+  std::priority_queue<DueTask> due_tasks_; ///< Tasks waiting for a thread
+  std::mutex mutex_;                       ///< Protects the tasks
+  std::condition_variable work_condition_; ///< Notified when tasks are due
+  std::condition_variable done_condition_; ///< Notified when calls finish
+  int next_id_;                            ///< Id of the next task
+  bool stopping_;                          ///< True when the pool stops
+};
@@ -2,6 +2,7 @@
 #include <aerial_autonomy/common/atomic.h>
 #include <aerial_autonomy/common/controller_status.h>
 #include <aerial_autonomy/controllers/base_controller.h>
+#include <aerial_autonomy/log/log.h>
 #include <aerial_autonomy/types/controller_groups.h>
 #include <glog/logging.h>
 
@@ -96,30 +97,31 @@ public:
         controller_(controller), status_(ControllerStatus::NotEngaged) {}
 
   /**
-   * @brief Extracts sensor data, run controller and send data back to hardware
+   * @brief Extracts sensor data, run controller and send data back to hardware.
+   * Requests a flight recorder dump when the controller becomes critical
    */
   virtual void run() {
     // Get latest sensor data
     // run the controller
     // send the data back to hardware manager
     // Do not run the controller if connector is not engaged
-    if (status_ == ControllerStatus::NotEngaged) {
+    if (status_.equals(ControllerStatus::NotEngaged)) {
       return;
     }
     SensorDataType sensor_data;
     ControlType control;
     if (!extractSensorData(sensor_data)) {
-      status_ = ControllerStatus(ControllerStatus::Critical,
-                                 "Cannot extract sensor data");
+      updateStatus(ControllerStatus(ControllerStatus::Critical,
+                                    "Cannot extract sensor data"));
       return;
     }
     if (!controller_.run(sensor_data, control)) {
-      status_ =
-          ControllerStatus(ControllerStatus::Critical, "Cannot run controller");
+      updateStatus(ControllerStatus(ControllerStatus::Critical,
+                                    "Cannot run controller"));
       return;
     }
     sendControllerCommands(control);
-    status_ = controller_.isConverged(sensor_data);
+    updateStatus(controller_.isConverged(sensor_data));
   }
   /**
    * @brief Set the goal for controller
@@ -130,6 +132,14 @@ public:
     status_ = ControllerStatus(ControllerStatus::Active);
     controller_.setGoal(goal);
   }
+  /**
+   * @brief Update the goal of an engaged controller without resetting the
+   * connector, e.g. to track a moving reference. The controller status is
+   * reevaluated on the next run.
+   *
+   * @param goal Goal for controller
+   */
+  void updateGoal(GoalType goal) { controller_.setGoal(goal); }
   /**
    * @brief Get the goal for controller
    *
@@ -157,6 +167,20 @@ public:
   void disengage() { status_ = ControllerStatus::NotEngaged; }
 
 protected:
+  /**
+   * @brief Set the status of an engaged connector and request a flight
+   * recorder dump when it becomes critical
+   *
+   * @param status New status of the controller
+   */
+  void updateStatus(const ControllerStatus &status) {
+    bool was_critical = status_.equals(ControllerStatus::Critical);
+    status_ = status;
+    if (!was_critical && status == ControllerStatus::Critical) {
+      Log::instance().requestFlightRecorderDump("Controller critical");
+    }
+  }
+
   /**
    * @brief  extract relevant data from hardware/estimators
    *
@@ -1,5 +1,8 @@
 #pragma once
+#include "aerial_autonomy/common/eigen_views.h"
+#include "aerial_autonomy/common/frame_graph.h"
 #include "aerial_autonomy/trackers/base_tracker.h"
+#include "aerial_autonomy/types/pose.h"
 #include <parsernode/parser.h>
 
 #include <tf/tf.h>
@@ -24,11 +27,15 @@ public:
       BaseTracker &tracker, parsernode::Parser &drone_hardware,
       tf::Transform camera_transform, tf::Transform tracking_offset_transform)
       : drone_hardware_(drone_hardware), tracker_(tracker),
-        camera_transform_(camera_transform),
+        camera_transform_(conversions::toPose(camera_transform)),
         // \todo Matt This will become unwieldy when we are tracking multiple
         // objects, each with different offsets.  This assumes the offset is the
         // same for all tracked objects
-        tracking_offset_transform_(tracking_offset_transform) {}
+        tracking_offset_transform_(
+            conversions::toPose(tracking_offset_transform)),
+        body_frame_(frame_graph_.addDynamicFrame(FrameGraph::root)),
+        camera_frame_(
+            frame_graph_.addStaticFrame(body_frame_, camera_transform_)) {}
   /**
    * @brief Destructor
    */
@@ -37,19 +44,41 @@ public:
   /**
    * @brief Get the rotation-compensated tracking pose of the tracker in the
    * rotation-compensated
-   * frame of the quadrotor
+   * frame of the quadrotor. Does not use the frame graph of the controller
+   * thread, so it can be called from any thread
    * @param obect_pose_cam Transform of the object in the camera's frame
    * @return Returned tracking pose in rotation compensated frame
    */
-  tf::Transform getTrackingTransformRotationCompensatedQuadFrame(
-      tf::Transform object_pose_cam);
+  Pose getTrackingTransformRotationCompensatedQuadFrame(
+      const tf::Transform &object_pose_cam);
 
 protected:
   /**
-   * @brief Get the rotation of the uav body frame
+   * @brief Set the rotation of the uav body frame for this tick
+   * @param quad_data UAV data providing the attitude
+   */
+  void updateBodyFrameRotation(const parsernode::common::quaddata &quad_data);
+  /**
+   * @brief Get the rotation-compensated tracking pose using the body rotation
+   * set by updateBodyFrameRotation
+   * @param object_pose_cam Transform of the object in the camera's frame
+   * @return Tracking pose in rotation compensated frame
+   */
+  Pose getCompensatedTrackingTransform(const Pose &object_pose_cam);
+  /**
+   * @brief Get the rotation-compensated tracking pose given the camera pose
+   * @param camera_pose Camera pose in the UAV-centered global frame
+   * @param object_pose_cam Transform of the object in the camera's frame
+   * @return Tracking pose in rotation compensated frame
+   */
+  Pose compensateTrackingTransform(const Pose &camera_pose,
+                                   const Pose &object_pose_cam) const;
+  /**
+   * @brief Get the rotation of the uav body frame set by
+   * updateBodyFrameRotation
    * @return The rotation transform
    */
-  tf::Transform getBodyFrameRotation();
+  const Pose &getBodyFrameRotation();
 
   /**
   * @brief Quad hardware to send commands
@@ -62,10 +91,18 @@ protected:
   /**
   * @brief camera transform with respect to body
   */
-  tf::Transform camera_transform_;
+  Pose camera_transform_;
   /**
   * @brief transform to apply to tracked object in its own frame before
   * roll/pitch compensation
   */
-  tf::Transform tracking_offset_transform_;
+  Pose tracking_offset_transform_;
+  /**
+  * @brief Body and camera frames in the rotation-compensated quad frame. The
+  * camera pose in the compensated frame is composed once per tick. Only used
+  * by the controller thread
+  */
+  FrameGraph frame_graph_;
+  FrameGraph::FrameId body_frame_;   ///< Body frame rotated by the attitude
+  FrameGraph::FrameId camera_frame_; ///< Camera frame on the body
 };
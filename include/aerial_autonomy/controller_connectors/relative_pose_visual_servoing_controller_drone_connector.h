@@ -15,8 +15,8 @@
  * to a goal pose expressed in the tracked object's coordinate frame
  */
 class RelativePoseVisualServoingControllerDroneConnector
-    : public ControllerConnector<std::tuple<tf::Transform, tf::Transform>,
-                                 PositionYaw, VelocityYawRate>,
+    : public ControllerConnector<std::tuple<Pose, Pose>, PositionYaw,
+                                 VelocityYawRate>,
       public BaseRelativePoseVisualServoingConnector {
 public:
   /**
@@ -52,8 +52,7 @@ protected:
    *
    * @return true if able to compute transforms
    */
-  virtual bool
-  extractSensorData(std::tuple<tf::Transform, tf::Transform> &sensor_data);
+  virtual bool extractSensorData(std::tuple<Pose, Pose> &sensor_data);
 
   /**
    * @brief Send velocity commands to hardware
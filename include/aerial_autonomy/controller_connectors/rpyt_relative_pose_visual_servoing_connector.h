@@ -6,7 +6,7 @@
 #include "aerial_autonomy/trackers/base_tracker.h"
 #include "aerial_autonomy/types/position_yaw.h"
 #include "aerial_autonomy/types/roll_pitch_yawrate_thrust.h"
-#include "aerial_autonomy/types/velocity_yaw_rate.h"
+#include "aerial_autonomy/types/twist.h"
 
 #include <parsernode/parser.h>
 
@@ -18,9 +18,8 @@
  * to a goal pose expressed in the tracked object's coordinate frame
  */
 class RPYTRelativePoseVisualServoingConnector
-    : public ControllerConnector<
-          std::tuple<tf::Transform, tf::Transform, VelocityYawRate>,
-          PositionYaw, RollPitchYawRateThrust>,
+    : public ControllerConnector<std::tuple<Pose, Pose, Twist>, PositionYaw,
+                                 RollPitchYawRateThrust>,
       public BaseRelativePoseVisualServoingConnector {
 public:
   /**
@@ -80,7 +79,7 @@ public:
   *
   * @return angle in radians
   */
-  double getViewingAngle(tf::Transform object_pose_cam) const;
+  double getViewingAngle(const Pose &object_pose_cam) const;
 
 protected:
   /**
@@ -88,13 +87,12 @@ protected:
    *
    * @param sensor_data Current transform of quadrotor in the
    * rotation-compensated frame of the quadrotor; tracking transform in the
-   * rotation-compensated frame of the quadrotor; current velocity and
-   * yawrate of the UAV
+   * rotation-compensated frame of the quadrotor; current linear and angular
+   * velocity of the UAV
    *
    * @return true if able to compute transforms
    */
-  virtual bool extractSensorData(
-      std::tuple<tf::Transform, tf::Transform, VelocityYawRate> &sensor_data);
+  virtual bool extractSensorData(std::tuple<Pose, Pose, Twist> &sensor_data);
 
   /**
    * @brief Send velocity commands to hardware
@@ -107,9 +105,8 @@ private:
   /**
    * @brief Base class typedef to simplify code
    */
-  using BaseClass = ControllerConnector<
-      std::tuple<tf::Transform, tf::Transform, VelocityYawRate>, PositionYaw,
-      RollPitchYawRateThrust>;
+  using BaseClass = ControllerConnector<std::tuple<Pose, Pose, Twist>,
+                                        PositionYaw, RollPitchYawRateThrust>;
   /**
    * @brief Estimator for finding the gain between joystick thrust command and
    * the acceleration in body z direction
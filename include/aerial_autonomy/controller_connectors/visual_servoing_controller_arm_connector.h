@@ -1,7 +1,11 @@
 #pragma once
 #include "aerial_autonomy/controller_connectors/base_controller_connector.h"
 #include "aerial_autonomy/controllers/relative_pose_controller.h"
+#include "aerial_autonomy/kinematics/damped_least_squares_ik.h"
+#include "aerial_autonomy/kinematics/reachability_map.h"
 #include "aerial_autonomy/trackers/base_tracker.h"
+#include "aerial_autonomy/types/pose.h"
+#include "arm_kinematics_config.pb.h"
 
 #include <arm_parsers/arm_parser.h>
 
@@ -9,27 +13,37 @@
 
 #include <tf/tf.h>
 
+#include <memory>
+#include <vector>
+
 /**
  * @brief A visual servoing controller that uses a tracker output as feedback
- * and moves the arm to a goal pose relative to the tracked target
+ * and moves the arm to a goal pose relative to the tracked target.
+ *
+ * End effector poses are sent to the arm hardware unless the arm geometry is
+ * configured. Otherwise goals are checked against a reachability map built
+ * at construction, and solved into joint angle commands in tree by an
+ * inverse kinematics solver warm-started from the previous tick.
  */
 class VisualServoingControllerArmConnector
-    : public ControllerConnector<std::tuple<tf::Transform, tf::Transform>,
-                                 tf::Transform, tf::Transform> {
+    : public ControllerConnector<std::tuple<Pose, Pose>, Pose, Pose> {
 public:
   /**
    * @brief Constructor
+   * @param tracker Tracker to connect to controller
+   * @param drone_hardware UAV hardware
+   * @param arm_hardware Arm hardware to send commands to
+   * @param controller Controller to connect to arm hardware
+   * @param camera_transform Camera transform in UAV frame
+   * @param arm_transform Arm transform in UAV frame
+   * @param ik_config Inverse kinematics settings. Poses are solved by the arm
+   * hardware when no joints are configured
    */
-  VisualServoingControllerArmConnector(BaseTracker &tracker,
-                                       parsernode::Parser &drone_hardware,
-                                       ArmParser &arm_hardware,
-                                       RelativePoseController &controller,
-                                       tf::Transform camera_transform,
-                                       tf::Transform arm_transform)
-      : ControllerConnector(controller, ControllerGroup::Arm),
-        drone_hardware_(drone_hardware), arm_hardware_(arm_hardware),
-        tracker_(tracker), camera_transform_(camera_transform),
-        arm_transform_(arm_transform) {}
+  VisualServoingControllerArmConnector(
+      BaseTracker &tracker, parsernode::Parser &drone_hardware,
+      ArmParser &arm_hardware, RelativePoseController &controller,
+      tf::Transform camera_transform, tf::Transform arm_transform,
+      ArmInverseKinematicsConfig ik_config = ArmInverseKinematicsConfig());
   /**
    * @brief Destructor
    */
@@ -41,7 +55,14 @@ public:
    * @param tracking_vector Returned tracking pose
    * @return True if successful and false otherwise
    */
-  bool getTrackingPoseArmFrame(tf::Transform &tracking_pose);
+  bool getTrackingPoseArmFrame(Pose &tracking_pose);
+  /**
+   * @brief Set the goal and start the inverse kinematics from the current
+   * joint angles of the arm on the next run
+   *
+   * @param goal Goal pose relative to the tracked target
+   */
+  virtual void setGoal(Pose goal);
 
 protected:
   /**
@@ -52,17 +73,20 @@ protected:
    *
    * @return true if able to extract ROI position
    */
-  virtual bool
-  extractSensorData(std::tuple<tf::Transform, tf::Transform> &sensor_data);
+  virtual bool extractSensorData(std::tuple<Pose, Pose> &sensor_data);
 
   /**
    * @brief  Send position commands to hardware
    *
    * @param controls position command to send to arm
    */
-  virtual void sendControllerCommands(tf::Transform controls);
+  virtual void sendControllerCommands(Pose controls);
 
 private:
+  /**
+   * @brief Base class typedef to simplify code
+   */
+  using BaseClass = ControllerConnector<std::tuple<Pose, Pose>, Pose, Pose>;
   /**
   * @brief Drone hardware to send commands
   */
@@ -76,11 +100,31 @@ private:
   */
   BaseTracker &tracker_;
   /**
-  * @brief camera transform with respect to body
+  * @brief Camera pose in the arm frame, composed once at construction
+  */
+  const Pose camera_pose_arm_frame_;
+  /**
+  * @brief In tree inverse kinematics. Null if poses are sent to the arm
+  * hardware
+  */
+  std::unique_ptr<DampedLeastSquaresIK> ik_solver_;
+  /**
+  * @brief End effector positions the arm can reach. Null without in tree
+  * inverse kinematics
+  */
+  std::unique_ptr<ReachabilityMap> reachability_map_;
+  /**
+  * @brief Move unreachable goals to the closest reachable position instead
+  * of skipping them
+  */
+  bool clamp_unreachable_goals_;
+  /**
+  * @brief Whether the solver started from the joint angles of the arm since
+  * the goal was set
   */
-  tf::Transform camera_transform_;
+  bool ik_seeded_;
   /**
-  * @brief arm transform with respect to body
+  * @brief Joint angle command sent to the arm hardware
   */
-  tf::Transform arm_transform_;
+  std::vector<double> joint_angles_;
 };
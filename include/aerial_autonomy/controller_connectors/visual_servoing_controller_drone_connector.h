@@ -1,7 +1,10 @@
 #pragma once
+#include "aerial_autonomy/common/eigen_views.h"
+#include "aerial_autonomy/common/frame_graph.h"
 #include "aerial_autonomy/controller_connectors/base_controller_connector.h"
 #include "aerial_autonomy/controllers/constant_heading_depth_controller.h"
 #include "aerial_autonomy/trackers/base_tracker.h"
+#include "aerial_autonomy/types/pose.h"
 #include "aerial_autonomy/types/position_yaw.h"
 #include "aerial_autonomy/types/velocity_yaw.h"
 #include "uav_vision_system_config.pb.h"
@@ -25,7 +28,10 @@ public:
       tf::Transform camera_transform)
       : ControllerConnector(controller, ControllerGroup::UAV),
         drone_hardware_(drone_hardware), tracker_(tracker),
-        camera_transform_(camera_transform) {}
+        camera_transform_(conversions::toPose(camera_transform)),
+        body_frame_(frame_graph_.addDynamicFrame(FrameGraph::root)),
+        camera_frame_(
+            frame_graph_.addStaticFrame(body_frame_, camera_transform_)) {}
   /**
    * @brief Destructor
    */
@@ -33,7 +39,8 @@ public:
 
   /**
    * @brief Get the tracking vector of the tracker in the global
-   * frame
+   * frame. Does not use the frame graph of the controller thread, so it can
+   * be called from any thread
    * @param tracking_vector Returned tracking vector
    * @return True if successful and false otherwise
    */
@@ -58,10 +65,14 @@ protected:
 
 private:
   /**
-   * @brief Get the rotation of the uav body frame
-   * @return The rotation transform
+   * @brief Get the tracking vector in the global frame using the given
+   * camera rotation
+   * @param camera_rotation Camera rotation in the global frame
+   * @param tracking_vector Returned tracking vector
+   * @return True if successful and false otherwise
    */
-  tf::Matrix3x3 getBodyFrameRotation();
+  bool getTrackingVectorGlobalFrame(const Eigen::Matrix3d &camera_rotation,
+                                    Position &tracking_vector);
 
   /**
   * @brief Quad hardware to send commands
@@ -74,5 +85,12 @@ private:
   /**
   * @brief camera transform with respect to body
   */
-  tf::Transform camera_transform_;
+  Pose camera_transform_;
+  /**
+  * @brief Body and camera frames in the UAV-centered global frame. Only used
+  * by the controller thread
+  */
+  FrameGraph frame_graph_;
+  FrameGraph::FrameId body_frame_;   ///< Body frame rotated by the attitude
+  FrameGraph::FrameId camera_frame_; ///< Camera frame on the body
 };
@@ -1,5 +1,6 @@
 #pragma once
 #include "aerial_autonomy/controllers/base_controller.h"
+#include "aerial_autonomy/controllers/multi_rate_cascade.h"
 #include "aerial_autonomy/controllers/rpyt_based_velocity_controller.h"
 #include "aerial_autonomy/types/empty_goal.h"
 #include "aerial_autonomy/types/joystick.h"
@@ -40,7 +41,9 @@ public:
             joystick_velocity_controller_config),
         rpyt_velocity_controller_(joystick_velocity_controller_config_
                                       .rpyt_based_velocity_controller_config(),
-                                  controller_timer_duration) {}
+                                  controller_timer_duration),
+        cascade_(joystick_velocity_controller_config_.cascade_config(),
+                 controller_timer_duration) {}
   /**
   * @brief Update RPYT controller config
   */
@@ -85,6 +88,11 @@ private:
   * @brief Internal controller to get rpyt from desired velocity
   */
   RPYTBasedVelocityController rpyt_velocity_controller_;
+  /**
+  * @brief Schedules the joystick mapping and holds or ramps its velocity
+  * goals
+  */
+  MultiRateCascade<VelocityYawRate> cascade_;
   /**
    * @brief convert joystick channels to velocity yaw rate
    *
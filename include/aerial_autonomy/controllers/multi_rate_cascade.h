@@ -0,0 +1,121 @@
+#pragma once
+#include "aerial_autonomy/common/timebase.h"
+#include "multi_rate_cascade_config.pb.h"
+
+#include <algorithm>
+#include <chrono>
+
+/**
+ * @brief Runs the outer loop of a cascaded controller at its own rate and
+ * feeds its setpoints to an inner loop running on every controller tick.
+ *
+ * Both loops are scheduled from the controller timer: on each tick the outer
+ * loop runs if its period has elapsed, and the inner loop gets the latest
+ * outer setpoint, either held or ramped over the outer period. The outer loop
+ * of a cascade that was not stepped for longer than an outer period, e.g.
+ * because its connector was disengaged, runs on the next step and its
+ * setpoint is used without ramping.
+ *
+ * @tparam SetpointT Output of the outer loop. Linear interpolation needs the
+ * +, - and scalar * operators
+ */
+template <class SetpointT> class MultiRateCascade {
+public:
+  /**
+   * @brief Duration of the outer loop
+   * @param config Cascade configuration
+   * @param inner_period Duration of the inner loop, i.e. of the controller
+   * timer
+   * @return The outer loop period, or the inner period if the outer loop runs
+   * on every tick
+   */
+  static std::chrono::duration<double>
+  outerPeriod(const MultiRateCascadeConfig &config,
+              std::chrono::duration<double> inner_period) {
+    return std::chrono::duration<double>(
+        std::max(config.outer_loop_period(), inner_period.count()));
+  }
+
+  /**
+   * @brief Constructor
+   * @param config Cascade configuration
+   * @param inner_period Duration of the inner loop
+   */
+  MultiRateCascade(MultiRateCascadeConfig config,
+                   std::chrono::duration<double> inner_period)
+      : config_(config),
+        outer_period_(std::chrono::duration_cast<timebase::Clock::duration>(
+            outerPeriod(config, inner_period))),
+        every_tick_(config.outer_loop_period() <= inner_period.count()),
+        started_(false), outer_runs_(0) {}
+
+  /**
+   * @brief Get the inner loop setpoint for a tick, running the outer loop if
+   * it is due
+   *
+   * @tparam OuterLoop Callable with signature bool(SetpointT &)
+   * @param now Time of the tick
+   * @param outer_loop Runs the outer loop and returns false on failure. A
+   * failed outer loop runs again on the next tick
+   * @param setpoint Returns the setpoint of the inner loop
+   * @return False if the outer loop failed
+   */
+  template <class OuterLoop>
+  bool step(timebase::TimePoint now, OuterLoop outer_loop,
+            SetpointT &setpoint) {
+    bool restart = !started_ || now - last_step_ > outer_period_;
+    last_step_ = now;
+    if (every_tick_ || restart || now >= next_outer_run_) {
+      SetpointT outer_setpoint;
+      if (!outer_loop(outer_setpoint)) {
+        // Restart again on the next step
+        started_ = started_ && !restart;
+        return false;
+      }
+      ++outer_runs_;
+      ramp_start_ =
+          restart || every_tick_ ? outer_setpoint : interpolate(now);
+      outer_setpoint_ = outer_setpoint;
+      outer_time_ = now;
+      // Keep the outer loop on its grid unless it fell behind by a period
+      next_outer_run_ = restart || now - next_outer_run_ >= outer_period_
+                            ? now + outer_period_
+                            : next_outer_run_ + outer_period_;
+      started_ = true;
+    }
+    setpoint = interpolate(now);
+    return true;
+  }
+
+  /**
+   * @brief Number of outer loop runs
+   */
+  uint64_t outerRuns() const { return outer_runs_; }
+
+private:
+  /**
+   * @brief Inner loop setpoint at a given time after the latest outer run
+   */
+  SetpointT interpolate(timebase::TimePoint now) const {
+    if (config_.setpoint_interpolation() == MultiRateCascadeConfig::HOLD) {
+      return outer_setpoint_;
+    }
+    double fraction =
+        std::chrono::duration<double>(now - outer_time_) / outer_period_;
+    if (fraction >= 1) {
+      return outer_setpoint_;
+    }
+    return ramp_start_ + (outer_setpoint_ - ramp_start_) * fraction;
+  }
+
+  MultiRateCascadeConfig config_;          ///< Cascade configuration
+  timebase::Clock::duration outer_period_; ///< Outer loop period
+  bool every_tick_;                        ///< Outer loop runs every tick
+  bool started_;                           ///< Outer loop ran once
+  timebase::TimePoint last_step_;          ///< Time of the latest step
+  timebase::TimePoint next_outer_run_;     ///< Time the outer loop is due
+  timebase::TimePoint outer_time_;         ///< Time of the latest outer run
+  SetpointT outer_setpoint_;               ///< Latest outer loop output
+  SetpointT ramp_start_;                   ///< Setpoint the ramp starts at
+  uint64_t outer_runs_;                    ///< Number of outer loop runs
+};
@@ -1,7 +1,7 @@
 #pragma once
 
-#include "aerial_autonomy/common/math.h"
 #include "aerial_autonomy/controllers/base_controller.h"
+#include "aerial_autonomy/controllers/qrotor_backstepping_kernel.h"
 #include "aerial_autonomy/types/particle_state.h"
 #include "aerial_autonomy/types/qrotor_backstepping_control.h"
 #include "aerial_autonomy/types/qrotor_backstepping_state.h"
@@ -9,8 +9,9 @@
 #include "aerial_autonomy/types/snap.h"
 #include "qrotor_backstepping_controller_config.pb.h"
 
-#include <Eigen/Dense>
+#include <atomic>
 #include <memory>
+#include <mutex>
 
 /**
  * @brief A trajectory-tracking backstepping controller for a quadrotor.
@@ -24,42 +25,29 @@ class QrotorBacksteppingController
           std::shared_ptr<ReferenceTrajectory<ParticleState, Snap>>,
           QrotorBacksteppingControl> {
 public:
-  using Vector6d = Eigen::Matrix<double, 6, 1>;
-  using Matrix63d = Eigen::Matrix<double, 6, 3>;
-  using Matrix6d = Eigen::Matrix<double, 6, 6>;
-  using Matrix36d = Eigen::Matrix<double, 3, 6>;
-
   /**
   * @brief Constructor
   * @param config Controller config
   */
   QrotorBacksteppingController(QrotorBacksteppingControllerConfig config)
-      : config_(config), m_(config_.mass()), e_(0, 0, 1),
-        ag_(0, 0, -config_.acc_gravity()) {
-    // Compute P from Q, K
-    Eigen::Vector3d kp(config_.kp_xy(), config_.kp_xy(), config_.kp_z());
-    Eigen::Vector3d kd(config_.kd_xy(), config_.kd_xy(), config_.kd_z());
-    K_.leftCols<3>() = kp.asDiagonal();
-    K_.rightCols<3>() = kd.asDiagonal();
-
-    A_ = Eigen::MatrixXd::Zero(6, 6);
-    A_.topRightCorner<3, 3>() = Eigen::MatrixXd::Identity(3, 3);
-
-    B_ = Eigen::MatrixXd::Zero(6, 3);
-    B_.bottomLeftCorner<3, 3>() = (1. / m_) * Eigen::MatrixXd::Identity(3, 3);
+      : config_(config), kernel_(config_), pending_kernel_(config_),
+        kernel_changed_(false) {}
 
-    J_ << config_.jxx(), config_.jxy(), config_.jxz(), config_.jyx(),
-        config_.jyy(), config_.jyz(), config_.jzx(), config_.jzy(),
-        config_.jzz();
-
-    Vector6d Qvec;
-    Qvec << config_.qx(), config_.qy(), config_.qz(), config_.qvx(),
-        config_.qvy(), config_.qvz();
-    Q_ = Qvec.asDiagonal();
+  /**
+  * @brief Update the mass used by the controller, e.g. after picking up a
+  * payload. Can be called from any thread while the control loop runs; the
+  * next run uses the new mass.
+  * @param mass Vehicle mass
+  */
+  void setMass(double mass);
 
-    auto AmBK = A_ - B_ * K_;
-    P_ = math::sylvester(AmBK.transpose(), AmBK, Q_);
-  }
+  /**
+  * @brief Retune position and velocity gains. Can be called from any thread
+  * while the control loop runs; the next run uses the new gains.
+  * @param kp Position gains along x, y, z
+  * @param kd Velocity gains along x, y, z
+  */
+  void setGains(const Eigen::Vector3d &kp, const Eigen::Vector3d &kd);
 
 protected:
   /**
@@ -102,39 +90,21 @@ protected:
 
 private:
   /**
-  * @brief State-independent second-order dynamics
-  */
-  Matrix6d A_;
-  /**
-  * @brief Control matrix
-  */
-  Matrix63d B_;
-  /**
-  * @brief Lyapunov function weights
-  */
-  Matrix6d P_;
-  /**
-  * @brief Gains for PD controller of second-order dynamics
-  */
-  Matrix36d K_;
-  /**
-  * @brief Mass
-  */
-  double m_;
-  /**
-  * @brief Thrust direction vector in body-frame
+  * @brief Control law specialized to the structure of the linear dynamics.
+  * Only used by the thread running the controller
   */
-  Eigen::Vector3d e_;
+  QrotorBacksteppingKernel kernel_;
   /**
-  * @brief Acceleration due to gravity
+  * @brief Kernel with the latest mass and gains. The setters solve for its
+  * Lyapunov weights so that the control loop only copies it
   */
-  Eigen::Vector3d ag_;
+  QrotorBacksteppingKernel pending_kernel_;
   /**
-  * @brief Moment of inertia matrix
+  * @brief Whether pending_kernel_ has changes that kernel_ has not adopted
   */
-  Eigen::Matrix3d J_;
+  std::atomic<bool> kernel_changed_;
   /**
-  * @brief Weight matrix for Lyapunov function time derivative
+  * @brief Synchronize access to pending_kernel_
   */
-  Matrix6d Q_;
+  std::mutex pending_kernel_mutex_;
 };
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "aerial_autonomy/types/particle_state.h"
+#include "aerial_autonomy/types/qrotor_backstepping_control.h"
+#include "aerial_autonomy/types/qrotor_backstepping_state.h"
+#include "aerial_autonomy/types/snap.h"
+#include "qrotor_backstepping_controller_config.pb.h"
+
+#include <Eigen/Dense>
+#include <vector>
+
+/**
+ * @brief Control law of the quadrotor backstepping controller.
+ *
+ * The linear dynamics used by the controller are
+ *
+ *      A = [0 I; 0 0],  B = [0; I/m],  K = [diag(kp) diag(kd)]
+ *
+ * The kernel folds the structure of these matrices into the computations,
+ * i.e. products with A, B and K are replaced by block copies, scaling and
+ * element-wise products, and every intermediate term is evaluated exactly
+ * once. Only the Lyapunov weights P (which are dense) are stored as matrices.
+ *
+ * Since A - BK is decoupled along each axis, the Lyapunov weights are solved
+ * as three 2x2 Lyapunov equations with fixed-size matrices. Mass and gains
+ * can therefore be rescheduled inside the control loop without allocating
+ * memory.
+ *
+ * The control evaluation does not modify the kernel, so the same kernel can
+ * be used to evaluate the controls of many vehicles or candidate states.
+ */
+class QrotorBacksteppingKernel {
+public:
+  using Matrix6d = Eigen::Matrix<double, 6, 6>;
+
+  /**
+  * @brief Constructor. Solves for the Lyapunov function weights using the
+  * gains and Q weights in config
+  * @param config Controller config
+  */
+  QrotorBacksteppingKernel(const QrotorBacksteppingControllerConfig &config);
+  /**
+  * @brief Constructor
+  * @param config Controller config
+  * @param P Lyapunov function weights satisfying (A - BK)^T P + P (A - BK) =
+  * -Q
+  */
+  QrotorBacksteppingKernel(const QrotorBacksteppingControllerConfig &config,
+                           const Matrix6d &P);
+  /**
+  * @brief Solve for the Lyapunov function weights from the gains and Q
+  * weights in config
+  * @param config Controller config
+  * @return Lyapunov function weights P
+  */
+  static Matrix6d
+  lyapunovWeights(const QrotorBacksteppingControllerConfig &config);
+  /**
+  * @brief Override the Lyapunov function weights
+  * @param P Lyapunov function weights
+  */
+  void setLyapunovWeights(const Matrix6d &P);
+  /**
+  * @brief Update mass, e.g. after picking up a payload, and the Lyapunov
+  * function weights that depend on it
+  * @param mass Vehicle mass
+  */
+  void setMass(double mass);
+  /**
+  * @brief Get the mass used by the control law
+  * @return mass
+  */
+  double getMass() const;
+  /**
+  * @brief Update position and velocity gains and the Lyapunov function
+  * weights that depend on them
+  * @param kp Position gains along x, y, z
+  * @param kd Velocity gains along x, y, z
+  */
+  void setGains(const Eigen::Vector3d &kp, const Eigen::Vector3d &kd);
+  /**
+  * @brief Compute controls for a single state
+  * @param state Current qrotor state
+  * @param desired_state Desired position, velocity, acceleration and jerk
+  * @param desired_snap Desired snap
+  * @param control Output controls
+  */
+  void run(const QrotorBacksteppingState &state,
+           const ParticleState &desired_state, const Snap &desired_snap,
+           QrotorBacksteppingControl &control) const;
+  /**
+  * @brief Compute controls for a batch of states, e.g. several vehicles or
+  * candidate states in a simulation sweep
+  * @param states Current qrotor states
+  * @param desired_states Desired states with the same size as states
+  * @param desired_snaps Desired snaps with the same size as states
+  * @param controls Output controls. Resized to the size of states
+  */
+  void run(const std::vector<QrotorBacksteppingState> &states,
+           const std::vector<ParticleState> &desired_states,
+           const std::vector<Snap> &desired_snaps,
+           std::vector<QrotorBacksteppingControl> &controls) const;
+
+private:
+  /**
+  * @brief Solve for Lyapunov function weights along each axis
+  * @param m Mass
+  * @param kp Position gains
+  * @param kd Velocity gains
+  * @param q_p Position weights of Q
+  * @param q_v Velocity weights of Q
+  * @return Lyapunov function weights P
+  */
+  static Matrix6d lyapunovWeights(double m, const Eigen::Vector3d &kp,
+                                  const Eigen::Vector3d &kd,
+                                  const Eigen::Vector3d &q_p,
+                                  const Eigen::Vector3d &q_v);
+  /**
+  * @brief Mass
+  */
+  double m_;
+  /**
+  * @brief Acceleration due to gravity (magnitude)
+  */
+  double acc_gravity_;
+  /**
+  * @brief Position gains (diagonal of K)
+  */
+  Eigen::Vector3d kp_;
+  /**
+  * @brief Velocity gains (diagonal of K)
+  */
+  Eigen::Vector3d kd_;
+  /**
+  * @brief Position weights of Q (diagonal)
+  */
+  Eigen::Vector3d q_p_;
+  /**
+  * @brief Velocity weights of Q (diagonal)
+  */
+  Eigen::Vector3d q_v_;
+  /**
+  * @brief Gain for achieving desired jerk
+  */
+  double k1_;
+  /**
+  * @brief Gain for achieving desired snap
+  */
+  double k2_;
+  /**
+  * @brief Minimum thrust before computing torques
+  */
+  double thrust_eps_;
+  /**
+  * @brief Moment of inertia matrix
+  */
+  Eigen::Matrix3d J_;
+  /**
+  * @brief Position block of B^T P
+  */
+  Eigen::Matrix3d BtP_p_;
+  /**
+  * @brief Velocity block of B^T P
+  */
+  Eigen::Matrix3d BtP_v_;
+};
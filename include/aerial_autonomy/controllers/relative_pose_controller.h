@@ -1,18 +1,16 @@
 #pragma once
 #include "aerial_autonomy/controllers/base_controller.h"
+#include "aerial_autonomy/types/pose.h"
 #include "pose_controller_config.pb.h"
 
 #include <tuple>
 
-#include <tf/tf.h>
-
 /**
  * @brief A pose controller that keeps a pose relative to some feedback
  * pose
  */
 class RelativePoseController
-    : public Controller<std::tuple<tf::Transform, tf::Transform>, tf::Transform,
-                        tf::Transform> {
+    : public Controller<std::tuple<Pose, Pose>, Pose, Pose> {
 public:
   /**
   * @brief Constructor
@@ -33,9 +31,8 @@ protected:
    * @param control Pose command
    * @return True if controller is successful in running
    */
-  virtual bool
-  runImplementation(std::tuple<tf::Transform, tf::Transform> sensor_data,
-                    tf::Transform goal, tf::Transform &control);
+  virtual bool runImplementation(std::tuple<Pose, Pose> sensor_data, Pose goal,
+                                 Pose &control);
   /**
   * @brief Check if controller converged
   *
@@ -44,8 +41,8 @@ protected:
   *
   * @return controller status that contains an enum and debug information.
   */
-  virtual ControllerStatus isConvergedImplementation(
-      std::tuple<tf::Transform, tf::Transform> sensor_data, tf::Transform goal);
+  virtual ControllerStatus
+  isConvergedImplementation(std::tuple<Pose, Pose> sensor_data, Pose goal);
 
 private:
   /**
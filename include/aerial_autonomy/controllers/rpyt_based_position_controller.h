@@ -1,5 +1,6 @@
 #pragma once
 #include "aerial_autonomy/controllers/base_controller.h"
+#include "aerial_autonomy/controllers/multi_rate_cascade.h"
 #include "aerial_autonomy/controllers/rpyt_based_velocity_controller.h"
 #include "aerial_autonomy/controllers/velocity_based_position_controller.h"
 #include "aerial_autonomy/log/log.h"
@@ -12,6 +13,9 @@
 
 /**
  * @brief A position controller that gives rpyt commands
+ *
+ * The position loop can run at a lower rate than the velocity loop, see
+ * MultiRateCascade.
  */
 class RPYTBasedPositionController
     : public Controller<std::tuple<VelocityYawRate, PositionYaw>, PositionYaw,
@@ -26,7 +30,8 @@ public:
    * @param config A config containing position based vel controller and
    * velocity based position controller
    * @param controller_timer_duration The time difference between calls for
-   * internal controllers
+   * the velocity controller. The position controller runs at the rate of the
+   * cascade config
    */
   RPYTBasedPositionController(
       RPYTBasedPositionControllerConfig config,
@@ -34,8 +39,11 @@ public:
       : rpyt_velocity_controller_(
             config.rpyt_based_velocity_controller_config(),
             controller_timer_duration),
-        position_controller_(config.velocity_based_position_controller_config(),
-                             controller_timer_duration) {}
+        position_controller_(
+            config.velocity_based_position_controller_config(),
+            MultiRateCascade<VelocityYawRate>::outerPeriod(
+                config.cascade_config(), controller_timer_duration)),
+        cascade_(config.cascade_config(), controller_timer_duration) {}
   /**
   * @brief Update RPYT controller config
   */
@@ -82,4 +90,8 @@ private:
    * @brief Controller that specifies desired velocity to achieve a position
    */
   VelocityBasedPositionController position_controller_;
+  /**
+   * @brief Schedules the position loop and holds its velocity commands
+   */
+  MultiRateCascade<VelocityYawRate> cascade_;
 };
@@ -1,26 +1,28 @@
 #pragma once
 #include "aerial_autonomy/controllers/base_controller.h"
+#include "aerial_autonomy/controllers/multi_rate_cascade.h"
 #include "aerial_autonomy/controllers/rpyt_based_velocity_controller.h"
 #include "aerial_autonomy/controllers/velocity_based_relative_pose_controller.h"
+#include "aerial_autonomy/types/pose.h"
 #include "aerial_autonomy/types/roll_pitch_yawrate_thrust.h"
+#include "aerial_autonomy/types/twist.h"
 #include "aerial_autonomy/types/velocity_yaw_rate.h"
 #include "rpyt_based_relative_pose_controller_config.pb.h"
 
 #include <tuple>
 
-#include <tf/tf.h>
-
 /**
  * @brief A pose controller that keeps a pose relative to some feedback
  * pose using a velocity controller and a rpyt controller.
  * Note 1: Only the yaw of the desired pose is tracked
  * since a quadrotor is underactuated and cannot arbitrarily control roll/pitch
  * while hovering
+ * Note 2: The relative pose loop can run at a lower rate than the velocity
+ * loop, e.g. at the camera rate, see MultiRateCascade
  */
 class RPYTBasedRelativePoseController
-    : public Controller<
-          std::tuple<tf::Transform, tf::Transform, VelocityYawRate>,
-          PositionYaw, RollPitchYawRateThrust> {
+    : public Controller<std::tuple<Pose, Pose, Twist>, PositionYaw,
+                        RollPitchYawRateThrust> {
 public:
   /**
   * @brief Constructor
@@ -31,10 +33,12 @@ public:
       : config_(config),
         velocity_based_relative_pose_controller_(
             config.velocity_based_relative_pose_controller_config(),
-            controller_timer_duration),
+            MultiRateCascade<VelocityYawRate>::outerPeriod(
+                config.cascade_config(), controller_timer_duration)),
         rpyt_based_velocity_controller_(
             config.rpyt_based_velocity_controller_config(),
-            controller_timer_duration) {}
+            controller_timer_duration),
+        cascade_(config.cascade_config(), controller_timer_duration) {}
   /**
    * @brief Destructor
    */
@@ -67,7 +71,8 @@ protected:
    * controller combined with a rpyt based velocity controller to track
    * a desired pose relative to a tracked pose.
    * @param sensor_data Pose of controlled point and tracked
-   * pose, along with current velocity and yawrate.
+   * pose, along with the current twist. The z angular velocity is used as
+   * the yaw rate.
    * NOTE: Both poses need to be given in the frame in which the
    * velocity command is executed
    *
@@ -75,23 +80,22 @@ protected:
    * @param control Velocity command
    * @return True if controller is successful in running
    */
-  virtual bool runImplementation(
-      std::tuple<tf::Transform, tf::Transform, VelocityYawRate> sensor_data,
-      PositionYaw goal, RollPitchYawRateThrust &control);
+  virtual bool runImplementation(std::tuple<Pose, Pose, Twist> sensor_data,
+                                 PositionYaw goal,
+                                 RollPitchYawRateThrust &control);
   /**
   * @brief Check if controller converged
   *
-  * @param sensor_data Current control pose, tracked pose, current velocity
-  * and yaw rate
+  * @param sensor_data Current control pose, tracked pose and current twist
   * @param goal Goal relative position and yaw in tracked pose frame
   * NOTE: Both poses need to be given in the frame in which the
   * velocity command is executed
   *
   * @return controller status that contains an enum and debug information.
   */
-  virtual ControllerStatus isConvergedImplementation(
-      std::tuple<tf::Transform, tf::Transform, VelocityYawRate> sensor_data,
-      PositionYaw goal);
+  virtual ControllerStatus
+  isConvergedImplementation(std::tuple<Pose, Pose, Twist> sensor_data,
+                            PositionYaw goal);
 
 private:
   /**
@@ -106,4 +110,8 @@ private:
    * @brief Controller that achieves a velocity by specifying desired rpyt
    */
   RPYTBasedVelocityController rpyt_based_velocity_controller_;
+  /**
+   * @brief Schedules the relative pose loop and holds its velocity commands
+   */
+  MultiRateCascade<VelocityYawRate> cascade_;
 };
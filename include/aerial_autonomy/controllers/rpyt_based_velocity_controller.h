@@ -51,6 +51,11 @@ public:
                                                   << "World_acc_x"
                                                   << "World_acc_y"
                                                   << "World_acc_z"
+                                                  << "Yaw"
+                                                  << "Roll_cmd"
+                                                  << "Pitch_cmd"
+                                                  << "Yawrate_cmd"
+                                                  << "Thrust_cmd"
                                                   << DataStream::endl;
   }
   /**
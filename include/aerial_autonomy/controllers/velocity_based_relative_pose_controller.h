@@ -1,14 +1,13 @@
 #pragma once
 #include "aerial_autonomy/controllers/base_controller.h"
 #include "aerial_autonomy/controllers/velocity_based_position_controller.h"
+#include "aerial_autonomy/types/pose.h"
 #include "aerial_autonomy/types/velocity_yaw.h"
 #include "velocity_based_relative_pose_controller_config.pb.h"
 #include <aerial_autonomy/VelocityBasedPositionControllerDynamicConfig.h>
 
 #include <tuple>
 
-#include <tf/tf.h>
-
 /**
  * @brief A pose controller that keeps a pose relative to some feedback
  * pose using a velocity controller.
@@ -17,8 +16,7 @@
  * while hovering
  */
 class VelocityBasedRelativePoseController
-    : public Controller<std::tuple<tf::Transform, tf::Transform>, PositionYaw,
-                        VelocityYawRate> {
+    : public Controller<std::tuple<Pose, Pose>, PositionYaw, VelocityYawRate> {
 public:
   /**
   * @brief Constructor
@@ -68,9 +66,8 @@ protected:
    * @param control Velocity command
    * @return True if controller is successful in running
    */
-  virtual bool
-  runImplementation(std::tuple<tf::Transform, tf::Transform> sensor_data,
-                    PositionYaw goal, VelocityYawRate &control);
+  virtual bool runImplementation(std::tuple<Pose, Pose> sensor_data,
+                                 PositionYaw goal, VelocityYawRate &control);
   /**
   * @brief Check if controller converged
   *
@@ -81,8 +78,9 @@ protected:
   *
   * @return controller status that contains an enum and debug information.
   */
-  virtual ControllerStatus isConvergedImplementation(
-      std::tuple<tf::Transform, tf::Transform> sensor_data, PositionYaw goal);
+  virtual ControllerStatus
+  isConvergedImplementation(std::tuple<Pose, Pose> sensor_data,
+                            PositionYaw goal);
 
 private:
   /**
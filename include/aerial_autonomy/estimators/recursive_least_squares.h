@@ -0,0 +1,141 @@
+#pragma once
+#include <Eigen/Dense>
+#include <cmath>
+#include <glog/logging.h>
+
+/**
+ * @brief Recursive least squares estimator for a linear-in-parameters model
+ *
+ *      y = phi^T theta + noise
+ *
+ * where theta is an N dimensional parameter vector and phi is the regressor
+ * for a scalar measurement y. All the storage is fixed size so that an update
+ * does not allocate memory.
+ *
+ * Old measurements are exponentially discounted using a forgetting factor.
+ * To avoid covariance windup when the regressor is not persistently
+ * exciting, the diagonal of the covariance is bounded to [min_covariance,
+ * max_covariance].
+ *
+ * @tparam N Number of parameters to estimate
+ */
+template <int N> class RecursiveLeastSquares {
+public:
+  /**
+   * @brief Parameter vector type
+   */
+  using VectorNd = Eigen::Matrix<double, N, 1>;
+  /**
+   * @brief Covariance matrix type
+   */
+  using MatrixNd = Eigen::Matrix<double, N, N>;
+
+  /**
+   * @brief Constructor
+   *
+   * @param initial_theta Initial guess of the parameters
+   * @param initial_covariance Diagonal of initial covariance. Large values
+   * imply low confidence in the initial guess
+   * @param forgetting_factor Discount applied to past measurements. Should be
+   * in (0, 1]. A value of 1 does not forget any measurement
+   * @param min_covariance Lower bound on the diagonal of covariance
+   * @param max_covariance Upper bound on the diagonal of covariance
+   */
+  RecursiveLeastSquares(const VectorNd &initial_theta,
+                        const VectorNd &initial_covariance,
+                        double forgetting_factor = 0.99,
+                        double min_covariance = 1e-8,
+                        double max_covariance = 1e4)
+      : forgetting_factor_(forgetting_factor), min_covariance_(min_covariance),
+        max_covariance_(max_covariance) {
+    CHECK_GT(forgetting_factor_, 0)
+        << "Forgetting factor should be between 0 and 1";
+    CHECK_LE(forgetting_factor_, 1)
+        << "Forgetting factor should be between 0 and 1";
+    CHECK_GT(min_covariance_, 0) << "Minimum covariance should be positive";
+    CHECK_GE(max_covariance_, min_covariance_)
+        << "Maximum covariance should be greater than minimum covariance";
+    reset(initial_theta, initial_covariance);
+  }
+
+  /**
+   * @brief Reset the estimate and covariance
+   *
+   * @param theta Parameter estimate to reset to
+   * @param covariance Diagonal of covariance to reset to
+   */
+  void reset(const VectorNd &theta, const VectorNd &covariance) {
+    theta_ = theta;
+    covariance_ = covariance.asDiagonal();
+    boundCovariance();
+  }
+
+  /**
+   * @brief Update the estimate using a scalar measurement
+   *
+   * @param phi Regressor for the measurement
+   * @param y Measurement
+   *
+   * @return Prediction error of the measurement before the update
+   */
+  double update(const VectorNd &phi, double y) {
+    const VectorNd P_phi = covariance_ * phi;
+    const double denominator = forgetting_factor_ + phi.dot(P_phi);
+    const double error = y - phi.dot(theta_);
+    const VectorNd gain = P_phi / denominator;
+    theta_.noalias() += gain * error;
+    covariance_.noalias() -= gain * P_phi.transpose();
+    covariance_ /= forgetting_factor_;
+    // Keep covariance symmetric against round off errors
+    covariance_ = 0.5 * (covariance_ + covariance_.transpose()).eval();
+    boundCovariance();
+    return error;
+  }
+
+  /**
+   * @brief Get the current parameter estimate
+   */
+  const VectorNd &getEstimate() const { return theta_; }
+
+  /**
+   * @brief Get the current covariance of parameter estimate
+   */
+  const MatrixNd &getCovariance() const { return covariance_; }
+
+  /**
+   * @brief Overwrite a single parameter. Used to project the estimate back
+   * into its feasible set
+   *
+   * @param index Index of the parameter
+   * @param value Value to set
+   */
+  void setEstimate(int index, double value) { theta_(index) = value; }
+
+private:
+  /**
+   * @brief Clamp the covariance diagonal. When a diagonal entry exceeds the
+   * maximum, the corresponding row and column are scaled to keep the matrix
+   * positive definite.
+   */
+  void boundCovariance() {
+    for (int i = 0; i < N; ++i) {
+      double diagonal = covariance_(i, i);
+      if (diagonal > max_covariance_) {
+        double scale = std::sqrt(max_covariance_ / diagonal);
+        covariance_.row(i) *= scale;
+        covariance_.col(i) *= scale;
+      } else if (diagonal < min_covariance_) {
+        covariance_(i, i) = min_covariance_;
+      }
+    }
+  }
+
+  VectorNd theta_;                 ///< Parameter estimate
+  MatrixNd covariance_;            ///< Estimate covariance
+  const double forgetting_factor_; ///< Discount on past measurements
+  const double min_covariance_;    ///< Lower bound on covariance diagonal
+  const double max_covariance_;    ///< Upper bound on covariance diagonal
+
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
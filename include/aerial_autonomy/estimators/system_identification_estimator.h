@@ -0,0 +1,112 @@
+#pragma once
+#include "aerial_autonomy/estimators/recursive_least_squares.h"
+#include "aerial_autonomy/estimators/thrust_gain_estimator.h"
+#include "system_identification_estimator_config.pb.h"
+
+#include <Eigen/Dense>
+
+/**
+ * @brief Identifies thrust gain, effective mass and linear drag of a quadrotor
+ * online using recursive least squares.
+ *
+ * The acceleration measured in body frame (gravity removed) is modelled as
+ *
+ *      a_x + g * (R^T e3)_x = -drag_xy * v_x
+ *      a_y + g * (R^T e3)_y = -drag_xy * v_y
+ *      a_z + g * (R^T e3)_z = kt * u - drag_z * v_z
+ *
+ * where v is the velocity in body frame, u is the thrust command and R is the
+ * body rotation. The thrust gain and vertical drag are estimated jointly by a
+ * two parameter estimator and the horizontal drag by a single parameter
+ * estimator. Thrust commands are delayed using the fixed size buffer of
+ * ThrustGainEstimator, so that the estimator does not allocate memory after
+ * construction.
+ *
+ * The effective mass is computed assuming the motor thrust per unit command
+ * is constant i.e mass = nominal_mass * kt_initial / kt.
+ *
+ * Usage:
+ *      SystemIdentificationEstimator estimator(config);
+ *      estimator.addSensorData(quad_data);
+ *      estimator.addThrustCommand(thrust_command);
+ *      double kt = estimator.getThrustGain();
+ *      double mass = estimator.getMass();
+ */
+class SystemIdentificationEstimator : public ThrustGainEstimator {
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param config Initial guesses and learning settings for the estimator
+   */
+  SystemIdentificationEstimator(SystemIdentificationEstimatorConfig config =
+                                    SystemIdentificationEstimatorConfig());
+  /**
+   * @brief reset thrust gain estimate and its covariance
+   *
+   * @param thrust_gain gain to reset to.
+   */
+  void resetThrustGain(double thrust_gain);
+  /**
+   * @brief Update the thrust gain assuming zero body velocity.
+   *
+   * @param roll current roll in radians under Euler ZYX convention
+   * @param pitch current pitch in radians under Euler ZYX convention
+   * @param body_z_acc Current body z acceleration in meters per second square
+   */
+  void addSensorData(double roll, double pitch, double body_z_acc);
+  /**
+   * @brief Update thrust gain, vertical drag and horizontal drag using the
+   * attitude, body acceleration and global velocity in quad data
+   *
+   * @param quad_data Current quad sensor data
+   */
+  void addSensorData(const parsernode::common::quaddata &quad_data);
+  /**
+   * @brief Effective mass of the vehicle including any payload
+   */
+  double getMass() const;
+  /**
+   * @brief Change in mass with respect to the nominal mass, e.g. after
+   * picking up an object
+   */
+  double getPayloadMass() const;
+  /**
+   * @brief Linear drag coefficient along body x and y axes (1/s)
+   */
+  double getDragXY() const;
+  /**
+   * @brief Linear drag coefficient along body z axis (1/s)
+   */
+  double getDragZ() const;
+
+private:
+  /**
+   * @brief Run the estimator updates for one sensor sample
+   *
+   * @param rotation Body rotation in global frame
+   * @param body_acc Body acceleration without gravity
+   * @param body_velocity Velocity in body frame
+   */
+  void update(const Eigen::Matrix3d &rotation, const Eigen::Vector3d &body_acc,
+              const Eigen::Vector3d &body_velocity);
+  /**
+   * @brief Estimator config
+   */
+  SystemIdentificationEstimatorConfig config_;
+  /**
+   * @brief Estimates [kt, drag_z] from body z acceleration
+   */
+  RecursiveLeastSquares<2> vertical_estimator_;
+  /**
+   * @brief Estimates drag_xy from body x and y acceleration
+   */
+  RecursiveLeastSquares<1> horizontal_estimator_;
+  /**
+   * @brief Thrust gain corresponding to nominal mass
+   */
+  const double nominal_thrust_gain_;
+
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
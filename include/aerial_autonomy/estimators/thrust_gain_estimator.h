@@ -1,6 +1,7 @@
 #pragma once
+#include "aerial_autonomy/common/ring_buffer.h"
 #include "thrust_gain_estimator_config.pb.h"
-#include <queue>
+#include <parsernode/common.h>
 
 /**
  * @brief Estimates the thrust gain given body acceleration, roll, pitch and
@@ -8,6 +9,11 @@
  */
 class ThrustGainEstimator {
 public:
+  /**
+   * @brief Maximum number of thrust commands that can be buffered to account
+   * for delay
+   */
+  static constexpr unsigned int max_buffer_size = 100;
   /**
    * @brief Estimates thrust gain given current roll, pitch, body z acceleration
    * and thrust commands
@@ -56,6 +62,10 @@ public:
                       unsigned int buffer_size = 1,
                       double max_thrust_gain = 0.25,
                       double min_thrust_gain = 0.1);
+  /**
+   * @brief Destructor
+   */
+  virtual ~ThrustGainEstimator() {}
   /**
    * @brief reset internal thrust gain to a specified value
    * This is to reset the estimator in case of failue in learning. If the
@@ -64,7 +74,7 @@ public:
    *
    * @param thrust_gain gain to reset to.
    */
-  void resetThrustGain(double thrust_gain);
+  virtual void resetThrustGain(double thrust_gain);
   /**
    * @brief process sensor data with the last available thrust command and
    * update internal thrust gain
@@ -82,19 +92,26 @@ public:
    * @param body_z_acc Current body z acceleration in meters per second square
    * (accelerometer reading)
    */
-  void addSensorData(double roll, double pitch, double body_z_acc);
+  virtual void addSensorData(double roll, double pitch, double body_z_acc);
+  /**
+   * @brief process quad sensor data with the last available thrust command.
+   * Uses the roll, pitch and body z acceleration in the quad data.
+   *
+   * @param quad_data Current quad sensor data
+   */
+  virtual void addSensorData(const parsernode::common::quaddata &quad_data);
   /**
    * @brief add thrust command to queue.
    * If queue is full, the command in front is discarded to mantain buffer size
    *
    * @param thrust_command the thrust command to add
    */
-  void addThrustCommand(double thrust_command);
+  virtual void addThrustCommand(double thrust_command);
   /**
    * @brief get current thrust gain
    * @return  current thrust gain
    */
-  double getThrustGain();
+  virtual double getThrustGain();
   /**
    * @brief process sensor data and thrust command to return estimated gain
    *
@@ -118,13 +135,13 @@ public:
    * estimator
    * is stopped and is restarting after a time.
    */
-  void clearBuffer();
+  virtual void clearBuffer();
 
-private:
+protected:
   /**
    * @brief Queue to store thrust commands to account for delay
    */
-  std::queue<double> thrust_command_queue_;
+  RingBuffer<double, max_buffer_size> thrust_command_queue_;
   /**
    * @brief The gain when multiplied should match the z acceleration in body
    * frame
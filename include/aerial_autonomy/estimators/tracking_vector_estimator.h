@@ -1,4 +1,7 @@
 #pragma once
+#include "aerial_autonomy/common/timebase.h"
+#include "aerial_autonomy/sensors/base_sensor.h"
+#include "aerial_autonomy/types/velocity.h"
 #include "tracking_vector_estimator_config.pb.h"
 #include <chrono>
 #include <glog/logging.h>
@@ -48,6 +51,11 @@ private:
    * marker measurements are not removed after consuming them once.
    */
   tf::Vector3 marker_dilation_stdev_;
+  /**
+   * @brief Stdeviation of the velocity used to move delayed marker
+   * measurements to the current time
+   */
+  tf::Vector3 velocity_stdev_;
   /**
    * @brief Create a opencv matrix given a diagonal vector
    *
@@ -80,6 +88,28 @@ private:
         << "Stdev vector should be greater than zero tolerance";
   }
 
+  /**
+   * @brief Set the measurement covariance growing with the measurement delay
+   *
+   * @param covariance_mat the matrix to set to
+   * @param marker_time_stamp the time stamp of the marker measurement
+   * @param dilation_stdev Growth of the measurement stdev per second of delay
+   */
+  void setMeasurementCovariance(cv::Mat &covariance_mat,
+                                timebase::TimePoint marker_time_stamp,
+                                const tf::Vector3 &dilation_stdev);
+  /**
+   * @brief Perform a single correction, inflating the measurement covariance
+   * by the given stdev per second of delay
+   *
+   * @param marker_direction Measured marker direction in global frame
+   * @param marker_time_stamp the time stamp of the marker measurement
+   * @param dilation_stdev Growth of the measurement stdev per second of delay
+   */
+  void correctMeasurement(tf::Vector3 marker_direction,
+                          timebase::TimePoint marker_time_stamp,
+                          const tf::Vector3 &dilation_stdev);
+
 public:
   /**
   * @brief Constructor
@@ -100,8 +130,23 @@ public:
   * @param marker_direction Measured marker direction in global frame
   */
   void correct(tf::Vector3 marker_direction,
-               std::chrono::time_point<std::chrono::high_resolution_clock>
-                   marker_time_stamp);
+               timebase::TimePoint marker_time_stamp);
+  /**
+  * @brief Perform a single correction using a delayed measurement
+  *
+  * The measurement is moved to the current time using the velocity at the
+  * marker time stamp, since the marker direction changes by the negative of
+  * the quadrotor displacement. The delay then only adds the velocity
+  * uncertainty to the measurement covariance instead of the marker dilation
+  *
+  * @param marker_direction Measured marker direction in global frame
+  * @param marker_time_stamp the time stamp of the marker measurement
+  * @param velocity_sensor Sensor providing the quadrotor velocity in global
+  * frame
+  */
+  void correct(tf::Vector3 marker_direction,
+               timebase::TimePoint marker_time_stamp,
+               Sensor<Velocity> &velocity_sensor);
   /**
   * @brief Initialize the state of the filter by setting the marker direction
   * and noise levels to initial state stdev from config.
@@ -165,8 +210,6 @@ public:
   * @param marker_time_stamp the time stamp when the marker message has been
   * received
   */
-  void setMeasurementCovariance(
-      cv::Mat &covariance_mat,
-      std::chrono::time_point<std::chrono::high_resolution_clock>
-          marker_time_stamp);
+  void setMeasurementCovariance(cv::Mat &covariance_mat,
+                                timebase::TimePoint marker_time_stamp);
 };
@@ -0,0 +1,86 @@
+#pragma once
+#include "arm_kinematics_config.pb.h"
+
+#include <Eigen/Dense>
+
+#include <vector>
+
+/**
+ * @brief Forward kinematics of a serial chain of revolute joints.
+ *
+ * Poses are expressed in the arm base frame. Joint frames are translated
+ * along the chain and rotated about their joint axis by the joint angle.
+ */
+class ArmKinematics {
+public:
+  /**
+  * @brief Geometric jacobian of end effector linear and angular velocity
+  */
+  using Jacobian = Eigen::Matrix<double, 6, Eigen::Dynamic>;
+  /**
+  * @brief Position and orientation error
+  */
+  using Vector6d = Eigen::Matrix<double, 6, 1>;
+
+  /**
+  * @brief Constructor
+  *
+  * @param config Arm geometry
+  */
+  ArmKinematics(ArmKinematicsConfig config);
+  /**
+  * @brief End effector pose at the given joint angles
+  *
+  * @param q Joint angles
+  */
+  Eigen::Matrix4d forwardKinematics(const Eigen::VectorXd &q) const;
+  /**
+  * @brief End effector pose and geometric jacobian at the given joint angles.
+  * Does not allocate if the jacobian already has one column per joint
+  *
+  * @param q Joint angles
+  * @param jacobian Returns the 6 x n jacobian in arm base frame
+  */
+  Eigen::Matrix4d forwardKinematics(const Eigen::VectorXd &q,
+                                    Jacobian &jacobian) const;
+  /**
+  * @brief Position and orientation error from a pose to a target pose, in
+  * arm base frame
+  */
+  static Vector6d poseError(const Eigen::Matrix4d &pose,
+                            const Eigen::Matrix4d &target);
+  /**
+  * @brief Number of joints
+  */
+  int size() const { return n_; }
+  /**
+  * @brief Lower joint limits
+  */
+  const Eigen::VectorXd &minAngles() const { return min_angles_; }
+  /**
+  * @brief Upper joint limits
+  */
+  const Eigen::VectorXd &maxAngles() const { return max_angles_; }
+  /**
+  * @brief Position of the first joint in arm base frame. Poses further than
+  * the reach from it cannot be reached
+  */
+  const Eigen::Vector3d &shoulder() const { return shoulder_; }
+  /**
+  * @brief Distance from the first joint to the furthest end effector
+  * position
+  */
+  double reach() const { return reach_; }
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+private:
+  const int n_;                               ///< Number of joints
+  std::vector<Eigen::Vector3d> axes_;         ///< Joint axes in joint frames
+  std::vector<Eigen::Vector3d> translations_; ///< Joint translations
+  Eigen::Vector3d end_effector_translation_;  ///< In last joint frame
+  Eigen::VectorXd min_angles_;                ///< Lower joint limits
+  Eigen::VectorXd max_angles_;                ///< Upper joint limits
+  Eigen::Vector3d shoulder_;                  ///< First joint position
+  double reach_;                              ///< Reach from the first joint
+};
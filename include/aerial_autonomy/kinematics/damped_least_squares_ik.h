@@ -0,0 +1,62 @@
+#pragma once
+#include "aerial_autonomy/kinematics/arm_kinematics.h"
+#include "arm_kinematics_config.pb.h"
+
+#include <Eigen/Dense>
+
+/**
+ * @brief Solves end effector poses into joint angles with damped least
+ * squares steps.
+ *
+ * Each solve runs at most a fixed number of iterations starting from the
+ * latest solution, so that consecutive goals at controller rate converge in
+ * a few iterations and a goal that moves away keeps being tracked over
+ * several solves. Joint angles are kept inside the joint limits. Solving does
+ * not allocate.
+ */
+class DampedLeastSquaresIK {
+public:
+  /**
+  * @brief Constructor. The solution starts with all joints at zero, clamped
+  * to the joint limits
+  *
+  * @param config Arm geometry and solver settings
+  */
+  DampedLeastSquaresIK(ArmInverseKinematicsConfig config);
+  /**
+  * @brief Start the next solve from the given joint angles, e.g. the current
+  * joint angles of the arm
+  *
+  * @param q Joint angles. Clamped to the joint limits
+  */
+  void reset(const Eigen::VectorXd &q);
+  /**
+  * @brief Move the solution towards an end effector pose
+  *
+  * @param target End effector pose in arm base frame
+  * @return True if the solution reaches the pose within the tolerances
+  */
+  bool solve(const Eigen::Matrix4d &target);
+  /**
+  * @brief Latest joint angles
+  */
+  const Eigen::VectorXd &getSolution() const { return q_; }
+  /**
+  * @brief Iterations run by the latest solve
+  */
+  int getIterations() const { return iterations_; }
+  /**
+  * @brief Arm geometry
+  */
+  const ArmKinematics &getKinematics() const { return kinematics_; }
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+private:
+  const ArmInverseKinematicsConfig config_; ///< Solver settings
+  const ArmKinematics kinematics_;          ///< Arm geometry
+  Eigen::VectorXd q_;                       ///< Latest solution
+  ArmKinematics::Jacobian jacobian_;        ///< Jacobian at the solution
+  Eigen::VectorXd q_step_;                  ///< Joint step of an iteration
+  int iterations_;                          ///< Iterations of latest solve
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include "aerial_autonomy/kinematics/arm_kinematics.h"
+
+#include <Eigen/Dense>
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Voxel grid of the end effector positions an arm can reach.
+ *
+ * The grid covers the cube around the first joint that contains the reach of
+ * the arm. Voxels are marked reachable by sampling joint angles uniformly
+ * inside the joint limits, and the voxels next to sampled ones are marked as
+ * well so that sampling gaps do not reject reachable positions. The map is
+ * therefore slightly optimistic at the workspace boundary, and orientations
+ * are not considered. The closest reachable voxel of every voxel is
+ * precomputed so that both lookups take constant time.
+ */
+class ReachabilityMap {
+public:
+  /**
+  * @brief Constructor. Builds the map
+  *
+  * @param kinematics Arm geometry
+  * @param voxel_size Edge of the voxels (m)
+  * @param samples Number of joint angle samples
+  * @param seed Seed of the joint angle samples
+  */
+  ReachabilityMap(const ArmKinematics &kinematics, double voxel_size,
+                  uint32_t samples, uint32_t seed = 0);
+  /**
+  * @brief Whether the end effector can reach a position
+  *
+  * @param position Position in arm base frame
+  */
+  bool isReachable(const Eigen::Vector3d &position) const;
+  /**
+  * @brief Center of the reachable voxel fewest voxel steps away from a
+  * position, or the position itself if it is reachable
+  *
+  * @param position Position in arm base frame
+  */
+  Eigen::Vector3d closestReachable(const Eigen::Vector3d &position) const;
+  /**
+  * @brief Fraction of the voxels that are reachable
+  */
+  double reachableFraction() const;
+
+private:
+  /**
+  * @brief Index of the voxel containing a position, clamped to the grid
+  */
+  uint32_t voxelIndex(const Eigen::Vector3d &position) const;
+  /**
+  * @brief Center of a voxel
+  */
+  Eigen::Vector3d voxelCenter(uint32_t index) const;
+
+  const double voxel_size_;        ///< Edge of the voxels
+  Eigen::Vector3d min_corner_;     ///< Corner of the grid with least x, y, z
+  int cells_;                      ///< Voxels along each axis
+  std::vector<uint8_t> reachable_; ///< Whether each voxel is reachable
+  std::vector<uint32_t> closest_;  ///< Closest reachable voxel of each voxel
+};
@@ -1,11 +1,36 @@
 #pragma once
 
+#include "aerial_autonomy/common/timebase.h"
 #include "data_stream_config.pb.h"
 
 #include <boost/filesystem.hpp>
 #include <boost/thread/mutex.hpp>
+#include <atomic>
 #include <chrono>
-#include <fstream>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <type_traits>
+#include <vector>
+
+#include <sys/uio.h>
+
+/**
+ * @brief Memory budget shared by the buffers of several data streams
+ */
+struct BufferBudget {
+  /**
+   * @brief Constructor
+   * @param limit Maximum number of bytes buffered. Zero disables the limit
+   */
+  explicit BufferBudget(uint64_t limit) : limit(limit), used(0) {}
+  const uint64_t limit;       ///< Maximum number of bytes buffered
+  std::atomic<uint64_t> used; ///< Number of bytes currently buffered
+};
+
+class FlightRecorderBuffer;
+class StreamCompressor;
 
 /**
  * @brief DataStream is a rate-limited output stream for data logging.
@@ -13,15 +38,41 @@
  * file.
  * This call will typically be done in a separate thread to ensure that logging
  * does not interfere with other tasks.
+ *
+ * Data points are time stamped with the nanoseconds of the process wide
+ * monotonic timebase. Time points of the timebase, e.g. the source time of
+ * sensor data, are logged in the same units so that latencies can be computed
+ * from the log.
+ *
+ * Completed data points are buffered until the next write. The buffer is
+ * bounded by the stream and the shared budget limits; when they are reached
+ * data points are dropped according to the stream drop policy and counted.
+ *
+ * Streams with a compression keep the values of data points as doubles and
+ * encode them when the buffer is written. Values that are not arithmetic
+ * types are parsed from their text representation.
+ *
+ * Streams with a flight recorder keep every data point, including the ones
+ * skipped by the log rate, in a ring holding the most recent data points.
+ * A dump hands an empty spare ring over to the logging thread through an
+ * atomic pointer and appends the recorded ring to the history of the previous
+ * dumps, so logging never waits for the dump. The logging thread only holds
+ * the recording ring while pushing a data point; data points of a stream are
+ * expected to be logged by one thread at a time.
  */
 class DataStream {
 public:
   /**
-  * @brief Constructor
+  * @brief Constructor. The file is only created if the stream logs data
   * @param path File path to write to
   * @param config Data stream configuration
+  * @param budget Memory budget shared with other streams (optional)
+  * @param flight_recorder_bytes Size of the flight recorder ring (bytes).
+  * Zero disables the flight recorder
   */
-  DataStream(boost::filesystem::path path, DataStreamConfig config);
+  DataStream(boost::filesystem::path path, DataStreamConfig config,
+             std::shared_ptr<BufferBudget> budget = nullptr,
+             uint64_t flight_recorder_bytes = 0);
 
   /**
   * @brief Move operator
@@ -30,10 +81,60 @@ public:
   DataStream(DataStream &&o);
 
   /**
-  * @brief Write the internal buffer to the file stream
+  * @brief Destructor releases the buffered bytes from the budget and closes
+  * the file
+  */
+  ~DataStream();
+
+  /**
+  * @brief Write the internal buffer to the file with a vectored write
   */
   void write();
 
+  /**
+  * @brief Write the flight recorder history as delimited text, starting with
+  * the last header. The history is kept for the next dump, and the data points
+  * recorded during the dump are added to it by the next dump. Should only be
+  * called by one thread at a time
+  * @param path File path to write to
+  * @param since Time stamp of the oldest data point to write (ns)
+  * @return False if the stream has no flight recorder or the file could not
+  * be written
+  */
+  bool dumpFlightRecorder(const boost::filesystem::path &path, int64_t since);
+
+  /**
+  * @brief Synchronize the file to disk
+  */
+  void sync();
+
+  /**
+  * @brief Close the current file, rename it to "<path>.<n>" and start a new
+  * file at the stream path beginning with the last header
+  * @param sync_file Synchronize the file to disk before closing it
+  */
+  void rotate(bool sync_file);
+
+  /**
+  * @brief Number of bytes written to the current file
+  */
+  uint64_t fileBytes() const;
+
+  /**
+  * @brief Time at which the current file was opened
+  */
+  std::chrono::steady_clock::time_point fileOpenTime() const;
+
+  /**
+  * @brief Number of data points dropped because the buffer was full
+  */
+  uint64_t droppedDataPoints() const;
+
+  /**
+  * @brief Number of bytes buffered for the next write
+  */
+  uint64_t bufferedBytes() const;
+
   /**
   * @brief Getter for config
   * @return Configuration
@@ -61,11 +162,46 @@ public:
   */
   template <class T> DataStream &operator<<(const T &t) {
     if (config_.log_data() && streaming_) {
-      data_point_ << config_.delimiter() << t;
+      if (compressor_ && !streaming_header_) {
+        values_.push_back(toDouble(t, std::is_arithmetic<T>()));
+      } else {
+        data_point_ << config_.delimiter() << t;
+      }
     }
     return *this;
   }
 
+  /**
+   * @brief Write several values to a data point. Compressed streams copy the
+   * values without formatting them
+   * @param values Values to write
+   * @param count Number of values
+   * @return modified DataStream
+   */
+  DataStream &appendValues(const double *values, size_t count);
+
+  /**
+   * @brief Streaming operator which writes a time point of the timebase to a
+   * data point as nanoseconds
+   * @param time Time point to write
+   * @return modified DataStream
+   */
+  DataStream &operator<<(const timebase::TimePoint &time) {
+    return *this << timebase::toNanoseconds(time);
+  }
+
+  /**
+   * @brief Start a data point time stamped with a given time point instead of
+   * the current time. The data point bypasses the log rate so that sources
+   * which are already sampled, e.g. buffered sensor data, are logged fully
+   *
+   * Like startl, the data point ends with DataStream::endl
+   *
+   * @param time Time stamp of the data point
+   * @return modified DataStream
+   */
+  DataStream &startAt(const timebase::TimePoint &time);
+
   /**
    * @brief DataStream modifier which signals the start of a data point
    * @param ds DataStream to modify
@@ -86,22 +222,127 @@ public:
   static DataStream &starth(DataStream &ds);
 
 private:
+  /**
+   * @brief Line buffered for the next write
+   */
+  struct BufferedLine {
+    std::string data; ///< Line including the newline
+    bool header;      ///< Whether the line is a header
+  };
+
+  /**
+  * @brief Convert an arithmetic value for compression
+  */
+  template <class T> static double toDouble(const T &t, std::true_type) {
+    return static_cast<double>(t);
+  }
+
+  /**
+  * @brief Convert a value for compression by parsing its text
+  * representation. Values that cannot be parsed are NaN
+  */
+  template <class T> static double toDouble(const T &t, std::false_type) {
+    std::stringstream ss;
+    ss << t;
+    double value;
+    return ss >> value ? value : std::numeric_limits<double>::quiet_NaN();
+  }
+
+  /**
+  * @brief Start a data point
+  * @param timestamp Time stamp of the data point (ns)
+  */
+  void startDataPoint(int64_t timestamp);
+
   /**
   * @brief Reset a string stream
   * @param ss String stream to reset
   */
   static void resetStringstream(std::stringstream &ss);
 
+  /**
+  * @brief Open the stream file, truncating it, and write the compressed
+  * stream prelude and the last header
+  */
+  void open();
+
+  /**
+  * @brief Add a completed line to the buffer, dropping data points if the
+  * buffer limits are reached
+  * @param line Line to add
+  * @param header Whether the line is a header. Headers are never dropped
+  */
+  void push(std::string line, bool header);
+
+  /**
+  * @brief Add a completed data point to the flight recorder, if any
+  * @param line Line of the data point
+  */
+  void record(const std::string &line);
+
+  /**
+  * @brief Check whether a line fits in the buffer limits
+  * @param size Size of the line
+  * @return True if the line fits
+  */
+  bool fits(uint64_t size) const;
+
+  /**
+  * @brief Write buffered lines to the file, handling partial writes
+  * @param lines Lines to write
+  */
+  void writeLines(const std::deque<BufferedLine> &lines);
+
+  /**
+  * @brief Write the vectored write descriptors to the file, handling partial
+  * writes
+  */
+  void writeIovecs();
+
+  /**
+  * @brief Encode buffered lines for a compressed stream
+  * @param lines Lines holding the header text or the data point timestamp
+  * followed by its values
+  * @param output Buffer to append the encoded lines to
+  */
+  void encodeLines(const std::deque<BufferedLine> &lines, std::string &output);
+
   DataStreamConfig config_;      ///< Configuration
   boost::filesystem::path path_; ///< Data filepath
-  std::chrono::time_point<std::chrono::high_resolution_clock>
-      last_write_time_; ///< Last time the buffer has been written to
-  std::fstream fs_;     ///< File stream that is written to
+  timebase::TimePoint last_write_time_; ///< Last time a data point was added
+  int fd_;              ///< File descriptor that is written to
   bool streaming_;      ///< Whether data is currently being recorded or not
-  std::stringstream buffer_;     ///< Stores several data points until they are
-                                 /// written to file stream
+  bool streaming_header_; ///< Whether the current data point is a header
+  bool buffering_;        ///< Whether the current data point is buffered for
+                          /// the file, i.e. not skipped by the log rate
   std::stringstream data_point_; ///< Stores the current data point while it is
                                  /// written to the DataStream (i.e. while
                                  /// streaming_ == true)
+  std::deque<BufferedLine> buffer_;  ///< Lines waiting for the next write
+  std::deque<BufferedLine> writing_; ///< Lines being written to file
+  uint64_t buffered_bytes_;          ///< Number of bytes in buffer_
+  std::string header_;               ///< Last header, repeated on rotation
+  std::shared_ptr<BufferBudget> budget_; ///< Budget shared between streams
+  std::atomic<uint64_t> dropped_;        ///< Number of dropped data points
+  uint64_t file_bytes_;                  ///< Bytes written to current file
+  std::chrono::steady_clock::time_point
+      file_open_time_;          ///< Time the current file was opened
+  unsigned int rotation_count_; ///< Number of rotated files
+  std::vector<iovec> iovecs_;   ///< Reused vectored write descriptors
+  std::unique_ptr<StreamCompressor> compressor_; ///< Encoder of compressed
+                                                 /// streams
+  int64_t timestamp_;          ///< Time of the current data point
+  std::vector<double> values_; ///< Values of the current compressed data point
+  std::string encoded_;        ///< Reused buffer of encoded lines
+  std::vector<std::unique_ptr<FlightRecorderBuffer>>
+      recorder_rings_; ///< Storage of the flight recorder rings
+  std::atomic<FlightRecorderBuffer *> recorder_; ///< Ring recording data
+                                                 /// points. Null while the
+                                                 /// logging thread pushes
+  FlightRecorderBuffer *spare_recorder_;   ///< Empty ring handed over to the
+                                           /// logging thread by dumps
+  FlightRecorderBuffer *history_recorder_; ///< Data points handed over by
+                                           /// the previous dumps
   mutable boost::mutex buffer_mutex_; ///< Synchronize access to the buffer
+  mutable boost::mutex file_mutex_;   ///< Synchronize access to the file
 };
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Fixed size byte ring holding the most recent data points of a data
+ * stream for the flight recorder.
+ *
+ * Each record is the time stamp of a data point followed by its buffered
+ * line. The storage is allocated once by the constructor; adding a record
+ * overwrites the oldest records until it fits, so recording never touches the
+ * heap. Not synchronized: the owning stream serializes access.
+ */
+class FlightRecorderBuffer {
+public:
+  /**
+  * @brief Constructor
+  * @param capacity Size of the ring (bytes), including 12 bytes of framing
+  * per record
+  */
+  explicit FlightRecorderBuffer(std::size_t capacity);
+
+  /**
+  * @brief Add a record, overwriting the oldest records if needed
+  * @param timestamp Time stamp of the data point (ns)
+  * @param data Line of the data point
+  * @param size Size of the line
+  * @return False if the record is larger than the ring and was not added
+  */
+  bool push(int64_t timestamp, const char *data, std::size_t size);
+
+  /**
+  * @brief Remove all the records
+  */
+  void clear();
+
+  /**
+  * @brief Number of records in the ring
+  */
+  std::size_t size() const { return records_; }
+
+  /**
+  * @brief Number of bytes used by the records
+  */
+  std::size_t bytes() const { return used_; }
+
+  /**
+  * @brief Visit the records from the oldest to the newest
+  * @param visitor Function taking the time stamp and the line of a record
+  */
+  template <class Visitor> void forEach(Visitor visitor) const {
+    std::size_t offset = begin_;
+    std::string line;
+    for (std::size_t i = 0; i < records_; ++i) {
+      uint32_t size;
+      int64_t timestamp;
+      offset = copyOut(offset, reinterpret_cast<char *>(&size), sizeof(size));
+      offset = copyOut(offset, reinterpret_cast<char *>(&timestamp),
+                       sizeof(timestamp));
+      line.resize(size);
+      offset = copyOut(offset, &line[0], size);
+      visitor(timestamp, line);
+    }
+  }
+
+private:
+  /**
+   * @brief Bytes framing each record: line size and time stamp
+   */
+  static constexpr std::size_t framing = sizeof(uint32_t) + sizeof(int64_t);
+
+  /**
+  * @brief Remove the oldest record
+  */
+  void popOldest();
+
+  /**
+  * @brief Copy bytes into the ring, wrapping around its end
+  * @param offset Ring offset to copy to
+  * @param data Bytes to copy
+  * @param size Number of bytes
+  * @return Ring offset following the copied bytes
+  */
+  std::size_t copyIn(std::size_t offset, const char *data, std::size_t size);
+
+  /**
+  * @brief Copy bytes out of the ring, wrapping around its end
+  * @param offset Ring offset to copy from
+  * @param data Destination of the bytes
+  * @param size Number of bytes
+  * @return Ring offset following the copied bytes
+  */
+  std::size_t copyOut(std::size_t offset, char *data, std::size_t size) const;
+
+  std::vector<char> storage_; ///< Ring storage
+  std::size_t begin_;         ///< Offset of the oldest record
+  std::size_t used_;          ///< Bytes used by the records
+  std::size_t records_;       ///< Number of records
+};
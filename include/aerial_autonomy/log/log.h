@@ -1,12 +1,16 @@
 #pragma once
 
 #include "aerial_autonomy/common/async_timer.h"
+#include "aerial_autonomy/common/timer_executor.h"
 #include "aerial_autonomy/log/data_stream.h"
 
 #include "log_config.pb.h"
 
+#include <atomic>
 #include <chrono>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include <boost/thread/recursive_mutex.hpp>
 
@@ -21,23 +25,92 @@
 
 /**
  * @brief Manages data log streams and a timer for periodically writing streams
- * to file
+ * to file.
+ *
+ * The timer thread is the single writer for all streams. Every write_duration
+ * it swaps out the buffer of each stream and writes it with one vectored
+ * write, then applies the fsync and rotation policies of the log config.
+ *
+ * Every log directory has a "timebase" stream mapping the monotonic time
+ * stamps of the streams to wall time and ROS time (zero when ROS time is not
+ * initialized). It is sampled once per second unless a stream config with the
+ * same id is provided.
+ *
+ * With a flight recorder duration, every stream also keeps its most recent
+ * data points at full rate in memory. A dump request only flags the log; the
+ * timer thread writes the history of the last flight_recorder_duration
+ * before the request to a "flight_record_<n>" folder of the log directory
+ * along with a "trigger" file holding the request time and reason.
+ *
+ * A process running several vehicles creates one Log per vehicle and makes it
+ * the instance of the threads working for the vehicle with Log::Scope, so the
+ * data streams of each vehicle are written to their own directory.
  */
 class Log {
 
 public:
   /**
-  * @brief Returns the only Log instance
-  * @return the Singleton instance
+  * @brief Makes a log the instance of the current thread while in scope
+  */
+  class Scope {
+  public:
+    /**
+    * @brief Constructor makes the log the instance of the current thread
+    * @param log Log returned by Log::instance until the scope ends
+    */
+    explicit Scope(Log &log) : previous_(scoped()) { scoped() = &log; }
+    /**
+    * @brief Destructor restores the previous instance of the thread
+    */
+    ~Scope() { scoped() = previous_; }
+    /**
+     * @brief Delete the copy constructor
+     */
+    Scope(const Scope &) = delete;
+    /**
+     * @brief Delete assign operator
+     */
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    Log *previous_; ///< Instance of the thread before the scope
+  };
+
+  /**
+  * @brief Returns the Log instance of the current thread, which is the
+  * process wide instance unless a Log::Scope is active
+  * @return the Log instance
   */
   static Log &instance() {
-    // The only instance
+    Log *log = scoped();
+    if (log) {
+      return *log;
+    }
+    // The only process wide instance
     // Guaranteed to be lazy initialized
     // Guaranteed that it will be destroyed correctly
     static Log instance;
     return instance;
   }
 
+  /**
+  * @brief Constructor for a log besides the process wide instance
+  * @param executor Executor running the write timer instead of a timer
+  * thread. Should outlive the log
+  */
+  explicit Log(TimerExecutor *executor)
+      : config_(),
+        log_timer_(std::bind(&Log::writeStreams, std::ref(*this)),
+                   std::chrono::milliseconds(config_.write_duration()),
+                   executor),
+        last_sync_time_(std::chrono::steady_clock::now()),
+        flight_recorder_enabled_(false), dump_requested_(false), dump_time_(0),
+        dump_count_(0) {
+    for (auto &pending_reason : pending_reasons_) {
+      pending_reason = nullptr;
+    }
+  }
+
   /**
   * @brief Destructor
   */
@@ -54,7 +127,15 @@ public:
   * @param id ID of DataStream to get
   * @return DataStream with ID id
   */
-  DataStream &operator[](std::string id);
+  DataStream &operator[](const std::string &id);
+
+  /**
+  * @brief Index operator for retrieving a data stream by a literal ID without
+  * allocating a key on every call
+  * @param id ID of DataStream to get
+  * @return DataStream with ID id
+  */
+  DataStream &operator[](const char *id);
 
   /**
   * @brief Add a data stream to the log
@@ -62,12 +143,49 @@ public:
   */
   void addDataStream(DataStreamConfig stream_config);
 
+  /**
+  * @brief Check whether the log has a data stream
+  * @param id ID of the DataStream
+  * @return True if the stream exists
+  */
+  bool hasDataStream(const std::string &id);
+
   /**
   * @brief Get the log directory
   * @return The path to the log directory
   */
   boost::filesystem::path directory();
 
+  /**
+  * @brief Request a dump of the flight recorder. Returns immediately; the
+  * dump is written by the timer thread. Requests made before the dump starts
+  * are merged into it
+  * @param reason Reason recorded in the trigger file of the dump
+  */
+  void dumpFlightRecorder(const std::string &reason);
+
+  /**
+  * @brief Request a dump of the flight recorder without locking or
+  * allocating, e.g. from a controller thread. Up to max_pending_reasons
+  * distinct reasons are recorded per dump
+  * @param reason Reason recorded in the trigger file of the dump. Should
+  * outlive the log, e.g. a string literal
+  */
+  void requestFlightRecorderDump(const char *reason);
+
+  /**
+  * @brief Number of flight recorder dumps written since the log was
+  * configured
+  */
+  unsigned int flightRecorderDumps();
+
+  /**
+  * @brief Get the number of dropped data points and buffered bytes of each
+  * stream as an html table for the system status
+  * @return Html table string
+  */
+  std::string getStatus();
+
   /**
    * @brief Delete the copy constructor
    *
@@ -94,12 +212,35 @@ private:
   void writeStreams();
 
   /**
-   * @brief Constructor for creating log
+  * @brief Write the requested flight recorder dump, if any. Called by the
+  * writer after the streams are written
+  */
+  void writeFlightRecord();
+
+  /**
+   * @brief Constructor for creating the process wide log
    */
-  Log()
-      : config_(),
-        log_timer_(std::bind(&Log::writeStreams, std::ref(*this)),
-                   std::chrono::milliseconds(config_.write_duration())) {}
+  Log() : Log(nullptr) {}
+
+  /**
+   * @brief Record the time of the first request merged into the next dump and
+   * flag the dump
+   */
+  void flagFlightRecorderDump();
+
+  /**
+   * @brief Maximum number of distinct reasons of lock free requests merged
+   * into a dump
+   */
+  static constexpr int max_pending_reasons = 4;
+
+  /**
+   * @brief Log made current by a Log::Scope on this thread, if any
+   */
+  static Log *&scoped() {
+    static thread_local Log *log = nullptr;
+    return log;
+  }
 
   /**
    * @brief Config specifying streams and frequencies etc
@@ -117,9 +258,50 @@ private:
    * @brief Log folder where logs are stored
    */
   boost::filesystem::path directory_;
+  /**
+   * @brief Memory budget shared by all the streams
+   */
+  std::shared_ptr<BufferBudget> budget_;
+  /**
+   * @brief Streams written by the timer. Reused between writes
+   */
+  std::vector<DataStream *> writing_streams_;
+  /**
+   * @brief Last time the streams were synchronized to disk
+   */
+  std::chrono::steady_clock::time_point last_sync_time_;
+  /**
+   * @brief Whether the configuration has a flight recorder
+   */
+  std::atomic<bool> flight_recorder_enabled_;
+  /**
+   * @brief Whether a flight recorder dump is requested
+   */
+  std::atomic<bool> dump_requested_;
+  /**
+   * @brief Time of the first request merged into the next dump (ns). Zero
+   * when no request is pending
+   */
+  std::atomic<int64_t> dump_time_;
+  /**
+   * @brief Reasons of the requests merged into the next dump
+   */
+  std::string dump_reason_;
+  /**
+   * @brief Reasons of the lock free requests merged into the next dump
+   */
+  std::atomic<const char *> pending_reasons_[max_pending_reasons];
+  /**
+   * @brief Number of flight recorder dumps written
+   */
+  std::atomic<unsigned int> dump_count_;
+  /**
+   * @brief Synchronize access to the dump request
+   */
+  boost::mutex dump_mutex_;
   /**
    * @brief Ensure creation/access/configure/write all
    * are synced even called from multiple threads
    */
-  boost::recursive_mutex streams_mutex;
+  boost::recursive_mutex streams_mutex_;
 };
@@ -0,0 +1,390 @@
+#pragma once
+#include "aerial_autonomy/log/log_reader.h"
+
+#include <boost/filesystem.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Sparse index entry pointing at a data point of a stream file
+ */
+struct StreamIndexEntry {
+  int64_t timestamp; ///< Timestamp of the data point
+  uint64_t offset;   ///< Byte offset of the data point in the file
+  int32_t segment;   ///< Segment of the data point
+};
+
+class StreamCursor;
+
+/**
+ * @brief Memory mapped data stream file with a sparse time index.
+ *
+ * Every index_stride-th data point is indexed so that time range queries
+ * only parse the data points in the range plus at most index_stride data
+ * points before it. Data point timestamps are assumed to be non decreasing,
+ * which holds for streams written by a single DataStream.
+ *
+ * The index can be saved next to the stream file and is loaded instead of
+ * scanning the file when the stream file has not changed since.
+ *
+ * Compressed streams are decoded to text in memory instead of being mapped
+ * and use their own delimiter. Their index refers to the decoded text.
+ */
+class MappedStream {
+public:
+  /**
+   * @brief Map a stream file and load or build its index.
+   *
+   * Throws std::runtime_error if the file cannot be mapped or does not start
+   * with a header
+   *
+   * @param path Path to the data stream file
+   * @param delimiter Delimiter used by the data stream
+   * @param index_stride Number of data points between index entries
+   */
+  MappedStream(boost::filesystem::path path, std::string delimiter = ",",
+               unsigned int index_stride = 1024);
+  /**
+   * @brief Destructor unmaps the file, if mapped
+   */
+  ~MappedStream();
+  /**
+   * @brief Delete copy constructor
+   */
+  MappedStream(const MappedStream &) = delete;
+  /**
+   * @brief Delete assignment operator
+   */
+  MappedStream &operator=(const MappedStream &) = delete;
+  /**
+   * @brief Get the column names excluding the time column
+   */
+  const std::vector<std::string> &columns() const;
+  /**
+   * @brief Get the schema of the data points parsed from the header
+   */
+  const RecordSchema &schema() const;
+  /**
+   * @brief Find the index of a column, i.e. of the first value of a field.
+   * Throws std::runtime_error if the stream does not have the column or a
+   * variable size field precedes it
+   */
+  size_t columnIndex(const std::string &column) const;
+  /**
+   * @brief Get the stream id, which is the file name of the stream
+   */
+  std::string streamId() const;
+  /**
+   * @brief Number of data points in the stream
+   */
+  uint64_t size() const;
+  /**
+   * @brief Timestamp of the first data point
+   */
+  int64_t startTime() const;
+  /**
+   * @brief Timestamp of the last data point
+   */
+  int64_t endTime() const;
+  /**
+   * @brief Whether the index was loaded from an index file
+   */
+  bool indexLoaded() const;
+  /**
+   * @brief Save the index next to the stream file.
+   * Throws std::runtime_error if the index file cannot be written
+   */
+  void saveIndex() const;
+  /**
+   * @brief Get the path of the index file of a stream file
+   */
+  static boost::filesystem::path
+  indexPath(const boost::filesystem::path &stream_path);
+  /**
+   * @brief Cursor over the data points with timestamps in [start, end]
+   *
+   * @param start Start time (inclusive)
+   * @param end End time (inclusive)
+   *
+   * @return Cursor positioned before the first data point in the range
+   */
+  StreamCursor cursor(
+      int64_t start = std::numeric_limits<int64_t>::min(),
+      int64_t end = std::numeric_limits<int64_t>::max()) const;
+  /**
+   * @brief Cursor over the data points up to end time starting from the
+   * indexed data point at or before the given time. Used to find the last
+   * data point before a time without scanning the whole stream.
+   *
+   * @param time Time to position the cursor before
+   * @param end End time (inclusive)
+   *
+   * @return Cursor positioned at most index_stride data points before time
+   */
+  StreamCursor cursorBefore(int64_t time, int64_t end) const;
+
+private:
+  friend class StreamCursor;
+  /**
+   * @brief Decode a compressed stream file, parse its header and load or
+   * build its index
+   */
+  void decodeCompressed();
+  /**
+   * @brief Parse the first header and check that it is a stream file
+   */
+  void parseHeader();
+  /**
+   * @brief Load the index file if it is up to date
+   * @return True if the index is loaded
+   */
+  bool loadIndex();
+  /**
+   * @brief Scan the file and build the sparse index
+   */
+  void buildIndex();
+  /**
+   * @brief Get the end of the line starting at an offset
+   */
+  uint64_t lineEnd(uint64_t offset) const;
+  /**
+   * @brief Parse the timestamp of the data point at an offset
+   */
+  int64_t parseTimestamp(uint64_t offset) const;
+  /**
+   * @brief Parse a data point line
+   *
+   * @param begin Offset of the line
+   * @param end Offset of the line end
+   * @param buffer Buffer reused to parse the line
+   * @param record Parsed data point
+   */
+  void parseRecord(uint64_t begin, uint64_t end, std::string &buffer,
+                   LogRecord &record) const;
+  /**
+   * @brief Index of the last entry with timestamp before time
+   */
+  size_t entryBefore(int64_t time) const;
+
+  boost::filesystem::path path_;        ///< Stream file path
+  std::string delimiter_;               ///< Delimiter between fields
+  unsigned int index_stride_;           ///< Data points between entries
+  int fd_;                              ///< File descriptor of the stream
+  const char *data_;                    ///< Mapped or decoded contents
+  std::string decoded_;                 ///< Decoded compressed stream
+  uint64_t file_size_;                  ///< Size of the contents
+  std::vector<std::string> columns_;    ///< Column names without time
+  RecordSchema schema_;                 ///< Fields declared by the columns
+  std::vector<StreamIndexEntry> index_; ///< Sparse time index
+  uint64_t record_count_;               ///< Number of data points
+  int64_t end_time_;                    ///< Timestamp of last data point
+  bool index_loaded_;                   ///< Whether index file was used
+};
+
+/**
+ * @brief Forward cursor over the data points of a mapped stream in a time
+ * range. Data points are parsed on demand.
+ */
+class StreamCursor {
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param stream Mapped stream
+   * @param offset Byte offset of the first data point to read
+   * @param segment Segment of the first data point
+   * @param start Data points before start are skipped
+   * @param end Cursor stops at the first data point after end
+   */
+  StreamCursor(const MappedStream &stream, uint64_t offset, int32_t segment,
+               int64_t start, int64_t end);
+  /**
+   * @brief Read the next data point in the range
+   *
+   * @param record Data point read. The values vector is reused
+   *
+   * @return False if there are no more data points in the range
+   */
+  bool next(LogRecord &record);
+
+private:
+  const MappedStream *stream_; ///< Stream to read from
+  uint64_t offset_;            ///< Offset of the next line
+  int32_t segment_;            ///< Segment of the next data point
+  int64_t start_;              ///< Start time (inclusive)
+  int64_t end_;                ///< End time (inclusive)
+  std::string buffer_;         ///< Line buffer reused across data points
+};
+
+/**
+ * @brief Time ordered iteration over the data points of several streams
+ */
+class MergedCursor {
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param cursors Stream cursors to merge
+   */
+  MergedCursor(std::vector<StreamCursor> cursors);
+  /**
+   * @brief Read the next data point across the streams. Data points with
+   * equal timestamps are returned in the order of the streams
+   *
+   * @param stream Index of the stream of the data point
+   * @param record Data point read
+   *
+   * @return False if all streams are exhausted
+   */
+  bool next(size_t &stream, LogRecord &record);
+
+private:
+  /**
+   * @brief Timestamp and stream index of the head of each stream
+   */
+  typedef std::pair<int64_t, size_t> QueueEntry;
+  std::vector<StreamCursor> cursors_; ///< Stream cursors
+  std::vector<LogRecord> heads_;      ///< Next data point of each stream
+  /**
+   * @brief Streams ordered by the timestamp of their next data point
+   */
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>,
+                      std::greater<QueueEntry>>
+      queue_;
+};
+
+/**
+ * @brief How stream values are computed at a resampled time
+ */
+enum class ResampleMethod {
+  Hold,  ///< Value of the last data point at or before the time
+  Linear ///< Linear interpolation between the surrounding data points
+};
+
+/**
+ * @brief Iterates over several streams sampled on a common time grid. Only
+ * streams with fixed size data points can be resampled; array and matrix
+ * fields are sampled element by element
+ */
+class ResampledCursor {
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param streams Streams to resample
+   * @param start Time of the first sample
+   * @param end Time after which sampling stops
+   * @param period Time between samples
+   * @param method Method used to compute values at sample times
+   *
+   * Throws std::runtime_error if a stream has variable size fields
+   */
+  ResampledCursor(std::vector<const MappedStream *> streams, int64_t start,
+                  int64_t end, std::chrono::nanoseconds period,
+                  ResampleMethod method);
+  /**
+   * @brief Column names of the samples as "stream_id/column", with array
+   * and matrix elements named as in RecordSchema::valueNames
+   */
+  const std::vector<std::string> &columns() const;
+  /**
+   * @brief Compute the next sample. Values of streams without data before
+   * the sample time are NaN
+   *
+   * @param time Sample time
+   * @param values Values of all stream columns
+   *
+   * @return False if the end time is reached
+   */
+  bool next(int64_t &time, std::vector<double> &values);
+
+private:
+  /**
+   * @brief Resampling state of a stream
+   */
+  struct StreamState {
+    StreamCursor cursor;  ///< Cursor over the stream
+    LogRecord previous;   ///< Last data point at or before the sample time
+    LogRecord upcoming;   ///< First data point after the sample time
+    bool has_previous;    ///< Whether previous is valid
+    bool has_upcoming;    ///< Whether upcoming is valid
+    size_t column_offset; ///< Offset of the stream columns in the sample
+    size_t column_count;  ///< Number of stream values
+  };
+  std::vector<StreamState> states_;  ///< State of each stream
+  std::vector<std::string> columns_; ///< Sample column names
+  int64_t time_;                     ///< Next sample time
+  int64_t end_;                      ///< End time
+  int64_t period_;                   ///< Sample period in nanoseconds
+  ResampleMethod method_;            ///< Resampling method
+  bool done_;                        ///< Whether the end time is reached
+};
+
+/**
+ * @brief Index over all the data streams in a log directory
+ * (see Log::directory)
+ */
+class LogIndex {
+public:
+  /**
+   * @brief Map and index every stream file in a log directory. Files that
+   * are not data streams are skipped. Throws std::runtime_error if the
+   * directory does not exist
+   *
+   * @param directory Log directory
+   * @param delimiter Delimiter used by the data streams
+   * @param index_stride Number of data points between index entries
+   */
+  LogIndex(boost::filesystem::path directory, std::string delimiter = ",",
+           unsigned int index_stride = 1024);
+  /**
+   * @brief Get the ids of the indexed streams in alphabetical order
+   */
+  std::vector<std::string> streamIds() const;
+  /**
+   * @brief Get a stream. Throws std::runtime_error if there is no stream
+   * with the id
+   */
+  const MappedStream &stream(const std::string &stream_id) const;
+  /**
+   * @brief Earliest timestamp across the non empty streams
+   */
+  int64_t startTime() const;
+  /**
+   * @brief Latest timestamp across the non empty streams
+   */
+  int64_t endTime() const;
+  /**
+   * @brief Save the index of every stream next to the stream file
+   */
+  void saveIndices() const;
+  /**
+   * @brief Time ordered iteration over the data points of several streams
+   * in the time range [start, end]
+   */
+  MergedCursor
+  merged(const std::vector<std::string> &stream_ids,
+         int64_t start = std::numeric_limits<int64_t>::min(),
+         int64_t end = std::numeric_limits<int64_t>::max()) const;
+  /**
+   * @brief Sample several streams on a common time grid from start to end
+   */
+  ResampledCursor resample(const std::vector<std::string> &stream_ids,
+                           int64_t start, int64_t end,
+                           std::chrono::nanoseconds period,
+                           ResampleMethod method = ResampleMethod::Hold) const;
+
+private:
+  /**
+   * @brief Indexed streams by stream id
+   */
+  std::map<std::string, std::unique_ptr<MappedStream>> streams_;
+};
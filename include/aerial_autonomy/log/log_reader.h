@@ -0,0 +1,114 @@
+#pragma once
+#include "aerial_autonomy/log/record_schema.h"
+
+#include <boost/filesystem.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A data point read from a data stream file
+ */
+struct LogRecord {
+  /**
+   * @brief Time stamp of the data point (nanoseconds of the monotonic
+   * timebase)
+   */
+  int64_t timestamp;
+  /**
+   * @brief Index of the header preceding the data point. A new header is
+   * written every time the logging component is constructed, so records with
+   * different segments come from different instances
+   */
+  int segment;
+  std::vector<double> values; ///< Values in the order of the stream columns
+};
+
+/**
+ * @brief Data points of a stream written by DataStream together with the
+ * column names from the stream header
+ *
+ * Columns declaring typed fields, e.g. arrays or matrices, hold several
+ * values of each data point; the record schema splits them back into fields.
+ */
+class RecordedStream {
+public:
+  /**
+   * @brief Read a data stream file
+   *
+   * Throws std::runtime_error if the file cannot be opened, a data point does
+   * not match the header or the headers in the file do not match.
+   * Compressed streams are decoded and use their own delimiter.
+   *
+   * @param path Path to the data stream file
+   * @param delimiter Delimiter used by the data stream
+   */
+  RecordedStream(boost::filesystem::path path, std::string delimiter = ",");
+  /**
+   * @brief Get the column names excluding the time column
+   */
+  const std::vector<std::string> &columns() const;
+  /**
+   * @brief Get the schema of the data points parsed from the header
+   */
+  const RecordSchema &schema() const;
+  /**
+   * @brief Get a field of a data point
+   *
+   * Throws std::runtime_error if the stream has no such field
+   *
+   * @param record Data point of the stream
+   * @param name Name of the field
+   *
+   * @return The field values
+   */
+  RecordField field(const LogRecord &record, const std::string &name) const;
+  /**
+   * @brief Get the data points in the order they were logged
+   */
+  const std::vector<LogRecord> &records() const;
+  /**
+   * @brief Find the index of a column, i.e. of the first value of a field
+   *
+   * Throws std::runtime_error if the stream does not have the column or a
+   * variable size field precedes it
+   *
+   * @param column Name of the column
+   *
+   * @return Index of the column in the record values
+   */
+  size_t columnIndex(const std::string &column) const;
+  /**
+   * @brief Check whether the stream has a column
+   */
+  bool hasColumn(const std::string &column) const;
+  /**
+   * @brief Get the stream id, which is the file name of the stream
+   */
+  std::string streamId() const;
+
+private:
+  /**
+   * @brief Read the data points of a compressed stream
+   */
+  void readCompressed();
+  /**
+   * @brief Set the columns from a header
+   * @param columns Header columns excluding the time column
+   * @param segment Index of the header
+   * @param location Location of the header for error messages
+   */
+  void setColumns(const std::vector<std::string> &columns, int segment,
+                  const std::string &location);
+  /**
+   * @brief Split a line into fields separated by the delimiter
+   */
+  std::vector<std::string> split(const std::string &line) const;
+
+  boost::filesystem::path path_;     ///< Path of the stream file
+  std::string delimiter_;            ///< Delimiter between fields
+  std::vector<std::string> columns_; ///< Column names without time
+  RecordSchema schema_;              ///< Fields declared by the columns
+  std::vector<LogRecord> records_;   ///< Data points
+};
@@ -0,0 +1,113 @@
+#pragma once
+#include "aerial_autonomy/log/log_reader.h"
+#include "log_replay_config.pb.h"
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Drives an algorithm with the inputs recorded in a data stream and
+ * produces the outputs to compare against the recorded outputs
+ */
+class StreamReplayer {
+public:
+  /**
+   * @brief Destructor
+   */
+  virtual ~StreamReplayer() {}
+  /**
+   * @brief Names of the recorded columns compared against the replayed
+   * outputs. The outputs of step are in the same order
+   */
+  virtual std::vector<std::string> outputColumns() const = 0;
+  /**
+   * @brief Find the input columns of the algorithm in the stream.
+   * Throws std::runtime_error if the stream does not have a column
+   *
+   * @param stream Stream that is replayed
+   */
+  virtual void initialize(const RecordedStream &stream) = 0;
+  /**
+   * @brief Reset the algorithm to its initial state. Called before the first
+   * record of every segment since the recorded component was reconstructed
+   */
+  virtual void reset() = 0;
+  /**
+   * @brief Run the algorithm on the inputs of a record
+   *
+   * @param values Recorded values in the order of the stream columns
+   * @param outputs Replayed outputs in the order of outputColumns
+   */
+  virtual void step(const std::vector<double> &values,
+                    std::vector<double> &outputs) = 0;
+};
+
+/**
+ * @brief Difference between replayed and recorded values of an output column
+ */
+struct ColumnDivergence {
+  std::string column;   ///< Name of the output column
+  double max_error;     ///< Maximum absolute error
+  double rms_error;     ///< Root mean square error
+  int divergent_ticks;  ///< Number of ticks with error above tolerance
+  int first_divergence; ///< First divergent tick or -1 if none
+};
+
+/**
+ * @brief Summary of replaying a stream
+ */
+struct ReplayResult {
+  std::string stream_id; ///< Stream that was replayed
+  int ticks;             ///< Number of replayed records
+  int segments;          ///< Number of recorded component instances
+  /**
+   * @brief Divergence of each output column
+   */
+  std::vector<ColumnDivergence> columns;
+  std::chrono::nanoseconds mean_tick_cost; ///< Mean time spent in step
+  std::chrono::nanoseconds max_tick_cost;  ///< Maximum time spent in step
+  std::chrono::nanoseconds recorded_duration; ///< Time span of the records
+  std::chrono::nanoseconds replay_duration;   ///< Time taken to replay
+  /**
+   * @brief Check whether any output column diverged
+   */
+  bool diverged() const;
+};
+
+/**
+ * @brief Print a human readable summary of a replay
+ *
+ * @param os Output stream
+ * @param result Replay summary
+ *
+ * @return Output stream
+ */
+std::ostream &operator<<(std::ostream &os, const ReplayResult &result);
+
+/**
+ * @brief Replays recorded streams tick by tick through a StreamReplayer
+ */
+class LogReplay {
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param config Replay rate and divergence tolerance
+   */
+  LogReplay(LogReplayConfig config = LogReplayConfig());
+  /**
+   * @brief Replay every record of a stream and compare the outputs of the
+   * replayer against the recorded outputs
+   *
+   * @param stream Recorded stream
+   * @param replayer Algorithm to drive with the recorded inputs
+   *
+   * @return Divergence and tick cost summary
+   */
+  ReplayResult replay(const RecordedStream &stream, StreamReplayer &replayer);
+
+private:
+  LogReplayConfig config_; ///< Replay configuration
+};
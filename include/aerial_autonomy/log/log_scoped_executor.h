@@ -0,0 +1,46 @@
+#pragma once
+
+#include "aerial_autonomy/common/timer_executor.h"
+#include "aerial_autonomy/log/log.h"
+
+/**
+ * @brief Runs tasks on another executor with a log as the Log instance, so
+ * that the data streams of the tasks go to that log
+ */
+class LogScopedExecutor : public TimerExecutor {
+public:
+  /**
+   * @brief Constructor
+   * @param executor Executor running the tasks. Should outlive this executor
+   * @param log Log made current while the tasks run
+   */
+  LogScopedExecutor(TimerExecutor &executor, Log &log)
+      : executor_(executor), log_(log) {}
+
+  /**
+   * @brief Run a task periodically with the log in scope
+   * @param task Function to call
+   * @param period The amount of time in between the start of each call
+   * @return Id of the scheduled task
+   */
+  int schedule(std::function<void()> task,
+               std::chrono::duration<double> period) {
+    Log &log = log_;
+    return executor_.schedule(
+        [&log, task]() {
+          Log::Scope scope(log);
+          task();
+        },
+        period);
+  }
+
+  /**
+   * @brief Stop calling a task
+   * @param id Id returned by schedule
+   */
+  void cancel(int id) { executor_.cancel(id); }
+
+private:
+  TimerExecutor &executor_; ///< Executor running the tasks
+  Log &log_;                ///< Log in scope while the tasks run
+};
@@ -1,28 +1,50 @@
 #pragma once
 
+#include <aerial_autonomy/sensors/mocap_capture.h>
+#include <aerial_autonomy/system_handlers/system_handler_context.h>
+
 #include <geometry_msgs/TransformStamped.h>
 #include <ros/ros.h>
 
 /**
 * @brief Helper class that records mocap data to a log file
+*
+* Poses are passed to a MocapCapture which logs every pose with the message
+* stamp as the time of the data point and the receive time as a column, and
+* provides the latest pose as a sensor
 */
 class MocapLogger {
 public:
   /**
   * @brief Constructor
   *
-  * Adds a header to log file
+  * Subscribes to the mocap poses
+  *
+  * @param config Capture configuration
+  * @param context Namespace and callback queue of the subscription and
+  * executor of the capture write timer
+  */
+  MocapLogger(MocapCaptureConfig config = MocapCaptureConfig(),
+              const SystemHandlerContext &context = SystemHandlerContext());
+  /**
+  * @brief Get the capture of the poses, e.g. to use as a sensor
   */
-  MocapLogger();
+  MocapCapture &capture();
 
 protected:
   /**
   * @brief subscriber function
   *
+  * Adds the pose to the capture buffer
+  *
   * @param data pose message obtained from mocap
   */
   void logData(const geometry_msgs::TransformStampedConstPtr data);
   /**
+  * @brief Buffers and logs the poses
+  */
+  MocapCapture capture_;
+  /**
   * @brief Nodehandle to create subscriber
   */
   ros::NodeHandle nh_;
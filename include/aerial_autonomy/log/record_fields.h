@@ -0,0 +1,125 @@
+#pragma once
+#include "aerial_autonomy/log/data_stream.h"
+#include "aerial_autonomy/log/record_schema.h"
+
+#include <Eigen/Dense>
+
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Helpers writing typed fields to data points. The values follow the
+ * layout of the field declared in the stream header, see RecordFieldType.
+ * Tagged unions are written as the index of the alternative followed by the
+ * values of the alternative.
+ *
+ * Example:
+ *   DATA_HEADER("mpc") << record_fields::variable("Trajectory", 4)
+ *                      << DataStream::endl;
+ *   DATA_LOG("mpc") << record_fields::rows(trajectory) << DataStream::endl;
+ */
+namespace record_fields {
+/**
+ * @brief Values of an Eigen matrix
+ * @tparam Derived Eigen expression type
+ */
+template <class Derived> struct MatrixValues {
+  const Eigen::DenseBase<Derived> &matrix; ///< Values in row major order
+  bool counted; ///< Whether the number of rows precedes the values
+};
+
+/**
+ * @brief Values of a vector of numbers
+ * @tparam T Arithmetic type
+ */
+template <class T> struct VectorValues {
+  static_assert(std::is_arithmetic<T>::value,
+                "Vector fields should hold numbers");
+  const std::vector<T> &vector; ///< Values
+  bool counted; ///< Whether the number of elements precedes the values
+};
+
+/**
+ * @brief Values of a fixed size array or matrix field
+ */
+template <class Derived>
+MatrixValues<Derived> fixed(const Eigen::DenseBase<Derived> &matrix) {
+  return MatrixValues<Derived>{matrix, false};
+}
+
+/**
+ * @brief Values of a fixed size array field
+ */
+template <class T> VectorValues<T> fixed(const std::vector<T> &vector) {
+  return VectorValues<T>{vector, false};
+}
+
+/**
+ * @brief Values of a variable number of rows field
+ */
+template <class Derived>
+MatrixValues<Derived> rows(const Eigen::DenseBase<Derived> &matrix) {
+  return MatrixValues<Derived>{matrix, true};
+}
+
+/**
+ * @brief Values of a variable length array field
+ */
+template <class T> VectorValues<T> list(const std::vector<T> &vector) {
+  return VectorValues<T>{vector, true};
+}
+
+/**
+ * @brief Write the values of a matrix field to a data point
+ * @param stream Data stream with a data point in progress
+ * @param values Values to write
+ * @return The data stream
+ */
+template <class Derived>
+DataStream &operator<<(DataStream &stream,
+                       const MatrixValues<Derived> &values) {
+  if (values.counted) {
+    stream << values.matrix.rows();
+  }
+  for (int i = 0; i < values.matrix.rows(); ++i) {
+    for (int j = 0; j < values.matrix.cols(); ++j) {
+      stream << double(values.matrix(i, j));
+    }
+  }
+  return stream;
+}
+
+/**
+ * @brief Write vector values one at a time
+ */
+template <class T>
+void appendVector(DataStream &stream, const std::vector<T> &vector) {
+  for (const T &value : vector) {
+    stream << value;
+  }
+}
+
+/**
+ * @brief Copy double values to the data point without formatting them
+ * separately
+ */
+inline void appendVector(DataStream &stream,
+                         const std::vector<double> &vector) {
+  stream.appendValues(vector.data(), vector.size());
+}
+
+/**
+ * @brief Write the values of a vector field to a data point
+ * @param stream Data stream with a data point in progress
+ * @param values Values to write
+ * @return The data stream
+ */
+template <class T>
+DataStream &operator<<(DataStream &stream, const VectorValues<T> &values) {
+  if (values.counted) {
+    stream << values.vector.size();
+  }
+  appendVector(stream, values.vector);
+  return stream;
+}
+}
@@ -0,0 +1,193 @@
+#pragma once
+#include <Eigen/Dense>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Type of a field of the data points of a stream, declared by a
+ * column of the stream header
+ *
+ * Declarations and the values each field adds to a data point:
+ * - "Name": one value
+ * - "Name[N]": fixed size array of N values
+ * - "Name[RxC]": fixed size R by C matrix, R * C values in row major order
+ * - "Name[]": variable length array, the number of elements followed by the
+ *   elements
+ * - "Name[?xC]": variable number of rows of C values, e.g. a trajectory, the
+ *   number of rows followed by the rows
+ * - "Name<A|B[N]|C[]>": tagged union, the index of the alternative followed
+ *   by the values of the alternative. Alternatives are declared like the
+ *   fields above except tagged unions
+ */
+struct RecordFieldType {
+  /**
+   * @brief Kind of field
+   */
+  enum Kind {
+    Scalar,   ///< Single value
+    Fixed,    ///< Fixed size array or matrix
+    Variable, ///< Variable number of rows
+    Tagged    ///< Tagged union of alternatives
+  };
+  /**
+   * @brief Parse a field declaration
+   *
+   * Throws std::runtime_error if the declaration is invalid
+   *
+   * @param declaration Column of the stream header
+   * @return Field type
+   */
+  static RecordFieldType parse(const std::string &declaration);
+  /**
+   * @brief Declaration of the field, i.e. the header column
+   */
+  std::string declaration() const;
+
+  std::string name; ///< Field name
+  Kind kind;        ///< Kind of field
+  size_t rows;      ///< Number of rows of fixed size fields
+  size_t cols;      ///< Number of columns of fixed and variable size fields
+  std::vector<RecordFieldType> alternatives; ///< Alternatives of tagged unions
+};
+
+/**
+ * @brief Values of a field of a data point
+ */
+struct RecordField {
+  std::string name; ///< Field name, or the name of the alternative of tagged
+                    /// unions
+  int tag; ///< Index of the alternative of tagged unions, -1 for other fields
+  Eigen::MatrixXd value; ///< Values of the field. Scalars are 1x1 matrices
+                         /// and arrays are column vectors
+};
+
+/**
+ * @brief Schema of the data points of a stream parsed from the columns of the
+ * stream header.
+ *
+ * Headers made of scalar columns only describe data points with one value per
+ * column as before. Typed fields are stored as consecutive values of the data
+ * point so that streams keep their text and compressed formats; the schema
+ * splits the values of a data point back into fields.
+ */
+class RecordSchema {
+public:
+  /**
+   * @brief Empty schema
+   */
+  RecordSchema();
+  /**
+   * @brief Parse the columns of a header
+   *
+   * Throws std::runtime_error if a column is not a valid field declaration
+   *
+   * @param columns Header columns excluding the time column
+   */
+  explicit RecordSchema(const std::vector<std::string> &columns);
+  /**
+   * @brief Get the field types in the order of the header
+   */
+  const std::vector<RecordFieldType> &fields() const;
+  /**
+   * @brief Check whether the schema has a field
+   */
+  bool hasField(const std::string &name) const;
+  /**
+   * @brief Whether every data point has the same number of values, i.e. the
+   * schema has no variable size or tagged fields
+   */
+  bool fixedSize() const;
+  /**
+   * @brief Number of values of the data points of fixed size schemas
+   */
+  size_t size() const;
+  /**
+   * @brief Offset of the first value of a field in the data point values
+   *
+   * Throws std::runtime_error if the schema has no such field or a variable
+   * size field precedes it
+   *
+   * @param name Name of the field
+   * @return Offset of the field values
+   */
+  size_t valueOffset(const std::string &name) const;
+  /**
+   * @brief Names of the values of fixed size schemas. Array and matrix
+   * elements are named "Name_i" and "Name_i_j"
+   *
+   * Throws std::runtime_error if the schema is not fixed size
+   */
+  std::vector<std::string> valueNames() const;
+  /**
+   * @brief Check whether the values of a data point match the schema
+   */
+  bool matches(const std::vector<double> &values) const;
+  /**
+   * @brief Split the values of a data point into fields
+   *
+   * Throws std::runtime_error if the values do not match the schema
+   *
+   * @param values Values of the data point
+   * @return Fields in the order of the schema
+   */
+  std::vector<RecordField> decode(const std::vector<double> &values) const;
+  /**
+   * @brief Get a field of a data point
+   *
+   * Throws std::runtime_error if the schema has no such field or the values
+   * do not match the schema
+   *
+   * @param values Values of the data point
+   * @param name Name of the field
+   * @return The field
+   */
+  RecordField field(const std::vector<double> &values,
+                    const std::string &name) const;
+
+private:
+  /**
+   * @brief Index of a field, or the number of fields if there is none
+   */
+  size_t fieldIndex(const std::string &name) const;
+
+  std::vector<RecordFieldType> fields_; ///< Field types
+};
+
+/**
+ * @brief Helpers declaring typed fields in stream headers
+ */
+namespace record_fields {
+/**
+ * @brief Declare a fixed size array
+ * @param name Field name
+ * @param size Number of elements
+ * @return Header column
+ */
+std::string array(const std::string &name, size_t size);
+/**
+ * @brief Declare a fixed size matrix stored in row major order
+ * @param name Field name
+ * @param rows Number of rows
+ * @param cols Number of columns
+ * @return Header column
+ */
+std::string matrix(const std::string &name, size_t rows, size_t cols);
+/**
+ * @brief Declare a variable number of rows
+ * @param name Field name
+ * @param cols Number of values per row. A single value declares a variable
+ * length array
+ * @return Header column
+ */
+std::string variable(const std::string &name, size_t cols = 1);
+/**
+ * @brief Declare a tagged union
+ * @param name Field name
+ * @param alternatives Declarations of the alternatives
+ * @return Header column
+ */
+std::string tagged(const std::string &name,
+                   const std::vector<std::string> &alternatives);
+}
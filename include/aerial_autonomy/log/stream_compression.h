@@ -0,0 +1,286 @@
+#pragma once
+#include "aerial_autonomy/log/log_reader.h"
+#include "data_stream_config.pb.h"
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Writes values bit by bit, most significant bit first
+ */
+class BitWriter {
+public:
+  /**
+   * @brief Constructor
+   */
+  BitWriter();
+  /**
+   * @brief Write the lowest bits of a value
+   * @param value Value to write
+   * @param bits Number of bits to write (1 to 64)
+   */
+  void write(uint64_t value, int bits);
+  /**
+   * @brief Write a single bit
+   */
+  void writeBit(bool bit);
+  /**
+   * @brief Check whether no bits have been written since the last flush
+   */
+  bool empty() const;
+  /**
+   * @brief Pad the written bits with zeros to a whole byte, append them to
+   * the output and start over
+   * @param output Buffer to append the bytes to
+   */
+  void flush(std::string &output);
+
+private:
+  std::string bytes_; ///< Completed bytes
+  uint8_t current_;   ///< Byte being filled
+  int used_;          ///< Number of bits used in the current byte
+};
+
+/**
+ * @brief Reads values written by BitWriter
+ */
+class BitReader {
+public:
+  /**
+   * @brief Constructor
+   * @param data Bytes to read
+   * @param size Number of bytes
+   */
+  BitReader(const char *data, size_t size);
+  /**
+   * @brief Read a value
+   *
+   * Throws std::runtime_error when reading past the end of the data
+   *
+   * @param bits Number of bits to read (1 to 64)
+   * @return Value read
+   */
+  uint64_t read(int bits);
+  /**
+   * @brief Read a single bit
+   */
+  bool readBit();
+
+private:
+  const uint8_t *data_; ///< Bytes to read
+  size_t size_;         ///< Number of bytes
+  size_t position_;     ///< Index of the next bit
+};
+
+/**
+ * @brief Encoder state shared by the compressor and the decompressor
+ *
+ * Timestamps are stored as the difference between consecutive timestamp
+ * deltas. XOR compression stores the XOR of each value with the previous
+ * value of its column, reusing the window of meaningful bits of the previous
+ * XOR when possible. QUANTIZED compression rounds values to multiples of the
+ * quantization step and stores the difference with the previous value of the
+ * column. Timestamp and quantized differences reuse the bit width of the
+ * previous difference when it fits. The state starts at zero so the first
+ * data point needs no special case.
+ */
+class StreamCodec {
+public:
+  /**
+   * @brief Constructor
+   * @param compression Compression of the values
+   * @param quantization Quantization step for QUANTIZED compression
+   */
+  StreamCodec(DataStreamConfig::Compression compression, double quantization);
+  /**
+   * @brief Reset the state at the start of a file or after a header
+   */
+  void reset();
+  /**
+   * @brief Encode a data point
+   * @param timestamp Time of the data point
+   * @param values Values of the data point
+   * @param count Number of values
+   * @param writer Writer for the encoded bits
+   */
+  void encode(int64_t timestamp, const double *values, size_t count,
+              BitWriter &writer);
+  /**
+   * @brief Decode a data point
+   * @param reader Reader of the encoded bits
+   * @param timestamp Returns the time of the data point
+   * @param values Returns the values of the data point
+   */
+  void decode(BitReader &reader, int64_t &timestamp,
+              std::vector<double> &values);
+
+private:
+  /**
+   * @brief Previous value of a column
+   */
+  struct ColumnState {
+    uint64_t bits;      ///< Bits of the previous value (XOR)
+    int leading;        ///< Leading zeros of the previous XOR
+    int trailing;       ///< Trailing zeros of the previous XOR
+    uint64_t quantized; ///< Previous quantized value (QUANTIZED)
+    int width;          ///< Bits of the previous quantized difference
+  };
+  /**
+   * @brief Resize the column state, keeping the state of the remaining
+   * columns
+   */
+  void resize(size_t count);
+  /**
+   * @brief Encode a value with XOR compression
+   */
+  void encodeXor(double value, ColumnState &state, BitWriter &writer);
+  /**
+   * @brief Decode a value with XOR compression
+   */
+  double decodeXor(ColumnState &state, BitReader &reader);
+  /**
+   * @brief Encode a value with QUANTIZED compression
+   */
+  void encodeQuantized(double value, ColumnState &state, BitWriter &writer);
+  /**
+   * @brief Decode a value with QUANTIZED compression
+   */
+  double decodeQuantized(ColumnState &state, BitReader &reader);
+
+  const DataStreamConfig::Compression compression_; ///< Value compression
+  const double quantization_;        ///< Quantization step
+  uint64_t previous_timestamp_;      ///< Previous timestamp
+  uint64_t previous_delta_;          ///< Previous timestamp difference
+  int timestamp_width_;              ///< Bits of the previous timestamp code
+  std::vector<ColumnState> columns_; ///< Previous values of the columns
+};
+
+/**
+ * @brief Encodes the lines of a data stream into the compressed file format
+ *
+ * A compressed file starts with a prelude holding the compression parameters
+ * and the delimiter, followed by header records holding the header text and
+ * block records holding encoded data points. The codec state carries over
+ * between blocks and is reset by every header so that memory stays bounded by
+ * the data points of a single block.
+ */
+class StreamCompressor {
+public:
+  /**
+   * @brief Constructor
+   * @param config Configuration of the stream with a compression other than
+   * NONE
+   */
+  explicit StreamCompressor(const DataStreamConfig &config);
+  /**
+   * @brief Reset the codec and append the file prelude
+   * @param output Buffer to append to
+   */
+  void start(std::string &output);
+  /**
+   * @brief Append the pending block and a header record, and reset the codec
+   * @param header Header text without the newline
+   * @param output Buffer to append to
+   */
+  void addHeader(const std::string &header, std::string &output);
+  /**
+   * @brief Add a data point to the pending block
+   * @param timestamp Time of the data point
+   * @param values Values of the data point
+   * @param count Number of values
+   */
+  void addDataPoint(int64_t timestamp, const double *values, size_t count);
+  /**
+   * @brief Append the pending block if it has data points
+   * @param output Buffer to append to
+   */
+  void flush(std::string &output);
+
+private:
+  DataStreamConfig config_; ///< Stream configuration
+  StreamCodec codec_;       ///< Codec state
+  BitWriter writer_;        ///< Bits of the pending block
+  std::string block_;       ///< Bytes of the pending block
+  uint32_t block_count_;    ///< Data points in the pending block
+};
+
+/**
+ * @brief Reads a compressed data stream line by line
+ */
+class CompressedStreamReader {
+public:
+  /**
+   * @brief Read the prelude of a compressed stream
+   *
+   * Throws std::runtime_error if the input is not a compressed stream
+   *
+   * @param input Compressed stream
+   */
+  explicit CompressedStreamReader(std::istream &input);
+  /**
+   * @brief Check whether a file is a compressed stream
+   */
+  static bool isCompressed(const std::string &path);
+  /**
+   * @brief Read the next line
+   *
+   * A truncated last block, e.g. after a crash, ends the stream. Throws
+   * std::runtime_error if the data is corrupted
+   *
+   * @return False at the end of the stream
+   */
+  bool next();
+  /**
+   * @brief Whether the last line read is a header
+   */
+  bool isHeader() const;
+  /**
+   * @brief Last header read, without the newline
+   */
+  const std::string &header() const;
+  /**
+   * @brief Last data point read. Segments count the headers as in
+   * RecordedStream
+   */
+  const LogRecord &record() const;
+  /**
+   * @brief Delimiter of the stream
+   */
+  const std::string &delimiter() const;
+  /**
+   * @brief Number of significant digits of the stream configuration
+   */
+  int precision() const;
+
+private:
+  /**
+   * @brief Read the next record of the file
+   * @return False at the end of the file
+   */
+  bool readRecord();
+
+  std::istream &input_;                ///< Compressed stream
+  std::string delimiter_;              ///< Stream delimiter
+  int precision_;                      ///< Stream precision
+  std::unique_ptr<StreamCodec> codec_; ///< Codec state
+  std::string block_;                  ///< Bytes of the current block
+  std::unique_ptr<BitReader> reader_;  ///< Reader of the current block
+  uint32_t block_remaining_;           ///< Data points left in the block
+  bool is_header_;                     ///< Whether the last line is a header
+  std::string header_;                 ///< Last header
+  LogRecord record_;                   ///< Last data point
+};
+
+/**
+ * @brief Write a compressed stream as delimited text
+ * @param input Compressed stream
+ * @param output Text output
+ * @param precision Significant digits of the values. Negative values use the
+ * precision of the stream configuration
+ */
+void decompressStream(std::istream &input, std::ostream &output,
+                      int precision = -1);
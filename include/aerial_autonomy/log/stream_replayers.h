@@ -0,0 +1,100 @@
+#pragma once
+#include "aerial_autonomy/controllers/rpyt_based_velocity_controller.h"
+#include "aerial_autonomy/estimators/thrust_gain_estimator.h"
+#include "aerial_autonomy/log/log_replay.h"
+
+#include <memory>
+
+/**
+ * @brief Replays the "thrust_gain_estimator" stream through a thrust gain
+ * estimator.
+ *
+ * The stream records the delayed thrust command used for each sensor update,
+ * so the estimator is replayed without a delay buffer. Every sensor update
+ * must be recorded, i.e the stream log rate should be above the controller
+ * rate, for the replayed gain to match the recorded gain.
+ */
+class ThrustGainEstimatorReplayer : public StreamReplayer {
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param config Estimator config used while recording
+   */
+  ThrustGainEstimatorReplayer(
+      ThrustGainEstimatorConfig config = ThrustGainEstimatorConfig());
+  /**
+   * @brief Replayed estimator outputs
+   */
+  std::vector<std::string> outputColumns() const;
+  /**
+   * @brief Find the estimator inputs in the stream
+   */
+  void initialize(const RecordedStream &stream);
+  /**
+   * @brief Create a new estimator with the initial thrust gain
+   */
+  void reset();
+  /**
+   * @brief Add a recorded sensor thrust pair to the estimator
+   */
+  void step(const std::vector<double> &values, std::vector<double> &outputs);
+
+private:
+  ThrustGainEstimatorConfig config_;               ///< Estimator config
+  std::unique_ptr<ThrustGainEstimator> estimator_; ///< Replayed estimator
+  size_t roll_index_;           ///< Column index of roll
+  size_t pitch_index_;          ///< Column index of pitch
+  size_t body_z_acc_index_;     ///< Column index of body z acceleration
+  size_t thrust_command_index_; ///< Column index of delayed thrust command
+};
+
+/**
+ * @brief Replays the "rpyt_based_velocity_controller" stream through an RPYT
+ * based velocity controller.
+ *
+ * The integral action depends on every control tick, so the stream log rate
+ * should be above the controller rate when the integral gains are non zero.
+ */
+class RPYTBasedVelocityControllerReplayer : public StreamReplayer {
+public:
+  /**
+   * @brief Constructor
+   *
+   * @param config Controller config used while recording
+   * @param controller_timer_duration Controller timestep used while recording
+   */
+  RPYTBasedVelocityControllerReplayer(
+      RPYTBasedVelocityControllerConfig config,
+      std::chrono::duration<double> controller_timer_duration);
+  /**
+   * @brief Replayed roll, pitch, yaw rate and thrust commands
+   */
+  std::vector<std::string> outputColumns() const;
+  /**
+   * @brief Find the controller inputs in the stream
+   */
+  void initialize(const RecordedStream &stream);
+  /**
+   * @brief Create a new controller with zero cumulative error
+   */
+  void reset();
+  /**
+   * @brief Run the controller on the recorded velocity, yaw and goal
+   */
+  void step(const std::vector<double> &values, std::vector<double> &outputs);
+
+private:
+  RPYTBasedVelocityControllerConfig config_; ///< Controller config
+  /**
+   * @brief Controller timestep
+   */
+  std::chrono::duration<double> controller_timer_duration_;
+  /**
+   * @brief Replayed controller
+   */
+  std::unique_ptr<RPYTBasedVelocityController> controller_;
+  std::vector<size_t> velocity_indices_; ///< Column indices of Vx..Yawrate
+  std::vector<size_t> goal_indices_;     ///< Column indices of the goal
+  size_t yaw_index_;                     ///< Column index of yaw
+};
@@ -8,6 +8,7 @@
 #include <aerial_autonomy/controller_connectors/arm_sine_controller_connector.h>
 #include <aerial_autonomy/controller_connectors/builtin_pose_controller_arm_connector.h>
 #include <aerial_autonomy/controllers/builtin_controller.h>
+#include <aerial_autonomy/simulators/arm_dynamics_simulator.h>
 
 // Arm hardware
 #include <arm_parsers/arm_parser.h>
@@ -218,6 +219,14 @@ protected:
         arm_parser_pointer = ArmParserPtr(new SimpleArm());
       } else if (arm_parser_type == "ArmSimulator") {
         arm_parser_pointer = ArmParserPtr(new ArmSimulator());
+      } else if (arm_parser_type == "ArmDynamicsSimulator") {
+        const auto &simulator_config = config.arm_dynamics_simulator_config();
+        std::shared_ptr<ArmDynamicsSimulator> simulator(
+            new ArmDynamicsSimulator(simulator_config));
+        // Nothing else advances the virtual clock of the arm hardware
+        simulator->startRealTime(std::chrono::duration<double>(
+            simulator_config.real_time_period()));
+        arm_parser_pointer = simulator;
       } else {
         throw std::runtime_error("Unknown arm parser type provided: " +
                                  arm_parser_type);
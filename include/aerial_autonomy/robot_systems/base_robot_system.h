@@ -3,15 +3,23 @@
 #include <aerial_autonomy/controller_connectors/base_controller_connector.h>
 // Store type_map
 #include <aerial_autonomy/common/type_map.h>
-// Iterable Enum
-#include <aerial_autonomy/common/iterable_enum.h>
+// Reader hand-off for active controllers
+#include <aerial_autonomy/common/epoch_gate.h>
 // Boost thread stuff
-#include <boost/thread/mutex.hpp>
-// Unique ptr
-#include <memory>
+#include <boost/thread/recursive_mutex.hpp>
+// Fixed size arrays
+#include <array>
+#include <atomic>
 
 /**
  * @brief Provides functions to switch between active controllers and get goals
+ *
+ * The active connector of each controller group is an atomic pointer in an
+ * array indexed by the group. Running the active controller and querying
+ * statuses only load the pointer, so they never wait for a controller switch.
+ * Activation and abort are serialized with each other; after replacing the
+ * active connector they wait, through an epoch gate, for runs of the replaced
+ * connector to finish before disengaging it.
 */
 class BaseRobotSystem {
 
@@ -23,40 +31,63 @@ protected:
 
 private:
   /**
-  * @brief Map to store active controller based on controller group
+  * @brief Number of controller groups
   */
-  std::map<ControllerGroup, AbstractControllerConnector *> active_controllers_;
+  static constexpr int controller_group_count_ =
+      static_cast<int>(ControllerGroup::Last) + 1;
   /**
-  * @brief Map to lock and swap the active controller for a given
-  * controller group
+  * @brief Active controller of each controller group
   */
-  std::map<ControllerGroup, std::unique_ptr<boost::mutex>> thread_mutexes_;
+  std::array<std::atomic<AbstractControllerConnector *>,
+             controller_group_count_>
+      active_controllers_;
+  /**
+  * @brief Gates entered by runs of the active controller of each group
+  */
+  std::array<EpochGate, controller_group_count_> run_gates_;
+  /**
+  * @brief Serializes activation and abort including dependent connectors
+  */
+  boost::recursive_mutex transition_mutex_;
+
+  /**
+  * @brief Index of a controller group in the arrays
+  */
+  static int index(ControllerGroup controller_group) {
+    return static_cast<int>(controller_group);
+  }
 
 public:
   /**
-  * @brief Constructor to initialize active controllers and mutexes to NULL
+  * @brief Constructor to initialize active controllers to NULL
   */
   BaseRobotSystem() {
-    // Initialize active controller map
-    for (auto controller_group : IterableEnum<ControllerGroup>()) {
-      active_controllers_.emplace(controller_group, nullptr);
-      thread_mutexes_[controller_group] =
-          std::unique_ptr<boost::mutex>(new boost::mutex);
+    for (auto &active_controller : active_controllers_) {
+      active_controller = nullptr;
     }
   }
 
+  /**
+  * @brief Make a connector and its dependent connectors active. A connector
+  * replaced in its group is not disengaged but stops running before this
+  * returns.
+  *
+  * @param controller_connector Connector to activate
+  */
   void activateControllerConnector(
       AbstractControllerConnector *controller_connector) {
     if (controller_connector == nullptr) {
       throw std::runtime_error(
           "null pointer provided for activating controller connector");
     }
+    boost::recursive_mutex::scoped_lock lock(transition_mutex_);
     controller_connector->initialize();
-    ControllerGroup controller_group =
-        controller_connector->getControllerGroup();
-    if (active_controllers_[controller_group] != controller_connector) {
-      boost::mutex::scoped_lock lock(*thread_mutexes_[controller_group]);
-      active_controllers_[controller_group] = controller_connector;
+    int group = index(controller_connector->getControllerGroup());
+    AbstractControllerConnector *const previous_controller =
+        active_controllers_[group].exchange(controller_connector);
+    if (previous_controller != nullptr &&
+        previous_controller != controller_connector) {
+      run_gates_[group].synchronize();
     }
     AbstractControllerConnector *dependent_connector =
         controller_connector->getDependentConnector();
@@ -76,7 +107,8 @@ public:
   template <class ControllerConnectorT, class GoalT> void setGoal(GoalT goal) {
     ControllerConnectorT *controller_connector =
         controller_connector_container_.getObject<ControllerConnectorT>();
-    if(controller_connector != nullptr) {
+    boost::recursive_mutex::scoped_lock lock(transition_mutex_);
+    if (controller_connector != nullptr) {
       ControllerGroup controller_group =
           controller_connector->getControllerGroup();
       abortController(controller_group);
@@ -85,6 +117,27 @@ public:
     activateControllerConnector(controller_connector);
   }
   /**
+  * @brief Update the goal of a connector that is already active without
+  * aborting and resetting it. Used to track references that move every tick.
+  * If the connector is not active, the goal is set using setGoal.
+  *
+  * @tparam ControllerConnectorT Type of connector to use
+  * @tparam GoalT Type of Goal to set
+  * @param goal Goal to set
+  */
+  template <class ControllerConnectorT, class GoalT>
+  void updateGoal(GoalT goal) {
+    ControllerConnectorT *controller_connector =
+        controller_connector_container_.getObject<ControllerConnectorT>();
+    if (controller_connector != nullptr &&
+        active_controllers_[index(controller_connector->getControllerGroup())]
+                .load() == controller_connector) {
+      controller_connector->updateGoal(goal);
+    } else {
+      setGoal<ControllerConnectorT, GoalT>(goal);
+    }
+  }
+  /**
   * @brief Get the goal from connector.
   *
   * @tparam ControllerConnectorT Type of connector to use
@@ -108,10 +161,9 @@ public:
   template <class ControllerConnectorT> ControllerStatus getStatus() const {
     const ControllerConnectorT *controller_connector =
         controller_connector_container_.getObject<ControllerConnectorT>();
-    auto active_controller =
-        active_controllers_.find(controller_connector->getControllerGroup());
-    if (active_controller == active_controllers_.end() ||
-        controller_connector != active_controller->second) {
+    if (controller_connector !=
+        active_controllers_[index(controller_connector->getControllerGroup())]
+            .load()) {
       return ControllerStatus::NotEngaged;
     }
     return controller_connector->getStatus();
@@ -127,31 +179,32 @@ public:
   */
   ControllerStatus
   getActiveControllerStatus(ControllerGroup controller_group) const {
-    auto active_controller = active_controllers_.find(controller_group);
-    if (active_controller != active_controllers_.end() &&
-        active_controller->second != nullptr) {
-      return active_controller->second->getStatus();
+    AbstractControllerConnector *active_controller =
+        active_controllers_[index(controller_group)].load();
+    if (active_controller != nullptr) {
+      return active_controller->getStatus();
     } else {
       return ControllerStatus(ControllerStatus::NotEngaged);
     }
   }
 
   /**
-  * @brief Remove active controller for given controller group
+  * @brief Remove active controller for given controller group. The
+  * connector is disengaged after its last run finishes, so this must not be
+  * called from a run of the same group.
   *
   * @param controller_group group for which active controller is
   * switched off
   */
   void abortController(ControllerGroup controller_group) {
+    boost::recursive_mutex::scoped_lock lock(transition_mutex_);
+    int group = index(controller_group);
     AbstractControllerConnector *const active_controller =
-        active_controllers_[controller_group];
+        active_controllers_[group].exchange(nullptr);
     if (active_controller != nullptr) {
-      // Disengage the controller
-      {
-        boost::mutex::scoped_lock lock(*thread_mutexes_[controller_group]);
-        active_controller->disengage();
-        active_controllers_[controller_group] = nullptr;
-      }
+      // Disengage the controller once it stops running
+      run_gates_[group].synchronize();
+      active_controller->disengage();
       AbstractControllerConnector *dependent_connector =
           active_controller->getDependentConnector();
       if (dependent_connector != nullptr) {
@@ -163,16 +216,18 @@ public:
   }
 
   /**
-  * @brief Run active controller stored for a given controller group
+  * @brief Run active controller stored for a given controller group. Does
+  * not wait for concurrent controller switches; a connector replaced during
+  * the run finishes the run before it is disengaged.
   *
   * @param controller_group group for which active controller is run
   */
   void runActiveController(ControllerGroup controller_group) {
-    // lock to ensure active_control fcn is not changed
+    int group = index(controller_group);
+    EpochGate::Guard guard = run_gates_[group].enter();
     AbstractControllerConnector *const active_controller =
-        active_controllers_[controller_group];
+        active_controllers_[group].load();
     if (active_controller != nullptr) {
-      boost::mutex::scoped_lock lock(*thread_mutexes_[controller_group]);
       active_controller->run();
     }
   }
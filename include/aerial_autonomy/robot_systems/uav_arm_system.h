@@ -37,7 +37,10 @@ public:
                                       .position_controller_config()),
         visual_servoing_arm_connector_(
             *tracker_, *drone_hardware_, *arm_hardware_,
-            relative_pose_controller_, camera_transform_, arm_transform_) {
+            relative_pose_controller_, camera_transform_, arm_transform_,
+            config_.uav_vision_system_config()
+                .uav_arm_system_config()
+                .arm_inverse_kinematics_config()) {
     controller_connector_container_.setObject(visual_servoing_arm_connector_);
   }
 
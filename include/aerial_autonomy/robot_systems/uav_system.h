@@ -10,6 +10,7 @@
 #include <aerial_autonomy/controllers/joystick_velocity_controller.h>
 #include <aerial_autonomy/controllers/rpyt_based_position_controller.h>
 // Estimators
+#include <aerial_autonomy/estimators/system_identification_estimator.h>
 #include <aerial_autonomy/estimators/thrust_gain_estimator.h>
 // Specific ControllerConnectors
 #include <aerial_autonomy/controller_connectors/basic_controller_connectors.h>
@@ -28,6 +29,7 @@
 // shared ptr
 #include <memory>
 
+#include <atomic>
 #include <iomanip>
 #include <sstream>
 
@@ -57,7 +59,7 @@ protected:
   /**
   * @brief Thrust gain estimator
   */
-  ThrustGainEstimator thrust_gain_estimator_;
+  std::unique_ptr<ThrustGainEstimator> thrust_gain_estimator_;
 
 private:
   // Controllers
@@ -116,6 +118,18 @@ private:
   * @brief Flag to specify if home location is specified or not
   */
   bool home_location_specified_;
+  /**
+  * @brief UAV data returned by getUAVData while a snapshot is taken
+  */
+  parsernode::common::quaddata sensor_snapshot_;
+  /**
+  * @brief True while getUAVData returns the snapshot
+  */
+  std::atomic<bool> sensor_snapshot_taken_;
+  /**
+  * @brief Protects the snapshot
+  */
+  mutable boost::mutex sensor_snapshot_mutex_;
   /**
    * @brief helper function to choose between the argument parser
    * and the one provided in config. If user provided a parser,
@@ -167,6 +181,28 @@ private:
 
     return velocity_sensor;
   }
+  /**
+   * @brief function to choose the thrust gain estimator from config.
+   * If a system identification estimator config is provided, the recursive
+   * least squares estimator is used. Otherwise the basic thrust gain
+   * estimator is used.
+   *
+   * @param config UAV config containing estimator configs
+   *
+   * @return the chosen estimator
+   */
+  static std::unique_ptr<ThrustGainEstimator>
+  chooseThrustGainEstimator(UAVSystemConfig &config) {
+    std::unique_ptr<ThrustGainEstimator> thrust_gain_estimator;
+    if (config.has_system_identification_estimator_config()) {
+      thrust_gain_estimator.reset(new SystemIdentificationEstimator(
+          config.system_identification_estimator_config()));
+    } else {
+      thrust_gain_estimator.reset(
+          new ThrustGainEstimator(config.thrust_gain_estimator_config()));
+    }
+    return thrust_gain_estimator;
+  }
 
 public:
   /**
@@ -200,7 +236,7 @@ public:
         rpyt_based_position_controller_(
             config.rpyt_based_position_controller_config(),
             std::chrono::milliseconds(config.uav_controller_timer_duration())),
-        thrust_gain_estimator_(config.thrust_gain_estimator_config()),
+        thrust_gain_estimator_(UAVSystem::chooseThrustGainEstimator(config)),
         builtin_position_controller_(config.position_controller_config()),
         builtin_velocity_controller_(config.velocity_controller_config()),
         joystick_velocity_controller_(
@@ -212,15 +248,15 @@ public:
                                              builtin_position_controller_),
         rpyt_based_position_controller_drone_connector_(
             *drone_hardware_, rpyt_based_position_controller_,
-            thrust_gain_estimator_),
+            *thrust_gain_estimator_),
         velocity_controller_drone_connector_(*drone_hardware_,
                                              builtin_velocity_controller_),
         rpyt_controller_drone_connector_(*drone_hardware_,
                                          manual_rpyt_controller_),
         joystick_velocity_controller_drone_connector_(
             *drone_hardware_, joystick_velocity_controller_,
-            thrust_gain_estimator_),
-        home_location_specified_(false) {
+            *thrust_gain_estimator_),
+        home_location_specified_(false), sensor_snapshot_taken_(false) {
     drone_hardware_->initialize();
     // Add control hardware connector containers
     controller_connector_container_.setObject(
@@ -236,14 +272,37 @@ public:
   /**
   * @brief Get sensor data from UAV
   *
-  * @return Accumulated sensor data from UAV
+  * @return Accumulated sensor data from UAV, or the snapshot if one is taken
   */
   parsernode::common::quaddata getUAVData() const {
     parsernode::common::quaddata data;
-    drone_hardware_->getquaddata(data);
+    if (sensor_snapshot_taken_) {
+      boost::mutex::scoped_lock lock(sensor_snapshot_mutex_);
+      data = sensor_snapshot_;
+    } else {
+      drone_hardware_->getquaddata(data);
+    }
     return data;
   }
 
+  /**
+  * @brief Read the sensor data from the UAV once. Until the snapshot is
+  * released, getUAVData returns this data so that the state machine and the
+  * status update of a tick act on the same data
+  */
+  void takeSensorSnapshot() {
+    parsernode::common::quaddata data;
+    drone_hardware_->getquaddata(data);
+    boost::mutex::scoped_lock lock(sensor_snapshot_mutex_);
+    sensor_snapshot_ = data;
+    sensor_snapshot_taken_ = true;
+  }
+
+  /**
+  * @brief Return the latest data from the UAV in getUAVData again
+  */
+  void releaseSensorSnapshot() { sensor_snapshot_taken_ = false; }
+
   /**
   * @brief Public API call to takeoff
   */
@@ -8,7 +8,9 @@
 #include "aerial_autonomy/estimators/tracking_vector_estimator.h"
 #include "aerial_autonomy/robot_systems/uav_system.h"
 #include "aerial_autonomy/trackers/alvar_tracker.h"
+#include "aerial_autonomy/trackers/color_blob_roi_detector.h"
 #include "aerial_autonomy/trackers/roi_to_position_converter.h"
+#include "aerial_autonomy/trackers/template_roi_detector.h"
 #include "uav_system_config.pb.h"
 
 #include <tf/tf.h>
@@ -51,7 +53,7 @@ public:
                                          camera_transform_),
         relative_pose_visual_servoing_drone_connector_(
             *tracker_, *drone_hardware_, rpyt_based_relative_pose_controller_,
-            thrust_gain_estimator_, camera_transform_,
+            *thrust_gain_estimator_, camera_transform_,
             conversions::protoTransformToTf(config_.uav_vision_system_config()
                                                 .tracking_offset_transform())) {
     controller_connector_container_.setObject(visual_servoing_drone_connector_);
@@ -117,7 +119,7 @@ public:
     table_writer.addCell("Tracking Vectors: ");
     std::unordered_map<uint32_t, tf::Transform> tracking_vectors;
     if (tracker_->getTrackingVectors(tracking_vectors)) {
-      for (auto tv : tracking_vectors) {
+      for (const auto &tv : tracking_vectors) {
         tf::Transform tv_body_frame = camera_transform_ * tv.second;
         table_writer.beginRow();
         table_writer.addCell(tv.first);
@@ -168,7 +170,10 @@ protected:
       std::string tracker_type =
           config.uav_vision_system_config().tracker_type();
       if (tracker_type == "ROI") {
-        tracker_pointer = BaseTrackerPtr(new RoiToPositionConverter());
+        RoiDetectorPtr detector = chooseRoiDetector(
+            config.uav_vision_system_config().roi_detector_config());
+        tracker_pointer = BaseTrackerPtr(
+            new RoiToPositionConverter("~tracker", std::move(detector)));
       } else if (tracker_type == "Alvar") {
         tracker_pointer = BaseTrackerPtr(new AlvarTracker());
       } else {
@@ -179,6 +184,28 @@ protected:
     return tracker_pointer;
   }
 
+  /**
+   * @brief Choose the detector run by the ROI tracker
+   *
+   * @param config Configuration containing a detector type
+   *
+   * @return Chosen detector, or null to receive ROIs from the roi topic
+   */
+  static RoiDetectorPtr chooseRoiDetector(const RoiDetectorConfig &config) {
+    std::string detector_type = config.detector_type();
+    if (detector_type.empty()) {
+      return nullptr;
+    } else if (detector_type == "ColorBlob") {
+      return RoiDetectorPtr(
+          new ColorBlobRoiDetector(config.color_blob_detector_config()));
+    } else if (detector_type == "Template") {
+      return RoiDetectorPtr(
+          new TemplateRoiDetector(config.template_detector_config()));
+    }
+    throw std::runtime_error("Unknown ROI detector type provided: " +
+                             detector_type);
+  }
+
 private:
   /**
   * @brief Track the target position given by the tracker
@@ -1,5 +1,6 @@
 #pragma once
 #include <aerial_autonomy/common/atomic.h>
+#include <aerial_autonomy/common/timebase.h>
 
 /**
 * @brief enum for sensor status
@@ -14,7 +15,7 @@ enum class SensorStatus { INVALID, VALID };
 /**
 * @brief convert sensor status to bool
 */
-bool sensor_status_to_bool(SensorStatus status) {
+inline bool sensor_status_to_bool(SensorStatus status) {
   if (status == SensorStatus::INVALID)
     return false;
   else
@@ -37,7 +38,28 @@ public:
   */
   virtual SensorDataT getSensorData() = 0;
   /**
+  * @brief gets the sensor data at a given time, e.g. the time of a delayed
+  * measurement that should be combined with the sensor data
+  *
+  * Sensors without a history return the latest data
+  *
+  * @param time Time of the sensor data
+  * @param data Returns the sensor data
+  *
+  * @return false if no sensor data is available at the time
+  */
+  virtual bool getSensorData(timebase::TimePoint time, SensorDataT &data) {
+    data = getSensorData();
+    return true;
+  }
+  /**
   * @brief gets the current status of the sensor
   */
   virtual SensorStatus getSensorStatus() = 0;
+  /**
+  * @brief gets the time at which the latest sensor data was measured
+  *
+  * Sensors without measurement time stamps return the current time
+  */
+  virtual timebase::TimePoint getSensorTime() { return timebase::Clock::now(); }
 };
@@ -1,10 +1,17 @@
 #pragma once
 #include "aerial_autonomy/sensors/base_sensor.h"
+#include "aerial_autonomy/sensors/sensor_history.h"
+#include "aerial_autonomy/types/velocity.h"
 #include "parsernode/parser.h"
 
+#include <mutex>
+
 /**
 * @brief sensor object which treats drone velocity
 * data as external sensor data
+*
+* Every poll of the drone velocity is added to a history so that the velocity
+* can be queried at the time of delayed measurements
 */
 class Guidance : public Sensor<Velocity> {
 public:
@@ -23,9 +30,23 @@ public:
     drone_hardware_.getquaddata(data);
 
     Velocity vel_data(data.linvel.x, data.linvel.y, data.linvel.z);
+    {
+      // Polls from several threads take turns writing to the history
+      std::lock_guard<std::mutex> lock(history_mutex_);
+      history_.push(timebase::Clock::now(), vel_data);
+    }
     return vel_data;
   }
 
+  /**
+  * @brief Polls the drone velocity and gives the velocity at a time,
+  * interpolated between the polls around it
+  */
+  bool getSensorData(timebase::TimePoint time, Velocity &vel_data) {
+    getSensorData();
+    return history_.getSensorData(time, vel_data);
+  }
+
   SensorStatus getSensorStatus() { return SensorStatus::VALID; }
 
 private:
@@ -33,4 +54,12 @@ private:
   * @brief UAV hardware to get data from
   */
   parsernode::Parser &drone_hardware_;
+  /**
+  * @brief Polled velocities
+  */
+  SensorHistory<Velocity, 128> history_;
+  /**
+  * @brief Serializes writes to the history
+  */
+  std::mutex history_mutex_;
 };
@@ -0,0 +1,112 @@
+#pragma once
+#include "aerial_autonomy/common/async_timer.h"
+#include "aerial_autonomy/common/atomic.h"
+#include "aerial_autonomy/common/spsc_ring_buffer.h"
+#include "aerial_autonomy/common/timebase.h"
+#include "aerial_autonomy/common/timer_executor.h"
+#include "aerial_autonomy/sensors/base_sensor.h"
+#include "aerial_autonomy/types/position_yaw.h"
+#include "mocap_capture_config.pb.h"
+
+#include <atomic>
+#include <cstdint>
+
+class Log;
+
+/**
+* @brief Pose measured by the motion capture system
+*/
+struct MocapSample {
+  timebase::TimePoint source_time;  ///< Stamp of the pose message
+  timebase::TimePoint receive_time; ///< Time the pose was received
+  uint32_t sequence;                ///< Sequence number of the pose message
+  double x;                         ///< Position x component (m)
+  double y;                         ///< Position y component (m)
+  double z;                         ///< Position z component (m)
+  double qx;                        ///< Orientation quaternion x component
+  double qy;                        ///< Orientation quaternion y component
+  double qz;                        ///< Orientation quaternion z component
+  double qw;                        ///< Orientation quaternion w component
+};
+
+/**
+* @brief Counters of the poses handled by a MocapCapture
+*/
+struct MocapCaptureStatistics {
+  uint64_t received; ///< Poses received
+  uint64_t dropped;  ///< Poses dropped because the buffer was full
+  uint64_t missed;   ///< Gaps in the sequence numbers, e.g. poses dropped by
+                     /// the subscription queue
+  uint64_t written;  ///< Poses written to the data stream
+};
+
+/**
+* @brief Captures every motion capture pose for logging and provides the
+* latest pose as a sensor
+*
+* Poses are added by a single producer, typically the subscriber callback,
+* to a lock-free ring buffer. A timer thread empties the buffer into the data
+* stream, time stamping each data point with the pose stamp so that neither
+* the log rate nor the write timing lose samples. Decimation only applies to
+* the data stream.
+*/
+class MocapCapture : public Sensor<PositionYaw> {
+public:
+  /**
+  * @brief Constructor
+  *
+  * Adds the data stream to the current log instance if it is not configured
+  * and writes its header, then starts the write timer
+  *
+  * @param config Capture configuration
+  * @param executor Executor running the write timer instead of a timer
+  * thread
+  */
+  explicit MocapCapture(MocapCaptureConfig config,
+                        TimerExecutor *executor = nullptr);
+  /**
+  * @brief Destructor stops the timer and writes the remaining poses
+  */
+  ~MocapCapture();
+  /**
+  * @brief Add a pose. Should only be called by one thread at a time
+  * @param sample Pose to add
+  */
+  void addSample(const MocapSample &sample);
+  /**
+  * @brief Write the buffered poses to the data stream. Called by the write
+  * timer
+  */
+  void write();
+  /**
+  * @brief Get the capture counters
+  */
+  MocapCaptureStatistics statistics() const;
+  using Sensor<PositionYaw>::getSensorData;
+  /**
+  * @brief Gets the position and yaw of the latest pose
+  */
+  PositionYaw getSensorData();
+  /**
+  * @brief Valid if a pose was received within the configured timeout
+  */
+  SensorStatus getSensorStatus();
+  /**
+  * @brief Gets the stamp of the latest pose
+  */
+  timebase::TimePoint getSensorTime();
+
+private:
+  MocapCaptureConfig config_;          ///< Capture configuration
+  Log &log_;                           ///< Log receiving the poses
+  SpscRingBuffer<MocapSample> buffer_; ///< Poses waiting to be written
+  Atomic<MocapSample> latest_;         ///< Latest pose
+  std::atomic<uint64_t> received_;     ///< Poses received
+  std::atomic<uint64_t> dropped_;      ///< Poses dropped by the buffer
+  std::atomic<uint64_t> missed_;       ///< Gaps in the sequence numbers
+  std::atomic<uint64_t> written_;      ///< Poses written
+  uint32_t last_sequence_;     ///< Sequence number of the previous pose
+  uint64_t decimation_count_;  ///< Poses taken from the buffer
+  uint64_t reported_dropped_;  ///< Dropped poses already reported
+  AsyncTimer write_timer_;     ///< Timer writing the buffered poses
+};
@@ -0,0 +1,217 @@
+#pragma once
+#include "aerial_autonomy/common/timebase.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+/**
+* @brief Linear interpolation between two samples. The sample type should
+* provide addition, subtraction and multiplication by a double
+*/
+struct LinearInterpolation {
+  /**
+  * @brief Interpolate between two samples
+  * @param before Sample preceding the query time
+  * @param after Sample following the query time
+  * @param alpha Fraction of the time between the samples (0 to 1)
+  * @return Interpolated sample
+  */
+  template <class T>
+  static T interpolate(const T &before, const T &after, double alpha) {
+    return before + (after - before) * alpha;
+  }
+};
+
+/**
+* @brief Zero order hold: the sample preceding the query time. Used for sample
+* types without a meaningful interpolation
+*/
+struct HoldInterpolation {
+  /**
+  * @brief Return the sample preceding the query time
+  * @param before Sample preceding the query time
+  * @return The sample preceding the query time
+  */
+  template <class T> static T interpolate(const T &before, const T &, double) {
+    return before;
+  }
+};
+
+/**
+* @brief Fixed capacity history of time stamped sensor samples that can be
+* queried at any time covered by the samples.
+*
+* One writer thread adds samples in time order while any number of threads
+* query the history without blocking the writer. Readers copy the samples they
+* need and retry if a sample was added meanwhile, so the sample type should
+* not own heap memory. The storage is allocated along with the history, so
+* adding and querying samples never touches the heap.
+*
+* @tparam T Type of sample
+* @tparam Capacity Number of samples kept. Older samples are overwritten
+* @tparam Interpolation Interpolation between the samples around a query time
+*/
+template <class T, std::size_t Capacity,
+          class Interpolation = LinearInterpolation>
+class SensorHistory {
+  static_assert(Capacity > 0, "Sensor history capacity should be positive");
+
+public:
+  /**
+  * @brief Constructor
+  *
+  * @param max_extrapolation Time after the newest sample until which queries
+  * return the newest sample
+  */
+  explicit SensorHistory(std::chrono::duration<double> max_extrapolation =
+                             std::chrono::duration<double>(0))
+      : sequence_(0), count_(0),
+        max_extrapolation_(
+            std::chrono::duration_cast<timebase::Clock::duration>(
+                max_extrapolation)) {}
+
+  /**
+  * @brief Add a sample. Should only be called by one thread at a time
+  *
+  * @param time Time of the sample
+  * @param value Sample
+  *
+  * @return False if the sample is older than the newest sample and was not
+  * added
+  */
+  bool push(timebase::TimePoint time, const T &value) {
+    uint64_t count = count_.load(std::memory_order_relaxed);
+    if (count > 0 && time < sample(count - 1).time) {
+      return false;
+    }
+    uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    samples_[count % Capacity] = Sample{time, value};
+    count_.store(count + 1, std::memory_order_relaxed);
+    sequence_.store(sequence + 2, std::memory_order_release);
+    return true;
+  }
+
+  /**
+  * @brief Get the newest sample
+  *
+  * @param time Returns the time of the sample
+  * @param value Returns the sample
+  *
+  * @return False if the history is empty
+  */
+  bool getLatest(timebase::TimePoint &time, T &value) const {
+    return read([&](uint64_t count) {
+      if (count == 0) {
+        return false;
+      }
+      const Sample &newest = sample(count - 1);
+      time = newest.time;
+      value = newest.value;
+      return true;
+    });
+  }
+
+  /**
+  * @brief Get the sample at a time, interpolating between the samples around
+  * it
+  *
+  * @param time Query time
+  * @param value Returns the sample at the query time
+  *
+  * @return False if the time is before the oldest sample or after the newest
+  * sample by more than the maximum extrapolation
+  */
+  bool getSensorData(timebase::TimePoint time, T &value) const {
+    return read([&](uint64_t count) {
+      if (count == 0) {
+        return false;
+      }
+      const Sample &newest = sample(count - 1);
+      if (time >= newest.time) {
+        if (time - newest.time > max_extrapolation_) {
+          return false;
+        }
+        value = newest.value;
+        return true;
+      }
+      uint64_t first = count > Capacity ? count - Capacity : 0;
+      if (time < sample(first).time) {
+        return false;
+      }
+      // Find the first sample after the query time
+      uint64_t low = first, high = count - 1;
+      while (high - low > 1) {
+        uint64_t middle = low + (high - low) / 2;
+        if (sample(middle).time > time) {
+          high = middle;
+        } else {
+          low = middle;
+        }
+      }
+      const Sample &before = sample(low);
+      const Sample &after = sample(high);
+      double alpha = std::chrono::duration<double>(time - before.time) /
+                     std::chrono::duration<double>(after.time - before.time);
+      value = Interpolation::interpolate(before.value, after.value, alpha);
+      return true;
+    });
+  }
+
+  /**
+  * @brief Number of samples in the history
+  */
+  std::size_t size() const {
+    uint64_t count = count_.load(std::memory_order_acquire);
+    return count > Capacity ? Capacity : count;
+  }
+
+private:
+  /**
+  * @brief Time stamped sample
+  */
+  struct Sample {
+    timebase::TimePoint time; ///< Time of the sample
+    T value;                  ///< Sample
+  };
+
+  /**
+  * @brief Get a sample by the number of samples added before it
+  */
+  const Sample &sample(uint64_t index) const {
+    return samples_[index % Capacity];
+  }
+
+  /**
+  * @brief Run a query until no sample is added while it runs
+  *
+  * @param query Query taking the number of samples added
+  *
+  * @return Result of the query
+  */
+  template <class Query> bool read(Query query) const {
+    while (true) {
+      uint64_t sequence = sequence_.load(std::memory_order_acquire);
+      if (sequence % 2 == 1) {
+        std::this_thread::yield();
+        continue;
+      }
+      bool result = query(count_.load(std::memory_order_relaxed));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sequence_.load(std::memory_order_relaxed) == sequence) {
+        return result;
+      }
+    }
+  }
+
+  std::array<Sample, Capacity> samples_; ///< Sample storage
+  std::atomic<uint64_t> sequence_; ///< Odd while a sample is being added
+  std::atomic<uint64_t> count_;    ///< Number of samples added
+  const timebase::Clock::duration max_extrapolation_; ///< Time after the
+                                                      /// newest sample covered
+};
@@ -1,5 +1,6 @@
 #pragma once
 #include "aerial_autonomy/sensors/base_sensor.h"
+#include "aerial_autonomy/sensors/sensor_history.h"
 #include "aerial_autonomy/types/velocity.h"
 #include "velocity_sensor_config.pb.h"
 #include <aerial_autonomy/common/conversions.h>
@@ -8,6 +9,9 @@
 #include <ros/ros.h>
 /**
 * @brief ros based velocity sensor
+*
+* Keeps a history of the odometry velocities stamped with the message stamps
+* so that the velocity can be queried at the time of delayed measurements
 */
 class VelocitySensor : public Sensor<Velocity> {
 public:
@@ -17,7 +21,9 @@ public:
   *
   * @param Config for velocity sensor
   */
-  VelocitySensor(VelocitySensorConfig config) : config_(config) {
+  VelocitySensor(VelocitySensorConfig config)
+      : config_(config),
+        history_(std::chrono::duration<double>(config.timeout())) {
     VLOG(2) << "Initialzing ROS Sensor";
     odom_sub_ =
         nh_.subscribe(config.topic(), 1, &VelocitySensor::odomCallback, this);
@@ -27,10 +33,19 @@ public:
   * @brief gives sensor data
   */
   Velocity getSensorData() {
-    Velocity sensor_data = sensor_data_;
+    timebase::TimePoint time;
+    Velocity sensor_data;
+    history_.getLatest(time, sensor_data);
     return sensor_data;
   }
   /**
+  * @brief gives the velocity at a time, interpolated between the odometry
+  * messages around it
+  */
+  bool getSensorData(timebase::TimePoint time, Velocity &sensor_data) {
+    return history_.getSensorData(time, sensor_data);
+  }
+  /**
   * @brief gives sensor status
   */
   SensorStatus getSensorStatus() {
@@ -43,6 +58,15 @@ public:
 
     return sensor_status;
   }
+  /**
+  * @brief gives the header stamp of the last odometry message in the timebase
+  */
+  timebase::TimePoint getSensorTime() {
+    timebase::TimePoint time;
+    Velocity sensor_data;
+    history_.getLatest(time, sensor_data);
+    return time;
+  }
 
 private:
   /**
@@ -54,7 +78,10 @@ private:
     Velocity vel_sensor_data(msg->twist.twist.linear.x,
                              msg->twist.twist.linear.y,
                              msg->twist.twist.linear.z);
-    sensor_data_ = vel_sensor_data;
+    if (!history_.push(timebase::fromRosTime(last_msg_time),
+                       vel_sensor_data)) {
+      LOG(WARNING) << "Dropping out of order odometry message";
+    }
   }
   /**
   * @brief sensor config
@@ -73,7 +100,7 @@ private:
   */
   Atomic<ros::Time> last_msg_time_;
   /**
-  * @brief variable to store sensor data
+  * @brief velocities of the latest odometry messages
   */
-  Atomic<Velocity> sensor_data_;
+  SensorHistory<Velocity, 128> history_;
 };
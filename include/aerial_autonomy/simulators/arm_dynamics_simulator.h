@@ -0,0 +1,234 @@
+#pragma once
+#include "aerial_autonomy/common/async_timer.h"
+#include "aerial_autonomy/common/timebase.h"
+#include "aerial_autonomy/kinematics/arm_kinematics.h"
+#include "arm_dynamics_simulator_config.pb.h"
+
+#include <Eigen/Dense>
+#include <arm_parsers/arm_parser.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+
+/**
+ * @brief Arm hardware simulating a serial chain of revolute joints and a
+ * gripper.
+ *
+ * Each joint tracks its angle target with a first or second order response
+ * limited in speed and acceleration, and stops at its angle limits. End
+ * effector poses are tracked by an onboard damped least squares controller
+ * that updates the joint targets every step. Closing the gripper grips the
+ * object with a probability that falls off with the position and orientation
+ * error between the end effector and the object, and a gripped object can
+ * slip out. The joints and gripper are integrated with a fixed step on a
+ * virtual clock that only moves when advance is called, and grips are drawn
+ * from a seeded generator, so runs are repeatable and much faster than real
+ * time. When nothing else calls advance, e.g. as the arm hardware of a robot
+ * system, startRealTime advances the virtual clock with the wall clock.
+ *
+ * Poses are expressed in the arm base frame.
+ */
+class ArmDynamicsSimulator : public ArmParser {
+public:
+  /**
+  * @brief Constructor. The arm starts powered off with all joints at zero and
+  * the gripper open
+  *
+  * @param config Simulator configuration
+  */
+  ArmDynamicsSimulator(
+      ArmDynamicsSimulatorConfig config = ArmDynamicsSimulatorConfig());
+  /**
+  * @brief Destructor. Stops advancing in real time
+  */
+  virtual ~ArmDynamicsSimulator();
+  /**
+  * @brief Track an end effector pose with the onboard controller
+  *
+  * @param pose End effector pose in arm base frame
+  * @return False if the arm is disabled or the pose is out of reach
+  */
+  virtual bool setEndEffectorPose(const Eigen::Matrix4d &pose);
+  /**
+  * @brief Move the joints to the given angles
+  *
+  * @param angles Joint angles (rad)
+  * @return False if the arm is disabled, or the angles do not match the
+  * joints or are outside the joint limits
+  */
+  virtual bool setJointAngles(const std::vector<double> &angles);
+  /**
+  * @brief End effector pose in arm base frame
+  */
+  virtual Eigen::Matrix4d getEndEffectorTransform();
+  /**
+  * @brief Joint angles (rad)
+  */
+  virtual std::vector<double> getJointAngles();
+  /**
+  * @brief Joint velocities (rad/s)
+  */
+  virtual std::vector<double> getJointVelocities();
+  /**
+  * @brief Close or open the gripper
+  *
+  * @param action True to close and false to open
+  * @return False if the arm is disabled
+  */
+  virtual bool grip(bool action);
+  /**
+  * @brief Whether the closed gripper is holding the object
+  */
+  virtual bool gripStatus();
+  /**
+  * @brief Open the gripper instantly, dropping any object
+  *
+  * @return True
+  */
+  virtual bool resetGripper();
+  /**
+  * @brief Power the arm on or off, or move to the folded or L shaped joint
+  * angles
+  *
+  * @param command Command to send
+  * @return False if a motion is commanded while the arm is disabled
+  */
+  virtual bool sendCmd(ArmParser::Command command);
+  /**
+  * @brief Whether the latest motion or gripper command is complete. False
+  * after powering on or off
+  */
+  virtual bool getCommandStatus();
+  /**
+  * @brief Enabled once powered on for the power on duration
+  */
+  virtual ArmParser::State state();
+
+  /**
+  * @brief Place the object to grip. Any gripped object is dropped
+  *
+  * @param pose Pose of the object in arm base frame at which the end
+  * effector grips it best
+  */
+  void setObjectPose(const Eigen::Matrix4d &pose);
+  /**
+  * @brief Pose of the object in arm base frame. Gripped objects move with the
+  * end effector
+  */
+  Eigen::Matrix4d getObjectPose();
+  /**
+  * @brief Probability of gripping the object from the current end effector
+  * pose. Zero if no object is placed
+  */
+  double gripSuccessProbability();
+  /**
+  * @brief Integrate the joints and gripper and move the virtual clock
+  *
+  * @param duration Time to simulate. Rounded to integration steps
+  */
+  void advance(std::chrono::duration<double> duration);
+  /**
+  * @brief Time of the virtual clock since construction
+  */
+  std::chrono::duration<double> getTime();
+  /**
+  * @brief Advance the virtual clock on a timer so that it keeps up with the
+  * steady clock. advance should not be called meanwhile
+  *
+  * @param period Period of the timer
+  */
+  void startRealTime(std::chrono::duration<double> period);
+  /**
+  * @brief Stop advancing the virtual clock in real time
+  */
+  void stopRealTime();
+  /**
+  * @brief Geometry of the simulated arm, e.g. to solve its inverse
+  * kinematics in tree
+  *
+  * @param config Simulator configuration. The default arm is used when no
+  * joints are configured
+  */
+  static ArmKinematicsConfig
+  kinematicsConfig(ArmDynamicsSimulatorConfig config);
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+private:
+  /**
+  * @brief Latest motion or gripper command
+  */
+  enum class Task {
+    None,        ///< Nothing commanded since powering on or off
+    Joints,      ///< Joint angle targets
+    EndEffector, ///< End effector pose target
+    Gripper      ///< Gripper closing or opening
+  };
+  /**
+  * @brief Gripper state
+  */
+  enum class Gripper { Open, Closing, Closed, Opening };
+  /**
+  * @brief Fill in the default arm if no joints are configured
+  */
+  static ArmDynamicsSimulatorConfig
+  withDefaultArm(ArmDynamicsSimulatorConfig config);
+  /**
+  * @brief Start moving the joints to the targets if enabled
+  */
+  bool moveJoints(const Eigen::VectorXd &targets);
+  /**
+  * @brief Grip success probability from an end effector pose
+  */
+  double gripSuccessProbability(const Eigen::Matrix4d &end_effector) const;
+  /**
+  * @brief Whether the latest command is complete
+  */
+  bool taskComplete() const;
+  /**
+  * @brief Integrate one step of the joints and gripper
+  */
+  void step();
+  /**
+  * @brief Advance the virtual clock to the time elapsed on the steady clock
+  * since starting in real time
+  */
+  void advanceToRealTime();
+
+  const ArmDynamicsSimulatorConfig config_; ///< Simulator configuration
+  const double dt_;                         ///< Integration step
+  const int n_;                             ///< Number of joints
+  const ArmKinematics kinematics_;          ///< Arm geometry
+  ArmKinematics::Jacobian jacobian_;        ///< Jacobian of the controller
+  std::mutex mutex_;               ///< Guards the simulator
+  uint64_t steps_;                 ///< Integration steps of the virtual clock
+  bool powered_;                   ///< Powered on
+  bool enabled_;                   ///< Enabled after powering on
+  uint64_t enable_steps_;          ///< Step at which the arm enables
+  Task task_;                      ///< Latest command
+  Eigen::VectorXd q_;              ///< Joint angles
+  Eigen::VectorXd q_dot_;          ///< Joint velocities
+  Eigen::VectorXd q_target_;       ///< Joint angle targets
+  Eigen::Matrix4d pose_target_;    ///< End effector pose target
+  Gripper gripper_;                ///< Gripper state
+  double gripper_remaining_;       ///< Time left to close or open (s)
+  bool has_object_;                ///< Object placed
+  bool holding_;                   ///< Object gripped
+  Eigen::Matrix4d object_pose_;    ///< Object pose
+  Eigen::Matrix4d grasp_offset_;   ///< Object pose in end effector frame
+  std::mt19937 generator_;         ///< Grip generator
+  std::uniform_real_distribution<double> uniform_; ///< Uniform in [0, 1)
+  timebase::TimePoint real_time_start_; ///< Steady time at real time start
+  /**
+  * @brief Virtual time at real time start
+  */
+  std::chrono::duration<double> virtual_time_start_;
+  /**
+  * @brief Timer advancing the virtual clock in real time. Declared last so
+  * that it stops before the simulator state is destroyed
+  */
+  std::unique_ptr<AsyncTimer> real_time_timer_;
+};
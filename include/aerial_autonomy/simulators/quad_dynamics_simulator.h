@@ -0,0 +1,303 @@
+#pragma once
+#include "aerial_autonomy/types/qrotor_backstepping_control.h"
+#include "aerial_autonomy/types/qrotor_backstepping_state.h"
+#include "quad_dynamics_simulator_config.pb.h"
+
+#include <Eigen/Dense>
+#include <parsernode/common.h>
+#include <parsernode/parser.h>
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <random>
+
+/**
+ * @brief UAV hardware simulating rigid body quadrotor dynamics.
+ *
+ * The vehicle is integrated with a fixed step RK4 integrator on a virtual
+ * clock that only moves when advance is called, so a test can run a mission
+ * much faster than real time by alternating controller runs and advance.
+ * Roll, pitch, yaw (rate) and thrust commands go through an onboard attitude
+ * controller and a first order motor model; guided velocity and position
+ * commands, takeoff and land are flown by onboard cascaded P loops on top.
+ * Backstepping controls bypass the onboard controllers. Commands are applied
+ * after the actuation delay, sensor data carries white noise, thrust drains
+ * the battery and lowers the thrust gain, and wind pushes the vehicle through
+ * linear drag.
+ *
+ * Sensor data follows the parser conventions: world frame position and
+ * velocity, ZYX Euler angles, body angular velocity and body frame
+ * acceleration without gravity.
+ */
+class QuadDynamicsSimulator : public parsernode::Parser {
+public:
+  /**
+  * @brief Constructor. The vehicle starts disarmed on the ground at the origin
+  *
+  * @param config Simulator configuration
+  */
+  QuadDynamicsSimulator(
+      QuadDynamicsSimulatorConfig config = QuadDynamicsSimulatorConfig());
+  /**
+  * @brief Arm and climb to the takeoff height above the current position
+  *
+  * @return True if taking off
+  */
+  virtual bool takeoff();
+  /**
+  * @brief Descend at the landing velocity and disarm on touchdown
+  *
+  * @return True if landing
+  */
+  virtual bool land();
+  /**
+  * @brief Turn off motors
+  *
+  * @return True
+  */
+  virtual bool disarm();
+  /**
+  * @brief Toggle software control. Commands are rejected without it
+  *
+  * @param state True to enable software control
+  * @return True
+  */
+  virtual bool flowControl(bool state);
+  /**
+  * @brief Recalibrate IMU. Does nothing
+  *
+  * @return True
+  */
+  virtual bool calibrateimubias();
+  /**
+  * @brief Command euler angles and thrust
+  *
+  * @param rpytmsg Msg format is (x,y,z,w) -> (roll, pitch, yaw, thrust)
+  * @return True if the command is accepted
+  */
+  virtual bool cmdrpythrust(geometry_msgs::Quaternion &rpytmsg);
+  /**
+  * @brief Command roll, pitch, yaw rate and thrust
+  *
+  * @param rpytmsg Msg format is (x,y,z,w) -> (roll, pitch, yaw rate, thrust)
+  * @return True if the command is accepted
+  */
+  virtual bool cmdrpyawratethrust(geometry_msgs::Quaternion &rpytmsg);
+  /**
+  * @brief Command velocity and yaw
+  *
+  * @param vel_cmd Velocity vector (m/s)
+  * @param yaw_ang Yaw angle (rad)
+  * @return True if the command is accepted
+  */
+  virtual bool cmdvel_yaw_angle_guided(geometry_msgs::Vector3 &vel_cmd,
+                                       double &yaw_ang);
+  /**
+  * @brief Command velocity and yaw rate
+  *
+  * @param vel_cmd Velocity vector (m/s)
+  * @param yaw_rate Yaw rate (rad/s)
+  * @return True if the command is accepted
+  */
+  virtual bool cmdvel_yaw_rate_guided(geometry_msgs::Vector3 &vel_cmd,
+                                      double &yaw_rate);
+  /**
+  * @brief Command position and yaw
+  *
+  * @param desired_pos Desired 3D position (m)
+  * @param desired_yaw Desired yaw angle (rad)
+  * @return True if the command is accepted
+  */
+  virtual bool cmdwaypoint(geometry_msgs::Vector3 &desired_pos,
+                           double desired_yaw = 0);
+  /**
+  * @brief Toggle gripper. Does nothing
+  *
+  * @param state 0 to close, 1 to open
+  */
+  virtual void grip(int state) {}
+  /**
+  * @brief Set the attitude of the vehicle
+  *
+  * @param roll Roll angle (rad)
+  * @param pitch Pitch angle (rad)
+  * @param yaw Yaw angle (rad)
+  */
+  virtual void reset_attitude(double roll, double pitch, double yaw);
+  /**
+  * @brief Initialize with a ros node handle. Does nothing
+  *
+  * @param nh_ Nodehandle
+  */
+  virtual void initialize(ros::NodeHandle &nh_) {}
+  /**
+  * @brief Get the noisy sensor data and UAV state
+  *
+  * @param d1 Data struct in which data is filled
+  */
+  virtual void getquaddata(parsernode::common::quaddata &d1);
+  /**
+  * @brief Set the height of the vehicle
+  *
+  * @param altitude_ Height (m)
+  */
+  virtual void setaltitude(double altitude_);
+  /**
+  * @brief Set the log directory. Does nothing
+  *
+  * @param logdir Log directory
+  */
+  virtual void setlogdir(string logdir) {}
+  /**
+  * @brief Toggle logging. Does nothing
+  *
+  * @param logswitch True to start logging
+  */
+  virtual void controllog(bool logswitch) {}
+
+  /**
+  * @brief Command second derivative of thrust and body torques, as given by
+  * the backstepping controller
+  *
+  * @param control Thrust second derivative and body torques
+  * @return True if the command is accepted
+  */
+  bool commandThrustTorque(const QrotorBacksteppingControl &control);
+  /**
+  * @brief Set the rc channels read by the joystick controllers
+  *
+  * @param channels rc channel values (-10000, 10000)
+  */
+  void setRC(int16_t channels[4]);
+  /**
+  * @brief Integrate the dynamics and move the virtual clock
+  *
+  * @param duration Time to simulate. Rounded to integration steps
+  */
+  void advance(std::chrono::duration<double> duration);
+  /**
+  * @brief Time of the virtual clock since construction
+  */
+  std::chrono::duration<double> getTime();
+  /**
+  * @brief Noise free state of the vehicle
+  */
+  QrotorBacksteppingState getState();
+  /**
+  * @brief Overwrite the state of the vehicle, e.g. to start a test in the
+  * air
+  *
+  * @param state New state
+  * @param armed True to arm the vehicle
+  */
+  void setState(const QrotorBacksteppingState &state, bool armed = true);
+  /**
+  * @brief Current thrust gain after battery drain
+  */
+  double getThrustGain();
+
+private:
+  /**
+  * @brief Source of the vehicle inputs
+  */
+  enum class Mode {
+    RollPitchYawThrust,     ///< Attitude and thrust
+    RollPitchYawRateThrust, ///< Roll, pitch, yaw rate and thrust
+    VelocityYaw,            ///< Guided velocity and yaw
+    VelocityYawRate,        ///< Guided velocity and yaw rate
+    PositionYaw,            ///< Guided position and yaw
+    ThrustTorque,           ///< Backstepping controls
+    Land                    ///< Guided descent until touchdown
+  };
+  /**
+  * @brief Command waiting for the actuation delay
+  */
+  struct Command {
+    double time;                ///< Time to apply the command (s)
+    Mode mode;                  ///< Mode commanded
+    Eigen::Vector3d setpoint;   ///< Attitude, velocity or position setpoint
+    double value;               ///< Thrust, yaw or yaw rate setpoint
+    QrotorBacksteppingControl thrust_torque; ///< Backstepping controls
+  };
+  /**
+  * @brief Integrated state: position, velocity, orientation quaternion
+  * (w, x, y, z), body angular velocity, thrust and thrust derivative
+  */
+  using StateVector = Eigen::Matrix<double, 15, 1>;
+  /**
+  * @brief Queue a command if software control is enabled
+  */
+  bool queueCommand(Mode mode, const Eigen::Vector3d &setpoint, double value,
+                    const QrotorBacksteppingControl &thrust_torque =
+                        QrotorBacksteppingControl());
+  /**
+  * @brief Apply commands whose delay has elapsed
+  */
+  void applyCommands();
+  /**
+  * @brief Run the onboard controllers and battery for one step
+  */
+  void updateInputs();
+  /**
+  * @brief Onboard attitude controller torque
+  *
+  * @param R_d Desired orientation
+  * @param w_d Desired body angular velocity
+  */
+  Eigen::Vector3d attitudeTorque(const Eigen::Matrix3d &R_d,
+                                 const Eigen::Vector3d &w_d) const;
+  /**
+  * @brief Guided mode acceleration to desired orientation and thrust
+  *
+  * @param acceleration Desired world acceleration without gravity
+  * @param yaw Desired yaw
+  * @param R_d Returns desired orientation
+  * @return Thrust force
+  */
+  double accelerationToAttitude(Eigen::Vector3d acceleration, double yaw,
+                                Eigen::Matrix3d &R_d) const;
+  /**
+  * @brief Time derivative of the state with the current inputs
+  */
+  StateVector derivative(const StateVector &x) const;
+  /**
+  * @brief Integrate one RK4 step and handle ground contact
+  */
+  void integrate();
+  /**
+  * @brief Current orientation
+  */
+  Eigen::Matrix3d rotation() const;
+  /**
+  * @brief Current yaw
+  */
+  double yaw() const;
+  /**
+  * @brief Thrust gain after battery drain
+  */
+  double thrustGain() const;
+
+  const QuadDynamicsSimulatorConfig config_; ///< Simulator configuration
+  const double dt_;                          ///< Integration step
+  const Eigen::Matrix3d J_;                  ///< Inertia
+  const Eigen::Matrix3d J_inverse_;          ///< Inverse of inertia
+  std::mutex mutex_;                         ///< Guards the simulator
+  StateVector x_;                            ///< Integrated state
+  Eigen::Vector3d acceleration_; ///< World acceleration of latest step
+  uint64_t steps_;               ///< Integration steps of the virtual clock
+  bool armed_;                   ///< Motors running
+  bool sdk_control_;             ///< Software control enabled
+  int16_t rc_[4];                ///< Rc channels
+  double battery_percent_;       ///< Battery percentage
+  Mode mode_;                    ///< Mode of the applied command
+  Command command_;              ///< Applied command
+  double yaw_setpoint_;          ///< Onboard yaw setpoint
+  std::deque<Command> commands_; ///< Commands waiting for the delay
+  Eigen::Vector3d torque_;       ///< Body torque of the step
+  double thrust_input_; ///< Thrust force target, or thrust second
+                        ///< derivative with backstepping controls
+  Eigen::Vector3d gust_;         ///< Wind gust velocity
+  std::mt19937 generator_;       ///< Noise generator
+  std::normal_distribution<double> noise_; ///< Unit normal distribution
+};
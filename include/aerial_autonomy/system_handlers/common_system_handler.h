@@ -7,7 +7,13 @@
 #include <aerial_autonomy/actions_guards/base_functors.h>
 #include <aerial_autonomy/common/async_timer.h>
 #include <aerial_autonomy/common/system_status_publisher.h>
+#include <aerial_autonomy/common/tick_pipeline.h>
+#include <aerial_autonomy/log/log.h>
 #include <aerial_autonomy/state_machines/state_machine_gui_connector.h>
+#include <aerial_autonomy/system_handlers/system_handler_context.h>
+#include <aerial_autonomy/uav_basic_events.h>
+
+#include <cmath>
 
 /**
  * @brief Provides logic common to different system handlers to
@@ -29,28 +35,48 @@ public:
    * associated with state machine event processing are connected or not. The
    * individual system handlers must extend this function if needed.
    *
+   * The flight recorder of the log is dumped when the state machine processes
+   * an Abort event or a reason is published on the dump_flight_recorder
+   * topic.
+   *
    * @param nh NodeHandle to use for event and command subscription
    * @param config Proto configuration parameters
    * @param robot_system robot system used to create logic state machine
+   * @param context Namespace, callback queue and timer executor of the
+   * handler
    */
-  CommonSystemHandler(const CommonSystemHandlerConfig &config,
-                      RobotSystemT &robot_system,
-                      const BaseStateMachineConfig &state_machine_config)
-      : nh_("~common"), logic_state_machine_(std::ref(robot_system),
-                                             std::cref(state_machine_config)),
+  CommonSystemHandler(
+      const CommonSystemHandlerConfig &config, RobotSystemT &robot_system,
+      const BaseStateMachineConfig &state_machine_config,
+      const SystemHandlerContext &context = SystemHandlerContext())
+      : nh_(context.nodeHandle("~common")),
+        logic_state_machine_(std::ref(robot_system),
+                             std::cref(state_machine_config)),
         state_machine_gui_connector_(nh_, event_manager_, logic_state_machine_),
         system_status_pub_(nh_, robot_system, logic_state_machine_),
         status_timer_(
             std::bind(
                 &SystemStatusPublisher<LogicStateMachineT>::publishSystemStatus,
                 std::ref(system_status_pub_)),
-            std::chrono::milliseconds(config.status_timer_duration())),
+            std::chrono::milliseconds(config.status_timer_duration()),
+            context.executor),
         logic_state_machine_timer_(
             std::bind(&LogicStateMachineT::template process_event<
                           InternalTransitionEvent>,
                       std::ref(logic_state_machine_),
                       InternalTransitionEvent()),
-            std::chrono::milliseconds(config.state_machine_timer_duration())) {}
+            std::chrono::milliseconds(config.state_machine_timer_duration()),
+            context.executor),
+        config_(config), pipelined_(false),
+        flight_recorder_sub_(nh_.subscribe(
+            "dump_flight_recorder", 1,
+            &CommonSystemHandler::dumpFlightRecorderCallback, this)) {
+    logic_state_machine_.setEventObserver([](std::type_index event) {
+      if (event == typeid(uav_basic_events::Abort)) {
+        Log::instance().dumpFlightRecorder("Abort event");
+      }
+    });
+  }
 
   /**
   * @brief Delete copy constructor
@@ -67,15 +93,58 @@ public:
   }
 
   /**
-  * @brief Start state machine internal event processing and status timer
+  * @brief Start state machine internal event processing and status timer.
+  * The timers are not started if a tick pipeline runs them
   */
   void startTimers() {
     logic_state_machine_.start();
-    logic_state_machine_timer_.start();
-    status_timer_.start();
+    if (!pipelined_) {
+      logic_state_machine_timer_.start();
+      status_timer_.start();
+    }
+  }
+
+  /**
+  * @brief Add the state machine internal transition and the status update to
+  * a tick pipeline instead of running them on their own timers. The status is
+  * updated on the tick closest to every status_timer_duration. Should be
+  * called before startTimers
+  *
+  * @param pipeline Pipeline run by the system handler
+  * @param tick_duration Time in between ticks of the pipeline
+  */
+  void addTickStages(TickPipeline &pipeline,
+                     std::chrono::duration<double> tick_duration) {
+    pipeline.addStage("state_machine",
+                      std::bind(&LogicStateMachineT::template process_event<
+                                    InternalTransitionEvent>,
+                                std::ref(logic_state_machine_),
+                                InternalTransitionEvent()));
+    double status_ticks =
+        std::chrono::duration<double>(
+            std::chrono::milliseconds(config_.status_timer_duration())) /
+        tick_duration;
+    unsigned int status_decimation =
+        status_ticks < 1.5 ? 1 : std::lround(status_ticks);
+    pipeline.addStage(
+        "status",
+        std::bind(
+            &SystemStatusPublisher<LogicStateMachineT>::publishSystemStatus,
+            std::ref(system_status_pub_)),
+        status_decimation);
+    system_status_pub_.setTickPipeline(&pipeline);
+    pipelined_ = true;
   }
 
 protected:
+  /**
+   * @brief Request a flight recorder dump
+   * @param reason Reason recorded with the dump
+   */
+  void dumpFlightRecorderCallback(const std_msgs::String &reason) {
+    Log::instance().dumpFlightRecorder(reason.data);
+  }
+
   /**
    * @brief Internal nodehandle to ensure the ros topics are namespaced under
    * common
@@ -91,4 +160,8 @@ protected:
       system_status_pub_;   ///< publishes status messages
   AsyncTimer status_timer_; ///< Update uav status and state machine status
   AsyncTimer logic_state_machine_timer_; ///< Timer for running state machine
+  CommonSystemHandlerConfig config_;     ///< Handler configuration
+  bool pipelined_; ///< True if a tick pipeline runs the state machine
+  ros::Subscriber flight_recorder_sub_; ///< Receives flight recorder dump
+                                        /// requests
 };
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <aerial_autonomy/common/worker_pool.h>
+#include <aerial_autonomy/log/log.h>
+#include <aerial_autonomy/log/log_scoped_executor.h>
+#include <aerial_autonomy/system_handlers/system_handler_context.h>
+
+#include "log_config.pb.h"
+#include "multi_vehicle_runtime_config.pb.h"
+
+#include <ros/callback_queue.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Hosts several vehicles in one process on a fixed number of threads.
+ *
+ * Each vehicle is a system handler with its own ROS namespace, callback queue
+ * and Log. The timers of all the vehicles, the writes of their logs and the
+ * polls of their callback queues run on one worker pool, so the number of
+ * threads does not grow with the number of vehicles. The vehicle Log is the
+ * Log instance of every task run for the vehicle.
+ */
+class MultiVehicleRuntime {
+public:
+  /**
+   * @brief Constructor starts the worker pool
+   *
+   * @param config Runtime configuration. The vehicles are added separately
+   * @param log_config Log configuration of the vehicles. Each vehicle logs to
+   * a directory prefixed with the configured directory and the vehicle name
+   */
+  MultiVehicleRuntime(MultiVehicleRuntimeConfig config, LogConfig log_config);
+
+  /**
+   * @brief Destructor removes the vehicles in the reverse order of addition
+   */
+  ~MultiVehicleRuntime();
+
+  /**
+   * @brief Create a vehicle
+   *
+   * The handler is constructed with the vehicle Log in scope and the vehicle
+   * context appended to the arguments
+   *
+   * @tparam HandlerT System handler type, e.g. UAVSystemHandler
+   * @tparam Args Types of the handler constructor arguments
+   * @param name Unique name of the vehicle
+   * @param args Handler constructor arguments preceding the context
+   *
+   * @return The handler of the vehicle
+   */
+  template <class HandlerT, class... Args>
+  HandlerT &addVehicle(const std::string &name, Args &&... args) {
+    Vehicle &vehicle = createVehicle(name);
+    Log::Scope scope(*vehicle.log);
+    std::shared_ptr<HandlerT> handler = std::make_shared<HandlerT>(
+        std::forward<Args>(args)..., vehicle.context);
+    vehicle.handler = handler;
+    startCallbacks(vehicle);
+    return *handler;
+  }
+
+  /**
+   * @brief Stop and destroy a vehicle. The other vehicles keep running
+   *
+   * @param name Name of the vehicle
+   */
+  void removeVehicle(const std::string &name);
+
+  /**
+   * @brief Number of vehicles
+   */
+  std::size_t vehicleCount() const;
+
+  /**
+   * @brief Get the Log of a vehicle
+   * @param name Name of the vehicle
+   * @return The vehicle Log
+   */
+  Log &vehicleLog(const std::string &name);
+
+  /**
+   * @brief Get the worker pool shared by the vehicles
+   */
+  WorkerPool &workerPool();
+
+  /**
+   * @brief Delete the copy constructor
+   */
+  MultiVehicleRuntime(const MultiVehicleRuntime &) = delete;
+  /**
+   * @brief Delete the assign operator
+   */
+  MultiVehicleRuntime &operator=(const MultiVehicleRuntime &) = delete;
+
+private:
+  /**
+   * @brief Components of a vehicle, stopped by stopVehicle
+   */
+  struct Vehicle {
+    std::string name;                                   ///< Vehicle name
+    std::unique_ptr<Log> log;                           ///< Vehicle log
+    std::unique_ptr<ros::CallbackQueue> callback_queue; ///< ROS callbacks
+    std::unique_ptr<LogScopedExecutor> executor; ///< Runs the vehicle tasks
+    SystemHandlerContext context;   ///< Context of the system handler
+    std::shared_ptr<void> handler;  ///< System handler
+    int callback_task;              ///< Task polling the callback queue
+  };
+
+  /**
+   * @brief Create the log, callback queue and executor of a vehicle
+   * @param name Unique name of the vehicle
+   * @return The new vehicle
+   */
+  Vehicle &createVehicle(const std::string &name);
+
+  /**
+   * @brief Start polling the callback queue of a vehicle
+   * @param vehicle Vehicle with a handler
+   */
+  void startCallbacks(Vehicle &vehicle);
+
+  /**
+   * @brief Stop the handler, callbacks and log of a vehicle in order
+   * @param vehicle Vehicle to stop
+   */
+  void stopVehicle(Vehicle &vehicle);
+
+  MultiVehicleRuntimeConfig config_; ///< Runtime configuration
+  LogConfig log_config_;             ///< Log configuration of the vehicles
+  WorkerPool worker_pool_;           ///< Threads shared by the vehicles
+  std::vector<std::unique_ptr<Vehicle>> vehicles_; ///< Vehicles by addition
+};
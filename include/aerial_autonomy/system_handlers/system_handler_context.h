@@ -0,0 +1,62 @@
+#pragma once
+
+#include <aerial_autonomy/common/timer_executor.h>
+
+#include <ros/callback_queue_interface.h>
+#include <ros/ros.h>
+
+#include <string>
+
+/**
+ * @brief Where a system handler runs: the ROS namespace of its topics, the
+ * queue of its ROS callbacks and the executor of its timers.
+ *
+ * The default context is the one of a single vehicle node, i.e. the node
+ * namespace, the global callback queue and one thread per timer. A
+ * multi-vehicle runtime gives each vehicle its own namespace and callback
+ * queue and shares the executor between vehicles.
+ */
+struct SystemHandlerContext {
+  /**
+   * @brief Constructor
+   * @param ros_namespace Namespace of the handler topics, empty for the node
+   * namespace
+   * @param callback_queue Queue of the handler subscriptions, nullptr for the
+   * global queue
+   * @param executor Executor of the handler timers, nullptr for a thread per
+   * timer
+   */
+  explicit SystemHandlerContext(
+      std::string ros_namespace = "",
+      ros::CallbackQueueInterface *callback_queue = nullptr,
+      TimerExecutor *executor = nullptr)
+      : ros_namespace(ros_namespace), callback_queue(callback_queue),
+        executor(executor) {}
+
+  /**
+   * @brief Create a node handle in the handler namespace that queues its
+   * callbacks on the handler queue
+   *
+   * @param name Name of the node handle relative to the handler namespace. A
+   * leading "~" makes it private to the node as with ros::NodeHandle
+   *
+   * @return The node handle
+   */
+  ros::NodeHandle nodeHandle(const std::string &name) const {
+    std::string resolved_name = name;
+    if (!ros_namespace.empty()) {
+      resolved_name = (!name.empty() && name[0] == '~')
+                          ? "~" + ros_namespace + "/" + name.substr(1)
+                          : ros_namespace + "/" + name;
+    }
+    ros::NodeHandle nh(resolved_name);
+    if (callback_queue) {
+      nh.setCallbackQueue(callback_queue);
+    }
+    return nh;
+  }
+
+  std::string ros_namespace; ///< Namespace of the handler topics
+  ros::CallbackQueueInterface *callback_queue; ///< Queue of the callbacks
+  TimerExecutor *executor;                     ///< Executor of the timers
+};
@@ -4,6 +4,7 @@
 
 #include <aerial_autonomy/VelocityBasedPositionControllerDynamicConfig.h>
 #include <aerial_autonomy/actions_guards/base_functors.h>
+#include <aerial_autonomy/common/controller_timer_hook.h>
 #include <aerial_autonomy/robot_systems/uav_arm_system.h>
 #include <aerial_autonomy/system_handlers/common_system_handler.h>
 #include <aerial_autonomy/trackers/alvar_tracker.h>
@@ -26,27 +27,48 @@ public:
   /**
    * @brief Constructor
    * @param config Proto configuration parameters
+   * @param state_machine_config State machine configuration
+   * @param context Namespace, callback queue and timer executor of the
+   * handler
    */
-  UAVArmSystemHandler(UAVSystemHandlerConfig &config,
-                      const BaseStateMachineConfig &state_machine_config)
+  UAVArmSystemHandler(
+      UAVSystemHandlerConfig &config,
+      const BaseStateMachineConfig &state_machine_config,
+      const SystemHandlerContext &context = SystemHandlerContext())
       : uav_system_(config.uav_system_config()),
         common_handler_(config.base_config(), uav_system_,
-                        state_machine_config),
+                        state_machine_config, context),
+        controller_timer_hook_(
+            config.base_config().record_controller_call_sites()),
         uav_controller_timer_(
-            std::bind(&UAVArmSystem::runActiveController, std::ref(uav_system_),
-                      ControllerGroup::UAV),
+            controller_timer_hook_.wrap(std::bind(
+                &UAVArmSystem::runActiveController, std::ref(uav_system_),
+                ControllerGroup::UAV)),
             std::chrono::milliseconds(
-                config.uav_system_config().uav_controller_timer_duration())),
+                config.uav_system_config().uav_controller_timer_duration()),
+            context.executor),
         arm_controller_timer_(
-            std::bind(&UAVArmSystem::runActiveController, std::ref(uav_system_),
-                      ControllerGroup::Arm),
+            controller_timer_hook_.wrap(std::bind(
+                &UAVArmSystem::runActiveController, std::ref(uav_system_),
+                ControllerGroup::Arm)),
             std::chrono::milliseconds(config.uav_arm_system_handler_config()
-                                          .arm_controller_timer_duration())) {
-
+                                          .arm_controller_timer_duration()),
+            context.executor),
+        pipelined_(config.base_config().pipelined_tick()),
+        tick_timer_(controller_timer_hook_.wrap(std::bind(
+                        &TickPipeline::tick, std::ref(tick_pipeline_))),
+            std::chrono::milliseconds(
+                config.uav_system_config().uav_controller_timer_duration()),
+            context.executor) {
+    configureTick(config);
     // Get the party started
     common_handler_.startTimers();
-    uav_controller_timer_.start();
-    arm_controller_timer_.start();
+    if (pipelined_) {
+      tick_timer_.start();
+    } else {
+      uav_controller_timer_.start();
+      arm_controller_timer_.start();
+    }
   }
 
   /**
@@ -68,11 +90,64 @@ public:
   */
   bool isConnected() { return common_handler_.isConnected(); }
 
+  /**
+  * @brief Get the stage timings of the pipelined tick
+  *
+  * @return Timing of each stage, empty if the tick is not pipelined
+  */
+  std::vector<TickStageTiming> getTickTimings() {
+    return pipelined_ ? tick_pipeline_.timings()
+                      : std::vector<TickStageTiming>();
+  }
+
 private:
+  /**
+  * @brief Add the sensor snapshot, controller, state machine, status and
+  * snapshot release stages to the tick pipeline if the configuration asks for
+  * a pipelined tick
+  *
+  * @param config Handler configuration
+  */
+  void configureTick(const UAVSystemHandlerConfig &config) {
+    if (!pipelined_) {
+      return;
+    }
+    tick_pipeline_.addStage(
+        "sensor_snapshot",
+        std::bind(&UAVArmSystem::takeSensorSnapshot, std::ref(uav_system_)));
+    tick_pipeline_.addStage("uav_controller",
+                            std::bind(&UAVArmSystem::runActiveController,
+                                      std::ref(uav_system_),
+                                      ControllerGroup::UAV));
+    // The arm controller runs on the tick closest to its timer duration
+    long arm_decimation = std::lround(
+        double(config.uav_arm_system_handler_config()
+                   .arm_controller_timer_duration()) /
+        config.uav_system_config().uav_controller_timer_duration());
+    tick_pipeline_.addStage("arm_controller",
+                            std::bind(&UAVArmSystem::runActiveController,
+                                      std::ref(uav_system_),
+                                      ControllerGroup::Arm),
+                            arm_decimation > 1 ? arm_decimation : 1);
+    common_handler_.addTickStages(
+        tick_pipeline_,
+        std::chrono::milliseconds(
+            config.uav_system_config().uav_controller_timer_duration()));
+    // Callers outside the tick get the latest sensor data
+    tick_pipeline_.addStage("sensor_release",
+                            std::bind(&UAVArmSystem::releaseSensorSnapshot,
+                                      std::ref(uav_system_)));
+  }
+
   UAVArmSystem uav_system_; ///< Contains controllers
   CommonSystemHandler<LogicStateMachineT, EventManagerT, UAVArmSystem>
       common_handler_;              ///< Common logic to create state machine
                                     ///< and associated connections.
+  ControllerTimerHook controller_timer_hook_; ///< Wraps controller timers
   AsyncTimer uav_controller_timer_; ///< Timer for running uav controller
   AsyncTimer arm_controller_timer_; ///< Timer for running arm controller
+  bool pipelined_;                  ///< True if the tick is pipelined
+  TickPipeline tick_pipeline_;      ///< Controller, state machine and status
+                                    /// stages of a pipelined tick
+  AsyncTimer tick_timer_;           ///< Timer running the pipelined tick
 };
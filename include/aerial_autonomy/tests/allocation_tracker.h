@@ -0,0 +1,160 @@
+#pragma once
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Namespace for tracking heap allocations performed by a thread.
+ *
+ * Linking the allocation tracker library replaces the global operator new and
+ * (on glibc) malloc with versions that count allocations per thread. The
+ * counters are used to assert that control ticks do not allocate after warm
+ * up and to report the call sites that allocate on a thread. Linking the
+ * library also installs recordingCallSites as the ControllerTimerHook of the
+ * system handlers.
+ */
+namespace allocation_tracker {
+
+/**
+ * @brief Heap allocations performed by a thread
+ */
+struct AllocationCounts {
+  uint64_t allocations;   ///< Number of allocations
+  uint64_t deallocations; ///< Number of deallocations
+  uint64_t bytes;         ///< Number of bytes requested by allocations
+};
+
+/**
+ * @brief Allocations performed by the calling thread since it started
+ */
+AllocationCounts threadCounts();
+
+/**
+ * @brief Count the allocations performed by the calling thread while the
+ * counter is in scope
+ */
+class ScopedAllocationCounter {
+public:
+  /**
+   * @brief Constructor records the current allocation counts of the thread
+   */
+  ScopedAllocationCounter();
+  /**
+   * @brief Allocations performed by the thread since construction
+   */
+  AllocationCounts counts() const;
+
+private:
+  AllocationCounts start_; ///< Thread allocation counts at construction
+};
+
+/**
+ * @brief Allocating call site recorded while call site recording is enabled
+ */
+struct CallSite {
+  std::vector<std::string> frames; ///< Demangled frames, innermost first
+  uint64_t allocations;            ///< Number of allocations from the site
+  uint64_t bytes;                  ///< Number of bytes allocated from the site
+};
+
+/**
+ * @brief Record the stack of every allocation made by the calling thread
+ * while in scope. Records from all threads are accumulated until
+ * clearCallSites is called.
+ */
+class ScopedCallSiteRecorder {
+public:
+  /**
+   * @brief Constructor enables recording on the calling thread
+   */
+  ScopedCallSiteRecorder();
+  /**
+   * @brief Destructor restores the previous recording state of the thread
+   */
+  ~ScopedCallSiteRecorder();
+
+private:
+  bool previously_recording_; ///< Recording state before construction
+};
+
+/**
+ * @brief Recorded call sites sorted by number of allocations
+ */
+std::vector<CallSite> callSites();
+
+/**
+ * @brief Clear the recorded call sites
+ */
+void clearCallSites();
+
+/**
+ * @brief Human readable report of the recorded call sites
+ *
+ * @param max_sites Maximum number of call sites in the report
+ * @param max_frames Maximum number of stack frames printed per call site
+ *
+ * @return Report string with one block per call site
+ */
+std::string callSiteReport(size_t max_sites = 10, size_t max_frames = 16);
+
+/**
+ * @brief Wrap a function so that call sites are recorded on whichever thread
+ * runs it, e.g. the function run by the controller timer of a simulated
+ * mission
+ *
+ * @param function Function to wrap
+ *
+ * @return Function that records call sites while running the given function
+ */
+std::function<void()> recordingCallSites(std::function<void()> function);
+
+/**
+ * @brief Check that a function does not allocate after warm up
+ *
+ * The function is called warmup_calls times to let caches, buffers and
+ * lazily created streams allocate, then called again while counting
+ * allocations. On failure the message lists the allocating call sites.
+ *
+ * @param function Function to check, e.g. a connector run
+ * @param warmup_calls Number of calls before allocations are counted
+ *
+ * @return Success if the function did not allocate after warm up
+ */
+template <class Function>
+::testing::AssertionResult allocationFree(Function function,
+                                          int warmup_calls = 1) {
+  for (int i = 0; i < warmup_calls; ++i) {
+    function();
+  }
+  clearCallSites();
+  AllocationCounts counts;
+  {
+    ScopedCallSiteRecorder recorder;
+    ScopedAllocationCounter counter;
+    function();
+    counts = counter.counts();
+  }
+  if (counts.allocations == 0) {
+    return ::testing::AssertionSuccess();
+  }
+  return ::testing::AssertionFailure()
+         << counts.allocations << " allocations (" << counts.bytes
+         << " bytes) after warm up\n"
+         << callSiteReport();
+}
+}
+
+/**
+ * @brief Expect that a function performs no allocations after one warm up call
+ */
+#define EXPECT_NO_ALLOCATIONS(function)                                        \
+  EXPECT_TRUE(allocation_tracker::allocationFree(function))
+
+/**
+ * @brief Assert that a function performs no allocations after one warm up call
+ */
+#define ASSERT_NO_ALLOCATIONS(function)                                        \
+  ASSERT_TRUE(allocation_tracker::allocationFree(function))
@@ -0,0 +1,100 @@
+#pragma once
+#include "aerial_autonomy/common/math.h"
+#include "aerial_autonomy/types/particle_state.h"
+#include "aerial_autonomy/types/qrotor_backstepping_control.h"
+#include "aerial_autonomy/types/qrotor_backstepping_state.h"
+#include "aerial_autonomy/types/snap.h"
+#include "qrotor_backstepping_controller_config.pb.h"
+
+#include <Eigen/Dense>
+
+/**
+ * @brief Dense implementation of the backstepping control law used as
+ * reference for the specialized kernel
+ */
+class ReferenceBacksteppingLaw {
+public:
+  using Vector6d = Eigen::Matrix<double, 6, 1>;
+  using Matrix6d = Eigen::Matrix<double, 6, 6>;
+
+  ReferenceBacksteppingLaw(QrotorBacksteppingControllerConfig config,
+                           const Matrix6d &P)
+      : config_(config), m_(config.mass()), e_(0, 0, 1),
+        ag_(0, 0, -config.acc_gravity()), P_(P) {
+    K_.leftCols<3>() =
+        Eigen::Vector3d(config_.kp_xy(), config_.kp_xy(), config_.kp_z())
+            .asDiagonal();
+    K_.rightCols<3>() =
+        Eigen::Vector3d(config_.kd_xy(), config_.kd_xy(), config_.kd_z())
+            .asDiagonal();
+    A_.setZero();
+    A_.topRightCorner<3, 3>() = Eigen::Matrix3d::Identity();
+    B_.setZero();
+    B_.bottomLeftCorner<3, 3>() = (1. / m_) * Eigen::Matrix3d::Identity();
+    J_ << config_.jxx(), config_.jxy(), config_.jxz(), config_.jyx(),
+        config_.jyy(), config_.jyz(), config_.jzx(), config_.jzy(),
+        config_.jzz();
+  }
+
+  void run(const QrotorBacksteppingState &state, const ParticleState &desired,
+           const Snap &snap, QrotorBacksteppingControl &control) {
+    const Eigen::Matrix3d &R = state.R;
+    double thrust = state.thrust;
+    double thrust_dot = state.thrust_dot;
+    const Eigen::Vector3d &p_d = desired.p;
+    const Eigen::Vector3d &v_d = desired.v;
+    const Eigen::Vector3d &acc_d = desired.a;
+    const Eigen::Vector3d &jerk_d = desired.j;
+    Eigen::Vector3d snap_d(snap.x, snap.y, snap.z);
+    const Eigen::Vector3d &w = state.w;
+
+    Eigen::Vector3d f = m_ * ag_;
+    Eigen::Vector3d g = R * e_ * thrust;
+
+    Vector6d x, x_dot;
+    x << state.p, state.v;
+    x_dot = A_ * x + B_ * (f + g);
+
+    Vector6d x_d, x_d_dot, x_d_ddot;
+    x_d << p_d, v_d;
+    x_d_dot << v_d, acc_d;
+    x_d_ddot << acc_d, jerk_d;
+
+    Eigen::Matrix3d w_hat = math::hat(w);
+    Vector6d z0 = x - x_d;
+    Vector6d z0_dot = x_dot - x_d_dot;
+    Eigen::Vector3d g_d = m_ * acc_d - K_ * z0 - f;
+    Eigen::Vector3d z1 = g - g_d;
+    Eigen::Vector3d g_d_dot = m_ * jerk_d - K_ * z0_dot;
+    Eigen::Vector3d g_dot = R * (w_hat * e_ * thrust + e_ * thrust_dot);
+    Eigen::Vector3d z1_dot = g_dot - g_d_dot;
+    Vector6d x_ddot = A_ * x_dot + B_ * g_dot;
+    Eigen::Vector3d g_d_ddot = m_ * snap_d - K_ * (x_ddot - x_d_ddot);
+    Eigen::Vector3d a_d =
+        g_d_dot - B_.transpose() * P_ * z0 - config_.k1() * z1;
+    Eigen::Vector3d a_d_dot =
+        g_d_ddot - B_.transpose() * P_ * z0_dot - config_.k1() * z1_dot;
+    Eigen::Vector3d z2 = g_dot - a_d;
+    Eigen::Vector3d b_d = a_d_dot - z1 - config_.k2() * z2;
+    Eigen::Vector3d snap_cmd = R.transpose() * b_d -
+                               thrust * w_hat * w_hat * e_ -
+                               2.0 * thrust_dot * w_hat * e_;
+    if (std::abs(thrust) > config_.thrust_eps()) {
+      control.torque = J_ * (e_.cross(snap_cmd) / thrust) - (J_ * w).cross(w);
+    } else {
+      control.torque.setZero();
+    }
+    control.thrust_ddot = e_.dot(snap_cmd);
+  }
+
+private:
+  QrotorBacksteppingControllerConfig config_;
+  double m_;
+  Eigen::Vector3d e_;
+  Eigen::Vector3d ag_;
+  Matrix6d A_;
+  Eigen::Matrix<double, 6, 3> B_;
+  Eigen::Matrix<double, 3, 6> K_;
+  Matrix6d P_;
+  Eigen::Matrix3d J_;
+};
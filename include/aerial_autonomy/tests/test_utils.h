@@ -10,6 +10,7 @@
 #include <tf/transform_datatypes.h>
 #include <thread>
 
+#include "aerial_autonomy/types/pose.h"
 #include "aerial_autonomy/types/position_yaw.h"
 
 /**
@@ -116,6 +117,18 @@ void ASSERT_TF_NEAR(const tf::Transform &tf1, const tf::Transform &tf2,
               tol);
 }
 
+/**
+ * @brief Assert that two poses are close to each other
+ * @param pose1 First pose
+ * @param pose2 Second pose
+ * @param tol Tolerance
+ */
+void ASSERT_POSE_NEAR(const Pose &pose1, const Pose &pose2,
+                      double tol = 1e-8) {
+  ASSERT_VEC_NEAR(pose1.p, pose2.p, tol);
+  ASSERT_NEAR(pose1.angleTo(pose2), 0., tol);
+}
+
 /**
  * @brief Functor class that waits until the input function results in the
  * template parameter
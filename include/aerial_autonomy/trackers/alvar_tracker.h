@@ -40,10 +40,10 @@ public:
   virtual bool trackingIsValid();
 
   /**
-  * @brief Get the time stamp of the current tracking vectors
+  * @brief Get the time stamp of the current tracking vectors, which is the
+  * stamp of the last marker message in the timebase
   */
-  virtual std::chrono::time_point<std::chrono::high_resolution_clock>
-  getTrackingTime();
+  virtual timebase::TimePoint getTrackingTime();
 
   /**
   * @brief Check if subscriber is connected
@@ -69,12 +69,11 @@ private:
   /**
   * @brief Last time we received a non-empty Alvar message
   */
-  Atomic<ros::Time> last_valid_time_;
+  Atomic<timebase::TimePoint> last_valid_time_;
   /**
-  * @brief Last time we received a non-empty Alvar message
+  * @brief Stamp of the last non-empty Alvar message
   */
-  Atomic<std::chrono::time_point<std::chrono::high_resolution_clock>>
-      last_tracking_time_;
+  Atomic<timebase::TimePoint> last_tracking_time_;
   /**
   * @brief Stored tracking transforms
   */
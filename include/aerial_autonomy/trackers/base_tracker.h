@@ -1,9 +1,9 @@
 #pragma once
+#include "aerial_autonomy/common/timebase.h"
 #include "aerial_autonomy/trackers/tracking_strategy.h"
 
 #include <tf/tf.h>
 
-#include <chrono>
 #include <tuple>
 #include <unordered_map>
 
@@ -62,9 +62,8 @@ public:
   */
   // \todo Matt Remove this function and add time stamps to information stored
   // with tracking vector
-  virtual std::chrono::time_point<std::chrono::high_resolution_clock>
-  getTrackingTime() {
-    return std::chrono::high_resolution_clock::now();
+  virtual timebase::TimePoint getTrackingTime() {
+    return timebase::Clock::now();
   }
 
 private:
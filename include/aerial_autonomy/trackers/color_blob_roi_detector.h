@@ -0,0 +1,32 @@
+#pragma once
+
+#include "aerial_autonomy/trackers/roi_detector.h"
+#include "roi_detector_config.pb.h"
+
+/**
+* @brief Detects the largest blob of pixels within an HSV colour range
+*/
+class ColorBlobRoiDetector : public RoiDetector {
+public:
+  /**
+  * @brief Constructor
+  *
+  * @param config Colour range and smallest blob area
+  */
+  ColorBlobRoiDetector(const ColorBlobDetectorConfig &config);
+  /**
+  * @brief Detect the bounding box of the largest blob
+  *
+  * @param image BGR image
+  * @param roi Returned bounding box
+  * @return True if the largest blob is at least the minimum area
+  */
+  bool detect(const cv::Mat &image, sensor_msgs::RegionOfInterest &roi);
+
+private:
+  const ColorBlobDetectorConfig config_; ///< Colour range and minimum area
+  /**
+  * @brief Buffers reused between images of the same size
+  */
+  cv::Mat hsv_, mask_, wrapped_mask_, labels_, stats_, centroids_;
+};
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <opencv2/core/core.hpp>
+
+#include <sensor_msgs/RegionOfInterest.h>
+
+#include <memory>
+
+/**
+* @brief Detects the region of interest of the target in an RGB image
+*/
+class RoiDetector {
+public:
+  /**
+  * @brief Destructor
+  */
+  virtual ~RoiDetector() {}
+  /**
+  * @brief Detect the target
+  *
+  * @param image BGR image. Not modified or stored
+  * @param roi Returned region of interest
+  * @return True if the target is detected
+  */
+  virtual bool detect(const cv::Mat &image,
+                      sensor_msgs::RegionOfInterest &roi) = 0;
+};
+
+/**
+* @brief Owning pointer to a detector
+*/
+using RoiDetectorPtr = std::unique_ptr<RoiDetector>;
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "aerial_autonomy/common/atomic.h"
+#include "aerial_autonomy/sensors/sensor_history.h"
 #include "aerial_autonomy/trackers/base_tracker.h"
+#include "aerial_autonomy/trackers/roi_detector.h"
 #include "aerial_autonomy/trackers/simple_tracking_strategy.h"
 #include "aerial_autonomy/types/position.h"
 
@@ -17,30 +19,29 @@
 
 #include <Eigen/Dense>
 
+#include <array>
+#include <cstddef>
+
 #include <boost/thread/mutex.hpp>
 
 /**
 * @brief Converts a ROI in image to vector in camera frame
+*
+* ROIs are received from the roi topic, or detected in the RGB image by an
+* in-process detector. Detected ROIs are matched with the depth image that has
+* the same stamp, whichever of the two arrives first.
 */
 class RoiToPositionConverter : public BaseTracker {
 public:
   /**
   * @brief Constructor
   *
+  * @param name_space Namespace of the topics
+  * @param detector Detector run on the RGB image. ROIs are received from the
+  * roi topic if null
   */
-  RoiToPositionConverter(std::string name_space = "~tracker")
-      : BaseTracker(std::move(
-            std::unique_ptr<TrackingStrategy>(new SimpleTrackingStrategy()))),
-        nh_(name_space), it_(nh_),
-        roi_subscriber_(nh_.subscribe(
-            "roi", 10, &RoiToPositionConverter::roiCallback, this)),
-        camera_info_subscriber_(
-            nh_.subscribe("camera_info", 1,
-                          &RoiToPositionConverter::cameraInfoCallback, this)),
-        depth_subscriber_(nh_.subscribe(
-            "depth", 1, &RoiToPositionConverter::depthCallback, this)),
-        image_subscriber_(it_.subscribe(
-            "image", 1, &RoiToPositionConverter::imageCallback, this)) {}
+  RoiToPositionConverter(std::string name_space = "~tracker",
+                         RoiDetectorPtr detector = nullptr);
 
   /**
    * @brief Get the stored tracking vector
@@ -77,10 +78,16 @@ public:
   bool isConnected();
 
   /**
-  * @brief Get the time stamp of the current tracking vectors
+  * @brief Get the time stamp of the current tracking vectors, which is the
+  * stamp of the depth image used to compute them in the timebase
+  */
+  virtual timebase::TimePoint getTrackingTime();
+
+  /**
+  * @brief Delay from the stamp of the latest depth image to computing its
+  * tracking vector
   */
-  virtual std::chrono::time_point<std::chrono::high_resolution_clock>
-  getTrackingTime();
+  std::chrono::duration<double> getTrackingLatency();
 
 private:
   /**
@@ -125,6 +132,36 @@ private:
   */
   static bool compare(Eigen::Vector3d a, Eigen::Vector3d b);
 
+  /**
+  * @brief Compute and store the tracking vector of a ROI in a depth image.
+  * Should be called with the depth mutex locked
+  * @param roi Region of interest in the depth image
+  * @param depth_msg Depth message
+  */
+  void addObjectPose(const sensor_msgs::RegionOfInterest &roi,
+                     const sensor_msgs::ImageConstPtr &depth_msg);
+  /**
+  * @brief Find the ROI detected in the image with a header stamp. Should be
+  * called with the depth mutex locked
+  * @param stamp Header stamp of the image
+  * @param roi Returned region of interest
+  * @return False if no ROI was detected in an image with the stamp
+  */
+  bool findDetectedRoi(const ros::Time &stamp,
+                       sensor_msgs::RegionOfInterest &roi) const;
+
+  /**
+  * @brief ROI detected in an image
+  */
+  struct DetectedRoi {
+    ros::Time stamp;                   ///< Header stamp of the image
+    sensor_msgs::RegionOfInterest roi; ///< Detected ROI
+  };
+  /**
+  * @brief Number of detected ROIs kept for depth images arriving late
+  */
+  static constexpr std::size_t detected_roi_capacity_ = 32;
+
   /**
   * @brief ROS node handle for communication
   */
@@ -158,9 +195,10 @@ private:
   */
   Atomic<sensor_msgs::RegionOfInterest> roi_rect_;
   /**
-  * @brief Transform of object in camera frame (meters)
+  * @brief Transforms of object in camera frame (meters) stamped with the
+  * depth images used to compute them
   */
-  Atomic<tf::Transform> object_pose_;
+  SensorHistory<tf::Transform, 32, HoldInterpolation> object_poses_;
   /**
   * @brief Max distance of object from camera (meters)
   * \todo Make this a configurable param
@@ -175,10 +213,32 @@ private:
   /**
   * @brief last time ROI was updated
   */
-  Atomic<ros::Time> last_roi_update_time_;
+  Atomic<timebase::TimePoint> last_roi_update_time_;
+  /**
+  * @brief Detector run on the RGB image, null for ROIs from the roi topic
+  */
+  RoiDetectorPtr detector_;
+  /**
+  * @brief Ring of the latest ROIs detected, in stamp order. Guarded by the
+  * depth mutex
+  */
+  std::array<DetectedRoi, detected_roi_capacity_> detected_rois_;
+  /**
+  * @brief Number of ROIs detected since construction
+  */
+  std::size_t detected_roi_count_ = 0;
+  /**
+  * @brief Latest depth image still waiting for the ROI detected in the image
+  * with the same stamp
+  */
+  sensor_msgs::ImageConstPtr pending_depth_;
+  /**
+  * @brief Guards the detected ROIs, the pending depth image and adding object
+  * poses
+  */
+  boost::mutex depth_mutex_;
   /**
-  * @brief Last time we received a non-empty Alvar message
+  * @brief Delay from the depth stamp to computing the latest tracking vector
   */
-  Atomic<std::chrono::time_point<std::chrono::high_resolution_clock>>
-      last_tracking_time_;
+  Atomic<std::chrono::duration<double>> tracking_latency_;
 };
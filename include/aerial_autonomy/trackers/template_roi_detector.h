@@ -0,0 +1,38 @@
+#pragma once
+
+#include "aerial_autonomy/trackers/roi_detector.h"
+#include "roi_detector_config.pb.h"
+
+/**
+* @brief Detects the best match of a template image by normalized correlation
+*/
+class TemplateRoiDetector : public RoiDetector {
+public:
+  /**
+  * @brief Constructor loading the template from the configured path
+  *
+  * @param config Template path and minimum score
+  */
+  TemplateRoiDetector(const TemplateDetectorConfig &config);
+  /**
+  * @brief Constructor
+  *
+  * @param config Minimum score
+  * @param template_image BGR template
+  */
+  TemplateRoiDetector(const TemplateDetectorConfig &config,
+                      const cv::Mat &template_image);
+  /**
+  * @brief Detect the template
+  *
+  * @param image BGR image at least as large as the template
+  * @param roi Returned bounding box of the best match
+  * @return True if the best match scores at least the minimum score
+  */
+  bool detect(const cv::Mat &image, sensor_msgs::RegionOfInterest &roi);
+
+private:
+  const TemplateDetectorConfig config_; ///< Minimum score
+  const cv::Mat template_;              ///< BGR template
+  cv::Mat scores_; ///< Match scores reused between images of the same size
+};
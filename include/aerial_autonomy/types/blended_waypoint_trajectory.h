@@ -0,0 +1,96 @@
+#pragma once
+#include "aerial_autonomy/types/position_yaw.h"
+#include "aerial_autonomy/types/reference_trajectory.h"
+#include "aerial_autonomy/types/velocity_yaw_rate.h"
+
+#include <Eigen/Dense>
+#include <vector>
+
+/**
+ * @brief Time parameterized path through a sequence of waypoints which does
+ * not stop at the intermediate waypoints.
+ *
+ * The path moves along straight lines between waypoints at a constant cruise
+ * velocity. Corners are replaced by quadratic blends which start and end on
+ * the adjacent lines, so that the velocity is continuous through the corner.
+ * The blends are sized such that the path stays within the corner tolerance
+ * of the waypoint and do not extend past the middle of the adjacent lines.
+ *
+ * Yaw is linearly interpolated along each line from the yaw of the previous
+ * waypoint to the yaw of the next waypoint. Lines are slowed down if needed to
+ * respect the maximum yaw rate. Yaw is held constant during blends.
+ */
+class BlendedWaypointTrajectory
+    : public ReferenceTrajectory<PositionYaw, VelocityYawRate> {
+public:
+  /**
+  * @brief Constructor
+  * @param waypoints Absolute waypoints including the start position. Should
+  * have at least one waypoint
+  * @param velocity Cruise velocity (m/s)
+  * @param corner_tolerance Maximum distance between the path and an
+  * intermediate waypoint (m)
+  * @param max_yaw_rate Maximum yaw rate (rad/s)
+  */
+  BlendedWaypointTrajectory(const std::vector<PositionYaw> &waypoints,
+                            double velocity, double corner_tolerance,
+                            double max_yaw_rate);
+  /**
+  * @brief Get the reference position and velocity at given time
+  * @param t Time since the start of the trajectory (s). The trajectory is
+  * clamped to the first and last waypoints outside [0, duration]
+  * @return Reference position, yaw and velocity, yaw rate
+  */
+  std::pair<PositionYaw, VelocityYawRate> atTime(double t) const;
+  /**
+  * @brief Time taken to reach the last waypoint (s)
+  */
+  double duration() const;
+  /**
+  * @brief Index of the waypoint being approached at the given time. The
+  * waypoint is considered reached when the path passes the middle of its
+  * corner blend.
+  * @param t Time since the start of the trajectory (s)
+  * @return Waypoint index in [1, number of waypoints - 1], or 0 if there is
+  * only one waypoint
+  */
+  int waypointIndex(double t) const;
+
+private:
+  /**
+  * @brief Part of the path which is either a line or a corner blend
+  */
+  struct Piece {
+    bool is_blend;          ///< Whether the piece is a corner blend
+    double t_start;         ///< Start time of the piece
+    double t_duration;      ///< Duration of the piece
+    Eigen::Vector3d start;  ///< Start point of line or blend
+    Eigen::Vector3d middle; ///< Corner of blend (unused for lines)
+    Eigen::Vector3d end;    ///< End point of line or blend
+    double yaw_start;       ///< Yaw at the start of the piece
+    double yaw_change;      ///< Change in yaw over the piece
+    int waypoint_index;     ///< Waypoint approached during the piece
+  };
+  /**
+  * @brief Find the piece active at time t
+  * @param t Time since start
+  * @return Index into pieces_
+  */
+  std::size_t findPiece(double t) const;
+  /**
+  * @brief Pieces of the path in order
+  */
+  std::vector<Piece> pieces_;
+  /**
+  * @brief Last waypoint
+  */
+  PositionYaw final_waypoint_;
+  /**
+  * @brief Index of the last waypoint
+  */
+  int final_waypoint_index_;
+  /**
+  * @brief Total duration
+  */
+  double duration_;
+};
@@ -1,35 +1,37 @@
 #pragma once
 
-#include "aerial_autonomy/types/acceleration.h"
-#include "aerial_autonomy/types/jerk.h"
-#include "aerial_autonomy/types/position.h"
-#include "aerial_autonomy/types/velocity.h"
+#include <Eigen/Dense>
 
 /**
 * @brief State of 3D 4th order particle system
+*
+* Stored as fixed-size Eigen vectors so that controllers and reference
+* trajectories use Eigen arithmetic on the state without conversions
 */
 struct ParticleState {
   /**
-  * @brief Position
+  * @brief Position in m
   */
-  Position p;
+  Eigen::Vector3d p;
   /**
-  * @brief Velocity
+  * @brief Velocity in m/s
   */
-  Velocity v;
+  Eigen::Vector3d v;
   /**
-  * @brief Acceleration
+  * @brief Acceleration in m/s^2
   */
-  Acceleration a;
+  Eigen::Vector3d a;
   /**
-  * @brief Jerk
+  * @brief Jerk in m/s^3
   */
-  Jerk j;
+  Eigen::Vector3d j;
 
   /**
   * @brief Constructor
   */
-  ParticleState() : p(0, 0, 0), v(0, 0, 0), a(0, 0, 0), j(0, 0, 0) {}
+  ParticleState()
+      : p(Eigen::Vector3d::Zero()), v(Eigen::Vector3d::Zero()),
+        a(Eigen::Vector3d::Zero()), j(Eigen::Vector3d::Zero()) {}
 
   /**
   * @brief Constructor
@@ -38,7 +40,8 @@ struct ParticleState {
   * @param a Acceleration
   * @param j Jerk
   */
-  ParticleState(Position p, Velocity v, Acceleration a, Jerk j)
+  ParticleState(const Eigen::Vector3d &p, const Eigen::Vector3d &v,
+                const Eigen::Vector3d &a, const Eigen::Vector3d &j)
       : p(p), v(v), a(a), j(j) {}
 
   /**
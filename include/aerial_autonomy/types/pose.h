@@ -0,0 +1,156 @@
+#pragma once
+#include <Eigen/Dense>
+#include <cmath>
+
+/**
+ * @brief Rigid body pose stored as a fixed-size Eigen rotation matrix and
+ * position.
+ *
+ * Used by the controllers and connectors instead of tf::Transform, so that
+ * composing and comparing poses every tick uses Eigen arithmetic without
+ * quaternion or Euler angle round trips. Conversions to and from tf are only
+ * done at the ROS boundary, see common/eigen_views.h
+ */
+struct Pose {
+  /**
+  * @brief Implicit constructor
+  * Instantiate the identity pose
+  */
+  Pose() : R(Eigen::Matrix3d::Identity()), p(Eigen::Vector3d::Zero()) {}
+  /**
+  * @brief Explicit constructor
+  *
+  * @param R Rotation of the frame
+  * @param p Position of the frame origin in m
+  */
+  Pose(const Eigen::Matrix3d &R, const Eigen::Vector3d &p) : R(R), p(p) {}
+  /**
+  * @brief Create a pose from Euler ZYX angles, i.e. the convention used by
+  * tf::Matrix3x3::setRPY
+  *
+  * @param roll Rotation about x in rad
+  * @param pitch Rotation about y in rad
+  * @param yaw Rotation about z in rad
+  * @param p Position in m
+  *
+  * @return Pose with the given orientation and position
+  */
+  static Pose fromRPY(double roll, double pitch, double yaw,
+                      const Eigen::Vector3d &p = Eigen::Vector3d::Zero()) {
+    return Pose((Eigen::AngleAxisd(yaw, Eigen::Vector3d::UnitZ()) *
+                 Eigen::AngleAxisd(pitch, Eigen::Vector3d::UnitY()) *
+                 Eigen::AngleAxisd(roll, Eigen::Vector3d::UnitX()))
+                    .toRotationMatrix(),
+                p);
+  }
+
+  Eigen::Matrix3d R; ///< Rotation of the frame
+  Eigen::Vector3d p; ///< Position of the frame origin in m
+
+  /**
+  * @brief Homogeneous transformation matrix of the pose
+  * @return 4x4 matrix with the rotation and position of the pose
+  */
+  Eigen::Matrix4d matrix() const {
+    Eigen::Matrix4d m = Eigen::Matrix4d::Identity();
+    m.topLeftCorner<3, 3>() = R;
+    m.topRightCorner<3, 1>() = p;
+    return m;
+  }
+  /**
+  * @brief Compose two poses
+  * @param pose Pose expressed in this frame
+  * @return Pose in the parent frame of this pose
+  */
+  Pose operator*(const Pose &pose) const {
+    return Pose(R * pose.R, R * pose.p + p);
+  }
+  /**
+  * @brief Transform a point
+  * @param point Point expressed in this frame
+  * @return Point in the parent frame of this pose
+  */
+  Eigen::Vector3d operator*(const Eigen::Vector3d &point) const {
+    return R * point + p;
+  }
+  /**
+  * @brief Inverse of the pose
+  * @return Pose of the parent frame in this frame
+  */
+  Pose inverse() const {
+    Eigen::Matrix3d R_inv = R.transpose();
+    return Pose(R_inv, -(R_inv * p));
+  }
+  /**
+  * @brief Compose the inverse of this pose with another pose, i.e.
+  * inverse() * pose without forming the inverse
+  * @param pose Pose expressed in the parent frame of this pose
+  * @return Pose expressed in this frame
+  */
+  Pose inverseTimes(const Pose &pose) const {
+    return Pose(R.transpose() * pose.R, R.transpose() * (pose.p - p));
+  }
+  /**
+  * @brief Yaw under Euler ZYX convention. Equivalent to the yaw returned by
+  * tf::Matrix3x3::getRPY, including the gimbal lock case, without computing
+  * roll and pitch
+  * @return Yaw in rad
+  */
+  double yaw() const {
+    if (std::abs(R(2, 0)) >= 1) {
+      return 0;
+    }
+    return std::atan2(R(1, 0), R(0, 0));
+  }
+  /**
+  * @brief Euler ZYX angles, the convention of tf::Matrix3x3::getRPY. In
+  * gimbal lock yaw is set to zero
+  * @param roll Rotation about x in rad
+  * @param pitch Rotation about y in rad
+  * @param yaw Rotation about z in rad
+  */
+  void getRPY(double &roll, double &pitch, double &yaw) const {
+    if (std::abs(R(2, 0)) >= 1) {
+      yaw = 0;
+      if (R(2, 0) < 0) {
+        pitch = M_PI / 2;
+        roll = std::atan2(R(0, 1), R(0, 2));
+      } else {
+        pitch = -M_PI / 2;
+        roll = std::atan2(-R(0, 1), -R(0, 2));
+      }
+      return;
+    }
+    pitch = -std::asin(R(2, 0));
+    roll = std::atan2(R(2, 1), R(2, 2));
+    yaw = std::atan2(R(1, 0), R(0, 0));
+  }
+  /**
+  * @brief Angle of the rotation between the orientations of two poses
+  * @param pose Pose to compare against
+  * @return Angle in [0, pi] rad
+  */
+  double angleTo(const Pose &pose) const {
+    const Eigen::Matrix3d dR = R.transpose() * pose.R;
+    // sin and cos of the angle from the skew and symmetric parts of dR,
+    // which is accurate for small angles unlike acos of the trace
+    const double sin_angle = 0.5 * Eigen::Vector3d(dR(2, 1) - dR(1, 2),
+                                                   dR(0, 2) - dR(2, 0),
+                                                   dR(1, 0) - dR(0, 1))
+                                       .norm();
+    const double cos_angle = 0.5 * (dR.trace() - 1);
+    return std::atan2(sin_angle, cos_angle);
+  }
+  /**
+  * @brief Compare two poses
+  * @param pose Pose to compare against
+  * @return True if the poses are the same
+  */
+  bool operator==(const Pose &pose) const { return R == pose.R && p == pose.p; }
+  /**
+  * @brief Compare two poses
+  * @param pose Pose to compare against
+  * @return True if the poses are not the same
+  */
+  bool operator!=(const Pose &pose) const { return !(*this == pose); }
+};
@@ -1,5 +1,5 @@
 #pragma once
-#include <tf/tf.h>
+#include <Eigen/Dense>
 
 /**
  * @brief Controls for a quadrotor given by a backstepping controller
@@ -12,5 +12,5 @@ struct QrotorBacksteppingControl {
   /**
   * @brief Body torques
   */
-  tf::Vector3 torque;
+  Eigen::Vector3d torque;
 };
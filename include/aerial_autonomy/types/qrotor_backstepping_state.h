@@ -1,5 +1,5 @@
 #pragma once
-#include <tf/tf.h>
+#include <Eigen/Dense>
 
 /**
  * @brief State of a quadrotor system with additional dynamic
@@ -10,20 +10,25 @@ struct QrotorBacksteppingState {
   * @brief Default constructor
   */
   QrotorBacksteppingState()
-      : pose(tf::Quaternion(0, 0, 0, 1), tf::Vector3(0, 0, 0)), v(0, 0, 0),
-        w(0, 0, 0), thrust(0), thrust_dot(0) {}
+      : R(Eigen::Matrix3d::Identity()), p(Eigen::Vector3d::Zero()),
+        v(Eigen::Vector3d::Zero()), w(Eigen::Vector3d::Zero()), thrust(0),
+        thrust_dot(0) {}
   /**
-  * @brief SE(3) pose
+  * @brief Body rotation in global frame
   */
-  tf::Transform pose;
+  Eigen::Matrix3d R;
+  /**
+  * @brief Position
+  */
+  Eigen::Vector3d p;
   /**
   * @brief Velocity
   */
-  tf::Vector3 v;
+  Eigen::Vector3d v;
   /**
   * @brief Angular velocity
   */
-  tf::Vector3 w;
+  Eigen::Vector3d w;
   /**
   * @brief Body-z thrust
   */
@@ -0,0 +1,55 @@
+#pragma once
+#include <Eigen/Dense>
+
+/**
+ * @brief Linear and angular velocity of a rigid body stored as fixed-size
+ * Eigen vectors
+ */
+struct Twist {
+  /**
+  * @brief Implicit constructor
+  * Instantiate linear and angular velocities to zero
+  */
+  Twist() : v(Eigen::Vector3d::Zero()), w(Eigen::Vector3d::Zero()) {}
+  /**
+  * @brief Explicit constructor
+  *
+  * @param v Linear velocity in m/s
+  * @param w Angular velocity in rad/s
+  */
+  Twist(const Eigen::Vector3d &v, const Eigen::Vector3d &w) : v(v), w(w) {}
+
+  Eigen::Vector3d v; ///< Linear velocity in m/s
+  Eigen::Vector3d w; ///< Angular velocity in rad/s
+
+  /**
+  * @brief Add two twists
+  * @param t Twist to add
+  * @return Sum of the twists
+  */
+  Twist operator+(const Twist &t) const { return Twist(v + t.v, w + t.w); }
+  /**
+  * @brief Subtract two twists
+  * @param t Twist to subtract
+  * @return Difference of the twists
+  */
+  Twist operator-(const Twist &t) const { return Twist(v - t.v, w - t.w); }
+  /**
+  * @brief Multiply times a scalar
+  * @param m Multiplier
+  * @return Scaled twist
+  */
+  Twist operator*(const double &m) const { return Twist(v * m, w * m); }
+  /**
+  * @brief Compare two twists
+  * @param t Twist to compare against
+  * @return True if the twists are the same
+  */
+  bool operator==(const Twist &t) const { return v == t.v && w == t.w; }
+  /**
+  * @brief Compare two twists
+  * @param t Twist to compare against
+  * @return True if the twists are not the same
+  */
+  bool operator!=(const Twist &t) const { return !(*this == t); }
+};
@@ -2,11 +2,26 @@
 import numpy as np
 import matplotlib.pyplot as plt
 import argparse
+import io
+import subprocess
 import sys
 import os
 import tf.transformations as tf
 
 
+def read_stream(path):
+    """
+    Read a data stream, converting compressed streams with decompress_log
+    """
+    with open(path, 'rb') as stream_file:
+        compressed = stream_file.read(8) == b'AALOGZD1'
+    if compressed:
+        text = subprocess.check_output(
+            ['rosrun', 'aerial_autonomy', 'decompress_log', path])
+        return np.genfromtxt(io.BytesIO(text), delimiter=',', names=True)
+    return np.genfromtxt(path, delimiter=',', names=True)
+
+
 def quat2RPY(qx, qy, qz, qw):
     N = len(qx)
     rpy_out = np.empty((N, 3))
@@ -27,11 +42,9 @@ parser.add_argument('--write_data', dest='write_data',
 parser.add_argument('--sensor_delay', type=float, default=0.15)
 parser.add_argument('--max_t', type=float, default=0.0)
 args = parser.parse_args()
-mocap_data = np.genfromtxt(os.path.join(args.directory, 'mocap_logger'),
-                           delimiter=',', names=True)
-rpyt_data = np.genfromtxt(os.path.join(args.directory,
-                                       'manual_rpyt_controller'),
-                          delimiter=',', names=True)
+mocap_data = read_stream(os.path.join(args.directory, 'mocap_logger'))
+rpyt_data = read_stream(os.path.join(args.directory,
+                                     'manual_rpyt_controller'))
 rpyt_ts = (rpyt_data['Time'] - rpyt_data['Time'][0]) / 1e9
 if args.max_t == 0:
     max_t = rpyt_ts[-1]
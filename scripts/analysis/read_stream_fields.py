@@ -0,0 +1,93 @@
+#!/usr/bin/env python2
+"""
+Read a text data stream whose header declares typed fields, e.g.
+"#Time,q[6],R[3x3],traj[?x4],goal<yaw|pos[3]>". Compressed streams should
+be converted with decompress_log first.
+
+Each data point is returned as a dictionary from field names to numpy
+arrays. Tagged unions are returned as (alternative name, array) tuples.
+"""
+import numpy as np
+import argparse
+import re
+
+field_pattern = re.compile(r'^([^\[\]<>|]+)(?:\[(\d*|\?x\d+|\d+x\d+)\])?$')
+
+
+def parse_field(declaration):
+    """
+    Parse a field declaration into (name, kind, rows, cols, alternatives)
+    """
+    if '<' in declaration:
+        name, alternatives = declaration[:-1].split('<', 1)
+        return (name, 'tagged', 0, 0,
+                [parse_field(a) for a in alternatives.split('|')])
+    match = field_pattern.match(declaration)
+    if not match:
+        raise ValueError('Invalid field declaration: ' + declaration)
+    name, dimensions = match.groups()
+    if dimensions is None:
+        return (name, 'scalar', 1, 1, [])
+    if dimensions == '':
+        return (name, 'variable', 0, 1, [])
+    if dimensions.startswith('?x'):
+        return (name, 'variable', 0, int(dimensions[2:]), [])
+    if 'x' in dimensions:
+        rows, cols = dimensions.split('x')
+        return (name, 'fixed', int(rows), int(cols), [])
+    return (name, 'fixed', int(dimensions), 1, [])
+
+
+def read_field(field, values, offset):
+    """
+    Read a field from the values of a data point starting at offset
+    Returns the field value and the offset past the field
+    """
+    name, kind, rows, cols, alternatives = field
+    if kind == 'tagged':
+        alternative = alternatives[int(values[offset])]
+        value, offset = read_field(alternative, values, offset + 1)
+        return (alternative[0], value), offset
+    if kind == 'variable':
+        rows = int(values[offset])
+        offset += 1
+    value = np.array(values[offset:offset + rows * cols])
+    if kind == 'scalar':
+        value = value[0]
+    elif cols > 1:
+        value = value.reshape(rows, cols)
+    return value, offset + rows * cols
+
+
+def read_stream(path, delimiter=','):
+    """
+    Read a text data stream into a list of (timestamp, fields) pairs
+    """
+    fields = []
+    records = []
+    with open(path) as stream:
+        for line in stream:
+            line = line.rstrip('\n')
+            if line.startswith('#'):
+                fields = [parse_field(c) for c in line.split(delimiter)[1:]]
+                continue
+            columns = line.split(delimiter)
+            values = [float(v) for v in columns[1:]]
+            offset = 0
+            record = {}
+            for field in fields:
+                record[field[0]], offset = read_field(field, values, offset)
+            if offset != len(values):
+                raise ValueError('Data point does not match the header: ' +
+                                 line)
+            records.append((int(columns[0]), record))
+    return records
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(prog='read_stream_fields')
+    parser.add_argument('stream', type=str, help='Stream file')
+    parser.add_argument('--delimiter', type=str, default=',')
+    args = parser.parse_args()
+    for timestamp, record in read_stream(args.stream, args.delimiter):
+        print timestamp, record
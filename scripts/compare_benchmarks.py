@@ -0,0 +1,92 @@
+#!/usr/bin/env python
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import sys
+
+"""
+Compare the json output of aerial_autonomy_benchmarks against a stored
+baseline and flag benchmarks that became slower than a threshold
+"""
+
+ACCEPTABLE_SLOWDOWN=10
+
+# Conversion factors from google benchmark time units to nanoseconds
+TIME_UNIT_NS = {'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+
+def loadBenchmarks(path):
+  """
+  Load the benchmark results from a json file into a dictionary from
+  benchmark name to (real time, cpu time) in nanoseconds. Aggregates
+  such as mean and stddev produced by --benchmark_repetitions are skipped
+  except for the mean which replaces the individual runs.
+  """
+  with open(path) as json_file:
+    data = json.load(json_file)
+  benchmarks = {}
+  for benchmark in data['benchmarks']:
+    run_type = benchmark.get('run_type', 'iteration')
+    aggregate = benchmark.get('aggregate_name', '')
+    if run_type == 'aggregate' and aggregate != 'mean':
+      continue
+    name = benchmark.get('run_name', benchmark['name'])
+    scale = TIME_UNIT_NS[benchmark.get('time_unit', 'ns')]
+    benchmarks[name] = (benchmark['real_time'] * scale,
+                        benchmark['cpu_time'] * scale)
+  return benchmarks
+
+def main():
+  # Arguments
+  parser = argparse.ArgumentParser()
+  parser.add_argument ("baseline",    action="store",      help="Path to baseline benchmark json (--benchmark_out_format=json)")
+  parser.add_argument ("current",     action="store",      help="Path to current benchmark json")
+  parser.add_argument ("--threshold", action="store",      help="Max acceptable slowdown percentage (Default: %s)"%(ACCEPTABLE_SLOWDOWN), default=ACCEPTABLE_SLOWDOWN, type=float)
+  parser.add_argument ("--time",      action="store",      help="Time to compare (Default: cpu)", choices=['cpu', 'real'], default='cpu')
+  ns = parser.parse_args()
+  if not ns:
+    print ("ERROR: Couldn't parse parameters")
+    sys.exit(-1)
+
+  for path in [ns.baseline, ns.current]:
+    if not os.path.exists(path):
+      print ("Cannot find benchmark results: {0}".format(path))
+      sys.exit(-1)
+
+  baseline = loadBenchmarks(ns.baseline)
+  current = loadBenchmarks(ns.current)
+  time_index = 1 if ns.time == 'cpu' else 0
+
+  regressions = []
+  name_width = max([len(name) for name in current] + [len('Benchmark')])
+  print ("{0:<{w}} {1:>14} {2:>14} {3:>9}".format(
+      'Benchmark', 'Baseline (ns)', 'Current (ns)', 'Change', w=name_width))
+  for name in sorted(current):
+    if name not in baseline:
+      print ("{0:<{w}} {1:>14} {2:>14.1f} {3:>9}".format(
+          name, '-', current[name][time_index], 'new', w=name_width))
+      continue
+    baseline_time = baseline[name][time_index]
+    current_time = current[name][time_index]
+    change = 100.0 * (current_time - baseline_time) / baseline_time
+    flag = ''
+    if change > ns.threshold:
+      regressions.append(name)
+      flag = ' REGRESSION'
+    print ("{0:<{w}} {1:>14.1f} {2:>14.1f} {3:>+8.1f}%{4}".format(
+        name, baseline_time, current_time, change, flag, w=name_width))
+
+  missing = sorted(set(baseline) - set(current))
+  for name in missing:
+    print ("Missing from current run: {0}".format(name))
+
+  if regressions:
+    print ("{0} benchmark(s) slower than baseline by more than {1}%".format(
+        len(regressions), ns.threshold))
+    sys.exit(1)
+  print ("No regressions above {0}%".format(ns.threshold))
+
+if __name__ == '__main__':
+  main()
@@ -3,13 +3,19 @@
 #include <stdexcept>
 
 AsyncTimer::AsyncTimer(std::function<void()> function,
-                       std::chrono::duration<double> timer_duration)
-    : function_(function), timer_duration_(timer_duration), running_(false) {}
+                       std::chrono::duration<double> timer_duration,
+                       TimerExecutor *executor)
+    : function_(function), timer_duration_(timer_duration), running_(false),
+      executor_(executor), task_id_(-1) {}
 
 AsyncTimer::~AsyncTimer() { stop(); }
 
 void AsyncTimer::stop() {
   running_ = false;
+  if (task_id_ >= 0) {
+    executor_->cancel(task_id_);
+    task_id_ = -1;
+  }
   if (timer_thread_.joinable()) {
     timer_thread_.join();
   }
@@ -18,6 +24,10 @@ void AsyncTimer::stop() {
 void AsyncTimer::start() {
   if (!running_) {
     running_ = true;
+    if (executor_) {
+      task_id_ = executor_->schedule(function_, timer_duration_);
+      return;
+    }
     timer_thread_ = std::thread(std::bind(&AsyncTimer::functionTimer, this));
   } else {
     throw std::logic_error("Cannot start AsyncTimer twice!");
@@ -0,0 +1,51 @@
+#include "aerial_autonomy/common/controller_timer_hook.h"
+
+#include <glog/logging.h>
+
+namespace {
+/**
+ * @brief Installed wrapper, empty if none is installed
+ */
+ControllerTimerHook::Wrapper &installedWrapper() {
+  static ControllerTimerHook::Wrapper wrapper;
+  return wrapper;
+}
+
+/**
+ * @brief Installed reporter, empty if none is installed
+ */
+ControllerTimerHook::Reporter &installedReporter() {
+  static ControllerTimerHook::Reporter reporter;
+  return reporter;
+}
+}
+
+void ControllerTimerHook::install(Wrapper wrapper, Reporter reporter) {
+  installedWrapper() = wrapper;
+  installedReporter() = reporter;
+}
+
+bool ControllerTimerHook::installed() {
+  return static_cast<bool>(installedWrapper());
+}
+
+ControllerTimerHook::ControllerTimerHook(bool enabled) : enabled_(enabled) {
+  if (enabled_ && !installed()) {
+    LOG(WARNING) << "Controller timer hook enabled but not installed. Link "
+                    "the allocation tracker to record controller call sites";
+  }
+}
+
+ControllerTimerHook::~ControllerTimerHook() {
+  if (enabled_ && installedReporter()) {
+    LOG(INFO) << "Controller timer report:\n" << installedReporter()();
+  }
+}
+
+std::function<void()>
+ControllerTimerHook::wrap(std::function<void()> function) const {
+  if (!enabled_ || !installed()) {
+    return function;
+  }
+  return installedWrapper()(function);
+}
@@ -30,6 +30,12 @@ void positionYawToTf(const PositionYaw &p, tf::Transform &tf) {
   tf.setOrigin(tf::Vector3(p.x, p.y, p.z));
 }
 
+Pose positionYawToPose(const PositionYaw &p) {
+  Eigen::Matrix3d R;
+  R = Eigen::AngleAxisd(p.yaw, Eigen::Vector3d::UnitZ());
+  return Pose(R, toEigen(p));
+}
+
 PositionYaw protoPositionYawToPositionYaw(config::PositionYaw p) {
   return PositionYaw(p.position().x(), p.position().y(), p.position().z(),
                      p.yaw());
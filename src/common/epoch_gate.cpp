@@ -0,0 +1,23 @@
+#include "aerial_autonomy/common/epoch_gate.h"
+
+#include <thread>
+
+EpochGate::EpochGate() : epoch_(0) {
+  readers_[0] = 0;
+  readers_[1] = 0;
+}
+
+void EpochGate::synchronize() {
+  std::lock_guard<std::mutex> lock(synchronize_mutex_);
+  // New readers count in the slot of the new epoch, but readers that loaded
+  // the previous epoch may still increment the drained slot. Flipping twice
+  // waits for those as well.
+  for (int i = 0; i < 2; ++i) {
+    int slot = epoch_++ & 1;
+    while (readers_[slot] != 0) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+int EpochGate::readers() const { return readers_[0] + readers_[1]; }
@@ -0,0 +1,95 @@
+#include "aerial_autonomy/common/frame_graph.h"
+
+#include <glog/logging.h>
+
+#include <limits>
+
+namespace {
+/**
+* @brief Version of transforms that are never composed again
+*/
+constexpr std::uint64_t static_version =
+    std::numeric_limits<std::uint64_t>::max();
+/**
+* @brief Version of transforms not composed yet
+*/
+constexpr std::uint64_t invalid_version = 0;
+}
+
+constexpr FrameGraph::FrameId FrameGraph::root;
+
+FrameGraph::FrameGraph() : version_(1) {
+  frames_.push_back(Frame{root, 0, false, Pose()});
+  cache_.resize(1, CacheEntry{Pose(), static_version});
+}
+
+FrameGraph::FrameId FrameGraph::addStaticFrame(FrameId parent,
+                                               const Pose &pose_in_parent) {
+  return addFrame(parent, false, pose_in_parent);
+}
+
+FrameGraph::FrameId FrameGraph::addDynamicFrame(FrameId parent) {
+  return addFrame(parent, true, Pose());
+}
+
+FrameGraph::FrameId FrameGraph::addFrame(FrameId parent, bool dynamic,
+                                         const Pose &pose_in_parent) {
+  CHECK_LT(parent, frames_.size()) << "Unknown parent frame";
+  frames_.push_back(
+      Frame{parent, frames_[parent].depth + 1, dynamic, pose_in_parent});
+  cache_.assign(frames_.size() * frames_.size(),
+                CacheEntry{Pose(), invalid_version});
+  return frames_.size() - 1;
+}
+
+void FrameGraph::setDynamicPose(FrameId frame, const Pose &pose_in_parent) {
+  CHECK_LT(frame, frames_.size()) << "Unknown frame";
+  CHECK(frames_[frame].dynamic) << "Pose of a static frame cannot change";
+  frames_[frame].pose_in_parent = pose_in_parent;
+  ++version_;
+}
+
+const Pose &FrameGraph::getTransform(FrameId target, FrameId source) {
+  CHECK_LT(target, frames_.size()) << "Unknown target frame";
+  CHECK_LT(source, frames_.size()) << "Unknown source frame";
+  CacheEntry &entry = cacheEntry(target, source);
+  if (entry.version == static_version || entry.version == version_) {
+    return entry.transform;
+  }
+  // Find the lowest common ancestor so that static subtrees under a dynamic
+  // frame, e.g. camera and arm on the body, are composed only once
+  FrameId target_ancestor = target;
+  FrameId source_ancestor = source;
+  while (frames_[target_ancestor].depth > frames_[source_ancestor].depth) {
+    target_ancestor = frames_[target_ancestor].parent;
+  }
+  while (frames_[source_ancestor].depth > frames_[target_ancestor].depth) {
+    source_ancestor = frames_[source_ancestor].parent;
+  }
+  while (target_ancestor != source_ancestor) {
+    target_ancestor = frames_[target_ancestor].parent;
+    source_ancestor = frames_[source_ancestor].parent;
+  }
+  bool dynamic = false;
+  Pose target_pose = composeToAncestor(target, target_ancestor, dynamic);
+  Pose source_pose = composeToAncestor(source, source_ancestor, dynamic);
+  std::uint64_t version = dynamic ? version_ : static_version;
+  entry.transform = target_pose.inverseTimes(source_pose);
+  entry.version = version;
+  // Store the inverse as well since both directions are usually looked up
+  CacheEntry &inverse_entry = cacheEntry(source, target);
+  inverse_entry.transform = entry.transform.inverse();
+  inverse_entry.version = version;
+  return entry.transform;
+}
+
+Pose FrameGraph::composeToAncestor(FrameId frame, FrameId ancestor,
+                                   bool &dynamic) const {
+  Pose pose;
+  for (; frame != ancestor; frame = frames_[frame].parent) {
+    const Frame &link = frames_[frame];
+    dynamic = dynamic || link.dynamic;
+    pose = link.pose_in_parent * pose;
+  }
+  return pose;
+}
@@ -0,0 +1,101 @@
+#include "aerial_autonomy/common/tick_pipeline.h"
+#include "aerial_autonomy/common/html_utils.h"
+#include "aerial_autonomy/log/log.h"
+
+#include <stdexcept>
+
+TickPipeline::TickPipeline(std::string stream_id)
+    : stream_id_(stream_id), tick_count_(0), header_written_(false) {
+  // The last entry times the whole tick
+  stages_.push_back(Stage{nullptr, 1, Clock::duration::zero(),
+                          TickStageTiming{"tick", 0, 0, 0, 0}, 0});
+}
+
+void TickPipeline::addStage(std::string name, std::function<void()> stage,
+                            unsigned int decimation) {
+  if (tick_count_ > 0) {
+    throw std::logic_error("Cannot add a stage to a running tick pipeline");
+  }
+  if (decimation == 0) {
+    throw std::out_of_range("Tick pipeline decimation should be positive");
+  }
+  stages_.insert(stages_.end() - 1,
+                 Stage{stage, decimation, Clock::duration::zero(),
+                       TickStageTiming{name, 0, 0, 0, 0}, 0});
+}
+
+void TickPipeline::tick() {
+  if (!header_written_) {
+    DataStream &header = DATA_HEADER(stream_id_);
+    for (const auto &stage : stages_) {
+      header << stage.timing.name;
+    }
+    header << DataStream::endl;
+    header_written_ = true;
+  }
+  Clock::time_point tick_start = Clock::now();
+  for (auto stage = stages_.begin(); stage != stages_.end() - 1; ++stage) {
+    if (tick_count_ % stage->decimation != 0) {
+      stage->duration = Clock::duration::zero();
+      continue;
+    }
+    Clock::time_point start = Clock::now();
+    stage->function();
+    stage->duration = Clock::now() - start;
+  }
+  stages_.back().duration = Clock::now() - tick_start;
+  {
+    std::lock_guard<std::mutex> lock(timing_mutex_);
+    for (auto &stage : stages_) {
+      if (tick_count_ % stage.decimation == 0) {
+        recordRun(stage);
+      }
+    }
+  }
+  DataStream &stream = DATA_LOG(stream_id_);
+  for (const auto &stage : stages_) {
+    stream << std::chrono::duration<double>(stage.duration).count();
+  }
+  stream << DataStream::endl;
+  ++tick_count_;
+}
+
+std::vector<TickStageTiming> TickPipeline::timings() {
+  std::lock_guard<std::mutex> lock(timing_mutex_);
+  std::vector<TickStageTiming> timings;
+  for (const auto &stage : stages_) {
+    timings.push_back(stage.timing);
+  }
+  return timings;
+}
+
+std::string TickPipeline::getStatus() {
+  HtmlTableWriter table_writer;
+  table_writer.beginRow();
+  table_writer.addHeader("Tick Pipeline (ms)", Colors::blue, 4);
+  table_writer.beginRow();
+  table_writer.addCell("Stage");
+  table_writer.addCell("Last");
+  table_writer.addCell("Mean");
+  table_writer.addCell("Max");
+  for (const auto &timing : timings()) {
+    table_writer.beginRow();
+    table_writer.addCell(timing.name);
+    table_writer.addCell(1e3 * timing.last);
+    table_writer.addCell(1e3 * timing.mean);
+    table_writer.addCell(1e3 * timing.max);
+  }
+  return table_writer.getTableString();
+}
+
+void TickPipeline::recordRun(Stage &stage) {
+  double duration = std::chrono::duration<double>(stage.duration).count();
+  TickStageTiming &timing = stage.timing;
+  ++timing.calls;
+  timing.last = duration;
+  if (duration > timing.max) {
+    timing.max = duration;
+  }
+  stage.total += duration;
+  timing.mean = stage.total / timing.calls;
+}
@@ -0,0 +1,88 @@
+#include "aerial_autonomy/common/timebase.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+
+namespace {
+/**
+ * @brief Differences between the sampled and the recorded offset that are
+ * treated as sampling jitter (ns)
+ */
+constexpr int64_t offset_tolerance = 1000000;
+/**
+ * @brief Differences between the sampled and the recorded offset that are
+ * treated as a jump of the reference clock, e.g. a restarted simulation (ns)
+ */
+constexpr int64_t offset_jump = 1000000000;
+/**
+ * @brief Maximum increase of the recorded offset per nanosecond of the
+ * timebase, so that converted stamps keep their order
+ */
+constexpr double max_offset_slew = 0.5;
+
+/**
+ * @brief Recorded mapping from the ROS or wall time of stamps to the timebase
+ */
+struct ReferenceMapping {
+  std::mutex mutex;        ///< Synchronize access to the mapping
+  bool initialized{false}; ///< Whether the offset is recorded
+  int64_t offset{0};       ///< Reference time minus timebase time (ns)
+  int64_t update_time{0};  ///< Timebase time of the last update (ns)
+};
+
+ReferenceMapping &referenceMapping() {
+  static ReferenceMapping mapping;
+  return mapping;
+}
+}
+
+namespace timebase {
+int64_t now() { return toNanoseconds(Clock::now()); }
+
+int64_t toNanoseconds(TimePoint time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             time.time_since_epoch())
+      .count();
+}
+
+int64_t wallTime() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+int64_t rosTime() {
+  return ros::Time::isValid() ? ros::Time::now().toNSec() : 0;
+}
+
+int64_t referenceOffset() {
+  int64_t current_time = now();
+  int64_t reference = ros::Time::isValid() ? rosTime() : wallTime();
+  int64_t sample = reference - current_time;
+  ReferenceMapping &mapping = referenceMapping();
+  std::lock_guard<std::mutex> lock(mapping.mutex);
+  int64_t difference = sample - mapping.offset;
+  if (!mapping.initialized || std::llabs(difference) > offset_jump) {
+    mapping.offset = sample;
+    mapping.initialized = true;
+  } else if (difference < -offset_tolerance) {
+    // The reference clock runs slower than the timebase. Decreasing the
+    // offset moves converted stamps later, which keeps their order
+    mapping.offset = sample;
+  } else if (difference > offset_tolerance) {
+    // The reference clock runs faster than the timebase. Slew the offset so
+    // that stamps converted later are not moved before earlier ones
+    int64_t max_step =
+        int64_t(max_offset_slew * (current_time - mapping.update_time));
+    mapping.offset += std::min(difference, max_step);
+  }
+  mapping.update_time = current_time;
+  return mapping.offset;
+}
+
+TimePoint fromRosTime(const ros::Time &stamp) {
+  return TimePoint(std::chrono::duration_cast<Clock::duration>(
+      std::chrono::nanoseconds(int64_t(stamp.toNSec()) - referenceOffset())));
+}
+}
@@ -0,0 +1,100 @@
+#include "aerial_autonomy/common/worker_pool.h"
+
+#include <stdexcept>
+
+WorkerPool::WorkerPool(unsigned int thread_count)
+    : next_id_(0), stopping_(false) {
+  if (thread_count == 0) {
+    throw std::out_of_range("Worker pool needs at least one thread");
+  }
+  for (unsigned int i = 0; i < thread_count; ++i) {
+    threads_.emplace_back(&WorkerPool::work, this);
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  work_condition_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+int WorkerPool::schedule(std::function<void()> task,
+                         std::chrono::duration<double> period) {
+  std::shared_ptr<Task> new_task(new Task{
+      task, std::chrono::duration_cast<Clock::duration>(period), Clock::now(),
+      false, false, std::thread::id()});
+  int id;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    id = next_id_++;
+    tasks_[id] = new_task;
+    due_tasks_.push(DueTask{new_task->due_time, id});
+  }
+  work_condition_.notify_one();
+  return id;
+}
+
+void WorkerPool::cancel(int id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto task_it = tasks_.find(id);
+  if (task_it == tasks_.end()) {
+    return;
+  }
+  std::shared_ptr<Task> task = task_it->second;
+  task->cancelled = true;
+  tasks_.erase(task_it);
+  // A task cancelling itself cannot wait for its own call to finish
+  if (task->thread != std::this_thread::get_id()) {
+    done_condition_.wait(lock, [&task]() { return !task->running; });
+  }
+}
+
+unsigned int WorkerPool::threadCount() const { return threads_.size(); }
+
+std::size_t WorkerPool::taskCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return tasks_.size();
+}
+
+void WorkerPool::work() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    if (due_tasks_.empty()) {
+      work_condition_.wait(lock);
+      continue;
+    }
+    DueTask due_task = due_tasks_.top();
+    if (Clock::now() < due_task.due_time) {
+      work_condition_.wait_until(lock, due_task.due_time);
+      continue;
+    }
+    due_tasks_.pop();
+    auto task_it = tasks_.find(due_task.id);
+    if (task_it == tasks_.end()) {
+      continue; // Cancelled while waiting
+    }
+    std::shared_ptr<Task> task = task_it->second;
+    task->running = true;
+    task->thread = std::this_thread::get_id();
+    lock.unlock();
+    task->function();
+    lock.lock();
+    task->running = false;
+    task->thread = std::thread::id();
+    if (!task->cancelled) {
+      // Skip the periods missed by an overrunning call
+      Clock::time_point now = Clock::now();
+      task->due_time += task->period;
+      if (task->due_time < now) {
+        task->due_time = now;
+      }
+      due_tasks_.push(DueTask{task->due_time, due_task.id});
+    }
+    done_condition_.notify_all();
+  }
+}
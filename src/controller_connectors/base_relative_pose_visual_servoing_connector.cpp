@@ -1,24 +1,44 @@
 #include "aerial_autonomy/controller_connectors/base_relative_pose_visual_servoing_connector.h"
 
-tf::Transform BaseRelativePoseVisualServoingConnector::
+Pose BaseRelativePoseVisualServoingConnector::
     getTrackingTransformRotationCompensatedQuadFrame(
-        tf::Transform object_pose_cam) {
+        const tf::Transform &object_pose_cam) {
+  parsernode::common::quaddata quad_data;
+  drone_hardware_.getquaddata(quad_data);
+  // Composed locally so that the frame graph is only used by the controller
+  // thread
+  Pose body_frame_rotation = Pose::fromRPY(
+      quad_data.rpydata.x, quad_data.rpydata.y, quad_data.rpydata.z);
+  return compensateTrackingTransform(body_frame_rotation * camera_transform_,
+                                     conversions::toPose(object_pose_cam));
+}
+
+Pose BaseRelativePoseVisualServoingConnector::getCompensatedTrackingTransform(
+    const Pose &object_pose_cam) {
+  return compensateTrackingTransform(
+      frame_graph_.getTransform(FrameGraph::root, camera_frame_),
+      object_pose_cam);
+}
+
+Pose BaseRelativePoseVisualServoingConnector::compensateTrackingTransform(
+    const Pose &camera_pose, const Pose &object_pose_cam) const {
   // Convert tracked frame from camera frame to UAV-centered global frame
-  tf::Transform tracking_transform = getBodyFrameRotation() *
-                                     camera_transform_ * object_pose_cam *
-                                     tracking_offset_transform_;
+  Pose tracking_transform =
+      camera_pose * object_pose_cam * tracking_offset_transform_;
   // Remove roll and pitch components of tracked frame
-  double roll, pitch, yaw;
-  tracking_transform.getBasis().getRPY(roll, pitch, yaw);
-  tracking_transform.getBasis().setRPY(0, 0, yaw);
+  tracking_transform.R =
+      Eigen::AngleAxisd(tracking_transform.yaw(), Eigen::Vector3d::UnitZ())
+          .toRotationMatrix();
   return tracking_transform;
 }
 
-tf::Transform BaseRelativePoseVisualServoingConnector::getBodyFrameRotation() {
-  parsernode::common::quaddata quad_data;
-  drone_hardware_.getquaddata(quad_data);
-  return tf::Transform(tf::createQuaternionFromRPY(quad_data.rpydata.x,
-                                                   quad_data.rpydata.y,
-                                                   quad_data.rpydata.z),
-                       tf::Vector3(0, 0, 0));
+void BaseRelativePoseVisualServoingConnector::updateBodyFrameRotation(
+    const parsernode::common::quaddata &quad_data) {
+  frame_graph_.setDynamicPose(
+      body_frame_, Pose::fromRPY(quad_data.rpydata.x, quad_data.rpydata.y,
+                                 quad_data.rpydata.z));
+}
+
+const Pose &BaseRelativePoseVisualServoingConnector::getBodyFrameRotation() {
+  return frame_graph_.getTransform(FrameGraph::root, body_frame_);
 }
@@ -29,8 +29,7 @@ bool JoystickVelocityControllerDroneConnector::extractSensorData(
                            quad_data.linvel.z, quad_data.omega.z);
 
   sensor_data = std::make_tuple(joy_data, vel_data, quad_data.rpydata.z);
-  thrust_gain_estimator_.addSensorData(quad_data.rpydata.x, quad_data.rpydata.y,
-                                       quad_data.linacc.z);
+  thrust_gain_estimator_.addSensorData(quad_data);
   auto rpyt_controller_config = private_reference_controller_.getRPYTConfig();
   rpyt_controller_config.set_kt(thrust_gain_estimator_.getThrustGain());
   private_reference_controller_.updateRPYTConfig(rpyt_controller_config);
@@ -2,7 +2,7 @@
 #include "aerial_autonomy/log/log.h"
 
 bool RelativePoseVisualServoingControllerDroneConnector::extractSensorData(
-    std::tuple<tf::Transform, tf::Transform> &sensor_data) {
+    std::tuple<Pose, Pose> &sensor_data) {
   parsernode::common::quaddata quad_data;
   drone_hardware_.getquaddata(quad_data);
   tf::Transform object_pose_cam;
@@ -10,8 +10,9 @@ bool RelativePoseVisualServoingControllerDroneConnector::extractSensorData(
     VLOG(1) << "Invalid tracking vector";
     return false;
   }
-  tf::Transform tracking_pose =
-      getTrackingTransformRotationCompensatedQuadFrame(object_pose_cam);
+  updateBodyFrameRotation(quad_data);
+  Pose tracking_pose =
+      getCompensatedTrackingTransform(conversions::toPose(object_pose_cam));
   DATA_LOG("relative_pose_visual_servoing_controller_drone_connector")
       << quad_data.linvel.x << quad_data.linvel.y << quad_data.linvel.z
       << quad_data.rpydata.x << quad_data.rpydata.y << quad_data.rpydata.z
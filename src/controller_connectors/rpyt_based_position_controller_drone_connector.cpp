@@ -9,8 +9,7 @@ bool RPYTBasedPositionControllerDroneConnector::extractSensorData(
   VelocityYawRate velocity_yawrate(data.linvel.x, data.linvel.y, data.linvel.z,
                                    data.omega.z);
   sensor_data = std::make_tuple(velocity_yawrate, position_yaw);
-  thrust_gain_estimator_.addSensorData(data.rpydata.x, data.rpydata.y,
-                                       data.linacc.z);
+  thrust_gain_estimator_.addSensorData(data);
   auto rpyt_controller_config = private_reference_controller_.getRPYTConfig();
   rpyt_controller_config.set_kt(thrust_gain_estimator_.getThrustGain());
   private_reference_controller_.updateRPYTConfig(rpyt_controller_config);
@@ -1,35 +1,93 @@
 #include "aerial_autonomy/controller_connectors/visual_servoing_controller_arm_connector.h"
-#include "aerial_autonomy/common/conversions.h"
-#include <tf_conversions/tf_eigen.h>
+#include "aerial_autonomy/common/eigen_views.h"
+
+#include <algorithm>
+
+VisualServoingControllerArmConnector::VisualServoingControllerArmConnector(
+    BaseTracker &tracker, parsernode::Parser &drone_hardware,
+    ArmParser &arm_hardware, RelativePoseController &controller,
+    tf::Transform camera_transform, tf::Transform arm_transform,
+    ArmInverseKinematicsConfig ik_config)
+    : ControllerConnector(controller, ControllerGroup::Arm),
+      drone_hardware_(drone_hardware), arm_hardware_(arm_hardware),
+      tracker_(tracker),
+      camera_pose_arm_frame_(
+          conversions::toPose(arm_transform.inverseTimes(camera_transform))),
+      clamp_unreachable_goals_(ik_config.clamp_unreachable_goals()),
+      ik_seeded_(false) {
+  if (ik_config.kinematics_config().joint_config_size() > 0) {
+    ik_solver_.reset(new DampedLeastSquaresIK(ik_config));
+    reachability_map_.reset(new ReachabilityMap(
+        ik_solver_->getKinematics(), ik_config.voxel_size(),
+        ik_config.reachability_samples(), ik_config.seed()));
+    joint_angles_.resize(ik_solver_->getKinematics().size());
+  }
+}
 
 bool VisualServoingControllerArmConnector::extractSensorData(
-    std::tuple<tf::Transform, tf::Transform> &sensor_data) {
-  tf::Transform tracking_pose;
+    std::tuple<Pose, Pose> &sensor_data) {
+  Pose tracking_pose;
   if (!getTrackingPoseArmFrame(tracking_pose)) {
     VLOG(1) << "Cannot find tracking pose";
     return false;
   }
 
-  tf::Transform arm_pose_tf;
-  conversions::transformMatrix4dToTf(arm_hardware_.getEndEffectorTransform(),
-                                     arm_pose_tf);
+  const Eigen::Matrix4d arm_pose = arm_hardware_.getEndEffectorTransform();
 
-  sensor_data = std::make_tuple(arm_pose_tf, tracking_pose);
+  sensor_data = std::make_tuple(Pose(arm_pose.topLeftCorner<3, 3>(),
+                                     arm_pose.topRightCorner<3, 1>()),
+                                tracking_pose);
 
   return true;
 }
 
-void VisualServoingControllerArmConnector::sendControllerCommands(
-    tf::Transform pose) {
-  Eigen::Affine3d pose_eig;
-  tf::transformTFToEigen(pose, pose_eig);
-  if (!arm_hardware_.setEndEffectorPose(pose_eig.matrix())) {
-    LOG_EVERY_N(WARNING, 50) << "End effector not in workspace";
+void VisualServoingControllerArmConnector::sendControllerCommands(Pose pose) {
+  if (!ik_solver_) {
+    if (!arm_hardware_.setEndEffectorPose(pose.matrix())) {
+      LOG_EVERY_N(WARNING, 50) << "End effector not in workspace";
+    }
+    return;
+  }
+  Eigen::Matrix4d target = pose.matrix();
+  const Eigen::Vector3d position = target.topRightCorner<3, 1>();
+  if (!reachability_map_->isReachable(position)) {
+    if (!clamp_unreachable_goals_) {
+      LOG_EVERY_N(WARNING, 50) << "End effector not in workspace";
+      return;
+    }
+    target.topRightCorner<3, 1>() =
+        reachability_map_->closestReachable(position);
+  }
+  if (!ik_seeded_) {
+    std::vector<double> angles = arm_hardware_.getJointAngles();
+    if (angles.size() == joint_angles_.size()) {
+      ik_solver_->reset(
+          Eigen::Map<const Eigen::VectorXd>(angles.data(), angles.size()));
+    } else {
+      LOG(WARNING) << "Expected " << joint_angles_.size()
+                   << " joint angles from the arm but received "
+                   << angles.size();
+    }
+    ik_seeded_ = true;
+  }
+  if (!ik_solver_->solve(target)) {
+    VLOG_EVERY_N(1, 50) << "Inverse kinematics not converged";
+  }
+  const Eigen::VectorXd &solution = ik_solver_->getSolution();
+  std::copy(solution.data(), solution.data() + solution.size(),
+            joint_angles_.begin());
+  if (!arm_hardware_.setJointAngles(joint_angles_)) {
+    LOG_EVERY_N(WARNING, 50) << "Joint angles not accepted by arm";
   }
 }
 
+void VisualServoingControllerArmConnector::setGoal(Pose goal) {
+  BaseClass::setGoal(goal);
+  ik_seeded_ = false;
+}
+
 bool VisualServoingControllerArmConnector::getTrackingPoseArmFrame(
-    tf::Transform &tracking_pose) {
+    Pose &tracking_pose) {
   tf::Transform object_pose_cam;
   if (!tracker_.getTrackingVector(object_pose_cam)) {
     return false;
@@ -45,11 +103,9 @@ bool VisualServoingControllerArmConnector::getTrackingPoseArmFrame(
   * type) subclassed from a common base.
   *  The subclasses will override this function
   */
-  // Compute object transform in quad frame
-  tf::Transform object_tf_body_frame = camera_transform_ * object_pose_cam;
-
   // Compute object transform in arm frame
-  tracking_pose = arm_transform_.inverse() * object_tf_body_frame;
+  tracking_pose =
+      camera_pose_arm_frame_ * conversions::toPose(object_pose_cam);
 
   return true;
 }
@@ -5,8 +5,13 @@ bool VisualServoingControllerDroneConnector::extractSensorData(
     PositionYaw &sensor_data) {
   parsernode::common::quaddata quad_data;
   drone_hardware_.getquaddata(quad_data);
+  frame_graph_.setDynamicPose(
+      body_frame_, Pose::fromRPY(quad_data.rpydata.x, quad_data.rpydata.y,
+                                 quad_data.rpydata.z));
   Position tracking_vector;
-  if (!getTrackingVectorGlobalFrame(tracking_vector)) {
+  if (!getTrackingVectorGlobalFrame(
+          frame_graph_.getTransform(FrameGraph::root, camera_frame_).R,
+          tracking_vector)) {
     VLOG(1) << "Cannot Find tracking vector of ROI";
     return false;
   }
@@ -30,25 +35,22 @@ void VisualServoingControllerDroneConnector::sendControllerCommands(
 
 bool VisualServoingControllerDroneConnector::getTrackingVectorGlobalFrame(
     Position &tracking_vector) {
-  tf::Transform object_pose_cam;
-  bool result = true;
-  result = tracker_.getTrackingVector(object_pose_cam);
-  if (result) {
-    tf::Vector3 object_direction_cam = object_pose_cam.getOrigin();
-    // Convert from camera frame to global frame
-    tf::Vector3 tracking_vector_tf =
-        (getBodyFrameRotation() *
-         (camera_transform_.getBasis() * object_direction_cam));
-    tracking_vector.x = tracking_vector_tf.getX();
-    tracking_vector.y = tracking_vector_tf.getY();
-    tracking_vector.z = tracking_vector_tf.getZ();
-  }
-  return result;
-}
-
-tf::Matrix3x3 VisualServoingControllerDroneConnector::getBodyFrameRotation() {
   parsernode::common::quaddata quad_data;
   drone_hardware_.getquaddata(quad_data);
-  return tf::Matrix3x3(tf::createQuaternionFromRPY(
-      quad_data.rpydata.x, quad_data.rpydata.y, quad_data.rpydata.z));
+  Pose body_rotation = Pose::fromRPY(quad_data.rpydata.x, quad_data.rpydata.y,
+                                     quad_data.rpydata.z);
+  return getTrackingVectorGlobalFrame(body_rotation.R * camera_transform_.R,
+                                      tracking_vector);
+}
+
+bool VisualServoingControllerDroneConnector::getTrackingVectorGlobalFrame(
+    const Eigen::Matrix3d &camera_rotation, Position &tracking_vector) {
+  tf::Transform object_pose_cam;
+  if (!tracker_.getTrackingVector(object_pose_cam)) {
+    return false;
+  }
+  // Convert from camera frame to global frame
+  conversions::xyzView(tracking_vector) =
+      camera_rotation * conversions::eigenView(object_pose_cam.getOrigin());
+  return true;
 }
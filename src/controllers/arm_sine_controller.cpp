@@ -1,15 +1,14 @@
 #include "aerial_autonomy/controllers/arm_sine_controller.h"
 #include "aerial_autonomy/log/log.h"
+#include "aerial_autonomy/log/record_fields.h"
 #include <string>
 
 ArmSineController::ArmSineController(ArmSineControllerConfig config)
     : config_(config) {
-  Log::instance()["arm_sine_controller"] << DataStream::starth;
-  for (int i = 0; i < config_.joint_config_size(); ++i) {
-    std::string header = "Jad_" + std::to_string(i);
-    Log::instance()["arm_sine_controller"] << header;
-  }
-  Log::instance()["arm_sine_controller"] << DataStream::endl;
+  Log::instance()["arm_sine_controller"]
+      << DataStream::starth
+      << record_fields::array("Jad", config_.joint_config_size())
+      << DataStream::endl;
 }
 
 void ArmSineController::setZeroTime() {
@@ -24,7 +23,6 @@ std::chrono::duration<double> ArmSineController::duration() {
 bool ArmSineController::runImplementation(EmptySensor, EmptyGoal,
                                           JointAngles &control) {
   auto joint_config = config_.joint_config();
-  Log::instance()["arm_sine_controller"] << DataStream::startl;
   for (auto it = joint_config.begin(); it < joint_config.end(); ++it) {
     double a = it->amplitude();
     double omega = 2 * M_PI * it->frequency();
@@ -32,8 +30,9 @@ bool ArmSineController::runImplementation(EmptySensor, EmptyGoal,
     double dt = duration().count();
     double angle = a * sin(omega * dt + phi);
     control.push_back(angle);
-    Log::instance()["arm_sine_controller"] << angle;
   }
-  Log::instance()["arm_sine_controller"] << DataStream::endl;
+  Log::instance()["arm_sine_controller"] << DataStream::startl
+                                         << record_fields::fixed(control)
+                                         << DataStream::endl;
   return true;
 }
@@ -5,8 +5,14 @@ bool JoystickVelocityController::runImplementation(
     std::tuple<Joystick, VelocityYawRate, double> sensor_data, EmptyGoal goal,
     RollPitchYawRateThrust &control) {
 
-  VelocityYawRate vel_goal =
-      convertJoystickToVelocityYawRate(std::get<0>(sensor_data));
+  VelocityYawRate vel_goal;
+  const Joystick &joystick = std::get<0>(sensor_data);
+  cascade_.step(timebase::Clock::now(),
+                [&](VelocityYawRate &joystick_goal) {
+                  joystick_goal = convertJoystickToVelocityYawRate(joystick);
+                  return true;
+                },
+                vel_goal);
 
   auto vel_sensor_data =
       std::make_tuple(std::get<1>(sensor_data), std::get<2>(sensor_data));
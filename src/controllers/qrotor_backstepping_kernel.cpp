@@ -0,0 +1,147 @@
+#include "aerial_autonomy/controllers/qrotor_backstepping_kernel.h"
+#include "aerial_autonomy/common/eigen_views.h"
+#include "aerial_autonomy/common/math.h"
+
+#include <glog/logging.h>
+
+QrotorBacksteppingKernel::QrotorBacksteppingKernel(
+    const QrotorBacksteppingControllerConfig &config)
+    : QrotorBacksteppingKernel(config, lyapunovWeights(config)) {}
+
+QrotorBacksteppingKernel::QrotorBacksteppingKernel(
+    const QrotorBacksteppingControllerConfig &config, const Matrix6d &P)
+    : m_(config.mass()), acc_gravity_(config.acc_gravity()),
+      kp_(config.kp_xy(), config.kp_xy(), config.kp_z()),
+      kd_(config.kd_xy(), config.kd_xy(), config.kd_z()),
+      q_p_(config.qx(), config.qy(), config.qz()),
+      q_v_(config.qvx(), config.qvy(), config.qvz()), k1_(config.k1()),
+      k2_(config.k2()), thrust_eps_(config.thrust_eps()) {
+  CHECK_GT(m_, 0) << "Mass should be positive";
+  J_ << config.jxx(), config.jxy(), config.jxz(), config.jyx(), config.jyy(),
+      config.jyz(), config.jzx(), config.jzy(), config.jzz();
+  setLyapunovWeights(P);
+}
+
+QrotorBacksteppingKernel::Matrix6d QrotorBacksteppingKernel::lyapunovWeights(
+    const QrotorBacksteppingControllerConfig &config) {
+  return lyapunovWeights(
+      config.mass(), Eigen::Vector3d(config.kp_xy(), config.kp_xy(),
+                                     config.kp_z()),
+      Eigen::Vector3d(config.kd_xy(), config.kd_xy(), config.kd_z()),
+      Eigen::Vector3d(config.qx(), config.qy(), config.qz()),
+      Eigen::Vector3d(config.qvx(), config.qvy(), config.qvz()));
+}
+
+QrotorBacksteppingKernel::Matrix6d QrotorBacksteppingKernel::lyapunovWeights(
+    double m, const Eigen::Vector3d &kp, const Eigen::Vector3d &kd,
+    const Eigen::Vector3d &q_p, const Eigen::Vector3d &q_v) {
+  Matrix6d P = Matrix6d::Zero();
+  for (int i = 0; i < 3; ++i) {
+    // Closed loop dynamics of position and velocity along axis i
+    Eigen::Matrix2d AmBK;
+    AmBK << 0, 1, -kp(i) / m, -kd(i) / m;
+    Eigen::Matrix2d Q_i = Eigen::Vector2d(q_p(i), q_v(i)).asDiagonal();
+    Eigen::Matrix2d P_i = math::lyapunov<2>(AmBK, Q_i);
+    P(i, i) = P_i(0, 0);
+    P(i, i + 3) = P(i + 3, i) = P_i(0, 1);
+    P(i + 3, i + 3) = P_i(1, 1);
+  }
+  return P;
+}
+
+void QrotorBacksteppingKernel::setLyapunovWeights(const Matrix6d &P) {
+  // B^T P only picks the velocity rows of P scaled by 1/m
+  BtP_p_ = P.bottomLeftCorner<3, 3>() / m_;
+  BtP_v_ = P.bottomRightCorner<3, 3>() / m_;
+}
+
+void QrotorBacksteppingKernel::setMass(double mass) {
+  CHECK_GT(mass, 0) << "Mass should be positive";
+  m_ = mass;
+  setLyapunovWeights(lyapunovWeights(m_, kp_, kd_, q_p_, q_v_));
+}
+
+double QrotorBacksteppingKernel::getMass() const { return m_; }
+
+void QrotorBacksteppingKernel::setGains(const Eigen::Vector3d &kp,
+                                        const Eigen::Vector3d &kd) {
+  kp_ = kp;
+  kd_ = kd;
+  setLyapunovWeights(lyapunovWeights(m_, kp_, kd_, q_p_, q_v_));
+}
+
+void QrotorBacksteppingKernel::run(const QrotorBacksteppingState &state,
+                                   const ParticleState &desired_state,
+                                   const Snap &desired_snap,
+                                   QrotorBacksteppingControl &control) const {
+  const Eigen::Matrix3d &R = state.R;
+  const Eigen::Vector3d &w = state.w;
+  const double thrust = state.thrust;
+  const double thrust_dot = state.thrust_dot;
+
+  const Eigen::Vector3d &a_d = desired_state.a;
+  const Eigen::Vector3d &j_d = desired_state.j;
+  auto snap_d = conversions::xyzView(desired_snap);
+
+  // Gravity f and thrust g forces
+  const Eigen::Vector3d f(0, 0, -m_ * acc_gravity_);
+  const Eigen::Vector3d g = R.col(2) * thrust;
+  // g_dot = R * (hat(w) * e3 * thrust + e3 * thrust_dot)
+  const Eigen::Vector3d g_dot =
+      R * Eigen::Vector3d(thrust * w.y(), -thrust * w.x(), thrust_dot);
+
+  // Tracking errors of x = [p; v] and its first two derivatives
+  const Eigen::Vector3d e_p = state.p - desired_state.p;
+  const Eigen::Vector3d e_v = state.v - desired_state.v;
+  const Eigen::Vector3d e_a = (f + g) / m_ - a_d;
+  const Eigen::Vector3d e_j = g_dot / m_ - j_d;
+
+  const Eigen::Vector3d g_d =
+      m_ * a_d - kp_.cwiseProduct(e_p) - kd_.cwiseProduct(e_v) - f;
+  const Eigen::Vector3d g_d_dot =
+      m_ * j_d - kp_.cwiseProduct(e_v) - kd_.cwiseProduct(e_a);
+  const Eigen::Vector3d g_d_ddot =
+      m_ * snap_d - kp_.cwiseProduct(e_a) - kd_.cwiseProduct(e_j);
+
+  const Eigen::Vector3d z1 = g - g_d;
+  const Eigen::Vector3d z1_dot = g_dot - g_d_dot;
+
+  const Eigen::Vector3d a_d_cmd =
+      g_d_dot - BtP_p_ * e_p - BtP_v_ * e_v - k1_ * z1;
+  const Eigen::Vector3d a_d_cmd_dot =
+      g_d_ddot - BtP_p_ * e_v - BtP_v_ * e_a - k1_ * z1_dot;
+  const Eigen::Vector3d z2 = g_dot - a_d_cmd;
+  const Eigen::Vector3d b_d = a_d_cmd_dot - z1 - k2_ * z2;
+
+  // snap_cmd = R^T b_d - thrust * hat(w)^2 e3 - 2 thrust_dot hat(w) e3
+  const Eigen::Vector3d snap_cmd =
+      R.transpose() * b_d +
+      Eigen::Vector3d(-thrust * w.x() * w.z() - 2.0 * thrust_dot * w.y(),
+                      -thrust * w.y() * w.z() + 2.0 * thrust_dot * w.x(),
+                      thrust * (w.x() * w.x() + w.y() * w.y()));
+
+  if (std::abs(thrust) > thrust_eps_) {
+    // e3 x snap_cmd = (-snap_y, snap_x, 0)
+    control.torque =
+        J_ * (Eigen::Vector3d(-snap_cmd.y(), snap_cmd.x(), 0) / thrust) -
+        (J_ * w).cross(w);
+  } else {
+    control.torque.setZero();
+  }
+  control.thrust_ddot = snap_cmd.z();
+}
+
+void QrotorBacksteppingKernel::run(
+    const std::vector<QrotorBacksteppingState> &states,
+    const std::vector<ParticleState> &desired_states,
+    const std::vector<Snap> &desired_snaps,
+    std::vector<QrotorBacksteppingControl> &controls) const {
+  CHECK_EQ(states.size(), desired_states.size())
+      << "Number of states and desired states should be the same";
+  CHECK_EQ(states.size(), desired_snaps.size())
+      << "Number of states and desired snaps should be the same";
+  controls.resize(states.size());
+  for (std::size_t i = 0; i < states.size(); ++i) {
+    run(states[i], desired_states[i], desired_snaps[i], controls[i]);
+  }
+}
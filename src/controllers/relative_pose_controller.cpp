@@ -3,33 +3,28 @@
 #include <glog/logging.h>
 
 bool RelativePoseController::runImplementation(
-    std::tuple<tf::Transform, tf::Transform> sensor_data, tf::Transform goal,
-    tf::Transform &control) {
+    std::tuple<Pose, Pose> sensor_data, Pose goal, Pose &control) {
   control = std::get<1>(sensor_data) * goal;
   return true;
 }
 
 ControllerStatus RelativePoseController::isConvergedImplementation(
-    std::tuple<tf::Transform, tf::Transform> sensor_data, tf::Transform goal) {
-  tf::Transform current_pose = std::get<0>(sensor_data);
-  tf::Transform tracked_pose = std::get<1>(sensor_data);
+    std::tuple<Pose, Pose> sensor_data, Pose goal) {
+  const Pose &current_pose = std::get<0>(sensor_data);
+  const Pose &tracked_pose = std::get<1>(sensor_data);
 
-  tf::Transform relative_pose = tracked_pose.inverse() * current_pose;
-  tf::Vector3 relative_position = relative_pose.getOrigin();
-  tf::Vector3 goal_position = goal.getOrigin();
-  tf::Quaternion relative_quat = relative_pose.getRotation();
-  tf::Quaternion goal_quat = goal.getRotation();
-  double rot_diff = goal_quat.angleShortestPath(relative_quat);
+  Pose relative_pose = tracked_pose.inverseTimes(current_pose);
+  double rot_diff = goal.angleTo(relative_pose);
 
-  tf::Vector3 error_position = relative_position - goal_position;
-  tf::Vector3 abs_error_position = error_position.absolute();
+  Eigen::Vector3d error_position = relative_pose.p - goal.p;
+  Eigen::Vector3d abs_error_position = error_position.cwiseAbs();
   ControllerStatus status(ControllerStatus::Active);
   status << "Error Position, Rotation: " << error_position.x()
          << error_position.y() << error_position.z() << rot_diff;
-  const tf::Quaternion &current_rot = current_pose.getRotation();
-  const tf::Vector3 &current_trans = current_pose.getOrigin();
-  const tf::Quaternion &tracked_rot = tracked_pose.getRotation();
-  const tf::Vector3 &tracked_trans = tracked_pose.getOrigin();
+  const Eigen::Quaterniond current_rot(current_pose.R);
+  const Eigen::Vector3d &current_trans = current_pose.p;
+  const Eigen::Quaterniond tracked_rot(tracked_pose.R);
+  const Eigen::Vector3d &tracked_trans = tracked_pose.p;
   DATA_LOG("relative_pose_controller")
       << error_position.x() << error_position.y() << error_position.z()
       << rot_diff << current_trans.x() << current_trans.y() << current_trans.z()
@@ -6,8 +6,13 @@ bool RPYTBasedPositionController::runImplementation(
   auto position = std::get<1>(sensor_data);
 
   VelocityYawRate velocity_command;
-  position_controller_.setGoal(goal, true);
-  bool control_success = position_controller_.run(position, velocity_command);
+  bool control_success = cascade_.step(
+      timebase::Clock::now(),
+      [&](VelocityYawRate &outer_command) {
+        position_controller_.setGoal(goal, true);
+        return position_controller_.run(position, outer_command);
+      },
+      velocity_command);
   if (control_success) {
     rpyt_velocity_controller_.setGoal(velocity_command);
     control_success &= rpyt_velocity_controller_.run(
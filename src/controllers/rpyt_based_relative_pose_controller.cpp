@@ -3,20 +3,33 @@
 
 #include <glog/logging.h>
 
+namespace {
+/**
+* @brief Velocity and yaw rate of a twist as used by the velocity controller
+*/
+VelocityYawRate toVelocityYawRate(const Twist &twist) {
+  return VelocityYawRate(twist.v.x(), twist.v.y(), twist.v.z(), twist.w.z());
+}
+}
+
 bool RPYTBasedRelativePoseController::runImplementation(
-    std::tuple<tf::Transform, tf::Transform, VelocityYawRate> sensor_data,
-    PositionYaw goal, RollPitchYawRateThrust &control) {
+    std::tuple<Pose, Pose, Twist> sensor_data, PositionYaw goal,
+    RollPitchYawRateThrust &control) {
   bool result = true;
   VelocityYawRate desired_velocity_yawrate;
-  tf::Transform current_transform = std::get<0>(sensor_data);
-  auto transform_tuple =
-      std::make_tuple(current_transform, std::get<1>(sensor_data));
-  velocity_based_relative_pose_controller_.setGoal(goal);
-  result &= velocity_based_relative_pose_controller_.run(
-      transform_tuple, desired_velocity_yawrate);
-  double current_yaw = tf::getYaw(current_transform.getRotation());
-  auto velocity_yawrate_yaw_tuple =
-      std::make_tuple(std::get<2>(sensor_data), current_yaw);
+  const Pose &current_pose = std::get<0>(sensor_data);
+  auto pose_tuple = std::make_tuple(current_pose, std::get<1>(sensor_data));
+  result &= cascade_.step(
+      timebase::Clock::now(),
+      [&](VelocityYawRate &outer_velocity_yawrate) {
+        velocity_based_relative_pose_controller_.setGoal(goal);
+        return velocity_based_relative_pose_controller_.run(
+            pose_tuple, outer_velocity_yawrate);
+      },
+      desired_velocity_yawrate);
+  double current_yaw = current_pose.yaw();
+  auto velocity_yawrate_yaw_tuple = std::make_tuple(
+      toVelocityYawRate(std::get<2>(sensor_data)), current_yaw);
   rpyt_based_velocity_controller_.setGoal(desired_velocity_yawrate);
   result &=
       rpyt_based_velocity_controller_.run(velocity_yawrate_yaw_tuple, control);
@@ -24,17 +37,15 @@ bool RPYTBasedRelativePoseController::runImplementation(
 }
 
 ControllerStatus RPYTBasedRelativePoseController::isConvergedImplementation(
-    std::tuple<tf::Transform, tf::Transform, VelocityYawRate> sensor_data,
-    PositionYaw goal) {
-  tf::Transform current_transform = std::get<0>(sensor_data);
-  auto transform_tuple =
-      std::make_tuple(current_transform, std::get<1>(sensor_data));
-  double current_yaw = tf::getYaw(current_transform.getRotation());
-  auto velocity_yawrate_yaw_tuple =
-      std::make_tuple(std::get<2>(sensor_data), current_yaw);
+    std::tuple<Pose, Pose, Twist> sensor_data, PositionYaw goal) {
+  const Pose &current_pose = std::get<0>(sensor_data);
+  auto pose_tuple = std::make_tuple(current_pose, std::get<1>(sensor_data));
+  double current_yaw = current_pose.yaw();
+  auto velocity_yawrate_yaw_tuple = std::make_tuple(
+      toVelocityYawRate(std::get<2>(sensor_data)), current_yaw);
   ControllerStatus overall_status(ControllerStatus::Completed);
   overall_status +=
-      velocity_based_relative_pose_controller_.isConverged(transform_tuple);
+      velocity_based_relative_pose_controller_.isConverged(pose_tuple);
   overall_status +=
       rpyt_based_velocity_controller_.isConverged(velocity_yawrate_yaw_tuple);
   return overall_status;
@@ -0,0 +1,127 @@
+#include <aerial_autonomy/common/math.h>
+#include <aerial_autonomy/estimators/system_identification_estimator.h>
+#include <aerial_autonomy/log/log.h>
+#include <glog/logging.h>
+
+SystemIdentificationEstimator::SystemIdentificationEstimator(
+    SystemIdentificationEstimatorConfig config)
+    : ThrustGainEstimator(config.thrust_gain_estimator_config()),
+      config_(config),
+      vertical_estimator_(
+          Eigen::Vector2d(config.thrust_gain_estimator_config().kt(),
+                          config.drag_z()),
+          Eigen::Vector2d(config.initial_thrust_gain_variance(),
+                          config.initial_drag_variance()),
+          config.forgetting_factor(), config.min_covariance(),
+          config.max_covariance()),
+      horizontal_estimator_(
+          Eigen::Matrix<double, 1, 1>::Constant(config.drag_xy()),
+          Eigen::Matrix<double, 1, 1>::Constant(
+              config.initial_drag_variance()),
+          config.forgetting_factor(), config.min_covariance(),
+          config.max_covariance()),
+      nominal_thrust_gain_(config.thrust_gain_estimator_config().kt()) {
+  CHECK_GT(config_.nominal_mass(), 0) << "Nominal mass should be positive";
+  CHECK_GE(config_.drag_max(), 0) << "Maximum drag should be non negative";
+  DATA_HEADER("system_identification_estimator") << "body_acc_x"
+                                                 << "body_acc_y"
+                                                 << "body_acc_z"
+                                                 << "body_vel_x"
+                                                 << "body_vel_y"
+                                                 << "body_vel_z"
+                                                 << "thrust_command"
+                                                 << "thrust_gain"
+                                                 << "drag_xy"
+                                                 << "drag_z"
+                                                 << "mass" << DataStream::endl;
+}
+
+void SystemIdentificationEstimator::resetThrustGain(double thrust_gain) {
+  ThrustGainEstimator::resetThrustGain(thrust_gain);
+  Eigen::Vector2d theta = vertical_estimator_.getEstimate();
+  theta(0) = thrust_gain;
+  vertical_estimator_.reset(
+      theta, Eigen::Vector2d(config_.initial_thrust_gain_variance(),
+                             config_.initial_drag_variance()));
+}
+
+void SystemIdentificationEstimator::addSensorData(double roll, double pitch,
+                                                  double body_z_acc) {
+  Eigen::Matrix3d rotation(Eigen::AngleAxisd(pitch, Eigen::Vector3d::UnitY()) *
+                           Eigen::AngleAxisd(roll, Eigen::Vector3d::UnitX()));
+  // Without velocity only the thrust gain is observable
+  update(rotation, Eigen::Vector3d(0, 0, body_z_acc), Eigen::Vector3d::Zero());
+}
+
+void SystemIdentificationEstimator::addSensorData(
+    const parsernode::common::quaddata &quad_data) {
+  Eigen::Matrix3d rotation(
+      Eigen::AngleAxisd(quad_data.rpydata.z, Eigen::Vector3d::UnitZ()) *
+      Eigen::AngleAxisd(quad_data.rpydata.y, Eigen::Vector3d::UnitY()) *
+      Eigen::AngleAxisd(quad_data.rpydata.x, Eigen::Vector3d::UnitX()));
+  Eigen::Vector3d global_velocity(quad_data.linvel.x, quad_data.linvel.y,
+                                  quad_data.linvel.z);
+  update(rotation, Eigen::Vector3d(quad_data.linacc.x, quad_data.linacc.y,
+                                   quad_data.linacc.z),
+         rotation.transpose() * global_velocity);
+}
+
+void SystemIdentificationEstimator::update(
+    const Eigen::Matrix3d &rotation, const Eigen::Vector3d &body_acc,
+    const Eigen::Vector3d &body_velocity) {
+  if (thrust_command_queue_.size() != delay_buffer_size_) {
+    VLOG(2) << "Waiting for thrust commands to fill up the buffer";
+    return;
+  }
+  double thrust_command = thrust_command_queue_.front();
+  // Acceleration in body frame due to thrust and drag only
+  Eigen::Vector3d body_force_acc =
+      body_acc + gravity_magnitude_ * rotation.row(2).transpose();
+
+  // The thrust gain is not observable without thrust
+  if (thrust_command > thrust_command_tolerance_) {
+    vertical_estimator_.update(
+        Eigen::Vector2d(thrust_command, -body_velocity.z()),
+        body_force_acc.z());
+    Eigen::Vector2d theta = vertical_estimator_.getEstimate();
+    vertical_estimator_.setEstimate(
+        0, math::clamp(theta(0), min_thrust_gain_, max_thrust_gain_));
+    vertical_estimator_.setEstimate(
+        1, math::clamp(theta(1), 0, config_.drag_max()));
+    thrust_gain_ = vertical_estimator_.getEstimate()(0);
+  }
+
+  // Drag is not observable at low speeds
+  for (int i = 0; i < 2; ++i) {
+    if (std::abs(body_velocity(i)) > config_.min_drag_velocity()) {
+      horizontal_estimator_.update(
+          Eigen::Matrix<double, 1, 1>::Constant(-body_velocity(i)),
+          body_force_acc(i));
+      horizontal_estimator_.setEstimate(
+          0, math::clamp(horizontal_estimator_.getEstimate()(0), 0,
+                         config_.drag_max()));
+    }
+  }
+
+  DATA_LOG("system_identification_estimator")
+      << body_acc.x() << body_acc.y() << body_acc.z() << body_velocity.x()
+      << body_velocity.y() << body_velocity.z() << thrust_command
+      << thrust_gain_ << getDragXY() << getDragZ() << getMass()
+      << DataStream::endl;
+}
+
+double SystemIdentificationEstimator::getMass() const {
+  return config_.nominal_mass() * nominal_thrust_gain_ / thrust_gain_;
+}
+
+double SystemIdentificationEstimator::getPayloadMass() const {
+  return getMass() - config_.nominal_mass();
+}
+
+double SystemIdentificationEstimator::getDragXY() const {
+  return horizontal_estimator_.getEstimate()(0);
+}
+
+double SystemIdentificationEstimator::getDragZ() const {
+  return vertical_estimator_.getEstimate()(1);
+}
@@ -4,6 +4,8 @@
 #include <glog/logging.h>
 #include <math.h>
 
+constexpr unsigned int ThrustGainEstimator::max_buffer_size;
+
 ThrustGainEstimator::ThrustGainEstimator(double thrust_gain_initial,
                                          double mixing_gain,
                                          unsigned int buffer_size,
@@ -14,6 +16,8 @@ ThrustGainEstimator::ThrustGainEstimator(double thrust_gain_initial,
       thrust_command_tolerance_(1e-2), max_thrust_gain_(max_thrust_gain),
       min_thrust_gain_(min_thrust_gain) {
   CHECK_GE(delay_buffer_size_, 1) << "Buffer size should be atleast 1";
+  CHECK_LE(delay_buffer_size_, max_buffer_size)
+      << "Buffer size should be atmost " << max_buffer_size;
   CHECK_GT(mixing_gain_, 0) << "Mixing gain should be between 0 and 1";
   CHECK_LT(mixing_gain_, 1) << "Mixing gain should be between 0 and 1";
   CHECK_GE(thrust_gain_initial, min_thrust_gain_)
@@ -67,6 +71,11 @@ void ThrustGainEstimator::addSensorData(double roll, double pitch,
   }
 }
 
+void ThrustGainEstimator::addSensorData(
+    const parsernode::common::quaddata &quad_data) {
+  addSensorData(quad_data.rpydata.x, quad_data.rpydata.y, quad_data.linacc.z);
+}
+
 void ThrustGainEstimator::addThrustCommand(double thrust_command) {
   if (thrust_command_queue_.size() == delay_buffer_size_) {
     thrust_command_queue_.pop();
@@ -76,7 +85,4 @@ void ThrustGainEstimator::addThrustCommand(double thrust_command) {
 
 double ThrustGainEstimator::getThrustGain() { return thrust_gain_; }
 
-void ThrustGainEstimator::clearBuffer() {
-  std::queue<double> empty;
-  thrust_command_queue_.swap(empty);
-}
+void ThrustGainEstimator::clearBuffer() { thrust_command_queue_.clear(); }
@@ -19,6 +19,7 @@ TrackingVectorEstimator::TrackingVectorEstimator(
   checkStdVector(config_.marker_meas_stdev());
   checkStdVector(config_.marker_initial_stdev());
   checkStdVector(config_.marker_dilation_stdev());
+  checkStdVector(config_.velocity_stdev());
   // Noise matrices
   setCovarianceMatrix(filter_.processNoiseCov, config_.marker_process_stdev());
   setCovarianceMatrix(filter_.measurementNoiseCov, config_.marker_meas_stdev());
@@ -29,6 +30,9 @@ TrackingVectorEstimator::TrackingVectorEstimator(
   marker_meas_stdev_ = tf::Vector3(config_.marker_meas_stdev().x(),
                                    config_.marker_meas_stdev().y(),
                                    config_.marker_meas_stdev().z());
+  velocity_stdev_ = tf::Vector3(config_.velocity_stdev().x(),
+                                config_.velocity_stdev().y(),
+                                config_.velocity_stdev().z());
   // Set initial state
   initializeState(tf::Vector3(0, 0, 0));
   DATA_HEADER("tracking_vector_estimator") << "Measured_Marker_x"
@@ -42,7 +46,8 @@ TrackingVectorEstimator::TrackingVectorEstimator(
                                            << "Meas_noise_z"
                                            << "Noise_x"
                                            << "Noise_y"
-                                           << "Noise_z" << DataStream::endl;
+                                           << "Noise_z"
+                                           << "Source_time" << DataStream::endl;
 }
 
 void TrackingVectorEstimator::initializeState(tf::Vector3 marker_direction) {
@@ -62,11 +67,16 @@ void TrackingVectorEstimator::predict(tf::Vector3 velocity) {
 }
 
 void TrackingVectorEstimator::setMeasurementCovariance(
-    cv::Mat &covariance_mat,
-    std::chrono::time_point<std::chrono::high_resolution_clock>
-        marker_time_stamp) {
-  double dt = std::chrono::duration<double>(
-                  std::chrono::high_resolution_clock::now() - marker_time_stamp)
+    cv::Mat &covariance_mat, timebase::TimePoint marker_time_stamp) {
+  setMeasurementCovariance(covariance_mat, marker_time_stamp,
+                           marker_dilation_stdev_);
+}
+
+void TrackingVectorEstimator::setMeasurementCovariance(
+    cv::Mat &covariance_mat, timebase::TimePoint marker_time_stamp,
+    const tf::Vector3 &dilation_stdev) {
+  double dt = std::chrono::duration<double>(timebase::Clock::now() -
+                                            marker_time_stamp)
                   .count();
   if (dt < 0) {
     LOG(WARNING) << "dt negative: " << dt;
@@ -75,15 +85,19 @@ void TrackingVectorEstimator::setMeasurementCovariance(
     LOG(WARNING) << "dt too high: " << dt;
     dt = 1.0;
   }
-  tf::Vector3 current_meas_stdev =
-      marker_meas_stdev_ + dt * marker_dilation_stdev_;
+  tf::Vector3 current_meas_stdev = marker_meas_stdev_ + dt * dilation_stdev;
   setCovarianceMatrix(covariance_mat, current_meas_stdev);
 }
 
-void TrackingVectorEstimator::correct(
-    tf::Vector3 marker_direction,
-    std::chrono::time_point<std::chrono::high_resolution_clock>
-        marker_time_stamp) {
+void TrackingVectorEstimator::correct(tf::Vector3 marker_direction,
+                                      timebase::TimePoint marker_time_stamp) {
+  correctMeasurement(marker_direction, marker_time_stamp,
+                     marker_dilation_stdev_);
+}
+
+void TrackingVectorEstimator::correctMeasurement(
+    tf::Vector3 marker_direction, timebase::TimePoint marker_time_stamp,
+    const tf::Vector3 &dilation_stdev) {
   if (!initial_state_initialized_) {
     initializeState(marker_direction);
     return;
@@ -91,7 +105,8 @@ void TrackingVectorEstimator::correct(
   cv::Mat_<double> measurement =
       (cv::Mat_<double>(3, 1) << marker_direction.x(), marker_direction.y(),
        marker_direction.z());
-  setMeasurementCovariance(filter_.measurementNoiseCov, marker_time_stamp);
+  setMeasurementCovariance(filter_.measurementNoiseCov, marker_time_stamp,
+                           dilation_stdev);
   filter_.correct(measurement);
   // Log data
   tf::Vector3 marker_noise = getMarkerNoise();
@@ -110,5 +125,24 @@ void TrackingVectorEstimator::correct(
   for (int i = 0; i < 3; ++i) {
     data_stream << marker_noise[i];
   }
-  data_stream << DataStream::endl;
+  data_stream << marker_time_stamp << DataStream::endl;
+}
+
+void TrackingVectorEstimator::correct(tf::Vector3 marker_direction,
+                                      timebase::TimePoint marker_time_stamp,
+                                      Sensor<Velocity> &velocity_sensor) {
+  double dt = std::chrono::duration<double>(timebase::Clock::now() -
+                                            marker_time_stamp)
+                  .count();
+  Velocity velocity;
+  if (dt > 0 && velocity_sensor.getSensorData(marker_time_stamp, velocity)) {
+    marker_direction -= tf::Vector3(velocity.x, velocity.y, velocity.z) * dt;
+    // The delay is compensated, so only the velocity error grows with it
+    correctMeasurement(marker_direction, marker_time_stamp, velocity_stdev_);
+    return;
+  }
+  if (dt > 0) {
+    LOG_EVERY_N(WARNING, 20) << "No velocity at the marker time stamp";
+  }
+  correct(marker_direction, marker_time_stamp);
 }
@@ -0,0 +1,77 @@
+#include "aerial_autonomy/kinematics/arm_kinematics.h"
+
+#include <glog/logging.h>
+
+namespace {
+/**
+ * @brief Translation of a position config
+ */
+Eigen::Vector3d toVector(const config::Position &position) {
+  return Eigen::Vector3d(position.x(), position.y(), position.z());
+}
+}
+
+ArmKinematics::ArmKinematics(ArmKinematicsConfig config)
+    : n_(config.joint_config_size()),
+      end_effector_translation_(toVector(config.end_effector_translation())),
+      min_angles_(n_), max_angles_(n_), shoulder_(Eigen::Vector3d::Zero()),
+      reach_(end_effector_translation_.norm()) {
+  for (int i = 0; i < n_; ++i) {
+    const auto &joint_config = config.joint_config(i);
+    CHECK_LE(joint_config.min_angle(), joint_config.max_angle())
+        << "Joint " << i << " limits are inverted";
+    axes_.push_back(
+        Eigen::Vector3d::Unit(static_cast<int>(joint_config.axis())));
+    translations_.push_back(toVector(joint_config.translation()));
+    min_angles_[i] = joint_config.min_angle();
+    max_angles_[i] = joint_config.max_angle();
+    // The first joint does not move the following joints away from it
+    if (i == 0) {
+      shoulder_ = translations_[i];
+    } else {
+      reach_ += translations_[i].norm();
+    }
+  }
+}
+
+Eigen::Matrix4d
+ArmKinematics::forwardKinematics(const Eigen::VectorXd &q) const {
+  Eigen::Affine3d transform = Eigen::Affine3d::Identity();
+  for (int i = 0; i < n_; ++i) {
+    transform.translate(translations_[i]);
+    transform.rotate(Eigen::AngleAxisd(q[i], axes_[i]));
+  }
+  transform.translate(end_effector_translation_);
+  return transform.matrix();
+}
+
+Eigen::Matrix4d ArmKinematics::forwardKinematics(const Eigen::VectorXd &q,
+                                                 Jacobian &jacobian) const {
+  jacobian.resize(6, n_);
+  Eigen::Affine3d transform = Eigen::Affine3d::Identity();
+  for (int i = 0; i < n_; ++i) {
+    transform.translate(translations_[i]);
+    // Keep the joint origin and axis until the end effector is known
+    jacobian.block<3, 1>(0, i) = transform.translation();
+    jacobian.block<3, 1>(3, i) = transform.linear() * axes_[i];
+    transform.rotate(Eigen::AngleAxisd(q[i], axes_[i]));
+  }
+  transform.translate(end_effector_translation_);
+  for (int i = 0; i < n_; ++i) {
+    const Eigen::Vector3d lever =
+        transform.translation() - jacobian.block<3, 1>(0, i);
+    jacobian.block<3, 1>(0, i) = jacobian.block<3, 1>(3, i).cross(lever);
+  }
+  return transform.matrix();
+}
+
+ArmKinematics::Vector6d
+ArmKinematics::poseError(const Eigen::Matrix4d &pose,
+                         const Eigen::Matrix4d &target) {
+  Vector6d error;
+  error.head<3>() = target.topRightCorner<3, 1>() - pose.topRightCorner<3, 1>();
+  Eigen::AngleAxisd rotation_error(target.topLeftCorner<3, 3>() *
+                                   pose.topLeftCorner<3, 3>().transpose());
+  error.tail<3>() = rotation_error.angle() * rotation_error.axis();
+  return error;
+}
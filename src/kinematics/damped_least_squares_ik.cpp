@@ -0,0 +1,51 @@
+#include "aerial_autonomy/kinematics/damped_least_squares_ik.h"
+
+#include <glog/logging.h>
+
+DampedLeastSquaresIK::DampedLeastSquaresIK(ArmInverseKinematicsConfig config)
+    : config_(config), kinematics_(config_.kinematics_config()),
+      q_(Eigen::VectorXd::Zero(kinematics_.size())),
+      jacobian_(6, kinematics_.size()), q_step_(kinematics_.size()),
+      iterations_(0) {
+  CHECK_GT(kinematics_.size(), 0) << "Arm should have at least one joint";
+  CHECK_GT(config_.max_iterations(), 0u)
+      << "Solver should run at least one iteration";
+  CHECK_GT(config_.max_joint_step(), 0)
+      << "Maximum joint step should be positive";
+  reset(q_);
+}
+
+void DampedLeastSquaresIK::reset(const Eigen::VectorXd &q) {
+  CHECK_EQ(q.size(), kinematics_.size()) << "Expected one angle per joint";
+  q_ = q.cwiseMax(kinematics_.minAngles()).cwiseMin(kinematics_.maxAngles());
+}
+
+bool DampedLeastSquaresIK::solve(const Eigen::Matrix4d &target) {
+  const double damping = config_.damping();
+  for (iterations_ = 0;
+       iterations_ < static_cast<int>(config_.max_iterations());
+       ++iterations_) {
+    ArmKinematics::Vector6d error = ArmKinematics::poseError(
+        kinematics_.forwardKinematics(q_, jacobian_), target);
+    if (error.head<3>().norm() < config_.position_tolerance() &&
+        error.tail<3>().norm() < config_.orientation_tolerance()) {
+      return true;
+    }
+    Eigen::Matrix<double, 6, 6> jjt;
+    jjt.noalias() = jacobian_ * jacobian_.transpose();
+    jjt.diagonal().array() += damping * damping;
+    q_step_.noalias() = jacobian_.transpose() * jjt.ldlt().solve(error);
+    // Limit the step so that linearizing the kinematics stays accurate
+    const double largest_step = q_step_.cwiseAbs().maxCoeff();
+    if (largest_step > config_.max_joint_step()) {
+      q_step_ *= config_.max_joint_step() / largest_step;
+    }
+    q_ = (q_ + q_step_)
+             .cwiseMax(kinematics_.minAngles())
+             .cwiseMin(kinematics_.maxAngles());
+  }
+  ArmKinematics::Vector6d error =
+      ArmKinematics::poseError(kinematics_.forwardKinematics(q_), target);
+  return error.head<3>().norm() < config_.position_tolerance() &&
+         error.tail<3>().norm() < config_.orientation_tolerance();
+}
@@ -0,0 +1,129 @@
+#include "aerial_autonomy/kinematics/reachability_map.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <random>
+
+ReachabilityMap::ReachabilityMap(const ArmKinematics &kinematics,
+                                 double voxel_size, uint32_t samples,
+                                 uint32_t seed)
+    : voxel_size_(voxel_size) {
+  CHECK_GT(voxel_size_, 0) << "Voxel size should be positive";
+  CHECK_GT(samples, 0u) << "Map needs at least one sample";
+  // Leave a voxel of margin around the reach for the dilated voxels
+  const double half_extent = kinematics.reach() + voxel_size_;
+  cells_ = static_cast<int>(std::ceil(2 * half_extent / voxel_size_));
+  min_corner_ = kinematics.shoulder() - Eigen::Vector3d::Constant(half_extent);
+  const uint32_t voxels = cells_ * cells_ * cells_;
+  std::vector<uint8_t> sampled(voxels, 0);
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  const int n = kinematics.size();
+  Eigen::VectorXd q(n);
+  for (uint32_t sample = 0; sample < samples; ++sample) {
+    for (int i = 0; i < n; ++i) {
+      q[i] = kinematics.minAngles()[i] +
+             uniform(generator) *
+                 (kinematics.maxAngles()[i] - kinematics.minAngles()[i]);
+    }
+    sampled[voxelIndex(
+        kinematics.forwardKinematics(q).topRightCorner<3, 1>())] = 1;
+  }
+  // Mark the neighbours of sampled voxels
+  reachable_.assign(voxels, 0);
+  for (int z = 0; z < cells_; ++z) {
+    for (int y = 0; y < cells_; ++y) {
+      for (int x = 0; x < cells_; ++x) {
+        if (!sampled[(z * cells_ + y) * cells_ + x]) {
+          continue;
+        }
+        for (int nz = std::max(z - 1, 0); nz <= std::min(z + 1, cells_ - 1);
+             ++nz) {
+          for (int ny = std::max(y - 1, 0);
+               ny <= std::min(y + 1, cells_ - 1); ++ny) {
+            for (int nx = std::max(x - 1, 0);
+                 nx <= std::min(x + 1, cells_ - 1); ++nx) {
+              reachable_[(nz * cells_ + ny) * cells_ + nx] = 1;
+            }
+          }
+        }
+      }
+    }
+  }
+  // Breadth first search from all reachable voxels at once finds the
+  // reachable voxel fewest steps away from every voxel
+  const uint32_t unvisited = std::numeric_limits<uint32_t>::max();
+  closest_.assign(voxels, unvisited);
+  std::deque<uint32_t> queue;
+  for (uint32_t index = 0; index < voxels; ++index) {
+    if (reachable_[index]) {
+      closest_[index] = index;
+      queue.push_back(index);
+    }
+  }
+  const int offsets[6][3] = {{1, 0, 0},  {-1, 0, 0}, {0, 1, 0},
+                             {0, -1, 0}, {0, 0, 1},  {0, 0, -1}};
+  while (!queue.empty()) {
+    const uint32_t index = queue.front();
+    queue.pop_front();
+    const int x = index % cells_;
+    const int y = (index / cells_) % cells_;
+    const int z = index / (cells_ * cells_);
+    for (const auto &offset : offsets) {
+      const int nx = x + offset[0];
+      const int ny = y + offset[1];
+      const int nz = z + offset[2];
+      if (nx < 0 || ny < 0 || nz < 0 || nx >= cells_ || ny >= cells_ ||
+          nz >= cells_) {
+        continue;
+      }
+      const uint32_t neighbour = (nz * cells_ + ny) * cells_ + nx;
+      if (closest_[neighbour] == unvisited) {
+        closest_[neighbour] = closest_[index];
+        queue.push_back(neighbour);
+      }
+    }
+  }
+}
+
+bool ReachabilityMap::isReachable(const Eigen::Vector3d &position) const {
+  const Eigen::Vector3d grid_position = (position - min_corner_) / voxel_size_;
+  if ((grid_position.array() < 0).any() ||
+      (grid_position.array() >= static_cast<double>(cells_)).any()) {
+    return false;
+  }
+  return reachable_[voxelIndex(position)];
+}
+
+Eigen::Vector3d
+ReachabilityMap::closestReachable(const Eigen::Vector3d &position) const {
+  if (isReachable(position)) {
+    return position;
+  }
+  return voxelCenter(closest_[voxelIndex(position)]);
+}
+
+double ReachabilityMap::reachableFraction() const {
+  return std::count(reachable_.begin(), reachable_.end(), 1) /
+         static_cast<double>(reachable_.size());
+}
+
+uint32_t ReachabilityMap::voxelIndex(const Eigen::Vector3d &position) const {
+  const Eigen::Vector3i cell = ((position - min_corner_) / voxel_size_)
+                                  .array()
+                                  .floor()
+                                  .max(0.0)
+                                  .min(cells_ - 1.0)
+                                  .cast<int>();
+  return (cell.z() * cells_ + cell.y()) * cells_ + cell.x();
+}
+
+Eigen::Vector3d ReachabilityMap::voxelCenter(uint32_t index) const {
+  const Eigen::Vector3d cell(index % cells_, (index / cells_) % cells_,
+                             index / (cells_ * cells_));
+  return min_corner_ + (cell + Eigen::Vector3d::Constant(0.5)) * voxel_size_;
+}
@@ -1,34 +1,237 @@
 #include "aerial_autonomy/log/data_stream.h"
+#include "aerial_autonomy/log/flight_recorder.h"
+#include "aerial_autonomy/log/stream_compression.h"
 
+#include <glog/logging.h>
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
 #include <exception>
+#include <fstream>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
 
-DataStream::DataStream(boost::filesystem::path path, DataStreamConfig config)
-    : config_(config), path_(path), streaming_(false) {
-  fs_.open(path.string(), std::fstream::out);
-  if (!fs_.is_open()) {
-    throw std::runtime_error("Could not open file: " + path.string());
+DataStream::DataStream(boost::filesystem::path path, DataStreamConfig config,
+                       std::shared_ptr<BufferBudget> budget,
+                       uint64_t flight_recorder_bytes)
+    : config_(config), path_(path), fd_(-1), streaming_(false),
+      streaming_header_(false), buffering_(false), buffered_bytes_(0),
+      budget_(budget), dropped_(0), file_bytes_(0), rotation_count_(0),
+      timestamp_(0), recorder_(nullptr), spare_recorder_(nullptr),
+      history_recorder_(nullptr) {
+  data_point_.precision(config_.precision());
+  if (config_.compression() != DataStreamConfig::NONE) {
+    compressor_.reset(new StreamCompressor(config_));
+  }
+  if (flight_recorder_bytes > 0 && config_.flight_recorder() &&
+      config_.log_data()) {
+    for (int i = 0; i < 3; ++i) {
+      recorder_rings_.emplace_back(
+          new FlightRecorderBuffer(flight_recorder_bytes));
+    }
+    recorder_ = recorder_rings_[0].get();
+    spare_recorder_ = recorder_rings_[1].get();
+    history_recorder_ = recorder_rings_[2].get();
+  }
+  // Disabled streams never write, so they do not create or truncate a file
+  if (config_.log_data()) {
+    open();
   }
 }
 
-DataStream::DataStream(DataStream &&o) {
-  config_ = o.config_;
-  last_write_time_ = o.last_write_time_;
-  path_ = o.path_;
-  o.fs_.close();
+DataStream::DataStream(DataStream &&o)
+    : config_(o.config_), path_(o.path_), last_write_time_(o.last_write_time_),
+      fd_(o.fd_), streaming_(false), streaming_header_(false),
+      buffering_(false), buffered_bytes_(0), budget_(o.budget_),
+      dropped_(o.dropped_.load()), file_bytes_(o.file_bytes_),
+      file_open_time_(o.file_open_time_), rotation_count_(o.rotation_count_),
+      compressor_(std::move(o.compressor_)), timestamp_(0),
+      recorder_rings_(std::move(o.recorder_rings_)),
+      recorder_(o.recorder_.load()), spare_recorder_(o.spare_recorder_),
+      history_recorder_(o.history_recorder_) {
+  boost::mutex::scoped_lock lock(o.buffer_mutex_);
+  buffer_.swap(o.buffer_);
+  std::swap(buffered_bytes_, o.buffered_bytes_);
+  header_.swap(o.header_);
+  o.fd_ = -1;
+  o.recorder_ = nullptr;
+  o.spare_recorder_ = nullptr;
+  o.history_recorder_ = nullptr;
+  data_point_.precision(config_.precision());
+}
 
-  fs_.open(path_.string(), std::fstream::out);
-  if (!fs_.is_open()) {
+DataStream::~DataStream() {
+  if (budget_) {
+    budget_->used -= buffered_bytes_;
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+}
+
+void DataStream::open() {
+  fd_ = ::open(path_.string().c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+               0644);
+  if (fd_ < 0) {
     throw std::runtime_error("Could not open file: " + path_.string());
   }
-  streaming_ = false;
+  file_bytes_ = 0;
+  file_open_time_ = std::chrono::steady_clock::now();
+  std::string header;
+  {
+    boost::mutex::scoped_lock lock(buffer_mutex_);
+    header = header_;
+  }
+  if (compressor_) {
+    encoded_.clear();
+    compressor_->start(encoded_);
+    if (!header.empty()) {
+      compressor_->addHeader(header.substr(0, header.size() - 1), encoded_);
+    }
+    iovecs_.assign(1, iovec{&encoded_[0], encoded_.size()});
+    writeIovecs();
+  } else if (!header.empty()) {
+    writeLines(std::deque<BufferedLine>{BufferedLine{header, true}});
+  }
 }
 
 void DataStream::write() {
-  boost::mutex::scoped_lock lock(buffer_mutex_);
+  boost::mutex::scoped_lock file_lock(file_mutex_);
+  uint64_t written_bytes;
+  {
+    // Swap the buffer so that data points can be added during the write
+    boost::mutex::scoped_lock lock(buffer_mutex_);
+    writing_.swap(buffer_);
+    written_bytes = buffered_bytes_;
+    buffered_bytes_ = 0;
+  }
+  if (compressor_) {
+    encoded_.clear();
+    encodeLines(writing_, encoded_);
+    if (!encoded_.empty()) {
+      iovecs_.assign(1, iovec{&encoded_[0], encoded_.size()});
+      writeIovecs();
+    }
+  } else {
+    writeLines(writing_);
+  }
+  writing_.clear();
+  if (budget_) {
+    budget_->used -= written_bytes;
+  }
+}
+
+bool DataStream::dumpFlightRecorder(const boost::filesystem::path &path,
+                                    int64_t since) {
+  if (recorder_rings_.empty()) {
+    return false;
+  }
+  // Hand the spare ring over to the logging thread, which only holds the
+  // recording ring while pushing a data point
+  FlightRecorderBuffer *recorded = recorder_.load(std::memory_order_acquire);
+  while (recorded == nullptr ||
+         !recorder_.compare_exchange_weak(recorded, spare_recorder_,
+                                          std::memory_order_acq_rel)) {
+    if (recorded == nullptr) {
+      std::this_thread::yield();
+      recorded = recorder_.load(std::memory_order_acquire);
+    }
+  }
+  // Add the recorded data points to the history of the previous dumps
+  recorded->forEach([&](int64_t timestamp, const std::string &line) {
+    history_recorder_->push(timestamp, line.data(), line.size());
+  });
+  recorded->clear();
+  spare_recorder_ = recorded;
+  std::string header;
+  {
+    boost::mutex::scoped_lock lock(buffer_mutex_);
+    header = header_;
+  }
+  std::ofstream file(path.string());
+  file.precision(config_.precision());
+  file << header;
+  std::vector<double> values;
+  history_recorder_->forEach([&](int64_t timestamp, const std::string &line) {
+    if (timestamp < since) {
+      return;
+    }
+    if (!compressor_) {
+      file << line;
+      return;
+    }
+    // Compressed data points are recorded as the timestamp followed by the
+    // values
+    values.resize((line.size() - sizeof(timestamp)) / sizeof(double));
+    if (!values.empty()) {
+      std::memcpy(&values[0], line.data() + sizeof(timestamp),
+                  values.size() * sizeof(double));
+    }
+    file << timestamp;
+    for (double value : values) {
+      file << config_.delimiter() << value;
+    }
+    file << '\n';
+  });
+  file.close();
+  if (!file) {
+    LOG(ERROR) << "Failed to write " << path.string();
+    return false;
+  }
+  return true;
+}
+
+void DataStream::sync() {
+  boost::mutex::scoped_lock file_lock(file_mutex_);
+  if (fd_ < 0) {
+    return;
+  }
+  if (fsync(fd_) != 0) {
+    LOG(ERROR) << "Failed to sync " << path_.string() << ": "
+               << std::strerror(errno);
+  }
+}
+
+void DataStream::rotate(bool sync_file) {
+  boost::mutex::scoped_lock file_lock(file_mutex_);
+  if (fd_ < 0) {
+    return;
+  }
+  if (sync_file && fsync(fd_) != 0) {
+    LOG(ERROR) << "Failed to sync " << path_.string() << ": "
+               << std::strerror(errno);
+  }
+  close(fd_);
+  fd_ = -1;
+  boost::filesystem::path rotated_path =
+      path_.string() + "." + std::to_string(++rotation_count_);
+  boost::system::error_code error;
+  boost::filesystem::rename(path_, rotated_path, error);
+  if (error) {
+    LOG(ERROR) << "Failed to rotate " << path_.string() << ": "
+               << error.message();
+  }
+  open();
+}
 
-  fs_ << buffer_.str();
-  fs_.flush();
-  resetStringstream(buffer_);
+uint64_t DataStream::fileBytes() const {
+  boost::mutex::scoped_lock file_lock(file_mutex_);
+  return file_bytes_;
+}
+
+std::chrono::steady_clock::time_point DataStream::fileOpenTime() const {
+  boost::mutex::scoped_lock file_lock(file_mutex_);
+  return file_open_time_;
+}
+
+uint64_t DataStream::droppedDataPoints() const { return dropped_; }
+
+uint64_t DataStream::bufferedBytes() const {
+  boost::mutex::scoped_lock lock(buffer_mutex_);
+  return buffered_bytes_;
 }
 
 const DataStreamConfig &DataStream::configuration() { return config_; }
@@ -39,11 +242,137 @@ DataStream &DataStream::operator<<(DataStream &(*func)(DataStream &)) {
   return func(*this);
 }
 
+DataStream &DataStream::appendValues(const double *values, size_t count) {
+  if (config_.log_data() && streaming_) {
+    if (compressor_ && !streaming_header_) {
+      values_.insert(values_.end(), values, values + count);
+    } else {
+      for (size_t i = 0; i < count; ++i) {
+        data_point_ << config_.delimiter() << values[i];
+      }
+    }
+  }
+  return *this;
+}
+
 void DataStream::resetStringstream(std::stringstream &ss) {
   ss.str(std::string());
   ss.clear();
 }
 
+void DataStream::record(const std::string &line) {
+  if (recorder_rings_.empty()) {
+    return;
+  }
+  // Hold the ring while pushing so that a dump does not hand it over
+  FlightRecorderBuffer *recorder =
+      recorder_.exchange(nullptr, std::memory_order_acquire);
+  recorder->push(timestamp_, line.data(), line.size());
+  recorder_.store(recorder, std::memory_order_release);
+}
+
+bool DataStream::fits(uint64_t size) const {
+  bool stream_fits = config_.max_buffer_bytes() == 0 ||
+                     buffered_bytes_ + size <= config_.max_buffer_bytes();
+  bool budget_fits =
+      !budget_ || budget_->limit == 0 || budget_->used + size <= budget_->limit;
+  return stream_fits && budget_fits;
+}
+
+void DataStream::push(std::string line, bool header) {
+  boost::mutex::scoped_lock lock(buffer_mutex_);
+  uint64_t size = line.size();
+  if (header) {
+    header_ = line;
+  } else {
+    if (config_.drop_policy() == DataStreamConfig::DROP_OLDEST) {
+      auto oldest = buffer_.begin();
+      while (!fits(size) && oldest != buffer_.end()) {
+        if (oldest->header) {
+          ++oldest;
+          continue;
+        }
+        buffered_bytes_ -= oldest->data.size();
+        if (budget_) {
+          budget_->used -= oldest->data.size();
+        }
+        oldest = buffer_.erase(oldest);
+        ++dropped_;
+      }
+    }
+    if (!fits(size)) {
+      ++dropped_;
+      return;
+    }
+  }
+  buffered_bytes_ += size;
+  if (budget_) {
+    budget_->used += size;
+  }
+  buffer_.push_back(BufferedLine{std::move(line), header});
+}
+
+void DataStream::writeLines(const std::deque<BufferedLine> &lines) {
+  auto line = lines.begin();
+  while (line != lines.end()) {
+    iovecs_.clear();
+    for (; line != lines.end() && iovecs_.size() < IOV_MAX; ++line) {
+      iovecs_.push_back(iovec{const_cast<char *>(line->data.data()),
+                              line->data.size()});
+    }
+    writeIovecs();
+  }
+}
+
+void DataStream::writeIovecs() {
+  size_t index = 0;
+  while (index < iovecs_.size()) {
+    ssize_t written = writev(fd_, &iovecs_[index], iovecs_.size() - index);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG(ERROR) << "Failed to write " << path_.string() << ": "
+                 << std::strerror(errno);
+      return;
+    }
+    file_bytes_ += written;
+    // Skip the fully written lines and resume partially written ones
+    size_t remaining = written;
+    while (index < iovecs_.size() && remaining >= iovecs_[index].iov_len) {
+      remaining -= iovecs_[index].iov_len;
+      ++index;
+    }
+    if (index < iovecs_.size()) {
+      iovecs_[index].iov_base =
+          static_cast<char *>(iovecs_[index].iov_base) + remaining;
+      iovecs_[index].iov_len -= remaining;
+    }
+  }
+}
+
+void DataStream::encodeLines(const std::deque<BufferedLine> &lines,
+                             std::string &output) {
+  std::vector<double> values;
+  for (const auto &line : lines) {
+    if (line.header) {
+      compressor_->addHeader(line.data.substr(0, line.data.size() - 1),
+                             output);
+      continue;
+    }
+    // Copy the values out of the line since they may not be aligned
+    int64_t timestamp;
+    std::memcpy(&timestamp, line.data.data(), sizeof(timestamp));
+    values.resize((line.data.size() - sizeof(timestamp)) / sizeof(double));
+    if (!values.empty()) {
+      std::memcpy(&values[0], line.data.data() + sizeof(timestamp),
+                  values.size() * sizeof(double));
+    }
+    compressor_->addDataPoint(timestamp, values.data(), values.size());
+  }
+  compressor_->flush(output);
+}
+
 DataStream &DataStream::startl(DataStream &ds) {
   ///\todo Matt add a separate flag to enforce startl should
   /// be accompained by endl
@@ -51,38 +380,82 @@ DataStream &DataStream::startl(DataStream &ds) {
     throw std::logic_error("startl called on streaming DataStream");
   }
   if (ds.config_.log_data()) {
-    auto now = std::chrono::high_resolution_clock::now();
+    auto now = timebase::Clock::now();
     std::chrono::duration<double> time_diff = now - ds.last_write_time_;
-    ds.streaming_ = time_diff.count() > 1. / ds.config_.log_rate();
-    if (ds.streaming_) {
-      ds.data_point_ << now.time_since_epoch().count();
+    ds.buffering_ = time_diff.count() > 1. / ds.config_.log_rate();
+    // The flight recorder keeps the data points skipped by the log rate
+    if (ds.buffering_ || !ds.recorder_rings_.empty()) {
+      ds.startDataPoint(timebase::toNanoseconds(now));
     }
   }
   return ds;
 }
 
+DataStream &DataStream::startAt(const timebase::TimePoint &time) {
+  if (streaming_) {
+    throw std::logic_error("startAt called on streaming DataStream");
+  }
+  if (config_.log_data()) {
+    buffering_ = true;
+    startDataPoint(timebase::toNanoseconds(time));
+  }
+  return *this;
+}
+
+void DataStream::startDataPoint(int64_t timestamp) {
+  streaming_ = true;
+  timestamp_ = timestamp;
+  if (!compressor_) {
+    data_point_ << timestamp;
+  }
+}
+
 DataStream &DataStream::starth(DataStream &ds) {
   if (ds.streaming_) {
     throw std::logic_error("starth called on streaming DataStream");
   }
   if (ds.config_.log_data()) {
     ds.streaming_ = true;
+    ds.streaming_header_ = true;
     ds.data_point_ << "#Time";
   }
   return ds;
 }
 
 DataStream &DataStream::endl(DataStream &ds) {
-  // \todo Matt Make this stuff a public "flush" function for DataStream that
-  // gets called by DataStream::endl
-  if (ds.streaming_) {
-    {
-      boost::mutex::scoped_lock(buffer_mutex_);
-      ds.buffer_ << ds.data_point_.str() << std::endl;
+  if (ds.streaming_ && ds.compressor_ && !ds.streaming_header_) {
+    // Compressed data points are buffered as the timestamp followed by the
+    // values and encoded when written
+    std::string line(
+        sizeof(ds.timestamp_) + ds.values_.size() * sizeof(double), '\0');
+    std::memcpy(&line[0], &ds.timestamp_, sizeof(ds.timestamp_));
+    if (!ds.values_.empty()) {
+      std::memcpy(&line[sizeof(ds.timestamp_)], ds.values_.data(),
+                  ds.values_.size() * sizeof(double));
+    }
+    ds.values_.clear();
+    ds.record(line);
+    if (ds.buffering_) {
+      ds.push(std::move(line), false);
+      ds.last_write_time_ = timebase::Clock::now();
+    }
+    ds.streaming_ = false;
+  } else if (ds.streaming_) {
+    ds.data_point_ << '\n';
+    if (ds.streaming_header_) {
+      // Headers do not count towards the log rate
+      ds.push(ds.data_point_.str(), true);
+    } else {
+      std::string line = ds.data_point_.str();
+      ds.record(line);
+      if (ds.buffering_) {
+        ds.push(std::move(line), false);
+        ds.last_write_time_ = timebase::Clock::now();
+      }
     }
-    ds.last_write_time_ = std::chrono::high_resolution_clock::now();
     resetStringstream(ds.data_point_);
     ds.streaming_ = false;
+    ds.streaming_header_ = false;
   }
   return ds;
 }
@@ -0,0 +1,66 @@
+#include "aerial_autonomy/log/flight_recorder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+constexpr std::size_t FlightRecorderBuffer::framing;
+
+FlightRecorderBuffer::FlightRecorderBuffer(std::size_t capacity)
+    : storage_(capacity), begin_(0), used_(0), records_(0) {
+  if (capacity <= framing) {
+    throw std::out_of_range("Flight recorder capacity too small");
+  }
+}
+
+bool FlightRecorderBuffer::push(int64_t timestamp, const char *data,
+                                std::size_t size) {
+  std::size_t record_size = framing + size;
+  if (record_size > storage_.size()) {
+    return false;
+  }
+  while (storage_.size() - used_ < record_size) {
+    popOldest();
+  }
+  uint32_t line_size = size;
+  std::size_t offset = (begin_ + used_) % storage_.size();
+  offset = copyIn(offset, reinterpret_cast<const char *>(&line_size),
+                  sizeof(line_size));
+  offset = copyIn(offset, reinterpret_cast<const char *>(&timestamp),
+                  sizeof(timestamp));
+  copyIn(offset, data, size);
+  used_ += record_size;
+  ++records_;
+  return true;
+}
+
+void FlightRecorderBuffer::clear() {
+  begin_ = 0;
+  used_ = 0;
+  records_ = 0;
+}
+
+void FlightRecorderBuffer::popOldest() {
+  uint32_t line_size;
+  copyOut(begin_, reinterpret_cast<char *>(&line_size), sizeof(line_size));
+  std::size_t record_size = framing + line_size;
+  begin_ = (begin_ + record_size) % storage_.size();
+  used_ -= record_size;
+  --records_;
+}
+
+std::size_t FlightRecorderBuffer::copyIn(std::size_t offset, const char *data,
+                                         std::size_t size) {
+  std::size_t first = std::min(size, storage_.size() - offset);
+  std::memcpy(&storage_[offset], data, first);
+  std::memcpy(&storage_[0], data + first, size - first);
+  return (offset + size) % storage_.size();
+}
+
+std::size_t FlightRecorderBuffer::copyOut(std::size_t offset, char *data,
+                                          std::size_t size) const {
+  std::size_t first = std::min(size, storage_.size() - offset);
+  std::memcpy(data, &storage_[offset], first);
+  std::memcpy(data + first, &storage_[0], size - first);
+  return (offset + size) % storage_.size();
+}
@@ -1,15 +1,32 @@
 #include "aerial_autonomy/log/log.h"
+#include "aerial_autonomy/common/html_utils.h"
 #include "aerial_autonomy/common/string_utils.h"
+#include "aerial_autonomy/common/timebase.h"
 
 #include <boost/filesystem.hpp>
 #include <glog/logging.h>
 
+#include <fstream>
+#include <map>
+
+namespace {
+/**
+ * @brief Stream recording the mapping between the timebase and wall and ROS
+ * time
+ */
+const std::string timebase_stream_id = "timebase";
+}
+
 Log::~Log() {
   log_timer_.stop();
   writeStreams(); // Make sure all data is out of the stream buffers
 }
 
 void Log::configure(LogConfig config) {
+  // The timer locks the streams while writing so it is stopped before locking
+  log_timer_.stop();
+  boost::recursive_mutex::scoped_lock lock(streams_mutex_);
+  writeStreams(); // Write the remaining data of the previous configuration
   config_ = config;
 
   // \todo Matt Add git commit tag to log file
@@ -20,13 +37,80 @@ void Log::configure(LogConfig config) {
                                directory_.string());
     }
   }
+  dump_count_ = 0;
+  flight_recorder_enabled_ = config_.flight_recorder_duration() > 0;
   configureStreams(config_);
 }
 
 boost::filesystem::path Log::directory() { return directory_; }
 
-DataStream &Log::operator[](std::string id) {
-  boost::recursive_mutex::scoped_lock(streams_mutex_);
+void Log::dumpFlightRecorder(const std::string &reason) {
+  if (!flight_recorder_enabled_) {
+    return;
+  }
+  {
+    boost::mutex::scoped_lock lock(dump_mutex_);
+    if (!dump_reason_.empty()) {
+      dump_reason_ += "; ";
+    }
+    dump_reason_ += reason;
+  }
+  flagFlightRecorderDump();
+}
+
+void Log::requestFlightRecorderDump(const char *reason) {
+  if (!flight_recorder_enabled_) {
+    return;
+  }
+  for (auto &pending_reason : pending_reasons_) {
+    const char *expected = nullptr;
+    if (pending_reason.compare_exchange_strong(expected, reason) ||
+        expected == reason) {
+      break;
+    }
+  }
+  flagFlightRecorderDump();
+}
+
+void Log::flagFlightRecorderDump() {
+  int64_t no_request = 0;
+  dump_time_.compare_exchange_strong(
+      no_request, timebase::toNanoseconds(timebase::Clock::now()));
+  dump_requested_ = true;
+}
+
+unsigned int Log::flightRecorderDumps() { return dump_count_; }
+
+std::string Log::getStatus() {
+  boost::recursive_mutex::scoped_lock lock(streams_mutex_);
+  // Sort the streams by id
+  std::map<std::string, DataStream *> sorted_streams;
+  for (auto &stream : streams_) {
+    sorted_streams[stream.first] = &stream.second;
+  }
+  HtmlTableWriter table_writer;
+  table_writer.beginRow();
+  table_writer.addHeader("Log Status", Colors::blue, 3);
+  for (const auto &stream : sorted_streams) {
+    uint64_t dropped = stream.second->droppedDataPoints();
+    table_writer.beginRow();
+    table_writer.addCell(stream.first);
+    table_writer.addCell(dropped, "Dropped",
+                         dropped > 0 ? Colors::red : Colors::green);
+    table_writer.addCell(stream.second->bufferedBytes(), "Buffered");
+  }
+  return table_writer.getTableString();
+}
+
+DataStream &Log::operator[](const char *id) {
+  // The key keeps its capacity across the calls of a thread
+  static thread_local std::string key;
+  key.assign(id);
+  return (*this)[key];
+}
+
+DataStream &Log::operator[](const std::string &id) {
+  boost::recursive_mutex::scoped_lock lock(streams_mutex_);
   auto stream = streams_.find(id);
   if (stream == streams_.end()) {
     // \todo Matt Find a better way to deal with this...
@@ -50,31 +134,129 @@ DataStream &Log::operator[](std::string id) {
 }
 
 void Log::addDataStream(DataStreamConfig stream_config) {
-  boost::recursive_mutex::scoped_lock(streams_mutex_);
+  boost::recursive_mutex::scoped_lock lock(streams_mutex_);
   if (streams_.find(stream_config.stream_id()) != streams_.end()) {
     throw std::runtime_error("Stream ID not unique: " +
                              stream_config.stream_id());
   }
   streams_.emplace(
       stream_config.stream_id(),
-      DataStream(directory_ / stream_config.stream_id(), stream_config));
+      DataStream(directory_ / stream_config.stream_id(), stream_config,
+                 budget_, config_.flight_recorder_duration() > 0
+                              ? config_.flight_recorder_bytes()
+                              : 0));
+}
+
+bool Log::hasDataStream(const std::string &id) {
+  boost::recursive_mutex::scoped_lock lock(streams_mutex_);
+  return streams_.find(id) != streams_.end();
 }
 
 void Log::configureStreams(LogConfig config) {
-  boost::recursive_mutex::scoped_lock(streams_mutex_);
-  log_timer_.stop(); // \todo Matt With locking, we should not have to stop the
-                     // timer... but for some reason it does not write otherwise
-  streams_.clear();  // streams are closed in destructor
+  // The timer is stopped by configure since it writes the streams without
+  // holding the lock
+  streams_.clear(); // streams are closed in destructor
+  budget_ = std::make_shared<BufferBudget>(config_.max_buffer_bytes());
   for (auto stream_config : config_.data_stream_configs()) {
     addDataStream(stream_config);
   }
+  // Record the timebase mapping once per second unless configured otherwise
+  if (streams_.find(timebase_stream_id) == streams_.end()) {
+    DataStreamConfig timebase_config;
+    timebase_config.set_stream_id(timebase_stream_id);
+    timebase_config.set_log_rate(1);
+    addDataStream(timebase_config);
+  }
+  streams_.at(timebase_stream_id) << DataStream::starth << "Wall_time"
+                                  << "ROS_time" << DataStream::endl;
   log_timer_.setDuration(std::chrono::milliseconds(config_.write_duration()));
   log_timer_.start();
 }
 
 void Log::writeStreams() {
-  boost::recursive_mutex::scoped_lock(streams_mutex_);
-  for (auto &stream : instance().streams_) {
-    stream.second.write();
+  {
+    boost::recursive_mutex::scoped_lock lock(streams_mutex_);
+    auto timebase_stream = streams_.find(timebase_stream_id);
+    if (timebase_stream != streams_.end()) {
+      timebase_stream->second << DataStream::startl << timebase::wallTime()
+                              << timebase::rosTime() << DataStream::endl;
+    }
+    writing_streams_.clear();
+    for (auto &stream : streams_) {
+      writing_streams_.push_back(&stream.second);
+    }
+  }
+  // Streams are only removed by configureStreams after stopping the timer so
+  // the disk writes do not block threads logging data points
+  auto now = std::chrono::steady_clock::now();
+  bool sync =
+      config_.fsync_policy() == LogConfig::EVERY_WRITE ||
+      (config_.fsync_policy() == LogConfig::PERIODIC &&
+       now - last_sync_time_ >=
+           std::chrono::milliseconds(config_.fsync_period()));
+  for (auto stream : writing_streams_) {
+    stream->write();
+    if (sync) {
+      stream->sync();
+    }
+    bool size_exceeded = config_.max_file_bytes() > 0 &&
+                         stream->fileBytes() >= config_.max_file_bytes();
+    bool duration_exceeded =
+        config_.max_file_duration() > 0 &&
+        now - stream->fileOpenTime() >=
+            std::chrono::seconds(config_.max_file_duration());
+    if (size_exceeded || duration_exceeded) {
+      stream->rotate(config_.fsync_policy() != LogConfig::NEVER);
+    }
+  }
+  if (sync) {
+    last_sync_time_ = now;
+  }
+  writeFlightRecord();
+}
+
+void Log::writeFlightRecord() {
+  if (!dump_requested_.exchange(false)) {
+    return;
+  }
+  int64_t dump_time = dump_time_.exchange(0);
+  std::string reason;
+  {
+    boost::mutex::scoped_lock lock(dump_mutex_);
+    reason.swap(dump_reason_);
+  }
+  for (auto &pending_reason : pending_reasons_) {
+    const char *pending = pending_reason.exchange(nullptr);
+    if (pending != nullptr) {
+      reason += (reason.empty() ? "" : "; ") + std::string(pending);
+    }
+  }
+  if (dump_time == 0) {
+    // The request raced with the previous dump, which took its time
+    dump_time = timebase::toNanoseconds(timebase::Clock::now());
+  }
+  boost::filesystem::path record_directory =
+      directory_ / ("flight_record_" + std::to_string(dump_count_ + 1));
+  boost::system::error_code error;
+  boost::filesystem::create_directory(record_directory, error);
+  if (error) {
+    LOG(ERROR) << "Could not create flight record directory "
+               << record_directory.string() << ": " << error.message();
+    return;
+  }
+  int64_t since =
+      dump_time - std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::duration<double>(
+                          config_.flight_recorder_duration()))
+                      .count();
+  for (auto stream : writing_streams_) {
+    stream->dumpFlightRecorder(
+        record_directory / stream->configuration().stream_id(), since);
   }
+  std::ofstream trigger((record_directory / "trigger").string());
+  trigger << "#Time,Reason\n"
+          << dump_time << "," << reason << "\n";
+  ++dump_count_;
+  LOG(WARNING) << "Wrote flight record " << record_directory.string() << ": "
+               << reason;
 }
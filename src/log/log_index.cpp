@@ -0,0 +1,535 @@
+#include "aerial_autonomy/log/log_index.h"
+#include "aerial_autonomy/log/stream_compression.h"
+
+#include <glog/logging.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+/**
+ * @brief Identifies index files and their format version
+ */
+const char index_magic[8] = {'A', 'A', 'L', 'O', 'G', 'I', 'D', '1'};
+
+/**
+ * @brief Split a header line into column names excluding "#Time"
+ */
+std::vector<std::string> splitHeader(const char *begin, const char *end,
+                                     const std::string &delimiter) {
+  std::string line(begin, end);
+  std::vector<std::string> fields;
+  size_t last = 0;
+  size_t next = 0;
+  while ((next = line.find(delimiter, last)) != std::string::npos) {
+    fields.push_back(line.substr(last, next - last));
+    last = next + delimiter.size();
+  }
+  fields.push_back(line.substr(last));
+  return std::vector<std::string>(fields.begin() + 1, fields.end());
+}
+
+/**
+ * @brief Write a value to a binary stream
+ */
+template <class T> void writeBinary(std::ofstream &file, const T &value) {
+  file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+/**
+ * @brief Read a value from a binary stream
+ */
+template <class T> bool readBinary(std::ifstream &file, T &value) {
+  return bool(file.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+}
+
+MappedStream::MappedStream(boost::filesystem::path path, std::string delimiter,
+                           unsigned int index_stride)
+    : path_(path), delimiter_(delimiter), index_stride_(index_stride),
+      fd_(-1), data_(nullptr), file_size_(0), record_count_(0), end_time_(0),
+      index_loaded_(false) {
+  if (delimiter_.empty() || index_stride_ == 0) {
+    throw std::runtime_error("Invalid delimiter or index stride for stream: " +
+                             path_.string());
+  }
+  if (CompressedStreamReader::isCompressed(path_.string())) {
+    decodeCompressed();
+    return;
+  }
+  fd_ = open(path_.string().c_str(), O_RDONLY);
+  if (fd_ < 0) {
+    throw std::runtime_error("Could not open file: " + path_.string());
+  }
+  struct stat file_stat;
+  if (fstat(fd_, &file_stat) != 0 || file_stat.st_size == 0) {
+    close(fd_);
+    throw std::runtime_error("Empty stream file: " + path_.string());
+  }
+  file_size_ = file_stat.st_size;
+  void *data = mmap(nullptr, file_size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+  if (data == MAP_FAILED) {
+    close(fd_);
+    throw std::runtime_error("Could not map file: " + path_.string());
+  }
+  data_ = static_cast<const char *>(data);
+  try {
+    parseHeader();
+    index_loaded_ = loadIndex();
+    if (!index_loaded_) {
+      buildIndex();
+    }
+  } catch (...) {
+    munmap(const_cast<char *>(data_), file_size_);
+    close(fd_);
+    throw;
+  }
+}
+
+MappedStream::~MappedStream() {
+  if (fd_ >= 0) {
+    munmap(const_cast<char *>(data_), file_size_);
+    close(fd_);
+  }
+}
+
+const std::vector<std::string> &MappedStream::columns() const {
+  return columns_;
+}
+
+const RecordSchema &MappedStream::schema() const { return schema_; }
+
+size_t MappedStream::columnIndex(const std::string &column) const {
+  if (!schema_.hasField(column)) {
+    throw std::runtime_error("Stream " + streamId() + " has no column " +
+                             column);
+  }
+  return schema_.valueOffset(column);
+}
+
+std::string MappedStream::streamId() const {
+  return path_.filename().string();
+}
+
+uint64_t MappedStream::size() const { return record_count_; }
+
+int64_t MappedStream::startTime() const {
+  return index_.empty() ? 0 : index_.front().timestamp;
+}
+
+int64_t MappedStream::endTime() const { return end_time_; }
+
+bool MappedStream::indexLoaded() const { return index_loaded_; }
+
+boost::filesystem::path
+MappedStream::indexPath(const boost::filesystem::path &stream_path) {
+  return stream_path.string() + ".index";
+}
+
+void MappedStream::saveIndex() const {
+  boost::filesystem::path index_path = indexPath(path_);
+  std::ofstream file(index_path.string(), std::ios::binary);
+  if (!file.is_open()) {
+    throw std::runtime_error("Could not open file: " + index_path.string());
+  }
+  file.write(index_magic, sizeof(index_magic));
+  writeBinary(file, file_size_);
+  writeBinary(file, index_stride_);
+  writeBinary(file, record_count_);
+  writeBinary(file, end_time_);
+  writeBinary(file, uint64_t(index_.size()));
+  for (const auto &entry : index_) {
+    writeBinary(file, entry.timestamp);
+    writeBinary(file, entry.offset);
+    writeBinary(file, entry.segment);
+  }
+  if (!file) {
+    throw std::runtime_error("Could not write file: " + index_path.string());
+  }
+}
+
+StreamCursor MappedStream::cursor(int64_t start, int64_t end) const {
+  if (index_.empty()) {
+    return StreamCursor(*this, file_size_, 0, start, end);
+  }
+  const StreamIndexEntry &entry = index_[entryBefore(start)];
+  return StreamCursor(*this, entry.offset, entry.segment, start, end);
+}
+
+StreamCursor MappedStream::cursorBefore(int64_t time, int64_t end) const {
+  if (index_.empty()) {
+    return StreamCursor(*this, file_size_, 0, time, end);
+  }
+  const StreamIndexEntry &entry = index_[entryBefore(time)];
+  return StreamCursor(*this, entry.offset, entry.segment,
+                      std::numeric_limits<int64_t>::min(), end);
+}
+
+void MappedStream::decodeCompressed() {
+  std::ifstream file(path_.string(), std::ios::binary);
+  CompressedStreamReader reader(file);
+  delimiter_ = reader.delimiter();
+  // Decode to text with enough digits to keep the values exact
+  std::ostringstream text;
+  text.precision(std::numeric_limits<double>::max_digits10);
+  while (reader.next()) {
+    if (reader.isHeader()) {
+      text << reader.header() << '\n';
+      continue;
+    }
+    const LogRecord &record = reader.record();
+    text << record.timestamp;
+    for (double value : record.values) {
+      text << delimiter_ << value;
+    }
+    text << '\n';
+  }
+  decoded_ = text.str();
+  if (decoded_.empty()) {
+    throw std::runtime_error("Empty stream file: " + path_.string());
+  }
+  data_ = decoded_.data();
+  file_size_ = decoded_.size();
+  parseHeader();
+  index_loaded_ = loadIndex();
+  if (!index_loaded_) {
+    buildIndex();
+  }
+}
+
+void MappedStream::parseHeader() {
+  if (data_[0] != '#') {
+    throw std::runtime_error("No header in stream: " + path_.string());
+  }
+  columns_ = splitHeader(data_, data_ + lineEnd(0), delimiter_);
+  schema_ = RecordSchema(columns_);
+}
+
+bool MappedStream::loadIndex() {
+  boost::filesystem::path index_path = indexPath(path_);
+  boost::system::error_code error;
+  if (!boost::filesystem::exists(index_path, error) ||
+      boost::filesystem::last_write_time(index_path, error) <
+          boost::filesystem::last_write_time(path_, error)) {
+    return false;
+  }
+  std::ifstream file(index_path.string(), std::ios::binary);
+  char magic[sizeof(index_magic)];
+  uint64_t file_size, entry_count;
+  if (!file.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, index_magic, sizeof(magic)) != 0 ||
+      !readBinary(file, file_size) || file_size != file_size_ ||
+      !readBinary(file, index_stride_) || !readBinary(file, record_count_) ||
+      !readBinary(file, end_time_) || !readBinary(file, entry_count)) {
+    return false;
+  }
+  index_.resize(entry_count);
+  for (auto &entry : index_) {
+    if (!readBinary(file, entry.timestamp) || !readBinary(file, entry.offset) ||
+        !readBinary(file, entry.segment) || entry.offset >= file_size_) {
+      index_.clear();
+      record_count_ = 0;
+      end_time_ = 0;
+      return false;
+    }
+  }
+  return true;
+}
+
+void MappedStream::buildIndex() {
+  int32_t segment = -1;
+  uint64_t last_record = 0;
+  for (uint64_t offset = 0; offset < file_size_;) {
+    uint64_t end = lineEnd(offset);
+    if (end == offset) {
+      ++offset;
+      continue;
+    }
+    if (data_[offset] == '#') {
+      if (segment >= 0 &&
+          splitHeader(data_ + offset, data_ + end, delimiter_) != columns_) {
+        throw std::runtime_error("Header at byte " + std::to_string(offset) +
+                                 " does not match the first header of " +
+                                 path_.string());
+      }
+      ++segment;
+    } else {
+      if (record_count_ % index_stride_ == 0) {
+        index_.push_back(
+            StreamIndexEntry{parseTimestamp(offset), offset, segment});
+      }
+      last_record = offset;
+      ++record_count_;
+    }
+    offset = end + 1;
+  }
+  if (record_count_ > 0) {
+    end_time_ = parseTimestamp(last_record);
+  }
+}
+
+uint64_t MappedStream::lineEnd(uint64_t offset) const {
+  const void *end = std::memchr(data_ + offset, '\n', file_size_ - offset);
+  return end ? static_cast<const char *>(end) - data_ : file_size_;
+}
+
+int64_t MappedStream::parseTimestamp(uint64_t offset) const {
+  // Timestamps have at most 19 digits
+  char buffer[24] = {0};
+  uint64_t end = std::min(lineEnd(offset), offset + sizeof(buffer) - 1);
+  std::copy(data_ + offset, data_ + end, buffer);
+  char *parse_end;
+  long long timestamp = std::strtoll(buffer, &parse_end, 10);
+  if (parse_end == buffer) {
+    throw std::runtime_error("Could not parse timestamp at byte " +
+                             std::to_string(offset) + " of " + path_.string());
+  }
+  return timestamp;
+}
+
+void MappedStream::parseRecord(uint64_t begin, uint64_t end,
+                               std::string &buffer, LogRecord &record) const {
+  buffer.assign(data_ + begin, data_ + end);
+  const char *field = buffer.c_str();
+  char *parse_end;
+  record.timestamp = std::strtoll(field, &parse_end, 10);
+  bool valid = parse_end != field;
+  record.values.clear();
+  field = parse_end;
+  while (valid && *field != '\0') {
+    valid = buffer.compare(field - buffer.c_str(), delimiter_.size(),
+                           delimiter_) == 0;
+    field += delimiter_.size();
+    record.values.push_back(std::strtod(field, &parse_end));
+    valid = valid && parse_end != field;
+    field = parse_end;
+  }
+  if (!valid || !schema_.matches(record.values)) {
+    throw std::runtime_error("Could not parse data point at byte " +
+                             std::to_string(begin) + " of " + path_.string());
+  }
+}
+
+size_t MappedStream::entryBefore(int64_t time) const {
+  auto it = std::lower_bound(index_.begin(), index_.end(), time,
+                             [](const StreamIndexEntry &entry, int64_t t) {
+                               return entry.timestamp < t;
+                             });
+  return it == index_.begin() ? 0 : (it - index_.begin()) - 1;
+}
+
+StreamCursor::StreamCursor(const MappedStream &stream, uint64_t offset,
+                           int32_t segment, int64_t start, int64_t end)
+    : stream_(&stream), offset_(offset), segment_(segment), start_(start),
+      end_(end) {}
+
+bool StreamCursor::next(LogRecord &record) {
+  while (offset_ < stream_->file_size_) {
+    uint64_t line_end = stream_->lineEnd(offset_);
+    uint64_t line_begin = offset_;
+    offset_ = line_end + 1;
+    if (line_end == line_begin) {
+      continue;
+    }
+    if (stream_->data_[line_begin] == '#') {
+      ++segment_;
+      continue;
+    }
+    stream_->parseRecord(line_begin, line_end, buffer_, record);
+    if (record.timestamp < start_) {
+      continue;
+    }
+    if (record.timestamp > end_) {
+      offset_ = stream_->file_size_;
+      return false;
+    }
+    record.segment = segment_;
+    return true;
+  }
+  return false;
+}
+
+MergedCursor::MergedCursor(std::vector<StreamCursor> cursors)
+    : cursors_(cursors), heads_(cursors_.size()) {
+  for (size_t i = 0; i < cursors_.size(); ++i) {
+    if (cursors_[i].next(heads_[i])) {
+      queue_.push(QueueEntry(heads_[i].timestamp, i));
+    }
+  }
+}
+
+bool MergedCursor::next(size_t &stream, LogRecord &record) {
+  if (queue_.empty()) {
+    return false;
+  }
+  stream = queue_.top().second;
+  queue_.pop();
+  std::swap(record, heads_[stream]);
+  if (cursors_[stream].next(heads_[stream])) {
+    queue_.push(QueueEntry(heads_[stream].timestamp, stream));
+  }
+  return true;
+}
+
+ResampledCursor::ResampledCursor(std::vector<const MappedStream *> streams,
+                                 int64_t start, int64_t end,
+                                 std::chrono::nanoseconds period,
+                                 ResampleMethod method)
+    : time_(start), end_(end), period_(period.count()), method_(method),
+      done_(start > end) {
+  CHECK_GT(period_, 0) << "Resampling period should be positive";
+  for (auto stream : streams) {
+    std::vector<std::string> names = stream->schema().valueNames();
+    StreamState state{stream->cursorBefore(start,
+                                           std::numeric_limits<int64_t>::max()),
+                      LogRecord(),
+                      LogRecord(),
+                      false,
+                      false,
+                      columns_.size(),
+                      stream->schema().size()};
+    state.has_upcoming = state.cursor.next(state.upcoming);
+    states_.push_back(state);
+    for (const auto &name : names) {
+      columns_.push_back(stream->streamId() + "/" + name);
+    }
+  }
+}
+
+const std::vector<std::string> &ResampledCursor::columns() const {
+  return columns_;
+}
+
+bool ResampledCursor::next(int64_t &time, std::vector<double> &values) {
+  if (done_) {
+    return false;
+  }
+  time = time_;
+  values.resize(columns_.size());
+  for (auto &state : states_) {
+    while (state.has_upcoming && state.upcoming.timestamp <= time) {
+      std::swap(state.previous, state.upcoming);
+      state.has_previous = true;
+      state.has_upcoming = state.cursor.next(state.upcoming);
+    }
+    auto output = values.begin() + state.column_offset;
+    size_t column_count = state.column_count;
+    if (!state.has_previous) {
+      std::fill(output, output + column_count,
+                std::numeric_limits<double>::quiet_NaN());
+    } else if (method_ == ResampleMethod::Linear && state.has_upcoming &&
+               state.upcoming.segment == state.previous.segment) {
+      double ratio = double(time - state.previous.timestamp) /
+                     (state.upcoming.timestamp - state.previous.timestamp);
+      for (size_t i = 0; i < column_count; ++i) {
+        output[i] = state.previous.values[i] +
+                    ratio * (state.upcoming.values[i] -
+                             state.previous.values[i]);
+      }
+    } else {
+      std::copy(state.previous.values.begin(), state.previous.values.end(),
+                output);
+    }
+  }
+  done_ = end_ - time_ < period_;
+  if (!done_) {
+    time_ += period_;
+  }
+  return true;
+}
+
+LogIndex::LogIndex(boost::filesystem::path directory, std::string delimiter,
+                   unsigned int index_stride) {
+  if (!boost::filesystem::is_directory(directory)) {
+    throw std::runtime_error("Log directory does not exist: " +
+                             directory.string());
+  }
+  for (boost::filesystem::directory_iterator it(directory), end; it != end;
+       ++it) {
+    const boost::filesystem::path &path = it->path();
+    if (!boost::filesystem::is_regular_file(path) ||
+        path.extension() == ".index") {
+      continue;
+    }
+    try {
+      streams_[path.filename().string()].reset(
+          new MappedStream(path, delimiter, index_stride));
+    } catch (const std::runtime_error &error) {
+      streams_.erase(path.filename().string());
+      LOG(WARNING) << "Skipping " << path.string() << ": " << error.what();
+    }
+  }
+}
+
+std::vector<std::string> LogIndex::streamIds() const {
+  std::vector<std::string> stream_ids;
+  for (const auto &stream : streams_) {
+    stream_ids.push_back(stream.first);
+  }
+  return stream_ids;
+}
+
+const MappedStream &LogIndex::stream(const std::string &stream_id) const {
+  auto stream = streams_.find(stream_id);
+  if (stream == streams_.end()) {
+    throw std::runtime_error("No stream with id: " + stream_id);
+  }
+  return *stream->second;
+}
+
+int64_t LogIndex::startTime() const {
+  int64_t start = std::numeric_limits<int64_t>::max();
+  for (const auto &stream : streams_) {
+    if (stream.second->size() > 0) {
+      start = std::min(start, stream.second->startTime());
+    }
+  }
+  return start;
+}
+
+int64_t LogIndex::endTime() const {
+  int64_t end = std::numeric_limits<int64_t>::min();
+  for (const auto &stream : streams_) {
+    if (stream.second->size() > 0) {
+      end = std::max(end, stream.second->endTime());
+    }
+  }
+  return end;
+}
+
+void LogIndex::saveIndices() const {
+  for (const auto &stream : streams_) {
+    stream.second->saveIndex();
+  }
+}
+
+MergedCursor LogIndex::merged(const std::vector<std::string> &stream_ids,
+                              int64_t start, int64_t end) const {
+  std::vector<StreamCursor> cursors;
+  for (const auto &stream_id : stream_ids) {
+    cursors.push_back(stream(stream_id).cursor(start, end));
+  }
+  return MergedCursor(cursors);
+}
+
+ResampledCursor LogIndex::resample(const std::vector<std::string> &stream_ids,
+                                   int64_t start, int64_t end,
+                                   std::chrono::nanoseconds period,
+                                   ResampleMethod method) const {
+  std::vector<const MappedStream *> streams;
+  for (const auto &stream_id : stream_ids) {
+    streams.push_back(&stream(stream_id));
+  }
+  return ResampledCursor(streams, start, end, period, method);
+}
@@ -0,0 +1,163 @@
+#include "aerial_autonomy/log/log_reader.h"
+#include "aerial_autonomy/log/stream_compression.h"
+
+#include <fstream>
+#include <stdexcept>
+
+RecordedStream::RecordedStream(boost::filesystem::path path,
+                               std::string delimiter)
+    : path_(path), delimiter_(delimiter) {
+  if (delimiter_.empty()) {
+    throw std::runtime_error("Empty delimiter for stream: " + path_.string());
+  }
+  if (CompressedStreamReader::isCompressed(path_.string())) {
+    readCompressed();
+    return;
+  }
+  std::ifstream file(path_.string());
+  if (!file.is_open()) {
+    throw std::runtime_error("Could not open file: " + path_.string());
+  }
+  std::string line;
+  int segment = -1;
+  int line_number = 0;
+  while (std::getline(file, line)) {
+    ++line_number;
+    if (line.empty()) {
+      continue;
+    }
+    std::vector<std::string> fields = split(line);
+    if (line[0] == '#') {
+      // Header with "#Time" as the first field
+      std::vector<std::string> columns(fields.begin() + 1, fields.end());
+      setColumns(columns, ++segment,
+                 "Header on line " + std::to_string(line_number));
+      continue;
+    }
+    if (segment < 0) {
+      throw std::runtime_error("Data before header in " + path_.string());
+    }
+    if (schema_.fixedSize() && fields.size() != schema_.size() + 1) {
+      throw std::runtime_error("Expected " +
+                               std::to_string(schema_.size() + 1) +
+                               " fields on line " +
+                               std::to_string(line_number) + " of " +
+                               path_.string());
+    }
+    LogRecord record;
+    record.segment = segment;
+    try {
+      record.timestamp = std::stoll(fields[0]);
+      record.values.reserve(fields.size() - 1);
+      for (size_t i = 1; i < fields.size(); ++i) {
+        record.values.push_back(std::stod(fields[i]));
+      }
+    } catch (const std::logic_error &) {
+      throw std::runtime_error("Could not parse line " +
+                               std::to_string(line_number) + " of " +
+                               path_.string());
+    }
+    if (!schema_.matches(record.values)) {
+      throw std::runtime_error("Line " + std::to_string(line_number) + " of " +
+                               path_.string() +
+                               " does not match the header fields");
+    }
+    records_.push_back(record);
+  }
+}
+
+void RecordedStream::readCompressed() {
+  std::ifstream file(path_.string(), std::ios::binary);
+  CompressedStreamReader reader(file);
+  delimiter_ = reader.delimiter();
+  while (reader.next()) {
+    if (reader.isHeader()) {
+      std::vector<std::string> fields = split(reader.header());
+      std::vector<std::string> columns(fields.begin() + 1, fields.end());
+      setColumns(columns, reader.record().segment,
+                 "Header " + std::to_string(reader.record().segment));
+      continue;
+    }
+    const LogRecord &record = reader.record();
+    if (record.segment < 0) {
+      throw std::runtime_error("Data before header in " + path_.string());
+    }
+    if (schema_.fixedSize() && record.values.size() != schema_.size()) {
+      throw std::runtime_error("Expected " + std::to_string(schema_.size()) +
+                               " values in data point " +
+                               std::to_string(records_.size()) + " of " +
+                               path_.string());
+    }
+    if (!schema_.matches(record.values)) {
+      throw std::runtime_error("Data point " + std::to_string(records_.size()) +
+                               " of " + path_.string() +
+                               " does not match the header fields");
+    }
+    records_.push_back(record);
+  }
+}
+
+const std::vector<std::string> &RecordedStream::columns() const {
+  return columns_;
+}
+
+const RecordSchema &RecordedStream::schema() const { return schema_; }
+
+RecordField RecordedStream::field(const LogRecord &record,
+                                  const std::string &name) const {
+  if (!schema_.hasField(name)) {
+    throw std::runtime_error("Stream " + streamId() + " has no field " + name);
+  }
+  return schema_.field(record.values, name);
+}
+
+const std::vector<LogRecord> &RecordedStream::records() const {
+  return records_;
+}
+
+size_t RecordedStream::columnIndex(const std::string &column) const {
+  if (!schema_.hasField(column)) {
+    throw std::runtime_error("Stream " + streamId() + " has no column " +
+                             column);
+  }
+  return schema_.valueOffset(column);
+}
+
+bool RecordedStream::hasColumn(const std::string &column) const {
+  return schema_.hasField(column);
+}
+
+std::string RecordedStream::streamId() const {
+  return path_.filename().string();
+}
+
+void RecordedStream::setColumns(const std::vector<std::string> &columns,
+                                int segment, const std::string &location) {
+  if (segment > 0) {
+    if (columns != columns_) {
+      throw std::runtime_error(location +
+                               " does not match the first header of " +
+                               path_.string());
+    }
+    return;
+  }
+  try {
+    schema_ = RecordSchema(columns);
+  } catch (const std::runtime_error &error) {
+    throw std::runtime_error(location + " of " + path_.string() + ": " +
+                             error.what());
+  }
+  columns_ = columns;
+}
+
+std::vector<std::string> RecordedStream::split(const std::string &line) const {
+  std::vector<std::string> fields;
+  size_t last = 0;
+  size_t next = 0;
+  while ((next = line.find(delimiter_, last)) != std::string::npos) {
+    fields.push_back(line.substr(last, next - last));
+    last = next + delimiter_.size();
+  }
+  fields.push_back(line.substr(last));
+  return fields;
+}
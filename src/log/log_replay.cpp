@@ -0,0 +1,126 @@
+#include "aerial_autonomy/log/log_replay.h"
+#include "aerial_autonomy/log/log.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+bool ReplayResult::diverged() const {
+  for (const auto &column : columns) {
+    if (column.divergent_ticks > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::ostream &operator<<(std::ostream &os, const ReplayResult &result) {
+  using std::chrono::duration;
+  os << "Stream: " << result.stream_id << "\n"
+     << "Ticks: " << result.ticks << " Segments: " << result.segments << "\n"
+     << "Recorded duration (s): "
+     << duration<double>(result.recorded_duration).count()
+     << " Replay duration (s): "
+     << duration<double>(result.replay_duration).count() << "\n"
+     << "Tick cost (us) mean: "
+     << duration<double, std::micro>(result.mean_tick_cost).count()
+     << " max: " << duration<double, std::micro>(result.max_tick_cost).count()
+     << "\n";
+  for (const auto &column : result.columns) {
+    os << column.column << ": max error " << column.max_error << " rms error "
+       << column.rms_error << " divergent ticks " << column.divergent_ticks;
+    if (column.first_divergence >= 0) {
+      os << " first divergence at tick " << column.first_divergence;
+    }
+    os << "\n";
+  }
+  os << (result.diverged() ? "DIVERGED" : "MATCHED");
+  return os;
+}
+
+LogReplay::LogReplay(LogReplayConfig config) : config_(config) {
+  CHECK_GE(config_.divergence_tolerance(), 0)
+      << "Divergence tolerance should be non negative";
+}
+
+ReplayResult LogReplay::replay(const RecordedStream &stream,
+                               StreamReplayer &replayer) {
+  // Replayed components write to a private log with their stream disabled
+  // instead of appending to the recorded streams of the process wide log
+  Log replay_log(nullptr);
+  DataStreamConfig replay_stream_config;
+  replay_stream_config.set_stream_id(stream.streamId());
+  replay_stream_config.set_log_data(false);
+  replay_log.addDataStream(replay_stream_config);
+  Log::Scope log_scope(replay_log);
+  replayer.initialize(stream);
+  std::vector<std::string> output_columns = replayer.outputColumns();
+  std::vector<size_t> output_indices;
+  ReplayResult result;
+  result.stream_id = stream.streamId();
+  result.ticks = 0;
+  result.segments = 0;
+  for (const auto &column : output_columns) {
+    output_indices.push_back(stream.columnIndex(column));
+    result.columns.push_back(ColumnDivergence{column, 0, 0, 0, -1});
+  }
+  result.mean_tick_cost = std::chrono::nanoseconds(0);
+  result.max_tick_cost = std::chrono::nanoseconds(0);
+  result.recorded_duration = std::chrono::nanoseconds(0);
+
+  const std::vector<LogRecord> &records = stream.records();
+  std::vector<double> outputs(output_columns.size());
+  std::vector<double> squared_errors(output_columns.size(), 0);
+  int segment = -1;
+  auto replay_start = std::chrono::steady_clock::now();
+  for (const auto &record : records) {
+    if (config_.rate_scale() > 0) {
+      std::chrono::duration<double, std::nano> recorded_offset(
+          (record.timestamp - records.front().timestamp) /
+          config_.rate_scale());
+      std::this_thread::sleep_until(
+          replay_start +
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              recorded_offset));
+    }
+    if (record.segment != segment) {
+      replayer.reset();
+      segment = record.segment;
+      result.segments++;
+    }
+    auto tick_start = std::chrono::steady_clock::now();
+    replayer.step(record.values, outputs);
+    auto tick_cost = std::chrono::steady_clock::now() - tick_start;
+    result.mean_tick_cost += tick_cost;
+    result.max_tick_cost = std::max(
+        result.max_tick_cost,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(tick_cost));
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      ColumnDivergence &column = result.columns[i];
+      double error = std::abs(outputs[i] - record.values[output_indices[i]]);
+      // NaN errors count as divergent
+      if (!(error <= config_.divergence_tolerance())) {
+        if (column.divergent_ticks == 0) {
+          column.first_divergence = result.ticks;
+        }
+        column.divergent_ticks++;
+      }
+      column.max_error = std::max(column.max_error, error);
+      squared_errors[i] += error * error;
+    }
+    result.ticks++;
+  }
+  result.replay_duration = std::chrono::steady_clock::now() - replay_start;
+  if (result.ticks > 0) {
+    result.mean_tick_cost /= result.ticks;
+    result.recorded_duration = std::chrono::nanoseconds(
+        records.back().timestamp - records.front().timestamp);
+    for (size_t i = 0; i < result.columns.size(); ++i) {
+      result.columns[i].rms_error =
+          std::sqrt(squared_errors[i] / result.ticks);
+    }
+  }
+  return result;
+}
@@ -1,21 +1,27 @@
-#include <aerial_autonomy/log/log.h>
 #include <aerial_autonomy/log/mocap_logger.h>
 
-MocapLogger::MocapLogger() : nh_("mocap_log") {
-  mocap_sub_ = nh_.subscribe("quad_pose_mocap", 1, &MocapLogger::logData, this);
-  DATA_HEADER("mocap_logger") << "X"
-                              << "Y"
-                              << "Z"
-                              << "Qx"
-                              << "Qy"
-                              << "Qz"
-                              << "Qw" << DataStream::endl;
+MocapLogger::MocapLogger(MocapCaptureConfig config,
+                         const SystemHandlerContext &context)
+    : capture_(config, context.executor),
+      nh_(context.nodeHandle("mocap_log")) {
+  mocap_sub_ = nh_.subscribe(config.topic(), config.queue_size(),
+                             &MocapLogger::logData, this);
 }
 
+MocapCapture &MocapLogger::capture() { return capture_; }
+
 void MocapLogger::logData(const geometry_msgs::TransformStampedConstPtr data) {
   auto &transform = data->transform;
-  DATA_LOG("mocap_logger") << transform.translation.x << transform.translation.y
-                           << transform.translation.z << transform.rotation.x
-                           << transform.rotation.y << transform.rotation.z
-                           << transform.rotation.w << DataStream::endl;
+  MocapSample sample;
+  sample.source_time = timebase::fromRosTime(data->header.stamp);
+  sample.receive_time = timebase::Clock::now();
+  sample.sequence = data->header.seq;
+  sample.x = transform.translation.x;
+  sample.y = transform.translation.y;
+  sample.z = transform.translation.z;
+  sample.qx = transform.rotation.x;
+  sample.qy = transform.rotation.y;
+  sample.qz = transform.rotation.z;
+  sample.qw = transform.rotation.w;
+  capture_.addSample(sample);
 }
@@ -0,0 +1,303 @@
+#include "aerial_autonomy/log/record_schema.h"
+
+#include <boost/algorithm/string/join.hpp>
+
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+/**
+ * @brief Characters that cannot appear in field names
+ */
+const char reserved_characters[] = "[]<>|";
+
+/**
+ * @brief Parse a size of a field declaration
+ * @param text Size text
+ * @param declaration Declaration for error messages
+ * @return The size
+ */
+size_t parseSize(const std::string &text, const std::string &declaration) {
+  if (text.empty() ||
+      text.find_first_not_of("0123456789") != std::string::npos) {
+    throw std::runtime_error("Invalid size in field declaration: " +
+                             declaration);
+  }
+  return std::stoul(text);
+}
+
+/**
+ * @brief Parse a field declaration other than a tagged union
+ */
+RecordFieldType parseUntagged(const std::string &declaration) {
+  RecordFieldType type;
+  type.rows = 1;
+  type.cols = 1;
+  size_t bracket = declaration.find('[');
+  type.name = declaration.substr(0, bracket);
+  if (type.name.empty() ||
+      type.name.find_first_of(reserved_characters) != std::string::npos) {
+    throw std::runtime_error("Invalid field name in declaration: " +
+                             declaration);
+  }
+  if (bracket == std::string::npos) {
+    type.kind = RecordFieldType::Scalar;
+    return type;
+  }
+  if (declaration.back() != ']') {
+    throw std::runtime_error("Missing ] in field declaration: " +
+                             declaration);
+  }
+  std::string dimensions =
+      declaration.substr(bracket + 1, declaration.size() - bracket - 2);
+  size_t separator = dimensions.find('x');
+  if (dimensions.empty()) {
+    type.kind = RecordFieldType::Variable;
+  } else if (separator == std::string::npos) {
+    type.kind = RecordFieldType::Fixed;
+    type.rows = parseSize(dimensions, declaration);
+  } else {
+    std::string rows = dimensions.substr(0, separator);
+    type.cols = parseSize(dimensions.substr(separator + 1), declaration);
+    if (rows == "?") {
+      type.kind = RecordFieldType::Variable;
+    } else {
+      type.kind = RecordFieldType::Fixed;
+      type.rows = parseSize(rows, declaration);
+    }
+  }
+  return type;
+}
+
+/**
+ * @brief Read a field from the values of a data point
+ * @param type Field type
+ * @param values Values of the data point
+ * @param offset Offset of the field, advanced past the field
+ * @param field Returns the field values if not null
+ * @return False if the values do not match the field type
+ */
+bool readField(const RecordFieldType &type, const std::vector<double> &values,
+               size_t &offset, RecordField *field) {
+  size_t rows = type.rows;
+  if (type.kind == RecordFieldType::Variable ||
+      type.kind == RecordFieldType::Tagged) {
+    if (offset >= values.size()) {
+      return false;
+    }
+    double count = values[offset++];
+    if (!(count >= 0) || count > values.size() ||
+        count != std::floor(count)) {
+      return false;
+    }
+    if (type.kind == RecordFieldType::Tagged) {
+      if (count >= type.alternatives.size()) {
+        return false;
+      }
+      if (field) {
+        field->tag = count;
+      }
+      return readField(type.alternatives[count], values, offset, field);
+    }
+    rows = count;
+  }
+  if (rows * type.cols > values.size() - offset) {
+    return false;
+  }
+  if (field) {
+    field->name = type.name;
+    field->value.resize(rows, type.cols);
+    for (size_t i = 0; i < rows; ++i) {
+      for (size_t j = 0; j < type.cols; ++j) {
+        field->value(i, j) = values[offset + i * type.cols + j];
+      }
+    }
+  }
+  offset += rows * type.cols;
+  return true;
+}
+}
+
+RecordFieldType RecordFieldType::parse(const std::string &declaration) {
+  size_t angle = declaration.find('<');
+  if (angle == std::string::npos) {
+    return parseUntagged(declaration);
+  }
+  if (declaration.back() != '>') {
+    throw std::runtime_error("Missing > in field declaration: " +
+                             declaration);
+  }
+  RecordFieldType type = parseUntagged(declaration.substr(0, angle));
+  if (type.kind != Scalar) {
+    throw std::runtime_error("Invalid tagged union declaration: " +
+                             declaration);
+  }
+  type.kind = Tagged;
+  std::string alternatives =
+      declaration.substr(angle + 1, declaration.size() - angle - 2);
+  size_t last = 0;
+  size_t next = 0;
+  do {
+    next = alternatives.find('|', last);
+    type.alternatives.push_back(
+        parseUntagged(alternatives.substr(last, next - last)));
+    last = next + 1;
+  } while (next != std::string::npos);
+  return type;
+}
+
+std::string RecordFieldType::declaration() const {
+  switch (kind) {
+  case Scalar:
+    return name;
+  case Fixed:
+    return cols == 1 ? record_fields::array(name, rows)
+                     : record_fields::matrix(name, rows, cols);
+  case Variable:
+    return record_fields::variable(name, cols);
+  case Tagged: {
+    std::vector<std::string> declarations;
+    for (const auto &alternative : alternatives) {
+      declarations.push_back(alternative.declaration());
+    }
+    return record_fields::tagged(name, declarations);
+  }
+  }
+  return name;
+}
+
+RecordSchema::RecordSchema() {}
+
+RecordSchema::RecordSchema(const std::vector<std::string> &columns) {
+  for (const auto &column : columns) {
+    fields_.push_back(RecordFieldType::parse(column));
+  }
+}
+
+const std::vector<RecordFieldType> &RecordSchema::fields() const {
+  return fields_;
+}
+
+bool RecordSchema::hasField(const std::string &name) const {
+  return fieldIndex(name) < fields_.size();
+}
+
+bool RecordSchema::fixedSize() const {
+  for (const auto &field : fields_) {
+    if (field.kind == RecordFieldType::Variable ||
+        field.kind == RecordFieldType::Tagged) {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t RecordSchema::size() const {
+  size_t size = 0;
+  for (const auto &field : fields_) {
+    size += field.rows * field.cols;
+  }
+  return size;
+}
+
+size_t RecordSchema::valueOffset(const std::string &name) const {
+  size_t index = fieldIndex(name);
+  if (index == fields_.size()) {
+    throw std::runtime_error("No field " + name);
+  }
+  size_t offset = 0;
+  for (size_t i = 0; i < index; ++i) {
+    if (fields_[i].kind == RecordFieldType::Variable ||
+        fields_[i].kind == RecordFieldType::Tagged) {
+      throw std::runtime_error("Field " + name +
+                               " follows the variable size field " +
+                               fields_[i].name);
+    }
+    offset += fields_[i].rows * fields_[i].cols;
+  }
+  return offset;
+}
+
+std::vector<std::string> RecordSchema::valueNames() const {
+  if (!fixedSize()) {
+    throw std::runtime_error("Values of variable size fields have no names");
+  }
+  std::vector<std::string> names;
+  for (const auto &field : fields_) {
+    if (field.kind == RecordFieldType::Scalar) {
+      names.push_back(field.name);
+      continue;
+    }
+    for (size_t i = 0; i < field.rows; ++i) {
+      for (size_t j = 0; j < field.cols; ++j) {
+        std::string name = field.name + "_" + std::to_string(i);
+        names.push_back(field.cols == 1 ? name
+                                        : name + "_" + std::to_string(j));
+      }
+    }
+  }
+  return names;
+}
+
+bool RecordSchema::matches(const std::vector<double> &values) const {
+  size_t offset = 0;
+  for (const auto &field : fields_) {
+    if (!readField(field, values, offset, nullptr)) {
+      return false;
+    }
+  }
+  return offset == values.size();
+}
+
+std::vector<RecordField> RecordSchema::decode(
+    const std::vector<double> &values) const {
+  std::vector<RecordField> fields(fields_.size());
+  size_t offset = 0;
+  for (size_t i = 0; i < fields_.size(); ++i) {
+    fields[i].tag = -1;
+    if (!readField(fields_[i], values, offset, &fields[i])) {
+      throw std::runtime_error("Data point does not match field " +
+                               fields_[i].name);
+    }
+  }
+  if (offset != values.size()) {
+    throw std::runtime_error("Data point has more values than its fields");
+  }
+  return fields;
+}
+
+RecordField RecordSchema::field(const std::vector<double> &values,
+                                const std::string &name) const {
+  size_t index = fieldIndex(name);
+  if (index == fields_.size()) {
+    throw std::runtime_error("No field " + name);
+  }
+  return decode(values)[index];
+}
+
+size_t RecordSchema::fieldIndex(const std::string &name) const {
+  size_t index = 0;
+  while (index < fields_.size() && fields_[index].name != name) {
+    ++index;
+  }
+  return index;
+}
+
+namespace record_fields {
+std::string array(const std::string &name, size_t size) {
+  return name + "[" + std::to_string(size) + "]";
+}
+
+std::string matrix(const std::string &name, size_t rows, size_t cols) {
+  return name + "[" + std::to_string(rows) + "x" + std::to_string(cols) + "]";
+}
+
+std::string variable(const std::string &name, size_t cols) {
+  return cols == 1 ? name + "[]" : name + "[?x" + std::to_string(cols) + "]";
+}
+
+std::string tagged(const std::string &name,
+                   const std::vector<std::string> &alternatives) {
+  return name + "<" + boost::algorithm::join(alternatives, "|") + ">";
+}
+}
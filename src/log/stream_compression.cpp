@@ -0,0 +1,484 @@
+#include "aerial_autonomy/log/stream_compression.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+/**
+ * @brief Identifies compressed streams and their format version
+ */
+const char compressed_magic[8] = {'A', 'A', 'L', 'O', 'G', 'Z', 'D', '1'};
+
+/**
+ * @brief Record holding the text of a header
+ */
+const char header_record = 'H';
+
+/**
+ * @brief Record holding a block of data points
+ */
+const char block_record = 'B';
+
+/**
+ * @brief Number of bits used to store a code width
+ */
+const int width_bits = 7;
+
+/**
+ * @brief Code width marking a value stored as raw double bits
+ */
+const int raw_width = 127;
+
+/**
+ * @brief Quantized values beyond this magnitude are stored raw
+ */
+const double max_quantized = 4.0e18;
+
+/**
+ * @brief Append a value to a binary buffer
+ */
+template <class T> void appendBinary(std::string &output, const T &value) {
+  output.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+/**
+ * @brief Read a value from a binary stream
+ */
+template <class T> bool readBinary(std::istream &input, T &value) {
+  return bool(input.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+/**
+ * @brief Map signed values to unsigned values with small magnitudes for
+ * small signed values
+ */
+uint64_t zigzag(uint64_t value) { return (value << 1) ^ (0 - (value >> 63)); }
+
+/**
+ * @brief Inverse of zigzag
+ */
+uint64_t unzigzag(uint64_t value) { return (value >> 1) ^ (0 - (value & 1)); }
+
+/**
+ * @brief Number of bits needed to store a value
+ */
+int bitWidth(uint64_t value) {
+  return value == 0 ? 0 : 64 - __builtin_clzll(value);
+}
+
+/**
+ * @brief Bits of a double
+ */
+uint64_t doubleBits(double value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+/**
+ * @brief Double with the given bits
+ */
+double bitsDouble(uint64_t bits) {
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/**
+ * @brief Write a code reusing the previous width when the code fits and does
+ * not waste more bits than a new width costs
+ * @param code Code to write
+ * @param width Previous width, updated when a new width is written
+ * @param writer Writer for the bits
+ */
+void writeCode(uint64_t code, int &width, BitWriter &writer) {
+  int code_width = bitWidth(code);
+  if (code_width <= width && width - code_width < width_bits) {
+    writer.writeBit(false);
+  } else {
+    writer.writeBit(true);
+    writer.write(code_width, width_bits);
+    width = code_width;
+  }
+  if (width > 0) {
+    writer.write(code, width);
+  }
+}
+
+/**
+ * @brief Read a code written by writeCode. Returns false when the code is a
+ * raw value marker
+ */
+bool readCode(uint64_t &code, int &width, BitReader &reader) {
+  if (reader.readBit()) {
+    int code_width = reader.read(width_bits);
+    if (code_width == raw_width) {
+      return false;
+    }
+    if (code_width > 64) {
+      throw std::runtime_error("Invalid code width in compressed stream");
+    }
+    width = code_width;
+  }
+  code = width > 0 ? reader.read(width) : 0;
+  return true;
+}
+}
+
+BitWriter::BitWriter() : current_(0), used_(0) {}
+
+void BitWriter::write(uint64_t value, int bits) {
+  while (bits > 0) {
+    int count = std::min(bits, 8 - used_);
+    bits -= count;
+    uint8_t chunk = (value >> bits) & ((1u << count) - 1);
+    current_ |= chunk << (8 - used_ - count);
+    used_ += count;
+    if (used_ == 8) {
+      bytes_.push_back(current_);
+      current_ = 0;
+      used_ = 0;
+    }
+  }
+}
+
+void BitWriter::writeBit(bool bit) { write(bit, 1); }
+
+bool BitWriter::empty() const { return bytes_.empty() && used_ == 0; }
+
+void BitWriter::flush(std::string &output) {
+  if (used_ > 0) {
+    bytes_.push_back(current_);
+  }
+  output.append(bytes_);
+  bytes_.clear();
+  current_ = 0;
+  used_ = 0;
+}
+
+BitReader::BitReader(const char *data, size_t size)
+    : data_(reinterpret_cast<const uint8_t *>(data)), size_(size),
+      position_(0) {}
+
+uint64_t BitReader::read(int bits) {
+  if (position_ + bits > 8 * size_) {
+    throw std::runtime_error("Read past the end of a compressed block");
+  }
+  uint64_t value = 0;
+  while (bits > 0) {
+    int used = position_ % 8;
+    int count = std::min(bits, 8 - used);
+    uint8_t chunk = (data_[position_ / 8] >> (8 - used - count)) &
+                    ((1u << count) - 1);
+    value = (value << count) | chunk;
+    position_ += count;
+    bits -= count;
+  }
+  return value;
+}
+
+bool BitReader::readBit() { return read(1); }
+
+StreamCodec::StreamCodec(DataStreamConfig::Compression compression,
+                         double quantization)
+    : compression_(compression), quantization_(quantization) {
+  CHECK(compression_ != DataStreamConfig::NONE)
+      << "Codec needs a compression";
+  CHECK_GT(quantization_, 0) << "Quantization step must be positive";
+  reset();
+}
+
+void StreamCodec::reset() {
+  previous_timestamp_ = 0;
+  previous_delta_ = 0;
+  timestamp_width_ = 0;
+  columns_.clear();
+}
+
+void StreamCodec::resize(size_t count) {
+  // No XOR window fits the initial leading zeros so the first XOR stores one
+  columns_.resize(count, ColumnState{0, 64, 0, 0, 0});
+}
+
+void StreamCodec::encode(int64_t timestamp, const double *values,
+                         size_t count, BitWriter &writer) {
+  // Number of values: '0' if the same as the previous data point
+  if (count == columns_.size()) {
+    writer.writeBit(false);
+  } else {
+    writer.writeBit(true);
+    writer.write(count, 32);
+  }
+  // Unsigned arithmetic wraps so any timestamp can be encoded
+  uint64_t delta = uint64_t(timestamp) - previous_timestamp_;
+  writeCode(zigzag(delta - previous_delta_), timestamp_width_, writer);
+  previous_timestamp_ = timestamp;
+  previous_delta_ = delta;
+  resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    if (compression_ == DataStreamConfig::XOR) {
+      encodeXor(values[i], columns_[i], writer);
+    } else {
+      encodeQuantized(values[i], columns_[i], writer);
+    }
+  }
+}
+
+void StreamCodec::decode(BitReader &reader, int64_t &timestamp,
+                         std::vector<double> &values) {
+  size_t count = columns_.size();
+  if (reader.readBit()) {
+    count = reader.read(32);
+  }
+  uint64_t dod;
+  if (!readCode(dod, timestamp_width_, reader)) {
+    throw std::runtime_error("Invalid timestamp in compressed stream");
+  }
+  previous_delta_ += unzigzag(dod);
+  previous_timestamp_ += previous_delta_;
+  timestamp = previous_timestamp_;
+  resize(count);
+  values.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    if (compression_ == DataStreamConfig::XOR) {
+      values[i] = decodeXor(columns_[i], reader);
+    } else {
+      values[i] = decodeQuantized(columns_[i], reader);
+    }
+  }
+}
+
+void StreamCodec::encodeXor(double value, ColumnState &state,
+                            BitWriter &writer) {
+  uint64_t bits = doubleBits(value);
+  uint64_t xor_bits = bits ^ state.bits;
+  state.bits = bits;
+  if (xor_bits == 0) {
+    writer.writeBit(false);
+    return;
+  }
+  writer.writeBit(true);
+  int leading = std::min(__builtin_clzll(xor_bits), 31);
+  int trailing = __builtin_ctzll(xor_bits);
+  if (leading >= state.leading && trailing >= state.trailing) {
+    // Meaningful bits fit in the previous window
+    writer.writeBit(false);
+    writer.write(xor_bits >> state.trailing,
+                 64 - state.leading - state.trailing);
+  } else {
+    writer.writeBit(true);
+    int meaningful = 64 - leading - trailing;
+    writer.write(leading, 5);
+    writer.write(meaningful - 1, 6);
+    writer.write(xor_bits >> trailing, meaningful);
+    state.leading = leading;
+    state.trailing = trailing;
+  }
+}
+
+double StreamCodec::decodeXor(ColumnState &state, BitReader &reader) {
+  if (reader.readBit()) {
+    if (reader.readBit()) {
+      state.leading = reader.read(5);
+      int meaningful = reader.read(6) + 1;
+      state.trailing = 64 - state.leading - meaningful;
+      if (state.trailing < 0) {
+        throw std::runtime_error("Invalid value in compressed stream");
+      }
+    } else if (state.leading + state.trailing >= 64) {
+      throw std::runtime_error("Invalid value in compressed stream");
+    }
+    uint64_t xor_bits = reader.read(64 - state.leading - state.trailing);
+    state.bits ^= xor_bits << state.trailing;
+  }
+  return bitsDouble(state.bits);
+}
+
+void StreamCodec::encodeQuantized(double value, ColumnState &state,
+                                  BitWriter &writer) {
+  double scaled = value / quantization_;
+  if (!(std::abs(scaled) < max_quantized)) {
+    // Infinite, NaN or too large to quantize; the previous value is kept
+    writer.writeBit(true);
+    writer.write(raw_width, width_bits);
+    writer.write(doubleBits(value), 64);
+    return;
+  }
+  uint64_t quantized = std::llround(scaled);
+  writeCode(zigzag(quantized - state.quantized), state.width, writer);
+  state.quantized = quantized;
+}
+
+double StreamCodec::decodeQuantized(ColumnState &state, BitReader &reader) {
+  uint64_t code;
+  if (!readCode(code, state.width, reader)) {
+    return bitsDouble(reader.read(64));
+  }
+  state.quantized += unzigzag(code);
+  return int64_t(state.quantized) * quantization_;
+}
+
+StreamCompressor::StreamCompressor(const DataStreamConfig &config)
+    : config_(config), codec_(config.compression(), config.quantization()),
+      block_count_(0) {}
+
+void StreamCompressor::start(std::string &output) {
+  codec_.reset();
+  writer_.flush(block_);
+  block_.clear();
+  block_count_ = 0;
+  output.append(compressed_magic, sizeof(compressed_magic));
+  appendBinary(output, uint8_t(config_.compression()));
+  appendBinary(output, config_.quantization());
+  appendBinary(output, int32_t(config_.precision()));
+  appendBinary(output, uint32_t(config_.delimiter().size()));
+  output.append(config_.delimiter());
+}
+
+void StreamCompressor::addHeader(const std::string &header,
+                                 std::string &output) {
+  flush(output);
+  codec_.reset();
+  output.push_back(header_record);
+  appendBinary(output, uint32_t(header.size()));
+  output.append(header);
+}
+
+void StreamCompressor::addDataPoint(int64_t timestamp, const double *values,
+                                    size_t count) {
+  codec_.encode(timestamp, values, count, writer_);
+  ++block_count_;
+}
+
+void StreamCompressor::flush(std::string &output) {
+  if (block_count_ == 0) {
+    return;
+  }
+  writer_.flush(block_);
+  output.push_back(block_record);
+  appendBinary(output, block_count_);
+  appendBinary(output, uint32_t(block_.size()));
+  output.append(block_);
+  block_.clear();
+  block_count_ = 0;
+}
+
+CompressedStreamReader::CompressedStreamReader(std::istream &input)
+    : input_(input), precision_(0), block_remaining_(0), is_header_(false) {
+  char magic[sizeof(compressed_magic)];
+  uint8_t compression;
+  double quantization;
+  int32_t precision;
+  uint32_t delimiter_size;
+  if (!input_.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, compressed_magic, sizeof(magic)) != 0 ||
+      !readBinary(input_, compression) || !readBinary(input_, quantization) ||
+      !readBinary(input_, precision) || !readBinary(input_, delimiter_size) ||
+      !DataStreamConfig::Compression_IsValid(compression) ||
+      compression == DataStreamConfig::NONE || !(quantization > 0)) {
+    throw std::runtime_error("Not a compressed data stream");
+  }
+  delimiter_.resize(delimiter_size);
+  if (!input_.read(&delimiter_[0], delimiter_size)) {
+    throw std::runtime_error("Not a compressed data stream");
+  }
+  precision_ = precision;
+  codec_.reset(new StreamCodec(
+      DataStreamConfig::Compression(compression), quantization));
+  record_.segment = -1;
+}
+
+bool CompressedStreamReader::isCompressed(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  char magic[sizeof(compressed_magic)];
+  return file.read(magic, sizeof(magic)) &&
+         std::memcmp(magic, compressed_magic, sizeof(magic)) == 0;
+}
+
+bool CompressedStreamReader::next() {
+  while (block_remaining_ == 0) {
+    if (!readRecord()) {
+      return false;
+    }
+    if (is_header_) {
+      return true;
+    }
+  }
+  codec_->decode(*reader_, record_.timestamp, record_.values);
+  --block_remaining_;
+  return true;
+}
+
+bool CompressedStreamReader::readRecord() {
+  char type;
+  if (!input_.get(type)) {
+    return false;
+  }
+  uint32_t size;
+  if (type == header_record) {
+    if (!readBinary(input_, size)) {
+      LOG(WARNING) << "Truncated header in compressed data stream";
+      return false;
+    }
+    header_.resize(size);
+    if (size > 0 && !input_.read(&header_[0], size)) {
+      LOG(WARNING) << "Truncated header in compressed data stream";
+      return false;
+    }
+    codec_->reset();
+    ++record_.segment;
+    is_header_ = true;
+  } else if (type == block_record) {
+    if (!readBinary(input_, block_remaining_) || !readBinary(input_, size)) {
+      LOG(WARNING) << "Truncated block in compressed data stream";
+      block_remaining_ = 0;
+      return false;
+    }
+    block_.resize(size);
+    if (size > 0 && !input_.read(&block_[0], size)) {
+      LOG(WARNING) << "Truncated block in compressed data stream";
+      block_remaining_ = 0;
+      return false;
+    }
+    reader_.reset(new BitReader(block_.data(), block_.size()));
+    is_header_ = false;
+  } else {
+    throw std::runtime_error("Invalid record in compressed data stream");
+  }
+  return true;
+}
+
+bool CompressedStreamReader::isHeader() const { return is_header_; }
+
+const std::string &CompressedStreamReader::header() const { return header_; }
+
+const LogRecord &CompressedStreamReader::record() const { return record_; }
+
+const std::string &CompressedStreamReader::delimiter() const {
+  return delimiter_;
+}
+
+int CompressedStreamReader::precision() const { return precision_; }
+
+void decompressStream(std::istream &input, std::ostream &output,
+                      int precision) {
+  CompressedStreamReader reader(input);
+  output.precision(precision < 0 ? reader.precision() : precision);
+  while (reader.next()) {
+    if (reader.isHeader()) {
+      output << reader.header() << '\n';
+      continue;
+    }
+    const LogRecord &record = reader.record();
+    output << record.timestamp;
+    for (double value : record.values) {
+      output << reader.delimiter() << value;
+    }
+    output << '\n';
+  }
+}
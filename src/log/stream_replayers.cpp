@@ -0,0 +1,76 @@
+#include "aerial_autonomy/log/stream_replayers.h"
+
+ThrustGainEstimatorReplayer::ThrustGainEstimatorReplayer(
+    ThrustGainEstimatorConfig config)
+    : config_(config) {
+  // Recorded thrust commands are already delayed
+  config_.set_buffer_size(1);
+}
+
+std::vector<std::string> ThrustGainEstimatorReplayer::outputColumns() const {
+  return {"thrust_gain"};
+}
+
+void ThrustGainEstimatorReplayer::initialize(const RecordedStream &stream) {
+  roll_index_ = stream.columnIndex("roll");
+  pitch_index_ = stream.columnIndex("pitch");
+  body_z_acc_index_ = stream.columnIndex("body_z_acc");
+  thrust_command_index_ = stream.columnIndex("thrust_command");
+}
+
+void ThrustGainEstimatorReplayer::reset() {
+  estimator_.reset(new ThrustGainEstimator(config_));
+}
+
+void ThrustGainEstimatorReplayer::step(const std::vector<double> &values,
+                                       std::vector<double> &outputs) {
+  estimator_->addThrustCommand(values[thrust_command_index_]);
+  estimator_->addSensorData(values[roll_index_], values[pitch_index_],
+                            values[body_z_acc_index_]);
+  outputs[0] = estimator_->getThrustGain();
+}
+
+RPYTBasedVelocityControllerReplayer::RPYTBasedVelocityControllerReplayer(
+    RPYTBasedVelocityControllerConfig config,
+    std::chrono::duration<double> controller_timer_duration)
+    : config_(config), controller_timer_duration_(controller_timer_duration) {}
+
+std::vector<std::string>
+RPYTBasedVelocityControllerReplayer::outputColumns() const {
+  return {"Roll_cmd", "Pitch_cmd", "Yawrate_cmd", "Thrust_cmd"};
+}
+
+void RPYTBasedVelocityControllerReplayer::initialize(
+    const RecordedStream &stream) {
+  velocity_indices_.clear();
+  goal_indices_.clear();
+  for (auto column : {"Vx", "Vy", "Vz", "Yawrate"}) {
+    velocity_indices_.push_back(stream.columnIndex(column));
+  }
+  for (auto column : {"Goalvx", "Goalvy", "Goalvz", "Goalvyawrate"}) {
+    goal_indices_.push_back(stream.columnIndex(column));
+  }
+  yaw_index_ = stream.columnIndex("Yaw");
+}
+
+void RPYTBasedVelocityControllerReplayer::reset() {
+  controller_.reset(new RPYTBasedVelocityController(
+      config_, controller_timer_duration_));
+}
+
+void RPYTBasedVelocityControllerReplayer::step(
+    const std::vector<double> &values, std::vector<double> &outputs) {
+  VelocityYawRate velocity_yawrate(
+      values[velocity_indices_[0]], values[velocity_indices_[1]],
+      values[velocity_indices_[2]], values[velocity_indices_[3]]);
+  controller_->setGoal(VelocityYawRate(
+      values[goal_indices_[0]], values[goal_indices_[1]],
+      values[goal_indices_[2]], values[goal_indices_[3]]));
+  RollPitchYawRateThrust control;
+  controller_->run(std::make_tuple(velocity_yawrate, values[yaw_index_]),
+                   control);
+  outputs[0] = control.r;
+  outputs[1] = control.p;
+  outputs[2] = control.y;
+  outputs[3] = control.t;
+}
@@ -0,0 +1,96 @@
+#include "aerial_autonomy/sensors/mocap_capture.h"
+#include "aerial_autonomy/log/log.h"
+
+#include <glog/logging.h>
+
+#include <cmath>
+
+MocapCapture::MocapCapture(MocapCaptureConfig config,
+                           TimerExecutor *executor)
+    : config_(config), log_(Log::instance()),
+      buffer_(config.buffer_capacity()), latest_(MocapSample()), received_(0),
+      dropped_(0), missed_(0), written_(0), last_sequence_(0),
+      decimation_count_(0), reported_dropped_(0),
+      write_timer_(std::bind(&MocapCapture::write, this),
+                   std::chrono::milliseconds(config.write_duration()),
+                   executor) {
+  CHECK_GT(config_.decimation(), 0u) << "Mocap decimation should be positive";
+  if (!log_.hasDataStream(config_.stream_id())) {
+    DataStreamConfig stream_config;
+    stream_config.set_stream_id(config_.stream_id());
+    stream_config.set_compression(DataStreamConfig::XOR);
+    log_.addDataStream(stream_config);
+  }
+  log_[config_.stream_id()] << DataStream::starth << "X"
+                            << "Y"
+                            << "Z"
+                            << "Qx"
+                            << "Qy"
+                            << "Qz"
+                            << "Qw"
+                            << "Receive_time" << DataStream::endl;
+  write_timer_.start();
+}
+
+MocapCapture::~MocapCapture() {
+  write_timer_.stop();
+  write();
+}
+
+void MocapCapture::addSample(const MocapSample &sample) {
+  if (received_ > 0 && sample.sequence > last_sequence_ + 1) {
+    missed_ += sample.sequence - last_sequence_ - 1;
+  }
+  last_sequence_ = sample.sequence;
+  latest_ = sample;
+  if (!buffer_.push(sample)) {
+    ++dropped_;
+  }
+  ++received_;
+}
+
+void MocapCapture::write() {
+  DataStream &stream = log_[config_.stream_id()];
+  MocapSample sample;
+  while (buffer_.pop(sample)) {
+    if (decimation_count_++ % config_.decimation() != 0) {
+      continue;
+    }
+    stream.startAt(sample.source_time)
+        << sample.x << sample.y << sample.z << sample.qx << sample.qy
+        << sample.qz << sample.qw << sample.receive_time << DataStream::endl;
+    ++written_;
+  }
+  uint64_t dropped = dropped_;
+  if (dropped > reported_dropped_) {
+    LOG(WARNING) << "Mocap buffer full, dropped "
+                 << dropped - reported_dropped_ << " poses";
+    reported_dropped_ = dropped;
+  }
+}
+
+MocapCaptureStatistics MocapCapture::statistics() const {
+  return MocapCaptureStatistics{received_, dropped_, missed_, written_};
+}
+
+PositionYaw MocapCapture::getSensorData() {
+  MocapSample sample = latest_;
+  double yaw =
+      std::atan2(2 * (sample.qw * sample.qz + sample.qx * sample.qy),
+                 1 - 2 * (sample.qy * sample.qy + sample.qz * sample.qz));
+  return PositionYaw(sample.x, sample.y, sample.z, yaw);
+}
+
+SensorStatus MocapCapture::getSensorStatus() {
+  if (received_ == 0) {
+    return SensorStatus::INVALID;
+  }
+  std::chrono::duration<double> age =
+      timebase::Clock::now() - latest_.get().receive_time;
+  return age.count() > config_.timeout() ? SensorStatus::INVALID
+                                         : SensorStatus::VALID;
+}
+
+timebase::TimePoint MocapCapture::getSensorTime() {
+  return latest_.get().source_time;
+}
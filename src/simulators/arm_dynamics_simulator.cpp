@@ -0,0 +1,398 @@
+#include "aerial_autonomy/simulators/arm_dynamics_simulator.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace {
+/**
+ * @brief Add a joint to the default arm
+ */
+void addJoint(ArmDynamicsSimulatorConfig &config,
+              ArmDynamicsSimulatorConfig::JointConfig::Axis axis, double x,
+              double limit, double folded_angle, double right_angle) {
+  auto joint_config = config.add_joint_config();
+  joint_config->set_axis(axis);
+  joint_config->mutable_translation()->set_x(x);
+  joint_config->set_min_angle(-limit);
+  joint_config->set_max_angle(limit);
+  joint_config->set_folded_angle(folded_angle);
+  joint_config->set_right_angle(right_angle);
+}
+}
+
+ArmDynamicsSimulator::ArmDynamicsSimulator(ArmDynamicsSimulatorConfig config)
+    : config_(withDefaultArm(config)), dt_(config_.integration_step()),
+      n_(config_.joint_config_size()), kinematics_(kinematicsConfig(config_)),
+      jacobian_(6, n_), steps_(0),
+      powered_(false), enabled_(false), enable_steps_(0), task_(Task::None),
+      q_(Eigen::VectorXd::Zero(n_)), q_dot_(Eigen::VectorXd::Zero(n_)),
+      q_target_(Eigen::VectorXd::Zero(n_)),
+      pose_target_(Eigen::Matrix4d::Identity()), gripper_(Gripper::Open),
+      gripper_remaining_(0), has_object_(false), holding_(false),
+      object_pose_(Eigen::Matrix4d::Identity()),
+      grasp_offset_(Eigen::Matrix4d::Identity()), generator_(config_.seed()),
+      uniform_(0.0, 1.0) {
+  CHECK_GT(dt_, 0) << "Integration step should be positive";
+  if (config_.joint_model() == ArmDynamicsSimulatorConfig::FIRST_ORDER) {
+    CHECK_GT(config_.time_constant(), 0) << "Time constant should be positive";
+  } else {
+    CHECK_GT(config_.natural_frequency(), 0)
+        << "Natural frequency should be positive";
+  }
+  CHECK_GE(config_.power_on_duration(), 0)
+      << "Power on duration should not be negative";
+  CHECK_GT(config_.grip_position_stddev(), 0)
+      << "Grip position stddev should be positive";
+  CHECK_GT(config_.grip_orientation_stddev(), 0)
+      << "Grip orientation stddev should be positive";
+  for (int i = 0; i < n_; ++i) {
+    const auto &joint_config = config_.joint_config(i);
+    CHECK_GT(joint_config.max_velocity(), 0)
+        << "Joint " << i << " maximum velocity should be positive";
+    CHECK_GT(joint_config.max_acceleration(), 0)
+        << "Joint " << i << " maximum acceleration should be positive";
+  }
+  // Start inside the joint limits
+  q_ = q_.cwiseMax(kinematics_.minAngles()).cwiseMin(kinematics_.maxAngles());
+  q_target_ = q_;
+  pose_target_ = kinematics_.forwardKinematics(q_);
+}
+
+ArmKinematicsConfig
+ArmDynamicsSimulator::kinematicsConfig(ArmDynamicsSimulatorConfig config) {
+  config = withDefaultArm(config);
+  ArmKinematicsConfig kinematics_config;
+  for (const auto &joint_config : config.joint_config()) {
+    auto kinematics_joint_config = kinematics_config.add_joint_config();
+    kinematics_joint_config->set_axis(
+        static_cast<ArmKinematicsConfig::JointConfig::Axis>(
+            joint_config.axis()));
+    *kinematics_joint_config->mutable_translation() =
+        joint_config.translation();
+    kinematics_joint_config->set_min_angle(joint_config.min_angle());
+    kinematics_joint_config->set_max_angle(joint_config.max_angle());
+  }
+  *kinematics_config.mutable_end_effector_translation() =
+      config.end_effector_translation();
+  return kinematics_config;
+}
+
+ArmDynamicsSimulatorConfig
+ArmDynamicsSimulator::withDefaultArm(ArmDynamicsSimulatorConfig config) {
+  if (config.joint_config_size() > 0) {
+    return config;
+  }
+  // Base yaw, shoulder and elbow pitch and a spherical wrist, stretched along
+  // x at zero angles
+  using JointConfig = ArmDynamicsSimulatorConfig::JointConfig;
+  addJoint(config, JointConfig::Z, 0.0, 3.14, 0.0, 0.0);
+  addJoint(config, JointConfig::Y, 0.0, 1.6, -1.2, 0.0);
+  addJoint(config, JointConfig::Y, 0.2, 2.6, 2.5, M_PI / 2);
+  addJoint(config, JointConfig::X, 0.2, 3.14, 0.0, 0.0);
+  addJoint(config, JointConfig::Y, 0.0, 1.8, 0.0, 0.0);
+  addJoint(config, JointConfig::X, 0.0, 3.14, 0.0, 0.0);
+  config.mutable_end_effector_translation()->set_x(0.05);
+  return config;
+}
+
+bool ArmDynamicsSimulator::setEndEffectorPose(const Eigen::Matrix4d &pose) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!enabled_) {
+    return false;
+  }
+  if ((pose.topRightCorner<3, 1>() - kinematics_.shoulder()).norm() >
+      kinematics_.reach()) {
+    LOG(WARNING) << "End effector not in workspace";
+    return false;
+  }
+  pose_target_ = pose;
+  task_ = Task::EndEffector;
+  return true;
+}
+
+bool ArmDynamicsSimulator::setJointAngles(const std::vector<double> &angles) {
+  if (angles.size() != static_cast<size_t>(n_)) {
+    LOG(WARNING) << "Expected " << n_ << " joint angles but received "
+                 << angles.size();
+    return false;
+  }
+  Eigen::VectorXd targets =
+      Eigen::Map<const Eigen::VectorXd>(angles.data(), n_);
+  if ((targets.array() < kinematics_.minAngles().array()).any() ||
+      (targets.array() > kinematics_.maxAngles().array()).any()) {
+    LOG(WARNING) << "Joint angles outside joint limits";
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  return moveJoints(targets);
+}
+
+Eigen::Matrix4d ArmDynamicsSimulator::getEndEffectorTransform() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return kinematics_.forwardKinematics(q_);
+}
+
+std::vector<double> ArmDynamicsSimulator::getJointAngles() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return std::vector<double>(q_.data(), q_.data() + n_);
+}
+
+std::vector<double> ArmDynamicsSimulator::getJointVelocities() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return std::vector<double>(q_dot_.data(), q_dot_.data() + n_);
+}
+
+bool ArmDynamicsSimulator::grip(bool action) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!enabled_) {
+    return false;
+  }
+  task_ = Task::Gripper;
+  if (action && gripper_ != Gripper::Closed && gripper_ != Gripper::Closing) {
+    gripper_ = Gripper::Closing;
+    gripper_remaining_ = config_.gripper_close_duration();
+  } else if (!action && gripper_ != Gripper::Open &&
+             gripper_ != Gripper::Opening) {
+    gripper_ = Gripper::Opening;
+    gripper_remaining_ = config_.gripper_open_duration();
+    holding_ = false;
+  }
+  return true;
+}
+
+bool ArmDynamicsSimulator::gripStatus() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return gripper_ == Gripper::Closed && holding_;
+}
+
+bool ArmDynamicsSimulator::resetGripper() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  gripper_ = Gripper::Open;
+  gripper_remaining_ = 0;
+  holding_ = false;
+  return true;
+}
+
+bool ArmDynamicsSimulator::sendCmd(ArmParser::Command command) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Eigen::VectorXd targets(n_);
+  switch (command) {
+  case ArmParser::POWER_ON:
+    if (!powered_) {
+      powered_ = true;
+      enable_steps_ =
+          steps_ + std::llround(config_.power_on_duration() / dt_);
+      enabled_ = (enable_steps_ == steps_);
+      task_ = Task::None;
+    }
+    return true;
+  case ArmParser::POWER_OFF:
+    powered_ = false;
+    enabled_ = false;
+    task_ = Task::None;
+    // Brakes hold the joints
+    q_dot_.setZero();
+    q_target_ = q_;
+    return true;
+  case ArmParser::FOLD_ARM:
+    for (int i = 0; i < n_; ++i) {
+      targets[i] = config_.joint_config(i).folded_angle();
+    }
+    return moveJoints(targets);
+  case ArmParser::RIGHT_ARM:
+    for (int i = 0; i < n_; ++i) {
+      targets[i] = config_.joint_config(i).right_angle();
+    }
+    return moveJoints(targets);
+  }
+  return false;
+}
+
+bool ArmDynamicsSimulator::getCommandStatus() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return enabled_ && taskComplete();
+}
+
+ArmParser::State ArmDynamicsSimulator::state() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return enabled_ ? ArmParser::ENABLED : ArmParser::DISABLED;
+}
+
+void ArmDynamicsSimulator::setObjectPose(const Eigen::Matrix4d &pose) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  object_pose_ = pose;
+  has_object_ = true;
+  holding_ = false;
+}
+
+Eigen::Matrix4d ArmDynamicsSimulator::getObjectPose() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return object_pose_;
+}
+
+double ArmDynamicsSimulator::gripSuccessProbability() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return gripSuccessProbability(kinematics_.forwardKinematics(q_));
+}
+
+void ArmDynamicsSimulator::advance(std::chrono::duration<double> duration) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const uint64_t end_steps = std::max<int64_t>(
+      steps_, std::llround((steps_ * dt_ + duration.count()) / dt_));
+  while (steps_ < end_steps) {
+    step();
+    ++steps_;
+  }
+}
+
+std::chrono::duration<double> ArmDynamicsSimulator::getTime() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return std::chrono::duration<double>(steps_ * dt_);
+}
+
+ArmDynamicsSimulator::~ArmDynamicsSimulator() { stopRealTime(); }
+
+void ArmDynamicsSimulator::startRealTime(
+    std::chrono::duration<double> period) {
+  CHECK_GT(period.count(), 0) << "Real time period should be positive";
+  stopRealTime();
+  real_time_start_ = timebase::Clock::now();
+  virtual_time_start_ = getTime();
+  real_time_timer_.reset(
+      new AsyncTimer(std::bind(&ArmDynamicsSimulator::advanceToRealTime, this),
+                     period));
+  real_time_timer_->start();
+}
+
+void ArmDynamicsSimulator::stopRealTime() {
+  if (real_time_timer_) {
+    real_time_timer_->stop();
+    real_time_timer_.reset();
+  }
+}
+
+void ArmDynamicsSimulator::advanceToRealTime() {
+  // Advance to the elapsed time rather than by the timer period so that
+  // timer jitter and rounding to integration steps do not accumulate
+  advance(virtual_time_start_ + (timebase::Clock::now() - real_time_start_) -
+          getTime());
+}
+
+bool ArmDynamicsSimulator::moveJoints(const Eigen::VectorXd &targets) {
+  if (!enabled_) {
+    return false;
+  }
+  q_target_ = targets;
+  task_ = Task::Joints;
+  return true;
+}
+
+double ArmDynamicsSimulator::gripSuccessProbability(
+    const Eigen::Matrix4d &end_effector) const {
+  if (!has_object_) {
+    return 0;
+  }
+  ArmKinematics::Vector6d error =
+      ArmKinematics::poseError(end_effector, object_pose_);
+  double position_ratio =
+      error.head<3>().norm() / config_.grip_position_stddev();
+  double orientation_ratio =
+      error.tail<3>().norm() / config_.grip_orientation_stddev();
+  return config_.grip_success_probability() *
+         std::exp(-0.5 * (position_ratio * position_ratio +
+                          orientation_ratio * orientation_ratio));
+}
+
+bool ArmDynamicsSimulator::taskComplete() const {
+  const double tolerance = config_.joint_tolerance();
+  const bool stopped = q_dot_.cwiseAbs().maxCoeff() < tolerance;
+  switch (task_) {
+  case Task::None:
+    return false;
+  case Task::Joints:
+    return stopped && (q_target_ - q_).cwiseAbs().maxCoeff() < tolerance;
+  case Task::EndEffector: {
+    ArmKinematics::Vector6d error = ArmKinematics::poseError(
+        kinematics_.forwardKinematics(q_), pose_target_);
+    return stopped && error.head<3>().norm() < config_.position_tolerance() &&
+           error.tail<3>().norm() < config_.orientation_tolerance();
+  }
+  case Task::Gripper:
+    return gripper_ == Gripper::Open || gripper_ == Gripper::Closed;
+  }
+  return false;
+}
+
+void ArmDynamicsSimulator::step() {
+  if (powered_ && !enabled_ && steps_ >= enable_steps_) {
+    enabled_ = true;
+  }
+  if (enabled_) {
+    if (task_ == Task::EndEffector) {
+      // One damped least squares step towards the pose target
+      ArmKinematics::Vector6d error = ArmKinematics::poseError(
+          kinematics_.forwardKinematics(q_, jacobian_), pose_target_);
+      const double damping = config_.damping();
+      Eigen::Matrix<double, 6, 6> jjt = jacobian_ * jacobian_.transpose();
+      jjt.diagonal().array() += damping * damping;
+      q_target_ = (q_ + jacobian_.transpose() * jjt.ldlt().solve(error))
+                      .cwiseMax(kinematics_.minAngles())
+                      .cwiseMin(kinematics_.maxAngles());
+    }
+    const bool first_order =
+        config_.joint_model() == ArmDynamicsSimulatorConfig::FIRST_ORDER;
+    const double wn = config_.natural_frequency();
+    for (int i = 0; i < n_; ++i) {
+      const auto &joint_config = config_.joint_config(i);
+      const double error = q_target_[i] - q_[i];
+      if (first_order) {
+        q_dot_[i] = error / config_.time_constant();
+      } else {
+        double acceleration =
+            wn * wn * error - 2 * config_.damping_ratio() * wn * q_dot_[i];
+        acceleration =
+            std::max(-joint_config.max_acceleration(),
+                     std::min(joint_config.max_acceleration(), acceleration));
+        q_dot_[i] += acceleration * dt_;
+      }
+      q_dot_[i] = std::max(-joint_config.max_velocity(),
+                           std::min(joint_config.max_velocity(), q_dot_[i]));
+      q_[i] += q_dot_[i] * dt_;
+      // Joint stops
+      const double min_angle = kinematics_.minAngles()[i];
+      const double max_angle = kinematics_.maxAngles()[i];
+      if (q_[i] < min_angle || q_[i] > max_angle) {
+        q_[i] = std::max(min_angle, std::min(max_angle, q_[i]));
+        q_dot_[i] = 0;
+      }
+    }
+  }
+  if (gripper_ == Gripper::Closing || gripper_ == Gripper::Opening) {
+    gripper_remaining_ -= dt_;
+    if (gripper_remaining_ <= 0) {
+      if (gripper_ == Gripper::Closing) {
+        gripper_ = Gripper::Closed;
+        const Eigen::Matrix4d end_effector =
+            kinematics_.forwardKinematics(q_);
+        holding_ =
+            uniform_(generator_) < gripSuccessProbability(end_effector);
+        if (holding_) {
+          grasp_offset_ = end_effector.inverse() * object_pose_;
+        }
+      } else {
+        gripper_ = Gripper::Open;
+      }
+    }
+  }
+  if (holding_) {
+    if (config_.grip_slip_rate() > 0 &&
+        uniform_(generator_) < config_.grip_slip_rate() * dt_) {
+      holding_ = false;
+    } else {
+      object_pose_ = kinematics_.forwardKinematics(q_) * grasp_offset_;
+    }
+  }
+}
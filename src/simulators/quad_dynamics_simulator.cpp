@@ -0,0 +1,466 @@
+#include "aerial_autonomy/simulators/quad_dynamics_simulator.h"
+#include "aerial_autonomy/common/math.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+/**
+ * @brief Vector of the skew symmetric part of a matrix
+ */
+Eigen::Vector3d vee(const Eigen::Matrix3d &m) {
+  return Eigen::Vector3d(m(2, 1) - m(1, 2), m(0, 2) - m(2, 0),
+                         m(1, 0) - m(0, 1)) /
+         2.0;
+}
+
+/**
+ * @brief Orientation from ZYX euler angles
+ */
+Eigen::Matrix3d rpyToRotation(double roll, double pitch, double yaw) {
+  return (Eigen::AngleAxisd(yaw, Eigen::Vector3d::UnitZ()) *
+          Eigen::AngleAxisd(pitch, Eigen::Vector3d::UnitY()) *
+          Eigen::AngleAxisd(roll, Eigen::Vector3d::UnitX()))
+      .toRotationMatrix();
+}
+}
+
+QuadDynamicsSimulator::QuadDynamicsSimulator(QuadDynamicsSimulatorConfig config)
+    : config_(config), dt_(config.integration_step()),
+      J_(Eigen::Vector3d(config.jxx(), config.jyy(), config.jzz())
+             .asDiagonal()),
+      J_inverse_(J_.inverse()), x_(StateVector::Zero()),
+      acceleration_(Eigen::Vector3d::Zero()), steps_(0), armed_(false),
+      sdk_control_(true), rc_{0, 0, 0, 0},
+      battery_percent_(config.initial_battery_percent()),
+      mode_(Mode::PositionYaw), yaw_setpoint_(0),
+      torque_(Eigen::Vector3d::Zero()), thrust_input_(0),
+      gust_(Eigen::Vector3d::Zero()), generator_(config.seed()) {
+  CHECK_GT(config_.mass(), 0) << "Mass should be positive";
+  CHECK_GT(config_.jxx(), 0) << "Inertia should be positive";
+  CHECK_GT(config_.jyy(), 0) << "Inertia should be positive";
+  CHECK_GT(config_.jzz(), 0) << "Inertia should be positive";
+  CHECK_GT(config_.thrust_gain(), 0) << "Thrust gain should be positive";
+  CHECK_GT(dt_, 0) << "Integration step should be positive";
+  CHECK_GE(config_.motor_time_constant(), 0)
+      << "Motor time constant should not be negative";
+  CHECK_GE(config_.actuation_delay(), 0)
+      << "Actuation delay should not be negative";
+  CHECK_GT(config_.wind_gust_time_constant(), 0)
+      << "Wind gust time constant should be positive";
+  // Identity orientation
+  x_(6) = 1;
+  command_.time = 0;
+  command_.mode = mode_;
+  command_.setpoint.setZero();
+  command_.value = 0;
+  command_.thrust_torque.thrust_ddot = 0;
+  command_.thrust_torque.torque.setZero();
+}
+
+bool QuadDynamicsSimulator::takeoff() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  armed_ = true;
+  commands_.clear();
+  mode_ = Mode::PositionYaw;
+  command_.setpoint = x_.segment<3>(0);
+  command_.setpoint.z() += config_.takeoff_height();
+  command_.value = yaw();
+  return true;
+}
+
+bool QuadDynamicsSimulator::land() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  commands_.clear();
+  mode_ = Mode::Land;
+  yaw_setpoint_ = yaw();
+  return true;
+}
+
+bool QuadDynamicsSimulator::disarm() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  armed_ = false;
+  commands_.clear();
+  return true;
+}
+
+bool QuadDynamicsSimulator::flowControl(bool state) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  sdk_control_ = state;
+  return true;
+}
+
+bool QuadDynamicsSimulator::calibrateimubias() { return true; }
+
+bool QuadDynamicsSimulator::cmdrpythrust(geometry_msgs::Quaternion &rpytmsg) {
+  return queueCommand(Mode::RollPitchYawThrust,
+                      Eigen::Vector3d(rpytmsg.x, rpytmsg.y, rpytmsg.z),
+                      rpytmsg.w);
+}
+
+bool QuadDynamicsSimulator::cmdrpyawratethrust(
+    geometry_msgs::Quaternion &rpytmsg) {
+  return queueCommand(Mode::RollPitchYawRateThrust,
+                      Eigen::Vector3d(rpytmsg.x, rpytmsg.y, rpytmsg.z),
+                      rpytmsg.w);
+}
+
+bool QuadDynamicsSimulator::cmdvel_yaw_angle_guided(
+    geometry_msgs::Vector3 &vel_cmd, double &yaw_ang) {
+  return queueCommand(Mode::VelocityYaw,
+                      Eigen::Vector3d(vel_cmd.x, vel_cmd.y, vel_cmd.z),
+                      yaw_ang);
+}
+
+bool QuadDynamicsSimulator::cmdvel_yaw_rate_guided(
+    geometry_msgs::Vector3 &vel_cmd, double &yaw_rate) {
+  return queueCommand(Mode::VelocityYawRate,
+                      Eigen::Vector3d(vel_cmd.x, vel_cmd.y, vel_cmd.z),
+                      yaw_rate);
+}
+
+bool QuadDynamicsSimulator::cmdwaypoint(geometry_msgs::Vector3 &desired_pos,
+                                        double desired_yaw) {
+  return queueCommand(
+      Mode::PositionYaw,
+      Eigen::Vector3d(desired_pos.x, desired_pos.y, desired_pos.z),
+      desired_yaw);
+}
+
+bool QuadDynamicsSimulator::commandThrustTorque(
+    const QrotorBacksteppingControl &control) {
+  return queueCommand(Mode::ThrustTorque, Eigen::Vector3d::Zero(), 0, control);
+}
+
+void QuadDynamicsSimulator::reset_attitude(double roll, double pitch,
+                                           double yaw) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Eigen::Quaterniond q(rpyToRotation(roll, pitch, yaw));
+  x_.segment<4>(6) << q.w(), q.x(), q.y(), q.z();
+}
+
+void QuadDynamicsSimulator::setaltitude(double altitude_) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  x_(2) = altitude_;
+}
+
+void QuadDynamicsSimulator::setRC(int16_t channels[4]) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::copy(channels, channels + 4, rc_);
+}
+
+void QuadDynamicsSimulator::getquaddata(parsernode::common::quaddata &d1) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const Eigen::Matrix3d R = rotation();
+  auto noise = [this](double stddev) {
+    return stddev > 0 ? stddev * noise_(generator_) : 0.0;
+  };
+  d1.localpos.x = x_(0) + noise(config_.position_noise());
+  d1.localpos.y = x_(1) + noise(config_.position_noise());
+  d1.localpos.z = x_(2) + noise(config_.position_noise());
+  d1.linvel.x = x_(3) + noise(config_.velocity_noise());
+  d1.linvel.y = x_(4) + noise(config_.velocity_noise());
+  d1.linvel.z = x_(5) + noise(config_.velocity_noise());
+  // ZYX euler angles
+  d1.rpydata.x =
+      std::atan2(R(2, 1), R(2, 2)) + noise(config_.attitude_noise());
+  d1.rpydata.y = -std::asin(math::clamp(R(2, 0), -1, 1)) +
+                 noise(config_.attitude_noise());
+  d1.rpydata.z = math::angleWrap(yaw() + noise(config_.attitude_noise()));
+  d1.omega.x = x_(10) + noise(config_.angular_velocity_noise());
+  d1.omega.y = x_(11) + noise(config_.angular_velocity_noise());
+  d1.omega.z = x_(12) + noise(config_.angular_velocity_noise());
+  const Eigen::Vector3d body_acceleration = R.transpose() * acceleration_;
+  d1.linacc.x = body_acceleration.x() + noise(config_.acceleration_noise());
+  d1.linacc.y = body_acceleration.y() + noise(config_.acceleration_noise());
+  d1.linacc.z = body_acceleration.z() + noise(config_.acceleration_noise());
+  d1.altitude = d1.localpos.z;
+  d1.batterypercent = battery_percent_;
+  d1.mass = config_.mass();
+  d1.timestamp = steps_ * dt_;
+  d1.armed = armed_;
+  d1.rc_sdk_control_switch = sdk_control_;
+  for (int i = 0; i < 4; ++i) {
+    d1.servo_in[i] = rc_[i];
+  }
+  d1.quadstate = armed_ ? (sdk_control_ ? "SDK_CONTROL" : "MANUAL_CONTROL")
+                        : "DISARMED";
+}
+
+void QuadDynamicsSimulator::advance(std::chrono::duration<double> duration) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const uint64_t end_steps = std::max<int64_t>(
+      steps_, std::llround((steps_ * dt_ + duration.count()) / dt_));
+  while (steps_ < end_steps) {
+    applyCommands();
+    updateInputs();
+    integrate();
+    ++steps_;
+  }
+}
+
+std::chrono::duration<double> QuadDynamicsSimulator::getTime() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return std::chrono::duration<double>(steps_ * dt_);
+}
+
+QrotorBacksteppingState QuadDynamicsSimulator::getState() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  QrotorBacksteppingState state;
+  state.p = x_.segment<3>(0);
+  state.v = x_.segment<3>(3);
+  state.R = rotation();
+  state.w = x_.segment<3>(10);
+  state.thrust = x_(13);
+  state.thrust_dot = x_(14);
+  return state;
+}
+
+void QuadDynamicsSimulator::setState(const QrotorBacksteppingState &state,
+                                     bool armed) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Eigen::Quaterniond q(state.R);
+  q.normalize();
+  x_ << state.p, state.v, q.w(), q.x(), q.y(), q.z(), state.w, state.thrust,
+      state.thrust_dot;
+  acceleration_.setZero();
+  armed_ = armed;
+}
+
+double QuadDynamicsSimulator::getThrustGain() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return thrustGain();
+}
+
+bool QuadDynamicsSimulator::queueCommand(
+    Mode mode, const Eigen::Vector3d &setpoint, double value,
+    const QrotorBacksteppingControl &thrust_torque) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!sdk_control_ || !armed_) {
+    return false;
+  }
+  Command command;
+  command.time = steps_ * dt_ + config_.actuation_delay();
+  command.mode = mode;
+  command.setpoint = setpoint;
+  command.value = value;
+  command.thrust_torque = thrust_torque;
+  commands_.push_back(command);
+  return true;
+}
+
+void QuadDynamicsSimulator::applyCommands() {
+  // Half a step of tolerance for the rounding of the virtual clock
+  const double time = (steps_ + 0.5) * dt_;
+  while (!commands_.empty() && commands_.front().time <= time) {
+    const Command &command = commands_.front();
+    bool yaw_rate_mode = command.mode == Mode::RollPitchYawRateThrust ||
+                         command.mode == Mode::VelocityYawRate;
+    if (yaw_rate_mode && mode_ != command.mode) {
+      yaw_setpoint_ = yaw();
+    }
+    if (command.mode == Mode::ThrustTorque && mode_ != Mode::ThrustTorque) {
+      // Continue from the thrust reached by the motors
+      x_(14) = 0;
+    }
+    mode_ = command.mode;
+    command_ = command;
+    commands_.pop_front();
+  }
+}
+
+void QuadDynamicsSimulator::updateInputs() {
+  const double m = config_.mass();
+  const double g = config_.acc_gravity();
+  Eigen::Matrix3d R_d;
+  Eigen::Vector3d w_d = Eigen::Vector3d::Zero();
+  double thrust = 0;
+  bool onboard_control = true;
+  if (!armed_) {
+    onboard_control = false;
+    torque_.setZero();
+  } else {
+    switch (mode_) {
+    case Mode::RollPitchYawThrust:
+    case Mode::RollPitchYawRateThrust: {
+      thrust = m * thrustGain() * std::max(command_.value, 0.0);
+      double yaw_d = command_.setpoint.z();
+      if (mode_ == Mode::RollPitchYawRateThrust) {
+        yaw_setpoint_ += command_.setpoint.z() * dt_;
+        yaw_d = yaw_setpoint_;
+        w_d.z() = command_.setpoint.z();
+      }
+      R_d = rpyToRotation(command_.setpoint.x(), command_.setpoint.y(), yaw_d);
+      break;
+    }
+    case Mode::VelocityYaw:
+    case Mode::VelocityYawRate:
+    case Mode::PositionYaw:
+    case Mode::Land: {
+      Eigen::Vector3d velocity_d = command_.setpoint;
+      double yaw_d = command_.value;
+      if (mode_ == Mode::VelocityYawRate) {
+        yaw_setpoint_ += command_.value * dt_;
+        yaw_d = yaw_setpoint_;
+        w_d.z() = command_.value;
+      } else if (mode_ == Mode::PositionYaw) {
+        velocity_d = config_.guided_position_gain() *
+                     (command_.setpoint - x_.segment<3>(0));
+        const double speed = velocity_d.norm();
+        if (speed > config_.guided_max_velocity()) {
+          velocity_d *= config_.guided_max_velocity() / speed;
+        }
+      } else if (mode_ == Mode::Land) {
+        velocity_d = Eigen::Vector3d(0, 0, -config_.landing_velocity());
+        yaw_d = yaw_setpoint_;
+      }
+      thrust = accelerationToAttitude(config_.guided_velocity_gain() *
+                                          (velocity_d - x_.segment<3>(3)),
+                                      yaw_d, R_d);
+      break;
+    }
+    case Mode::ThrustTorque:
+      onboard_control = false;
+      torque_ = command_.thrust_torque.torque;
+      thrust_input_ = command_.thrust_torque.thrust_ddot;
+      break;
+    }
+  }
+  if (onboard_control) {
+    torque_ = attitudeTorque(R_d, w_d);
+  }
+  if (mode_ != Mode::ThrustTorque || !armed_) {
+    thrust_input_ = thrust;
+    if (config_.motor_time_constant() == 0) {
+      x_(13) = thrust;
+    }
+  }
+  // Battery drains with thrust relative to hover
+  battery_percent_ =
+      std::max(0.0, battery_percent_ -
+                        config_.battery_drain_rate() *
+                            std::max(x_(13), 0.0) / (m * g) * dt_);
+  // Gusts follow an Ornstein-Uhlenbeck process
+  if (config_.wind_gust_stddev() > 0) {
+    const double tau = config_.wind_gust_time_constant();
+    for (int i = 0; i < 3; ++i) {
+      gust_(i) += -gust_(i) * dt_ / tau +
+                  config_.wind_gust_stddev() * std::sqrt(2 * dt_ / tau) *
+                      noise_(generator_);
+    }
+  }
+}
+
+Eigen::Vector3d
+QuadDynamicsSimulator::attitudeTorque(const Eigen::Matrix3d &R_d,
+                                      const Eigen::Vector3d &w_d) const {
+  const Eigen::Matrix3d R = rotation();
+  const Eigen::Vector3d w = x_.segment<3>(10);
+  const Eigen::Vector3d e_R = vee(R_d.transpose() * R - R.transpose() * R_d);
+  const Eigen::Vector3d e_w = w - R.transpose() * R_d * w_d;
+  return J_ * (-config_.attitude_kp() * e_R - config_.attitude_kd() * e_w) +
+         w.cross(J_ * w);
+}
+
+double
+QuadDynamicsSimulator::accelerationToAttitude(Eigen::Vector3d acceleration,
+                                              double yaw,
+                                              Eigen::Matrix3d &R_d) const {
+  const double g = config_.acc_gravity();
+  // Limit tilt by limiting horizontal acceleration
+  const double max_horizontal = g * std::tan(config_.guided_max_tilt());
+  const double horizontal = acceleration.head<2>().norm();
+  if (horizontal > max_horizontal) {
+    acceleration.head<2>() *= max_horizontal / horizontal;
+  }
+  acceleration.z() = std::max(acceleration.z(), -0.5 * g);
+  const Eigen::Vector3d thrust_acceleration =
+      acceleration + Eigen::Vector3d(0, 0, g);
+  const Eigen::Vector3d b3 = thrust_acceleration.normalized();
+  const Eigen::Vector3d b1_d(std::cos(yaw), std::sin(yaw), 0);
+  const Eigen::Vector3d b2 = b3.cross(b1_d).normalized();
+  R_d.col(0) = b2.cross(b3);
+  R_d.col(1) = b2;
+  R_d.col(2) = b3;
+  // Thrust along the current body z axis
+  return config_.mass() * thrust_acceleration.dot(rotation().col(2));
+}
+
+QuadDynamicsSimulator::StateVector
+QuadDynamicsSimulator::derivative(const StateVector &x) const {
+  const double m = config_.mass();
+  const Eigen::Quaterniond q(x(6), x(7), x(8), x(9));
+  const Eigen::Vector3d v = x.segment<3>(3);
+  const Eigen::Vector3d w = x.segment<3>(10);
+  const double thrust = x(13);
+  const Eigen::Vector3d wind(config_.wind_velocity().vx() + gust_.x(),
+                             config_.wind_velocity().vy() + gust_.y(),
+                             config_.wind_velocity().vz() + gust_.z());
+  StateVector x_dot;
+  x_dot.segment<3>(0) = v;
+  x_dot.segment<3>(3) =
+      (q * Eigen::Vector3d(0, 0, thrust) +
+       config_.drag_coefficient() * (wind - v)) /
+          m -
+      Eigen::Vector3d(0, 0, config_.acc_gravity());
+  // q_dot = q * (0, w) / 2
+  const Eigen::Quaterniond q_dot = q * Eigen::Quaterniond(0, w.x(), w.y(),
+                                                          w.z());
+  x_dot.segment<4>(6) << q_dot.w() / 2, q_dot.x() / 2, q_dot.y() / 2,
+      q_dot.z() / 2;
+  x_dot.segment<3>(10) = J_inverse_ * (torque_ - w.cross(J_ * w));
+  if (armed_ && mode_ == Mode::ThrustTorque) {
+    x_dot(13) = x(14);
+    x_dot(14) = thrust_input_;
+  } else if (config_.motor_time_constant() > 0) {
+    x_dot(13) = (thrust_input_ - thrust) / config_.motor_time_constant();
+    x_dot(14) = 0;
+  } else {
+    x_dot(13) = 0;
+    x_dot(14) = 0;
+  }
+  return x_dot;
+}
+
+void QuadDynamicsSimulator::integrate() {
+  const StateVector k1 = derivative(x_);
+  const StateVector k2 = derivative(x_ + dt_ / 2 * k1);
+  const StateVector k3 = derivative(x_ + dt_ / 2 * k2);
+  const StateVector k4 = derivative(x_ + dt_ * k3);
+  x_ += dt_ / 6 * (k1 + 2 * k2 + 2 * k3 + k4);
+  x_.segment<4>(6).normalize();
+  if (!(armed_ && mode_ == Mode::ThrustTorque)) {
+    x_(14) = config_.motor_time_constant() > 0
+                 ? (thrust_input_ - x_(13)) / config_.motor_time_constant()
+                 : 0;
+  }
+  acceleration_ = derivative(x_).segment<3>(3);
+  // Ground contact
+  if (x_(2) <= 0) {
+    x_(2) = 0;
+    if (x_(5) <= 0) {
+      x_.segment<3>(3).setZero();
+      x_.segment<3>(10).setZero();
+      acceleration_.setZero();
+      if (mode_ == Mode::Land) {
+        armed_ = false;
+      }
+    }
+  }
+}
+
+Eigen::Matrix3d QuadDynamicsSimulator::rotation() const {
+  return Eigen::Quaterniond(x_(6), x_(7), x_(8), x_(9)).toRotationMatrix();
+}
+
+double QuadDynamicsSimulator::thrustGain() const {
+  return config_.thrust_gain() * (1.0 - config_.battery_thrust_gain_loss() *
+                                            (1.0 - battery_percent_ / 100.0));
+}
+
+double QuadDynamicsSimulator::yaw() const {
+  const Eigen::Matrix3d R = rotation();
+  return std::atan2(R(1, 0), R(0, 0));
+}
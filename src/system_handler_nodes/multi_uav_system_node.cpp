@@ -0,0 +1,41 @@
+#include <aerial_autonomy/common/system_handler_node_utils.h>
+#include <aerial_autonomy/state_machines/uav_state_machine.h>
+#include <aerial_autonomy/system_handlers/multi_vehicle_runtime.h>
+#include <aerial_autonomy/system_handlers/uav_system_handler.h>
+#include <aerial_autonomy/uav_basic_events.h>
+
+/**
+ * @brief Loads configuration files and starts a system handler per vehicle
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return Exit status
+ */
+int main(int argc, char **argv) {
+  GOOGLE_PROTOBUF_VERIFY_VERSION;
+  google::InitGoogleLogging("aerial_autonomy_node");
+
+  ros::init(argc, argv, "aerial_autonomy");
+  ros::NodeHandle nh;
+  createAndConfigureLogConfig(nh);
+  auto log_config =
+      loadConfigFromROSParam<LogConfig>(nh, "log_config_filename");
+  auto state_machine_config = loadConfigFromROSParam<BaseStateMachineConfig>(
+      nh, "state_machine_config_filename");
+  auto runtime_config = loadConfigFromROSParam<MultiVehicleRuntimeConfig>(
+      nh, "multi_vehicle_config_filename");
+
+  MultiVehicleRuntime runtime(runtime_config, log_config);
+  for (auto &vehicle : *runtime_config.mutable_vehicles()) {
+    runtime.addVehicle<UAVSystemHandler<
+        UAVStateMachine, uav_basic_events::UAVEventManager<UAVStateMachine>>>(
+        vehicle.name(), *vehicle.mutable_uav_system_handler_config(),
+        state_machine_config);
+  }
+  LOG(INFO) << "Started " << runtime.vehicleCount() << " vehicles on "
+            << runtime.workerPool().threadCount() << " worker threads";
+
+  // Callbacks outside the vehicle namespaces, e.g. of the hardware drivers
+  ros::spin();
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+#include <aerial_autonomy/system_handlers/multi_vehicle_runtime.h>
+
+#include <stdexcept>
+#include <thread>
+
+namespace {
+/**
+ * @brief Number of worker threads for a runtime configuration
+ */
+unsigned int workerThreads(const MultiVehicleRuntimeConfig &config) {
+  unsigned int threads = config.worker_threads();
+  if (threads == 0) {
+    threads = std::thread::hardware_concurrency();
+  }
+  return threads > 0 ? threads : 1;
+}
+}
+
+MultiVehicleRuntime::MultiVehicleRuntime(MultiVehicleRuntimeConfig config,
+                                         LogConfig log_config)
+    : config_(config), log_config_(log_config),
+      worker_pool_(workerThreads(config)) {}
+
+MultiVehicleRuntime::~MultiVehicleRuntime() {
+  for (auto vehicle = vehicles_.rbegin(); vehicle != vehicles_.rend();
+       ++vehicle) {
+    stopVehicle(**vehicle);
+  }
+}
+
+void MultiVehicleRuntime::removeVehicle(const std::string &name) {
+  for (auto vehicle = vehicles_.begin(); vehicle != vehicles_.end();
+       ++vehicle) {
+    if ((*vehicle)->name == name) {
+      stopVehicle(**vehicle);
+      vehicles_.erase(vehicle);
+      return;
+    }
+  }
+  throw std::out_of_range("Vehicle does not exist: " + name);
+}
+
+std::size_t MultiVehicleRuntime::vehicleCount() const {
+  return vehicles_.size();
+}
+
+Log &MultiVehicleRuntime::vehicleLog(const std::string &name) {
+  for (auto &vehicle : vehicles_) {
+    if (vehicle->name == name) {
+      return *vehicle->log;
+    }
+  }
+  throw std::out_of_range("Vehicle does not exist: " + name);
+}
+
+WorkerPool &MultiVehicleRuntime::workerPool() { return worker_pool_; }
+
+MultiVehicleRuntime::Vehicle &
+MultiVehicleRuntime::createVehicle(const std::string &name) {
+  for (auto &vehicle : vehicles_) {
+    if (vehicle->name == name) {
+      throw std::runtime_error("Vehicle name not unique: " + name);
+    }
+  }
+  std::unique_ptr<Vehicle> vehicle(new Vehicle());
+  vehicle->name = name;
+  // The log writes its own streams so it does not need a scoped executor
+  vehicle->log.reset(new Log(&worker_pool_));
+  LogConfig log_config = log_config_;
+  log_config.set_directory(log_config.directory() + name + "_");
+  vehicle->log->configure(log_config);
+  vehicle->callback_queue.reset(new ros::CallbackQueue());
+  vehicle->executor.reset(new LogScopedExecutor(worker_pool_, *vehicle->log));
+  vehicle->context = SystemHandlerContext(name, vehicle->callback_queue.get(),
+                                          vehicle->executor.get());
+  vehicle->callback_task = -1;
+  vehicles_.push_back(std::move(vehicle));
+  return *vehicles_.back();
+}
+
+void MultiVehicleRuntime::startCallbacks(Vehicle &vehicle) {
+  ros::CallbackQueue *callback_queue = vehicle.callback_queue.get();
+  vehicle.callback_task = vehicle.executor->schedule(
+      [callback_queue]() { callback_queue->callAvailable(); },
+      std::chrono::milliseconds(config_.callback_duration()));
+}
+
+void MultiVehicleRuntime::stopVehicle(Vehicle &vehicle) {
+  if (vehicle.callback_task >= 0) {
+    vehicle.executor->cancel(vehicle.callback_task);
+  }
+  {
+    Log::Scope scope(*vehicle.log);
+    vehicle.handler.reset();
+  }
+  vehicle.callback_queue->clear();
+  vehicle.log.reset();
+}
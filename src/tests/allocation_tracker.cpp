@@ -0,0 +1,329 @@
+#include "aerial_autonomy/tests/allocation_tracker.h"
+#include "aerial_autonomy/common/controller_timer_hook.h"
+
+#include <cxxabi.h>
+#include <execinfo.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <new>
+#include <sstream>
+
+#ifdef __GLIBC__
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *ptr);
+}
+#endif
+
+namespace {
+/// Maximum number of stack frames recorded per allocation
+constexpr int max_recorded_frames = 24;
+/// Frames skipped inside the allocation hooks
+constexpr int skipped_frames = 3;
+
+thread_local uint64_t thread_allocations = 0;   ///< Allocations by thread
+thread_local uint64_t thread_deallocations = 0; ///< Deallocations by thread
+thread_local uint64_t thread_bytes = 0;         ///< Bytes allocated by thread
+/// Whether call sites are recorded for the thread
+thread_local bool thread_recording = false;
+/// Whether the thread is inside the tracker. Allocations made by the tracker
+/// itself are neither counted nor recorded
+thread_local bool thread_in_tracker = false;
+
+/**
+ * @brief Allocation statistics of a call site
+ */
+struct CallSiteCounts {
+  uint64_t allocations; ///< Number of allocations
+  uint64_t bytes;       ///< Number of bytes
+};
+
+using CallSiteMap = std::map<std::vector<void *>, CallSiteCounts>;
+
+/// Protects the call site map
+std::mutex call_sites_mutex;
+
+/**
+ * @brief Call sites recorded by all threads. Created on first use since
+ * allocations can happen before static initialization of this file
+ */
+CallSiteMap &callSiteMap() {
+  static CallSiteMap *call_sites = new CallSiteMap;
+  return *call_sites;
+}
+
+/**
+ * @brief Set the in tracker flag of the thread while in scope
+ */
+class TrackerScope {
+public:
+  TrackerScope() : previous_(thread_in_tracker) { thread_in_tracker = true; }
+  ~TrackerScope() { thread_in_tracker = previous_; }
+
+private:
+  bool previous_;
+};
+
+void recordCallSite(size_t size) {
+  TrackerScope scope;
+  void *frames[max_recorded_frames + skipped_frames];
+  int frame_count = backtrace(frames, max_recorded_frames + skipped_frames);
+  std::vector<void *> stack(frames + std::min(frame_count, skipped_frames),
+                            frames + frame_count);
+  std::lock_guard<std::mutex> lock(call_sites_mutex);
+  CallSiteCounts &counts = callSiteMap()[stack];
+  ++counts.allocations;
+  counts.bytes += size;
+}
+
+void countAllocation(size_t size) {
+  if (thread_in_tracker) {
+    return;
+  }
+  ++thread_allocations;
+  thread_bytes += size;
+  if (thread_recording) {
+    recordCallSite(size);
+  }
+}
+
+void countDeallocation(void *ptr) {
+  if (ptr != nullptr && !thread_in_tracker) {
+    ++thread_deallocations;
+  }
+}
+
+/**
+ * @brief Demangle a frame returned by backtrace_symbols of the form
+ * binary(mangled_name+offset) [address] into name+offset. Frames without a
+ * symbol name are returned unchanged
+ */
+std::string demangleFrame(const char *symbol) {
+  std::string frame(symbol);
+  size_t begin = frame.find('(');
+  size_t end = frame.find('+', begin);
+  if (begin == std::string::npos || end == std::string::npos ||
+      end == begin + 1) {
+    return frame;
+  }
+  std::string mangled = frame.substr(begin + 1, end - begin - 1);
+  int status = 0;
+  char *demangled =
+      abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+  if (status != 0 || demangled == nullptr) {
+    return frame;
+  }
+  std::string result(demangled);
+  std::free(demangled);
+  size_t offset_end = frame.find(')', end);
+  return result + frame.substr(end, offset_end - end);
+}
+
+/**
+ * @brief Remove the frames of the tracker and of the allocation functions from
+ * the top of a stack so that the first frame is the allocating call site
+ */
+void dropAllocatorFrames(std::vector<std::string> &frames) {
+  static const std::vector<std::string> allocator_names{
+      "operator new", "malloc", "calloc", "realloc", "posix_memalign"};
+  auto is_allocator = [](const std::string &frame) {
+    for (const auto &name : allocator_names) {
+      if (frame.compare(0, name.size(), name) == 0 ||
+          frame.find("(" + name + "+") != std::string::npos) {
+        return true;
+      }
+    }
+    return false;
+  };
+  auto last_allocator = std::find_if(frames.rbegin(), frames.rend(),
+                                     is_allocator);
+  if (last_allocator != frames.rend()) {
+    frames.erase(frames.begin(), last_allocator.base());
+  }
+}
+
+void *allocate(size_t size) {
+  countAllocation(size);
+#ifdef __GLIBC__
+  return __libc_malloc(size);
+#else
+  return std::malloc(size);
+#endif
+}
+
+void deallocate(void *ptr) {
+  countDeallocation(ptr);
+#ifdef __GLIBC__
+  __libc_free(ptr);
+#else
+  std::free(ptr);
+#endif
+}
+
+void *allocateOrThrow(size_t size) {
+  void *ptr = allocate(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+}
+
+void *operator new(size_t size) { return allocateOrThrow(size); }
+
+void *operator new[](size_t size) { return allocateOrThrow(size); }
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size == 0 ? 1 : size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size == 0 ? 1 : size);
+}
+
+void operator delete(void *ptr) noexcept { deallocate(ptr); }
+
+void operator delete[](void *ptr) noexcept { deallocate(ptr); }
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+  deallocate(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+  deallocate(ptr);
+}
+
+#ifdef __GLIBC__
+// Interpose the C allocation functions so that allocations made through
+// malloc (e.g. by Eigen or C libraries) are counted as well
+extern "C" {
+void *malloc(size_t size) { return allocate(size); }
+
+void free(void *ptr) { deallocate(ptr); }
+
+void *calloc(size_t count, size_t size) {
+  countAllocation(count * size);
+  return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+  if (size != 0) {
+    countAllocation(size);
+  }
+  if (ptr != nullptr) {
+    countDeallocation(ptr);
+  }
+  return __libc_realloc(ptr, size);
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size) {
+  countAllocation(size);
+  *ptr = __libc_memalign(alignment, size);
+  return *ptr == nullptr ? ENOMEM : 0;
+}
+}
+#endif
+
+namespace allocation_tracker {
+
+AllocationCounts threadCounts() {
+  AllocationCounts counts;
+  counts.allocations = thread_allocations;
+  counts.deallocations = thread_deallocations;
+  counts.bytes = thread_bytes;
+  return counts;
+}
+
+ScopedAllocationCounter::ScopedAllocationCounter() : start_(threadCounts()) {}
+
+AllocationCounts ScopedAllocationCounter::counts() const {
+  AllocationCounts current = threadCounts();
+  current.allocations -= start_.allocations;
+  current.deallocations -= start_.deallocations;
+  current.bytes -= start_.bytes;
+  return current;
+}
+
+ScopedCallSiteRecorder::ScopedCallSiteRecorder()
+    : previously_recording_(thread_recording) {
+  thread_recording = true;
+}
+
+ScopedCallSiteRecorder::~ScopedCallSiteRecorder() {
+  thread_recording = previously_recording_;
+}
+
+std::vector<CallSite> callSites() {
+  TrackerScope scope;
+  std::vector<CallSite> call_sites;
+  std::lock_guard<std::mutex> lock(call_sites_mutex);
+  for (const auto &call_site : callSiteMap()) {
+    const std::vector<void *> &stack = call_site.first;
+    CallSite result;
+    result.allocations = call_site.second.allocations;
+    result.bytes = call_site.second.bytes;
+    char **symbols = backtrace_symbols(stack.data(), stack.size());
+    for (size_t i = 0; i < stack.size(); ++i) {
+      result.frames.push_back(symbols != nullptr ? demangleFrame(symbols[i])
+                                                 : std::string("??"));
+    }
+    std::free(symbols);
+    dropAllocatorFrames(result.frames);
+    call_sites.push_back(result);
+  }
+  std::sort(call_sites.begin(), call_sites.end(),
+            [](const CallSite &a, const CallSite &b) {
+              return a.allocations > b.allocations;
+            });
+  return call_sites;
+}
+
+void clearCallSites() {
+  TrackerScope scope;
+  std::lock_guard<std::mutex> lock(call_sites_mutex);
+  callSiteMap().clear();
+}
+
+std::string callSiteReport(size_t max_sites, size_t max_frames) {
+  std::vector<CallSite> call_sites = callSites();
+  TrackerScope scope;
+  std::stringstream report;
+  report << call_sites.size() << " allocating call sites\n";
+  for (size_t i = 0; i < std::min(max_sites, call_sites.size()); ++i) {
+    const CallSite &call_site = call_sites[i];
+    report << "#" << i << ": " << call_site.allocations << " allocations, "
+           << call_site.bytes << " bytes\n";
+    for (size_t j = 0; j < std::min(max_frames, call_site.frames.size());
+         ++j) {
+      report << "    " << call_site.frames[j] << "\n";
+    }
+  }
+  return report.str();
+}
+
+std::function<void()> recordingCallSites(std::function<void()> function) {
+  return [function]() {
+    ScopedCallSiteRecorder recorder;
+    function();
+  };
+}
+}
+
+namespace {
+/**
+ * @brief Record the call sites of the controller timers of the handlers
+ * enabling record_controller_call_sites in executables linking the tracker
+ */
+const bool controller_timer_hook_installed =
+    (ControllerTimerHook::install(
+         allocation_tracker::recordingCallSites,
+         []() { return allocation_tracker::callSiteReport(); }),
+     true);
+}
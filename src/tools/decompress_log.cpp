@@ -0,0 +1,68 @@
+#include <aerial_autonomy/log/stream_compression.h>
+
+#include <glog/logging.h>
+
+#include <fstream>
+#include <iostream>
+
+/**
+ * @brief Print usage of the tool
+ * @param name Executable name
+ */
+void printUsage(const char *name) {
+  std::cerr << "Usage: " << name
+            << " COMPRESSED_STREAM [OUTPUT_FILE] [--precision DIGITS]\n"
+            << "Converts a compressed data stream back to delimited text."
+            << " The text is printed to the standard output unless an output"
+            << " file is given. Values use the precision of the stream"
+            << " configuration unless --precision is given" << std::endl;
+}
+
+/**
+ * @brief Decompresses a data stream written with a compression
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return Exit status
+ */
+int main(int argc, char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  if (argc < 2) {
+    printUsage(argv[0]);
+    return 2;
+  }
+  std::string output_path;
+  int precision = -1;
+  for (int i = 2; i < argc; ++i) {
+    std::string option = argv[i];
+    if (option == "--precision" && i + 1 < argc) {
+      precision = std::stoi(argv[++i]);
+    } else if (option[0] != '-' && output_path.empty()) {
+      output_path = option;
+    } else {
+      printUsage(argv[0]);
+      return 2;
+    }
+  }
+
+  std::ifstream input(argv[1], std::ios::binary);
+  if (!input.is_open()) {
+    LOG(ERROR) << "Could not open file: " << argv[1];
+    return 1;
+  }
+  std::ofstream output_file;
+  if (!output_path.empty()) {
+    output_file.open(output_path);
+    if (!output_file.is_open()) {
+      LOG(ERROR) << "Could not open file: " << output_path;
+      return 1;
+    }
+  }
+  try {
+    decompressStream(input, output_path.empty() ? std::cout : output_file,
+                     precision);
+  } catch (const std::runtime_error &error) {
+    LOG(ERROR) << argv[1] << ": " << error.what();
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,109 @@
+#include <aerial_autonomy/log/log_index.h>
+
+#include <glog/logging.h>
+
+#include <boost/algorithm/string.hpp>
+
+#include <cmath>
+#include <iostream>
+
+/**
+ * @brief Print usage of the tool
+ * @param name Executable name
+ */
+void printUsage(const char *name) {
+  std::cerr
+      << "Usage: " << name << " LOG_DIRECTORY [--streams ID1,ID2,...]"
+      << " [--start SECONDS] [--end SECONDS] [--resample PERIOD_SECONDS]"
+      << " [--linear]\n"
+      << "Indexes the streams in a log directory and prints a summary. With"
+      << " --streams, prints the data points of the streams between start"
+      << " and end (relative to the start of the log) in time order, or"
+      << " sampled every period with --resample" << std::endl;
+}
+
+/**
+ * @brief Indexes the data streams of a log directory and runs time range
+ * queries over them
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return Exit status
+ */
+int main(int argc, char **argv) {
+  google::InitGoogleLogging(argv[0]);
+  if (argc < 2) {
+    printUsage(argv[0]);
+    return 2;
+  }
+  std::vector<std::string> stream_ids;
+  double start_seconds = 0;
+  double end_seconds = -1;
+  double period_seconds = 0;
+  ResampleMethod method = ResampleMethod::Hold;
+  for (int i = 2; i < argc; ++i) {
+    std::string option = argv[i];
+    bool has_value = i + 1 < argc;
+    if (option == "--streams" && has_value) {
+      boost::split(stream_ids, argv[++i], boost::is_any_of(","));
+    } else if (option == "--start" && has_value) {
+      start_seconds = std::stod(argv[++i]);
+    } else if (option == "--end" && has_value) {
+      end_seconds = std::stod(argv[++i]);
+    } else if (option == "--resample" && has_value) {
+      period_seconds = std::stod(argv[++i]);
+    } else if (option == "--linear") {
+      method = ResampleMethod::Linear;
+    } else {
+      printUsage(argv[0]);
+      return 2;
+    }
+  }
+
+  LogIndex log_index(argv[1]);
+  log_index.saveIndices();
+  int64_t log_start = log_index.startTime();
+  if (stream_ids.empty()) {
+    for (const auto &stream_id : log_index.streamIds()) {
+      const MappedStream &stream = log_index.stream(stream_id);
+      std::cout << stream_id << ": " << stream.size() << " data points";
+      if (stream.size() > 0) {
+        std::cout << " from " << (stream.startTime() - log_start) * 1e-9
+                  << " s to " << (stream.endTime() - log_start) * 1e-9 << " s";
+      }
+      std::cout << "\n";
+    }
+    return 0;
+  }
+
+  int64_t start = log_start + std::llround(start_seconds * 1e9);
+  int64_t end = end_seconds < 0 ? log_index.endTime()
+                                : log_start + std::llround(end_seconds * 1e9);
+  std::cout.precision(17);
+  if (period_seconds > 0) {
+    ResampledCursor cursor = log_index.resample(
+        stream_ids, start, end,
+        std::chrono::nanoseconds(std::llround(period_seconds * 1e9)), method);
+    std::cout << "#Time," << boost::join(cursor.columns(), ",") << "\n";
+    int64_t time;
+    std::vector<double> values;
+    while (cursor.next(time, values)) {
+      std::cout << time;
+      for (double value : values) {
+        std::cout << "," << value;
+      }
+      std::cout << "\n";
+    }
+  } else {
+    MergedCursor cursor = log_index.merged(stream_ids, start, end);
+    size_t stream;
+    LogRecord record;
+    while (cursor.next(stream, record)) {
+      std::cout << stream_ids[stream] << "," << record.timestamp;
+      for (double value : record.values) {
+        std::cout << "," << value;
+      }
+      std::cout << "\n";
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,61 @@
+#include <aerial_autonomy/common/proto_utils.h>
+#include <aerial_autonomy/log/stream_replayers.h>
+
+#include <glog/logging.h>
+
+#include <iostream>
+
+/**
+ * @brief Load an optional proto text config
+ *
+ * @tparam ConfigT Type of config to load
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @param index Argument index of the config file name
+ *
+ * @return Loaded config or default config if the argument is not provided
+ */
+template <class ConfigT>
+ConfigT loadOptionalConfig(int argc, char **argv, int index) {
+  ConfigT config;
+  if (argc > index && !proto_utils::loadProtoText(argv[index], config)) {
+    LOG(FATAL) << "Failed to open config file: " << argv[index];
+  }
+  return config;
+}
+
+/**
+ * @brief Replays a recorded data stream through the algorithm that produced
+ * it and prints the divergence from the recorded outputs and the tick cost
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return 0 if the replay matches the recording, 1 if it diverges
+ */
+int main(int argc, char **argv) {
+  GOOGLE_PROTOBUF_VERIFY_VERSION;
+  google::InitGoogleLogging(argv[0]);
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0]
+              << " STREAM_FILE [REPLAY_CONFIG] [ALGORITHM_CONFIG]"
+                 " [CONTROLLER_TIMER_DURATION]"
+              << std::endl;
+    return 2;
+  }
+  RecordedStream stream(argv[1]);
+  LogReplay log_replay(loadOptionalConfig<LogReplayConfig>(argc, argv, 2));
+  std::unique_ptr<StreamReplayer> replayer;
+  if (stream.streamId() == "thrust_gain_estimator") {
+    replayer.reset(new ThrustGainEstimatorReplayer(
+        loadOptionalConfig<ThrustGainEstimatorConfig>(argc, argv, 3)));
+  } else if (stream.streamId() == "rpyt_based_velocity_controller") {
+    double controller_timer_duration = argc > 4 ? std::stod(argv[4]) : 0.02;
+    replayer.reset(new RPYTBasedVelocityControllerReplayer(
+        loadOptionalConfig<RPYTBasedVelocityControllerConfig>(argc, argv, 3),
+        std::chrono::duration<double>(controller_timer_duration)));
+  } else {
+    LOG(FATAL) << "No replayer for stream: " << stream.streamId();
+  }
+  ReplayResult result = log_replay.replay(stream, *replayer);
+  std::cout << result << std::endl;
+  return result.diverged() ? 1 : 0;
+}
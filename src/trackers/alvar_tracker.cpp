@@ -12,7 +12,7 @@ bool AlvarTracker::getTrackingVectors(
 }
 
 bool AlvarTracker::trackingIsValid() {
-  bool valid = (ros::Time::now() - last_valid_time_).toSec() < timeout_.count();
+  bool valid = timebase::Clock::now() - last_valid_time_.get() < timeout_;
   if (!valid) {
     VLOG_EVERY_N(1, 20) << "Alvar has not been updated for " << timeout_.count()
                         << " seconds";
@@ -24,8 +24,8 @@ void AlvarTracker::markerCallback(
     const ar_track_alvar_msgs::AlvarMarkers &marker_msg) {
   if (marker_msg.markers.size() == 0)
     return;
-  last_valid_time_ = ros::Time::now();
-  last_tracking_time_ = std::chrono::high_resolution_clock::now();
+  last_valid_time_ = timebase::Clock::now();
+  last_tracking_time_ = timebase::fromRosTime(marker_msg.header.stamp);
   std::unordered_map<uint32_t, tf::Transform> object_poses;
   for (unsigned int i = 0; i < marker_msg.markers.size(); i++) {
     auto marker_pose = marker_msg.markers[i].pose.pose;
@@ -41,7 +41,6 @@ void AlvarTracker::markerCallback(
 
 bool AlvarTracker::isConnected() { return alvar_sub_.getNumPublishers() > 0; }
 
-std::chrono::time_point<std::chrono::high_resolution_clock>
-AlvarTracker::getTrackingTime() {
+timebase::TimePoint AlvarTracker::getTrackingTime() {
   return last_tracking_time_;
 }
@@ -0,0 +1,54 @@
+#include "aerial_autonomy/trackers/color_blob_roi_detector.h"
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <glog/logging.h>
+
+ColorBlobRoiDetector::ColorBlobRoiDetector(
+    const ColorBlobDetectorConfig &config)
+    : config_(config) {
+  CHECK_LE(config_.hue_min(), 180u) << "Hue should be in [0, 180]";
+  CHECK_LE(config_.hue_max(), 180u) << "Hue should be in [0, 180]";
+  CHECK_LE(config_.saturation_min(), config_.saturation_max())
+      << "Saturation range is inverted";
+  CHECK_LE(config_.value_min(), config_.value_max())
+      << "Value range is inverted";
+}
+
+bool ColorBlobRoiDetector::detect(const cv::Mat &image,
+                                  sensor_msgs::RegionOfInterest &roi) {
+  cv::cvtColor(image, hsv_, cv::COLOR_BGR2HSV);
+  const cv::Scalar lower(config_.hue_min(), config_.saturation_min(),
+                         config_.value_min());
+  const cv::Scalar upper(config_.hue_max(), config_.saturation_max(),
+                         config_.value_max());
+  if (config_.hue_min() <= config_.hue_max()) {
+    cv::inRange(hsv_, lower, upper, mask_);
+  } else {
+    // Hue range wrapping around, split at 180
+    cv::inRange(hsv_, lower, cv::Scalar(180, upper[1], upper[2]), mask_);
+    cv::inRange(hsv_, cv::Scalar(0, lower[1], lower[2]), upper, wrapped_mask_);
+    cv::bitwise_or(mask_, wrapped_mask_, mask_);
+  }
+  int components =
+      cv::connectedComponentsWithStats(mask_, labels_, stats_, centroids_);
+  // Label 0 is the background
+  int largest = 0;
+  int largest_area = 0;
+  for (int label = 1; label < components; ++label) {
+    int area = stats_.at<int>(label, cv::CC_STAT_AREA);
+    if (area > largest_area) {
+      largest = label;
+      largest_area = area;
+    }
+  }
+  if (largest == 0 || largest_area < static_cast<int>(config_.min_area())) {
+    return false;
+  }
+  roi.x_offset = stats_.at<int>(largest, cv::CC_STAT_LEFT);
+  roi.y_offset = stats_.at<int>(largest, cv::CC_STAT_TOP);
+  roi.width = stats_.at<int>(largest, cv::CC_STAT_WIDTH);
+  roi.height = stats_.at<int>(largest, cv::CC_STAT_HEIGHT);
+  roi.do_rectify = false;
+  return true;
+}
@@ -4,25 +4,103 @@
 
 #include <glog/logging.h>
 
+RoiToPositionConverter::RoiToPositionConverter(std::string name_space,
+                                               RoiDetectorPtr detector)
+    : BaseTracker(std::move(
+          std::unique_ptr<TrackingStrategy>(new SimpleTrackingStrategy()))),
+      nh_(name_space), it_(nh_),
+      camera_info_subscriber_(nh_.subscribe(
+          "camera_info", 1, &RoiToPositionConverter::cameraInfoCallback, this)),
+      depth_subscriber_(nh_.subscribe(
+          "depth", 1, &RoiToPositionConverter::depthCallback, this)),
+      detector_(std::move(detector)),
+      tracking_latency_(std::chrono::duration<double>(0)) {
+  // Only subscribe to images when detecting ROIs in them
+  if (detector_) {
+    image_subscriber_ =
+        it_.subscribe("image", 1, &RoiToPositionConverter::imageCallback, this);
+  } else {
+    roi_subscriber_ =
+        nh_.subscribe("roi", 10, &RoiToPositionConverter::roiCallback, this);
+  }
+}
+
 bool RoiToPositionConverter::isConnected() {
-  return roi_subscriber_.getNumPublishers() > 0 &&
-         depth_subscriber_.getNumPublishers() > 0;
+  bool roi_connected = detector_ ? image_subscriber_.getNumPublishers() > 0
+                                 : roi_subscriber_.getNumPublishers() > 0;
+  return roi_connected && depth_subscriber_.getNumPublishers() > 0;
 }
 
-std::chrono::time_point<std::chrono::high_resolution_clock>
-RoiToPositionConverter::getTrackingTime() {
-  return last_tracking_time_;
+timebase::TimePoint RoiToPositionConverter::getTrackingTime() {
+  timebase::TimePoint time;
+  tf::Transform object_pose;
+  object_poses_.getLatest(time, object_pose);
+  return time;
 }
 
 void RoiToPositionConverter::roiCallback(
     const sensor_msgs::RegionOfInterest &roi_msg) {
-  last_roi_update_time_ = ros::Time::now();
-  last_tracking_time_ = std::chrono::high_resolution_clock::now();
+  last_roi_update_time_ = timebase::Clock::now();
   roi_rect_ = roi_msg;
 }
 
+std::chrono::duration<double> RoiToPositionConverter::getTrackingLatency() {
+  return tracking_latency_;
+}
+
 void RoiToPositionConverter::imageCallback(
-    const sensor_msgs::ImageConstPtr &img_msg) {}
+    const sensor_msgs::ImageConstPtr &img_msg) {
+  // Shares the image data when it is already BGR
+  cv_bridge::CvImageConstPtr image;
+  try {
+    image = cv_bridge::toCvShare(img_msg, sensor_msgs::image_encodings::BGR8);
+  } catch (cv_bridge::Exception &e) {
+    LOG(ERROR) << "Cannot convert image: " << e.what();
+    return;
+  }
+  sensor_msgs::RegionOfInterest roi;
+  if (!detector_->detect(image->image, roi)) {
+    VLOG(2) << "Target not detected";
+    return;
+  }
+  const ros::Time &stamp = img_msg->header.stamp;
+  last_roi_update_time_ = timebase::Clock::now();
+  roi_rect_ = roi;
+  boost::mutex::scoped_lock lock(depth_mutex_);
+  if (detected_roi_count_ > 0 &&
+      stamp < detected_rois_[(detected_roi_count_ - 1) %
+                             detected_roi_capacity_]
+                  .stamp) {
+    LOG(WARNING) << "Dropping out of order image";
+    return;
+  }
+  detected_rois_[detected_roi_count_ % detected_roi_capacity_] =
+      DetectedRoi{stamp, roi};
+  ++detected_roi_count_;
+  if (pending_depth_ && pending_depth_->header.stamp == stamp) {
+    addObjectPose(roi, pending_depth_);
+    pending_depth_.reset();
+  }
+}
+
+bool RoiToPositionConverter::findDetectedRoi(
+    const ros::Time &stamp, sensor_msgs::RegionOfInterest &roi) const {
+  std::size_t first = detected_roi_count_ > detected_roi_capacity_
+                          ? detected_roi_count_ - detected_roi_capacity_
+                          : 0;
+  // ROIs are in stamp order, so scan back from the newest ROI
+  for (std::size_t index = detected_roi_count_; index > first; --index) {
+    const DetectedRoi &candidate =
+        detected_rois_[(index - 1) % detected_roi_capacity_];
+    if (candidate.stamp == stamp) {
+      roi = candidate.roi;
+      return true;
+    } else if (candidate.stamp < stamp) {
+      return false;
+    }
+  }
+  return false;
+}
 
 void RoiToPositionConverter::cameraInfoCallback(
     const sensor_msgs::CameraInfo &cam_info_msg) {
@@ -37,29 +115,51 @@ void RoiToPositionConverter::depthCallback(
     return;
   }
 
+  if (detector_) {
+    // Use the ROI detected in the image with the same stamp, or wait for it
+    sensor_msgs::RegionOfInterest roi;
+    boost::mutex::scoped_lock lock(depth_mutex_);
+    if (findDetectedRoi(depth_msg->header.stamp, roi)) {
+      addObjectPose(roi, depth_msg);
+      pending_depth_.reset();
+    } else {
+      pending_depth_ = depth_msg;
+    }
+    return;
+  }
+
   /// \todo (Matt) make timeout configurable
   if (!roiIsValid()) {
     return;
   }
 
-  cv_bridge::CvImagePtr depth =
-      cv_bridge::toCvCopy(depth_msg, sensor_msgs::image_encodings::TYPE_32FC1);
+  boost::mutex::scoped_lock lock(depth_mutex_);
+  addObjectPose(roi_rect_, depth_msg);
+}
 
+void RoiToPositionConverter::addObjectPose(
+    const sensor_msgs::RegionOfInterest &roi,
+    const sensor_msgs::ImageConstPtr &depth_msg) {
   if (!cameraInfoIsValid()) {
     return;
   }
 
+  cv_bridge::CvImageConstPtr depth =
+      cv_bridge::toCvShare(depth_msg, sensor_msgs::image_encodings::TYPE_32FC1);
+
   // Copy variables
-  sensor_msgs::RegionOfInterest roi_rect;
-  roi_rect = roi_rect_;
   sensor_msgs::CameraInfo camera_info;
   camera_info = camera_info_;
   tf::Transform object_pose;
-  computeTrackingVector(roi_rect, depth->image, camera_info,
-                        max_object_distance_, foreground_percent_, object_pose);
-  object_pose_ = object_pose;
-  /// \todo store a flag indicating a position has been computed and return
-  /// false in positionIsValid if it has not
+  computeTrackingVector(roi, depth->image, camera_info, max_object_distance_,
+                        foreground_percent_, object_pose);
+  timebase::TimePoint stamp = timebase::fromRosTime(depth_msg->header.stamp);
+  if (!object_poses_.push(stamp, object_pose)) {
+    LOG(WARNING) << "Dropping out of order depth image";
+    return;
+  }
+  tracking_latency_ =
+      std::chrono::duration<double>(timebase::Clock::now() - stamp);
 }
 
 bool RoiToPositionConverter::trackingIsValid() {
@@ -74,7 +174,8 @@ bool RoiToPositionConverter::cameraInfoIsValid() {
 }
 
 bool RoiToPositionConverter::roiIsValid() {
-  bool valid = (ros::Time::now() - last_roi_update_time_).toSec() < 0.5;
+  bool valid = timebase::Clock::now() - last_roi_update_time_.get() <
+               std::chrono::milliseconds(500);
   if (!valid)
     VLOG(2) << "ROI has not been updated for 0.5 seconds";
   return valid;
@@ -86,7 +187,13 @@ bool RoiToPositionConverter::getTrackingVectors(
   if (!trackingIsValid()) {
     return false;
   }
-  pos[0] = object_pose_;
+  timebase::TimePoint time;
+  tf::Transform object_pose;
+  // No tracking vector before the first depth image
+  if (!object_poses_.getLatest(time, object_pose)) {
+    return false;
+  }
+  pos[0] = object_pose;
   return true;
 }
 
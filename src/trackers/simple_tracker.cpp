@@ -22,9 +22,12 @@ bool SimpleTracker::getTrackingVectors(
                                   uav_data.rpydata.z),
       tf::Vector3(uav_data.localpos.x, uav_data.localpos.y,
                   uav_data.localpos.z));
-  for (auto target : target_poses_) {
-    p[target.first] =
-        camera_transform_.inverse() * quad_tf_global.inverse() * target.second;
+  // Composed locally rather than cached since trackers are queried from the
+  // controller, logic and status threads
+  const tf::Transform global_to_camera =
+      (quad_tf_global * camera_transform_).inverse();
+  for (const auto &target : target_poses_) {
+    p[target.first] = global_to_camera * target.second;
   }
   return true;
 }
@@ -0,0 +1,38 @@
+#include "aerial_autonomy/trackers/template_roi_detector.h"
+
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <glog/logging.h>
+
+TemplateRoiDetector::TemplateRoiDetector(const TemplateDetectorConfig &config)
+    : TemplateRoiDetector(
+          config, cv::imread(config.template_path(), cv::IMREAD_COLOR)) {}
+
+TemplateRoiDetector::TemplateRoiDetector(const TemplateDetectorConfig &config,
+                                         const cv::Mat &template_image)
+    : config_(config), template_(template_image) {
+  CHECK(!template_.empty()) << "Could not load template "
+                            << config_.template_path();
+}
+
+bool TemplateRoiDetector::detect(const cv::Mat &image,
+                                 sensor_msgs::RegionOfInterest &roi) {
+  if (image.cols < template_.cols || image.rows < template_.rows) {
+    LOG(WARNING) << "Image smaller than template";
+    return false;
+  }
+  cv::matchTemplate(image, template_, scores_, cv::TM_CCOEFF_NORMED);
+  double max_score;
+  cv::Point max_location;
+  cv::minMaxLoc(scores_, nullptr, &max_score, nullptr, &max_location);
+  if (max_score < config_.min_score()) {
+    return false;
+  }
+  roi.x_offset = max_location.x;
+  roi.y_offset = max_location.y;
+  roi.width = template_.cols;
+  roi.height = template_.rows;
+  roi.do_rectify = false;
+  return true;
+}
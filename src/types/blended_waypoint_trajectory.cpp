@@ -0,0 +1,129 @@
+#include "aerial_autonomy/types/blended_waypoint_trajectory.h"
+#include "aerial_autonomy/common/math.h"
+
+#include <algorithm>
+#include <glog/logging.h>
+
+BlendedWaypointTrajectory::BlendedWaypointTrajectory(
+    const std::vector<PositionYaw> &waypoints, double velocity,
+    double corner_tolerance, double max_yaw_rate)
+    : duration_(0) {
+  CHECK(!waypoints.empty()) << "Trajectory needs at least one waypoint";
+  CHECK_GT(velocity, 0) << "Velocity should be positive";
+  CHECK_GE(corner_tolerance, 0) << "Corner tolerance should be non negative";
+  CHECK_GT(max_yaw_rate, 0) << "Maximum yaw rate should be positive";
+  const double eps = 1e-9;
+  const std::size_t n = waypoints.size();
+  final_waypoint_ = waypoints.back();
+  final_waypoint_index_ = n - 1;
+
+  std::vector<Eigen::Vector3d> points;
+  for (const auto &waypoint : waypoints) {
+    points.emplace_back(waypoint.x, waypoint.y, waypoint.z);
+  }
+  // Direction and length of the line leaving each waypoint
+  std::vector<Eigen::Vector3d> directions(n, Eigen::Vector3d::Zero());
+  std::vector<double> lengths(n, 0);
+  for (std::size_t i = 0; i + 1 < n; ++i) {
+    Eigen::Vector3d line = points[i + 1] - points[i];
+    lengths[i] = line.norm();
+    if (lengths[i] > eps) {
+      directions[i] = line / lengths[i];
+    }
+  }
+  // Distance from each waypoint at which its corner blend starts and ends.
+  // The middle of a quadratic blend is at a distance of
+  // blend * |direction change| / 4 from the waypoint.
+  std::vector<double> blend_distances(n, 0);
+  for (std::size_t i = 1; i + 1 < n; ++i) {
+    double direction_change = (directions[i] - directions[i - 1]).norm();
+    if (lengths[i - 1] > eps && lengths[i] > eps && direction_change > eps) {
+      blend_distances[i] =
+          std::min({4.0 * corner_tolerance / direction_change,
+                    0.5 * lengths[i - 1], 0.5 * lengths[i]});
+    }
+  }
+
+  double t = 0;
+  for (std::size_t i = 0; i + 1 < n; ++i) {
+    Piece line;
+    line.is_blend = false;
+    line.t_start = t;
+    line.start = points[i] + blend_distances[i] * directions[i];
+    line.end = points[i + 1] - blend_distances[i + 1] * directions[i];
+    line.middle = line.end;
+    line.yaw_start = waypoints[i].yaw;
+    line.yaw_change = math::angleWrap(waypoints[i + 1].yaw - waypoints[i].yaw);
+    line.t_duration =
+        std::max((line.end - line.start).norm() / velocity,
+                 std::abs(line.yaw_change) / max_yaw_rate);
+    line.waypoint_index = i + 1;
+    if (line.t_duration > 0) {
+      pieces_.push_back(line);
+      t += line.t_duration;
+    }
+    const double blend_distance = blend_distances[i + 1];
+    if (blend_distance > 0) {
+      Piece blend;
+      blend.is_blend = true;
+      blend.t_start = t;
+      blend.t_duration = 2.0 * blend_distance / velocity;
+      blend.start = line.end;
+      blend.middle = points[i + 1];
+      blend.end = points[i + 1] + blend_distance * directions[i + 1];
+      blend.yaw_start = waypoints[i + 1].yaw;
+      blend.yaw_change = 0;
+      blend.waypoint_index = i + 1;
+      pieces_.push_back(blend);
+      t += blend.t_duration;
+    }
+  }
+  duration_ = t;
+}
+
+std::pair<PositionYaw, VelocityYawRate>
+BlendedWaypointTrajectory::atTime(double t) const {
+  if (t >= duration_ || pieces_.empty()) {
+    return std::make_pair(final_waypoint_, VelocityYawRate(0, 0, 0, 0));
+  }
+  const Piece &piece = pieces_[findPiece(t)];
+  double s = std::max(t - piece.t_start, 0.0) / piece.t_duration;
+  Eigen::Vector3d position, velocity;
+  if (piece.is_blend) {
+    // Quadratic bezier curve with the waypoint as control point
+    position = (1 - s) * (1 - s) * piece.start +
+               2 * s * (1 - s) * piece.middle + s * s * piece.end;
+    velocity = (2 * (1 - s) * (piece.middle - piece.start) +
+                2 * s * (piece.end - piece.middle)) /
+               piece.t_duration;
+  } else {
+    position = piece.start + s * (piece.end - piece.start);
+    velocity = (piece.end - piece.start) / piece.t_duration;
+  }
+  PositionYaw position_yaw(position.x(), position.y(), position.z(),
+                           math::angleWrap(piece.yaw_start +
+                                           s * piece.yaw_change));
+  VelocityYawRate velocity_yaw_rate(velocity.x(), velocity.y(), velocity.z(),
+                                    piece.yaw_change / piece.t_duration);
+  return std::make_pair(position_yaw, velocity_yaw_rate);
+}
+
+double BlendedWaypointTrajectory::duration() const { return duration_; }
+
+int BlendedWaypointTrajectory::waypointIndex(double t) const {
+  if (t >= duration_ || pieces_.empty()) {
+    return final_waypoint_index_;
+  }
+  const Piece &piece = pieces_[findPiece(t)];
+  if (piece.is_blend && t - piece.t_start >= 0.5 * piece.t_duration) {
+    return piece.waypoint_index + 1;
+  }
+  return piece.waypoint_index;
+}
+
+std::size_t BlendedWaypointTrajectory::findPiece(double t) const {
+  auto it = std::upper_bound(
+      pieces_.begin(), pieces_.end(), t,
+      [](double time, const Piece &piece) { return time < piece.t_start; });
+  return it == pieces_.begin() ? 0 : (it - pieces_.begin()) - 1;
+}
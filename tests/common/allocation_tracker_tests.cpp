@@ -0,0 +1,226 @@
+#include "aerial_autonomy/common/async_timer.h"
+#include "aerial_autonomy/common/controller_timer_hook.h"
+#include "aerial_autonomy/controller_connectors/manual_rpyt_controller_drone_connector.h"
+#include "aerial_autonomy/controller_connectors/velocity_based_position_controller_drone_connector.h"
+#include "aerial_autonomy/controllers/manual_rpyt_controller.h"
+#include "aerial_autonomy/controllers/qrotor_backstepping_kernel.h"
+#include "aerial_autonomy/controllers/velocity_based_position_controller.h"
+#include "aerial_autonomy/estimators/recursive_least_squares.h"
+#include "aerial_autonomy/tests/allocation_tracker.h"
+#include "aerial_autonomy/tests/sample_parser.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+
+using namespace allocation_tracker;
+
+/**
+* @brief Allocate a vector so that call sites can be found in the report
+*/
+void __attribute__((noinline)) allocatingFunction(std::vector<double> &data) {
+  data.clear();
+  data.shrink_to_fit();
+  data.push_back(1.0);
+}
+
+/**
+* @brief Position connector allocating every time it sends commands
+*/
+class AllocatingConnector
+    : public VelocityBasedPositionControllerDroneConnector {
+public:
+  AllocatingConnector(
+      parsernode::Parser &drone_hardware,
+      Controller<PositionYaw, PositionYaw, VelocityYawRate> &controller)
+      : VelocityBasedPositionControllerDroneConnector(drone_hardware,
+                                                      controller) {}
+
+protected:
+  virtual void sendControllerCommands(VelocityYawRate controls) {
+    allocatingFunction(commands_);
+    VelocityBasedPositionControllerDroneConnector::sendControllerCommands(
+        controls);
+  }
+
+private:
+  std::vector<double> commands_;
+};
+
+TEST(AllocationTrackerTests, CountNew) {
+  ScopedAllocationCounter counter;
+  std::unique_ptr<int> data(new int(1));
+  EXPECT_EQ(counter.counts().allocations, 1u);
+  EXPECT_EQ(counter.counts().bytes, sizeof(int));
+  data.reset();
+  EXPECT_EQ(counter.counts().deallocations, 1u);
+}
+
+TEST(AllocationTrackerTests, CountMalloc) {
+  ScopedAllocationCounter counter;
+  void *data = std::malloc(16);
+  EXPECT_EQ(counter.counts().allocations, 1u);
+  data = std::realloc(data, 32);
+  EXPECT_EQ(counter.counts().allocations, 2u);
+  std::free(data);
+  EXPECT_EQ(counter.counts().bytes, 48u);
+}
+
+TEST(AllocationTrackerTests, CountPerThread) {
+  ScopedAllocationCounter counter;
+  std::thread thread([]() { std::unique_ptr<int> data(new int(1)); });
+  uint64_t allocations = counter.counts().allocations;
+  thread.join();
+  // Creating the thread may allocate on this thread but the allocation inside
+  // the thread is not counted
+  ScopedAllocationCounter join_counter;
+  EXPECT_EQ(join_counter.counts().allocations, 0u);
+  EXPECT_LE(counter.counts().allocations, allocations);
+}
+
+TEST(AllocationTrackerTests, AllocationFreeAfterWarmup) {
+  std::vector<double> data;
+  auto fill = [&data]() {
+    data.clear();
+    data.push_back(1.0);
+  };
+  EXPECT_NO_ALLOCATIONS(fill);
+}
+
+TEST(AllocationTrackerTests, AllocatingFunctionFails) {
+  std::vector<double> data;
+  auto result = allocationFree([&data]() { allocatingFunction(data); }, 3);
+  ASSERT_FALSE(result);
+  std::string message = result.message();
+  EXPECT_NE(message.find("1 allocations"), std::string::npos) << message;
+  EXPECT_NE(message.find("allocatingFunction"), std::string::npos) << message;
+}
+
+TEST(AllocationTrackerTests, RecordCallSites) {
+  clearCallSites();
+  std::vector<double> data;
+  allocatingFunction(data);
+  EXPECT_TRUE(callSites().empty());
+  {
+    ScopedCallSiteRecorder recorder;
+    for (int i = 0; i < 2; ++i) {
+      allocatingFunction(data);
+    }
+  }
+  allocatingFunction(data);
+  std::vector<CallSite> call_sites = callSites();
+  ASSERT_FALSE(call_sites.empty());
+  uint64_t allocations = 0;
+  uint64_t bytes = 0;
+  for (const auto &call_site : call_sites) {
+    allocations += call_site.allocations;
+    bytes += call_site.bytes;
+  }
+  EXPECT_EQ(allocations, 2u);
+  EXPECT_EQ(bytes, 2 * sizeof(double));
+  clearCallSites();
+  EXPECT_TRUE(callSites().empty());
+}
+
+TEST(AllocationTrackerTests, RecordCallSitesOnTimerThread) {
+  clearCallSites();
+  std::vector<double> data;
+  AsyncTimer timer(recordingCallSites([&data]() { allocatingFunction(data); }),
+                   std::chrono::milliseconds(1));
+  timer.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  timer.stop();
+  std::vector<CallSite> call_sites = callSites();
+  ASSERT_FALSE(call_sites.empty());
+  std::string report = callSiteReport();
+  EXPECT_NE(report.find("allocatingFunction"), std::string::npos) << report;
+}
+
+TEST(AllocationTrackerTests, ControllerTimerHook) {
+  // Linking the tracker installs the hook
+  ASSERT_TRUE(ControllerTimerHook::installed());
+  clearCallSites();
+  std::vector<double> data;
+  {
+    ControllerTimerHook hook(false);
+    AsyncTimer timer(hook.wrap([&data]() { allocatingFunction(data); }),
+                     std::chrono::milliseconds(1));
+    timer.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  EXPECT_TRUE(callSites().empty());
+  {
+    ControllerTimerHook hook(true);
+    AsyncTimer timer(hook.wrap([&data]() { allocatingFunction(data); }),
+                     std::chrono::milliseconds(1));
+    timer.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  std::string report = callSiteReport();
+  EXPECT_NE(report.find("allocatingFunction"), std::string::npos) << report;
+}
+
+TEST(AllocationTrackerTests, QrotorBacksteppingKernel) {
+  QrotorBacksteppingControllerConfig config;
+  config.set_mass(1.3);
+  QrotorBacksteppingKernel kernel(config);
+  QrotorBacksteppingState state;
+  state.thrust = 12.0;
+  ParticleState desired_state;
+  desired_state.p = Eigen::Vector3d(1, 2, 3);
+  QrotorBacksteppingControl control;
+  EXPECT_NO_ALLOCATIONS([&]() {
+    kernel.run(state, desired_state, Snap(), control);
+  });
+}
+
+TEST(AllocationTrackerTests, RecursiveLeastSquares) {
+  using Estimator = RecursiveLeastSquares<3>;
+  Estimator estimator(Estimator::VectorNd::Zero(),
+                      Estimator::VectorNd::Ones());
+  Estimator::VectorNd phi(1, 2, 3);
+  EXPECT_NO_ALLOCATIONS([&]() { estimator.update(phi, 1.0); });
+}
+
+TEST(AllocationTrackerTests, ConnectorRun) {
+  SampleParser drone_hardware;
+  ManualRPYTController controller;
+  ManualRPYTControllerDroneConnector connector(drone_hardware, controller);
+  connector.setGoal(EmptyGoal());
+  EXPECT_NO_ALLOCATIONS([&connector]() { connector.run(); });
+  EXPECT_EQ(connector.getStatus(), ControllerStatus::Completed);
+}
+
+TEST(AllocationTrackerTests, ReportConnectorCallSitesOnControllerThread) {
+  SampleParser drone_hardware;
+  VelocityBasedPositionController controller;
+  AllocatingConnector connector(drone_hardware, controller);
+  connector.setGoal(PositionYaw(1, 2, 3, 0.5));
+  clearCallSites();
+  AsyncTimer timer(recordingCallSites([&connector]() { connector.run(); }),
+                   std::chrono::milliseconds(1));
+  timer.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  timer.stop();
+  // Every call site recorded on the controller thread is below the connector
+  std::vector<CallSite> call_sites = callSites();
+  ASSERT_FALSE(call_sites.empty());
+  for (const auto &call_site : call_sites) {
+    bool found_connector = false;
+    for (const auto &frame : call_site.frames) {
+      found_connector |=
+          frame.find("ControllerConnector") != std::string::npos;
+    }
+    EXPECT_TRUE(found_connector) << callSiteReport();
+  }
+  std::string report = callSiteReport();
+  EXPECT_NE(report.find("allocatingFunction"), std::string::npos) << report;
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
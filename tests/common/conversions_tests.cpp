@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include "aerial_autonomy/common/conversions.h"
+#include "aerial_autonomy/common/eigen_views.h"
 #include "aerial_autonomy/tests/test_utils.h"
 
 using namespace conversions;
@@ -38,6 +39,14 @@ TEST(PositionYawToTf, NegativeYaw) {
                                      tf::Vector3(-1, 2, 50)));
 }
 
+TEST(PositionYawToPose, MatchesTf) {
+  PositionYaw p(-1, 2, 50, -0.1);
+  tf::Transform p_tf;
+  positionYawToTf(p, p_tf);
+  ASSERT_TF_NEAR(toTf(positionYawToPose(p)), p_tf);
+  ASSERT_NEAR(positionYawToPose(p).yaw(), -0.1, 1e-8);
+}
+
 void compareProtoToTf(double x, double y, double z, double roll, double pitch,
                       double yaw) {
   config::Transform ptf;
@@ -172,6 +181,51 @@ TEST(ArmaToEigen, ConvertBack) {
   compareArma(m, m2);
 }
 
+TEST(EigenViews, TfVector) {
+  tf::Vector3 v(1, 2, 3);
+  auto v_eig = eigenView(v);
+  ASSERT_EQ(v_eig, Eigen::Vector3d(1, 2, 3));
+  // View aliases the tf vector
+  v_eig *= 2;
+  ASSERT_EQ(v.x(), 2);
+  ASSERT_EQ(v.y(), 4);
+  ASSERT_EQ(v.z(), 6);
+  ASSERT_EQ(toTf(v_eig + Eigen::Vector3d::Ones()), tf::Vector3(3, 5, 7));
+}
+
+TEST(EigenViews, TfMatrix) {
+  tf::Matrix3x3 m(1, 2, 3, 4, 5, 6, 7, 8, 9);
+  auto m_eig = eigenView(m);
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 3; ++j) {
+      ASSERT_EQ(m_eig(i, j), m[i][j]);
+    }
+  }
+}
+
+TEST(EigenViews, XYZView) {
+  Position p(1, 2, 3);
+  xyzView(p) += Eigen::Vector3d(1, 1, 1);
+  ASSERT_EQ(p, Position(2, 3, 4));
+  const Velocity v(1, 2, 3);
+  ASSERT_EQ(xyzView(v), Eigen::Vector3d(1, 2, 3));
+}
+
+TEST(EigenViews, Yaw) {
+  for (double yaw_in = -3.0; yaw_in < 3.0; yaw_in += 0.5) {
+    tf::Matrix3x3 m;
+    m.setRPY(0.3, -0.2, yaw_in);
+    double roll, pitch, yaw;
+    m.getRPY(roll, pitch, yaw);
+    ASSERT_NEAR(conversions::yaw(m), yaw, 1e-12);
+  }
+  tf::Matrix3x3 gimbal_lock;
+  gimbal_lock.setRPY(0.1, M_PI / 2, 0.5);
+  double roll, pitch, yaw;
+  gimbal_lock.getRPY(roll, pitch, yaw);
+  ASSERT_NEAR(conversions::yaw(gimbal_lock), yaw, 1e-12);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include <aerial_autonomy/common/epoch_gate.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+TEST(EpochGateTests, NoReaders) {
+  EpochGate gate;
+  ASSERT_EQ(gate.readers(), 0);
+  gate.synchronize();
+  gate.synchronize();
+}
+
+TEST(EpochGateTests, GuardLeavesGate) {
+  EpochGate gate;
+  {
+    EpochGate::Guard guard = gate.enter();
+    ASSERT_EQ(gate.readers(), 1);
+    EpochGate::Guard moved(std::move(guard));
+    ASSERT_EQ(gate.readers(), 1);
+  }
+  ASSERT_EQ(gate.readers(), 0);
+}
+
+TEST(EpochGateTests, SynchronizeWaitsForReader) {
+  EpochGate gate;
+  std::atomic<bool> entered(false);
+  std::atomic<bool> left(false);
+  std::thread reader([&]() {
+    EpochGate::Guard guard = gate.enter();
+    entered = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    left = true;
+  });
+  while (!entered) {
+    std::this_thread::yield();
+  }
+  gate.synchronize();
+  ASSERT_TRUE(left);
+  reader.join();
+}
+
+TEST(EpochGateTests, ReadersNeverSeeReclaimedObject) {
+  EpochGate gate;
+  std::atomic<int *> shared(new int(0));
+  std::atomic<bool> stop(false);
+  std::atomic<int> errors(0);
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&]() {
+      while (!stop) {
+        EpochGate::Guard guard = gate.enter();
+        int *value = shared.load();
+        // Reclaimed objects are set to -1 before deletion
+        if (*value < 0) {
+          ++errors;
+        }
+      }
+    });
+  }
+  for (int i = 1; i < 2000; ++i) {
+    int *previous = shared.exchange(new int(i));
+    gate.synchronize();
+    *previous = -1;
+    delete previous;
+  }
+  stop = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  delete shared.load();
+  ASSERT_EQ(errors, 0);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,86 @@
+#include "aerial_autonomy/common/frame_graph.h"
+#include "aerial_autonomy/tests/test_utils.h"
+
+#include <gtest/gtest.h>
+
+using namespace test_utils;
+
+/**
+* @brief Body frame moving in the world with a camera and an arm mounted on
+* the body
+*/
+class FrameGraphTests : public ::testing::Test {
+public:
+  FrameGraphTests()
+      : camera_transform_(Pose::fromRPY(-M_PI / 2, 0, -M_PI / 2,
+                                        Eigen::Vector3d(0.1, 0, 0))),
+        arm_transform_(
+            Pose::fromRPY(M_PI, 0, 0, Eigen::Vector3d(0.2, 0, -0.1))),
+        body_frame_(graph_.addDynamicFrame(FrameGraph::root)),
+        camera_frame_(graph_.addStaticFrame(body_frame_, camera_transform_)),
+        arm_frame_(graph_.addStaticFrame(body_frame_, arm_transform_)) {}
+
+protected:
+  FrameGraph graph_;      ///< Graph rooted at the world frame
+  Pose camera_transform_; ///< Camera pose in the body frame
+  Pose arm_transform_;    ///< Arm pose in the body frame
+  FrameGraph::FrameId body_frame_;   ///< Body frame
+  FrameGraph::FrameId camera_frame_; ///< Camera frame
+  FrameGraph::FrameId arm_frame_;    ///< Arm frame
+};
+
+TEST_F(FrameGraphTests, Identity) {
+  ASSERT_EQ(graph_.size(), 4u);
+  ASSERT_POSE_NEAR(graph_.getTransform(camera_frame_, camera_frame_), Pose());
+  // Dynamic pose is identity until set
+  ASSERT_POSE_NEAR(graph_.getTransform(FrameGraph::root, body_frame_), Pose());
+}
+
+TEST_F(FrameGraphTests, StaticTransforms) {
+  ASSERT_POSE_NEAR(graph_.getTransform(body_frame_, camera_frame_),
+                   camera_transform_);
+  ASSERT_POSE_NEAR(graph_.getTransform(camera_frame_, body_frame_),
+                   camera_transform_.inverse());
+  ASSERT_POSE_NEAR(graph_.getTransform(arm_frame_, camera_frame_),
+                   arm_transform_.inverse() * camera_transform_);
+}
+
+TEST_F(FrameGraphTests, DynamicTransforms) {
+  Pose body_pose = Pose::fromRPY(0.1, -0.2, 0.3, Eigen::Vector3d(1, 2, 3));
+  graph_.setDynamicPose(body_frame_, body_pose);
+  ASSERT_POSE_NEAR(graph_.getTransform(FrameGraph::root, camera_frame_),
+                   body_pose * camera_transform_);
+  ASSERT_POSE_NEAR(graph_.getTransform(camera_frame_, FrameGraph::root),
+                   camera_transform_.inverse() * body_pose.inverse());
+  // Cached transforms are composed again after the pose changes
+  body_pose.p = Eigen::Vector3d(-1, 0, 0.5);
+  graph_.setDynamicPose(body_frame_, body_pose);
+  ASSERT_POSE_NEAR(graph_.getTransform(FrameGraph::root, camera_frame_),
+                   body_pose * camera_transform_);
+  ASSERT_POSE_NEAR(graph_.getTransform(camera_frame_, FrameGraph::root),
+                   camera_transform_.inverse() * body_pose.inverse());
+  // Transforms within the body do not depend on the body pose
+  ASSERT_POSE_NEAR(graph_.getTransform(arm_frame_, camera_frame_),
+                   arm_transform_.inverse() * camera_transform_);
+}
+
+TEST_F(FrameGraphTests, AddFrameAfterLookup) {
+  graph_.getTransform(arm_frame_, camera_frame_);
+  Pose tool_transform = Pose::fromRPY(0, 0.5, 0, Eigen::Vector3d(0, 0, 0.3));
+  auto tool_frame = graph_.addStaticFrame(arm_frame_, tool_transform);
+  ASSERT_POSE_NEAR(graph_.getTransform(arm_frame_, camera_frame_),
+                   arm_transform_.inverse() * camera_transform_);
+  ASSERT_POSE_NEAR(graph_.getTransform(body_frame_, tool_frame),
+                   arm_transform_ * tool_transform);
+}
+
+TEST_F(FrameGraphTests, StaticPoseCannotChange) {
+  ASSERT_DEATH(
+      graph_.setDynamicPose(camera_frame_, Pose()),
+      "Pose of a static frame cannot change");
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
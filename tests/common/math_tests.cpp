@@ -93,6 +93,26 @@ TEST(HatTests, HatIsCrossProduct) {
   ASSERT_VEC_NEAR(v_hat_v2, m_v2_hat_v, 1e-6);
 }
 
+TEST(LyapunovTests, SolvesLyapunovEquation) {
+  Eigen::Matrix3d A;
+  A << -1, 2, 0, 0, -3, 1, 0.5, 0, -2;
+  Eigen::Matrix3d Q = Eigen::Vector3d(1, 2, 3).asDiagonal();
+  Eigen::Matrix3d P = math::lyapunov<3>(A, Q);
+  ASSERT_LT((A.transpose() * P + P * A + Q).norm(), 1e-10);
+  ASSERT_TRUE(P.isApprox(P.transpose()));
+  // P is positive definite since A is stable
+  ASSERT_GT(P.eigenvalues().real().minCoeff(), 0);
+}
+
+TEST(LyapunovTests, MatchesSylvester) {
+  Eigen::Matrix<double, 6, 6> A = Eigen::Matrix<double, 6, 6>::Random() -
+                                  5 * Eigen::Matrix<double, 6, 6>::Identity();
+  Eigen::Matrix<double, 6, 6> Q = Eigen::Matrix<double, 6, 6>::Identity();
+  Eigen::Matrix<double, 6, 6> P = math::lyapunov<6>(A, Q);
+  Eigen::MatrixXd P_sylvester = math::sylvester(A.transpose(), A, Q);
+  ASSERT_TRUE(P.isApprox(P_sylvester, 1e-9));
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
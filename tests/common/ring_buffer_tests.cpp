@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include "aerial_autonomy/common/ring_buffer.h"
+
+TEST(RingBufferTests, Constructor) {
+  ASSERT_NO_THROW((RingBuffer<int, 5>()));
+  ASSERT_NO_THROW((RingBuffer<int, 5>(3)));
+  ASSERT_THROW((RingBuffer<int, 5>(0)), std::out_of_range);
+  ASSERT_THROW((RingBuffer<int, 5>(6)), std::out_of_range);
+}
+
+TEST(RingBufferTests, PushPop) {
+  RingBuffer<int, 5> buffer;
+  ASSERT_TRUE(buffer.empty());
+  buffer.push(1);
+  buffer.push(2);
+  ASSERT_EQ(buffer.size(), 2);
+  ASSERT_EQ(buffer.front(), 1);
+  ASSERT_EQ(buffer.back(), 2);
+  buffer.pop();
+  ASSERT_EQ(buffer.size(), 1);
+  ASSERT_EQ(buffer.front(), 2);
+  buffer.pop();
+  ASSERT_TRUE(buffer.empty());
+  // Pop on empty buffer does nothing
+  buffer.pop();
+  ASSERT_TRUE(buffer.empty());
+}
+
+TEST(RingBufferTests, Overwrite) {
+  RingBuffer<int, 5> buffer(3);
+  for (int i = 0; i < 5; ++i) {
+    buffer.push(i);
+  }
+  ASSERT_TRUE(buffer.full());
+  ASSERT_EQ(buffer.size(), 3);
+  ASSERT_EQ(buffer.maxSize(), 3);
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_EQ(buffer[i], i + 2);
+  }
+  ASSERT_EQ(buffer.front(), 2);
+  ASSERT_EQ(buffer.back(), 4);
+}
+
+TEST(RingBufferTests, Clear) {
+  RingBuffer<int, 5> buffer;
+  buffer.push(1);
+  buffer.push(2);
+  buffer.clear();
+  ASSERT_TRUE(buffer.empty());
+  buffer.push(3);
+  ASSERT_EQ(buffer.front(), 3);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
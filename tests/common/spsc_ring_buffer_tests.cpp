@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include "aerial_autonomy/common/spsc_ring_buffer.h"
+
+#include <thread>
+
+TEST(SpscRingBufferTests, Constructor) {
+  ASSERT_NO_THROW(SpscRingBuffer<int>(1));
+  ASSERT_THROW(SpscRingBuffer<int>(0), std::out_of_range);
+}
+
+TEST(SpscRingBufferTests, PushPop) {
+  SpscRingBuffer<int> buffer(3);
+  int element;
+  ASSERT_FALSE(buffer.pop(element));
+  ASSERT_TRUE(buffer.push(1));
+  ASSERT_TRUE(buffer.push(2));
+  ASSERT_EQ(buffer.size(), 2u);
+  ASSERT_TRUE(buffer.pop(element));
+  ASSERT_EQ(element, 1);
+  ASSERT_TRUE(buffer.pop(element));
+  ASSERT_EQ(element, 2);
+  ASSERT_FALSE(buffer.pop(element));
+  ASSERT_EQ(buffer.size(), 0u);
+}
+
+TEST(SpscRingBufferTests, PushFull) {
+  SpscRingBuffer<int> buffer(3);
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(buffer.push(i));
+  }
+  // A full buffer keeps the buffered elements
+  ASSERT_FALSE(buffer.push(3));
+  ASSERT_EQ(buffer.size(), buffer.capacity());
+  int element;
+  ASSERT_TRUE(buffer.pop(element));
+  ASSERT_EQ(element, 0);
+  // Wrap around the storage
+  ASSERT_TRUE(buffer.push(4));
+  for (int expected : {1, 2, 4}) {
+    ASSERT_TRUE(buffer.pop(element));
+    ASSERT_EQ(element, expected);
+  }
+}
+
+TEST(SpscRingBufferTests, ProducerConsumer) {
+  SpscRingBuffer<int> buffer(64);
+  const int count = 100000;
+  std::thread producer([&buffer]() {
+    for (int i = 0; i < count; ++i) {
+      while (!buffer.push(i)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+  int expected = 0;
+  int element;
+  while (expected < count) {
+    if (buffer.pop(element)) {
+      ASSERT_EQ(element, expected);
+      ++expected;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+  ASSERT_FALSE(buffer.pop(element));
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -135,6 +135,21 @@ TEST(ThreadSafeStateMachineTests, MultiThreadDoubleCount) {
   t2.join();
   ASSERT_EQ(state_machine.count_value, 300);
 }
+
+TEST(ThreadSafeStateMachineTests, EventObserver) {
+  SampleStateMachine state_machine(0);
+  state_machine.start();
+  std::vector<std::type_index> events;
+  state_machine.setEventObserver(
+      [&](std::type_index event) { events.push_back(event); });
+  state_machine.process_event(SwitchToDoubleCount());
+  state_machine.process_event(DoubleCountEvt());
+  // The events processed by actions are observed as well
+  ASSERT_EQ(events, std::vector<std::type_index>(
+                        {typeid(SwitchToDoubleCount), typeid(DoubleCountEvt),
+                         typeid(Count), typeid(Count)}));
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
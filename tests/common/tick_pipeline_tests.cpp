@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <aerial_autonomy/common/tick_pipeline.h>
+
+#include <stdexcept>
+#include <thread>
+
+TEST(TickPipelineTests, Order) {
+  TickPipeline pipeline;
+  std::vector<std::string> calls;
+  pipeline.addStage("controller",
+                    [&calls]() { calls.push_back("controller"); });
+  pipeline.addStage("state_machine",
+                    [&calls]() { calls.push_back("state_machine"); });
+  pipeline.addStage("status", [&calls]() { calls.push_back("status"); });
+  pipeline.tick();
+  ASSERT_EQ(calls, std::vector<std::string>(
+                       {"controller", "state_machine", "status"}));
+}
+
+TEST(TickPipelineTests, Decimation) {
+  TickPipeline pipeline;
+  int controller_count = 0;
+  int status_count = 0;
+  pipeline.addStage("controller", [&]() { ++controller_count; });
+  pipeline.addStage("status", [&]() { ++status_count; }, 3);
+  for (int i = 0; i < 7; ++i) {
+    pipeline.tick();
+  }
+  ASSERT_EQ(controller_count, 7);
+  // Ticks 0, 3 and 6
+  ASSERT_EQ(status_count, 3);
+  std::vector<TickStageTiming> timings = pipeline.timings();
+  ASSERT_EQ(timings.size(), 3u);
+  ASSERT_EQ(timings[1].name, "status");
+  ASSERT_EQ(timings[1].calls, 3u);
+  ASSERT_EQ(timings[2].name, "tick");
+  ASSERT_EQ(timings[2].calls, 7u);
+}
+
+TEST(TickPipelineTests, Timings) {
+  TickPipeline pipeline;
+  pipeline.addStage("fast", []() {});
+  pipeline.addStage("slow", []() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  });
+  pipeline.tick();
+  pipeline.tick();
+  std::vector<TickStageTiming> timings = pipeline.timings();
+  ASSERT_EQ(timings[0].name, "fast");
+  ASSERT_LT(timings[0].max, 5e-3);
+  ASSERT_GE(timings[1].last, 5e-3);
+  ASSERT_GE(timings[1].mean, 5e-3);
+  ASSERT_GE(timings[1].max, timings[1].last);
+  ASSERT_GE(timings[2].last, timings[0].last + timings[1].last);
+  ASSERT_NE(pipeline.getStatus().find("slow"), std::string::npos);
+}
+
+TEST(TickPipelineTests, InvalidStages) {
+  TickPipeline pipeline;
+  ASSERT_THROW(pipeline.addStage("none", []() {}, 0), std::out_of_range);
+  pipeline.addStage("stage", []() {});
+  pipeline.tick();
+  ASSERT_THROW(pipeline.addStage("late", []() {}), std::logic_error);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
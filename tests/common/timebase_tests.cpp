@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include "aerial_autonomy/common/timebase.h"
+
+#include <thread>
+
+TEST(Timebase, Monotonic) {
+  int64_t start = timebase::now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  int64_t end = timebase::now();
+  ASSERT_GE(end - start, 10000000);
+  timebase::TimePoint time = timebase::Clock::now();
+  ASSERT_EQ(timebase::toNanoseconds(time + std::chrono::microseconds(1)),
+            timebase::toNanoseconds(time) + 1000);
+}
+
+TEST(Timebase, FromWallStamp) {
+  // Without ROS time, stamps are treated as wall time
+  ros::Time stamp;
+  stamp.fromNSec(timebase::wallTime() - 500000000);
+  int64_t time = timebase::toNanoseconds(timebase::fromRosTime(stamp));
+  ASSERT_NEAR((timebase::now() - time) * 1e-9, 0.5, 0.05);
+  ASSERT_EQ(timebase::rosTime(), 0);
+}
+
+TEST(Timebase, SameStampSameTime) {
+  ros::Time stamp;
+  stamp.fromNSec(timebase::wallTime() - 20000000);
+  timebase::TimePoint time = timebase::fromRosTime(stamp);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  ASSERT_EQ(timebase::fromRosTime(stamp), time);
+}
+
+TEST(Timebase, StampOrderKept) {
+  ros::Time stamp;
+  stamp.fromNSec(timebase::wallTime());
+  timebase::TimePoint last_time = timebase::fromRosTime(stamp);
+  for (int i = 0; i < 1000; ++i) {
+    stamp.fromNSec(stamp.toNSec() + 1000);
+    timebase::TimePoint time = timebase::fromRosTime(stamp);
+    ASSERT_GT(time, last_time);
+    last_time = time;
+  }
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <aerial_autonomy/common/async_timer.h>
+#include <aerial_autonomy/common/worker_pool.h>
+
+#include <atomic>
+#include <stdexcept>
+
+TEST(WorkerPoolTests, NoThreads) {
+  ASSERT_THROW(WorkerPool(0), std::out_of_range);
+}
+
+TEST(WorkerPoolTests, Period) {
+  WorkerPool pool(2);
+  ASSERT_EQ(pool.threadCount(), 2u);
+  std::atomic<int> count(0);
+  int id = pool.schedule([&count]() { ++count; },
+                         std::chrono::milliseconds(20));
+  ASSERT_EQ(pool.taskCount(), 1u);
+  std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+  pool.cancel(id);
+  ASSERT_EQ(pool.taskCount(), 0u);
+  ASSERT_GE(count, 49);
+  ASSERT_LE(count, 51);
+  int cancelled_count = count;
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_EQ(count, cancelled_count);
+}
+
+TEST(WorkerPoolTests, ManyTasksFewThreads) {
+  WorkerPool pool(2);
+  const int task_count = 100;
+  std::vector<std::atomic<int>> counts(task_count);
+  std::vector<int> ids;
+  for (int i = 0; i < task_count; ++i) {
+    counts[i] = 0;
+    std::atomic<int> &count = counts[i];
+    ids.push_back(
+        pool.schedule([&count]() { ++count; }, std::chrono::milliseconds(10)));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  for (int id : ids) {
+    pool.cancel(id);
+  }
+  for (auto &count : counts) {
+    ASSERT_GE(count, 10);
+  }
+}
+
+TEST(WorkerPoolTests, NoConcurrentCalls) {
+  WorkerPool pool(4);
+  std::atomic<int> running(0);
+  std::atomic<int> max_running(0);
+  std::atomic<int> count(0);
+  int id = pool.schedule(
+      [&]() {
+        int now_running = ++running;
+        if (now_running > max_running) {
+          max_running = now_running;
+        }
+        // Overrun the period
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        ++count;
+        --running;
+      },
+      std::chrono::milliseconds(1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  pool.cancel(id);
+  ASSERT_EQ(max_running, 1);
+  // Missed periods are skipped instead of being caught up
+  ASSERT_LE(count, 21);
+  ASSERT_EQ(running, 0);
+}
+
+TEST(WorkerPoolTests, CancelWaitsForCall) {
+  WorkerPool pool(1);
+  std::atomic<bool> started(false);
+  std::atomic<bool> finished(false);
+  int id = pool.schedule(
+      [&]() {
+        started = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        finished = true;
+      },
+      std::chrono::milliseconds(100));
+  while (!started) {
+    std::this_thread::yield();
+  }
+  pool.cancel(id);
+  ASSERT_TRUE(finished);
+}
+
+TEST(WorkerPoolTests, CancelFromTask) {
+  WorkerPool pool(1);
+  std::atomic<int> count(0);
+  int id = -1;
+  std::atomic<bool> scheduled(false);
+  id = pool.schedule(
+      [&]() {
+        while (!scheduled) {
+          std::this_thread::yield();
+        }
+        ++count;
+        pool.cancel(id);
+      },
+      std::chrono::milliseconds(1));
+  scheduled = true;
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_EQ(count, 1);
+  ASSERT_EQ(pool.taskCount(), 0u);
+}
+
+TEST(WorkerPoolTests, AsyncTimer) {
+  WorkerPool pool(1);
+  std::atomic<int> count(0);
+  AsyncTimer timer([&count]() { ++count; }, std::chrono::milliseconds(20),
+                   &pool);
+  timer.start();
+  ASSERT_THROW(timer.start(), std::logic_error);
+  ASSERT_EQ(pool.taskCount(), 1u);
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  timer.setDuration(std::chrono::milliseconds(40));
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  timer.stop();
+  ASSERT_EQ(pool.taskCount(), 0u);
+  ASSERT_GE(count, 36);
+  ASSERT_LE(count, 40);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -2,6 +2,9 @@
 #include <aerial_autonomy/tests/sample_robot_system.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <thread>
+
 //// \brief Definitions
 ///  Define any necessary subclasses for tests here
 struct SampleController : public Controller<int, int, int> {
@@ -59,6 +62,82 @@ protected:
   LowlevelSampleControllerConnector &lowlevel_connector_;
 };
 
+/**
+* @brief Connector counting runs in progress to detect runs overlapping with
+* its disengagement
+*/
+class StressConnector : public ControllerConnector<int, int, int> {
+public:
+  StressConnector(Controller<int, int, int> &controller,
+                  ControllerGroup controller_group,
+                  StressConnector *dependent_connector = nullptr)
+      : ControllerConnector<int, int, int>(controller, controller_group),
+        dependent_connector_(dependent_connector), runs_in_progress_(0),
+        runs_(0), overlaps_(0) {}
+  virtual void run() {
+    ++runs_in_progress_;
+    ++runs_;
+    ControllerConnector<int, int, int>::run();
+    // Widen the window in which an abort could overlap the run
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+    --runs_in_progress_;
+  }
+  virtual void disengage() {
+    if (runs_in_progress_ != 0) {
+      ++overlaps_;
+    }
+    ControllerConnector<int, int, int>::disengage();
+  }
+  virtual void sendControllerCommands(int control) {
+    if (dependent_connector_) {
+      dependent_connector_->setGoal(control);
+    }
+  }
+  virtual bool extractSensorData(int &sensor_data) {
+    sensor_data = 0;
+    return true;
+  }
+  virtual AbstractControllerConnector *getDependentConnector() {
+    return dependent_connector_;
+  }
+
+  StressConnector *dependent_connector_; ///< Connector receiving commands
+  std::atomic<int> runs_in_progress_;    ///< Runs not finished yet
+  std::atomic<int> runs_;                ///< Number of runs
+  std::atomic<int> overlaps_; ///< Disengagements during a run
+};
+
+/**
+* @brief Low level connectors of the stress test
+*/
+struct LowlevelStressConnector : public StressConnector {
+  LowlevelStressConnector(Controller<int, int, int> &controller)
+      : StressConnector(controller, ControllerGroup::UAV) {}
+};
+
+/**
+* @brief High level connector of the stress test driving a low level one
+*/
+struct HighlevelStressConnector : public StressConnector {
+  HighlevelStressConnector(Controller<int, int, int> &controller,
+                           StressConnector &lowlevel_connector)
+      : StressConnector(controller, ControllerGroup::Arm,
+                        &lowlevel_connector) {}
+};
+
+/**
+* @brief Connector whose initialization waits for a flag
+*/
+struct BlockingConnector : public LowlevelSampleControllerConnector {
+  BlockingConnector(Controller<int, int, int> &controller)
+      : LowlevelSampleControllerConnector(controller), release_(false) {}
+  virtual void initialize() {
+    while (!release_) {
+      std::this_thread::yield();
+    }
+  }
+  std::atomic<bool> release_; ///< Whether initialization can finish
+};
 ////
 
 /// \brief TEST
@@ -148,6 +227,96 @@ TEST(SampleRobotSystemTest, DependentConnectorAbort) {
   robot_system.runActiveController(ControllerGroup::UAV);
   ASSERT_EQ(controller1.control_, 0);
 }
+
+TEST(SampleRobotSystemTest, RunDoesNotWaitForActivation) {
+  SampleController controller1, controller2;
+  LowlevelSampleControllerConnector active_connector(controller1);
+  BlockingConnector blocking_connector(controller2);
+  SampleRobotSystem robot_system;
+  robot_system.addControllerConnector(active_connector);
+  robot_system.setGoal<LowlevelSampleControllerConnector>(1);
+  std::thread activation([&]() {
+    robot_system.activateControllerConnector(&blocking_connector);
+  });
+  // Runs and status queries proceed while the activation is blocked
+  for (int i = 0; i < 10; ++i) {
+    controller1.control_ = 0;
+    robot_system.runActiveController(ControllerGroup::UAV);
+    ASSERT_EQ(controller1.control_, 2);
+    ASSERT_EQ(robot_system.getStatus<LowlevelSampleControllerConnector>(),
+              ControllerStatus::Completed);
+    ASSERT_EQ(robot_system.getActiveControllerStatus(ControllerGroup::UAV),
+              ControllerStatus::Completed);
+  }
+  blocking_connector.release_ = true;
+  activation.join();
+  ASSERT_EQ(robot_system.getStatus<LowlevelSampleControllerConnector>(),
+            ControllerStatus::NotEngaged);
+}
+
+TEST(SampleRobotSystemTest, ConcurrentSwitchStress) {
+  SampleController lowlevel_controller1, lowlevel_controller2,
+      highlevel_controller;
+  LowlevelStressConnector lowlevel_connector(lowlevel_controller1);
+  StressConnector other_lowlevel_connector(lowlevel_controller2,
+                                           ControllerGroup::UAV);
+  HighlevelStressConnector highlevel_connector(highlevel_controller,
+                                               lowlevel_connector);
+  SampleRobotSystem robot_system;
+  robot_system.addControllerConnector(lowlevel_connector);
+  robot_system.addControllerConnector(other_lowlevel_connector);
+  robot_system.addControllerConnector(highlevel_connector);
+  std::atomic<bool> stop(false);
+  std::vector<std::thread> threads;
+  // One run thread per group as in the system handlers
+  for (auto group : {ControllerGroup::UAV, ControllerGroup::Arm}) {
+    threads.emplace_back([&, group]() {
+      while (!stop) {
+        robot_system.runActiveController(group);
+      }
+    });
+  }
+  // Threads switching controllers and reading statuses
+  threads.emplace_back([&]() {
+    for (int i = 0; !stop; ++i) {
+      robot_system.setGoal<HighlevelStressConnector>(i);
+      robot_system.abortController(ControllerGroup::Arm);
+    }
+  });
+  threads.emplace_back([&]() {
+    for (int i = 0; !stop; ++i) {
+      robot_system.setGoal<LowlevelStressConnector>(i);
+      robot_system.activateControllerConnector(&other_lowlevel_connector);
+      robot_system.abortController(ControllerGroup::UAV);
+    }
+  });
+  threads.emplace_back([&]() {
+    for (int i = 0; !stop; ++i) {
+      robot_system.updateGoal<LowlevelStressConnector>(i);
+      robot_system.getStatus<HighlevelStressConnector>();
+      robot_system.getActiveControllerStatus(ControllerGroup::UAV);
+    }
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  stop = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  robot_system.abortController(ControllerGroup::Arm);
+  robot_system.abortController(ControllerGroup::UAV);
+  for (StressConnector *connector :
+       {static_cast<StressConnector *>(&lowlevel_connector),
+        &other_lowlevel_connector,
+        static_cast<StressConnector *>(&highlevel_connector)}) {
+    ASSERT_GT(connector->runs_, 0);
+    ASSERT_EQ(connector->overlaps_, 0);
+    ASSERT_EQ(connector->runs_in_progress_, 0);
+  }
+  ASSERT_EQ(robot_system.getActiveControllerStatus(ControllerGroup::UAV),
+            ControllerStatus::NotEngaged);
+  ASSERT_EQ(robot_system.getActiveControllerStatus(ControllerGroup::Arm),
+            ControllerStatus::NotEngaged);
+}
 ///
 
 int main(int argc, char **argv) {
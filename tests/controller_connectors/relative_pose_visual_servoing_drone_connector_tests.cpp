@@ -2,6 +2,7 @@
 #include <gtest/gtest.h>
 
 #include <aerial_autonomy/common/conversions.h>
+#include <aerial_autonomy/common/eigen_views.h>
 #include <aerial_autonomy/controller_connectors/relative_pose_visual_servoing_controller_drone_connector.h>
 #include <aerial_autonomy/controllers/velocity_based_relative_pose_controller.h>
 #include <aerial_autonomy/tests/test_utils.h>
@@ -138,10 +139,10 @@ TEST_F(RelativePoseVisualServoingControllerDroneConnectorTests,
   // Get vector
   tf::Transform object_pose_cam;
   ASSERT_TRUE(simple_tracker_->getTrackingVector(object_pose_cam));
-  tf::Transform tracking_vector =
+  Pose tracking_vector =
       visual_servoing_connector_
           ->getTrackingTransformRotationCompensatedQuadFrame(object_pose_cam);
-  ASSERT_TF_NEAR(tracking_vector, goal_rot_comp, 1e-6);
+  ASSERT_POSE_NEAR(tracking_vector, conversions::toPose(goal_rot_comp), 1e-6);
 }
 
 TEST_F(RelativePoseVisualServoingControllerDroneConnectorTests,
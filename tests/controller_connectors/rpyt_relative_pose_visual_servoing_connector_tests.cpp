@@ -172,14 +172,14 @@ TEST_F(RPYTRelativePoseVisualConnectorTests,
 }
 
 TEST_F(RPYTRelativePoseVisualConnectorTests, TestViewingAngle) {
-  tf::Transform object_pose_cam(tf::createQuaternionFromRPY(M_PI / 2, 0, 0),
-                                tf::Vector3(1, 0, 0));
+  Pose object_pose_cam =
+      Pose::fromRPY(M_PI / 2, 0, 0, Eigen::Vector3d(1, 0, 0));
   ASSERT_NEAR(visual_servoing_connector_->getViewingAngle(object_pose_cam),
               M_PI / 2, 1e-8);
-  object_pose_cam.setOrigin(tf::Vector3(0, 0, 1));
+  object_pose_cam.p = Eigen::Vector3d(0, 0, 1);
   ASSERT_NEAR(visual_servoing_connector_->getViewingAngle(object_pose_cam), 0,
               1e-8);
-  object_pose_cam.setOrigin(tf::Vector3(0, 1, 1));
+  object_pose_cam.p = Eigen::Vector3d(0, 1, 1);
   ASSERT_NEAR(visual_servoing_connector_->getViewingAngle(object_pose_cam),
               M_PI / 4, 1e-8);
 }
@@ -3,6 +3,8 @@
 #include <aerial_autonomy/common/conversions.h>
 #include <aerial_autonomy/controller_connectors/visual_servoing_controller_arm_connector.h>
 #include <aerial_autonomy/controllers/relative_pose_controller.h>
+#include <aerial_autonomy/simulators/arm_dynamics_simulator.h>
+#include <aerial_autonomy/tests/test_utils.h>
 #include <aerial_autonomy/trackers/simple_tracker.h>
 
 #include <arm_parsers/arm_simulator.h>
@@ -49,7 +51,7 @@ public:
 TEST_F(VisualServoingControllerArmConnectorTests, Constructor) {}
 
 TEST_F(VisualServoingControllerArmConnectorTests, CriticalRun) {
-  visual_servoing_connector_->setGoal(tf::Transform());
+  visual_servoing_connector_->setGoal(Pose());
   // make tracking invalid:
   simple_tracker_->setTrackingIsValid(false);
   // Run connector
@@ -63,15 +65,12 @@ TEST_F(VisualServoingControllerArmConnectorTests, GetTrackingPoseArmFrame) {
   Position roi_goal(2, 0, 0.5);
   simple_tracker_->setTargetPositionGlobalFrame(roi_goal);
   // Get goal
-  tf::Transform tracking_pose;
-  tf::Transform expected_tracking_pose(tf::createQuaternionFromRPY(M_PI, 0, 0),
-                                       tf::Vector3(2, 0, -0.5));
+  Pose tracking_pose;
+  Pose expected_tracking_pose =
+      Pose::fromRPY(M_PI, 0, 0, Eigen::Vector3d(2, 0, -0.5));
   ASSERT_TRUE(
       visual_servoing_connector_->getTrackingPoseArmFrame(tracking_pose));
-  ASSERT_EQ(tracking_pose.getOrigin(), expected_tracking_pose.getOrigin());
-  ASSERT_NEAR(tracking_pose.getRotation().angleShortestPath(
-                  expected_tracking_pose.getRotation()),
-              0., 1e-8);
+  test_utils::ASSERT_POSE_NEAR(tracking_pose, expected_tracking_pose);
 }
 
 TEST_F(VisualServoingControllerArmConnectorTests, SetGoal) {
@@ -84,8 +83,8 @@ TEST_F(VisualServoingControllerArmConnectorTests, SetGoal) {
   // Enable arm
   arm_hardware_.sendCmd(ArmParser::POWER_ON);
   // Set goal
-  tf::Transform relative_pose(tf::Quaternion(0, 0, 0, 1),
-                              tf::Vector3(-0.5, 0, 0.1));
+  Pose relative_pose(Eigen::Matrix3d::Identity(),
+                     Eigen::Vector3d(-0.5, 0, 0.1));
   visual_servoing_connector_->setGoal(relative_pose);
   // Run controller 100 times
   while (visual_servoing_connector_->getStatus() == ControllerStatus::Active) {
@@ -106,6 +105,103 @@ TEST_F(VisualServoingControllerArmConnectorTests, SetGoal) {
             ControllerStatus::Completed);
 }
 
+/**
+* @brief Connector solving the inverse kinematics of a simulated 6 joint arm
+* reaching 0.45 m
+*/
+class VisualServoingControllerArmConnectorIKTests : public ::testing::Test {
+public:
+  VisualServoingControllerArmConnectorIKTests()
+      : camera_transform_(tf::Matrix3x3(0, 0, 1, -1, 0, 0, 0, -1, 0)),
+        arm_transform_(tf::Matrix3x3(1, 0, 0, 0, -1, 0, 0, 0, -1)),
+        simple_tracker_(drone_hardware_, camera_transform_) {
+    PoseControllerConfig controller_config;
+    auto position_tolerance =
+        controller_config.mutable_goal_position_tolerance();
+    position_tolerance->set_x(0.01);
+    position_tolerance->set_y(0.01);
+    position_tolerance->set_z(0.01);
+    controller_.reset(new RelativePoseController(controller_config));
+    *ik_config_.mutable_kinematics_config() =
+        ArmDynamicsSimulator::kinematicsConfig(ArmDynamicsSimulatorConfig());
+    // Target 0.6 m in front of the UAV at the takeoff altitude
+    simple_tracker_.setTargetPositionGlobalFrame(Position(0.6, 0, 0.5));
+    drone_hardware_.setBatteryPercent(60);
+    drone_hardware_.takeoff();
+    arm_hardware_.sendCmd(ArmParser::POWER_ON);
+    arm_hardware_.advance(std::chrono::milliseconds(1));
+  }
+
+  /**
+   * @brief Create the connector, set the goal relative to the target and run
+   * the connector at 50 Hz of simulated time
+   *
+   * @param relative_position Goal position relative to the target
+   * @param ticks Maximum number of runs
+   */
+  void runConnector(Eigen::Vector3d relative_position, int ticks) {
+    visual_servoing_connector_.reset(new VisualServoingControllerArmConnector(
+        simple_tracker_, drone_hardware_, arm_hardware_, *controller_,
+        camera_transform_, arm_transform_, ik_config_));
+    // Rotation cancels the upside down arm
+    visual_servoing_connector_->setGoal(
+        Pose::fromRPY(M_PI, 0, 0, relative_position));
+    for (int tick = 0; tick < ticks; ++tick) {
+      visual_servoing_connector_->run();
+      if (visual_servoing_connector_->getStatus() !=
+          ControllerStatus::Active) {
+        break;
+      }
+      arm_hardware_.advance(std::chrono::milliseconds(20));
+    }
+  }
+
+  /**
+   * @brief End effector position in arm frame
+   */
+  Eigen::Vector3d endEffectorPosition() {
+    return arm_hardware_.getEndEffectorTransform().topRightCorner<3, 1>();
+  }
+
+  tf::Transform camera_transform_; ///< Front facing camera
+  tf::Transform arm_transform_;    ///< Upside down arm
+  ArmDynamicsSimulator arm_hardware_;
+  QuadSimulator drone_hardware_;
+  SimpleTracker simple_tracker_;
+  std::unique_ptr<RelativePoseController> controller_;
+  ArmInverseKinematicsConfig ik_config_;
+  std::unique_ptr<VisualServoingControllerArmConnector>
+      visual_servoing_connector_;
+};
+
+TEST_F(VisualServoingControllerArmConnectorIKTests, ReachGoal) {
+  runConnector(Eigen::Vector3d(-0.3, 0, 0.1), 500);
+  ASSERT_EQ(visual_servoing_connector_->getStatus(),
+            ControllerStatus::Completed);
+  ASSERT_TRUE(endEffectorPosition().isApprox(Eigen::Vector3d(0.3, 0, -0.1),
+                                             0.01));
+}
+
+TEST_F(VisualServoingControllerArmConnectorIKTests, SkipUnreachableGoal) {
+  Eigen::Vector3d start_position = endEffectorPosition();
+  runConnector(Eigen::Vector3d(0.2, 0, 0.1), 50);
+  ASSERT_EQ(visual_servoing_connector_->getStatus(),
+            ControllerStatus::Active);
+  ASSERT_TRUE(endEffectorPosition().isApprox(start_position));
+}
+
+TEST_F(VisualServoingControllerArmConnectorIKTests, ClampUnreachableGoal) {
+  ik_config_.set_clamp_unreachable_goals(true);
+  // Goal 0.6 m above the arm
+  runConnector(Eigen::Vector3d(-0.6, 0, -0.6), 200);
+  ASSERT_EQ(visual_servoing_connector_->getStatus(),
+            ControllerStatus::Active);
+  Eigen::Vector3d position = endEffectorPosition();
+  ASSERT_NEAR(position.x(), 0, 0.05);
+  ASSERT_NEAR(position.y(), 0, 0.05);
+  ASSERT_GT(position.z(), 0.35);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
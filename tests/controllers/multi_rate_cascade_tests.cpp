@@ -0,0 +1,142 @@
+#include "aerial_autonomy/controllers/multi_rate_cascade.h"
+#include "aerial_autonomy/controllers/rpyt_based_position_controller.h"
+
+#include <gtest/gtest.h>
+
+class MultiRateCascadeTests : public ::testing::Test {
+public:
+  MultiRateCascadeTests()
+      : inner_period_(std::chrono::milliseconds(5)), outer_runs_(0) {
+    config_.set_outer_loop_period(0.02);
+  }
+
+  /**
+   * @brief Step a cascade whose outer loop returns the number of runs
+   *
+   * @param cascade Cascade to step
+   * @param milliseconds Time of the step
+   * @return Inner loop setpoint
+   */
+  double step(MultiRateCascade<double> &cascade, int milliseconds) {
+    double setpoint = -1;
+    EXPECT_TRUE(cascade.step(start_ + std::chrono::milliseconds(milliseconds),
+                             [this](double &outer_setpoint) {
+                               outer_setpoint = ++outer_runs_;
+                               return true;
+                             },
+                             setpoint));
+    return setpoint;
+  }
+
+protected:
+  MultiRateCascadeConfig config_;
+  std::chrono::duration<double> inner_period_;
+  timebase::TimePoint start_;
+  int outer_runs_;
+};
+
+TEST_F(MultiRateCascadeTests, OuterPeriod) {
+  ASSERT_DOUBLE_EQ(
+      MultiRateCascade<double>::outerPeriod(config_, inner_period_).count(),
+      0.02);
+  config_.clear_outer_loop_period();
+  ASSERT_DOUBLE_EQ(
+      MultiRateCascade<double>::outerPeriod(config_, inner_period_).count(),
+      0.005);
+}
+
+TEST_F(MultiRateCascadeTests, EveryTick) {
+  config_.clear_outer_loop_period();
+  MultiRateCascade<double> cascade(config_, inner_period_);
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(step(cascade, 5 * i), i + 1);
+  }
+  ASSERT_EQ(cascade.outerRuns(), 10u);
+}
+
+TEST_F(MultiRateCascadeTests, Hold) {
+  MultiRateCascade<double> cascade(config_, inner_period_);
+  // The outer loop runs every fourth inner tick
+  for (int i = 0; i < 12; ++i) {
+    ASSERT_EQ(step(cascade, 5 * i), i / 4 + 1);
+  }
+  ASSERT_EQ(cascade.outerRuns(), 3u);
+}
+
+TEST_F(MultiRateCascadeTests, Linear) {
+  config_.set_setpoint_interpolation(MultiRateCascadeConfig::LINEAR);
+  MultiRateCascade<double> cascade(config_, inner_period_);
+  // The first setpoint is used directly
+  ASSERT_EQ(step(cascade, 0), 1);
+  ASSERT_EQ(step(cascade, 10), 1);
+  // Ramp from 1 to 2 over the outer period
+  ASSERT_EQ(step(cascade, 20), 1);
+  ASSERT_DOUBLE_EQ(step(cascade, 25), 1.25);
+  ASSERT_DOUBLE_EQ(step(cascade, 35), 1.75);
+  ASSERT_EQ(step(cascade, 40), 2);
+}
+
+TEST_F(MultiRateCascadeTests, JitterKeepsOuterRate) {
+  MultiRateCascade<double> cascade(config_, inner_period_);
+  // Late ticks do not delay the following outer runs
+  step(cascade, 0);
+  step(cascade, 18);
+  ASSERT_EQ(step(cascade, 23), 2);
+  ASSERT_EQ(step(cascade, 38), 2);
+  ASSERT_EQ(step(cascade, 40), 3);
+}
+
+TEST_F(MultiRateCascadeTests, RestartAfterGap) {
+  config_.set_setpoint_interpolation(MultiRateCascadeConfig::LINEAR);
+  MultiRateCascade<double> cascade(config_, inner_period_);
+  step(cascade, 0);
+  step(cascade, 20);
+  // Not stepped for longer than the outer period, e.g. disengaged
+  ASSERT_EQ(step(cascade, 100), 3);
+  ASSERT_EQ(step(cascade, 105), 3);
+}
+
+TEST_F(MultiRateCascadeTests, OuterFailure) {
+  MultiRateCascade<double> cascade(config_, inner_period_);
+  double setpoint = 0;
+  ASSERT_FALSE(cascade.step(start_,
+                            [](double &) { return false; }, setpoint));
+  ASSERT_EQ(cascade.outerRuns(), 0u);
+  // The outer loop runs again on the next tick
+  ASSERT_EQ(step(cascade, 5), 1);
+  ASSERT_EQ(step(cascade, 10), 1);
+}
+
+TEST(MultiRateCascadeControllerTests, PositionLoopHeld) {
+  RPYTBasedPositionControllerConfig config;
+  // Position loop much slower than the test
+  config.mutable_cascade_config()->set_outer_loop_period(10);
+  RPYTBasedPositionController controller(config,
+                                         std::chrono::milliseconds(5));
+  controller.setGoal(PositionYaw(1, 0, 0, 0));
+  RollPitchYawRateThrust first_control;
+  auto sensor_data =
+      std::make_tuple(VelocityYawRate(0, 0, 0, 0), PositionYaw(0, 0, 0, 0));
+  ASSERT_TRUE(controller.run(sensor_data, first_control));
+  // Moving the vehicle does not change the held velocity command
+  std::get<1>(sensor_data).x = 0.5;
+  RollPitchYawRateThrust control;
+  ASSERT_TRUE(controller.run(sensor_data, control));
+  ASSERT_DOUBLE_EQ(control.p, first_control.p);
+  ASSERT_DOUBLE_EQ(control.r, first_control.r);
+  // The position loop runs on every tick by default
+  config.clear_cascade_config();
+  RPYTBasedPositionController every_tick_controller(
+      config, std::chrono::milliseconds(5));
+  every_tick_controller.setGoal(PositionYaw(1, 0, 0, 0));
+  std::get<1>(sensor_data).x = 0;
+  ASSERT_TRUE(every_tick_controller.run(sensor_data, first_control));
+  std::get<1>(sensor_data).x = 0.5;
+  ASSERT_TRUE(every_tick_controller.run(sensor_data, control));
+  ASSERT_NE(control.p, first_control.p);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -3,10 +3,11 @@
 #include "aerial_autonomy/types/discrete_reference_trajectory_interpolate.h"
 #include "qrotor_backstepping_controller_config.pb.h"
 
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <gcop/hrotor.h>
-#include <tf_conversions/tf_eigen.h>
+#include <thread>
 
 #include <gtest/gtest.h>
 
@@ -60,21 +61,21 @@ public:
       qrotor_state.thrust += qrotor_state.thrust_dot * dt.count();
 
       Body3dState xa;
-      tf::matrixTFToEigen(qrotor_state.pose.getBasis(), xa.R);
-      tf::vectorTFToEigen(qrotor_state.pose.getOrigin(), xa.p);
-      tf::vectorTFToEigen(qrotor_state.w, xa.w);
-      tf::vectorTFToEigen(qrotor_state.v, xa.v);
+      xa.R = qrotor_state.R;
+      xa.p = qrotor_state.p;
+      xa.w = qrotor_state.w;
+      xa.v = qrotor_state.v;
 
       Body3dState xb;
-      Eigen::Vector4d controls_eig(controls.torque.x(), controls.torque.y(),
-                                   controls.torque.z(), qrotor_state.thrust);
+      Eigen::Vector4d controls_eig;
+      controls_eig << controls.torque, qrotor_state.thrust;
       sys.Step(xb, time, xa, controls_eig, dt.count());
       time += dt.count();
 
-      tf::matrixEigenToTF(xb.R, qrotor_state.pose.getBasis());
-      tf::vectorEigenToTF(xb.p, qrotor_state.pose.getOrigin());
-      tf::vectorEigenToTF(xb.w, qrotor_state.w);
-      tf::vectorEigenToTF(xb.v, qrotor_state.v);
+      qrotor_state.R = xb.R;
+      qrotor_state.p = xb.p;
+      qrotor_state.w = xb.w;
+      qrotor_state.v = xb.v;
 
       return bool(controller.isConverged(sensor_data));
     };
@@ -102,15 +103,15 @@ TEST_F(QrotorBacksteppingControllerTests, Convergence) {
   }
 
   QrotorBacksteppingState qrotor_state;
-  qrotor_state.pose.setOrigin(tf::Vector3(3, -3, 1));
+  qrotor_state.p = Eigen::Vector3d(3, -3, 1);
   testConvergence(ref, qrotor_state);
 
   // Non-zero linear velocity
-  qrotor_state.v = tf::Vector3(1, 1, -1);
+  qrotor_state.v = Eigen::Vector3d(1, 1, -1);
   testConvergence(ref, qrotor_state);
 
   // Non-zero angular velocity
-  qrotor_state.w = tf::Vector3(M_PI / 6, -M_PI / 4, 0);
+  qrotor_state.w = Eigen::Vector3d(M_PI / 6, -M_PI / 4, 0);
   testConvergence(ref, qrotor_state);
 }
 
@@ -122,18 +123,18 @@ TEST_F(QrotorBacksteppingControllerTests, ConvergenceSpiral) {
   for (double t = 0; t < 200; t += 0.05) {
     ref->ts.push_back(t);
     ParticleState desired_state;
-    desired_state.p.x = cos(w_xy * t);
-    desired_state.p.y = sin(w_xy * t);
-    desired_state.p.z = sin(w_z * t) + 3;
-    desired_state.v.x = w_xy * -sin(w_xy * t);
-    desired_state.v.y = w_xy * cos(w_xy * t);
-    desired_state.v.z = w_z * cos(w_z * t);
-    desired_state.a.x = std::pow(w_xy, 2) * -cos(w_xy * t);
-    desired_state.a.y = std::pow(w_xy, 2) * -sin(w_xy * t);
-    desired_state.a.z = std::pow(w_z, 2) * -sin(w_z * t);
-    desired_state.j.x = std::pow(w_xy, 3) * sin(w_xy * t);
-    desired_state.j.y = std::pow(w_xy, 3) * -cos(w_xy * t);
-    desired_state.j.z = std::pow(w_z, 3) * -cos(w_z * t);
+    desired_state.p.x() = cos(w_xy * t);
+    desired_state.p.y() = sin(w_xy * t);
+    desired_state.p.z() = sin(w_z * t) + 3;
+    desired_state.v.x() = w_xy * -sin(w_xy * t);
+    desired_state.v.y() = w_xy * cos(w_xy * t);
+    desired_state.v.z() = w_z * cos(w_z * t);
+    desired_state.a.x() = std::pow(w_xy, 2) * -cos(w_xy * t);
+    desired_state.a.y() = std::pow(w_xy, 2) * -sin(w_xy * t);
+    desired_state.a.z() = std::pow(w_z, 2) * -sin(w_z * t);
+    desired_state.j.x() = std::pow(w_xy, 3) * sin(w_xy * t);
+    desired_state.j.y() = std::pow(w_xy, 3) * -cos(w_xy * t);
+    desired_state.j.z() = std::pow(w_z, 3) * -cos(w_z * t);
 
     Snap desired_control(std::pow(w_xy, 4) * cos(w_xy * t),
                          std::pow(w_xy, 4) * sin(w_xy * t),
@@ -147,11 +148,11 @@ TEST_F(QrotorBacksteppingControllerTests, ConvergenceSpiral) {
   testConvergence(ref, qrotor_state);
 
   // Non-zero linear velocity
-  qrotor_state.v = tf::Vector3(1, 1, -1);
+  qrotor_state.v = Eigen::Vector3d(1, 1, -1);
   testConvergence(ref, qrotor_state);
 
   // Non-zero angular velocity
-  qrotor_state.w = tf::Vector3(M_PI / 6, -M_PI / 4, 0);
+  qrotor_state.w = Eigen::Vector3d(M_PI / 6, -M_PI / 4, 0);
   testConvergence(ref, qrotor_state);
 }
 
@@ -168,7 +169,7 @@ TEST_F(QrotorBacksteppingControllerTests, SmallThrust) {
   auto sensor_data = std::make_pair(0.0, QrotorBacksteppingState());
   auto &qrotor_state = std::get<1>(sensor_data);
   qrotor_state.thrust = 0;
-  qrotor_state.pose.setOrigin(tf::Vector3(3, 2, 1));
+  qrotor_state.p = Eigen::Vector3d(3, 2, 1);
 
   QrotorBacksteppingControl controls;
   controller.run(sensor_data, controls);
@@ -195,6 +196,57 @@ TEST_F(QrotorBacksteppingControllerTests, ReferenceTooShort) {
   ASSERT_FALSE(controller.run(sensor_data, controls));
 }
 
+TEST_F(QrotorBacksteppingControllerTests, SetParametersWhileRunning) {
+  shared_ptr<DiscreteReferenceTrajectoryInterpolate<ParticleState, Snap>> ref(
+      new DiscreteReferenceTrajectoryInterpolate<ParticleState, Snap>());
+  for (double t = 0; t < 1; t += 0.05) {
+    ref->ts.push_back(t);
+    ref->states.push_back(ParticleState());
+    ref->controls.push_back(Snap());
+  }
+  QrotorBacksteppingController controller(config_);
+  controller.setGoal(ref);
+  QrotorBacksteppingState qrotor_state;
+  qrotor_state.p = Eigen::Vector3d(1, -1, 0.5);
+  qrotor_state.thrust = config_.mass() * config_.acc_gravity();
+  auto sensor_data = std::make_pair(0.0, qrotor_state);
+
+  // Retune from another thread while the control loop runs
+  std::atomic<bool> done(false);
+  std::thread tuner([&]() {
+    for (int i = 0; !done; ++i) {
+      controller.setMass(config_.mass() * (1 + 0.1 * (i % 2)));
+      controller.setGains(Eigen::Vector3d::Constant(0.4 + 0.1 * (i % 2)),
+                          Eigen::Vector3d::Constant(0.2));
+    }
+  });
+  bool finite = true;
+  for (int i = 0; i < 1000; ++i) {
+    QrotorBacksteppingControl controls;
+    controller.run(sensor_data, controls);
+    finite = finite && std::isfinite(controls.thrust_ddot) &&
+             controls.torque.allFinite();
+  }
+  done = true;
+  tuner.join();
+  ASSERT_TRUE(finite);
+
+  // The next run uses the latest parameters
+  Eigen::Vector3d kp(0.3, 0.3, 0.5);
+  Eigen::Vector3d kd(0.1, 0.1, 0.3);
+  controller.setMass(2 * config_.mass());
+  controller.setGains(kp, kd);
+  QrotorBacksteppingControl controls;
+  ASSERT_TRUE(controller.run(sensor_data, controls));
+  QrotorBacksteppingKernel kernel(config_);
+  kernel.setMass(2 * config_.mass());
+  kernel.setGains(kp, kd);
+  QrotorBacksteppingControl expected_controls;
+  kernel.run(qrotor_state, ParticleState(), Snap(), expected_controls);
+  ASSERT_NEAR(controls.thrust_ddot, expected_controls.thrust_ddot, 1e-8);
+  test_utils::ASSERT_VEC_NEAR(controls.torque, expected_controls.torque);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
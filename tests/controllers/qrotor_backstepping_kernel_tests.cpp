@@ -0,0 +1,167 @@
+#include "aerial_autonomy/common/math.h"
+#include "aerial_autonomy/controllers/qrotor_backstepping_kernel.h"
+#include "aerial_autonomy/tests/reference_backstepping_law.h"
+#include "qrotor_backstepping_controller_config.pb.h"
+
+#include <random>
+
+#include <gtest/gtest.h>
+
+class QrotorBacksteppingKernelTests : public ::testing::Test {
+protected:
+  QrotorBacksteppingKernelTests() : generator_(0), distribution_(-1, 1) {
+    config_.set_mass(1.3);
+    config_.set_kp_xy(2.0);
+    config_.set_kp_z(3.0);
+    config_.set_kd_xy(1.5);
+    config_.set_kd_z(2.5);
+    config_.set_k1(2.0);
+    config_.set_k2(4.0);
+    config_.set_jxx(0.02);
+    config_.set_jyy(0.03);
+    config_.set_jzz(0.04);
+    config_.set_jxy(0.001);
+    config_.set_jyx(0.001);
+    // Any symmetric matrix exercises all the terms of the control law
+    Eigen::Matrix<double, 6, 6> M = Eigen::Matrix<double, 6, 6>::Random();
+    P_ = M + M.transpose();
+  }
+
+  double random() { return distribution_(generator_); }
+
+  Eigen::Vector3d randomVector() {
+    return Eigen::Vector3d(random(), random(), random());
+  }
+
+  QrotorBacksteppingState randomState() {
+    QrotorBacksteppingState state;
+    state.R = Eigen::AngleAxisd(M_PI * random(), randomVector().normalized())
+                  .toRotationMatrix();
+    state.p = randomVector();
+    state.v = randomVector();
+    state.w = randomVector();
+    state.thrust = 10 + random();
+    state.thrust_dot = random();
+    return state;
+  }
+
+  ParticleState randomDesiredState() {
+    ParticleState state;
+    state.p = randomVector();
+    state.v = randomVector();
+    state.a = randomVector();
+    state.j = randomVector();
+    return state;
+  }
+
+  QrotorBacksteppingControllerConfig config_;
+  Eigen::Matrix<double, 6, 6> P_;
+  std::mt19937 generator_;
+  std::uniform_real_distribution<double> distribution_;
+};
+
+TEST_F(QrotorBacksteppingKernelTests, MatchesReference) {
+  QrotorBacksteppingKernel kernel(config_, P_);
+  ReferenceBacksteppingLaw reference(config_, P_);
+  for (int i = 0; i < 100; ++i) {
+    QrotorBacksteppingState state = randomState();
+    ParticleState desired_state = randomDesiredState();
+    Snap snap(random(), random(), random());
+    QrotorBacksteppingControl control, reference_control;
+    kernel.run(state, desired_state, snap, control);
+    reference.run(state, desired_state, snap, reference_control);
+    ASSERT_NEAR(control.thrust_ddot, reference_control.thrust_ddot, 1e-9);
+    for (int j = 0; j < 3; ++j) {
+      ASSERT_NEAR(control.torque(j), reference_control.torque(j), 1e-9);
+    }
+  }
+}
+
+TEST_F(QrotorBacksteppingKernelTests, ZeroThrust) {
+  QrotorBacksteppingKernel kernel(config_, P_);
+  QrotorBacksteppingState state = randomState();
+  state.thrust = 0.5 * config_.thrust_eps();
+  QrotorBacksteppingControl control;
+  kernel.run(state, randomDesiredState(), Snap(), control);
+  ASSERT_EQ(control.torque, Eigen::Vector3d::Zero());
+}
+
+TEST_F(QrotorBacksteppingKernelTests, Batch) {
+  QrotorBacksteppingKernel kernel(config_, P_);
+  std::vector<QrotorBacksteppingState> states;
+  std::vector<ParticleState> desired_states;
+  std::vector<Snap> snaps;
+  for (int i = 0; i < 10; ++i) {
+    states.push_back(randomState());
+    desired_states.push_back(randomDesiredState());
+    snaps.push_back(Snap(random(), random(), random()));
+  }
+  std::vector<QrotorBacksteppingControl> controls;
+  kernel.run(states, desired_states, snaps, controls);
+  ASSERT_EQ(controls.size(), states.size());
+  for (unsigned int i = 0; i < states.size(); ++i) {
+    QrotorBacksteppingControl control;
+    kernel.run(states[i], desired_states[i], snaps[i], control);
+    ASSERT_EQ(controls[i].thrust_ddot, control.thrust_ddot);
+    ASSERT_EQ(controls[i].torque, control.torque);
+  }
+  snaps.pop_back();
+  ASSERT_DEATH(kernel.run(states, desired_states, snaps, controls),
+               "Number of states and desired snaps should be the same");
+}
+
+TEST_F(QrotorBacksteppingKernelTests, LyapunovWeights) {
+  Eigen::Matrix<double, 6, 6> P =
+      QrotorBacksteppingKernel::lyapunovWeights(config_);
+  // Dense formulation of the Lyapunov equation
+  Eigen::Matrix<double, 3, 6> K;
+  K << config_.kp_xy(), 0, 0, config_.kd_xy(), 0, 0, 0, config_.kp_xy(), 0, 0,
+      config_.kd_xy(), 0, 0, 0, config_.kp_z(), 0, 0, config_.kd_z();
+  Eigen::Matrix<double, 6, 6> A = Eigen::Matrix<double, 6, 6>::Zero();
+  A.topRightCorner<3, 3>() = Eigen::Matrix3d::Identity();
+  Eigen::Matrix<double, 6, 3> B = Eigen::Matrix<double, 6, 3>::Zero();
+  B.bottomLeftCorner<3, 3>() = Eigen::Matrix3d::Identity() / config_.mass();
+  Eigen::Matrix<double, 6, 6> AmBK = A - B * K;
+  Eigen::Matrix<double, 6, 6> Q = Eigen::Matrix<double, 6, 6>::Identity();
+  Eigen::MatrixXd P_sylvester = math::sylvester(AmBK.transpose(), AmBK, Q);
+  ASSERT_TRUE(P.isApprox(P_sylvester, 1e-9));
+  ASSERT_LT((AmBK.transpose() * P + P * AmBK + Q).norm(), 1e-9);
+}
+
+TEST_F(QrotorBacksteppingKernelTests, SetMass) {
+  QrotorBacksteppingKernel kernel(config_);
+  kernel.setMass(1.7);
+  ASSERT_EQ(kernel.getMass(), 1.7);
+  config_.set_mass(1.7);
+  QrotorBacksteppingKernel expected_kernel(config_);
+  QrotorBacksteppingState state = randomState();
+  ParticleState desired_state = randomDesiredState();
+  QrotorBacksteppingControl control, expected_control;
+  kernel.run(state, desired_state, Snap(), control);
+  expected_kernel.run(state, desired_state, Snap(), expected_control);
+  ASSERT_EQ(control.thrust_ddot, expected_control.thrust_ddot);
+  ASSERT_EQ(control.torque, expected_control.torque);
+  ASSERT_DEATH(kernel.setMass(0), "Mass should be positive");
+}
+
+TEST_F(QrotorBacksteppingKernelTests, SetGains) {
+  QrotorBacksteppingKernel kernel(config_);
+  kernel.setGains(Eigen::Vector3d(3, 3, 4), Eigen::Vector3d(2, 2, 3));
+  config_.set_kp_xy(3);
+  config_.set_kp_z(4);
+  config_.set_kd_xy(2);
+  config_.set_kd_z(3);
+  QrotorBacksteppingKernel expected_kernel(config_);
+  QrotorBacksteppingState state = randomState();
+  ParticleState desired_state = randomDesiredState();
+  QrotorBacksteppingControl control, expected_control;
+  kernel.run(state, desired_state, Snap(), control);
+  expected_kernel.run(state, desired_state, Snap(), expected_control);
+  ASSERT_EQ(control.thrust_ddot, expected_control.thrust_ddot);
+  ASSERT_EQ(control.torque, expected_control.torque);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -24,93 +24,92 @@ TEST_F(RelativePoseControllerTests, Constructor) {
 
 TEST_F(RelativePoseControllerTests, ConvergedNoOffset) {
   RelativePoseController controller(config_);
-  tf::Transform current_pose(tf::Quaternion(0, 0, 0, 1), tf::Vector3(0, 0, 0));
-  tf::Transform tracked_pose(tf::Quaternion(0, 0, 0, 1), tf::Vector3(0, 0, 0));
-  tf::Transform goal(tf::Quaternion(0, 0, 0, 1), tf::Vector3(0, 0, 0));
-  tf::Transform global_goal = tracked_pose * goal;
+  Pose current_pose(Eigen::Matrix3d::Identity(), Eigen::Vector3d(0, 0, 0));
+  Pose tracked_pose(Eigen::Matrix3d::Identity(), Eigen::Vector3d(0, 0, 0));
+  Pose goal(Eigen::Matrix3d::Identity(), Eigen::Vector3d(0, 0, 0));
+  Pose global_goal = tracked_pose * goal;
   auto sensor_data = std::make_tuple(current_pose, tracked_pose);
 
   controller.setGoal(goal);
 
-  tf::Transform controls;
+  Pose controls;
   bool result = controller.run(sensor_data, controls);
 
   ASSERT_TRUE(result);
-  ASSERT_TF_NEAR(controls, global_goal);
+  ASSERT_POSE_NEAR(controls, global_goal);
   ASSERT_TRUE(controller.isConverged(sensor_data));
 }
 
 TEST_F(RelativePoseControllerTests, NotConvergedNoOffset) {
   RelativePoseController controller(config_);
-  tf::Transform current_pose(tf::Quaternion(0, 0, 0, 1),
-                             tf::Vector3(-1, -1, 2));
-  tf::Transform tracked_pose(tf::Quaternion(0, 0, 0, 1), tf::Vector3(0, 0, 0));
-  tf::Transform goal(tf::Quaternion(0, 0, 0, 1), tf::Vector3(0, 0, 0));
-  tf::Transform global_goal = tracked_pose * goal;
+  Pose current_pose(Eigen::Matrix3d::Identity(), Eigen::Vector3d(-1, -1, 2));
+  Pose tracked_pose(Eigen::Matrix3d::Identity(), Eigen::Vector3d(0, 0, 0));
+  Pose goal(Eigen::Matrix3d::Identity(), Eigen::Vector3d(0, 0, 0));
+  Pose global_goal = tracked_pose * goal;
   auto sensor_data = std::make_tuple(current_pose, tracked_pose);
 
   controller.setGoal(goal);
 
-  tf::Transform controls;
+  Pose controls;
   bool result = controller.run(sensor_data, controls);
 
   ASSERT_TRUE(result);
-  ASSERT_TF_NEAR(controls, global_goal);
+  ASSERT_POSE_NEAR(controls, global_goal);
   ASSERT_FALSE(controller.isConverged(sensor_data));
 }
 
 TEST_F(RelativePoseControllerTests, ConvergedOffset) {
   RelativePoseController controller(config_);
-  tf::Transform current_pose(tf::Quaternion(0, 0, 0, 1), tf::Vector3(9, 0, -1));
-  tf::Transform tracked_pose(tf::Quaternion(0, 0, 0, 1), tf::Vector3(10, 0, 0));
-  tf::Transform goal(tf::Quaternion(0, 0, 0, 1), tf::Vector3(-1, 0, -1));
-  tf::Transform global_goal = tracked_pose * goal;
+  Pose current_pose(Eigen::Matrix3d::Identity(), Eigen::Vector3d(9, 0, -1));
+  Pose tracked_pose(Eigen::Matrix3d::Identity(), Eigen::Vector3d(10, 0, 0));
+  Pose goal(Eigen::Matrix3d::Identity(), Eigen::Vector3d(-1, 0, -1));
+  Pose global_goal = tracked_pose * goal;
   auto sensor_data = std::make_tuple(current_pose, tracked_pose);
 
   controller.setGoal(goal);
 
-  tf::Transform controls;
+  Pose controls;
   bool result = controller.run(sensor_data, controls);
 
   ASSERT_TRUE(result);
-  ASSERT_TF_NEAR(controls, global_goal);
+  ASSERT_POSE_NEAR(controls, global_goal);
   ASSERT_TRUE(controller.isConverged(sensor_data));
 }
 
 TEST_F(RelativePoseControllerTests, ConvergedWithinTolerance) {
   RelativePoseController controller(config_);
-  tf::Transform current_pose(tf::Quaternion(0, 0, 0, 1), tf::Vector3(9, 0, -1));
-  tf::Transform tracked_pose(tf::Quaternion(0, 0, 0, 1),
-                             tf::Vector3(10.09, .19, 0.09));
-  tf::Transform goal(tf::Quaternion(0, 0, 0, 1), tf::Vector3(-1, 0, -1));
-  tf::Transform global_goal = tracked_pose * goal;
+  Pose current_pose(Eigen::Matrix3d::Identity(), Eigen::Vector3d(9, 0, -1));
+  Pose tracked_pose(Eigen::Matrix3d::Identity(),
+                    Eigen::Vector3d(10.09, .19, 0.09));
+  Pose goal(Eigen::Matrix3d::Identity(), Eigen::Vector3d(-1, 0, -1));
+  Pose global_goal = tracked_pose * goal;
   auto sensor_data = std::make_tuple(current_pose, tracked_pose);
 
   controller.setGoal(goal);
 
-  tf::Transform controls;
+  Pose controls;
   bool result = controller.run(sensor_data, controls);
 
   ASSERT_TRUE(result);
-  ASSERT_TF_NEAR(controls, global_goal);
+  ASSERT_POSE_NEAR(controls, global_goal);
   ASSERT_TRUE(controller.isConverged(sensor_data));
 }
 
 TEST_F(RelativePoseControllerTests, NotConvergedOffset) {
   RelativePoseController controller(config_);
-  tf::Transform current_pose(tf::Quaternion(0, 0, 0, 1), tf::Vector3(0, 1, 2));
-  tf::Transform tracked_pose(tf::Quaternion(0, 0, 0, 1), tf::Vector3(10, 0, 0));
-  tf::Transform goal(tf::Quaternion(0, 0, 0, 1), tf::Vector3(-1, 0, -1));
-  tf::Transform global_goal = tracked_pose * goal;
+  Pose current_pose(Eigen::Matrix3d::Identity(), Eigen::Vector3d(0, 1, 2));
+  Pose tracked_pose(Eigen::Matrix3d::Identity(), Eigen::Vector3d(10, 0, 0));
+  Pose goal(Eigen::Matrix3d::Identity(), Eigen::Vector3d(-1, 0, -1));
+  Pose global_goal = tracked_pose * goal;
   auto sensor_data = std::make_tuple(current_pose, tracked_pose);
 
   controller.setGoal(goal);
 
-  tf::Transform controls;
+  Pose controls;
   bool result = controller.run(sensor_data, controls);
 
   ASSERT_TRUE(result);
-  ASSERT_TF_NEAR(controls, global_goal);
+  ASSERT_POSE_NEAR(controls, global_goal);
   ASSERT_FALSE(controller.isConverged(sensor_data));
 }
 
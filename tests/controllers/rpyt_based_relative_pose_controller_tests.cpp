@@ -1,5 +1,6 @@
 #include "aerial_autonomy/controllers/rpyt_based_relative_pose_controller.h"
 #include "aerial_autonomy/common/conversions.h"
+#include "aerial_autonomy/common/eigen_views.h"
 #include "aerial_autonomy/common/math.h"
 #include "aerial_autonomy/tests/test_utils.h"
 
@@ -53,8 +54,12 @@ public:
                                                std::chrono::milliseconds(20));
     tf::Transform goal_tf;
     positionYawToTf(goal, goal_tf);
-    auto sensor_data =
-        std::make_tuple(current_pose, tracked_pose, current_velocity_yawrate);
+    Twist current_twist(
+        Eigen::Vector3d(current_velocity_yawrate.x, current_velocity_yawrate.y,
+                        current_velocity_yawrate.z),
+        Eigen::Vector3d(0, 0, current_velocity_yawrate.yaw_rate));
+    auto sensor_data = std::make_tuple(toPose(current_pose),
+                                       toPose(tracked_pose), current_twist);
 
     tf::Transform global_goal = tracked_pose * goal_tf;
     tf::Vector3 position_diff =
@@ -1,5 +1,6 @@
 #include "aerial_autonomy/controllers/velocity_based_relative_pose_controller.h"
 #include "aerial_autonomy/common/conversions.h"
+#include "aerial_autonomy/common/eigen_views.h"
 #include "aerial_autonomy/common/math.h"
 #include "aerial_autonomy/tests/test_utils.h"
 
@@ -30,7 +31,8 @@ public:
     VelocityBasedRelativePoseController controller(config_);
     tf::Transform goal_tf;
     conversions::positionYawToTf(goal, goal_tf);
-    auto sensor_data = std::make_tuple(current_pose, tracked_pose);
+    auto sensor_data =
+        std::make_tuple(toPose(current_pose), toPose(tracked_pose));
 
     tf::Transform global_goal = tracked_pose * goal_tf;
     tf::Vector3 position_diff =
@@ -0,0 +1,189 @@
+#include <aerial_autonomy/estimators/recursive_least_squares.h>
+#include <aerial_autonomy/estimators/system_identification_estimator.h>
+#include <aerial_autonomy/estimators/thrust_gain_estimator.h>
+#include <glog/logging.h>
+
+#include <gtest/gtest.h>
+
+/**
+ * @brief Simulates the measurements of a quadrotor with known thrust gain and
+ * linear drag
+ */
+class SystemIdentificationEstimatorTests : public ::testing::Test {
+protected:
+  SystemIdentificationEstimatorTests()
+      : t_(0), dt_(0.02), thrust_gain_(0.12), drag_xy_(0.3), drag_z_(0.5),
+        thrust_command_(0) {
+    auto thrust_gain_config = config_.mutable_thrust_gain_estimator_config();
+    thrust_gain_config->set_kt(0.16);
+    config_.set_nominal_mass(1.5);
+  }
+
+  /**
+   * @brief Create sensor data for the current time using the last thrust
+   * command and advance time
+   */
+  parsernode::common::quaddata step() {
+    double roll = 0.3 * cos(t_);
+    double pitch = 0.3 * sin(1.3 * t_);
+    double yaw = 0.5 * t_;
+    Eigen::Matrix3d rotation(
+        Eigen::AngleAxisd(yaw, Eigen::Vector3d::UnitZ()) *
+        Eigen::AngleAxisd(pitch, Eigen::Vector3d::UnitY()) *
+        Eigen::AngleAxisd(roll, Eigen::Vector3d::UnitX()));
+    Eigen::Vector3d global_velocity(2 * sin(0.7 * t_), 2 * cos(0.9 * t_),
+                                    sin(1.1 * t_));
+    Eigen::Vector3d body_velocity = rotation.transpose() * global_velocity;
+    Eigen::Vector3d body_acc(-drag_xy_ * body_velocity.x(),
+                             -drag_xy_ * body_velocity.y(),
+                             thrust_gain_ * thrust_command_ -
+                                 drag_z_ * body_velocity.z());
+    body_acc -= 9.81 * rotation.row(2).transpose();
+    parsernode::common::quaddata data;
+    data.rpydata.x = roll;
+    data.rpydata.y = pitch;
+    data.rpydata.z = yaw;
+    data.linvel.x = global_velocity.x();
+    data.linvel.y = global_velocity.y();
+    data.linvel.z = global_velocity.z();
+    data.linacc.x = body_acc.x();
+    data.linacc.y = body_acc.y();
+    data.linacc.z = body_acc.z();
+    t_ += dt_;
+    return data;
+  }
+
+  /**
+   * @brief Compute a hover thrust command with some excitation
+   */
+  double thrustCommand(double thrust_gain_estimate) {
+    thrust_command_ = 9.81 / thrust_gain_estimate + 5 * sin(2 * t_);
+    return thrust_command_;
+  }
+
+  SystemIdentificationEstimatorConfig config_;
+  double t_;
+  double dt_;
+  double thrust_gain_;
+  double drag_xy_;
+  double drag_z_;
+  double thrust_command_;
+};
+
+TEST(RecursiveLeastSquaresTests, Constructor) {
+  ASSERT_NO_THROW(RecursiveLeastSquares<2>(Eigen::Vector2d::Zero(),
+                                           Eigen::Vector2d::Ones()));
+  ASSERT_DEATH(RecursiveLeastSquares<2>(Eigen::Vector2d::Zero(),
+                                        Eigen::Vector2d::Ones(), 0),
+               "Forgetting factor should be between 0 and 1");
+  ASSERT_DEATH(RecursiveLeastSquares<2>(Eigen::Vector2d::Zero(),
+                                        Eigen::Vector2d::Ones(), 1.5),
+               "Forgetting factor should be between 0 and 1");
+  ASSERT_DEATH(RecursiveLeastSquares<2>(Eigen::Vector2d::Zero(),
+                                        Eigen::Vector2d::Ones(), 0.9, 1, 0.1),
+               "Maximum covariance should be greater than minimum covariance");
+}
+
+TEST(RecursiveLeastSquaresTests, LinearFit) {
+  RecursiveLeastSquares<2> rls(Eigen::Vector2d::Zero(),
+                               Eigen::Vector2d::Constant(1e4), 1.0);
+  for (int i = 0; i < 100; ++i) {
+    double x = 0.1 * i;
+    rls.update(Eigen::Vector2d(x, 1), 2 * x - 3);
+  }
+  ASSERT_NEAR(rls.getEstimate()(0), 2, 1e-3);
+  ASSERT_NEAR(rls.getEstimate()(1), -3, 1e-3);
+}
+
+TEST(RecursiveLeastSquaresTests, CovarianceBounded) {
+  RecursiveLeastSquares<2> rls(Eigen::Vector2d::Zero(),
+                               Eigen::Vector2d::Constant(1), 0.9, 1e-6, 10);
+  // Second parameter is never excited
+  for (int i = 0; i < 1000; ++i) {
+    rls.update(Eigen::Vector2d(1, 0), 1);
+  }
+  ASSERT_LE(rls.getCovariance()(1, 1), 10 + 1e-8);
+  ASSERT_GE(rls.getCovariance()(0, 0), 1e-6 - 1e-12);
+  ASSERT_NEAR(rls.getEstimate()(0), 1, 1e-6);
+}
+
+TEST_F(SystemIdentificationEstimatorTests, Constructor) {
+  ASSERT_NO_THROW(SystemIdentificationEstimator estimator(config_));
+  config_.set_nominal_mass(0);
+  ASSERT_DEATH(SystemIdentificationEstimator estimator(config_),
+               "Nominal mass should be positive");
+}
+
+TEST_F(SystemIdentificationEstimatorTests, WaitForBuffer) {
+  config_.mutable_thrust_gain_estimator_config()->set_buffer_size(3);
+  SystemIdentificationEstimator estimator(config_);
+  estimator.addThrustCommand(thrustCommand(0.16));
+  estimator.addSensorData(step());
+  ASSERT_EQ(estimator.getThrustGain(), 0.16);
+}
+
+TEST_F(SystemIdentificationEstimatorTests, Convergence) {
+  SystemIdentificationEstimator estimator(config_);
+  for (int i = 0; i < 1000; ++i) {
+    estimator.addSensorData(step());
+    estimator.addThrustCommand(thrustCommand(estimator.getThrustGain()));
+  }
+  ASSERT_NEAR(estimator.getThrustGain(), thrust_gain_, 1e-5);
+  ASSERT_NEAR(estimator.getDragXY(), drag_xy_, 1e-4);
+  ASSERT_NEAR(estimator.getDragZ(), drag_z_, 1e-4);
+  ASSERT_NEAR(estimator.getMass(), 1.5 * 0.16 / thrust_gain_, 1e-3);
+}
+
+TEST_F(SystemIdentificationEstimatorTests, TrackPayloadChange) {
+  SystemIdentificationEstimator estimator(config_);
+  for (int i = 0; i < 500; ++i) {
+    estimator.addSensorData(step());
+    estimator.addThrustCommand(thrustCommand(estimator.getThrustGain()));
+  }
+  double mass_before = estimator.getMass();
+  // Pick up a payload which is a fifth of the vehicle mass
+  thrust_gain_ = thrust_gain_ / 1.2;
+  for (int i = 0; i < 1500; ++i) {
+    estimator.addSensorData(step());
+    estimator.addThrustCommand(thrustCommand(estimator.getThrustGain()));
+  }
+  ASSERT_NEAR(estimator.getThrustGain(), thrust_gain_, 1e-4);
+  ASSERT_NEAR(estimator.getMass() / mass_before, 1.2, 1e-3);
+  ASSERT_NEAR(estimator.getPayloadMass(), estimator.getMass() - 1.5, 1e-8);
+}
+
+TEST_F(SystemIdentificationEstimatorTests,
+       ConvergesFasterThanThrustGainEstimator) {
+  SystemIdentificationEstimator sysid_estimator(config_);
+  ThrustGainEstimator thrust_gain_estimator(
+      config_.thrust_gain_estimator_config());
+  // Both estimators see the same data. No drag so that the thrust gain
+  // estimator model is exact.
+  drag_xy_ = drag_z_ = 0;
+  auto converged = [&](ThrustGainEstimator &estimator) {
+    return std::abs(estimator.getThrustGain() - thrust_gain_) < 1e-4;
+  };
+  int sysid_steps = -1, thrust_gain_steps = -1;
+  for (int i = 0; i < 2000; ++i) {
+    auto data = step();
+    sysid_estimator.addSensorData(data);
+    thrust_gain_estimator.addSensorData(data);
+    double command = thrustCommand(thrust_gain_estimator.getThrustGain());
+    sysid_estimator.addThrustCommand(command);
+    thrust_gain_estimator.addThrustCommand(command);
+    if (sysid_steps < 0 && converged(sysid_estimator)) {
+      sysid_steps = i;
+    }
+    if (thrust_gain_steps < 0 && converged(thrust_gain_estimator)) {
+      thrust_gain_steps = i;
+    }
+  }
+  ASSERT_GE(sysid_steps, 0);
+  ASSERT_GE(thrust_gain_steps, 0);
+  ASSERT_LT(sysid_steps, thrust_gain_steps);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -17,6 +17,8 @@ TEST(ThrustGainEstimatorTests, Constructor) {
                "Mixing gain should be between 0 and 1");
   ASSERT_DEATH(ThrustGainEstimator(0.16, 0.5, 0),
                "Buffer size should be atleast 1");
+  ASSERT_DEATH(ThrustGainEstimator(0.16, 0.5, 101),
+               "Buffer size should be atmost 100");
 }
 
 TEST(ThrustGainEstimatorTests, resetThrustGain) {
@@ -75,6 +77,19 @@ TEST(ThrustGainEstimatorTests, addThrustCommand) {
   ASSERT_EQ(thrust_gain_estimator.getQueueSize(), 5);
 }
 
+TEST(ThrustGainEstimatorTests, addQuadData) {
+  double thrust_gain = 0.2;
+  ThrustGainEstimator thrust_gain_estimator(0.16, 0.5);
+  double thrust_command = 60;
+  parsernode::common::quaddata quad_data;
+  quad_data.rpydata.x = 0;
+  quad_data.rpydata.y = 0;
+  quad_data.linacc.z = thrust_command * thrust_gain - 9.81;
+  thrust_gain_estimator.addThrustCommand(thrust_command);
+  thrust_gain_estimator.addSensorData(quad_data);
+  ASSERT_NEAR(thrust_gain_estimator.getThrustGain(), 0.18, 1e-8);
+}
+
 TEST(ThrustGainEstimatorTests, testConvergence) {
   ThrustGainEstimator thrust_gain_estimator(0.16, 0.1);
   double t = 0;
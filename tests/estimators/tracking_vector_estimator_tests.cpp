@@ -1,5 +1,6 @@
 #include <aerial_autonomy/estimators/tracking_vector_estimator.h>
 #include <aerial_autonomy/log/log.h>
+#include <aerial_autonomy/sensors/sensor_history.h>
 #include <aerial_autonomy/tests/test_utils.h>
 #include <glog/logging.h>
 #include <tf/tf.h>
@@ -8,6 +9,24 @@
 
 using namespace test_utils;
 
+/**
+ * @brief Velocity sensor replaying a velocity history
+ */
+class HistoryVelocitySensor : public Sensor<Velocity> {
+public:
+  Velocity getSensorData() {
+    timebase::TimePoint time;
+    Velocity velocity;
+    history.getLatest(time, velocity);
+    return velocity;
+  }
+  bool getSensorData(timebase::TimePoint time, Velocity &velocity) {
+    return history.getSensorData(time, velocity);
+  }
+  SensorStatus getSensorStatus() { return SensorStatus::VALID; }
+  SensorHistory<Velocity, 16> history;
+};
+
 class TrackingVectorEstimatorTests : public ::testing::Test {
 public:
   static void SetUpTestCase() {
@@ -44,8 +63,8 @@ TEST_F(TrackingVectorEstimatorTests, initializeState) {
 TEST_F(TrackingVectorEstimatorTests, testMeasurementCovariance) {
   TrackingVectorEstimator estimator(config_, std::chrono::milliseconds(20));
   int seconds_offset = 1;
-  auto marker_time_stamp = std::chrono::high_resolution_clock::now() -
-                           std::chrono::seconds(seconds_offset);
+  auto marker_time_stamp =
+      timebase::Clock::now() - std::chrono::seconds(seconds_offset);
   cv::Mat measurement_covariance_matrix;
   estimator.setMeasurementCovariance(measurement_covariance_matrix,
                                      marker_time_stamp);
@@ -96,8 +115,7 @@ TEST_F(TrackingVectorEstimatorTests, correctState) {
     tf::Vector3 quad_vel(-sin(t), cos(t), 0);
     tf::Vector3 marker_direction = marker_pos - quad_pos;
     estimator.predict(quad_vel);
-    estimator.correct(marker_direction,
-                      std::chrono::high_resolution_clock::now());
+    estimator.correct(marker_direction, timebase::Clock::now());
     tf::Vector3 estimated_marker_direction = estimator.getMarkerDirection();
     tf::Vector3 error_marker_direction =
         estimated_marker_direction - marker_direction;
@@ -113,6 +131,66 @@ TEST_F(TrackingVectorEstimatorTests, correctState) {
                               std::chrono::milliseconds(0)));
 }
 
+TEST_F(TrackingVectorEstimatorTests, correctDelayedMeasurement) {
+  TrackingVectorEstimator estimator(config_, std::chrono::milliseconds(20));
+  HistoryVelocitySensor velocity_sensor;
+  auto now = timebase::Clock::now();
+  velocity_sensor.history.push(now - std::chrono::seconds(1),
+                               Velocity(0, 0, 0));
+  velocity_sensor.history.push(now - std::chrono::milliseconds(400),
+                               Velocity(0, 2, 0));
+  velocity_sensor.history.push(now, Velocity(0, 2, 0));
+  // The first correction initializes the state with the measurement moved
+  // to the current time
+  estimator.resetState();
+  tf::Vector3 marker_direction(1, 0, 0);
+  estimator.correct(marker_direction, now - std::chrono::milliseconds(200),
+                    velocity_sensor);
+  ASSERT_NEAR(estimator.getMarkerDirection().x(), 1, 1e-6);
+  ASSERT_NEAR(estimator.getMarkerDirection().y(), -0.4, 1e-2);
+  ASSERT_NEAR(estimator.getMarkerDirection().z(), 0, 1e-6);
+  // Without velocity at the marker time stamp the measurement is used as is
+  estimator.resetState();
+  estimator.correct(marker_direction, now - std::chrono::seconds(2),
+                    velocity_sensor);
+  ASSERT_VEC_NEAR(estimator.getMarkerDirection(), marker_direction);
+}
+
+TEST_F(TrackingVectorEstimatorTests, delayedMeasurementCovariance) {
+  // Moving the measurement to the current time compensates the delay, so the
+  // measurement covariance grows with the velocity stdev instead of the
+  // marker dilation stdev
+  config_.mutable_marker_dilation_stdev()->set_x(1);
+  config_.mutable_marker_dilation_stdev()->set_y(1);
+  config_.mutable_marker_dilation_stdev()->set_z(1);
+  TrackingVectorEstimator compensated(config_, std::chrono::milliseconds(20));
+  TrackingVectorEstimator uncompensated(config_,
+                                        std::chrono::milliseconds(20));
+  HistoryVelocitySensor velocity_sensor;
+  auto now = timebase::Clock::now();
+  velocity_sensor.history.push(now - std::chrono::seconds(1),
+                               Velocity(0, 2, 0));
+  velocity_sensor.history.push(now, Velocity(0, 2, 0));
+  tf::Vector3 marker_direction(1, 0, 0);
+  compensated.initializeState(marker_direction);
+  uncompensated.initializeState(marker_direction);
+  auto marker_time_stamp = now - std::chrono::milliseconds(200);
+  compensated.correct(marker_direction, marker_time_stamp, velocity_sensor);
+  uncompensated.correct(marker_direction, marker_time_stamp);
+  // Initial and measurement stdevs are 1e-2, velocity stdev is 1e-2 per
+  // second over the 0.2 s delay
+  double initial_covariance = 1e-4;
+  double measurement_covariance = (1e-2 + 0.2 * 1e-2) * (1e-2 + 0.2 * 1e-2);
+  double expected_noise =
+      sqrt(initial_covariance * measurement_covariance /
+           (initial_covariance + measurement_covariance));
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_NEAR(compensated.getMarkerNoise()[i], expected_noise, 1e-4);
+    ASSERT_LT(compensated.getMarkerNoise()[i],
+              uncompensated.getMarkerNoise()[i]);
+  }
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,95 @@
+#include "aerial_autonomy/kinematics/arm_kinematics.h"
+
+#include <gtest/gtest.h>
+
+/**
+* @brief Add a joint to an arm
+*/
+void addJoint(ArmKinematicsConfig &config,
+              ArmKinematicsConfig::JointConfig::Axis axis, double x) {
+  auto joint_config = config.add_joint_config();
+  joint_config->set_axis(axis);
+  joint_config->mutable_translation()->set_x(x);
+}
+
+/**
+* @brief Base yaw, shoulder and elbow pitch and a spherical wrist, stretched
+* along x at zero angles
+*/
+ArmKinematicsConfig sixJointConfig() {
+  ArmKinematicsConfig config;
+  addJoint(config, ArmKinematicsConfig::JointConfig::Z, 0.0);
+  addJoint(config, ArmKinematicsConfig::JointConfig::Y, 0.0);
+  addJoint(config, ArmKinematicsConfig::JointConfig::Y, 0.2);
+  addJoint(config, ArmKinematicsConfig::JointConfig::X, 0.2);
+  addJoint(config, ArmKinematicsConfig::JointConfig::Y, 0.0);
+  addJoint(config, ArmKinematicsConfig::JointConfig::X, 0.0);
+  config.mutable_end_effector_translation()->set_x(0.05);
+  return config;
+}
+
+TEST(ArmKinematicsTests, Limits) {
+  ArmKinematicsConfig config = sixJointConfig();
+  config.mutable_joint_config(0)->mutable_translation()->set_z(0.1);
+  config.mutable_joint_config(2)->set_min_angle(-1.0);
+  config.mutable_joint_config(2)->set_max_angle(2.0);
+  ArmKinematics kinematics(config);
+  ASSERT_EQ(kinematics.size(), 6);
+  ASSERT_DOUBLE_EQ(kinematics.minAngles()[2], -1.0);
+  ASSERT_DOUBLE_EQ(kinematics.maxAngles()[2], 2.0);
+  ASSERT_TRUE(kinematics.shoulder().isApprox(Eigen::Vector3d(0, 0, 0.1)));
+  ASSERT_NEAR(kinematics.reach(), 0.45, 1e-12);
+}
+
+TEST(ArmKinematicsTests, ForwardKinematics) {
+  ArmKinematics kinematics(sixJointConfig());
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(6);
+  Eigen::Matrix4d pose = kinematics.forwardKinematics(q);
+  Eigen::Vector3d position = pose.topRightCorner<3, 1>();
+  Eigen::Matrix3d rotation = pose.topLeftCorner<3, 3>();
+  ASSERT_TRUE(position.isApprox(Eigen::Vector3d(0.45, 0, 0)));
+  ASSERT_TRUE(rotation.isApprox(Eigen::Matrix3d::Identity()));
+  // Yaw the base and bend the elbow up by 90 degrees
+  q[0] = M_PI / 2;
+  q[2] = -M_PI / 2;
+  position = kinematics.forwardKinematics(q).topRightCorner<3, 1>();
+  ASSERT_TRUE(position.isApprox(Eigen::Vector3d(0, 0.2, 0.25)));
+}
+
+TEST(ArmKinematicsTests, JacobianMatchesFiniteDifferences) {
+  ArmKinematics kinematics(sixJointConfig());
+  Eigen::VectorXd q(6);
+  q << 0.3, -0.4, 1.1, 0.5, -0.7, 0.2;
+  ArmKinematics::Jacobian jacobian;
+  Eigen::Matrix4d pose = kinematics.forwardKinematics(q, jacobian);
+  ASSERT_TRUE(pose.isApprox(kinematics.forwardKinematics(q)));
+  ASSERT_EQ(jacobian.cols(), 6);
+  const double delta = 1e-7;
+  for (int i = 0; i < 6; ++i) {
+    Eigen::VectorXd q_delta = q;
+    q_delta[i] += delta;
+    ArmKinematics::Vector6d velocity =
+        ArmKinematics::poseError(pose, kinematics.forwardKinematics(q_delta)) /
+        delta;
+    for (int j = 0; j < 6; ++j) {
+      ASSERT_NEAR(jacobian(j, i), velocity[j], 1e-5);
+    }
+  }
+}
+
+TEST(ArmKinematicsTests, PoseError) {
+  Eigen::Matrix4d pose = Eigen::Matrix4d::Identity();
+  Eigen::Matrix4d target = Eigen::Matrix4d::Identity();
+  target.topLeftCorner<3, 3>() =
+      Eigen::AngleAxisd(0.3, Eigen::Vector3d::UnitY()).toRotationMatrix();
+  target.topRightCorner<3, 1>() = Eigen::Vector3d(1, 2, 3);
+  ArmKinematics::Vector6d error = ArmKinematics::poseError(pose, target);
+  ArmKinematics::Vector6d expected_error;
+  expected_error << 1, 2, 3, 0, 0.3, 0;
+  ASSERT_TRUE(error.isApprox(expected_error));
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
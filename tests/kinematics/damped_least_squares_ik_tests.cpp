@@ -0,0 +1,113 @@
+#include "aerial_autonomy/kinematics/damped_least_squares_ik.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+class DampedLeastSquaresIKTests : public ::testing::Test {
+public:
+  /**
+   * @brief Base yaw, shoulder and elbow pitch and a spherical wrist,
+   * stretched along x at zero angles, reaching 0.45 m
+   */
+  static ArmInverseKinematicsConfig sixJointConfig() {
+    ArmInverseKinematicsConfig config;
+    auto kinematics_config = config.mutable_kinematics_config();
+    using JointConfig = ArmKinematicsConfig::JointConfig;
+    const JointConfig::Axis axes[] = {JointConfig::Z, JointConfig::Y,
+                                      JointConfig::Y, JointConfig::X,
+                                      JointConfig::Y, JointConfig::X};
+    const double translations[] = {0.0, 0.0, 0.2, 0.2, 0.0, 0.0};
+    const double limits[] = {3.14, 1.6, 2.6, 3.14, 1.8, 3.14};
+    for (int i = 0; i < 6; ++i) {
+      auto joint_config = kinematics_config->add_joint_config();
+      joint_config->set_axis(axes[i]);
+      joint_config->mutable_translation()->set_x(translations[i]);
+      joint_config->set_min_angle(-limits[i]);
+      joint_config->set_max_angle(limits[i]);
+    }
+    kinematics_config->mutable_end_effector_translation()->set_x(0.05);
+    return config;
+  }
+
+  /**
+   * @brief Check that the solution reaches a pose
+   */
+  static void expectSolution(const DampedLeastSquaresIK &solver,
+                             const Eigen::Matrix4d &target) {
+    ArmKinematics::Vector6d error = ArmKinematics::poseError(
+        solver.getKinematics().forwardKinematics(solver.getSolution()),
+        target);
+    EXPECT_LT(error.head<3>().norm(), 1e-3);
+    EXPECT_LT(error.tail<3>().norm(), 1e-2);
+  }
+};
+
+TEST_F(DampedLeastSquaresIKTests, SolveSampledPoses) {
+  DampedLeastSquaresIK solver(sixJointConfig());
+  const ArmKinematics &kinematics = solver.getKinematics();
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  for (int sample = 0; sample < 20; ++sample) {
+    // Poses of a bent elbow with the wrist away from its singularity
+    Eigen::VectorXd q(6);
+    q << uniform(generator), 0.5 * uniform(generator),
+        1.0 + 0.5 * uniform(generator), uniform(generator),
+        (uniform(generator) > 0 ? 1 : -1) * (0.3 + 0.5 * uniform(generator)),
+        uniform(generator);
+    Eigen::Matrix4d target = kinematics.forwardKinematics(q);
+    // Start from nearby joint angles as in the previous controller tick
+    Eigen::VectorXd start(6);
+    for (int i = 0; i < 6; ++i) {
+      start[i] = q[i] + 0.2 * uniform(generator);
+    }
+    solver.reset(start);
+    ASSERT_TRUE(solver.solve(target));
+    expectSolution(solver, target);
+  }
+}
+
+TEST_F(DampedLeastSquaresIKTests, WarmStartTracksMovingGoal) {
+  DampedLeastSquaresIK solver(sixJointConfig());
+  Eigen::VectorXd q(6);
+  q << 0.2, -0.3, 1.2, 0.1, -0.4, 0.0;
+  Eigen::Matrix4d target = solver.getKinematics().forwardKinematics(q);
+  solver.reset(q);
+  ASSERT_TRUE(solver.solve(target));
+  ASSERT_EQ(solver.getIterations(), 0);
+  // Move the goal by 5 mm per controller tick
+  for (int tick = 0; tick < 20; ++tick) {
+    target(1, 3) += 0.005;
+    ASSERT_TRUE(solver.solve(target));
+    EXPECT_LE(solver.getIterations(), 3);
+    expectSolution(solver, target);
+  }
+}
+
+TEST_F(DampedLeastSquaresIKTests, UnreachablePose) {
+  ArmInverseKinematicsConfig config = sixJointConfig();
+  DampedLeastSquaresIK solver(config);
+  Eigen::Matrix4d target = Eigen::Matrix4d::Identity();
+  target(0, 3) = 1.0;
+  ASSERT_FALSE(solver.solve(target));
+  ASSERT_EQ(solver.getIterations(), static_cast<int>(config.max_iterations()));
+  const ArmKinematics &kinematics = solver.getKinematics();
+  ASSERT_TRUE((solver.getSolution().array() >=
+               kinematics.minAngles().array()).all());
+  ASSERT_TRUE((solver.getSolution().array() <=
+               kinematics.maxAngles().array()).all());
+}
+
+TEST_F(DampedLeastSquaresIKTests, ResetClampsToLimits) {
+  DampedLeastSquaresIK solver(sixJointConfig());
+  Eigen::VectorXd q = Eigen::VectorXd::Constant(6, 3.0);
+  solver.reset(q);
+  ASSERT_DOUBLE_EQ(solver.getSolution()[0], 3.0);
+  ASSERT_DOUBLE_EQ(solver.getSolution()[1], 1.6);
+  ASSERT_DOUBLE_EQ(solver.getSolution()[4], 1.8);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
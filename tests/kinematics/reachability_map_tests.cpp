@@ -0,0 +1,73 @@
+#include "aerial_autonomy/kinematics/reachability_map.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+/**
+* @brief Planar arm with a shoulder yawing about z and an elbow pitching
+* about y, with 0.2 m links and the shoulder 0.1 m above the base
+*/
+ArmKinematicsConfig twoJointConfig() {
+  ArmKinematicsConfig config;
+  auto shoulder_config = config.add_joint_config();
+  shoulder_config->set_axis(ArmKinematicsConfig::JointConfig::Z);
+  shoulder_config->mutable_translation()->set_z(0.1);
+  auto elbow_config = config.add_joint_config();
+  elbow_config->set_axis(ArmKinematicsConfig::JointConfig::Y);
+  elbow_config->mutable_translation()->set_x(0.2);
+  elbow_config->set_min_angle(-M_PI / 2);
+  elbow_config->set_max_angle(M_PI / 2);
+  config.mutable_end_effector_translation()->set_x(0.2);
+  return config;
+}
+
+TEST(ReachabilityMapTests, SampledPositionsAreReachable) {
+  ArmKinematics kinematics(twoJointConfig());
+  ReachabilityMap map(kinematics, 0.02, 20000);
+  std::mt19937 generator(1);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  for (int sample = 0; sample < 100; ++sample) {
+    Eigen::VectorXd q(2);
+    q << M_PI * uniform(generator), 0.5 * M_PI * uniform(generator);
+    Eigen::Vector3d position =
+        kinematics.forwardKinematics(q).topRightCorner<3, 1>();
+    ASSERT_TRUE(map.isReachable(position));
+    ASSERT_TRUE(map.closestReachable(position).isApprox(position));
+  }
+  ASSERT_GT(map.reachableFraction(), 0);
+  ASSERT_LT(map.reachableFraction(), 0.2);
+}
+
+TEST(ReachabilityMapTests, UnreachablePositions) {
+  ArmKinematics kinematics(twoJointConfig());
+  ReachabilityMap map(kinematics, 0.02, 20000);
+  // Beyond the reach, above the shoulder, off the elbow circle and outside
+  // the grid
+  ASSERT_FALSE(map.isReachable(Eigen::Vector3d(0.5, 0, 0.1)));
+  ASSERT_FALSE(map.isReachable(Eigen::Vector3d(0, 0, 0.1)));
+  ASSERT_FALSE(map.isReachable(Eigen::Vector3d(0.2, 0, 0.2)));
+  ASSERT_FALSE(map.isReachable(Eigen::Vector3d(10, -10, 10)));
+}
+
+TEST(ReachabilityMapTests, ClosestReachable) {
+  ArmKinematics kinematics(twoJointConfig());
+  ReachabilityMap map(kinematics, 0.02, 20000);
+  const Eigen::Vector3d shoulder = kinematics.shoulder();
+  // Straight out beyond the reach
+  Eigen::Vector3d closest =
+      map.closestReachable(shoulder + Eigen::Vector3d(0.6, 0, 0));
+  ASSERT_TRUE(map.isReachable(closest));
+  ASSERT_NEAR(closest.x() - shoulder.x(), 0.4, 0.05);
+  ASSERT_NEAR(closest.y(), 0, 0.03);
+  ASSERT_NEAR(closest.z(), shoulder.z(), 0.03);
+  // Far outside the grid
+  closest = map.closestReachable(Eigen::Vector3d(10, 0, 0.1));
+  ASSERT_TRUE(map.isReachable(closest));
+  ASSERT_LT((closest - shoulder).norm(), 0.45);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <cstdio>
+#include <fstream>
 #include <thread>
 
 #include "aerial_autonomy/log/data_stream.h"
@@ -139,9 +140,245 @@ TEST_F(DataStreamTest, LogDataFalse) {
     std::this_thread::sleep_for(std::chrono::milliseconds(200));
   }
   ds->write();
+  ds->sync();
+  ds->rotate(true);
+  // Disabled streams do not create a file
+  ASSERT_FALSE(boost::filesystem::exists(ds->path()));
+}
+
+/**
+ * @brief Read the lines of a file replacing data point timestamps with "t"
+ */
+std::vector<std::string> readLines(std::string path) {
+  std::ifstream file(path);
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line[0] != '#') {
+      line = "t" + line.substr(line.find(','));
+    }
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+/**
+ * @brief Size of a data point line holding a single digit, i.e. the
+ * timestamp, delimiter, value and newline
+ */
+uint64_t lineBytes() { return std::to_string(timebase::now()).size() + 3; }
+
+/**
+ * @brief Write lines of a single value to a stream ignoring the log rate
+ */
+void writeLines(DataStream &ds, std::vector<int> values) {
+  for (auto value : values) {
+    ds << DataStream::startl << value << DataStream::endl;
+  }
+}
+
+TEST_F(DataStreamTest, TimePoint) {
+  config_.set_log_rate(1e12);
+  DataStream ds(test_path_, config_);
+  timebase::TimePoint source_time =
+      timebase::Clock::now() - std::chrono::milliseconds(5);
+  ds << DataStream::startl << source_time << DataStream::endl;
+  ds.write();
+  std::ifstream file(test_path_);
+  int64_t time, logged_source_time;
+  char delimiter;
+  ASSERT_TRUE(file >> time >> delimiter >> logged_source_time);
+  ASSERT_EQ(logged_source_time, timebase::toNanoseconds(source_time));
+  ASSERT_GE(time - logged_source_time, 5000000);
+}
+
+TEST_F(DataStreamTest, StartAt) {
+  config_.set_log_rate(1);
+  DataStream ds(test_path_, config_);
+  timebase::TimePoint start_time = timebase::Clock::now();
+  // Data points with a given time stamp are not rate limited
+  for (int i = 0; i < 3; ++i) {
+    ds.startAt(start_time + std::chrono::microseconds(i))
+        << i << DataStream::endl;
+  }
+  ASSERT_THROW(ds.startAt(start_time).startAt(start_time), std::logic_error);
+  ds << DataStream::endl;
+  ds.write();
+  std::ifstream file(test_path_);
+  for (int i = 0; i < 3; ++i) {
+    int64_t time;
+    char delimiter;
+    int value;
+    ASSERT_TRUE(file >> time >> delimiter >> value);
+    ASSERT_EQ(time, timebase::toNanoseconds(start_time) + 1000 * i);
+    ASSERT_EQ(value, i);
+  }
+}
+
+TEST_F(DataStreamTest, DropOldest) {
+  config_.set_log_rate(1e12);
+  // Room for the header and two and a half lines
+  uint64_t max_bytes = std::string("#Time,X\n").size() + 5 * lineBytes() / 2;
+  config_.set_max_buffer_bytes(max_bytes);
+  DataStream ds(test_path_, config_);
+  ds << DataStream::starth << "X" << DataStream::endl;
+  writeLines(ds, {1, 2, 3, 4, 5});
+  ASSERT_EQ(ds.droppedDataPoints(), 3u);
+  ASSERT_LE(ds.bufferedBytes(), max_bytes);
+  ds.write();
+  ASSERT_EQ(ds.bufferedBytes(), 0u);
+  // Headers are not dropped
+  ASSERT_EQ(readLines(test_path_),
+            std::vector<std::string>({"#Time,X", "t,4", "t,5"}));
+}
+
+TEST_F(DataStreamTest, DropNewest) {
+  config_.set_log_rate(1e12);
+  config_.set_max_buffer_bytes(5 * lineBytes() / 2);
+  config_.set_drop_policy(DataStreamConfig::DROP_NEWEST);
+  DataStream ds(test_path_, config_);
+  writeLines(ds, {1, 2, 3, 4, 5});
+  ASSERT_EQ(ds.droppedDataPoints(), 3u);
+  ds.write();
+  writeLines(ds, {6});
+  ds.write();
+  test_utils::verifyFileData(std::vector<std::vector<int>>({{1}, {2}, {6}}),
+                             ds.path(), config_.delimiter());
+}
+
+TEST_F(DataStreamTest, SharedBudget) {
+  config_.set_log_rate(1e12);
+  config_.set_drop_policy(DataStreamConfig::DROP_NEWEST);
+  auto budget = std::make_shared<BufferBudget>(5 * lineBytes() / 2);
+  DataStream ds1(test_path_, config_, budget);
+  DataStream ds2(test_path_ + "2", config_, budget);
+  writeLines(ds1, {1});
+  writeLines(ds2, {2, 3});
+  ASSERT_EQ(ds1.droppedDataPoints(), 0u);
+  ASSERT_EQ(ds2.droppedDataPoints(), 1u);
+  ASSERT_EQ(budget->used, ds1.bufferedBytes() + ds2.bufferedBytes());
+  ds1.write();
+  ds2.write();
+  ASSERT_EQ(budget->used, 0u);
+}
+
+TEST_F(DataStreamTest, Rotate) {
+  config_.set_log_rate(1e12);
+  DataStream ds(test_path_, config_);
+  ds << DataStream::starth << "X" << DataStream::endl;
+  writeLines(ds, {1, 2});
+  ds.write();
+  uint64_t file_bytes = ds.fileBytes();
+  ASSERT_EQ(file_bytes, boost::filesystem::file_size(test_path_));
+  ds.rotate(true);
+  writeLines(ds, {3});
+  ds.write();
+  ds.sync();
+  ASSERT_EQ(readLines(test_path_ + ".1"),
+            std::vector<std::string>({"#Time,X", "t,1", "t,2"}));
+  ASSERT_EQ(readLines(test_path_),
+            std::vector<std::string>({"#Time,X", "t,3"}));
+  ASSERT_LT(ds.fileBytes(), file_bytes);
+}
 
-  test_utils::verifyFileData(std::vector<std::vector<int>>(), ds->path(),
-                             config_.delimiter());
+TEST_F(DataStreamTest, FlightRecorder) {
+  config_.set_log_rate(1);
+  DataStream ds(test_path_, config_, nullptr, 4096);
+  ds << DataStream::starth << "X" << DataStream::endl;
+  writeLines(ds, {1, 2, 3});
+  ds.write();
+  // The log rate only applies to the file
+  ASSERT_EQ(readLines(test_path_),
+            std::vector<std::string>({"#Time,X", "t,1"}));
+  std::string dump_path = test_path_ + "_dump";
+  ASSERT_TRUE(ds.dumpFlightRecorder(dump_path, 0));
+  ASSERT_EQ(readLines(dump_path),
+            std::vector<std::string>({"#Time,X", "t,1", "t,2", "t,3"}));
+  // Only data points recorded since the given time are dumped
+  int64_t since = timebase::now();
+  writeLines(ds, {4});
+  ASSERT_TRUE(ds.dumpFlightRecorder(dump_path, since));
+  ASSERT_EQ(readLines(dump_path),
+            std::vector<std::string>({"#Time,X", "t,4"}));
+}
+
+TEST_F(DataStreamTest, FlightRecorderDumpTwice) {
+  config_.set_log_rate(1e12);
+  DataStream ds(test_path_, config_, nullptr, 4096);
+  ds << DataStream::starth << "X" << DataStream::endl;
+  writeLines(ds, {1, 2});
+  std::string dump_path = test_path_ + "_dump";
+  ASSERT_TRUE(ds.dumpFlightRecorder(dump_path, 0));
+  ASSERT_EQ(readLines(dump_path),
+            std::vector<std::string>({"#Time,X", "t,1", "t,2"}));
+  // The history is kept across back to back dumps
+  ASSERT_TRUE(ds.dumpFlightRecorder(dump_path, 0));
+  ASSERT_EQ(readLines(dump_path),
+            std::vector<std::string>({"#Time,X", "t,1", "t,2"}));
+  // Data points recorded after a dump follow the history
+  writeLines(ds, {3});
+  ASSERT_TRUE(ds.dumpFlightRecorder(dump_path, 0));
+  ASSERT_EQ(readLines(dump_path),
+            std::vector<std::string>({"#Time,X", "t,1", "t,2", "t,3"}));
+}
+
+TEST_F(DataStreamTest, FlightRecorderConcurrentDumps) {
+  config_.set_log_rate(1e12);
+  DataStream ds(test_path_, config_, nullptr, 1 << 20);
+  std::atomic<bool> logging(true);
+  std::thread logger([&]() {
+    for (int i = 1; i <= 2000; ++i) {
+      writeLines(ds, {i});
+    }
+    logging = false;
+  });
+  std::string dump_path = test_path_ + "_dump";
+  while (logging) {
+    ASSERT_TRUE(ds.dumpFlightRecorder(dump_path, 0));
+  }
+  logger.join();
+  // Data points logged during the dumps are kept in order
+  ASSERT_TRUE(ds.dumpFlightRecorder(dump_path, 0));
+  std::vector<std::string> lines = readLines(dump_path);
+  ASSERT_EQ(lines.size(), 2000u);
+  for (size_t i = 0; i < lines.size(); ++i) {
+    ASSERT_EQ(lines[i], "t," + std::to_string(i + 1));
+  }
+}
+
+TEST_F(DataStreamTest, FlightRecorderOverwrite) {
+  config_.set_log_rate(1e12);
+  // Room for two lines and their framing
+  DataStream ds(test_path_, config_, nullptr, 2 * (lineBytes() + 12));
+  writeLines(ds, {1, 2, 3, 4});
+  std::string dump_path = test_path_ + "_dump";
+  ASSERT_TRUE(ds.dumpFlightRecorder(dump_path, 0));
+  ASSERT_EQ(readLines(dump_path), std::vector<std::string>({"t,3", "t,4"}));
+}
+
+TEST_F(DataStreamTest, FlightRecorderCompressed) {
+  config_.set_log_rate(1);
+  config_.set_compression(DataStreamConfig::XOR);
+  DataStream ds(test_path_, config_, nullptr, 4096);
+  ds << DataStream::starth << "X"
+     << "Y" << DataStream::endl;
+  for (int i = 0; i < 3; ++i) {
+    ds << DataStream::startl << i << 0.5 * i << DataStream::endl;
+  }
+  std::string dump_path = test_path_ + "_dump";
+  ASSERT_TRUE(ds.dumpFlightRecorder(dump_path, 0));
+  // Dumps are delimited text
+  ASSERT_EQ(readLines(dump_path),
+            std::vector<std::string>(
+                {"#Time,X,Y", "t,0,0", "t,1,0.5", "t,2,1"}));
+}
+
+TEST_F(DataStreamTest, FlightRecorderDisabled) {
+  DataStream ds(test_path_, config_);
+  ASSERT_FALSE(ds.dumpFlightRecorder(test_path_ + "_dump", 0));
+  config_.set_flight_recorder(false);
+  DataStream opted_out(test_path_ + "2", config_, nullptr, 4096);
+  ASSERT_FALSE(opted_out.dumpFlightRecorder(test_path_ + "_dump", 0));
 }
 
 int main(int argc, char **argv) {
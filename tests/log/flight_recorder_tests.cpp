@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include "aerial_autonomy/log/flight_recorder.h"
+
+#include <stdexcept>
+#include <utility>
+
+namespace {
+/**
+ * @brief Get the records of a buffer
+ */
+std::vector<std::pair<int64_t, std::string>>
+records(const FlightRecorderBuffer &buffer) {
+  std::vector<std::pair<int64_t, std::string>> result;
+  buffer.forEach([&](int64_t timestamp, const std::string &line) {
+    result.emplace_back(timestamp, line);
+  });
+  return result;
+}
+}
+
+TEST(FlightRecorderBufferTests, TooSmall) {
+  ASSERT_THROW(FlightRecorderBuffer(12), std::out_of_range);
+}
+
+TEST(FlightRecorderBufferTests, Push) {
+  FlightRecorderBuffer buffer(100);
+  ASSERT_TRUE(buffer.push(1, "a,1\n", 4));
+  ASSERT_TRUE(buffer.push(2, "", 0));
+  ASSERT_EQ(buffer.size(), 2u);
+  ASSERT_EQ(buffer.bytes(), 28u);
+  ASSERT_EQ(records(buffer), (std::vector<std::pair<int64_t, std::string>>(
+                                 {{1, "a,1\n"}, {2, ""}})));
+  buffer.clear();
+  ASSERT_EQ(buffer.size(), 0u);
+  ASSERT_TRUE(records(buffer).empty());
+}
+
+TEST(FlightRecorderBufferTests, TooLarge) {
+  FlightRecorderBuffer buffer(20);
+  ASSERT_TRUE(buffer.push(1, "abcdefgh", 8));
+  ASSERT_FALSE(buffer.push(2, "abcdefghi", 9));
+  ASSERT_EQ(buffer.size(), 1u);
+}
+
+TEST(FlightRecorderBufferTests, Overwrite) {
+  // Records of 12 + 5 bytes wrap around the end of the ring
+  FlightRecorderBuffer buffer(40);
+  for (int i = 0; i < 10; ++i) {
+    std::string line = "line" + std::to_string(i);
+    ASSERT_TRUE(buffer.push(i, line.data(), line.size()));
+    ASSERT_LE(buffer.bytes(), 40u);
+  }
+  ASSERT_EQ(records(buffer), (std::vector<std::pair<int64_t, std::string>>(
+                                 {{8, "line8"}, {9, "line9"}})));
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
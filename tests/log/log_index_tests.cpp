@@ -0,0 +1,272 @@
+#include <gtest/gtest.h>
+
+#include "aerial_autonomy/log/log.h"
+#include "aerial_autonomy/log/log_index.h"
+#include "aerial_autonomy/log/stream_compression.h"
+
+#include <cmath>
+#include <fstream>
+#include <thread>
+
+class LogIndexTest : public testing::Test {
+public:
+  LogIndexTest() : test_directory_("/tmp/log_index_test") {
+    boost::filesystem::remove_all(test_directory_);
+    boost::filesystem::create_directory(test_directory_);
+  }
+
+  /**
+   * @brief Write a stream file with a data point every 10 ns from start time
+   * and values (time, -time)
+   */
+  boost::filesystem::path writeStream(std::string stream_id, int64_t start,
+                                      int count, int header_every = 0) {
+    std::ofstream file((test_directory_ / stream_id).string());
+    for (int i = 0; i < count; ++i) {
+      if (i == 0 || (header_every > 0 && i % header_every == 0)) {
+        file << "#Time,x,y\n";
+      }
+      int64_t time = start + 10 * i;
+      file << time << "," << time << "," << -time << "\n";
+    }
+    return test_directory_ / stream_id;
+  }
+
+  /**
+   * @brief Read the timestamps of a cursor
+   */
+  std::vector<int64_t> timestamps(StreamCursor cursor) {
+    std::vector<int64_t> result;
+    LogRecord record;
+    while (cursor.next(record)) {
+      EXPECT_EQ(record.values[0], record.timestamp);
+      result.push_back(record.timestamp);
+    }
+    return result;
+  }
+
+protected:
+  boost::filesystem::path test_directory_;
+};
+
+TEST_F(LogIndexTest, IndexStream) {
+  MappedStream stream(writeStream("stream", 100, 25), ",", 4);
+  ASSERT_EQ(stream.streamId(), "stream");
+  ASSERT_EQ(stream.columns(), std::vector<std::string>({"x", "y"}));
+  ASSERT_EQ(stream.columnIndex("y"), 1u);
+  ASSERT_THROW(stream.columnIndex("z"), std::runtime_error);
+  ASSERT_EQ(stream.size(), 25u);
+  ASSERT_EQ(stream.startTime(), 100);
+  ASSERT_EQ(stream.endTime(), 340);
+  ASSERT_FALSE(stream.indexLoaded());
+  ASSERT_EQ(timestamps(stream.cursor()).size(), 25u);
+}
+
+TEST_F(LogIndexTest, TimeRange) {
+  MappedStream stream(writeStream("stream", 0, 100, 30), ",", 8);
+  ASSERT_EQ(timestamps(stream.cursor(255, 305)),
+            std::vector<int64_t>({260, 270, 280, 290, 300}));
+  ASSERT_EQ(timestamps(stream.cursor(990, 2000)),
+            std::vector<int64_t>({990}));
+  ASSERT_TRUE(timestamps(stream.cursor(1000, 2000)).empty());
+  ASSERT_TRUE(timestamps(stream.cursor(-100, -1)).empty());
+  ASSERT_EQ(timestamps(stream.cursor(-100, 0)), std::vector<int64_t>({0}));
+  // Segments are counted from the start of the stream
+  LogRecord record;
+  StreamCursor cursor = stream.cursor(600, 600);
+  ASSERT_TRUE(cursor.next(record));
+  ASSERT_EQ(record.segment, 2);
+  ASSERT_EQ(record.values, std::vector<double>({600, -600}));
+  ASSERT_FALSE(cursor.next(record));
+}
+
+TEST_F(LogIndexTest, SaveAndLoadIndex) {
+  boost::filesystem::path path = writeStream("stream", 0, 50, 20);
+  {
+    MappedStream stream(path, ",", 4);
+    stream.saveIndex();
+  }
+  ASSERT_TRUE(boost::filesystem::exists(MappedStream::indexPath(path)));
+  MappedStream stream(path, ",", 16);
+  ASSERT_TRUE(stream.indexLoaded());
+  ASSERT_EQ(stream.size(), 50u);
+  ASSERT_EQ(stream.endTime(), 490);
+  ASSERT_EQ(timestamps(stream.cursor(215, 245)),
+            std::vector<int64_t>({220, 230, 240}));
+  // A changed stream file is indexed again
+  writeStream("stream", 0, 60);
+  MappedStream changed_stream(path, ",", 4);
+  ASSERT_FALSE(changed_stream.indexLoaded());
+  ASSERT_EQ(changed_stream.size(), 60u);
+}
+
+TEST_F(LogIndexTest, CompressedStream) {
+  DataStreamConfig config;
+  config.set_delimiter(";");
+  config.set_compression(DataStreamConfig::XOR);
+  StreamCompressor compressor(config);
+  std::string encoded;
+  compressor.start(encoded);
+  compressor.addHeader("#Time;x;y", encoded);
+  for (int i = 0; i < 25; ++i) {
+    double values[] = {0.1 * i, -std::sqrt(i)};
+    compressor.addDataPoint(100 + 10 * i, values, 2);
+  }
+  compressor.flush(encoded);
+  boost::filesystem::path path = test_directory_ / "compressed";
+  std::ofstream(path.string(), std::ios::binary) << encoded;
+  // Compressed streams use their own delimiter and keep exact values
+  MappedStream stream(path, ",", 4);
+  ASSERT_EQ(stream.columns(), std::vector<std::string>({"x", "y"}));
+  ASSERT_EQ(stream.size(), 25u);
+  ASSERT_EQ(stream.startTime(), 100);
+  ASSERT_EQ(stream.endTime(), 340);
+  LogRecord record;
+  StreamCursor cursor = stream.cursor(170, 170);
+  ASSERT_TRUE(cursor.next(record));
+  ASSERT_EQ(record.values, std::vector<double>({0.1 * 7, -std::sqrt(7)}));
+  ASSERT_FALSE(cursor.next(record));
+  stream.saveIndex();
+  MappedStream indexed_stream(path, ",", 4);
+  ASSERT_TRUE(indexed_stream.indexLoaded());
+  StreamCursor indexed_cursor = indexed_stream.cursor(300, 400);
+  int count = 0;
+  while (indexed_cursor.next(record)) {
+    ++count;
+  }
+  ASSERT_EQ(count, 5);
+}
+
+TEST_F(LogIndexTest, StreamErrors) {
+  ASSERT_THROW(MappedStream(test_directory_ / "missing"), std::runtime_error);
+  std::ofstream((test_directory_ / "empty").string());
+  ASSERT_THROW(MappedStream(test_directory_ / "empty"), std::runtime_error);
+  std::ofstream((test_directory_ / "no_header").string()) << "1,2\n";
+  ASSERT_THROW(MappedStream(test_directory_ / "no_header"),
+               std::runtime_error);
+  std::ofstream((test_directory_ / "mismatch").string())
+      << "#Time,a\n1,2\n#Time,b\n";
+  ASSERT_THROW(MappedStream(test_directory_ / "mismatch"),
+               std::runtime_error);
+  std::ofstream((test_directory_ / "bad_data").string())
+      << "#Time,a\n1,2\n2,x\n";
+  MappedStream stream(test_directory_ / "bad_data");
+  StreamCursor cursor = stream.cursor();
+  LogRecord record;
+  ASSERT_TRUE(cursor.next(record));
+  ASSERT_THROW(cursor.next(record), std::runtime_error);
+}
+
+TEST_F(LogIndexTest, IndexDirectory) {
+  writeStream("stream_a", 0, 10);
+  writeStream("stream_b", 5, 10);
+  std::ofstream((test_directory_ / "notes.txt").string()) << "not a stream\n";
+  LogIndex log_index(test_directory_, ",", 4);
+  log_index.saveIndices();
+  ASSERT_EQ(log_index.streamIds(),
+            std::vector<std::string>({"stream_a", "stream_b"}));
+  ASSERT_EQ(log_index.startTime(), 0);
+  ASSERT_EQ(log_index.endTime(), 95);
+  ASSERT_THROW(log_index.stream("notes.txt"), std::runtime_error);
+  // Index files are not indexed as streams
+  LogIndex loaded_index(test_directory_, ",", 4);
+  ASSERT_EQ(loaded_index.streamIds().size(), 2u);
+  ASSERT_TRUE(loaded_index.stream("stream_a").indexLoaded());
+  ASSERT_THROW(LogIndex(test_directory_ / "missing"), std::runtime_error);
+}
+
+TEST_F(LogIndexTest, Merged) {
+  writeStream("stream_a", 0, 10);
+  writeStream("stream_b", 5, 10);
+  writeStream("stream_c", 20, 2);
+  LogIndex log_index(test_directory_, ",", 3);
+  MergedCursor cursor =
+      log_index.merged({"stream_a", "stream_b", "stream_c"}, 15, 35);
+  std::vector<std::pair<size_t, int64_t>> merged;
+  size_t stream;
+  LogRecord record;
+  while (cursor.next(stream, record)) {
+    merged.push_back(std::make_pair(stream, record.timestamp));
+  }
+  std::vector<std::pair<size_t, int64_t>> expected = {
+      {1, 15}, {0, 20}, {2, 20}, {1, 25}, {0, 30}, {2, 30}, {1, 35}};
+  ASSERT_EQ(merged, expected);
+}
+
+TEST_F(LogIndexTest, ResampleHold) {
+  writeStream("stream_a", 100, 10);
+  writeStream("stream_b", 125, 10);
+  LogIndex log_index(test_directory_, ",", 2);
+  ResampledCursor cursor = log_index.resample(
+      {"stream_a", "stream_b"}, 120, 150, std::chrono::nanoseconds(15));
+  ASSERT_EQ(cursor.columns(),
+            std::vector<std::string>(
+                {"stream_a/x", "stream_a/y", "stream_b/x", "stream_b/y"}));
+  int64_t time;
+  std::vector<double> values;
+  ASSERT_TRUE(cursor.next(time, values));
+  ASSERT_EQ(time, 120);
+  ASSERT_EQ(values[0], 120);
+  ASSERT_EQ(values[1], -120);
+  ASSERT_TRUE(std::isnan(values[2]));
+  ASSERT_TRUE(cursor.next(time, values));
+  ASSERT_EQ(time, 135);
+  ASSERT_EQ(values, std::vector<double>({130, -130, 135, -135}));
+  ASSERT_TRUE(cursor.next(time, values));
+  ASSERT_EQ(time, 150);
+  ASSERT_EQ(values, std::vector<double>({150, -150, 145, -145}));
+  ASSERT_FALSE(cursor.next(time, values));
+}
+
+TEST_F(LogIndexTest, ResampleLinear) {
+  writeStream("stream", 100, 10, 5);
+  LogIndex log_index(test_directory_, ",", 2);
+  ResampledCursor cursor =
+      log_index.resample({"stream"}, 90, 200, std::chrono::nanoseconds(4),
+                         ResampleMethod::Linear);
+  int64_t time;
+  std::vector<double> values;
+  while (cursor.next(time, values)) {
+    if (time < 100) {
+      ASSERT_TRUE(std::isnan(values[0]));
+    } else if (time >= 140 && time < 150) {
+      // Data points of different segments are not interpolated
+      ASSERT_EQ(values[0], 140);
+    } else if (time < 190) {
+      ASSERT_NEAR(values[0], time, 1e-9);
+      ASSERT_NEAR(values[1], -time, 1e-9);
+    } else {
+      ASSERT_EQ(values[0], 190);
+    }
+  }
+  ASSERT_EQ(time, 198);
+}
+
+TEST_F(LogIndexTest, IndexLogDirectory) {
+  LogConfig config;
+  config.set_directory((test_directory_ / "log").string());
+  config.set_write_duration(10);
+  DataStreamConfig *ds = config.add_data_stream_configs();
+  ds->set_stream_id("stream");
+  ds->set_log_rate(1e12);
+  Log::instance().configure(config);
+  DATA_HEADER("stream") << "a" << DataStream::endl;
+  for (int i = 0; i < 10; ++i) {
+    DATA_LOG("stream") << i << DataStream::endl;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  LogIndex log_index(Log::instance().directory());
+  ASSERT_EQ(log_index.streamIds(),
+            std::vector<std::string>({"stream", "timebase"}));
+  const MappedStream &stream = log_index.stream("stream");
+  ASSERT_EQ(stream.size(), 10u);
+  LogRecord record;
+  StreamCursor cursor = stream.cursor(stream.endTime(), stream.endTime());
+  ASSERT_TRUE(cursor.next(record));
+  ASSERT_EQ(record.values, std::vector<double>({9}));
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
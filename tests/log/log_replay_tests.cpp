@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+
+#include "aerial_autonomy/log/log.h"
+#include "aerial_autonomy/log/stream_replayers.h"
+
+#include <fstream>
+#include <thread>
+
+class LogReplayTest : public testing::Test {
+public:
+  LogReplayTest() : test_path_("/tmp/log_replay_test") {
+    LogConfig config;
+    config.set_directory(test_path_);
+    config.set_write_duration(10);
+    for (auto stream_id :
+         {"thrust_gain_estimator", "rpyt_based_velocity_controller"}) {
+      DataStreamConfig *ds = config.add_data_stream_configs();
+      ds->set_stream_id(stream_id);
+      // Record every tick with full precision
+      ds->set_log_rate(1e12);
+      ds->set_precision(17);
+    }
+    Log::instance().configure(config);
+  }
+
+  /**
+   * @brief Run a thrust gain estimator on a synthetic flight
+   */
+  void recordThrustGainEstimator(ThrustGainEstimatorConfig config,
+                                 int ticks) {
+    ThrustGainEstimator estimator(config);
+    for (int i = 0; i < ticks; ++i) {
+      estimator.addThrustCommand(60 + 5 * std::sin(0.1 * i));
+      estimator.addSensorData(0.1 * std::sin(0.05 * i),
+                              -0.1 * std::cos(0.07 * i),
+                              0.3 * std::sin(0.13 * i));
+    }
+  }
+
+  /**
+   * @brief Run an rpyt velocity controller on a synthetic flight
+   */
+  void recordRPYTController(RPYTBasedVelocityControllerConfig config,
+                            int ticks) {
+    RPYTBasedVelocityController controller(config,
+                                           std::chrono::milliseconds(20));
+    RollPitchYawRateThrust control;
+    for (int i = 0; i < ticks; ++i) {
+      controller.setGoal(VelocityYawRate(1, -0.5, 0.2 * (i / 50), 0.1));
+      VelocityYawRate velocity(std::sin(0.02 * i), -0.5 * std::sin(0.03 * i),
+                               0.1 * std::cos(0.05 * i), 0.05);
+      controller.run(std::make_tuple(velocity, 0.01 * i), control);
+    }
+  }
+
+  /**
+   * @brief Wait for the log timer to write the streams and read a stream
+   */
+  RecordedStream readStream(std::string stream_id) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    return RecordedStream(Log::instance()[stream_id].path());
+  }
+
+  /**
+   * @brief Write a stream file
+   */
+  std::string writeFile(std::string contents) {
+    std::string path = test_path_ + "_stream";
+    std::ofstream file(path);
+    file << contents;
+    return path;
+  }
+
+  /**
+   * @brief RPYT controller config with integral action
+   */
+  RPYTBasedVelocityControllerConfig rpytConfig() {
+    RPYTBasedVelocityControllerConfig config;
+    config.set_kp_xy(2.0);
+    config.set_kp_z(1.5);
+    config.set_ki_xy(0.1);
+    config.set_ki_z(0.2);
+    config.set_max_acc_norm(2.0);
+    return config;
+  }
+
+protected:
+  std::string test_path_;
+};
+
+TEST_F(LogReplayTest, ReadStream) {
+  std::string path = writeFile("#Time,a,b\n1,0.5,2\n2,-1,3e-2\n"
+                               "#Time,a,b\n3,4,5\n");
+  RecordedStream stream(path);
+  ASSERT_EQ(stream.columns(), std::vector<std::string>({"a", "b"}));
+  ASSERT_EQ(stream.records().size(), 3u);
+  ASSERT_EQ(stream.records()[1].timestamp, 2);
+  ASSERT_EQ(stream.records()[1].values, std::vector<double>({-1, 3e-2}));
+  ASSERT_EQ(stream.records()[1].segment, 0);
+  ASSERT_EQ(stream.records()[2].segment, 1);
+  ASSERT_EQ(stream.columnIndex("b"), 1u);
+  ASSERT_FALSE(stream.hasColumn("c"));
+  ASSERT_THROW(stream.columnIndex("c"), std::runtime_error);
+  ASSERT_EQ(stream.streamId(), "log_replay_test_stream");
+}
+
+TEST_F(LogReplayTest, ReadStreamErrors) {
+  ASSERT_THROW(RecordedStream("/tmp/no_such_stream"), std::runtime_error);
+  ASSERT_THROW(RecordedStream(writeFile("1,2\n")), std::runtime_error);
+  ASSERT_THROW(RecordedStream(writeFile("#Time,a\n1,2,3\n")),
+               std::runtime_error);
+  ASSERT_THROW(RecordedStream(writeFile("#Time,a\n1,x\n")),
+               std::runtime_error);
+  ASSERT_THROW(RecordedStream(writeFile("#Time,a\n1,2\n#Time,b\n")),
+               std::runtime_error);
+}
+
+TEST_F(LogReplayTest, ReplayThrustGainEstimator) {
+  ThrustGainEstimatorConfig config;
+  config.set_buffer_size(3);
+  recordThrustGainEstimator(config, 200);
+  recordThrustGainEstimator(config, 100);
+  RecordedStream stream = readStream("thrust_gain_estimator");
+  ThrustGainEstimatorReplayer replayer(config);
+  LogReplayConfig replay_config;
+  replay_config.set_divergence_tolerance(1e-12);
+  ReplayResult result = LogReplay(replay_config).replay(stream, replayer);
+  // The buffer has to fill up before the first sensor update
+  ASSERT_EQ(result.ticks, 198 + 98);
+  ASSERT_EQ(result.segments, 2);
+  ASSERT_FALSE(result.diverged()) << result;
+  ASSERT_EQ(result.columns.size(), 1u);
+  ASSERT_EQ(result.columns[0].column, "thrust_gain");
+  ASSERT_EQ(result.columns[0].first_divergence, -1);
+  ASSERT_LE(result.mean_tick_cost, result.max_tick_cost);
+}
+
+TEST_F(LogReplayTest, ThrustGainEstimatorDiverges) {
+  ThrustGainEstimatorConfig config;
+  recordThrustGainEstimator(config, 100);
+  RecordedStream stream = readStream("thrust_gain_estimator");
+  config.set_mixing_gain(0.2);
+  ThrustGainEstimatorReplayer replayer(config);
+  ReplayResult result = LogReplay().replay(stream, replayer);
+  ASSERT_TRUE(result.diverged());
+  ASSERT_EQ(result.columns[0].first_divergence, 0);
+  ASSERT_GT(result.columns[0].max_error, 1e-6);
+  ASSERT_GT(result.columns[0].rms_error, 0);
+}
+
+TEST_F(LogReplayTest, ReplayRPYTController) {
+  recordRPYTController(rpytConfig(), 200);
+  RecordedStream stream = readStream("rpyt_based_velocity_controller");
+  RPYTBasedVelocityControllerReplayer replayer(rpytConfig(),
+                                               std::chrono::milliseconds(20));
+  LogReplayConfig replay_config;
+  replay_config.set_divergence_tolerance(1e-12);
+  ReplayResult result = LogReplay(replay_config).replay(stream, replayer);
+  ASSERT_EQ(result.ticks, 200);
+  ASSERT_EQ(result.segments, 1);
+  ASSERT_EQ(result.columns.size(), 4u);
+  ASSERT_FALSE(result.diverged()) << result;
+}
+
+TEST_F(LogReplayTest, RPYTControllerDiverges) {
+  recordRPYTController(rpytConfig(), 200);
+  RecordedStream stream = readStream("rpyt_based_velocity_controller");
+  RPYTBasedVelocityControllerConfig config = rpytConfig();
+  config.set_ki_xy(0.2);
+  RPYTBasedVelocityControllerReplayer replayer(config,
+                                               std::chrono::milliseconds(20));
+  ReplayResult result = LogReplay().replay(stream, replayer);
+  ASSERT_TRUE(result.diverged());
+  // Yaw rate command does not depend on the gains
+  ASSERT_EQ(result.columns[2].divergent_ticks, 0);
+}
+
+TEST_F(LogReplayTest, ReplayAtRecordedRate) {
+  recordRPYTController(rpytConfig(), 50);
+  RecordedStream stream = readStream("rpyt_based_velocity_controller");
+  RPYTBasedVelocityControllerReplayer replayer(rpytConfig(),
+                                               std::chrono::milliseconds(20));
+  LogReplayConfig replay_config;
+  replay_config.set_rate_scale(0.5);
+  ReplayResult result = LogReplay(replay_config).replay(stream, replayer);
+  ASSERT_GE(result.replay_duration, 2 * result.recorded_duration);
+  ASSERT_FALSE(result.diverged()) << result;
+}
+
+TEST_F(LogReplayTest, ReplayLeavesLogUntouched) {
+  recordRPYTController(rpytConfig(), 50);
+  RecordedStream stream = readStream("rpyt_based_velocity_controller");
+  RPYTBasedVelocityControllerReplayer replayer(rpytConfig(),
+                                               std::chrono::milliseconds(20));
+  ReplayResult result = LogReplay().replay(stream, replayer);
+  ASSERT_EQ(result.ticks, 50);
+  // The replayed controller neither starts a segment nor adds records
+  RecordedStream after_replay = readStream("rpyt_based_velocity_controller");
+  ASSERT_EQ(after_replay.records().size(), stream.records().size());
+  ASSERT_EQ(after_replay.records().back().segment,
+            stream.records().back().segment);
+}
+
+TEST_F(LogReplayTest, ReplayInLogDirectory) {
+  recordRPYTController(rpytConfig(), 50);
+  RecordedStream stream = readStream("rpyt_based_velocity_controller");
+  // Replay tools are typically run from inside the log directory
+  boost::filesystem::path working_directory =
+      boost::filesystem::current_path();
+  boost::filesystem::current_path(Log::instance().directory());
+  RPYTBasedVelocityControllerReplayer replayer(rpytConfig(),
+                                               std::chrono::milliseconds(20));
+  ReplayResult result = LogReplay().replay(stream, replayer);
+  boost::filesystem::current_path(working_directory);
+  ASSERT_EQ(result.ticks, 50);
+  RecordedStream after_replay = readStream("rpyt_based_velocity_controller");
+  ASSERT_EQ(after_replay.records().size(), stream.records().size());
+  ASSERT_FALSE(
+      boost::filesystem::exists(Log::instance().directory() / "empty"));
+}
+
+TEST_F(LogReplayTest, MissingInputColumn) {
+  RecordedStream stream(writeFile("#Time,roll,pitch\n1,0,0\n"));
+  ThrustGainEstimatorReplayer replayer;
+  ASSERT_THROW(LogReplay().replay(stream, replayer), std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
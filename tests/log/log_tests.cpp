@@ -1,10 +1,14 @@
 #include <gtest/gtest.h>
 
+#include "aerial_autonomy/common/worker_pool.h"
 #include "aerial_autonomy/log/log.h"
+#include "aerial_autonomy/log/log_scoped_executor.h"
 #include "aerial_autonomy/tests/test_utils.h"
 
 #include <boost/filesystem.hpp>
 
+#include <fstream>
+
 class LogTest : public testing::Test {
 public:
   LogTest() : test_path_("/tmp/log_test") {
@@ -96,6 +100,158 @@ TEST_F(LogTest, Write) {
       data1, Log::instance()["stream1"].path(),
       Log::instance()["stream1"].configuration().delimiter());
 }
+TEST_F(LogTest, Scope) {
+  Log &process_log = Log::instance();
+  WorkerPool pool(1);
+  {
+    Log vehicle_log(&pool);
+    {
+      Log::Scope scope(vehicle_log);
+      ASSERT_EQ(&Log::instance(), &vehicle_log);
+      // Other threads keep the process wide instance
+      Log *other_thread_log = nullptr;
+      std::thread([&other_thread_log]() {
+        other_thread_log = &Log::instance();
+      }).join();
+      ASSERT_EQ(other_thread_log, &process_log);
+    }
+    ASSERT_EQ(&Log::instance(), &process_log);
+  }
+  ASSERT_EQ(pool.taskCount(), 0u);
+}
+
+TEST_F(LogTest, ScopedExecutor) {
+  WorkerPool pool(1);
+  Log vehicle_log(&pool);
+  config_.set_directory(test_path_ + "_vehicle");
+  config_.set_write_duration(10);
+  vehicle_log.configure(config_);
+  // The log writes on the pool instead of its own thread
+  ASSERT_EQ(pool.taskCount(), 1u);
+  LogScopedExecutor executor(pool, vehicle_log);
+  std::vector<std::vector<double>> data = {{1.5, 2}, {3, -4.5}};
+  int id = executor.schedule(
+      [this, &data]() { writeToStream(data, "stream2", 30); },
+      std::chrono::seconds(10));
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  executor.cancel(id);
+  ASSERT_EQ(vehicle_log["stream2"].path().parent_path(),
+            vehicle_log.directory());
+  test_utils::verifyFileData(data, vehicle_log["stream2"].path(), ",");
+}
+
+TEST_F(LogTest, RotateBySize) {
+  config_.set_write_duration(10);
+  config_.set_max_file_bytes(60);
+  config_.set_fsync_policy(LogConfig::EVERY_WRITE);
+  config_.mutable_data_stream_configs(0)->set_log_rate(1e12);
+  ASSERT_NO_THROW(Log::instance().configure(config_));
+  DATA_HEADER("stream0") << "x" << DataStream::endl;
+  for (int i = 0; i < 5; ++i) {
+    DATA_LOG("stream0") << i << DataStream::endl;
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  // Each file holds the header and data points until it exceeds 60 bytes
+  boost::filesystem::path path = Log::instance()["stream0"].path();
+  ASSERT_TRUE(boost::filesystem::exists(path.string() + ".1"));
+  std::ifstream rotated_file(path.string() + ".1");
+  std::string header;
+  ASSERT_TRUE(std::getline(rotated_file, header));
+  ASSERT_EQ(header, "#Time,x");
+}
+
+TEST_F(LogTest, TimebaseStream) {
+  config_.set_write_duration(10);
+  ASSERT_NO_THROW(Log::instance().configure(config_));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  std::ifstream file((Log::instance().directory() / "timebase").string());
+  std::string header;
+  ASSERT_TRUE(std::getline(file, header));
+  ASSERT_EQ(header, "#Time,Wall_time,ROS_time");
+  int64_t time, wall_time, ros_time;
+  char delimiter;
+  ASSERT_TRUE(file >> time >> delimiter >> wall_time >> delimiter >> ros_time);
+  ASSERT_LE(time, timebase::now());
+  ASSERT_NEAR((timebase::wallTime() - wall_time) * 1e-9,
+              (timebase::now() - time) * 1e-9, 1e-2);
+}
+
+TEST_F(LogTest, StatusReportsDroppedDataPoints) {
+  config_.set_write_duration(10000);
+  // Room for two and a half data points of a single digit
+  uint64_t line_bytes = std::to_string(timebase::now()).size() + 3;
+  DataStreamConfig *stream_config = config_.mutable_data_stream_configs(0);
+  stream_config->set_max_buffer_bytes(5 * line_bytes / 2);
+  stream_config->set_log_rate(1e12);
+  ASSERT_NO_THROW(Log::instance().configure(config_));
+  for (int i = 0; i < 5; ++i) {
+    DATA_LOG("stream0") << i << DataStream::endl;
+  }
+  ASSERT_EQ(Log::instance()["stream0"].droppedDataPoints(), 3u);
+  std::string status = Log::instance().getStatus();
+  ASSERT_NE(status.find("stream0"), std::string::npos);
+  ASSERT_NE(status.find("Dropped: 3"), std::string::npos);
+}
+TEST_F(LogTest, FlightRecorder) {
+  config_.set_write_duration(20);
+  config_.set_flight_recorder_duration(10);
+  config_.set_flight_recorder_bytes(4096);
+  Log::instance().configure(config_);
+  std::vector<std::vector<double>> data = {{1, 2}, {3, 4}, {5, 6}};
+  // The data points are faster than the log rate
+  writeToStream(data, "stream0", 0);
+  Log::instance().dumpFlightRecorder("first");
+  Log::instance().dumpFlightRecorder("second");
+  for (int i = 0; i < 100 && Log::instance().flightRecorderDumps() == 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  // Requests made before the dump are merged
+  ASSERT_EQ(Log::instance().flightRecorderDumps(), 1u);
+  boost::filesystem::path record_directory =
+      Log::instance().directory() / "flight_record_1";
+  test_utils::verifyFileData(data, record_directory / "stream0", ",");
+  std::ifstream trigger((record_directory / "trigger").string());
+  std::string header, reason;
+  std::getline(trigger, header);
+  std::getline(trigger, reason);
+  ASSERT_EQ(reason.substr(reason.find(',') + 1), "first; second");
+}
+
+TEST_F(LogTest, FlightRecorderRequest) {
+  config_.set_write_duration(20);
+  config_.set_flight_recorder_duration(10);
+  config_.set_flight_recorder_bytes(4096);
+  Log::instance().configure(config_);
+  std::vector<std::vector<double>> data = {{1, 2}, {3, 4}};
+  writeToStream(data, "stream0", 0);
+  // Repeated lock free requests are merged with the other requests
+  Log::instance().requestFlightRecorderDump("critical");
+  Log::instance().requestFlightRecorderDump("critical");
+  Log::instance().dumpFlightRecorder("abort");
+  for (int i = 0; i < 100 && Log::instance().flightRecorderDumps() == 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_EQ(Log::instance().flightRecorderDumps(), 1u);
+  boost::filesystem::path record_directory =
+      Log::instance().directory() / "flight_record_1";
+  test_utils::verifyFileData(data, record_directory / "stream0", ",");
+  std::ifstream trigger((record_directory / "trigger").string());
+  std::string header, reason;
+  std::getline(trigger, header);
+  std::getline(trigger, reason);
+  ASSERT_EQ(reason.substr(reason.find(',') + 1), "abort; critical");
+}
+
+TEST_F(LogTest, FlightRecorderDisabled) {
+  config_.set_write_duration(20);
+  Log::instance().configure(config_);
+  Log::instance().dumpFlightRecorder("ignored");
+  Log::instance().requestFlightRecorderDump("ignored");
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_EQ(Log::instance().flightRecorderDumps(), 0u);
+}
+
 /**
 * Non deterministic test
 * \todo Matt Fix this test
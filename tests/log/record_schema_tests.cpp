@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+
+#include "aerial_autonomy/log/log_reader.h"
+#include "aerial_autonomy/log/record_fields.h"
+
+#include <boost/filesystem.hpp>
+
+TEST(RecordFieldTypeTest, ParseDeclarations) {
+  RecordFieldType scalar = RecordFieldType::parse("x");
+  ASSERT_EQ(scalar.kind, RecordFieldType::Scalar);
+  ASSERT_EQ(scalar.name, "x");
+  RecordFieldType array = RecordFieldType::parse("q[6]");
+  ASSERT_EQ(array.kind, RecordFieldType::Fixed);
+  ASSERT_EQ(array.name, "q");
+  ASSERT_EQ(array.rows, 6u);
+  ASSERT_EQ(array.cols, 1u);
+  RecordFieldType matrix = RecordFieldType::parse("R[3x3]");
+  ASSERT_EQ(matrix.kind, RecordFieldType::Fixed);
+  ASSERT_EQ(matrix.rows, 3u);
+  ASSERT_EQ(matrix.cols, 3u);
+  RecordFieldType list = RecordFieldType::parse("ids[]");
+  ASSERT_EQ(list.kind, RecordFieldType::Variable);
+  ASSERT_EQ(list.cols, 1u);
+  RecordFieldType rows = RecordFieldType::parse("traj[?x4]");
+  ASSERT_EQ(rows.kind, RecordFieldType::Variable);
+  ASSERT_EQ(rows.cols, 4u);
+  RecordFieldType tagged = RecordFieldType::parse("goal<none|pos[3]|wp[?x3]>");
+  ASSERT_EQ(tagged.kind, RecordFieldType::Tagged);
+  ASSERT_EQ(tagged.name, "goal");
+  ASSERT_EQ(tagged.alternatives.size(), 3u);
+  ASSERT_EQ(tagged.alternatives[1].name, "pos");
+  ASSERT_EQ(tagged.alternatives[2].kind, RecordFieldType::Variable);
+}
+
+TEST(RecordFieldTypeTest, DeclarationRoundTrip) {
+  for (std::string declaration :
+       {"x", "q[6]", "q[0]", "R[3x3]", "ids[]", "traj[?x4]",
+        "goal<none|pos[3]|wp[?x3]>"}) {
+    ASSERT_EQ(RecordFieldType::parse(declaration).declaration(), declaration);
+  }
+  ASSERT_EQ(record_fields::array("q", 6), "q[6]");
+  ASSERT_EQ(record_fields::matrix("R", 3, 2), "R[3x2]");
+  ASSERT_EQ(record_fields::variable("ids"), "ids[]");
+  ASSERT_EQ(record_fields::variable("traj", 4), "traj[?x4]");
+  ASSERT_EQ(record_fields::tagged("goal", {"none", "pos[3]"}),
+            "goal<none|pos[3]>");
+}
+
+TEST(RecordFieldTypeTest, InvalidDeclarations) {
+  for (std::string declaration :
+       {"", "[3]", "q[-1]", "q[3", "q[a]", "q[?]", "q[3x]", "q[?x]",
+        "goal<a|b", "goal[2]<a|b>", "goal<a|<b|c>>", "goal<a||b>"}) {
+    ASSERT_THROW(RecordFieldType::parse(declaration), std::runtime_error)
+        << declaration;
+  }
+}
+
+TEST(RecordSchemaTest, ScalarColumns) {
+  RecordSchema schema({"a", "b"});
+  ASSERT_TRUE(schema.fixedSize());
+  ASSERT_EQ(schema.size(), 2u);
+  ASSERT_EQ(schema.valueOffset("b"), 1u);
+  ASSERT_EQ(schema.valueNames(), std::vector<std::string>({"a", "b"}));
+  ASSERT_TRUE(schema.matches({1, 2}));
+  ASSERT_FALSE(schema.matches({1}));
+  ASSERT_FALSE(schema.matches({1, 2, 3}));
+}
+
+TEST(RecordSchemaTest, FixedFields) {
+  RecordSchema schema({"t", "q[2]", "R[2x2]"});
+  ASSERT_TRUE(schema.fixedSize());
+  ASSERT_EQ(schema.size(), 7u);
+  ASSERT_EQ(schema.valueOffset("R"), 3u);
+  ASSERT_EQ(schema.valueNames(),
+            std::vector<std::string>({"t", "q_0", "q_1", "R_0_0", "R_0_1",
+                                      "R_1_0", "R_1_1"}));
+  std::vector<double> values = {0, 1, 2, 3, 4, 5, 6};
+  auto fields = schema.decode(values);
+  ASSERT_EQ(fields.size(), 3u);
+  ASSERT_EQ(fields[0].tag, -1);
+  ASSERT_EQ(fields[1].value, Eigen::Vector2d(1, 2));
+  Eigen::Matrix2d rotation;
+  rotation << 3, 4, 5, 6;
+  ASSERT_EQ(schema.field(values, "R").value, Eigen::MatrixXd(rotation));
+  ASSERT_THROW(schema.field(values, "S"), std::runtime_error);
+}
+
+TEST(RecordSchemaTest, VariableFields) {
+  RecordSchema schema({"t", "traj[?x2]", "ids[]"});
+  ASSERT_FALSE(schema.fixedSize());
+  ASSERT_EQ(schema.valueOffset("traj"), 1u);
+  ASSERT_THROW(schema.valueOffset("ids"), std::runtime_error);
+  ASSERT_THROW(schema.valueNames(), std::runtime_error);
+  std::vector<double> values = {0, 2, 1, 2, 3, 4, 1, 7};
+  ASSERT_TRUE(schema.matches(values));
+  auto fields = schema.decode(values);
+  ASSERT_EQ(fields[1].value.rows(), 2);
+  ASSERT_EQ(fields[1].value.cols(), 2);
+  ASSERT_EQ(fields[1].value(1, 0), 3);
+  ASSERT_EQ(fields[2].value, Eigen::VectorXd::Constant(1, 7));
+  // Empty fields
+  ASSERT_EQ(schema.decode({0, 0, 0})[1].value.rows(), 0);
+  // Counts that do not match the values
+  ASSERT_FALSE(schema.matches({0, 2, 1, 2, 3, 4, 2, 7}));
+  ASSERT_FALSE(schema.matches({0, 1.5, 1, 2, 0}));
+  ASSERT_FALSE(schema.matches({0, -1, 0}));
+  ASSERT_THROW(schema.decode({0, 3, 1, 2}), std::runtime_error);
+}
+
+TEST(RecordSchemaTest, TaggedFields) {
+  RecordSchema schema({"goal<yaw|pos[3]|wp[?x3]>", "t"});
+  auto yaw = schema.decode({0, 0.5, 5});
+  ASSERT_EQ(yaw[0].tag, 0);
+  ASSERT_EQ(yaw[0].name, "yaw");
+  ASSERT_EQ(yaw[0].value(0, 0), 0.5);
+  ASSERT_EQ(yaw[1].value(0, 0), 5);
+  auto position = schema.decode({1, 1, 2, 3, 5});
+  ASSERT_EQ(position[0].tag, 1);
+  ASSERT_EQ(position[0].value, Eigen::Vector3d(1, 2, 3));
+  auto waypoints = schema.decode({2, 1, 1, 2, 3, 5});
+  ASSERT_EQ(waypoints[0].tag, 2);
+  ASSERT_EQ(waypoints[0].value.rows(), 1);
+  ASSERT_FALSE(schema.matches({3, 0.5, 5}));
+  ASSERT_FALSE(schema.matches({1, 1, 2, 5}));
+}
+
+class RecordedFieldsTest : public testing::TestWithParam<bool> {
+public:
+  RecordedFieldsTest() : test_directory_("/tmp/record_schema_test") {
+    boost::filesystem::remove_all(test_directory_);
+    boost::filesystem::create_directory(test_directory_);
+    config_.set_log_rate(1e12);
+    config_.set_precision(17);
+    if (GetParam()) {
+      config_.set_compression(DataStreamConfig::XOR);
+    }
+  }
+
+protected:
+  boost::filesystem::path test_directory_;
+  DataStreamConfig config_;
+};
+
+TEST_P(RecordedFieldsTest, RoundTrip) {
+  Eigen::Matrix3d rotation;
+  rotation << 1, 2, 3, 4, 5, 6, 7, 8, 9.5;
+  std::vector<int> ids = {3, 1, 4, 1, 5};
+  {
+    DataStream ds(test_directory_ / "stream", config_);
+    ds << DataStream::starth << "t" << record_fields::array("q", 2)
+       << record_fields::matrix("R", 3, 3) << record_fields::variable("ids")
+       << record_fields::variable("traj", 2)
+       << record_fields::tagged("goal", {"yaw", "pos[3]"})
+       << DataStream::endl;
+    for (int i = 0; i < 4; ++i) {
+      Eigen::MatrixXd trajectory = Eigen::MatrixXd::Constant(i, 2, 0.1 * i);
+      std::vector<int> some_ids(ids.begin(), ids.begin() + i);
+      ds << DataStream::startl << i
+         << record_fields::fixed(std::vector<double>({0.5 * i, -0.5 * i}))
+         << record_fields::fixed(rotation) << record_fields::list(some_ids)
+         << record_fields::rows(trajectory);
+      if (i % 2 == 0) {
+        ds << 0 << 0.25 * i;
+      } else {
+        ds << 1 << record_fields::fixed(Eigen::Vector3d(i, i, i));
+      }
+      ds << DataStream::endl;
+    }
+    ds.write();
+  }
+  RecordedStream stream(test_directory_ / "stream");
+  ASSERT_FALSE(stream.schema().fixedSize());
+  ASSERT_EQ(stream.columnIndex("R"), 3u);
+  ASSERT_THROW(stream.columnIndex("traj"), std::runtime_error);
+  ASSERT_EQ(stream.records().size(), 4u);
+  for (int i = 0; i < 4; ++i) {
+    const LogRecord &record = stream.records()[i];
+    ASSERT_EQ(stream.field(record, "q").value,
+              Eigen::Vector2d(0.5 * i, -0.5 * i));
+    ASSERT_EQ(stream.field(record, "R").value, Eigen::MatrixXd(rotation));
+    Eigen::VectorXd some_ids = stream.field(record, "ids").value;
+    ASSERT_EQ(some_ids.size(), i);
+    for (int j = 0; j < i; ++j) {
+      ASSERT_EQ(some_ids(j), ids[j]);
+    }
+    ASSERT_EQ(stream.field(record, "traj").value,
+              Eigen::MatrixXd::Constant(i, 2, 0.1 * i));
+    RecordField goal = stream.field(record, "goal");
+    ASSERT_EQ(goal.tag, i % 2);
+    if (goal.tag == 0) {
+      ASSERT_EQ(goal.name, "yaw");
+      ASSERT_EQ(goal.value(0, 0), 0.25 * i);
+    } else {
+      ASSERT_EQ(goal.name, "pos");
+      ASSERT_EQ(goal.value, Eigen::Vector3d(i, i, i));
+    }
+  }
+}
+
+TEST_P(RecordedFieldsTest, MismatchedDataPoint) {
+  {
+    DataStream ds(test_directory_ / "stream", config_);
+    ds << DataStream::starth << record_fields::variable("ids")
+       << DataStream::endl;
+    ds << DataStream::startl << 2 << 1 << DataStream::endl;
+    ds.write();
+  }
+  ASSERT_THROW(RecordedStream(test_directory_ / "stream"), std::runtime_error);
+}
+
+INSTANTIATE_TEST_CASE_P(TextAndCompressed, RecordedFieldsTest,
+                        testing::Values(false, true));
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,292 @@
+#include <gtest/gtest.h>
+
+#include "aerial_autonomy/log/data_stream.h"
+#include "aerial_autonomy/log/log_reader.h"
+#include "aerial_autonomy/log/stream_compression.h"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+
+namespace {
+/**
+ * @brief Encode data points with a codec and decode them with a new codec
+ */
+std::vector<std::vector<double>>
+roundTrip(DataStreamConfig::Compression compression, double quantization,
+          const std::vector<int64_t> &timestamps,
+          const std::vector<std::vector<double>> &data) {
+  StreamCodec encoder(compression, quantization);
+  BitWriter writer;
+  for (size_t i = 0; i < data.size(); ++i) {
+    encoder.encode(timestamps[i], data[i].data(), data[i].size(), writer);
+  }
+  std::string bytes;
+  writer.flush(bytes);
+  StreamCodec decoder(compression, quantization);
+  BitReader reader(bytes.data(), bytes.size());
+  std::vector<std::vector<double>> decoded(data.size());
+  for (size_t i = 0; i < data.size(); ++i) {
+    int64_t timestamp;
+    decoder.decode(reader, timestamp, decoded[i]);
+    EXPECT_EQ(timestamp, timestamps[i]);
+  }
+  return decoded;
+}
+
+/**
+ * @brief Read the lines of a file without the time field
+ */
+std::vector<std::string> readWithoutTime(std::istream &input) {
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(input, line)) {
+    lines.push_back(line.substr(line.find(',')));
+  }
+  return lines;
+}
+
+/**
+ * @brief Get the bits of a double
+ */
+uint64_t bits(double value) {
+  uint64_t result;
+  std::memcpy(&result, &value, sizeof(result));
+  return result;
+}
+
+/**
+ * @brief Compress a controller-like stream: 100 Hz ticks with scheduling
+ * jitter, smooth states, noisy measurements, constant goals and saturated
+ * commands
+ * @param config Configuration of the stream with a compression other than
+ * NONE
+ * @return Size of the text stream divided by the size of the compressed stream
+ */
+double compressionRatio(const DataStreamConfig &config) {
+  StreamCompressor compressor(config);
+  std::string compressed;
+  compressor.start(compressed);
+  std::stringstream text;
+  text.precision(config.precision());
+  std::mt19937 generator(5);
+  std::normal_distribution<double> jitter(0, 2e4);
+  std::normal_distribution<double> noise(0, 1e-3);
+  int64_t timestamp = 1500000000000000000;
+  std::vector<double> values(20);
+  for (int i = 0; i < 6000; ++i) {
+    timestamp += 10000000 + int64_t(jitter(generator));
+    double t = 0.01 * i;
+    for (int j = 0; j < 6; ++j) {
+      values[j] = std::sin(0.5 * t + j);
+    }
+    for (int j = 6; j < 12; ++j) {
+      values[j] = std::cos(0.3 * t + j) + noise(generator);
+    }
+    for (int j = 12; j < 16; ++j) {
+      values[j] = 0.5 * j;
+    }
+    for (int j = 16; j < 20; ++j) {
+      values[j] = std::max(-0.2, std::min(0.2, std::sin(2 * t + j)));
+    }
+    compressor.addDataPoint(timestamp, values.data(), values.size());
+    text << timestamp;
+    for (double value : values) {
+      text << config.delimiter() << value;
+    }
+    text << '\n';
+    if (i % 100 == 99) {
+      compressor.flush(compressed);
+    }
+  }
+  return double(text.str().size()) / compressed.size();
+}
+}
+
+TEST(BitWriterTest, WriteAndRead) {
+  BitWriter writer;
+  ASSERT_TRUE(writer.empty());
+  writer.writeBit(true);
+  writer.write(5, 3);
+  writer.write(0xfedcba9876543210, 64);
+  writer.write(0x3ff, 10);
+  ASSERT_FALSE(writer.empty());
+  std::string bytes;
+  writer.flush(bytes);
+  ASSERT_TRUE(writer.empty());
+  ASSERT_EQ(bytes.size(), 10u);
+  BitReader reader(bytes.data(), bytes.size());
+  ASSERT_TRUE(reader.readBit());
+  ASSERT_EQ(reader.read(3), 5u);
+  ASSERT_EQ(reader.read(64), 0xfedcba9876543210);
+  ASSERT_EQ(reader.read(10), 0x3ffu);
+  ASSERT_EQ(reader.read(2), 0u);
+  ASSERT_THROW(reader.read(1), std::runtime_error);
+}
+
+TEST(StreamCodecTest, XorIsLossless) {
+  std::mt19937 generator(3);
+  std::normal_distribution<double> noise(0, 10);
+  std::vector<int64_t> timestamps = {std::numeric_limits<int64_t>::max(), -5,
+                                     0, 1000, 1000, 999, 1 << 30};
+  std::vector<std::vector<double>> data = {
+      {1.5, -0.0, 0.0},
+      {1.5, std::numeric_limits<double>::quiet_NaN(), 0.0},
+      {std::numeric_limits<double>::infinity(), 1e-300, 1e300},
+      {noise(generator), noise(generator)},
+      {},
+      {noise(generator), noise(generator), noise(generator), 4},
+      {noise(generator), noise(generator), noise(generator), 4}};
+  auto decoded = roundTrip(DataStreamConfig::XOR, 1, timestamps, data);
+  for (size_t i = 0; i < data.size(); ++i) {
+    ASSERT_EQ(decoded[i].size(), data[i].size());
+    for (size_t j = 0; j < data[i].size(); ++j) {
+      ASSERT_EQ(bits(decoded[i][j]), bits(data[i][j]));
+    }
+  }
+}
+
+TEST(StreamCodecTest, QuantizedWithinHalfStep) {
+  double quantization = 1e-3;
+  std::mt19937 generator(4);
+  std::normal_distribution<double> noise(0, 100);
+  std::vector<int64_t> timestamps;
+  std::vector<std::vector<double>> data;
+  for (int i = 0; i < 100; ++i) {
+    timestamps.push_back(1e18 + 1e7 * i + (i % 7) * 1000);
+    data.push_back({noise(generator), std::sin(i * 0.1), 2.0});
+  }
+  data[10] = {std::numeric_limits<double>::quiet_NaN(),
+              -std::numeric_limits<double>::infinity(), 1e300};
+  auto decoded =
+      roundTrip(DataStreamConfig::QUANTIZED, quantization, timestamps, data);
+  for (size_t i = 0; i < data.size(); ++i) {
+    for (size_t j = 0; j < data[i].size(); ++j) {
+      if (std::isfinite(data[i][j]) && std::abs(data[i][j]) < 1e10) {
+        ASSERT_NEAR(decoded[i][j], data[i][j], 0.5 * quantization + 1e-12);
+      } else {
+        // Values that cannot be quantized are stored exactly
+        ASSERT_EQ(bits(decoded[i][j]), bits(data[i][j]));
+      }
+    }
+  }
+}
+
+TEST(StreamCodecTest, CompressionRatio) {
+  DataStreamConfig config;
+  config.set_compression(DataStreamConfig::QUANTIZED);
+  ASSERT_GE(compressionRatio(config), 5.0);
+  // XOR keeps every bit of the values while the text keeps 6 digits, so it
+  // only saves the bits that repeat between ticks (about 1.6x here)
+  config.set_compression(DataStreamConfig::XOR);
+  double xor_ratio = compressionRatio(config);
+  RecordProperty("xor_compression_ratio", std::to_string(xor_ratio));
+  ASSERT_GE(xor_ratio, 1.4);
+}
+
+class CompressedDataStreamTest : public testing::Test {
+public:
+  CompressedDataStreamTest() : test_directory_("/tmp/compressed_stream_test") {
+    boost::filesystem::remove_all(test_directory_);
+    boost::filesystem::create_directory(test_directory_);
+    config_.set_log_rate(1e12);
+  }
+
+  /**
+   * @brief Log a header and data points with integer, floating point and
+   * text values
+   */
+  void logData(DataStream &ds, int count) {
+    ds << DataStream::starth << "a"
+       << "b"
+       << "c" << DataStream::endl;
+    for (int i = 0; i < count; ++i) {
+      ds << DataStream::startl << i << 0.1 * i << std::to_string(-i)
+         << DataStream::endl;
+    }
+  }
+
+protected:
+  boost::filesystem::path test_directory_;
+  DataStreamConfig config_;
+};
+
+TEST_F(CompressedDataStreamTest, XorMatchesText) {
+  DataStream text_stream(test_directory_ / "text", config_);
+  config_.set_compression(DataStreamConfig::XOR);
+  DataStream compressed_stream(test_directory_ / "compressed", config_);
+  for (int i = 0; i < 3; ++i) {
+    logData(text_stream, 50);
+    logData(compressed_stream, 50);
+    text_stream.write();
+    compressed_stream.write();
+  }
+  ASSERT_TRUE(CompressedStreamReader::isCompressed(
+      (test_directory_ / "compressed").string()));
+  std::string text_path = (test_directory_ / "text").string();
+  ASSERT_FALSE(CompressedStreamReader::isCompressed(text_path));
+  std::ifstream compressed_file((test_directory_ / "compressed").string());
+  std::stringstream decompressed;
+  decompressStream(compressed_file, decompressed);
+  std::ifstream text_file(text_path);
+  ASSERT_EQ(readWithoutTime(decompressed), readWithoutTime(text_file));
+}
+
+TEST_F(CompressedDataStreamTest, ReadRecordedStream) {
+  config_.set_compression(DataStreamConfig::QUANTIZED);
+  config_.set_quantization(1e-9);
+  config_.set_delimiter(";");
+  {
+    DataStream ds(test_directory_ / "stream", config_);
+    logData(ds, 10);
+    ds.write();
+    logData(ds, 5);
+    ds.write();
+  }
+  RecordedStream stream(test_directory_ / "stream");
+  ASSERT_EQ(stream.columns(), std::vector<std::string>({"a", "b", "c"}));
+  ASSERT_EQ(stream.records().size(), 15u);
+  const LogRecord &record = stream.records()[12];
+  ASSERT_EQ(record.segment, 1);
+  ASSERT_NEAR(record.values[0], 2, 1e-9);
+  ASSERT_NEAR(record.values[1], 0.2, 1e-9);
+  ASSERT_NEAR(record.values[2], -2, 1e-9);
+  ASSERT_LE(stream.records()[0].timestamp, record.timestamp);
+}
+
+TEST_F(CompressedDataStreamTest, RotateAndTruncate) {
+  config_.set_compression(DataStreamConfig::XOR);
+  {
+    DataStream ds(test_directory_ / "stream", config_);
+    logData(ds, 10);
+    ds.write();
+    ds.rotate(false);
+    for (int i = 0; i < 3; ++i) {
+      ds << DataStream::startl << i << i << i << DataStream::endl;
+      ds.write();
+    }
+  }
+  RecordedStream rotated(test_directory_ / "stream.1");
+  ASSERT_EQ(rotated.records().size(), 10u);
+  // The new file starts with the prelude and the header
+  RecordedStream stream(test_directory_ / "stream");
+  ASSERT_EQ(stream.columns(), std::vector<std::string>({"a", "b", "c"}));
+  ASSERT_EQ(stream.records().size(), 3u);
+  // A truncated last block ends the stream
+  boost::filesystem::resize_file(
+      test_directory_ / "stream",
+      boost::filesystem::file_size(test_directory_ / "stream") - 1);
+  RecordedStream truncated(test_directory_ / "stream");
+  ASSERT_EQ(truncated.records().size(), 2u);
+  std::ifstream text_file((test_directory_ / "stream").string());
+  text_file.seekg(4);
+  ASSERT_THROW(CompressedStreamReader reader(text_file), std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
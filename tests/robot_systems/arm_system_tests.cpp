@@ -1,4 +1,5 @@
 #include <aerial_autonomy/robot_systems/arm_system.h>
+#include <aerial_autonomy/tests/test_utils.h>
 #include <arm_parsers/arm_simulator.h>
 #include <chrono>
 #include <gtest/gtest.h>
@@ -57,6 +58,26 @@ TEST(ArmSystemTests, JointAngles) {
   ASSERT_NEAR(joint_angles[1], 0.0, 1e-2);
 }
 
+TEST(ArmSystemTests, DynamicsSimulatorHardware) {
+  ArmSystemConfig config;
+  config.set_arm_parser_type("ArmDynamicsSimulator");
+  config.mutable_arm_dynamics_simulator_config()->set_power_on_duration(0.5);
+  ArmSystem arm_system(config);
+  // Enabling takes simulated time, which advances in real time
+  arm_system.power(true);
+  ASSERT_FALSE(arm_system.enabled());
+  ASSERT_EQ(arm_system.getJointAngles().size(), 6u);
+  ASSERT_TRUE(test_utils::waitUntilTrue()([&]() { return arm_system.enabled(); },
+                                          std::chrono::seconds(2),
+                                          std::chrono::milliseconds(10)));
+  // Joints move without anything else advancing the simulator
+  arm_system.rightArm();
+  ASSERT_FALSE(arm_system.getCommandStatus());
+  ASSERT_TRUE(test_utils::waitUntilTrue()(
+      [&]() { return arm_system.getCommandStatus(); }, std::chrono::seconds(2),
+      std::chrono::milliseconds(10)));
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -134,6 +134,19 @@ TEST(UAVSystemTests, abortController) {
   ASSERT_NE(data_position_yaw, position_yaw);
 }
 
+TEST(UAVSystemTests, SensorSnapshot) {
+  UAVSystem uav_system(ParserPtr(new QuadSimulator));
+  uav_system.takeSensorSnapshot();
+  uav_system.takeOff();
+  // The snapshot hides data arriving after it is taken
+  ASSERT_EQ(uav_system.getUAVData().localpos.z, 0.0);
+  uav_system.releaseSensorSnapshot();
+  // Fresh data once the snapshot is released at the end of the tick
+  ASSERT_EQ(uav_system.getUAVData().localpos.z, 0.5);
+  uav_system.land();
+  ASSERT_EQ(uav_system.getUAVData().localpos.z, 0.0);
+}
+
 ///
 
 int main(int argc, char **argv) {
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include "aerial_autonomy/log/log.h"
+#include "aerial_autonomy/log/log_reader.h"
+#include "aerial_autonomy/log/stream_compression.h"
+#include "aerial_autonomy/sensors/mocap_capture.h"
+
+#include <cmath>
+#include <thread>
+
+class MocapCaptureTests : public testing::Test {
+public:
+  MocapCaptureTests() {
+    LogConfig log_config;
+    log_config.set_directory("/tmp/mocap_capture_test");
+    log_config.set_write_duration(10);
+    Log::instance().configure(log_config);
+    config_.set_write_duration(5);
+  }
+
+  /**
+   * @brief Create a pose with increasing stamps and sequence numbers
+   */
+  MocapSample sample(uint32_t sequence) {
+    MocapSample sample;
+    sample.source_time =
+        start_time_ + std::chrono::microseconds(sequence * 2500);
+    sample.receive_time = timebase::Clock::now();
+    sample.sequence = sequence;
+    sample.x = sequence;
+    sample.y = -0.5 * sequence;
+    sample.z = 1.0;
+    sample.qx = sample.qy = 0;
+    sample.qz = std::sin(M_PI / 4);
+    sample.qw = std::cos(M_PI / 4);
+    return sample;
+  }
+
+  /**
+   * @brief Wait until the capture has handled all the received poses
+   */
+  void waitForWrite(MocapCapture &capture) {
+    for (int i = 0; i < 200; ++i) {
+      MocapCaptureStatistics statistics = capture.statistics();
+      if (statistics.written + statistics.dropped == statistics.received) {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+  }
+
+protected:
+  MocapCaptureConfig config_;
+  timebase::TimePoint start_time_ = timebase::Clock::now();
+};
+
+TEST_F(MocapCaptureTests, WritesEveryPose) {
+  config_.set_stream_id("mocap");
+  {
+    MocapCapture capture(config_);
+    for (uint32_t i = 1; i <= 500; ++i) {
+      capture.addSample(sample(i));
+    }
+    waitForWrite(capture);
+    MocapCaptureStatistics statistics = capture.statistics();
+    ASSERT_EQ(statistics.received, 500u);
+    ASSERT_EQ(statistics.written, 500u);
+    ASSERT_EQ(statistics.dropped, 0u);
+    ASSERT_EQ(statistics.missed, 0u);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  boost::filesystem::path path = Log::instance().directory() / "mocap";
+  // Streams without a configuration are compressed losslessly
+  ASSERT_TRUE(CompressedStreamReader::isCompressed(path.string()));
+  RecordedStream stream(path);
+  ASSERT_EQ(stream.columns(),
+            std::vector<std::string>(
+                {"X", "Y", "Z", "Qx", "Qy", "Qz", "Qw", "Receive_time"}));
+  ASSERT_EQ(stream.records().size(), 500u);
+  for (uint32_t i = 1; i <= 500; ++i) {
+    const LogRecord &record = stream.records()[i - 1];
+    MocapSample expected = sample(i);
+    ASSERT_EQ(record.timestamp, timebase::toNanoseconds(expected.source_time));
+    ASSERT_EQ(record.values[0], expected.x);
+    ASSERT_EQ(record.values[1], expected.y);
+    ASSERT_GE(record.values[7], timebase::toNanoseconds(start_time_));
+  }
+}
+
+TEST_F(MocapCaptureTests, DropsWhenFull) {
+  config_.set_stream_id("mocap_drops");
+  config_.set_buffer_capacity(4);
+  config_.set_write_duration(50);
+  MocapCapture capture(config_);
+  for (uint32_t i = 1; i <= 1000; ++i) {
+    capture.addSample(sample(i));
+  }
+  waitForWrite(capture);
+  MocapCaptureStatistics statistics = capture.statistics();
+  ASSERT_EQ(statistics.received, 1000u);
+  ASSERT_GT(statistics.dropped, 0u);
+  ASSERT_EQ(statistics.written + statistics.dropped, 1000u);
+}
+
+TEST_F(MocapCaptureTests, CountsMissedPoses) {
+  config_.set_stream_id("mocap_missed");
+  MocapCapture capture(config_);
+  for (uint32_t i : {1, 2, 5, 6, 10}) {
+    capture.addSample(sample(i));
+  }
+  ASSERT_EQ(capture.statistics().missed, 5u);
+}
+
+TEST_F(MocapCaptureTests, Decimation) {
+  config_.set_stream_id("mocap_decimated");
+  config_.set_decimation(3);
+  MocapCapture capture(config_);
+  for (uint32_t i = 1; i <= 9; ++i) {
+    capture.addSample(sample(i));
+  }
+  for (int i = 0; i < 200 && capture.statistics().written < 3; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  ASSERT_EQ(capture.statistics().written, 3u);
+  // The sensor is not decimated
+  ASSERT_EQ(capture.getSensorData().x, 9);
+}
+
+TEST_F(MocapCaptureTests, Sensor) {
+  config_.set_stream_id("mocap_sensor");
+  config_.set_timeout(0.05);
+  MocapCapture capture(config_);
+  ASSERT_EQ(capture.getSensorStatus(), SensorStatus::INVALID);
+  MocapSample pose = sample(4);
+  capture.addSample(pose);
+  ASSERT_EQ(capture.getSensorStatus(), SensorStatus::VALID);
+  PositionYaw position_yaw = capture.getSensorData();
+  ASSERT_EQ(position_yaw.x, 4);
+  ASSERT_EQ(position_yaw.y, -2);
+  ASSERT_EQ(position_yaw.z, 1);
+  ASSERT_NEAR(position_yaw.yaw, M_PI / 2, 1e-12);
+  ASSERT_EQ(capture.getSensorTime(), pose.source_time);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_EQ(capture.getSensorStatus(), SensorStatus::INVALID);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include "aerial_autonomy/sensors/sensor_history.h"
+#include "aerial_autonomy/types/velocity.h"
+
+#include <thread>
+
+namespace {
+/**
+ * @brief Time offset from a start time
+ */
+timebase::TimePoint at(timebase::TimePoint start, int milliseconds) {
+  return start + std::chrono::milliseconds(milliseconds);
+}
+}
+
+TEST(SensorHistoryTests, Empty) {
+  SensorHistory<double, 4> history;
+  timebase::TimePoint time;
+  double value;
+  ASSERT_EQ(history.size(), 0u);
+  ASSERT_FALSE(history.getLatest(time, value));
+  ASSERT_FALSE(history.getSensorData(timebase::Clock::now(), value));
+}
+
+TEST(SensorHistoryTests, Interpolate) {
+  SensorHistory<Velocity, 8> history;
+  timebase::TimePoint start = timebase::Clock::now();
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(history.push(at(start, 10 * i), Velocity(i, -2 * i, 1)));
+  }
+  Velocity velocity;
+  ASSERT_TRUE(history.getSensorData(at(start, 15), velocity));
+  ASSERT_NEAR(velocity.x, 1.5, 1e-9);
+  ASSERT_NEAR(velocity.y, -3, 1e-9);
+  ASSERT_NEAR(velocity.z, 1, 1e-9);
+  // Samples are returned exactly at their time
+  ASSERT_TRUE(history.getSensorData(start, velocity));
+  ASSERT_EQ(velocity, Velocity(0, 0, 1));
+  ASSERT_TRUE(history.getSensorData(at(start, 30), velocity));
+  ASSERT_EQ(velocity, Velocity(3, -6, 1));
+  timebase::TimePoint time;
+  ASSERT_TRUE(history.getLatest(time, velocity));
+  ASSERT_EQ(time, at(start, 30));
+  ASSERT_EQ(velocity, Velocity(3, -6, 1));
+}
+
+TEST(SensorHistoryTests, ExtrapolationLimit) {
+  SensorHistory<double, 4> history(std::chrono::milliseconds(20));
+  timebase::TimePoint start = timebase::Clock::now();
+  history.push(start, 1);
+  history.push(at(start, 10), 2);
+  double value;
+  // The newest sample is held until the extrapolation limit
+  ASSERT_TRUE(history.getSensorData(at(start, 30), value));
+  ASSERT_EQ(value, 2);
+  ASSERT_FALSE(history.getSensorData(at(start, 31), value));
+  // No extrapolation before the oldest sample
+  ASSERT_FALSE(history.getSensorData(at(start, -1), value));
+}
+
+TEST(SensorHistoryTests, OutOfOrder) {
+  SensorHistory<double, 4> history;
+  timebase::TimePoint start = timebase::Clock::now();
+  ASSERT_TRUE(history.push(start, 1));
+  ASSERT_FALSE(history.push(at(start, -1), 2));
+  ASSERT_TRUE(history.push(start, 3));
+  ASSERT_EQ(history.size(), 2u);
+  timebase::TimePoint time;
+  double value;
+  ASSERT_TRUE(history.getLatest(time, value));
+  ASSERT_EQ(value, 3);
+}
+
+TEST(SensorHistoryTests, Overwrite) {
+  SensorHistory<double, 4> history;
+  timebase::TimePoint start = timebase::Clock::now();
+  for (int i = 0; i < 10; ++i) {
+    history.push(at(start, i), i);
+  }
+  ASSERT_EQ(history.size(), 4u);
+  double value;
+  ASSERT_FALSE(history.getSensorData(at(start, 5), value));
+  ASSERT_TRUE(history.getSensorData(at(start, 6), value));
+  ASSERT_EQ(value, 6);
+}
+
+TEST(SensorHistoryTests, Hold) {
+  SensorHistory<int, 4, HoldInterpolation> history;
+  timebase::TimePoint start = timebase::Clock::now();
+  history.push(start, 1);
+  history.push(at(start, 10), 2);
+  int value;
+  ASSERT_TRUE(history.getSensorData(at(start, 9), value));
+  ASSERT_EQ(value, 1);
+}
+
+TEST(SensorHistoryTests, ConcurrentReaders) {
+  // Samples lie on a line so every interpolated value can be checked
+  SensorHistory<Velocity, 16> history;
+  timebase::TimePoint start = timebase::Clock::now();
+  const int count = 20000;
+  std::atomic<bool> done(false);
+  std::thread writer([&]() {
+    for (int i = 0; i < count; ++i) {
+      history.push(at(start, i), Velocity(i, 2 * i, -i));
+    }
+    done = true;
+  });
+  int checked = 0;
+  while (!done || checked == 0) {
+    timebase::TimePoint time;
+    Velocity latest;
+    if (!history.getLatest(time, latest)) {
+      continue;
+    }
+    ASSERT_EQ(latest.y, 2 * latest.x);
+    timebase::TimePoint query = time - std::chrono::microseconds(2500);
+    Velocity velocity;
+    if (history.getSensorData(query, velocity)) {
+      double expected =
+          std::chrono::duration<double, std::milli>(query - start).count();
+      ASSERT_NEAR(velocity.x, expected, 1e-6);
+      ASSERT_NEAR(velocity.y, 2 * expected, 1e-6);
+      ASSERT_NEAR(velocity.z, -expected, 1e-6);
+      ++checked;
+    }
+  }
+  writer.join();
+  ASSERT_GT(checked, 0);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -56,6 +56,27 @@ TEST_F(VelocitySensorTests, Timeout) {
   ASSERT_FALSE(sensor_status_to_bool(sensor.getSensorStatus()));
 }
 
+TEST_F(VelocitySensorTests, VelocityAtTime) {
+  VelocitySensor sensor(config);
+  nav_msgs::Odometry odom_msg;
+  ros::Time stamp = ros::Time::now();
+  for (int i = 0; i < 2; ++i) {
+    odom_msg.header.stamp = stamp + ros::Duration(0.1 * i);
+    odom_msg.twist.twist.linear.x = i;
+    odom_pub.publish(odom_msg);
+    ros::Duration(0.01).sleep();
+    ros::spinOnce();
+  }
+  timebase::TimePoint time =
+      timebase::fromRosTime(stamp + ros::Duration(0.025));
+  Velocity sensor_vel;
+  ASSERT_TRUE(sensor.getSensorData(time, sensor_vel));
+  ASSERT_NEAR(sensor_vel.x, 0.25, 1e-3);
+  ASSERT_NEAR(sensor.getSensorData().x, 1, 1e-4);
+  ASSERT_FALSE(sensor.getSensorData(
+      time - std::chrono::milliseconds(100), sensor_vel));
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   ros::init(argc, argv, "velocity_sensor_tests");
@@ -0,0 +1,265 @@
+#include "aerial_autonomy/simulators/arm_dynamics_simulator.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <thread>
+
+class ArmDynamicsSimulatorTests : public ::testing::Test {
+public:
+  /**
+   * @brief Single joint rotating about z with a 0.5 m link
+   */
+  static ArmDynamicsSimulatorConfig singleJointConfig() {
+    ArmDynamicsSimulatorConfig config;
+    auto joint_config = config.add_joint_config();
+    joint_config->set_min_angle(-1.0);
+    joint_config->set_max_angle(1.0);
+    joint_config->set_max_velocity(2.0);
+    joint_config->set_max_acceleration(20.0);
+    config.mutable_end_effector_translation()->set_x(0.5);
+    return config;
+  }
+
+  /**
+   * @brief Pose with the given translation and identity rotation
+   */
+  static Eigen::Matrix4d translation(double x, double y, double z) {
+    Eigen::Matrix4d pose = Eigen::Matrix4d::Identity();
+    pose.topRightCorner<3, 1>() = Eigen::Vector3d(x, y, z);
+    return pose;
+  }
+
+  /**
+   * @brief Power on the arm and advance until it is enabled
+   */
+  static void powerOn(ArmDynamicsSimulator &simulator) {
+    ASSERT_TRUE(simulator.sendCmd(ArmParser::POWER_ON));
+    simulator.advance(std::chrono::milliseconds(1));
+    ASSERT_EQ(simulator.state(), ArmParser::ENABLED);
+  }
+};
+
+TEST_F(ArmDynamicsSimulatorTests, PowerOn) {
+  ArmDynamicsSimulatorConfig config;
+  config.set_power_on_duration(0.5);
+  ArmDynamicsSimulator simulator(config);
+  ASSERT_EQ(simulator.state(), ArmParser::DISABLED);
+  ASSERT_FALSE(simulator.sendCmd(ArmParser::RIGHT_ARM));
+  ASSERT_FALSE(simulator.grip(true));
+  ASSERT_TRUE(simulator.sendCmd(ArmParser::POWER_ON));
+  simulator.advance(std::chrono::milliseconds(400));
+  ASSERT_EQ(simulator.state(), ArmParser::DISABLED);
+  simulator.advance(std::chrono::milliseconds(101));
+  ASSERT_EQ(simulator.state(), ArmParser::ENABLED);
+  // Powering on is not a motion command
+  ASSERT_FALSE(simulator.getCommandStatus());
+  ASSERT_TRUE(simulator.sendCmd(ArmParser::POWER_OFF));
+  ASSERT_EQ(simulator.state(), ArmParser::DISABLED);
+}
+
+TEST_F(ArmDynamicsSimulatorTests, DefaultArm) {
+  ArmDynamicsSimulator simulator;
+  ASSERT_EQ(simulator.getJointAngles().size(), 6u);
+  Eigen::Matrix4d end_effector = simulator.getEndEffectorTransform();
+  ASSERT_TRUE(end_effector.isApprox(translation(0.45, 0, 0)));
+  powerOn(simulator);
+  ASSERT_TRUE(simulator.sendCmd(ArmParser::RIGHT_ARM));
+  ASSERT_FALSE(simulator.getCommandStatus());
+  simulator.advance(std::chrono::seconds(2));
+  ASSERT_TRUE(simulator.getCommandStatus());
+  // Forearm points down
+  end_effector = simulator.getEndEffectorTransform();
+  ASSERT_NEAR(end_effector(0, 3), 0.2, 1e-2);
+  ASSERT_NEAR(end_effector(1, 3), 0.0, 1e-2);
+  ASSERT_NEAR(end_effector(2, 3), -0.25, 1e-2);
+  // Motion stops when powered off
+  ASSERT_TRUE(simulator.sendCmd(ArmParser::FOLD_ARM));
+  simulator.advance(std::chrono::milliseconds(100));
+  ASSERT_TRUE(simulator.sendCmd(ArmParser::POWER_OFF));
+  auto joint_angles = simulator.getJointAngles();
+  simulator.advance(std::chrono::seconds(1));
+  ASSERT_EQ(simulator.getJointAngles(), joint_angles);
+  ASSERT_FALSE(simulator.getCommandStatus());
+}
+
+TEST_F(ArmDynamicsSimulatorTests, SecondOrderJoint) {
+  ArmDynamicsSimulator simulator(singleJointConfig());
+  powerOn(simulator);
+  ASSERT_TRUE(simulator.setJointAngles({0.8}));
+  double max_velocity = 0;
+  for (int i = 0; i < 1000; ++i) {
+    simulator.advance(std::chrono::milliseconds(1));
+    max_velocity = std::max(max_velocity, simulator.getJointVelocities()[0]);
+    if (i == 99) {
+      // Accelerating at the acceleration limit
+      ASSERT_NEAR(simulator.getJointAngles()[0], 0.5 * 20.0 * 0.01, 1e-2);
+      ASSERT_FALSE(simulator.getCommandStatus());
+    }
+  }
+  ASSERT_LE(max_velocity, 2.0);
+  ASSERT_NEAR(simulator.getJointAngles()[0], 0.8, 1e-2);
+  ASSERT_TRUE(simulator.getCommandStatus());
+}
+
+TEST_F(ArmDynamicsSimulatorTests, FirstOrderJoint) {
+  ArmDynamicsSimulatorConfig config = singleJointConfig();
+  config.set_joint_model(ArmDynamicsSimulatorConfig::FIRST_ORDER);
+  config.set_time_constant(0.1);
+  config.mutable_joint_config(0)->set_max_velocity(100.0);
+  ArmDynamicsSimulator simulator(config);
+  powerOn(simulator);
+  ASSERT_TRUE(simulator.setJointAngles({0.5}));
+  simulator.advance(std::chrono::milliseconds(100));
+  ASSERT_NEAR(simulator.getJointAngles()[0], 0.5 * (1 - std::exp(-1.0)),
+              1e-2);
+  simulator.advance(std::chrono::seconds(1));
+  ASSERT_TRUE(simulator.getCommandStatus());
+}
+
+TEST_F(ArmDynamicsSimulatorTests, WorkspaceLimits) {
+  ArmDynamicsSimulator simulator(singleJointConfig());
+  powerOn(simulator);
+  ASSERT_FALSE(simulator.setJointAngles({1.2}));
+  ASSERT_FALSE(simulator.setJointAngles({0.5, 0.5}));
+  ASSERT_FALSE(simulator.setEndEffectorPose(translation(0.6, 0, 0)));
+  // Reachable pose outside the joint limits stops at the limit
+  Eigen::Matrix4d target = translation(0, -0.5, 0);
+  target.topLeftCorner<3, 3>() =
+      Eigen::AngleAxisd(-M_PI / 2, Eigen::Vector3d::UnitZ()).toRotationMatrix();
+  ASSERT_TRUE(simulator.setEndEffectorPose(target));
+  simulator.advance(std::chrono::seconds(2));
+  ASSERT_NEAR(simulator.getJointAngles()[0], -1.0, 1e-3);
+  ASSERT_FALSE(simulator.getCommandStatus());
+}
+
+TEST_F(ArmDynamicsSimulatorTests, EndEffectorPose) {
+  ArmDynamicsSimulator simulator;
+  powerOn(simulator);
+  Eigen::Matrix4d target = translation(0.25, 0.1, -0.2);
+  target.topLeftCorner<3, 3>() =
+      Eigen::AngleAxisd(0.3, Eigen::Vector3d::UnitZ()).toRotationMatrix();
+  // Start away from the stretched out singularity
+  ASSERT_TRUE(simulator.sendCmd(ArmParser::RIGHT_ARM));
+  simulator.advance(std::chrono::seconds(2));
+  ASSERT_TRUE(simulator.setEndEffectorPose(target));
+  simulator.advance(std::chrono::seconds(3));
+  ASSERT_TRUE(simulator.getCommandStatus());
+  ASSERT_TRUE(simulator.getEndEffectorTransform().isApprox(target, 1e-2));
+}
+
+TEST_F(ArmDynamicsSimulatorTests, GripSuccessProbability) {
+  ArmDynamicsSimulator simulator;
+  ASSERT_EQ(simulator.gripSuccessProbability(), 0);
+  simulator.setObjectPose(simulator.getEndEffectorTransform());
+  ASSERT_DOUBLE_EQ(simulator.gripSuccessProbability(), 0.95);
+  simulator.setObjectPose(translation(0.47, 0, 0));
+  ASSERT_NEAR(simulator.gripSuccessProbability(), 0.95 * std::exp(-0.5),
+              1e-9);
+  Eigen::Matrix4d rotated = translation(0.45, 0, 0);
+  rotated.topLeftCorner<3, 3>() =
+      Eigen::AngleAxisd(0.6, Eigen::Vector3d::UnitX()).toRotationMatrix();
+  simulator.setObjectPose(rotated);
+  ASSERT_NEAR(simulator.gripSuccessProbability(), 0.95 * std::exp(-2.0),
+              1e-9);
+}
+
+TEST_F(ArmDynamicsSimulatorTests, GripAndRelease) {
+  ArmDynamicsSimulatorConfig config;
+  config.set_grip_success_probability(1.0);
+  ArmDynamicsSimulator simulator(config);
+  powerOn(simulator);
+  Eigen::Matrix4d object_pose = simulator.getEndEffectorTransform();
+  simulator.setObjectPose(object_pose);
+  ASSERT_TRUE(simulator.grip(true));
+  simulator.advance(std::chrono::milliseconds(250));
+  ASSERT_FALSE(simulator.gripStatus());
+  ASSERT_FALSE(simulator.getCommandStatus());
+  simulator.advance(std::chrono::milliseconds(60));
+  ASSERT_TRUE(simulator.gripStatus());
+  ASSERT_TRUE(simulator.getCommandStatus());
+  // The gripped object moves with the end effector
+  ASSERT_TRUE(simulator.sendCmd(ArmParser::RIGHT_ARM));
+  simulator.advance(std::chrono::seconds(2));
+  ASSERT_TRUE(simulator.gripStatus());
+  ASSERT_TRUE(
+      simulator.getObjectPose().isApprox(simulator.getEndEffectorTransform()));
+  // Released where it was placed
+  object_pose = simulator.getObjectPose();
+  ASSERT_TRUE(simulator.grip(false));
+  ASSERT_FALSE(simulator.gripStatus());
+  ASSERT_TRUE(simulator.sendCmd(ArmParser::FOLD_ARM));
+  simulator.advance(std::chrono::seconds(2));
+  ASSERT_TRUE(simulator.getObjectPose().isApprox(object_pose));
+}
+
+TEST_F(ArmDynamicsSimulatorTests, GripMissesFarObject) {
+  ArmDynamicsSimulator simulator;
+  powerOn(simulator);
+  simulator.setObjectPose(translation(0.2, 0.2, 0));
+  ASSERT_TRUE(simulator.grip(true));
+  simulator.advance(std::chrono::seconds(1));
+  ASSERT_TRUE(simulator.getCommandStatus());
+  ASSERT_FALSE(simulator.gripStatus());
+  ASSERT_TRUE(simulator.resetGripper());
+}
+
+TEST_F(ArmDynamicsSimulatorTests, GripStatistics) {
+  ArmDynamicsSimulatorConfig config;
+  config.set_seed(3);
+  auto grip_trials = [&config]() {
+    ArmDynamicsSimulator simulator(config);
+    powerOn(simulator);
+    // Success probability is 0.95 * exp(-0.5)
+    simulator.setObjectPose(translation(0.47, 0, 0));
+    std::vector<bool> grips;
+    for (int i = 0; i < 400; ++i) {
+      simulator.grip(true);
+      simulator.advance(std::chrono::milliseconds(300));
+      grips.push_back(simulator.gripStatus());
+      simulator.resetGripper();
+      simulator.setObjectPose(translation(0.47, 0, 0));
+    }
+    return grips;
+  };
+  std::vector<bool> grips = grip_trials();
+  double success_rate = std::count(grips.begin(), grips.end(), true) / 400.0;
+  ASSERT_NEAR(success_rate, 0.95 * std::exp(-0.5), 0.06);
+  // Repeatable with the same seed
+  ASSERT_EQ(grip_trials(), grips);
+}
+
+TEST_F(ArmDynamicsSimulatorTests, GripSlip) {
+  ArmDynamicsSimulatorConfig config;
+  config.set_grip_success_probability(1.0);
+  config.set_grip_slip_rate(2.0);
+  ArmDynamicsSimulator simulator(config);
+  powerOn(simulator);
+  simulator.setObjectPose(simulator.getEndEffectorTransform());
+  simulator.grip(true);
+  simulator.advance(std::chrono::milliseconds(300));
+  ASSERT_TRUE(simulator.gripStatus());
+  simulator.advance(std::chrono::seconds(10));
+  ASSERT_FALSE(simulator.gripStatus());
+}
+
+TEST_F(ArmDynamicsSimulatorTests, RealTime) {
+  ArmDynamicsSimulator simulator;
+  simulator.advance(std::chrono::milliseconds(100));
+  simulator.startRealTime(std::chrono::milliseconds(5));
+  ASSERT_TRUE(simulator.sendCmd(ArmParser::POWER_ON));
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  simulator.stopRealTime();
+  // Continues from the virtual time at start
+  ASSERT_NEAR(simulator.getTime().count(), 0.3, 0.05);
+  ASSERT_EQ(simulator.state(), ArmParser::ENABLED);
+  // Stopped
+  std::chrono::duration<double> stop_time = simulator.getTime();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  ASSERT_EQ(simulator.getTime(), stop_time);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
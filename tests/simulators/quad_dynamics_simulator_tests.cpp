@@ -0,0 +1,293 @@
+#include "aerial_autonomy/controllers/qrotor_backstepping_controller.h"
+#include "aerial_autonomy/controllers/rpyt_based_velocity_controller.h"
+#include "aerial_autonomy/estimators/thrust_gain_estimator.h"
+#include "aerial_autonomy/simulators/quad_dynamics_simulator.h"
+#include "aerial_autonomy/types/discrete_reference_trajectory_interpolate.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+class QuadDynamicsSimulatorTests : public ::testing::Test {
+public:
+  QuadDynamicsSimulatorTests() : controller_period_(0.02) {}
+
+  /**
+   * @brief Hovering state at a height
+   */
+  QrotorBacksteppingState hoverState(double height) {
+    QrotorBacksteppingState state;
+    state.p.z() = height;
+    state.thrust = config_.mass() * config_.acc_gravity();
+    return state;
+  }
+
+  /**
+   * @brief Send level roll, pitch, yaw rate, thrust commands holding height
+   * with a PD loop using the given thrust gain
+   *
+   * @param simulator Simulator to command
+   * @param duration Time to hold height
+   * @param thrust_gain Thrust gain used by the commands
+   * @param estimator Thrust gain estimator fed with the sensor data and the
+   * commands if not null
+   */
+  void holdHeight(QuadDynamicsSimulator &simulator, double duration,
+                  double thrust_gain,
+                  ThrustGainEstimator *estimator = nullptr) {
+    for (double t = 0; t < duration; t += controller_period_) {
+      parsernode::common::quaddata data;
+      simulator.getquaddata(data);
+      if (estimator) {
+        estimator->addSensorData(data);
+        thrust_gain = estimator->getThrustGain();
+      }
+      geometry_msgs::Quaternion rpyt;
+      rpyt.w = (config_.acc_gravity() - 2 * data.linvel.z) / thrust_gain;
+      if (estimator) {
+        estimator->addThrustCommand(rpyt.w);
+      }
+      ASSERT_TRUE(simulator.cmdrpyawratethrust(rpyt));
+      simulator.advance(std::chrono::duration<double>(controller_period_));
+    }
+  }
+
+protected:
+  QuadDynamicsSimulatorConfig config_;
+  double controller_period_;
+};
+
+TEST_F(QuadDynamicsSimulatorTests, FreeFall) {
+  config_.set_drag_coefficient(0);
+  QuadDynamicsSimulator simulator(config_);
+  QrotorBacksteppingState state;
+  state.p.z() = 100;
+  simulator.setState(state, false);
+  simulator.advance(std::chrono::seconds(1));
+  state = simulator.getState();
+  ASSERT_NEAR(state.p.z(), 100 - config_.acc_gravity() / 2, 1e-6);
+  ASSERT_NEAR(state.v.z(), -config_.acc_gravity(), 1e-6);
+  ASSERT_NEAR(simulator.getTime().count(), 1.0, 1e-12);
+  // Stops on the ground
+  simulator.advance(std::chrono::seconds(5));
+  state = simulator.getState();
+  ASSERT_EQ(state.p.z(), 0);
+  ASSERT_EQ(state.v.z(), 0);
+}
+
+TEST_F(QuadDynamicsSimulatorTests, ThrustTorque) {
+  QuadDynamicsSimulator simulator(config_);
+  simulator.setState(hoverState(10));
+  QrotorBacksteppingControl control;
+  control.thrust_ddot = 2;
+  control.torque = Eigen::Vector3d(config_.jxx(), 0, 0);
+  ASSERT_TRUE(simulator.commandThrustTorque(control));
+  simulator.advance(std::chrono::milliseconds(500));
+  auto state = simulator.getState();
+  ASSERT_NEAR(state.w.x(), 0.5, 1e-9);
+  ASSERT_NEAR(state.w.y(), 0, 1e-9);
+  ASSERT_NEAR(state.thrust_dot, 1, 1e-9);
+  ASSERT_NEAR(state.thrust,
+              config_.mass() * config_.acc_gravity() + 0.25, 1e-9);
+}
+
+TEST_F(QuadDynamicsSimulatorTests, TakeoffLand) {
+  QuadDynamicsSimulator simulator(config_);
+  geometry_msgs::Quaternion rpyt;
+  // Commands are rejected while disarmed
+  ASSERT_FALSE(simulator.cmdrpyawratethrust(rpyt));
+  ASSERT_TRUE(simulator.takeoff());
+  simulator.advance(std::chrono::seconds(10));
+  parsernode::common::quaddata data;
+  simulator.getquaddata(data);
+  ASSERT_TRUE(data.armed);
+  ASSERT_NEAR(data.localpos.z, config_.takeoff_height(), 1e-2);
+  ASSERT_NEAR(data.linvel.z, 0, 1e-2);
+  ASSERT_NEAR(data.timestamp, 10, 1e-9);
+  ASSERT_TRUE(simulator.land());
+  simulator.advance(std::chrono::seconds(5));
+  simulator.getquaddata(data);
+  ASSERT_FALSE(data.armed);
+  ASSERT_EQ(data.localpos.z, 0);
+}
+
+TEST_F(QuadDynamicsSimulatorTests, FlowControl) {
+  QuadDynamicsSimulator simulator(config_);
+  simulator.setState(hoverState(1));
+  geometry_msgs::Quaternion rpyt;
+  ASSERT_TRUE(simulator.cmdrpyawratethrust(rpyt));
+  simulator.flowControl(false);
+  ASSERT_FALSE(simulator.cmdrpyawratethrust(rpyt));
+  parsernode::common::quaddata data;
+  simulator.getquaddata(data);
+  ASSERT_FALSE(data.rc_sdk_control_switch);
+}
+
+TEST_F(QuadDynamicsSimulatorTests, ActuationDelay) {
+  config_.set_actuation_delay(0.1);
+  QuadDynamicsSimulator simulator(config_);
+  simulator.setState(hoverState(10));
+  geometry_msgs::Quaternion rpyt;
+  rpyt.y = 0.2;
+  rpyt.w = config_.acc_gravity() / config_.thrust_gain();
+  ASSERT_TRUE(simulator.cmdrpythrust(rpyt));
+  simulator.advance(std::chrono::milliseconds(90));
+  parsernode::common::quaddata data;
+  simulator.getquaddata(data);
+  ASSERT_NEAR(data.rpydata.y, 0, 1e-9);
+  simulator.advance(std::chrono::milliseconds(500));
+  simulator.getquaddata(data);
+  ASSERT_NEAR(data.rpydata.y, 0.2, 1e-2);
+}
+
+TEST_F(QuadDynamicsSimulatorTests, SensorNoise) {
+  config_.set_position_noise(0.1);
+  config_.set_seed(3);
+  QuadDynamicsSimulator simulator(config_);
+  QuadDynamicsSimulator same_seed_simulator(config_);
+  simulator.setState(hoverState(1));
+  double sum = 0, sum_squares = 0;
+  const int samples = 4000;
+  parsernode::common::quaddata data, same_seed_data;
+  for (int i = 0; i < samples; ++i) {
+    simulator.getquaddata(data);
+    same_seed_simulator.getquaddata(same_seed_data);
+    ASSERT_EQ(data.localpos.x, same_seed_data.localpos.x);
+    sum += data.localpos.x;
+    sum_squares += data.localpos.x * data.localpos.x;
+  }
+  double mean = sum / samples;
+  ASSERT_NEAR(mean, 0, 0.01);
+  ASSERT_NEAR(std::sqrt(sum_squares / samples - mean * mean), 0.1, 0.01);
+  // The state is noise free
+  ASSERT_EQ(simulator.getState().p.x(), 0);
+  ASSERT_EQ(data.linvel.x, 0);
+}
+
+TEST_F(QuadDynamicsSimulatorTests, BatteryDrain) {
+  config_.set_battery_drain_rate(1);
+  config_.set_battery_thrust_gain_loss(0.5);
+  QuadDynamicsSimulator simulator(config_);
+  simulator.setState(hoverState(10));
+  holdHeight(simulator, 20, config_.thrust_gain());
+  parsernode::common::quaddata data;
+  simulator.getquaddata(data);
+  ASSERT_NEAR(data.batterypercent, 80, 1);
+  ASSERT_NEAR(simulator.getThrustGain(),
+              config_.thrust_gain() * (1 - 0.5 * 0.2), 1e-3);
+  // The vehicle sinks with the constant thrust gain
+  ASSERT_LT(simulator.getState().p.z(), 9);
+}
+
+TEST_F(QuadDynamicsSimulatorTests, ThrustGainEstimation) {
+  config_.set_thrust_gain(0.2);
+  QuadDynamicsSimulator simulator(config_);
+  simulator.setState(hoverState(10));
+  ThrustGainEstimator estimator(0.16, 0.1, 1, 0.25, 0.1);
+  holdHeight(simulator, 10, 0.16, &estimator);
+  ASSERT_NEAR(estimator.getThrustGain(), 0.2, 5e-3);
+  ASSERT_NEAR(simulator.getState().v.z(), 0, 1e-2);
+}
+
+TEST_F(QuadDynamicsSimulatorTests, Wind) {
+  config_.mutable_wind_velocity()->set_vx(2);
+  config_.set_drag_coefficient(0.5);
+  QuadDynamicsSimulator simulator(config_);
+  simulator.setState(hoverState(10));
+  holdHeight(simulator, 10, config_.thrust_gain());
+  // Drifts with the wind with a time constant of 2 s
+  ASSERT_NEAR(simulator.getState().v.x(), 2 * (1 - std::exp(-5)), 0.05);
+  ASSERT_NEAR(simulator.getState().v.y(), 0, 1e-6);
+}
+
+TEST_F(QuadDynamicsSimulatorTests, WindGusts) {
+  config_.set_wind_gust_stddev(1);
+  config_.set_drag_coefficient(0.5);
+  QuadDynamicsSimulator simulator(config_);
+  simulator.setState(hoverState(10));
+  holdHeight(simulator, 5, config_.thrust_gain());
+  ASSERT_GT(simulator.getState().v.head<2>().norm(), 1e-3);
+}
+
+TEST_F(QuadDynamicsSimulatorTests, RPYTVelocityController) {
+  RPYTBasedVelocityControllerConfig controller_config;
+  controller_config.set_kp_xy(2);
+  controller_config.set_kp_z(2);
+  controller_config.set_max_acc_norm(2);
+  RPYTBasedVelocityController controller(
+      controller_config, std::chrono::duration<double>(controller_period_));
+  controller.setGoal(VelocityYawRate(1, -0.5, 0.2, 0.1));
+  QuadDynamicsSimulator simulator(config_);
+  simulator.setState(hoverState(10));
+  for (double t = 0; t < 10; t += controller_period_) {
+    parsernode::common::quaddata data;
+    simulator.getquaddata(data);
+    RollPitchYawRateThrust control;
+    ASSERT_TRUE(controller.run(
+        std::make_tuple(VelocityYawRate(data.linvel.x, data.linvel.y,
+                                        data.linvel.z, data.omega.z),
+                        data.rpydata.z),
+        control));
+    geometry_msgs::Quaternion rpyt;
+    rpyt.x = control.r;
+    rpyt.y = control.p;
+    rpyt.z = control.y;
+    rpyt.w = control.t;
+    ASSERT_TRUE(simulator.cmdrpyawratethrust(rpyt));
+    simulator.advance(std::chrono::duration<double>(controller_period_));
+  }
+  auto state = simulator.getState();
+  // Drag leaves a steady state error without integral action
+  ASSERT_NEAR(state.v.x(), 1, 0.1);
+  ASSERT_NEAR(state.v.y(), -0.5, 0.1);
+  ASSERT_NEAR(state.v.z(), 0.2, 0.1);
+  ASSERT_NEAR(state.w.z(), 0.1, 1e-2);
+}
+
+TEST_F(QuadDynamicsSimulatorTests, BacksteppingController) {
+  QrotorBacksteppingControllerConfig controller_config;
+  controller_config.set_mass(config_.mass());
+  controller_config.set_jxx(config_.jxx());
+  controller_config.set_jyy(config_.jyy());
+  controller_config.set_jzz(config_.jzz());
+  controller_config.set_k1(1);
+  controller_config.set_k2(1);
+  controller_config.set_kp_xy(2);
+  controller_config.set_kp_z(2);
+  controller_config.set_kd_xy(2);
+  controller_config.set_kd_z(2);
+  QrotorBacksteppingController controller(controller_config);
+  std::shared_ptr<DiscreteReferenceTrajectoryInterpolate<ParticleState, Snap>>
+      reference(
+          new DiscreteReferenceTrajectoryInterpolate<ParticleState, Snap>());
+  for (double t = 0; t < 30; t += 0.1) {
+    reference->ts.push_back(t);
+    ParticleState goal;
+    goal.p = Eigen::Vector3d(1, -1, 2);
+    reference->states.push_back(goal);
+    reference->controls.push_back(Snap());
+  }
+  controller.setGoal(reference);
+  // No drag on the controller model
+  config_.set_drag_coefficient(0);
+  QuadDynamicsSimulator simulator(config_);
+  simulator.setState(hoverState(1));
+  const double period = 0.005;
+  for (double t = 0; t < 20; t += period) {
+    QrotorBacksteppingControl control;
+    ASSERT_TRUE(controller.run(
+        std::make_pair(simulator.getTime().count(), simulator.getState()),
+        control));
+    ASSERT_TRUE(simulator.commandThrustTorque(control));
+    simulator.advance(std::chrono::duration<double>(period));
+  }
+  auto state = simulator.getState();
+  ASSERT_NEAR(state.p.x(), 1, 0.05);
+  ASSERT_NEAR(state.p.y(), -1, 0.05);
+  ASSERT_NEAR(state.p.z(), 2, 0.05);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,3 +1,4 @@
+#include <aerial_autonomy/simulators/arm_dynamics_simulator.h>
 #include <aerial_autonomy/state_machines/pick_place_state_machine.h>
 #include <aerial_autonomy/tests/test_utils.h>
 #include <aerial_autonomy/trackers/simple_tracker.h>
@@ -29,10 +30,30 @@ namespace pe = pick_place_events;
 */
 namespace be = uav_basic_events;
 
-class PickPlaceStateMachineTests : public ::testing::Test {
+/**
+* @brief Ideal arm: goals are reached and the gripper is set by the tests
+*/
+void configureArm(ArmSimulator &, PickPlaceStateMachineConfig &) {}
+
+/**
+* @brief Arm dynamics simulator advancing in real time. Its pick goal has to
+* lie in the workspace of the simulated arm, and the grip timeout has to
+* cover reaching it since the timeout starts when entering the pick state
+*/
+void configureArm(ArmDynamicsSimulator &arm,
+                  PickPlaceStateMachineConfig &config) {
+  auto pick_goal = config.mutable_arm_goal_transform(0);
+  pick_goal->mutable_position()->set_x(0.3);
+  pick_goal->mutable_position()->set_z(-0.15);
+  config.mutable_grip_config()->set_grip_timeout(4000);
+  arm.startRealTime(std::chrono::milliseconds(10));
+}
+
+template <class ArmT>
+class PickPlaceStateMachineFixture : public ::testing::Test {
 public:
-  PickPlaceStateMachineTests()
-      : drone_hardware_(new QuadSimulator), arm_(new ArmSimulator),
+  PickPlaceStateMachineFixture()
+      : drone_hardware_(new QuadSimulator), arm_(new ArmT),
         goal_tolerance_position_(0.1), grip_timeout_(1000), grip_duration_(10) {
     auto vision_state_machine_config =
         state_machine_config_.mutable_visual_servoing_state_machine_config();
@@ -136,6 +157,7 @@ public:
     // Arm goals
     pick_state_machine_config->add_arm_goal_transform();
     pick_state_machine_config->add_arm_goal_transform();
+    configureArm(*arm_, *pick_state_machine_config);
 
     // Relative marker goal for pick
     auto pose_goal = vision_state_machine_config->add_relative_pose_goals();
@@ -183,12 +205,8 @@ public:
     uav_arm_system_.reset(new UAVArmSystem(
         config_, std::dynamic_pointer_cast<BaseTracker>(tracker_),
         std::dynamic_pointer_cast<parsernode::Parser>(drone_hardware_),
-        std::dynamic_pointer_cast<ArmSimulator>(arm_)));
-    logic_state_machine_.reset(new PickPlaceStateMachine(
-        boost::ref(*uav_arm_system_), boost::cref(state_machine_config_)));
-    logic_state_machine_->start();
-    // Move to landed state
-    logic_state_machine_->process_event(InternalTransitionEvent());
+        std::dynamic_pointer_cast<ArmParser>(arm_)));
+    resetStateMachine();
 
     // Targets used in pick place
     // Target objects
@@ -228,7 +246,7 @@ public:
     Log::instance().addDataStream(data_config);
   }
 
-  ~PickPlaceStateMachineTests() {
+  ~PickPlaceStateMachineFixture() {
     logic_state_machine_->stop();
     uav_arm_system_.reset();
     logic_state_machine_.reset();
@@ -236,7 +254,7 @@ public:
 
 protected:
   std::shared_ptr<QuadSimulator> drone_hardware_;
-  std::shared_ptr<ArmSimulator> arm_;
+  std::shared_ptr<ArmT> arm_;
   UAVSystemConfig config_;
   BaseStateMachineConfig state_machine_config_;
   std::shared_ptr<SimpleTracker> tracker_;
@@ -247,6 +265,34 @@ protected:
   uint32_t grip_duration_;
   std::unordered_map<uint32_t, tf::Transform> targets_;
 
+  /**
+  * @brief Create a state machine with the current state machine config and
+  * move it to the landed state
+  */
+  void resetStateMachine() {
+    if (logic_state_machine_) {
+      logic_state_machine_->stop();
+    }
+    logic_state_machine_.reset(new PickPlaceStateMachine(
+        boost::ref(*uav_arm_system_), boost::cref(state_machine_config_)));
+    logic_state_machine_->start();
+    // Move to landed state
+    logic_state_machine_->process_event(InternalTransitionEvent());
+  }
+
+  /**
+  * @brief Run the UAV and arm controllers once
+  * @return True if any of the controllers is active
+  */
+  bool runControllers() {
+    uav_arm_system_->runActiveController(ControllerGroup::UAV);
+    uav_arm_system_->runActiveController(ControllerGroup::Arm);
+    return uav_arm_system_->getActiveControllerStatus(ControllerGroup::UAV) ==
+               ControllerStatus::Active ||
+           uav_arm_system_->getActiveControllerStatus(ControllerGroup::Arm) ==
+               ControllerStatus::Active;
+  }
+
   template <class EventT> void testManualControlAbort() {
     // First takeoff
     GoToHoverFromLanded();
@@ -290,7 +336,10 @@ protected:
     logic_state_machine_->process_event(InternalTransitionEvent());
   }
 
-  void PickPlace(uint32_t expected_place_target) {
+  /**
+  * @brief Pick the tracked object and move to the post pick waypoints
+  */
+  void PickObject() {
     // Check we are waiting for pick
     ASSERT_STREQ(pstate(*logic_state_machine_), "WaitingForPick");
     // Check in PickState
@@ -303,14 +352,7 @@ protected:
     ASSERT_EQ(uav_arm_system_->getStatus<BuiltInPoseControllerArmConnector>(),
               ControllerStatus::Active);
     // Keep running the controller until its completed or timeout
-    auto getStatusRunControllers = [&]() {
-      uav_arm_system_->runActiveController(ControllerGroup::UAV);
-      uav_arm_system_->runActiveController(ControllerGroup::Arm);
-      return uav_arm_system_->getActiveControllerStatus(ControllerGroup::UAV) ==
-                 ControllerStatus::Active ||
-             uav_arm_system_->getActiveControllerStatus(ControllerGroup::Arm) ==
-                 ControllerStatus::Active;
-    };
+    auto getStatusRunControllers = [&]() { return runControllers(); };
     ASSERT_FALSE(test_utils::waitUntilFalse()(getStatusRunControllers,
                                               std::chrono::seconds(1),
                                               std::chrono::milliseconds(0)));
@@ -323,6 +365,11 @@ protected:
     ASSERT_STREQ(pstate(*logic_state_machine_), "ReachingPostPickWaypoint");
     ASSERT_EQ(logic_state_machine_->lastProcessedEventIndex(),
               typeid(ObjectId));
+  }
+
+  void PickPlace(uint32_t expected_place_target) {
+    ASSERT_NO_FATAL_FAILURE(PickObject());
+    auto getStatusRunControllers = [&]() { return runControllers(); };
     // Run controllers through one waypoint
     logic_state_machine_->process_event(InternalTransitionEvent());
     ASSERT_FALSE(test_utils::waitUntilFalse()(getStatusRunControllers,
@@ -363,6 +410,132 @@ protected:
   }
 };
 
+using PickPlaceStateMachineTests = PickPlaceStateMachineFixture<ArmSimulator>;
+
+/**
+* @brief Follows continuous paths through the post pick and post place
+* waypoints instead of stopping at each waypoint
+*/
+class PickPlaceBlendedWaypointsTests : public PickPlaceStateMachineTests {
+public:
+  PickPlaceBlendedWaypointsTests() {
+    auto waypoint_config =
+        state_machine_config_.mutable_visual_servoing_state_machine_config()
+            ->mutable_pick_place_state_machine_config()
+            ->mutable_following_waypoint_sequence_config();
+    waypoint_config->set_blend_waypoints(true);
+    waypoint_config->set_cruise_velocity(5.0);
+    waypoint_config->set_max_yaw_rate(10.0);
+    waypoint_config->set_look_ahead_time(0.1);
+    waypoint_config->set_settle_timeout(settle_timeout_);
+    resetStateMachine();
+  }
+
+protected:
+  /**
+  * @brief Process internal transitions until the state machine leaves the
+  * current waypoint state
+  *
+  * @param run_controller Whether to run the UAV controller on every
+  * transition
+  */
+  void FollowBlendedPath(bool run_controller = true) {
+    std::string state = pstate(*logic_state_machine_);
+    ASSERT_TRUE(test_utils::waitUntilTrue()(
+        [&]() {
+          if (run_controller) {
+            uav_arm_system_->runActiveController(ControllerGroup::UAV);
+          }
+          logic_state_machine_->process_event(InternalTransitionEvent());
+          return pstate(*logic_state_machine_) != state;
+        },
+        std::chrono::seconds(5), std::chrono::milliseconds(1)));
+  }
+
+  const double settle_timeout_ = 0.5; ///< Time to converge after a path (s)
+};
+
+/**
+* @brief Runs the pick place state machine against the simulated arm dynamics
+* and gripper instead of an arm reaching every goal instantly
+*/
+class PickPlaceDynamicsSimulatorTests
+    : public PickPlaceStateMachineFixture<ArmDynamicsSimulator> {
+protected:
+  /**
+  * @brief Takeoff once the arm is folded and start picking
+  */
+  void StartPick() {
+    drone_hardware_->setBatteryPercent(100);
+    logic_state_machine_->process_event(be::Takeoff());
+    ASSERT_STREQ(pstate(*logic_state_machine_), "ArmPreTakeoffFolding");
+    // Folding the arm takes time
+    ASSERT_TRUE(test_utils::waitUntilTrue()(
+        [&]() {
+          logic_state_machine_->process_event(InternalTransitionEvent());
+          return std::string(pstate(*logic_state_machine_)) == "Takingoff";
+        },
+        std::chrono::seconds(5), std::chrono::milliseconds(10)));
+    logic_state_machine_->process_event(InternalTransitionEvent());
+    ASSERT_STREQ(pstate(*logic_state_machine_), "Hovering");
+    logic_state_machine_->process_event(pe::Pick());
+    logic_state_machine_->process_event(InternalTransitionEvent());
+    ASSERT_STREQ(pstate(*logic_state_machine_), "PickState");
+  }
+
+  /**
+  * @brief Run the arm controller until the end effector reaches the pick goal
+  */
+  void ReachPickGoal() {
+    ASSERT_FALSE(test_utils::waitUntilFalse()(
+        [&]() {
+          uav_arm_system_->runActiveController(ControllerGroup::Arm);
+          return uav_arm_system_->getActiveControllerStatus(
+                     ControllerGroup::Arm) == ControllerStatus::Active;
+        },
+        std::chrono::seconds(5), std::chrono::milliseconds(10)));
+    ASSERT_EQ(uav_arm_system_->getStatus<BuiltInPoseControllerArmConnector>(),
+              ControllerStatus::Completed);
+    // The controller tolerance is coarser than the grip tolerance; let the
+    // arm settle at the goal
+    ASSERT_TRUE(test_utils::waitUntilTrue()(
+        [&]() { return arm_->getCommandStatus(); }, std::chrono::seconds(2),
+        std::chrono::milliseconds(10)));
+  }
+
+  /**
+  * @brief Process internal transitions until the state machine leaves the
+  * pick state
+  */
+  void WaitForGrip() {
+    std::chrono::milliseconds grip_timeout(
+        pickPlaceConfig().grip_config().grip_timeout());
+    ASSERT_TRUE(test_utils::waitUntilTrue()(
+        [&]() {
+          logic_state_machine_->process_event(InternalTransitionEvent());
+          return std::string(pstate(*logic_state_machine_)) != "PickState";
+        },
+        grip_timeout, std::chrono::milliseconds(10)));
+  }
+
+  const PickPlaceStateMachineConfig &pickPlaceConfig() const {
+    return state_machine_config_.visual_servoing_state_machine_config()
+        .pick_place_state_machine_config();
+  }
+
+  /**
+  * @brief Pick goal in the arm frame
+  */
+  Eigen::Matrix4d pickGoal() const {
+    auto goal = pickPlaceConfig().arm_goal_transform(0);
+    Eigen::Matrix4d pose = Eigen::Matrix4d::Identity();
+    pose(0, 3) = goal.position().x();
+    pose(1, 3) = goal.position().y();
+    pose(2, 3) = goal.position().z();
+    return pose;
+  }
+};
+
 TEST_F(PickPlaceStateMachineTests, InitialState) {
   // Validate
   ASSERT_STREQ(pstate(*logic_state_machine_), "Landed");
@@ -593,6 +766,111 @@ TEST_F(PickPlaceStateMachineTests, PickPlaceManualControlInternalActions) {
 }
 ///
 
+TEST_F(PickPlaceDynamicsSimulatorTests, PickObject) {
+  arm_->setObjectPose(pickGoal());
+  StartPick();
+  ReachPickGoal();
+  ASSERT_TRUE(arm_->getEndEffectorTransform().isApprox(pickGoal(), 1e-2));
+  // Close the gripper on the object
+  ASSERT_TRUE(arm_->grip(true));
+  WaitForGrip();
+  ASSERT_STREQ(pstate(*logic_state_machine_), "ReachingPostPickWaypoint");
+  ASSERT_EQ(logic_state_machine_->lastProcessedEventIndex(),
+            typeid(ObjectId));
+  ASSERT_TRUE(arm_->gripStatus());
+}
+
+TEST_F(PickPlaceDynamicsSimulatorTests, MissObject) {
+  // Object out of reach of the gripper at the pick goal
+  Eigen::Matrix4d object_pose = pickGoal();
+  object_pose(1, 3) += 0.2;
+  arm_->setObjectPose(object_pose);
+  StartPick();
+  ReachPickGoal();
+  ASSERT_TRUE(arm_->grip(true));
+  WaitForGrip();
+  ASSERT_STREQ(pstate(*logic_state_machine_), "ResetVisualServoing");
+  ASSERT_EQ(logic_state_machine_->lastProcessedEventIndex(), typeid(Reset));
+  ASSERT_FALSE(arm_->gripStatus());
+}
+
+TEST_F(PickPlaceBlendedWaypointsTests, PickPlace) {
+  auto pick_state_machine_config =
+      state_machine_config_.visual_servoing_state_machine_config()
+          .pick_place_state_machine_config();
+  GoToHoverFromLanded();
+  logic_state_machine_->process_event(pe::Pick());
+  ASSERT_NO_FATAL_FAILURE(PickObject());
+  parsernode::common::quaddata start = uav_arm_system_->getUAVData();
+  // Blended path through the post pick waypoints
+  FollowBlendedPath();
+  ASSERT_STREQ(pstate(*logic_state_machine_), "PlaceState");
+  ASSERT_EQ(logic_state_machine_->lastProcessedEventIndex(),
+            typeid(ObjectId));
+  // Path ends at the sum of the relative waypoints (0, 0, 1) and (-1, 0, 1)
+  parsernode::common::quaddata end = uav_arm_system_->getUAVData();
+  ASSERT_NEAR(end.localpos.x, start.localpos.x - 1, goal_tolerance_position_);
+  ASSERT_NEAR(end.localpos.y, start.localpos.y, goal_tolerance_position_);
+  ASSERT_NEAR(end.localpos.z, start.localpos.z + 2, goal_tolerance_position_);
+  uint32_t place_target;
+  ASSERT_TRUE(uav_arm_system_->getTrackingVectorId(place_target));
+  ASSERT_EQ(place_target,
+            pick_state_machine_config.place_groups().Get(0).destination_id());
+  ASSERT_FALSE(test_utils::waitUntilFalse()(
+      [&]() { return runControllers(); }, std::chrono::seconds(1),
+      std::chrono::milliseconds(0)));
+  logic_state_machine_->process_event(InternalTransitionEvent());
+  ASSERT_STREQ(pstate(*logic_state_machine_), "ReachingPostPlaceWaypoint");
+  // Blended path through the post place waypoints
+  FollowBlendedPath();
+  ASSERT_STREQ(pstate(*logic_state_machine_), "WaitingForPick");
+  ASSERT_EQ(logic_state_machine_->lastProcessedEventIndex(),
+            typeid(Completed));
+}
+
+TEST_F(PickPlaceBlendedWaypointsTests, AbortIfControllerNotEngaged) {
+  GoToHoverFromLanded();
+  logic_state_machine_->process_event(pe::Pick());
+  ASSERT_NO_FATAL_FAILURE(PickObject());
+  // Start the path
+  logic_state_machine_->process_event(InternalTransitionEvent());
+  uav_arm_system_->runActiveController(ControllerGroup::UAV);
+  ASSERT_STREQ(pstate(*logic_state_machine_), "ReachingPostPickWaypoint");
+  ASSERT_EQ(uav_arm_system_->getActiveControllerStatus(ControllerGroup::UAV),
+            ControllerStatus::Active);
+  uav_arm_system_->abortController(ControllerGroup::UAV);
+  logic_state_machine_->process_event(InternalTransitionEvent());
+  ASSERT_STREQ(pstate(*logic_state_machine_), "Hovering");
+  ASSERT_EQ(logic_state_machine_->lastProcessedEventIndex(),
+            typeid(be::Abort));
+}
+
+TEST_F(PickPlaceBlendedWaypointsTests, Abort) {
+  GoToHoverFromLanded();
+  logic_state_machine_->process_event(pe::Pick());
+  ASSERT_NO_FATAL_FAILURE(PickObject());
+  logic_state_machine_->process_event(InternalTransitionEvent());
+  logic_state_machine_->process_event(be::Abort());
+  ASSERT_STREQ(pstate(*logic_state_machine_), "Hovering");
+  ASSERT_EQ(uav_arm_system_->getActiveControllerStatus(ControllerGroup::UAV),
+            ControllerStatus::NotEngaged);
+}
+
+TEST_F(PickPlaceBlendedWaypointsTests, Timeout) {
+  GoToHoverFromLanded();
+  logic_state_machine_->process_event(pe::Pick());
+  ASSERT_NO_FATAL_FAILURE(PickObject());
+  auto start = std::chrono::steady_clock::now();
+  // The controller is not run, so it never reaches the end of the path
+  FollowBlendedPath(false);
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  ASSERT_STREQ(pstate(*logic_state_machine_), "Hovering");
+  ASSERT_EQ(logic_state_machine_->lastProcessedEventIndex(),
+            typeid(be::Abort));
+  ASSERT_GT(elapsed.count(), settle_timeout_);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
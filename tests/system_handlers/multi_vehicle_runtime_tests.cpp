@@ -0,0 +1,241 @@
+#include <aerial_autonomy/common/async_timer.h>
+#include <aerial_autonomy/log/log.h>
+#include <aerial_autonomy/state_machines/uav_state_machine.h>
+#include <aerial_autonomy/system_handlers/multi_vehicle_runtime.h>
+#include <aerial_autonomy/system_handlers/uav_system_handler.h>
+#include <aerial_autonomy/tests/test_utils.h>
+#include <aerial_autonomy/uav_basic_events.h>
+#include <gtest/gtest.h>
+#include <ros/ros.h>
+
+#include <boost/filesystem.hpp>
+
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <thread>
+
+namespace {
+/**
+ * @brief Threads created once per process after the baseline count, e.g. by
+ * ROS when the first topics are advertised
+ */
+const std::size_t kSharedThreads = 8;
+
+/**
+ * @brief Number of threads of the process
+ */
+std::size_t processThreadCount() {
+  return std::distance(boost::filesystem::directory_iterator("/proc/self/task"),
+                       boost::filesystem::directory_iterator());
+}
+
+/**
+ * @brief Read the last field of each line of a data stream file
+ * @param path Path of the file
+ * @return Last field of each line
+ */
+std::vector<std::string> lastFields(const boost::filesystem::path &path) {
+  std::vector<std::string> fields;
+  std::ifstream file(path.string());
+  std::string line;
+  while (std::getline(file, line)) {
+    if (!line.empty()) {
+      fields.push_back(line.substr(line.rfind(',') + 1));
+    }
+  }
+  return fields;
+}
+}
+
+/**
+ * @brief Minimal system handler that logs its name on a controller timer
+ * run by the executor of its context
+ */
+class TickLoggingHandler {
+public:
+  /**
+   * @brief Constructor starts the timer
+   * @param name Name written to the vehicle_ticks stream on every tick
+   * @param context Namespace, callback queue and timer executor of the
+   * handler
+   */
+  TickLoggingHandler(std::string name, const SystemHandlerContext &context)
+      : nh_(context.nodeHandle("common")), ticks_(0),
+        timer_(
+            [this, name]() {
+              DATA_LOG("vehicle_ticks") << name << DataStream::endl;
+              ++ticks_;
+            },
+            std::chrono::milliseconds(10), context.executor) {
+    timer_.start();
+  }
+
+  /**
+   * @brief Namespace of the handler topics
+   */
+  std::string rosNamespace() const { return nh_.getNamespace(); }
+
+  /**
+   * @brief Number of timer ticks
+   */
+  int ticks() const { return ticks_; }
+
+private:
+  ros::NodeHandle nh_;     ///< Node handle in the vehicle namespace
+  std::atomic<int> ticks_; ///< Number of timer ticks
+  AsyncTimer timer_;       ///< Timer run on the runtime worker pool
+};
+
+class MultiVehicleRuntimeTests : public ::testing::Test {
+public:
+  MultiVehicleRuntimeTests()
+      : log_directory_("/tmp/multi_vehicle_runtime_test") {
+    boost::filesystem::remove_all(log_directory_);
+    boost::filesystem::create_directories(log_directory_);
+    log_config_.set_directory(log_directory_.string() + "/");
+    log_config_.set_write_duration(20);
+    DataStreamConfig *stream = log_config_.add_data_stream_configs();
+    stream->set_stream_id("vehicle_ticks");
+    stream->set_delimiter(",");
+    stream->set_log_rate(1000);
+    runtime_config_.set_worker_threads(4);
+    runtime_config_.set_callback_duration(5);
+    uav_config_.mutable_uav_system_config()->set_uav_parser_type(
+        "quad_simulator_parser/QuadSimParser");
+    // Start the process log threads before counting threads
+    Log::instance();
+  }
+
+  /**
+   * @brief Name of the i-th vehicle. Names have the same length so that no
+   * name is a prefix of another
+   */
+  static std::string vehicleName(int i) {
+    std::ostringstream name;
+    name << "uav_" << std::setw(2) << std::setfill('0') << i;
+    return name.str();
+  }
+
+protected:
+  using UAVHandler =
+      UAVSystemHandler<UAVStateMachine,
+                       uav_basic_events::UAVEventManager<UAVStateMachine>>;
+
+  ros::NodeHandle nh_; ///< Keeps the ROS threads running between vehicles
+  boost::filesystem::path log_directory_; ///< Parent of the vehicle logs
+  LogConfig log_config_;                  ///< Log configuration of vehicles
+  MultiVehicleRuntimeConfig runtime_config_; ///< Runtime configuration
+  UAVSystemHandlerConfig uav_config_;        ///< Simulated UAV handler
+  BaseStateMachineConfig state_machine_config_; ///< UAV state machine
+};
+
+TEST_F(MultiVehicleRuntimeTests, ManySimulatedVehicles) {
+  const int vehicle_count = 50;
+  const std::size_t max_threads = processThreadCount() +
+                                  runtime_config_.worker_threads() +
+                                  kSharedThreads;
+  MultiVehicleRuntime runtime(runtime_config_, log_config_);
+  ASSERT_EQ(runtime.workerPool().threadCount(),
+            runtime_config_.worker_threads());
+  for (int i = 0; i < vehicle_count; ++i) {
+    runtime.addVehicle<UAVHandler>(vehicleName(i), uav_config_,
+                                   state_machine_config_);
+    ASSERT_LE(processThreadCount(), max_threads);
+  }
+  ASSERT_EQ(runtime.vehicleCount(), std::size_t(vehicle_count));
+  // Let the controller, state machine and log timers of all vehicles run
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  ASSERT_LE(processThreadCount(), max_threads);
+  // Each vehicle logs to its own directory prefixed with its name
+  std::set<boost::filesystem::path> directories;
+  for (int i = 0; i < vehicle_count; ++i) {
+    std::string name = vehicleName(i);
+    Log &log = runtime.vehicleLog(name);
+    boost::filesystem::path directory = log.directory();
+    ASSERT_TRUE(boost::filesystem::is_directory(directory));
+    ASSERT_EQ(directory.parent_path(), log_directory_);
+    ASSERT_EQ(directory.filename().string().compare(0, name.size() + 1,
+                                                    name + "_"),
+              0);
+    ASSERT_EQ(log["vehicle_ticks"].path().parent_path(), directory);
+    ASSERT_TRUE(boost::filesystem::exists(log["timebase"].path()));
+    directories.insert(directory);
+  }
+  ASSERT_EQ(directories.size(), std::size_t(vehicle_count));
+}
+
+TEST_F(MultiVehicleRuntimeTests, VehicleLogAndNamespace) {
+  const int vehicle_count = 3;
+  MultiVehicleRuntime runtime(runtime_config_, log_config_);
+  std::vector<TickLoggingHandler *> handlers;
+  std::vector<boost::filesystem::path> paths;
+  for (int i = 0; i < vehicle_count; ++i) {
+    std::string name = vehicleName(i);
+    handlers.push_back(&runtime.addVehicle<TickLoggingHandler>(name, name));
+    paths.push_back(runtime.vehicleLog(name)["vehicle_ticks"].path());
+    // Topics are namespaced under the vehicle name
+    ASSERT_EQ(handlers.back()->rosNamespace(),
+              ros::names::resolve(name + "/common"));
+  }
+  for (auto handler : handlers) {
+    ASSERT_TRUE(test_utils::waitUntilTrue()(
+        [handler]() { return handler->ticks() >= 10; },
+        std::chrono::seconds(1)));
+  }
+  // The logs are written when the vehicles are removed
+  for (int i = 0; i < vehicle_count; ++i) {
+    runtime.removeVehicle(vehicleName(i));
+  }
+  // DATA_LOG in the timer of a vehicle writes to the vehicle log only
+  for (int i = 0; i < vehicle_count; ++i) {
+    std::vector<std::string> fields = lastFields(paths[i]);
+    ASSERT_GE(fields.size(), 10u);
+    for (const auto &field : fields) {
+      ASSERT_EQ(field, vehicleName(i));
+    }
+  }
+}
+
+TEST_F(MultiVehicleRuntimeTests, AddRemoveVehicle) {
+  MultiVehicleRuntime runtime(runtime_config_, log_config_);
+  const std::size_t idle_tasks = runtime.workerPool().taskCount();
+  runtime.addVehicle<TickLoggingHandler>("uav_00", "uav_00");
+  TickLoggingHandler &handler =
+      runtime.addVehicle<TickLoggingHandler>("uav_01", "uav_01");
+  ASSERT_EQ(runtime.vehicleCount(), 2u);
+  // Names are unique
+  ASSERT_THROW(runtime.addVehicle<TickLoggingHandler>("uav_00", "uav_00"),
+               std::runtime_error);
+  ASSERT_EQ(runtime.vehicleCount(), 2u);
+
+  runtime.removeVehicle("uav_00");
+  ASSERT_EQ(runtime.vehicleCount(), 1u);
+  ASSERT_THROW(runtime.vehicleLog("uav_00"), std::out_of_range);
+  ASSERT_THROW(runtime.removeVehicle("uav_00"), std::out_of_range);
+  // The remaining vehicle keeps running
+  int ticks = handler.ticks();
+  ASSERT_TRUE(test_utils::waitUntilTrue()(
+      [&handler, ticks]() { return handler.ticks() > ticks + 5; },
+      std::chrono::seconds(1)));
+
+  // A removed name can be added again
+  runtime.addVehicle<TickLoggingHandler>("uav_00", "uav_00");
+  ASSERT_EQ(runtime.vehicleCount(), 2u);
+  ASSERT_NO_THROW(runtime.vehicleLog("uav_00"));
+
+  // Removing the vehicles cancels their tasks on the pool
+  runtime.removeVehicle("uav_00");
+  runtime.removeVehicle("uav_01");
+  ASSERT_EQ(runtime.vehicleCount(), 0u);
+  ASSERT_EQ(runtime.workerPool().taskCount(), idle_tasks);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "multi_vehicle_runtime_tests");
+  return RUN_ALL_TESTS();
+}
@@ -1,5 +1,6 @@
 #include <aerial_autonomy/state_machines/uav_state_machine.h>
 #include <aerial_autonomy/system_handlers/uav_system_handler.h>
+#include <aerial_autonomy/tests/allocation_tracker.h>
 #include <aerial_autonomy/tests/test_utils.h>
 #include <aerial_autonomy/uav_basic_events.h>
 #include <gtest/gtest.h>
@@ -15,10 +16,8 @@ class UAVSystemHandlerTests : public ::testing::Test,
 public:
   UAVSystemHandlerTests() : BaseTestPubSubs() {
     // Configure system
-    UAVSystemHandlerConfig uav_system_handler_config;
-    BaseStateMachineConfig state_machine_config;
     // \todo Add UAV state machine config
-    auto uav_config = uav_system_handler_config.mutable_uav_system_config();
+    auto uav_config = uav_system_handler_config_.mutable_uav_system_config();
     uav_config->set_uav_parser_type("quad_simulator_parser/QuadSimParser");
     uav_config->set_minimum_takeoff_height(0.4);
     // Position controller params
@@ -49,13 +48,45 @@ public:
     uav_config->mutable_rpyt_based_position_controller_config()
         ->mutable_rpyt_based_velocity_controller_config()
         ->set_max_acc_norm(10.);
+    createHandler();
+  }
 
+  /**
+   * @brief Replace the system handler by one using the current configuration
+   */
+  void createHandler() {
+    uav_system_handler_.reset();
     uav_system_handler_.reset(
         new UAVSystemHandler<UAVStateMachine, UAVEventManager<UAVStateMachine>>(
-            uav_system_handler_config, state_machine_config));
+            uav_system_handler_config_, state_machine_config_));
     ros::spinOnce();
   }
 
+  /**
+   * @brief Check that takeoff and land events are processed
+   */
+  void checkTakeoffAndLand() {
+    while (!uav_system_handler_->isConnected()) {
+    }
+    auto armed_true_fun = [=]() {
+      ros::spinOnce();
+      return uav_system_handler_->getUAVData().armed;
+    };
+    // Check takeoff works
+    publishEvent("Takeoff");
+    ASSERT_TRUE(test_utils::waitUntilTrue()(
+        armed_true_fun, std::chrono::seconds(timeout_wait)));
+    ASSERT_EQ(uav_system_handler_->getUAVData().localpos.z, 0.5);
+    // Check subsequent event works
+    publishEvent("Land");
+    ASSERT_FALSE(test_utils::waitUntilFalse()(
+        armed_true_fun, std::chrono::seconds(timeout_wait)));
+    ASSERT_EQ(uav_system_handler_->getUAVData().localpos.z, 0.0);
+  }
+
+  UAVSystemHandlerConfig uav_system_handler_config_; ///< Handler config
+  BaseStateMachineConfig state_machine_config_; ///< State machine config
+
   const unsigned long timeout_wait =
       20; ///< Timeout for ros topic wait in seconds
   std::unique_ptr<UAVSystemHandler<UAVStateMachine,
@@ -71,23 +102,10 @@ TEST_F(UAVSystemHandlerTests, TestConnections) {
   SUCCEED();
 }
 
-TEST_F(UAVSystemHandlerTests, ProcessEvents) {
-  while (!uav_system_handler_->isConnected()) {
-  }
-  auto armed_true_fun = [=]() {
-    ros::spinOnce();
-    return uav_system_handler_->getUAVData().armed;
-  };
-  // Check takeoff works
-  publishEvent("Takeoff");
-  ASSERT_TRUE(test_utils::waitUntilTrue()(armed_true_fun,
-                                          std::chrono::seconds(timeout_wait)));
-  ASSERT_EQ(uav_system_handler_->getUAVData().localpos.z, 0.5);
-  // Check subsequent event works
-  publishEvent("Land");
-  ASSERT_FALSE(test_utils::waitUntilFalse()(
-      armed_true_fun, std::chrono::seconds(timeout_wait)));
-  ASSERT_EQ(uav_system_handler_->getUAVData().localpos.z, 0.0);
+TEST_F(UAVSystemHandlerTests, ProcessEvents) { checkTakeoffAndLand(); }
+
+TEST_F(UAVSystemHandlerTests, NoTickTimings) {
+  ASSERT_TRUE(uav_system_handler_->getTickTimings().empty());
 }
 
 TEST_F(UAVSystemHandlerTests, ProcessPoseCommand) {
@@ -126,6 +144,77 @@ TEST_F(UAVSystemHandlerTests, ReceiveStatus) {
       std::chrono::seconds(timeout_wait)));
 }
 
+/**
+ * @brief Runs the controller, state machine and status on one pipelined tick
+ */
+class UAVSystemHandlerPipelinedTests : public UAVSystemHandlerTests {
+public:
+  UAVSystemHandlerPipelinedTests() {
+    uav_system_handler_config_.mutable_base_config()->set_pipelined_tick(true);
+    createHandler();
+  }
+};
+
+TEST_F(UAVSystemHandlerPipelinedTests, ProcessEvents) { checkTakeoffAndLand(); }
+
+TEST_F(UAVSystemHandlerPipelinedTests, TickTimings) {
+  ASSERT_TRUE(test_utils::waitUntilTrue()(
+      [=]() {
+        auto timings = uav_system_handler_->getTickTimings();
+        return !timings.empty() && timings.back().calls > 5;
+      },
+      std::chrono::seconds(timeout_wait)));
+  auto timings = uav_system_handler_->getTickTimings();
+  std::vector<std::string> stage_names;
+  for (const auto &timing : timings) {
+    stage_names.push_back(timing.name);
+  }
+  ASSERT_EQ(stage_names,
+            std::vector<std::string>({"sensor_snapshot", "uav_controller",
+                                      "state_machine", "status",
+                                      "sensor_release", "tick"}));
+  // The status is updated about every 50 ms on a 20 ms tick
+  ASSERT_LT(timings[3].calls, timings[5].calls);
+  ASSERT_GT(timings[3].calls, 0u);
+  // Every tick that takes a snapshot releases it
+  ASSERT_GE(timings[4].calls + 1, timings[0].calls);
+}
+
+TEST_F(UAVSystemHandlerPipelinedTests, ReceiveStatus) {
+  while (!isStatusConnected())
+    ;
+  ASSERT_TRUE(test_utils::waitUntilTrue()(
+      [=]() {
+        ros::spinOnce();
+        return status_.find("Tick Pipeline") != std::string::npos;
+      },
+      std::chrono::seconds(timeout_wait)));
+}
+
+/**
+ * @brief Records the call sites allocating on the controller timer during the
+ * simulated mission
+ */
+class UAVSystemHandlerCallSiteTests : public UAVSystemHandlerTests {
+public:
+  UAVSystemHandlerCallSiteTests() {
+    allocation_tracker::clearCallSites();
+    uav_system_handler_config_.mutable_base_config()
+        ->set_record_controller_call_sites(true);
+    createHandler();
+  }
+};
+
+TEST_F(UAVSystemHandlerCallSiteTests, ProcessEvents) {
+  // Linking the allocation tracker installs the hook
+  ASSERT_TRUE(ControllerTimerHook::installed());
+  checkTakeoffAndLand();
+  // The report is logged when the handler is destroyed
+  uav_system_handler_.reset();
+  std::string report = allocation_tracker::callSiteReport();
+  ASSERT_NE(report.find("allocating call sites"), std::string::npos);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   ros::init(argc, argv, "uav_system_handler_tests");
@@ -0,0 +1,92 @@
+#include "aerial_autonomy/trackers/color_blob_roi_detector.h"
+#include "aerial_autonomy/trackers/template_roi_detector.h"
+
+#include <gtest/gtest.h>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+/**
+* @brief Check a ROI against a rectangle
+*/
+void expectRoi(const sensor_msgs::RegionOfInterest &roi, cv::Rect rect) {
+  EXPECT_EQ(static_cast<int>(roi.x_offset), rect.x);
+  EXPECT_EQ(static_cast<int>(roi.y_offset), rect.y);
+  EXPECT_EQ(static_cast<int>(roi.width), rect.width);
+  EXPECT_EQ(static_cast<int>(roi.height), rect.height);
+}
+
+TEST(ColorBlobRoiDetectorTests, LargestBlob) {
+  ColorBlobDetectorConfig config;
+  // Green
+  config.set_hue_min(50);
+  config.set_hue_max(70);
+  ColorBlobRoiDetector detector(config);
+  cv::Mat image(120, 160, CV_8UC3, cv::Scalar(40, 40, 40));
+  sensor_msgs::RegionOfInterest roi;
+  ASSERT_FALSE(detector.detect(image, roi));
+  cv::rectangle(image, cv::Rect(10, 20, 12, 12), cv::Scalar(0, 255, 0), -1);
+  cv::rectangle(image, cv::Rect(80, 40, 30, 20), cv::Scalar(0, 200, 0), -1);
+  // Blue blob is ignored
+  cv::rectangle(image, cv::Rect(0, 80, 100, 40), cv::Scalar(255, 0, 0), -1);
+  ASSERT_TRUE(detector.detect(image, roi));
+  expectRoi(roi, cv::Rect(80, 40, 30, 20));
+}
+
+TEST(ColorBlobRoiDetectorTests, MinArea) {
+  ColorBlobDetectorConfig config;
+  config.set_hue_min(50);
+  config.set_hue_max(70);
+  config.set_min_area(200);
+  ColorBlobRoiDetector detector(config);
+  cv::Mat image(120, 160, CV_8UC3, cv::Scalar(0, 0, 0));
+  cv::rectangle(image, cv::Rect(10, 20, 14, 14), cv::Scalar(0, 255, 0), -1);
+  sensor_msgs::RegionOfInterest roi;
+  ASSERT_FALSE(detector.detect(image, roi));
+  cv::rectangle(image, cv::Rect(10, 20, 15, 14), cv::Scalar(0, 255, 0), -1);
+  ASSERT_TRUE(detector.detect(image, roi));
+}
+
+TEST(ColorBlobRoiDetectorTests, HueWrapsAround) {
+  ColorBlobDetectorConfig config;
+  // Red on both sides of hue 0
+  config.set_hue_min(170);
+  config.set_hue_max(10);
+  ColorBlobRoiDetector detector(config);
+  cv::Mat image(120, 160, CV_8UC3, cv::Scalar(0, 0, 0));
+  // Hue 175 and hue 5 next to each other form one blob
+  cv::Mat hsv(1, 2, CV_8UC3);
+  hsv.at<cv::Vec3b>(0, 0) = cv::Vec3b(175, 255, 255);
+  hsv.at<cv::Vec3b>(0, 1) = cv::Vec3b(5, 255, 255);
+  cv::Mat bgr;
+  cv::cvtColor(hsv, bgr, cv::COLOR_HSV2BGR);
+  for (int i = 0; i < 2; ++i) {
+    cv::Vec3b color = bgr.at<cv::Vec3b>(0, i);
+    image(cv::Rect(30 + 20 * i, 30, 20, 20))
+        .setTo(cv::Scalar(color[0], color[1], color[2]));
+  }
+  sensor_msgs::RegionOfInterest roi;
+  ASSERT_TRUE(detector.detect(image, roi));
+  expectRoi(roi, cv::Rect(30, 30, 40, 20));
+}
+
+TEST(TemplateRoiDetectorTests, Match) {
+  cv::Mat image(120, 160, CV_8UC3);
+  cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(255));
+  cv::Rect target(70, 35, 24, 16);
+  TemplateDetectorConfig config;
+  TemplateRoiDetector detector(config, image(target).clone());
+  sensor_msgs::RegionOfInterest roi;
+  ASSERT_TRUE(detector.detect(image, roi));
+  expectRoi(roi, target);
+  // Not found in an unrelated image
+  cv::Mat other(120, 160, CV_8UC3);
+  cv::randu(other, cv::Scalar::all(0), cv::Scalar::all(255));
+  ASSERT_FALSE(detector.detect(other, roi));
+  // Image smaller than the template
+  ASSERT_FALSE(detector.detect(image(cv::Rect(0, 0, 10, 10)), roi));
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
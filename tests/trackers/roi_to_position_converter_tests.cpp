@@ -4,6 +4,7 @@
 #include <sensor_msgs/image_encodings.h>
 #include <thread>
 
+#include "aerial_autonomy/trackers/color_blob_roi_detector.h"
 #include "aerial_autonomy/trackers/roi_to_position_converter.h"
 
 class RoiToPositionConverterROSTests : public ::testing::Test {
@@ -12,7 +13,8 @@ public:
       : nh_(), camera_info_pub_(
                    nh_.advertise<sensor_msgs::CameraInfo>("camera_info", 1)),
         roi_pub_(nh_.advertise<sensor_msgs::RegionOfInterest>("roi", 1)),
-        depth_pub_(nh_.advertise<sensor_msgs::Image>("depth", 1)) {}
+        depth_pub_(nh_.advertise<sensor_msgs::Image>("depth", 1)),
+        image_pub_(nh_.advertise<sensor_msgs::Image>("image", 1)) {}
   void publishCameraInfo(sensor_msgs::CameraInfo &camera_info) {
     camera_info_pub_.publish(camera_info);
     ros::spinOnce();
@@ -22,11 +24,22 @@ public:
     std::this_thread::sleep_for(std::chrono::milliseconds(50));
     ros::spinOnce();
   }
-  void publishDepth(cv::Mat &depth) {
+  void publishDepth(cv::Mat &depth, ros::Time stamp = ros::Time()) {
     cv_bridge::CvImage depth_msg;
+    depth_msg.header.stamp = stamp;
     depth_msg.encoding = sensor_msgs::image_encodings::TYPE_32FC1;
     depth_msg.image = depth;
     depth_pub_.publish(depth_msg.toImageMsg());
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ros::spinOnce();
+  }
+  void publishImage(cv::Mat &image, ros::Time stamp) {
+    cv_bridge::CvImage image_msg;
+    image_msg.header.stamp = stamp;
+    image_msg.encoding = sensor_msgs::image_encodings::BGR8;
+    image_msg.image = image;
+    image_pub_.publish(image_msg.toImageMsg());
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
     ros::spinOnce();
   }
 
@@ -35,6 +48,7 @@ private:
   ros::Publisher camera_info_pub_;
   ros::Publisher roi_pub_;
   ros::Publisher depth_pub_;
+  ros::Publisher image_pub_;
 };
 
 TEST(RoiToPositionConverterTests, ComputeTrackingVector) {
@@ -206,6 +220,61 @@ TEST_F(RoiToPositionConverterROSTests, GetTrackingVector) {
   ASSERT_NEAR(pose.getRotation().w(), 1, 1e-5);
 }
 
+TEST_F(RoiToPositionConverterROSTests, DetectorMatchesDepthStamp) {
+  ColorBlobDetectorConfig config;
+  config.set_hue_min(50);
+  config.set_hue_max(70);
+  config.set_min_area(10);
+  RoiToPositionConverter converter(
+      "", RoiDetectorPtr(new ColorBlobRoiDetector(config)));
+  while (!converter.isConnected()) {
+  }
+  sensor_msgs::CameraInfo camera_info;
+  double cx = 20;
+  double cy = 20;
+  double fx = 2;
+  double fy = 2;
+  camera_info.K[2] = cx;
+  camera_info.K[5] = cy;
+  camera_info.K[0] = fx;
+  camera_info.K[4] = fy;
+  publishCameraInfo(camera_info);
+
+  // Green target in the top left corner
+  cv::Mat image(40, 40, CV_8UC3, cv::Scalar(0, 0, 0));
+  image(cv::Rect(0, 0, 10, 10)).setTo(cv::Scalar(0, 255, 0));
+  cv::Mat depth(40, 40, CV_32F);
+  depth(cv::Rect(0, 0, 40, 40)).setTo(1);
+  depth(cv::Rect(0, 0, 5, 5)).setTo(0.5);
+
+  // Depth image waits for the image with the same stamp
+  ros::Time stamp = ros::Time::now();
+  publishDepth(depth, stamp);
+  tf::Transform pose;
+  ASSERT_FALSE(converter.getTrackingVector(pose));
+  publishImage(image, stamp);
+  ASSERT_TRUE(converter.getTrackingVector(pose));
+  ASSERT_NEAR(pose.getOrigin().x(), 0.5 * (2 - cx) / fx, 1e-5);
+  ASSERT_NEAR(pose.getOrigin().y(), 0.5 * (2 - cy) / fy, 1e-5);
+  ASSERT_NEAR(pose.getOrigin().z(), 0.5, 1e-5);
+  // The stamp is converted to the timebase when the depth image is used, so
+  // compare the tracking times against each other rather than against
+  // another conversion of the stamp
+  timebase::TimePoint first_tracking_time = converter.getTrackingTime();
+  ASSERT_GT(converter.getTrackingLatency().count(), 0);
+
+  // Image arriving first
+  stamp += ros::Duration(0.1);
+  publishImage(image, stamp);
+  publishDepth(depth, stamp);
+  timebase::TimePoint second_tracking_time = converter.getTrackingTime();
+  ASSERT_GT(second_tracking_time, first_tracking_time);
+
+  // No tracking vector for a depth image without a detection
+  publishDepth(depth, stamp + ros::Duration(0.1));
+  ASSERT_EQ(converter.getTrackingTime(), second_tracking_time);
+}
+
 int main(int argc, char **argv) {
   ros::init(argc, argv, "roi_to_position_converter_test");
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,181 @@
+#include <aerial_autonomy/controllers/velocity_based_position_controller.h>
+#include <aerial_autonomy/types/blended_waypoint_trajectory.h>
+#include <gtest/gtest.h>
+
+/**
+* @brief Distance between the positions of two waypoints
+*/
+double distance(const PositionYaw &a, const PositionYaw &b) {
+  return Eigen::Vector3d(a.x - b.x, a.y - b.y, a.z - b.z).norm();
+}
+
+/**
+* @brief Square path of side 1m with a yaw turn at the second waypoint
+*/
+std::vector<PositionYaw> squarePath() {
+  return {PositionYaw(0, 0, 1, 0), PositionYaw(1, 0, 1, 0),
+          PositionYaw(1, 1, 1, M_PI / 2), PositionYaw(0, 1, 1, M_PI / 2),
+          PositionYaw(0, 0, 1, M_PI / 2)};
+}
+
+TEST(BlendedWaypointTrajectoryTests, SingleWaypoint) {
+  PositionYaw waypoint(1, 2, 3, 0.5);
+  BlendedWaypointTrajectory trajectory({waypoint}, 1.0, 0.1, 1.0);
+  ASSERT_EQ(trajectory.duration(), 0);
+  ASSERT_EQ(trajectory.atTime(0).first, waypoint);
+  ASSERT_EQ(trajectory.atTime(-1).first, waypoint);
+  ASSERT_EQ(trajectory.waypointIndex(0), 0);
+}
+
+TEST(BlendedWaypointTrajectoryTests, InvalidArguments) {
+  ASSERT_DEATH(BlendedWaypointTrajectory({}, 1.0, 0.1, 1.0),
+               "Trajectory needs at least one waypoint");
+  ASSERT_DEATH(BlendedWaypointTrajectory(squarePath(), 0, 0.1, 1.0),
+               "Velocity should be positive");
+}
+
+TEST(BlendedWaypointTrajectoryTests, StraightLine) {
+  BlendedWaypointTrajectory trajectory(
+      {PositionYaw(0, 0, 0, 0), PositionYaw(2, 0, 0, 0)}, 0.5, 0.1, 1.0);
+  ASSERT_DOUBLE_EQ(trajectory.duration(), 4.0);
+  auto reference = trajectory.atTime(1.0);
+  ASSERT_NEAR(distance(reference.first, PositionYaw(0.5, 0, 0, 0)), 0, 1e-12);
+  ASSERT_DOUBLE_EQ(reference.second.x, 0.5);
+  ASSERT_EQ(trajectory.atTime(4.0).first, PositionYaw(2, 0, 0, 0));
+  ASSERT_EQ(trajectory.atTime(5.0).second, VelocityYawRate(0, 0, 0, 0));
+}
+
+TEST(BlendedWaypointTrajectoryTests, YawRateLimited) {
+  BlendedWaypointTrajectory trajectory(
+      {PositionYaw(0, 0, 0, 0), PositionYaw(0, 0, 0, M_PI / 2)}, 0.5, 0.1,
+      0.5);
+  ASSERT_DOUBLE_EQ(trajectory.duration(), M_PI);
+  auto reference = trajectory.atTime(M_PI / 2);
+  ASSERT_DOUBLE_EQ(reference.first.yaw, M_PI / 4);
+  ASSERT_DOUBLE_EQ(reference.second.yaw_rate, 0.5);
+}
+
+TEST(BlendedWaypointTrajectoryTests, ContinuousPathWithinCornerTolerance) {
+  const double velocity = 0.5;
+  const double corner_tolerance = 0.05;
+  auto waypoints = squarePath();
+  // Yaw rate is high enough that the lines are not slowed down
+  BlendedWaypointTrajectory trajectory(waypoints, velocity, corner_tolerance,
+                                       2.0);
+  // Blends take as long as the corners they replace
+  ASSERT_NEAR(trajectory.duration(), 4.0 / velocity, 1e-9);
+  std::vector<double> closest_distance(waypoints.size(), 1e3);
+  const double dt = 1e-3;
+  auto previous = trajectory.atTime(0);
+  int previous_index = trajectory.waypointIndex(0);
+  for (double t = dt; t < trajectory.duration(); t += dt) {
+    auto reference = trajectory.atTime(t);
+    // Position is continuous and speed is limited to the cruise velocity
+    ASSERT_LE(distance(reference.first, previous.first),
+              velocity * dt * (1 + 1e-6));
+    // Velocity is continuous through corners
+    Velocity velocity_change = reference.second - previous.second;
+    ASSERT_LT(Eigen::Vector3d(velocity_change.x, velocity_change.y,
+                              velocity_change.z)
+                  .norm(),
+              10 * dt);
+    for (unsigned int i = 0; i < waypoints.size(); ++i) {
+      closest_distance[i] = std::min(closest_distance[i],
+                                     distance(reference.first, waypoints[i]));
+    }
+    // Waypoint index does not decrease
+    int index = trajectory.waypointIndex(t);
+    ASSERT_GE(index, previous_index);
+    previous_index = index;
+    previous = reference;
+  }
+  ASSERT_EQ(previous_index, int(waypoints.size()) - 1);
+  for (unsigned int i = 1; i + 1 < waypoints.size(); ++i) {
+    ASSERT_LE(closest_distance[i], corner_tolerance + 1e-6);
+  }
+  ASSERT_EQ(trajectory.atTime(trajectory.duration()).first, waypoints.back());
+}
+
+/**
+* @brief Simulate a vehicle which follows velocity commands from a position
+* controller and return the time taken to complete the mission.
+*/
+class WaypointMissionTimeTests : public ::testing::Test {
+protected:
+  WaypointMissionTimeTests() : dt_(0.02), max_time_(100) {
+    config_.set_position_gain(1.0);
+    config_.set_z_gain(1.0);
+    config_.set_yaw_gain(1.0);
+    config_.set_max_velocity(1.0);
+    config_.set_max_yaw_rate(1.0);
+    config_.set_position_i_gain(0.0);
+    config_.set_yaw_i_gain(0.0);
+    config_.set_position_saturation_value(0.0);
+    config_.set_yaw_saturation_value(0.0);
+    auto tolerance = config_.mutable_position_controller_config();
+    tolerance->mutable_goal_position_tolerance()->set_x(0.05);
+    tolerance->mutable_goal_position_tolerance()->set_y(0.05);
+    tolerance->mutable_goal_position_tolerance()->set_z(0.05);
+    tolerance->set_goal_yaw_tolerance(0.05);
+  }
+
+  /**
+  * @brief Move the vehicle by one time step towards the goal
+  * @return True if the controller converged to the goal
+  */
+  bool step(VelocityBasedPositionController &controller, PositionYaw goal) {
+    controller.setGoal(goal, false);
+    VelocityYawRate command;
+    controller.run(position_, command);
+    position_ = position_ + command * dt_;
+    return controller.isConverged(position_) == ControllerStatus::Completed;
+  }
+
+  double stopAndGoTime(const std::vector<PositionYaw> &waypoints) {
+    VelocityBasedPositionController controller(
+        config_, std::chrono::duration<double>(dt_));
+    position_ = waypoints.front();
+    double t = 0;
+    for (unsigned int i = 1; i < waypoints.size(); ++i) {
+      while (!step(controller, waypoints[i]) && t < max_time_) {
+        t += dt_;
+      }
+    }
+    return t;
+  }
+
+  double blendedTime(const std::vector<PositionYaw> &waypoints,
+                     double look_ahead_time) {
+    VelocityBasedPositionController controller(
+        config_, std::chrono::duration<double>(dt_));
+    BlendedWaypointTrajectory trajectory(waypoints, 1.0, 0.05, 1.0);
+    position_ = waypoints.front();
+    double t = 0;
+    while ((!step(controller, trajectory.atTime(t + look_ahead_time).first) ||
+            t < trajectory.duration()) &&
+           t < max_time_) {
+      t += dt_;
+    }
+    return t;
+  }
+
+  VelocityBasedPositionControllerConfig config_;
+  PositionYaw position_;
+  double dt_;
+  double max_time_; ///< Time after which the mission is abandoned
+};
+
+TEST_F(WaypointMissionTimeTests, BlendingReducesMissionTime) {
+  auto waypoints = squarePath();
+  double stop_and_go_time = stopAndGoTime(waypoints);
+  double blended_time = blendedTime(waypoints, 1.0);
+  LOG(INFO) << "Stop and go: " << stop_and_go_time
+            << "s Blended: " << blended_time << "s";
+  ASSERT_LT(stop_and_go_time, max_time_);
+  ASSERT_LT(blended_time, 0.75 * stop_and_go_time);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include "aerial_autonomy/common/eigen_views.h"
+#include "aerial_autonomy/tests/test_utils.h"
+#include "aerial_autonomy/types/pose.h"
+#include "aerial_autonomy/types/twist.h"
+
+using namespace conversions;
+using namespace test_utils;
+
+TEST(PoseTests, Identity) {
+  Pose pose;
+  ASSERT_TRUE(pose.R.isIdentity());
+  ASSERT_TRUE(pose.p.isZero());
+  ASSERT_TF_NEAR(toTf(pose), tf::Transform::getIdentity());
+}
+
+TEST(PoseTests, FromRPY) {
+  Pose pose = Pose::fromRPY(0.1, -0.2, 0.3, Eigen::Vector3d(1, 2, 3));
+  ASSERT_TF_NEAR(toTf(pose),
+                 tf::Transform(tf::createQuaternionFromRPY(0.1, -0.2, 0.3),
+                               tf::Vector3(1, 2, 3)));
+}
+
+TEST(PoseTests, ComposeAndInvert) {
+  tf::Transform tf1(tf::createQuaternionFromRPY(0.1, -0.2, 0.3),
+                    tf::Vector3(1, 2, 3));
+  tf::Transform tf2(tf::createQuaternionFromRPY(-0.4, 0.5, 1.2),
+                    tf::Vector3(-1, 0.5, 2));
+  Pose pose1 = toPose(tf1);
+  Pose pose2 = toPose(tf2);
+  ASSERT_TF_NEAR(toTf(pose1 * pose2), tf1 * tf2);
+  ASSERT_TF_NEAR(toTf(pose1.inverse()), tf1.inverse());
+  ASSERT_TF_NEAR(toTf(pose1.inverseTimes(pose2)), tf1.inverseTimes(tf2));
+  ASSERT_POSE_NEAR(pose1 * pose1.inverse(), Pose());
+  tf::Vector3 point_tf = tf1 * tf::Vector3(0.3, -0.2, 0.1);
+  ASSERT_VEC_NEAR(pose1 * Eigen::Vector3d(0.3, -0.2, 0.1),
+                  Eigen::Vector3d(point_tf.x(), point_tf.y(), point_tf.z()));
+}
+
+TEST(PoseTests, RPY) {
+  Pose pose = Pose::fromRPY(0.1, -0.2, 0.3);
+  double roll, pitch, yaw;
+  pose.getRPY(roll, pitch, yaw);
+  ASSERT_NEAR(roll, 0.1, 1e-8);
+  ASSERT_NEAR(pitch, -0.2, 1e-8);
+  ASSERT_NEAR(yaw, 0.3, 1e-8);
+  ASSERT_NEAR(pose.yaw(), 0.3, 1e-8);
+}
+
+TEST(PoseTests, YawGimbalLock) {
+  // Same convention as tf::Matrix3x3::getRPY, which sets yaw to zero
+  Pose pose = Pose::fromRPY(0.2, M_PI / 2, 0.5);
+  pose.R(2, 0) = -1;
+  ASSERT_EQ(pose.yaw(), 0);
+  double roll, pitch, yaw;
+  pose.getRPY(roll, pitch, yaw);
+  ASSERT_EQ(yaw, 0);
+  ASSERT_NEAR(pitch, M_PI / 2, 1e-8);
+}
+
+TEST(PoseTests, AngleTo) {
+  Pose pose1 = Pose::fromRPY(0.1, -0.2, 0.3);
+  Pose pose2 = Pose::fromRPY(-0.4, 0.5, 1.2);
+  tf::Quaternion q1 = tf::createQuaternionFromRPY(0.1, -0.2, 0.3);
+  tf::Quaternion q2 = tf::createQuaternionFromRPY(-0.4, 0.5, 1.2);
+  ASSERT_NEAR(pose1.angleTo(pose2), q1.angleShortestPath(q2), 1e-8);
+  ASSERT_NEAR(pose1.angleTo(pose1), 0, 1e-12);
+  ASSERT_NEAR(Pose().angleTo(Pose::fromRPY(M_PI, 0, 0)), M_PI, 1e-8);
+}
+
+TEST(PoseTests, Matrix) {
+  Pose pose = Pose::fromRPY(0.1, -0.2, 0.3, Eigen::Vector3d(1, 2, 3));
+  Eigen::Matrix4d m = pose.matrix();
+  Eigen::Matrix3d R = m.topLeftCorner<3, 3>();
+  Eigen::Vector3d p = m.topRightCorner<3, 1>();
+  ASSERT_TRUE(R.isApprox(pose.R));
+  ASSERT_VEC_NEAR(p, pose.p);
+  ASSERT_VEC_NEAR(Eigen::Vector4d(m.row(3)), Eigen::Vector4d(0, 0, 0, 1));
+}
+
+TEST(TwistTests, Arithmetic) {
+  Twist t1(Eigen::Vector3d(1, 2, 3), Eigen::Vector3d(0.1, 0.2, 0.3));
+  Twist t2(Eigen::Vector3d(-1, 0, 1), Eigen::Vector3d(0, 0, 0.5));
+  ASSERT_EQ(t1 + t2, Twist(Eigen::Vector3d(0, 2, 4),
+                           Eigen::Vector3d(0.1, 0.2, 0.8)));
+  ASSERT_EQ(t1 - t1, Twist());
+  ASSERT_EQ(t2 * 2, Twist(Eigen::Vector3d(-2, 0, 2),
+                          Eigen::Vector3d(0, 0, 1)));
+  ASSERT_NE(t1, t2);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}